@@ -370,4 +370,42 @@ bool csv_helper_load_spawn_position(const char *_pFolderName, struct vec2 *_pOut
 
     fclose(pFile);
     return bSuccess;
-}
\ No newline at end of file
+}
+
+bool csv_helper_load_logic_flag(const char *_pFolderName, const char *_pKey)
+{
+    if (!_pFolderName || !_pKey)
+        return false;
+
+    /* Build path: "rom:/<folder>/logic.csv" */
+    char szPath[256];
+    snprintf(szPath, sizeof(szPath), "rom:/%s/logic.csv", _pFolderName);
+
+    FILE *pFile = fopen(szPath, "r");
+    if (!pFile)
+        return false;
+
+    char szLine[256];
+    bool bTruncated = false;
+    bool bSet = false;
+
+    while (csv_helper_fgets_checked(szLine, sizeof(szLine), pFile, &bTruncated))
+    {
+        if (bTruncated)
+            continue;
+
+        csv_helper_strip_eol(szLine);
+
+        /* Parse format: "key,value" */
+        char *pToken = strtok(szLine, ",");
+        if (!pToken || strcmp(pToken, _pKey) != 0)
+            continue;
+
+        int iValue = 0;
+        bSet = csv_helper_parse_int(strtok(NULL, ","), &iValue) && iValue != 0;
+        break;
+    }
+
+    fclose(pFile);
+    return bSet;
+}
@@ -132,4 +132,13 @@ bool csv_helper_copy_line_for_tokenizing(const char *_pLine, char *_pOutBuf, siz
  * @param _pOutPos Output parameter for the parsed spawn position (defaults to 0,0 if not found)
  * @return true if spawn position was successfully loaded, false otherwise
  */
-bool csv_helper_load_spawn_position(const char *_pFolderName, struct vec2 *_pOutPos);
\ No newline at end of file
+bool csv_helper_load_spawn_position(const char *_pFolderName, struct vec2 *_pOutPos);
+
+/**
+ * Checks a per-map option in logic.csv of the specified folder.
+ * Looks for a "<key>,1" line (any line; "spawn,x,y" stays first).
+ * @param _pFolderName Folder name (e.g., "space", "cave", etc.)
+ * @param _pKey Option name (e.g., "flatten_layers")
+ * @return true if the option is present and set to a non-zero value, false otherwise
+ */
+bool csv_helper_load_logic_flag(const char *_pFolderName, const char *_pKey);
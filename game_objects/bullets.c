@@ -221,6 +221,11 @@ void bullets_update(bool _bShootDown)
     /* Select damage based on bullet upgrade progression */
     int iBulletDamage = gp_state_unlock_get(GP_UNLOCK_BULLETS_UPGRADED) ? BULLET_DAMAGE_UPGRADED : BULLET_DAMAGE_NORMAL;
 
+    /* Move, then resolve meteor hits for the whole step of every bullet in one batch */
+    SpaceSweep aSweeps[BULLET_POOL_SIZE];
+    int aSweepBullet[BULLET_POOL_SIZE];
+    uint16_t uSweepCount = 0;
+
     for (int i = 0; i < BULLET_POOL_SIZE; ++i)
     {
         struct entity2D *pBullet = &m_aBullets[i];
@@ -228,6 +233,7 @@ void bullets_update(bool _bShootDown)
             continue;
 
         /* Move */
+        struct vec2 vFrom = pBullet->vPos;
         pBullet->vPos = vec2_add(pBullet->vPos, vec2_scale(pBullet->vVel, fFrameMul));
 
         /* Wrap X position in PLANET mode */
@@ -244,13 +250,33 @@ void bullets_update(bool _bShootDown)
             continue;
         }
 
-        /* 2. Collision vs meteors (SPACE mode only) */
-        if (bIsSpaceMode && space_objects_check_bullet_collision(pBullet, iBulletDamage))
+        if (bIsSpaceMode)
         {
-            entity2d_deactivate(pBullet);
+            aSweeps[uSweepCount] = (SpaceSweep){.vFrom = vFrom, .vTo = pBullet->vPos, .fRadius = (float)pBullet->iCollisionRadius};
+            aSweepBullet[uSweepCount] = i;
+            uSweepCount++;
+        }
+    }
+
+    /* 2. Collision vs meteors (SPACE mode only): swept over the step, so fast bullets can't skip small meteors */
+    if (uSweepCount > 0 && space_objects_check_bullet_sweeps(aSweeps, uSweepCount, iBulletDamage) > 0)
+    {
+        for (uint16_t k = 0; k < uSweepCount; ++k)
+        {
+            if (!aSweeps[k].pHit)
+                continue;
+
+            int i = aSweepBullet[k];
+            entity2d_deactivate(&m_aBullets[i]);
             m_aBulletSpawnTimes[i] = 0;
-            continue;
         }
+    }
+
+    for (int i = 0; i < BULLET_POOL_SIZE; ++i)
+    {
+        struct entity2D *pBullet = &m_aBullets[i];
+        if (!entity2d_is_active(pBullet))
+            continue;
 
         /* 3. Lifetime check - despawn if exceeded max lifetime */
         if (m_aBulletSpawnTimes[i] != 0 && (uCurrentTime - m_aBulletSpawnTimes[i]) >= BULLET_MAX_LIFETIME_MS)
@@ -15,6 +15,7 @@
 #include "../minimap.h"
 #include "../player_jnr.h"
 #include "../player_surface.h"
+#include "../render_queue.h"
 #include "../resource_helper.h"
 #include "../rng.h"
 #include "../tilemap.h"
@@ -331,7 +332,15 @@ void currency_handler_refresh(const char *_pFolder, gp_state_t _eState)
             SpaceObject *pMeteor = space_objects_spawn_meteor(vPos);
             if (!pMeteor)
             {
-                debugf("currency_handler_refresh: Failed to spawn meteor for currency ID %u\n", (unsigned)uCurrencyId);
+                /* Pool full: park it, it wakes once the camera comes close */
+                if (!space_objects_spawn_meteor_dormant(vPos,
+                                                        meteors_get_crystal_sprite(),
+                                                        rngf(-FM_PI, FM_PI),
+                                                        rngf(-CURRENCY_METEOR_MAX_ROT_SPEED, CURRENCY_METEOR_MAX_ROT_SPEED),
+                                                        12,
+                                                        METEOR_CURRENCY_HITPOINTS,
+                                                        uCurrencyId))
+                    debugf("currency_handler_refresh: Failed to spawn meteor for currency ID %u\n", (unsigned)uCurrencyId);
                 if (pLineEnd)
                     pLineStart = pLineEnd + 1;
                 else
@@ -357,17 +366,17 @@ void currency_handler_refresh(const char *_pFolder, gp_state_t _eState)
             entity2d_init_from_sprite(&pMeteor->entity, vPos, pCrystalSprite, uFlags, uLayerMask);
 
             pMeteor->entity.fAngleRad = rngf(-FM_PI, FM_PI);
-            pMeteor->entity.vVel = vec2_make(0.0f, 0.0f); /* Currency meteors don't move initially */
+            space_object_set_velocity(pMeteor, vec2_make(0.0f, 0.0f)); /* Currency meteors don't move initially */
             pMeteor->entity.iCollisionRadius = 12;
 
-            pMeteor->data.meteor.fRotationSpeed = rngf(-CURRENCY_METEOR_MAX_ROT_SPEED, CURRENCY_METEOR_MAX_ROT_SPEED);
-            pMeteor->data.meteor.fTintFrames = 0.0f;
-            pMeteor->data.meteor.iFramesAlive = 0;
-            pMeteor->data.meteor.uCurrencyId = uCurrencyId;
+            pMeteor->pData->meteor.fRotationSpeed = rngf(-CURRENCY_METEOR_MAX_ROT_SPEED, CURRENCY_METEOR_MAX_ROT_SPEED);
+            pMeteor->pData->meteor.fTintFrames = 0.0f;
+            pMeteor->pData->meteor.iFramesAlive = 0;
+            pMeteor->pData->meteor.uCurrencyId = uCurrencyId;
 
             /* Set high hit points for currency meteors */
             pMeteor->iHitPoints = METEOR_CURRENCY_HITPOINTS;
-            pMeteor->bSleeping = false;
+            space_object_set_sleeping(pMeteor, false);
         }
         else
         {
@@ -524,6 +533,24 @@ void currency_handler_update(void)
     if (!pPlayerEntity || !entity2d_is_collidable(pPlayerEntity))
         return;
 
+    /* SURFACE: project the player (slot 0) and all currency through the sphere distortion in one batch */
+    bool bDistorted = (currentState == SURFACE && g_mainTilemap.bInitialized);
+    struct vec2 aWorldPos[MAX_CURRENCY + 1];
+    struct vec2i aScreenPos[MAX_CURRENCY + 1];
+    bool aVisible[MAX_CURRENCY + 1];
+
+    if (bDistorted)
+    {
+        aWorldPos[0] = pPlayerEntity->vPos;
+        for (size_t i = 0; i < m_iCurrencyCount; ++i)
+            aWorldPos[i + 1] = m_aCurrency[i].entity.vPos;
+
+        tilemap_world_to_screen_distorted_batch(aWorldPos, aScreenPos, aVisible, (uint16_t)(m_iCurrencyCount + 1));
+
+        if (!aVisible[0])
+            return; /* player not visible */
+    }
+
     for (size_t i = 0; i < m_iCurrencyCount; ++i)
     {
         CurrencyInstance *pCurrency = &m_aCurrency[i];
@@ -535,14 +562,13 @@ void currency_handler_update(void)
             continue;
 
         /* In SURFACE mode, check collision in distorted screen space to match visual representation */
-        if (currentState == SURFACE && g_mainTilemap.bInitialized)
+        if (bDistorted)
         {
-            /* Convert both positions to distorted screen space */
-            struct vec2i vCurrencyScreen, vPlayerScreen;
-            if (!tilemap_world_to_screen_distorted(pCurrency->entity.vPos, &vCurrencyScreen))
+            /* Both positions in distorted screen space (projected above) */
+            if (!aVisible[i + 1])
                 continue; /* currency not visible */
-            if (!tilemap_world_to_screen_distorted(pPlayerEntity->vPos, &vPlayerScreen))
-                continue; /* player not visible */
+            struct vec2i vCurrencyScreen = aScreenPos[i + 1];
+            struct vec2i vPlayerScreen = aScreenPos[0];
 
             /* Check collision in distorted screen space using shared helper */
             bool bIsColliding = entity2d_check_collision_circle_screen(vCurrencyScreen, pCurrency->entity.iCollisionRadius, vPlayerScreen, pPlayerEntity->iCollisionRadius);
@@ -610,8 +636,12 @@ void currency_handler_render(void)
     gp_state_t currentState = gp_state_get();
     float fZoom = camera_get_zoom(&g_mainCamera);
 
-    rdpq_set_mode_standard();
-    rdpq_mode_alphacompare(1);
+    /* SPACE goes through the render queue, which sets the mode itself */
+    if (currentState != SPACE)
+    {
+        rdpq_set_mode_standard();
+        rdpq_mode_alphacompare(1);
+    }
 
     for (size_t i = 0; i < m_iCurrencyCount; ++i)
     {
@@ -660,7 +690,8 @@ void currency_handler_render(void)
         }
         else if (currentState == SPACE)
         {
-            entity2d_render_simple(pEnt);
+            /* Drawn with the rest of the SPACE world by render_queue_flush */
+            render_queue_entity(RENDER_LAYER_CURRENCY, pEnt, false);
         }
         else
         {
@@ -41,6 +41,7 @@
 #include <sys/types.h>
 
 #define TRANSITION_HOLD_SEC 0.0f
+#define TILEMAP_LOAD_FRAME_BUDGET_US 3000 /* Staged tilemap load work per frame during landing transitions */
 
 ////////////////////////////////////////////////////////////
 /// SAVE
@@ -291,6 +292,39 @@ static void enter_state_space(void)
     gp_state_snap_space_transition();
 }
 
+/* Start loading the tilemap of the layer we are landing on, in steps during the landing animation (see gp_state_update).
+ * PLANET and SURFACE share the same tilemap, so nothing is loaded if it is already the current one. */
+static void preload_layer_tilemap(gp_state_t _state)
+{
+    if (_state != PLANET && _state != SURFACE && _state != JNR)
+        return;
+
+    const char *pFolder = get_layer_folder(_state);
+    if (!pFolder)
+        return;
+
+    tilemap_type_t eType = (_state == JNR) ? TILEMAP_TYPE_JNR : TILEMAP_TYPE_SURFACE;
+    const char *pLoadedFolder = tilemap_get_loaded_folder();
+    if (eType == TILEMAP_TYPE_SURFACE && pLoadedFolder && strcmp(pLoadedFolder, pFolder) == 0)
+        return;
+
+    /* Recently visited maps are still resident: tilemap_init takes them over instantly */
+    if (tilemap_is_resident(pFolder, eType))
+        return;
+
+    tilemap_load_begin(pFolder, eType);
+}
+
+/* Make pFolder the active tilemap: hand over the staged load started when landing (finishing it if needed), or load it now */
+static void acquire_layer_tilemap(const char *_pFolder, tilemap_type_t _eType)
+{
+    if (tilemap_load_is_pending(_pFolder, _eType) && tilemap_load_finish())
+        return;
+
+    tilemap_load_cancel(); /* stale load for another map */
+    tilemap_init(_pFolder, _eType);
+}
+
 static void enter_state_planet(bool _bFromAbove)
 {
     /* Initialize entities valid in PLANET mode */
@@ -306,7 +340,7 @@ static void enter_state_planet(bool _bFromAbove)
         const char *pLoadedFolder = tilemap_get_loaded_folder();
         if (!pLoadedFolder || strcmp(pLoadedFolder, pFolder) != 0)
         {
-            tilemap_init(pFolder, TILEMAP_TYPE_SURFACE);
+            acquire_layer_tilemap(pFolder, TILEMAP_TYPE_SURFACE);
         }
 
         /* Refresh currency handler (loads currency.csv and creates currency entities).
@@ -346,7 +380,7 @@ static void enter_state_surface(bool _bFromAbove)
         const char *pLoadedFolder = tilemap_get_loaded_folder();
         if (!pLoadedFolder || strcmp(pLoadedFolder, pFolder) != 0)
         {
-            tilemap_init(pFolder, TILEMAP_TYPE_SURFACE);
+            acquire_layer_tilemap(pFolder, TILEMAP_TYPE_SURFACE);
         }
 
         /* Refresh currency handler (loads currency.csv and creates currency entities).
@@ -383,7 +417,7 @@ static void enter_state_jnr(void)
     const char *pFolder = get_layer_folder(JNR);
     if (pFolder)
     {
-        tilemap_init(pFolder, TILEMAP_TYPE_JNR);
+        acquire_layer_tilemap(pFolder, TILEMAP_TYPE_JNR);
         triggers_load_init(pFolder);
         triggers_dialogue_init(pFolder);
         audio_play_music(MUSIC_NORMAL, pFolder);
@@ -455,6 +489,7 @@ void gp_state_land(void)
 
     m_targetState = gp_state_current + 1;
     m_transState = TRANS_LAND_ANIM;
+    preload_layer_tilemap(m_targetState);
     /* Only play UFO animation for states where UFO exists (SPACE, PLANET, SURFACE) */
     /* Skip animation for SURFACE->JNR transition as UFO is not active in JNR */
     if (gp_state_current != SURFACE || m_targetState != JNR)
@@ -503,6 +538,7 @@ static void perform_state_switch(gp_state_t oldState, gp_state_t newState)
     if (oldState == PLANET && newState == SPACE)
     {
         tilemap_free();
+        tilemap_residency_flush(); /* Leaving the planet: parked maps are not needed in SPACE */
         ufo_free();
         weapons_free();
         tractor_beam_free();
@@ -628,6 +664,10 @@ void gp_state_init_scene(void)
 
 void gp_state_update(void)
 {
+    /* Advance a staged tilemap load (started by gp_state_land) while the transition plays */
+    if (m_transState != TRANS_NONE)
+        tilemap_load_update(TILEMAP_LOAD_FRAME_BUDGET_US);
+
     switch (m_transState)
     {
     case TRANS_NONE:
@@ -1034,6 +1074,7 @@ void gp_state_set_persist(const gp_state_persist_t *_pIn)
 
     /* Reset any transition-in-progress state to avoid “half-transition” after load */
     m_transState = TRANS_NONE;
+    tilemap_load_cancel(); /* Tilemap staged by a dropped landing */
     m_targetState = gp_state_current;
     m_fHoldTimer = 0.0f;
 
@@ -1160,6 +1201,7 @@ void gp_state_set(gp_state_t _eState)
 
     /* Keep internals coherent if called externally */
     m_transState = TRANS_NONE;
+    tilemap_load_cancel(); /* Tilemap staged by a dropped landing */
     m_targetState = gp_state_current;
     m_fHoldTimer = 0.0f;
 
@@ -1,6 +1,7 @@
 #include "item_turbo.h"
 #include "../audio.h"
 #include "../camera.h"
+#include "../render_queue.h"
 #include "../resource_helper.h"
 #include "libdragon.h"
 #include "ufo.h"
@@ -76,7 +77,7 @@ static void render_items_array(const ItemTurboInstance *pItems, size_t iCount)
     {
         const ItemTurboInstance *pItem = &pItems[i];
         const struct entity2D *pEnt = &pItem->entity;
-        entity2d_render_simple(pEnt);
+        render_queue_entity(RENDER_LAYER_PICKUPS, pEnt, false);
     }
 }
 
@@ -201,12 +202,9 @@ void item_turbo_update(void)
     update_items_array(m_aTurboItemsDynamic, m_iTurboItemCountDynamic, pUfoEntity);
 }
 
-/* Render turbo items */
+/* Queue turbo items (drawn by render_queue_flush) */
 void item_turbo_render(void)
 {
-    rdpq_set_mode_standard();
-    rdpq_mode_alphacompare(1); /* draw pixels with alpha >= 1 (colorkey style) */
-
     render_items_array(m_aTurboItemsStatic, m_iTurboItemCountStatic);
     render_items_array(m_aTurboItemsDynamic, m_iTurboItemCountDynamic);
 }
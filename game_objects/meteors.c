@@ -7,6 +7,7 @@
 #include "../frame_time.h"
 #include "../math2d.h"
 #include "../minimap.h"
+#include "../render_queue.h"
 #include "../resource_helper.h"
 #include "../rng.h"
 #include "item_turbo.h"
@@ -42,10 +43,10 @@ void meteors_free(void)
     /* Also clear meteors from space_objects to prevent stale sprite pointers */
     /* Note: space_objects_free() handles general cleanup, but we do this here to explicitly
        nullify the sprite pointer since we are freeing the sprite resource itself. */
-    int iMax = space_objects_get_max_count();
-    for (int i = 0; i < iMax; i++)
+    int iCount = space_objects_get_active_count();
+    for (int i = 0; i < iCount; i++)
     {
-        SpaceObject *obj = space_objects_get_object(i);
+        SpaceObject *obj = space_objects_get_active(i);
         if (obj && obj->bAllocated && obj->type == SO_METEOR)
         {
             /* Instead of just marking for delete, immediately deactivate and clear pointer */
@@ -55,6 +56,9 @@ void meteors_free(void)
             obj->entity.pSprite = NULL;
         }
     }
+
+    /* Parked meteors hold sprite pointers too */
+    space_objects_clear_dormant();
 }
 
 void meteors_init(void)
@@ -126,19 +130,30 @@ void meteors_init(void)
                     entity2d_init_from_sprite(&pMeteor->entity, vSpawnPos, m_pMeteorSprite, uFlags, uLayerMask);
 
                     pMeteor->entity.fAngleRad = rngf(-FM_PI, FM_PI);
-                    pMeteor->entity.vVel = vec2_make(randf_symmetric(METEOR_MAX_SPEED), randf_symmetric(METEOR_MAX_SPEED));
+                    space_object_set_velocity(pMeteor, vec2_make(randf_symmetric(METEOR_MAX_SPEED), randf_symmetric(METEOR_MAX_SPEED)));
                     pMeteor->entity.iCollisionRadius = 12;
 
                     /* Configure meteor data */
-                    pMeteor->data.meteor.fRotationSpeed = randf_symmetric(METEOR_MAX_ROT_SPEED);
-                    pMeteor->data.meteor.fTintFrames = 0.0f;
-                    pMeteor->data.meteor.iFramesAlive = 0;
+                    pMeteor->pData->meteor.fRotationSpeed = randf_symmetric(METEOR_MAX_ROT_SPEED);
+                    pMeteor->pData->meteor.fTintFrames = 0.0f;
+                    pMeteor->pData->meteor.iFramesAlive = 0;
 
                     pMeteor->iHitPoints = METEOR_HITPOINTS;
-                    pMeteor->bSleeping = false;
+                    space_object_set_sleeping(pMeteor, false);
 
                     iTotalSpawned++;
                 }
+                else if (space_objects_spawn_meteor_dormant(vSpawnPos,
+                                                            m_pMeteorSprite,
+                                                            rngf(-FM_PI, FM_PI),
+                                                            randf_symmetric(METEOR_MAX_ROT_SPEED),
+                                                            12,
+                                                            METEOR_HITPOINTS,
+                                                            0))
+                {
+                    /* Pool full: park it, it wakes once the camera comes close */
+                    iTotalSpawned++;
+                }
             }
         }
         fclose(pFile);
@@ -156,7 +171,7 @@ void meteor_apply_damage(SpaceObject *pMeteor, int iDamage, struct vec2 vImpactD
         return;
 
     /* Currency meteor special handling */
-    if (pMeteor->data.meteor.uCurrencyId > 0)
+    if (pMeteor->pData->meteor.uCurrencyId > 0)
     {
         /* Always apply impact force (even if damage is 0) */
         if (vec2_mag_sq(vImpactDir) > 1e-6f)
@@ -165,7 +180,7 @@ void meteor_apply_damage(SpaceObject *pMeteor, int iDamage, struct vec2 vImpactD
             struct vec2 vNormalized = vec2_normalize(vImpactDir);
             float fImpactStrength = vec2_mag(vImpactDir);
             struct vec2 vImpulse = vec2_scale(vNormalized, fImpactStrength);
-            pMeteor->entity.vVel = vec2_add(pMeteor->entity.vVel, vImpulse);
+            space_object_set_velocity(pMeteor, vec2_add(pMeteor->entity.vVel, vImpulse));
         }
 
         /* Normal bullets (damage = 1) don't damage currency meteors */
@@ -178,25 +193,25 @@ void meteor_apply_damage(SpaceObject *pMeteor, int iDamage, struct vec2 vImpactD
         /* Only apply tint and reduce hit points if actual damage was applied */
         if (iDamage > 0)
         {
-            pMeteor->data.meteor.fTintFrames = (float)METEOR_TINT_FRAMES;
+            pMeteor->pData->meteor.fTintFrames = (float)METEOR_TINT_FRAMES;
             pMeteor->iHitPoints -= iDamage;
         }
     }
     else
     {
         /* Normal meteor behavior */
-        pMeteor->data.meteor.fTintFrames = (float)METEOR_TINT_FRAMES;
+        pMeteor->pData->meteor.fTintFrames = (float)METEOR_TINT_FRAMES;
         pMeteor->iHitPoints -= iDamage;
     }
 
     if (pMeteor->iHitPoints <= 0)
     {
         /* Check if this is a currency meteor - spawn currency before destroying */
-        if (pMeteor->data.meteor.uCurrencyId > 0)
+        if (pMeteor->pData->meteor.uCurrencyId > 0)
         {
             /* Spawn currency entity at meteor position */
             extern void currency_handler_spawn_from_meteor(struct vec2 vPos, uint8_t uCurrencyId);
-            currency_handler_spawn_from_meteor(pMeteor->entity.vPos, pMeteor->data.meteor.uCurrencyId);
+            currency_handler_spawn_from_meteor(pMeteor->entity.vPos, pMeteor->pData->meteor.uCurrencyId);
         }
 
         /* Disable meteor and play explosion */
@@ -225,9 +240,6 @@ sprite_t *meteors_get_crystal_sprite(void)
 
 void meteor_render_object(SpaceObject *pMeteor, struct vec2i vScreen, float fZoom)
 {
-    /* Mode setting removed - handled by space_objects_render batching */
-    // rdpq_mode_combiner(RDPQ_COMBINER_TEX_FLAT);
-    // rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
     const struct entity2D *pEnt = &pMeteor->entity;
     if (!pEnt->pSprite)
         return;
@@ -240,21 +252,7 @@ void meteor_render_object(SpaceObject *pMeteor, struct vec2i vScreen, float fZoo
         .theta = pEnt->fAngleRad,
     };
 
-    /* Tint on hit to show feedback: modulate texture with prim color */
-    /* Optimized: only set color if tinted, otherwise assume default white (set in batch start) */
-    if (pMeteor->data.meteor.fTintFrames > 0.0f)
-    {
-        rdpq_set_prim_color(RGBA32(255, 100, 100, 255));
-
-        /* Render */
-        rdpq_sprite_blit(pEnt->pSprite, vScreen.iX, vScreen.iY, &parms);
-
-        /* Restore default white for next object in batch */
-        rdpq_set_prim_color(RGBA32(255, 255, 255, 255));
-    }
-    else
-    {
-        /* Render (color is already white) */
-        rdpq_sprite_blit(pEnt->pSprite, vScreen.iX, vScreen.iY, &parms);
-    }
+    /* Tint on hit to show feedback: modulate texture with prim color (the queue only sets it when it changes) */
+    color_t tint = (pMeteor->pData->meteor.fTintFrames > 0.0f) ? RGBA32(255, 100, 100, 255) : RGBA32(255, 255, 255, 255);
+    render_queue_sprite(RENDER_LAYER_OBJECTS, RENDER_MODE_TINTED, pEnt->pSprite, vScreen.iX, vScreen.iY, &parms, tint);
 }
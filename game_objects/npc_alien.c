@@ -90,7 +90,7 @@ NpcAlienInstance *npc_alien_create(npc_type_t type)
     if (!pObj)
         return NULL;
 
-    NpcData *pData = &pObj->data.npc;
+    NpcData *pData = &pObj->pData->npc;
 
     /* Initialize NpcData */
     pData->type = type;
@@ -137,7 +137,7 @@ NpcAlienInstance *npc_alien_create(npc_type_t type)
     }
 
     pObj->entity.fAngleRad = 0.0f;
-    pObj->entity.vVel = vec2_zero();
+    space_object_set_velocity(pObj, vec2_zero());
     pObj->iHitPoints = 100; /* Default HP */
 
     return pObj;
@@ -149,7 +149,7 @@ void npc_alien_destroy(NpcAlienInstance *pInstance)
         return;
 
     /* Cleanup resources */
-    NpcData *pData = &pInstance->data.npc;
+    NpcData *pData = &pInstance->pData->npc;
 
     /* Stop engine sound if playing */
     int iChannel = (pData->type == NPC_TYPE_ALIEN) ? MIXER_CHANNEL_NPC_ALIEN : MIXER_CHANNEL_NPC_RHINO;
@@ -211,6 +211,7 @@ static void npc_alien_update_physics(SpaceObject *pObj, const struct vec2 *pvTar
     struct vec2 vToTarget = vec2_sub(*pvTargetPos, pObj->entity.vPos);
     float fDistanceToTarget = vec2_mag(vToTarget);
     bool bAccelerating = false;
+    struct vec2 vVel = pObj->entity.vVel;
 
     if (!bInHitCooldown && fDistanceToTarget > 1e-6f)
     {
@@ -222,31 +223,32 @@ static void npc_alien_update_physics(SpaceObject *pObj, const struct vec2 *pvTar
         }
 
         struct vec2 vAccel = vec2_scale(vDirToTarget, NPC_ALIEN_ACCELERATION * fAccelScale);
-        pObj->entity.vVel = vec2_add(pObj->entity.vVel, vec2_scale(vAccel, fFrameMul));
+        vVel = vec2_add(vVel, vec2_scale(vAccel, fFrameMul));
         bAccelerating = true;
 
-        float fVelDot = vec2_dot(pObj->entity.vVel, vDirToTarget);
+        float fVelDot = vec2_dot(vVel, vDirToTarget);
         if (fVelDot < 0.0f || fDistanceToTarget < NPC_ALIEN_SLOWDOWN_DISTANCE * 0.5f)
         {
             struct vec2 vBrake = vec2_scale(vDirToTarget, fVelDot);
-            pObj->entity.vVel = vec2_sub(pObj->entity.vVel, vec2_scale(vBrake, 0.3f * fFrameMul));
+            vVel = vec2_sub(vVel, vec2_scale(vBrake, 0.3f * fFrameMul));
         }
     }
 
     float fDampingBase = bAccelerating ? NPC_ALIEN_VELOCITY_DAMPING : NPC_ALIEN_VELOCITY_DECAY;
     float fDamping = powf(fDampingBase, fFrameMul);
-    pObj->entity.vVel = vec2_scale(pObj->entity.vVel, fDamping);
+    vVel = vec2_scale(vVel, fDamping);
 
-    float fSpeed = vec2_mag(pObj->entity.vVel);
+    float fSpeed = vec2_mag(vVel);
     if (fSpeed > NPC_ALIEN_MAX_SPEED)
     {
-        pObj->entity.vVel = vec2_scale(pObj->entity.vVel, NPC_ALIEN_MAX_SPEED / fSpeed);
+        vVel = vec2_scale(vVel, NPC_ALIEN_MAX_SPEED / fSpeed);
     }
+    space_object_set_velocity(pObj, vVel);
 }
 
 static void npc_alien_update_path_pause_resume(SpaceObject *pObj, const struct vec2 *pvPathPos, bool bInHitCooldown)
 {
-    NpcData *pData = &pObj->data.npc;
+    NpcData *pData = &pObj->pData->npc;
     struct vec2 vPlayerPos = ufo_get_position();
     float fUfoNpcDistance = vec2_dist(pObj->entity.vPos, vPlayerPos);
     float fNpcPathDistance = vec2_dist(pObj->entity.vPos, *pvPathPos);
@@ -278,7 +280,7 @@ void npc_alien_update_object(SpaceObject *pObj)
     if (!pObj || !entity2d_is_active(&pObj->entity))
         return;
 
-    NpcData *pData = &pObj->data.npc;
+    NpcData *pData = &pObj->pData->npc;
     float fFrameMul = frame_time_mul();
     uint32_t uCurrentMs = get_ticks_ms();
     bool bIsGrabbed = pObj->entity.bGrabbed;
@@ -400,7 +402,7 @@ void npc_alien_update_object(SpaceObject *pObj)
     }
 
     /* Update position (tractor beam sets velocity directly, so this still works) */
-    pObj->entity.vPos = vec2_add(pObj->entity.vPos, vec2_scale(pObj->entity.vVel, fFrameMul));
+    space_object_set_position(pObj, vec2_add(pObj->entity.vPos, vec2_scale(pObj->entity.vVel, fFrameMul)));
     pData->fThrusterAnimFrame += fFrameMul;
 
     /* Target-reached checking still works when grabbed (checked after position update) */
@@ -432,7 +434,7 @@ void npc_alien_render_object(SpaceObject *pObj, struct vec2i vScreen, float fZoo
 {
     if (!pObj)
         return;
-    NpcData *pData = &pObj->data.npc;
+    NpcData *pData = &pObj->pData->npc;
     int iCenterX = vScreen.iX;
     int iCenterY = vScreen.iY;
 
@@ -507,14 +509,14 @@ PathInstance **npc_alien_get_path_ptr(NpcAlienInstance *pInstance)
 {
     if (!pInstance)
         return NULL;
-    return &pInstance->data.npc.pPath;
+    return &pInstance->pData->npc.pPath;
 }
 
 void npc_alien_set_path(NpcAlienInstance *pInstance, PathInstance *pPath, bool bPositionEntity, bool bWaitForPlayer)
 {
     if (!pInstance)
         return;
-    NpcData *pData = &pInstance->data.npc;
+    NpcData *pData = &pInstance->pData->npc;
 
     if (pData->pPath)
     {
@@ -527,7 +529,7 @@ void npc_alien_set_path(NpcAlienInstance *pInstance, PathInstance *pPath, bool b
     if (pPath && bPositionEntity)
     {
         struct vec2 vInitialPos = path_mover_get_current_pos(pPath);
-        entity2d_set_pos(&pInstance->entity, vInitialPos);
+        space_object_set_position(pInstance, vInitialPos);
     }
     npc_alien_reset_reached_target(pInstance);
     pData->vDirectTarget = vec2_zero();
@@ -537,7 +539,7 @@ void npc_alien_set_direct_target(NpcAlienInstance *pInstance, struct vec2 vTarge
 {
     if (!pInstance)
         return;
-    NpcData *pData = &pInstance->data.npc;
+    NpcData *pData = &pInstance->pData->npc;
     pData->vDirectTarget = vTarget;
     pData->bWaitForPlayer = bWaitForPlayer;
     npc_alien_reset_reached_target(pInstance);
@@ -546,13 +548,13 @@ void npc_alien_set_direct_target(NpcAlienInstance *pInstance, struct vec2 vTarge
 
 bool npc_alien_get_reached_target(NpcAlienInstance *pInstance)
 {
-    return pInstance ? pInstance->data.npc.bReachedTarget : false;
+    return pInstance ? pInstance->pData->npc.bReachedTarget : false;
 }
 
 void npc_alien_reset_reached_target(NpcAlienInstance *pInstance)
 {
     if (pInstance)
-        pInstance->data.npc.bReachedTarget = false;
+        pInstance->pData->npc.bReachedTarget = false;
 }
 
 /* Legacy wrappers removed */
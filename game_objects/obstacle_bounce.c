@@ -1,5 +1,6 @@
 #include "obstacle_bounce.h"
 #include "../camera.h"
+#include "../render_queue.h"
 #include "../resource_helper.h"
 #include "libdragon.h"
 #include "ufo.h"
@@ -100,16 +101,13 @@ void obstacle_bounce_update(void)
     }
 }
 
-/* Render bounce obstacles */
+/* Queue bounce obstacles (drawn by render_queue_flush) */
 void obstacle_bounce_render(void)
 {
-    rdpq_set_mode_standard();
-    rdpq_mode_alphacompare(1); /* draw pixels with alpha >= 1 (colorkey style) */
-
     for (size_t i = 0; i < m_iBounceObstacleCount; ++i)
     {
         const ObstacleBounceInstance *pObstacle = &m_aBounceObstacles[i];
         const struct entity2D *pEnt = &pObstacle->entity;
-        entity2d_render_simple(pEnt);
+        render_queue_entity(RENDER_LAYER_PICKUPS, pEnt, false);
     }
 }
@@ -4,6 +4,7 @@
 #include "../font_helper.h"
 #include "../math_helper.h"
 #include "../minimap.h"
+#include "../render_queue.h"
 #include "../resource_helper.h"
 #include "../string_helper.h"
 #include "../triggers.h"
@@ -331,10 +332,10 @@ void planets_update(void)
     trigger_collection_update_with_entity(&m_planetTriggers, pUfoEntity);
 }
 
-/* Helper: Render entity with scale rules (used for both planets and deco objects)
- * Returns true if rendered, false if skipped (not visible, no sprite, etc.)
+/* Helper: Queue entity with scale rules (used for both planets and deco objects)
+ * Returns true if queued, false if skipped (not visible, no sprite, etc.)
  * Outputs screen position for caller use (e.g., planet name rendering) */
-static bool render_entity_with_scale(const struct entity2D *_pEnt, bool _bMinimapActive, float _fZoom, struct vec2i *_pOutScreenPos)
+static bool render_entity_with_scale(const struct entity2D *_pEnt, render_layer_t _eLayer, bool _bMinimapActive, float _fZoom, struct vec2i *_pOutScreenPos)
 {
     if (!_pEnt)
         return false;
@@ -359,9 +360,10 @@ static bool render_entity_with_scale(const struct entity2D *_pEnt, bool _bMinima
     if (!_pEnt->pSprite)
         return false;
 
-    /* Render with clamped zoom */
+    /* Render with clamped zoom; filter based on zoom */
+    render_mode_t eMode = (_fZoom != 1.0f) ? RENDER_MODE_SPRITE_SMOOTH : RENDER_MODE_SPRITE;
     rdpq_blitparms_t parms = {.cx = _pEnt->vHalf.iX, .cy = _pEnt->vHalf.iY, .scale_x = _fZoom, .scale_y = _fZoom, .theta = 0.0f};
-    rdpq_sprite_blit(_pEnt->pSprite, vScreenPos.iX, vScreenPos.iY, &parms);
+    render_queue_sprite(_eLayer, eMode, _pEnt->pSprite, vScreenPos.iX, vScreenPos.iY, &parms, RGBA32(255, 255, 255, 255));
 
     /* Output values for caller */
     if (_pOutScreenPos)
@@ -370,7 +372,24 @@ static bool render_entity_with_scale(const struct entity2D *_pEnt, bool _bMinima
     return true;
 }
 
-/* Render planets */
+/* Render queue callback: planet name below its sprite (minimap) */
+static void render_planet_label(void *_pContext, int _iX, int _iY, float _fScale)
+{
+    const PlanetInstance *pPlanet = (const PlanetInstance *)_pContext;
+    const struct entity2D *pEnt = &pPlanet->entity;
+
+    char szDisplayName[64];
+    if (string_helper_nice_location_name(pPlanet->szName, szDisplayName, sizeof(szDisplayName)))
+    {
+        float fTextWidth = font_helper_get_text_width(FONT_NORMAL, szDisplayName);
+        float fScaledPadding = (UI_DESIGNER_PADDING / 2.0f) * _fScale;
+        int iTextX = (int)(_iX - fTextWidth / 2.0f);
+        int iTextY = _iY + (int)((float)pEnt->vHalf.iY * _fScale) + (int)fScaledPadding + UI_FONT_Y_OFFSET;
+        rdpq_text_printf(NULL, FONT_NORMAL, iTextX, iTextY, "%s", szDisplayName);
+    }
+}
+
+/* Queue planets (drawn by render_queue_flush) */
 void planets_render(void)
 {
     bool bMinimapActive = minimap_is_active();
@@ -381,56 +400,21 @@ void planets_render(void)
     float fGlobalZoom = MIN_PLANET_SCALE + (1.0f - MIN_PLANET_SCALE) * (fCameraZoom - MINIMAP_ZOOM_LEVEL) / fZoomRange;
     fGlobalZoom = clampf(fGlobalZoom, MIN_PLANET_SCALE, 1.0f);
 
-    /* Setup RDP mode once for all planets/deco */
-    rdpq_set_mode_standard();
-    rdpq_mode_alphacompare(1); /* draw pixels with alpha >= 1 (colorkey style) */
-
-    /* Set filter based on zoom */
-    if (fGlobalZoom != 1.0f)
-        rdpq_mode_filter(FILTER_BILINEAR);
-    else
-        rdpq_mode_filter(FILTER_POINT);
-
-    /* Render decorative objects first (background layer) */
+    /* Decorative objects first (background layer) */
     for (size_t i = 0; i < m_iDecoCount; ++i)
     {
-        render_entity_with_scale(&m_aDeco[i], bMinimapActive, fGlobalZoom, NULL);
+        render_entity_with_scale(&m_aDeco[i], RENDER_LAYER_DECO, bMinimapActive, fGlobalZoom, NULL);
     }
 
-    /* Render planets */
-    struct vec2i aPlanetScreenPos[MAX_PLANETS];
-    bool aPlanetVisible[MAX_PLANETS];
-
     for (size_t i = 0; i < m_iPlanetCount; ++i)
     {
-        const PlanetInstance *pPlanet = &m_aPlanets[i];
-        const struct entity2D *pEnt = &pPlanet->entity;
-
-        aPlanetVisible[i] = render_entity_with_scale(pEnt, bMinimapActive, fGlobalZoom, &aPlanetScreenPos[i]);
-    }
-
-    /* Render planet names below sprite when minimap is active */
-    if (bMinimapActive)
-    {
-        for (size_t i = 0; i < m_iPlanetCount; ++i)
-        {
-            if (!aPlanetVisible[i])
-                continue;
-
-            const PlanetInstance *pPlanet = &m_aPlanets[i];
-            const struct entity2D *pEnt = &pPlanet->entity;
-            struct vec2i vScreenPos = aPlanetScreenPos[i];
+        PlanetInstance *pPlanet = &m_aPlanets[i];
+        struct vec2i vScreenPos;
+        bool bVisible = render_entity_with_scale(&pPlanet->entity, RENDER_LAYER_PLANETS, bMinimapActive, fGlobalZoom, &vScreenPos);
 
-            char szDisplayName[64];
-            if (string_helper_nice_location_name(pPlanet->szName, szDisplayName, sizeof(szDisplayName)))
-            {
-                float fTextWidth = font_helper_get_text_width(FONT_NORMAL, szDisplayName);
-                float fScaledPadding = (UI_DESIGNER_PADDING / 2.0f) * fGlobalZoom;
-                int iTextX = (int)(vScreenPos.iX - fTextWidth / 2.0f);
-                int iTextY = vScreenPos.iY + (int)((float)pEnt->vHalf.iY * fGlobalZoom) + (int)fScaledPadding + UI_FONT_Y_OFFSET;
-                rdpq_text_printf(NULL, FONT_NORMAL, iTextX, iTextY, "%s", szDisplayName);
-            }
-        }
+        /* Planet names below sprite when minimap is active */
+        if (bVisible && bMinimapActive)
+            render_queue_custom(RENDER_LAYER_PLANET_LABELS, render_planet_label, pPlanet, vScreenPos.iX, vScreenPos.iY, fGlobalZoom);
     }
 }
 
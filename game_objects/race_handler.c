@@ -14,6 +14,7 @@
 #include "../math_helper.h"
 #include "../menu.h"
 #include "../minimap.h"
+#include "../render_queue.h"
 #include "../resource_helper.h"
 #include "../ui.h"
 #include "libdragon.h"
@@ -849,20 +850,24 @@ static void render_countdown(void)
         rdpq_text_printf(&m_tpCenterBoth, FONT_NORMAL, 0, 0, "%s", pText);
 }
 
+/* Render queue callback: the race track sets its own RDP state */
+static void render_race_track(void *_pContext, int _iX, int _iY, float _fScale)
+{
+    race_track_render();
+}
+
 void race_handler_render(void)
 {
     if (!m_handler.bInitialized || !race_track_is_initialized())
         return;
 
-    /* Render race track */
-    race_track_render();
+    /* Queue race track (layer below the coin) */
+    render_queue_custom(RENDER_LAYER_RACE_TRACK, render_race_track, NULL, 0, 0, 1.0f);
 
-    rdpq_set_mode_standard();
-    rdpq_mode_alphacompare(1);
-    /* Render coin entity if active */
+    /* Queue coin entity if active */
     if (entity2d_is_visible(&m_handler.coinEntity))
     {
-        entity2d_render_simple(&m_handler.coinEntity);
+        render_queue_entity(RENDER_LAYER_PICKUPS, &m_handler.coinEntity, false);
     }
 }
 
@@ -54,8 +54,8 @@ void race_handler_abort_race(void);
 /* _bCDown: C-down button pressed this frame (for restarting race at finish line) */
 void race_handler_update(bool _bCDown);
 
-/* Render race track and coin entity (world objects) */
-/* Internally calls race_track_render() */
+/* Queue race track and coin entity (world objects) for render_queue_flush */
+/* The track is drawn by race_track_render() from a custom queue item */
 void race_handler_render(void);
 
 /* Render race UI (coin slots, lap times, countdown) */
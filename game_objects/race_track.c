@@ -50,6 +50,25 @@ typedef struct
 static RaceTrackChunk *m_pChunks = NULL;
 static uint16_t m_uChunkCount = 0;
 
+/* Closest-segment grid over the track bounding box: each cell lists every segment that can be the nearest one
+ * for some point inside it, so closest-point queries test a handful of segments without search history.
+ * Cells farther than RACE_TRACK_GRID_COVERAGE from the track stay empty and fall back to the chunk search. */
+#define RACE_TRACK_GRID_CELL 32.0f      /* Cell size (doubled until the grid fits) */
+#define RACE_TRACK_GRID_MAX_CELLS 16384 /* Cap on cells (uint16 offsets per cell) */
+#define RACE_TRACK_GRID_COVERAGE (RACE_TRACK_HALF_COLLIDE + RACE_TRACK_BBOX_MARGIN) /* Distance from the centerline answered by the grid */
+
+static struct
+{
+    uint16_t *pCellStart; /* uCellsX * uCellsY + 1 offsets into pSegments */
+    uint16_t *pSegments;  /* Candidate segment indices, ascending per cell */
+    float fOriginX;
+    float fOriginY;
+    float fInvCellSize;
+    uint16_t uCellsX;
+    uint16_t uCellsY;
+    bool bValid;
+} m_grid = {0};
+
 /* Border textures */
 static sprite_t *m_pBorderSprite = NULL;
 static rdpq_texparms_t m_borderTexParms = {0};
@@ -70,10 +89,11 @@ static void compute_track_bounding_box(void);
 static bool is_position_near_track(struct vec2 _vPos);
 static void find_closest_point(struct vec2 _vPos, struct vec2 *_pOutClosest, struct vec2 *_pOutNormal, float *_pOutLateralDist, float *_pOutS);
 static bool check_track_collision(struct vec2 _vUfoPos, struct vec2 *_pOutClosest, struct vec2 *_pOutNormal, float *_pOutPenetration);
+static void build_track_grid(void);
+static void free_track_grid(void);
 
 /* Collision state */
 static bool m_bCollisionEnabled = true;
-static uint16_t m_uLastSegIndex = 0;
 static bool m_bWasColliding = false; /* Track previous collision state for edge detection */
 
 /* Bounding box for optimization */
@@ -566,6 +586,9 @@ void race_track_init(const char *_pRaceName)
 
     /* Build spatial chunks for culling optimization */
     build_track_chunks();
+
+    /* Build closest-segment grid for collision and progress queries */
+    build_track_grid();
 }
 
 void race_track_free(void)
@@ -589,6 +612,8 @@ void race_track_free(void)
         m_uChunkCount = 0;
     }
 
+    free_track_grid();
+
     SAFE_FREE_SPRITE(m_pBorderSprite);
     SAFE_FREE_SPRITE(m_pRoadSprite);
     SAFE_FREE_SPRITE(m_pFinishLineSprite);
@@ -596,7 +621,6 @@ void race_track_free(void)
     memset(&m_track, 0, sizeof(m_track));
     m_bBBoxValid = false;
     m_bCollisionEnabled = true;
-    m_uLastSegIndex = 0;
     m_bWasColliding = false;
     m_cachedCameraBounds.bValid = false;
 }
@@ -668,8 +692,8 @@ static bool is_position_near_track(struct vec2 _vPos)
     return (_vPos.fX >= m_fTrackMinX && _vPos.fX <= m_fTrackMaxX && _vPos.fY >= m_fTrackMinY && _vPos.fY <= m_fTrackMaxY);
 }
 
-/* Helper: Test a segment and update best result if closer */
-static void test_segment(uint16_t _uSegIndex, struct vec2 _vPos, float *_pBestDistSq, uint16_t *_pBestSegIndex, float *_pBestT, struct vec2 *_pBestClosest)
+/* Helper: Closest point on a segment; returns the squared distance */
+static float segment_closest_point(uint16_t _uSegIndex, struct vec2 _vPos, float *_pOutT, struct vec2 *_pOutClosest)
 {
     uint16_t uNext = (_uSegIndex == m_track.uSampleCount - 1) ? 0 : (_uSegIndex + 1);
     struct vec2 vSegStart = m_track.pSamples[_uSegIndex].vPos;
@@ -695,8 +719,19 @@ static void test_segment(uint16_t _uSegIndex, struct vec2 _vPos, float *_pBestDi
         vClosest = vec2_mix(vSegStart, vSegEnd, fT);
     }
 
-    struct vec2 vDelta = vec2_sub(_vPos, vClosest);
-    float fDistSq = vec2_mag_sq(vDelta);
+    if (_pOutT)
+        *_pOutT = fT;
+    if (_pOutClosest)
+        *_pOutClosest = vClosest;
+    return vec2_mag_sq(vec2_sub(_vPos, vClosest));
+}
+
+/* Helper: Test a segment and update best result if closer */
+static void test_segment(uint16_t _uSegIndex, struct vec2 _vPos, float *_pBestDistSq, uint16_t *_pBestSegIndex, float *_pBestT, struct vec2 *_pBestClosest)
+{
+    struct vec2 vClosest;
+    float fT;
+    float fDistSq = segment_closest_point(_uSegIndex, _vPos, &fT, &vClosest);
 
     if (fDistSq < *_pBestDistSq)
     {
@@ -707,85 +742,260 @@ static void test_segment(uint16_t _uSegIndex, struct vec2 _vPos, float *_pBestDi
     }
 }
 
-/* Find closest point on track polyline to given position */
-static void find_closest_point(struct vec2 _vPos, struct vec2 *_pOutClosest, struct vec2 *_pOutNormal, float *_pOutLateralDist, float *_pOutS)
+static void free_track_grid(void)
 {
-    if (!_pOutClosest || !_pOutNormal || !_pOutLateralDist || !_pOutS || !m_track.bInitialized || m_track.uSampleCount < 2)
+    free(m_grid.pCellStart);
+    free(m_grid.pSegments);
+    memset(&m_grid, 0, sizeof(m_grid));
+}
+
+/* Helper: Cell range covered by a segment's bounding box grown by _fReach (clamped to the grid) */
+static void grid_segment_cell_range(uint16_t _uSegIndex, float _fCellSize, float _fReach, int *_pMinX, int *_pMaxX, int *_pMinY, int *_pMaxY)
+{
+    uint16_t uNext = (_uSegIndex == m_track.uSampleCount - 1) ? 0 : (_uSegIndex + 1);
+    struct vec2 vA = m_track.pSamples[_uSegIndex].vPos;
+    struct vec2 vB = m_track.pSamples[uNext].vPos;
+
+    *_pMinX = (int)floorf((fminf(vA.fX, vB.fX) - _fReach - m_grid.fOriginX) / _fCellSize);
+    *_pMaxX = (int)floorf((fmaxf(vA.fX, vB.fX) + _fReach - m_grid.fOriginX) / _fCellSize);
+    *_pMinY = (int)floorf((fminf(vA.fY, vB.fY) - _fReach - m_grid.fOriginY) / _fCellSize);
+    *_pMaxY = (int)floorf((fmaxf(vA.fY, vB.fY) + _fReach - m_grid.fOriginY) / _fCellSize);
+    *_pMinX = (*_pMinX < 0) ? 0 : *_pMinX;
+    *_pMinY = (*_pMinY < 0) ? 0 : *_pMinY;
+    *_pMaxX = (*_pMaxX >= (int)m_grid.uCellsX) ? (int)m_grid.uCellsX - 1 : *_pMaxX;
+    *_pMaxY = (*_pMaxY >= (int)m_grid.uCellsY) ? (int)m_grid.uCellsY - 1 : *_pMaxY;
+}
+
+/* Helper: Count (or, with _bFill, store) a segment in the cells where it can be the nearest one */
+static void grid_visit_candidates(uint16_t _uSegIndex, const float *_pBound, float _fCellSize, float _fHalfDiag, float _fReach, bool _bFill, uint32_t *_pTotal)
+{
+    int iMinX, iMaxX, iMinY, iMaxY;
+    grid_segment_cell_range(_uSegIndex, _fCellSize, _fReach, &iMinX, &iMaxX, &iMinY, &iMaxY);
+    for (int y = iMinY; y <= iMaxY; ++y)
     {
-        if (_pOutClosest)
-            *_pOutClosest = vec2_zero();
-        if (_pOutNormal)
-            *_pOutNormal = vec2_make(1.0f, 0.0f);
-        if (_pOutLateralDist)
-            *_pOutLateralDist = 0.0f;
-        if (_pOutS)
-            *_pOutS = 0.0f;
+        for (int x = iMinX; x <= iMaxX; ++x)
+        {
+            uint32_t uCell = (uint32_t)y * m_grid.uCellsX + (uint32_t)x;
+            if (_pBound[uCell] > _fReach)
+                continue; /* Far from the track: fallback search */
+
+            struct vec2 vCenter = vec2_make(m_grid.fOriginX + ((float)x + 0.5f) * _fCellSize, m_grid.fOriginY + ((float)y + 0.5f) * _fCellSize);
+            if (sqrtf(segment_closest_point(_uSegIndex, vCenter, NULL, NULL)) - _fHalfDiag > _pBound[uCell])
+                continue;
+
+            if (_bFill)
+            {
+                m_grid.pSegments[--m_grid.pCellStart[uCell]] = _uSegIndex;
+            }
+            else
+            {
+                m_grid.pCellStart[uCell]++;
+                (*_pTotal)++;
+            }
+        }
+    }
+}
+
+/* Build the closest-segment grid (needs the bounding box).
+ * Per cell, with d = distance from the cell center to a segment and h = half the cell diagonal:
+ * the nearest segment of any point in the cell is at most U = min(d) + h away, and a segment can only be
+ * that close if d - h <= U. Those segments are the cell's candidates. Cells with U beyond the coverage
+ * reach keep no candidates. */
+static void build_track_grid(void)
+{
+    free_track_grid();
+
+    if (!m_bBBoxValid || m_track.uSampleCount < 2)
         return;
+
+    float fWidth = m_fTrackMaxX - m_fTrackMinX;
+    float fHeight = m_fTrackMaxY - m_fTrackMinY;
+    float fCellSize = RACE_TRACK_GRID_CELL;
+    uint32_t uCellsX, uCellsY;
+    for (;;)
+    {
+        uCellsX = (uint32_t)ceilf(fWidth / fCellSize);
+        uCellsY = (uint32_t)ceilf(fHeight / fCellSize);
+        uCellsX = (uCellsX < 1) ? 1 : uCellsX;
+        uCellsY = (uCellsY < 1) ? 1 : uCellsY;
+        if (uCellsX * uCellsY <= RACE_TRACK_GRID_MAX_CELLS)
+            break;
+        fCellSize *= 2.0f;
     }
 
-    float fBestDistSq = 1e10f;
-    uint16_t uBestSegIndex = 0;
-    float fBestT = 0.0f;
-    struct vec2 vBestClosest = vec2_zero();
-    bool bFoundInWindow = false;
+    uint32_t uCellCount = uCellsX * uCellsY;
+    float fHalfDiag = fCellSize * 0.7072f; /* Half diagonal, rounded up for points on cell edges */
+    float fReach = RACE_TRACK_GRID_COVERAGE + 2.0f * fHalfDiag; /* Covers every point within RACE_TRACK_GRID_COVERAGE */
+
+    m_grid.fOriginX = m_fTrackMinX;
+    m_grid.fOriginY = m_fTrackMinY;
+    m_grid.fInvCellSize = 1.0f / fCellSize;
+    m_grid.uCellsX = (uint16_t)uCellsX;
+    m_grid.uCellsY = (uint16_t)uCellsY;
 
-    /* First, try searching in window around last known segment (with wrapping) */
-    if (m_uLastSegIndex < m_track.uSampleCount)
+    float *pBound = (float *)malloc(sizeof(float) * uCellCount);
+    m_grid.pCellStart = (uint16_t *)calloc(uCellCount + 1, sizeof(uint16_t));
+    if (!pBound || !m_grid.pCellStart)
     {
-        /* Search window segments, handling wrap-around */
-        for (int16_t iOffset = -(int16_t)RACE_TRACK_SEARCH_WINDOW; iOffset <= (int16_t)RACE_TRACK_SEARCH_WINDOW; ++iOffset)
-        {
-            int16_t iSegIndex = (int16_t)m_uLastSegIndex + iOffset;
+        debugf("race_track: Failed to allocate closest-segment grid (%lu cells)\n", (unsigned long)uCellCount);
+        free(pBound);
+        free_track_grid();
+        return;
+    }
 
-            /* Wrap index to valid range */
-            while (iSegIndex < 0)
-                iSegIndex += (int16_t)m_track.uSampleCount;
-            while (iSegIndex >= (int16_t)m_track.uSampleCount)
-                iSegIndex -= (int16_t)m_track.uSampleCount;
+    for (uint32_t c = 0; c < uCellCount; ++c)
+        pBound[c] = 1e10f;
 
-            test_segment((uint16_t)iSegIndex, _vPos, &fBestDistSq, &uBestSegIndex, &fBestT, &vBestClosest);
-            bFoundInWindow = true;
+    /* Pass 1: per-cell bound on the nearest-segment distance */
+    for (uint16_t i = 0; i < m_track.uSampleCount; ++i)
+    {
+        int iMinX, iMaxX, iMinY, iMaxY;
+        grid_segment_cell_range(i, fCellSize, fReach, &iMinX, &iMaxX, &iMinY, &iMaxY);
+        for (int y = iMinY; y <= iMaxY; ++y)
+        {
+            for (int x = iMinX; x <= iMaxX; ++x)
+            {
+                struct vec2 vCenter = vec2_make(m_grid.fOriginX + ((float)x + 0.5f) * fCellSize, m_grid.fOriginY + ((float)y + 0.5f) * fCellSize);
+                float fBound = sqrtf(segment_closest_point(i, vCenter, NULL, NULL)) + fHalfDiag;
+                uint32_t uCell = (uint32_t)y * uCellsX + (uint32_t)x;
+                if (fBound < pBound[uCell])
+                    pBound[uCell] = fBound;
+            }
         }
     }
 
-    /* If not found in window, do full search (optimized with chunks if available) */
-    if (!bFoundInWindow)
+    /* Pass 2: count candidates per cell */
+    uint32_t uTotal = 0;
+    for (uint16_t i = 0; i < m_track.uSampleCount; ++i)
+        grid_visit_candidates(i, pBound, fCellSize, fHalfDiag, fReach, false, &uTotal);
+
+    if (uTotal > UINT16_MAX)
     {
-        debugf("race_track: Full search triggered (lastSegIndex=%d, sampleCount=%d)\n", m_uLastSegIndex, m_track.uSampleCount);
+        debugf("race_track: Closest-segment grid too large (%lu candidates), using chunk search\n", (unsigned long)uTotal);
+        free(pBound);
+        free_track_grid();
+        return;
+    }
 
-        if (m_pChunks && m_uChunkCount > 0)
+    /* Counts to end offsets */
+    uint32_t uSum = 0;
+    for (uint32_t c = 0; c < uCellCount; ++c)
+    {
+        uSum += m_grid.pCellStart[c];
+        m_grid.pCellStart[c] = (uint16_t)uSum;
+    }
+    m_grid.pCellStart[uCellCount] = (uint16_t)uSum;
+
+    m_grid.pSegments = (uint16_t *)malloc(sizeof(uint16_t) * (uTotal > 0 ? uTotal : 1));
+    if (!m_grid.pSegments)
+    {
+        debugf("race_track: Failed to allocate closest-segment grid (%lu candidates)\n", (unsigned long)uTotal);
+        free(pBound);
+        free_track_grid();
+        return;
+    }
+
+    /* Pass 3: fill back to front, which leaves each cell's offset at its start and its list ascending */
+    for (int32_t i = (int32_t)m_track.uSampleCount - 1; i >= 0; --i)
+        grid_visit_candidates((uint16_t)i, pBound, fCellSize, fHalfDiag, fReach, true, NULL);
+
+    free(pBound);
+    m_grid.bValid = true;
+}
+
+/* Find the nearest segment: grid cell candidates near the track, exact chunk search elsewhere */
+static void find_closest_segment(struct vec2 _vPos, uint16_t *_pOutSegIndex, float *_pOutT, struct vec2 *_pOutClosest)
+{
+    float fBestDistSq = 1e10f;
+    uint16_t uBestSegIndex = 0;
+    float fBestT = 0.0f;
+    struct vec2 vBestClosest = m_track.pSamples[0].vPos;
+
+    if (m_grid.bValid)
+    {
+        int iCellX = (int)floorf((_vPos.fX - m_grid.fOriginX) * m_grid.fInvCellSize);
+        int iCellY = (int)floorf((_vPos.fY - m_grid.fOriginY) * m_grid.fInvCellSize);
+        if (iCellX >= 0 && iCellX < (int)m_grid.uCellsX && iCellY >= 0 && iCellY < (int)m_grid.uCellsY)
         {
-            /* Optimized search: check chunks first */
-            /* float fExpand = RACE_TRACK_WIDTH * 0.5f + RACE_TRACK_CHUNK_SIZE * RACE_TRACK_STEP * 0.5f; */ /* Conservative search radius unused for now */
+            uint32_t uCell = (uint32_t)iCellY * m_grid.uCellsX + (uint32_t)iCellX;
+            uint16_t uStart = m_grid.pCellStart[uCell];
+            uint16_t uEnd = m_grid.pCellStart[uCell + 1];
+            for (uint16_t i = uStart; i < uEnd; ++i)
+                test_segment(m_grid.pSegments[i], _vPos, &fBestDistSq, &uBestSegIndex, &fBestT, &vBestClosest);
 
-            for (uint16_t c = 0; c < m_uChunkCount; ++c)
+            if (uEnd > uStart)
             {
-                const RaceTrackChunk *pChunk = &m_pChunks[c];
-
-                /* Check if point is near chunk (AABB check with margin) */
-                /* We use a looser check here to be safe */
-                if (_vPos.fX >= pChunk->fMinX - 50.0f && _vPos.fX <= pChunk->fMaxX + 50.0f && _vPos.fY >= pChunk->fMinY - 50.0f && _vPos.fY <= pChunk->fMaxY + 50.0f)
-                {
-                    /* Search inside this chunk */
-                    for (uint16_t i = pChunk->uStartIndex; i < pChunk->uEndIndex; ++i)
-                    {
-                        test_segment(i, _vPos, &fBestDistSq, &uBestSegIndex, &fBestT, &vBestClosest);
-                    }
-                }
+                *_pOutSegIndex = uBestSegIndex;
+                *_pOutT = fBestT;
+                *_pOutClosest = vBestClosest;
+                return;
             }
         }
-        else
+    }
+
+    if (m_pChunks && m_uChunkCount > 0)
+    {
+        /* Chunk boxes contain their segments, so the distance to a box bounds its segments from below:
+         * search the closest box first, then only boxes that can still beat the best segment */
+        uint16_t uFirst = 0;
+        float fFirstDistSq = 1e10f;
+        for (uint16_t c = 0; c < m_uChunkCount; ++c)
         {
-            /* Fallback: linear search all segments */
-            for (uint16_t i = 0; i < m_track.uSampleCount; ++i)
+            const RaceTrackChunk *pChunk = &m_pChunks[c];
+            float fDX = fmaxf(fmaxf(pChunk->fMinX - _vPos.fX, _vPos.fX - pChunk->fMaxX), 0.0f);
+            float fDY = fmaxf(fmaxf(pChunk->fMinY - _vPos.fY, _vPos.fY - pChunk->fMaxY), 0.0f);
+            if (fDX * fDX + fDY * fDY < fFirstDistSq)
             {
-                test_segment(i, _vPos, &fBestDistSq, &uBestSegIndex, &fBestT, &vBestClosest);
+                fFirstDistSq = fDX * fDX + fDY * fDY;
+                uFirst = c;
             }
         }
+
+        for (uint16_t n = 0; n < m_uChunkCount; ++n)
+        {
+            uint16_t c = (uint16_t)((uFirst + n) % m_uChunkCount);
+            const RaceTrackChunk *pChunk = &m_pChunks[c];
+            float fDX = fmaxf(fmaxf(pChunk->fMinX - _vPos.fX, _vPos.fX - pChunk->fMaxX), 0.0f);
+            float fDY = fmaxf(fmaxf(pChunk->fMinY - _vPos.fY, _vPos.fY - pChunk->fMaxY), 0.0f);
+            if (fDX * fDX + fDY * fDY >= fBestDistSq)
+                continue;
+
+            for (uint16_t i = pChunk->uStartIndex; i < pChunk->uEndIndex; ++i)
+                test_segment(i, _vPos, &fBestDistSq, &uBestSegIndex, &fBestT, &vBestClosest);
+        }
+    }
+    else
+    {
+        /* Fallback: linear search all segments */
+        for (uint16_t i = 0; i < m_track.uSampleCount; ++i)
+            test_segment(i, _vPos, &fBestDistSq, &uBestSegIndex, &fBestT, &vBestClosest);
     }
 
-    /* Update cached segment index */
-    m_uLastSegIndex = uBestSegIndex;
+    *_pOutSegIndex = uBestSegIndex;
+    *_pOutT = fBestT;
+    *_pOutClosest = vBestClosest;
+}
+
+/* Find closest point on track polyline to given position */
+static void find_closest_point(struct vec2 _vPos, struct vec2 *_pOutClosest, struct vec2 *_pOutNormal, float *_pOutLateralDist, float *_pOutS)
+{
+    if (!_pOutClosest || !_pOutNormal || !_pOutLateralDist || !_pOutS || !m_track.bInitialized || m_track.uSampleCount < 2)
+    {
+        if (_pOutClosest)
+            *_pOutClosest = vec2_zero();
+        if (_pOutNormal)
+            *_pOutNormal = vec2_make(1.0f, 0.0f);
+        if (_pOutLateralDist)
+            *_pOutLateralDist = 0.0f;
+        if (_pOutS)
+            *_pOutS = 0.0f;
+        return;
+    }
+
+    uint16_t uBestSegIndex;
+    float fBestT;
+    struct vec2 vBestClosest;
+    find_closest_segment(_vPos, &uBestSegIndex, &fBestT, &vBestClosest);
 
     /* Interpolate normal between segment endpoints */
     uint16_t uNext = (uBestSegIndex == m_track.uSampleCount - 1) ? 0 : (uBestSegIndex + 1);
@@ -837,12 +1047,8 @@ static bool check_track_collision(struct vec2 _vUfoPos, struct vec2 *_pOutCloses
 void race_track_set_collision_enabled(bool _bEnabled)
 {
     m_bCollisionEnabled = _bEnabled;
-    /* Reset cached segment index when disabling collision to prevent stale data */
     if (!_bEnabled)
-    {
-        m_uLastSegIndex = 0;
         m_bWasColliding = false;
-    }
 }
 
 bool race_track_is_collision_enabled(void)
@@ -1517,6 +1723,21 @@ float race_track_get_progress_for_position(struct vec2 _vPos)
     return fS;
 }
 
+bool race_track_get_progress_and_lateral(struct vec2 _vPos, float *_pOutS, float *_pOutLateralDist)
+{
+    if (!m_track.bInitialized || m_track.uSampleCount < 2)
+        return false;
+
+    struct vec2 vClosest, vNormal;
+    float fLateralDist, fS;
+    find_closest_point(_vPos, &vClosest, &vNormal, &fLateralDist, &fS);
+    if (_pOutS)
+        *_pOutS = fS;
+    if (_pOutLateralDist)
+        *_pOutLateralDist = fLateralDist;
+    return true;
+}
+
 /* Internal helper: Find sample indices and interpolation factor for a given s value */
 static bool find_sample_indices_for_s(float _fS, uint16_t *_pOutLower, uint16_t *_pOutUpper, float *_pOutT)
 {
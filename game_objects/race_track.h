@@ -21,11 +21,6 @@ typedef struct
 /* Collision constants */
 #define RACE_TRACK_HALF_COLLIDE 84.0f     /* Half-width for collision, matches RACE_TRACK_WIDTH * 0.5f */
 #define RACE_TRACK_COLLISION_EPSILON 2.0f /* Small inward push to prevent re-collision */
-/* Search window: segments to search around last known position.
- * With RACE_TRACK_STEP=32, window of 8 covers ~256 units.
- * Too low if: full search triggers often (check debug output), or collision feels jittery near sharp curves.
- * Increase if: UFO moves very fast or track has tight curves causing segment jumps > window size. */
-#define RACE_TRACK_SEARCH_WINDOW 4
 #define RACE_TRACK_BBOX_MARGIN 50.0f      /* Extra margin for bounding box check */
 #define RACE_TRACK_BOUNCE_COOLDOWN_MS 200 /* Bounce cooldown duration in milliseconds */
 
@@ -51,6 +46,10 @@ bool race_track_is_collision_enabled(void);
 /* Get progress coordinate s for a given world position */
 float race_track_get_progress_for_position(struct vec2 _vPos);
 
+/* Get progress coordinate s and signed lateral distance from the centerline for a given world position.
+ * Closest-point queries use a grid built at init, so they are independent of previous queries. */
+bool race_track_get_progress_and_lateral(struct vec2 _vPos, float *_pOutS, float *_pOutLateralDist);
+
 /* Get world position and tangent for a given progress coordinate s */
 bool race_track_get_position_for_progress(float _fS, struct vec2 *_pOutPos, struct vec2 *_pOutTangent);
 
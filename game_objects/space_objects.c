@@ -5,6 +5,8 @@
 #include "../frame_time.h"
 #include "../math2d.h"
 #include "../minimap.h"
+#include "../profiler.h"
+#include "../render_queue.h"
 #include "../rng.h"
 #include "../satellite_pieces.h"
 #include "libdragon.h"
@@ -28,19 +30,116 @@ static wav64_t *m_explosionSounds[3] = {NULL, NULL, NULL};
 #define SPACE_GRID_CELL 48.0f /* Optimized: 48 matches object sizes better (meteors ~24px, UFO ~16px) */
 #define SPACE_GRID_BUCKETS 2048
 #define SPACE_GRID_BUCKET_MASK (SPACE_GRID_BUCKETS - 1)
-
-/* Helper macro for iterating over objects in a grid range */
+#define SPACE_QUERY_WORLD_LIMIT 1.0e6f /* Query cell ranges are clamped to +-this many pixels */
+#define SPACE_QUERY_CELL_COST 2        /* Object tests one query cell costs (hash, chain walk, stamps) */
+
+/* Dormant Sector Settings */
+#define SPACE_SECTOR_SIZE 512.0f
+#define SPACE_SECTOR_BUCKETS 64
+#define SPACE_SECTOR_BUCKET_MASK (SPACE_SECTOR_BUCKETS - 1)
+#define SPACE_DORMANT_MAX 1536               /* Parked meteor records (on top of the MAX_SPACE_OBJECTS live slots) */
+#define SPACE_DORMANT_WAKE_MARGIN 160.0f     /* Wake radius: half diagonal of the view plus this */
+#define SPACE_DORMANT_PARK_HYSTERESIS 192.0f /* Park radius: wake radius plus this */
+#define SPACE_DORMANT_SWEEP_BUCKETS 4        /* Sector buckets swept per update (all of them every 16 updates) */
+
+/* Helper macro for iterating over objects in a grid range. Linked objects are always allocated; the flag
+ * checks catch objects deleted or deactivated since the last update. */
 #define SPACE_GRID_LOOP(min_x, max_x, min_y, max_y, obj_name)                                                                                                                      \
     for (int _cx = (min_x); _cx <= (max_x); _cx++)                                                                                                                                 \
         for (int _cy = (min_y); _cy <= (max_y); _cy++)                                                                                                                             \
-            for (int _j = s_gridHead[space_hash_cell(_cx, _cy)]; _j != -1; _j = s_objects[_j].next_in_cell)                                                                        \
-                for (SpaceObject *obj_name = &s_objects[_j]; obj_name && obj_name->bAllocated && !obj_name->markForDelete && entity2d_is_active(&obj_name->entity); obj_name = NULL)
+            for (int _j = s_gridHead[space_hash_cell(_cx, _cy)]; _j != -1; _j = s_hot.aiNextInCell[_j])                                                                            \
+                for (SpaceObject *obj_name = &s_objects[_j]; obj_name && !obj_name->markForDelete && entity2d_is_active(&obj_name->entity); obj_name = NULL)
+
+/* Object state as parallel arrays (indexed by slot). Position, velocity and the sleep flag are the storage of
+ * every allocated slot: integration, sleep, grid and pair kernels run on them and the space_object_set_*
+ * setters write them; entity.vPos/vVel mirror them (set by the setters, published after the pair kernel).
+ * Radius, collidability and the live list (live slots in active list order) are gathered each update. auMoving
+ * lists the meteors the logic pass hands to the integration kernel, with their SO_HOT_MOTION_* flags.
+ * The spatial hash persists across frames: a slot stays linked in its bucket (doubly linked chain) until
+ * its cell changes or it stops being live, so only movers across cell borders are relinked. */
+#define SO_HOT_COLLIDABLE (1u << 0)
+#define SO_HOT_SLEEPING (1u << 1)
+#define SO_HOT_MOVED (1u << 2) /* Position written since the last grid update */
+
+#define SO_HOT_MOTION_DAMPED (1u << 0)    /* Currency meteor not grabbed: damped, sleeps when slow */
+#define SO_HOT_MOTION_MAY_SLEEP (1u << 1) /* Not grabbed and past the sleep cooldown */
+
+typedef struct
+{
+    float afPosX[MAX_SPACE_OBJECTS];
+    float afPosY[MAX_SPACE_OBJECTS];
+    float afVelX[MAX_SPACE_OBJECTS];
+    float afVelY[MAX_SPACE_OBJECTS];
+    float afRadius[MAX_SPACE_OBJECTS];
+    uint8_t auState[MAX_SPACE_OBJECTS];       /* SO_HOT_* */
+    uint8_t auMotion[MAX_SPACE_OBJECTS];      /* SO_HOT_MOTION_* of the slots in auMoving */
+    int16_t aiNextInCell[MAX_SPACE_OBJECTS];  /* Spatial hash chain, -1 terminated */
+    int16_t aiPrevInCell[MAX_SPACE_OBJECTS];  /* -1 at the chain head */
+    int16_t aiBucket[MAX_SPACE_OBJECTS];      /* Bucket the slot is linked in, -1 if not linked */
+    int32_t aiCellX[MAX_SPACE_OBJECTS];       /* Cell the slot is linked for */
+    int32_t aiCellY[MAX_SPACE_OBJECTS];
+    uint16_t auLive[MAX_SPACE_OBJECTS];
+    uint16_t auMoving[MAX_SPACE_OBJECTS];
+    uint16_t uLiveCount;
+    uint16_t uMovingCount;
+} space_objects_hot_t;
+
+/* Meteor parked far from the camera: just what the meteor logic needs to continue. Records are chained per
+ * sector (hashed like the grid, sector coordinates stored to tell colliding sectors apart); unused records
+ * form a free list through the same link. Drifting records keep their sector until a sweep or the wake scan
+ * finds them in another one (see space_objects_update_dormancy). */
+typedef struct
+{
+    struct vec2 vPos;
+    struct vec2 vVel;
+    float fAngleRad;
+    float fRotationSpeed;
+    float fParkedClock; /* s_fDormantClock the state is at (when parked or last moved to another sector) */
+    sprite_t *pSprite;
+    int16_t iHitPoints;
+    int16_t iNext;
+    int16_t iSectorX;
+    int16_t iSectorY;
+    uint8_t uCollisionRadius;
+    uint8_t uCurrencyId;
+    uint8_t uFramesAlive;
+    bool bSleeping;
+} space_dormant_t;
 
 static SpaceObject s_objects[MAX_SPACE_OBJECTS];
+static SpaceObjectData s_objectData[MAX_SPACE_OBJECTS];
+static space_objects_hot_t s_hot;
 static int s_gridHead[SPACE_GRID_BUCKETS];
+static uint16_t s_auGridBucketCount[SPACE_GRID_BUCKETS]; /* Chain length per bucket */
+static uint16_t s_uGridOccupied = 0;                     /* Buckets with a non-empty chain */
+static uint16_t s_uGridLinked = 0;                       /* Objects linked in the grid */
+static uint32_t s_uGridRelinks = 0;                      /* Link/relink operations since the last update */
+static int32_t s_iGridMinCellX = 0;                      /* Cell range holding every linked object (empty if min > max) */
+static int32_t s_iGridMaxCellX = -1;
+static int32_t s_iGridMinCellY = 0;
+static int32_t s_iGridMaxCellY = -1;
+/* Allocated slots (s_aliveCount entries) in slot order as of the last compaction, objects spawned since then
+ * appended. Objects marked for delete stay listed until the compaction at the start of the next update.
+ * s_auSlotMask has a bit per allocated slot; spawns take the lowest free one. */
+#define SPACE_SLOT_WORDS (MAX_SPACE_OBJECTS / 32)
+static uint16_t s_auActive[MAX_SPACE_OBJECTS];
 static int s_aliveCount = 0;
+static uint32_t s_auSlotMask[SPACE_SLOT_WORDS];
 static uint16_t s_renderStamp[MAX_SPACE_OBJECTS];
 static uint16_t s_renderStampCounter = 1;
+static uint16_t s_queryStamp[MAX_SPACE_OBJECTS]; /* Objects already tested by the current query or raycast */
+static uint16_t s_queryStampCounter = 1;
+static uint32_t s_uSweepTests = 0; /* Objects tested by grid sweeps (each at most once per sweep) */
+static space_dormant_t s_dormant[SPACE_DORMANT_MAX];
+static int16_t s_aiSectorHead[SPACE_SECTOR_BUCKETS];
+static int16_t s_iDormantFreeHead = -1;
+static uint16_t s_uDormantCount = 0;
+static uint32_t s_uDormantTransfers = 0; /* Meteors parked or woken since the last update */
+static float s_fDormantClock = 0.0f;     /* Meteor logic frames run so far (sum of frame multipliers) */
+static float s_fDormantMaxSpeed = 0.0f;  /* Upper bound of the parked speeds (they only decay while parked) */
+static int s_iDormantSweepBucket = 0;    /* Next sector bucket to sweep */
+static float s_fDormantSweepClock = 0.0f;  /* Clock at the start of the current sweep over all buckets */
+static float s_fDormantSectorClock = 0.0f; /* Clock at the start of the previous one: no record has left its sector for longer */
 
 #define SO_BOUNCE_FORCE_UFO 0.3f
 #define SO_BOUNCE_FORCE_OBJECT 1.0f
@@ -54,6 +153,59 @@ static uint16_t s_renderStampCounter = 1;
 
 #define METEOR_MINIMAP_RENDER_INTERVAL 5
 
+/* Slot of a pooled object, -1 for objects outside the pool */
+static inline int space_object_slot(const SpaceObject *obj)
+{
+    if (obj < s_objects || obj >= s_objects + MAX_SPACE_OBJECTS)
+        return -1;
+    return (int)(obj - s_objects);
+}
+
+SpaceObject *space_objects_from_entity(const struct entity2D *pEntity)
+{
+    /* entity is the first member, so a pooled entity is also a pooled object */
+    SpaceObject *obj = (SpaceObject *)pEntity;
+    return (pEntity && space_object_slot(obj) >= 0) ? obj : NULL;
+}
+
+void space_object_set_position(SpaceObject *obj, struct vec2 vPos)
+{
+    obj->entity.vPos = vPos;
+    int i = space_object_slot(obj);
+    if (i < 0)
+        return;
+    s_hot.afPosX[i] = vPos.fX;
+    s_hot.afPosY[i] = vPos.fY;
+    s_hot.auState[i] |= SO_HOT_MOVED;
+}
+
+void space_object_set_velocity(SpaceObject *obj, struct vec2 vVel)
+{
+    obj->entity.vVel = vVel;
+    int i = space_object_slot(obj);
+    if (i < 0)
+        return;
+    s_hot.afVelX[i] = vVel.fX;
+    s_hot.afVelY[i] = vVel.fY;
+}
+
+void space_object_set_sleeping(SpaceObject *obj, bool bSleeping)
+{
+    int i = space_object_slot(obj);
+    if (i < 0)
+        return;
+    if (bSleeping)
+        s_hot.auState[i] |= SO_HOT_SLEEPING;
+    else
+        s_hot.auState[i] &= (uint8_t)~SO_HOT_SLEEPING;
+}
+
+bool space_object_is_sleeping(const SpaceObject *obj)
+{
+    int i = space_object_slot(obj);
+    return i >= 0 && (s_hot.auState[i] & SO_HOT_SLEEPING);
+}
+
 /* Helper: Apply impact force to an object's velocity */
 static void apply_impact_force(SpaceObject *obj, struct vec2 vImpactDir)
 {
@@ -66,7 +218,7 @@ static void apply_impact_force(SpaceObject *obj, struct vec2 vImpactDir)
     struct vec2 vImpulse = vec2_scale(vNormalized, fImpactStrength);
 
     /* Add impulse to object velocity */
-    obj->entity.vVel = vec2_add(obj->entity.vVel, vImpulse);
+    space_object_set_velocity(obj, vec2_add(obj->entity.vVel, vImpulse));
 }
 
 /* Helper: Hash function */
@@ -116,6 +268,93 @@ static inline void space_calc_camera_grid_bounds(const struct camera2D *pCamera,
     space_calc_grid_bounds(fCamLeft, fCamRight, fCamTop, fCamBottom, pMinX, pMaxX, pMinY, pMaxY);
 }
 
+/* Grid: link a slot at the head of a bucket chain */
+static inline void space_grid_link(int _iIndex, int _iBucket, int _iCellX, int _iCellY)
+{
+    int iHead = s_gridHead[_iBucket];
+    s_hot.aiNextInCell[_iIndex] = (int16_t)iHead;
+    s_hot.aiPrevInCell[_iIndex] = -1;
+    if (iHead != -1)
+        s_hot.aiPrevInCell[iHead] = (int16_t)_iIndex;
+    s_gridHead[_iBucket] = _iIndex;
+
+    s_hot.aiBucket[_iIndex] = (int16_t)_iBucket;
+    s_hot.aiCellX[_iIndex] = _iCellX;
+    s_hot.aiCellY[_iIndex] = _iCellY;
+
+    if (s_auGridBucketCount[_iBucket]++ == 0)
+        s_uGridOccupied++;
+    s_uGridLinked++;
+    s_uGridRelinks++;
+}
+
+/* Grid: remove a slot from its bucket chain (no-op if not linked) */
+static inline void space_grid_unlink(int _iIndex)
+{
+    int iBucket = s_hot.aiBucket[_iIndex];
+    if (iBucket < 0)
+        return;
+
+    int iPrev = s_hot.aiPrevInCell[_iIndex];
+    int iNext = s_hot.aiNextInCell[_iIndex];
+    if (iPrev != -1)
+        s_hot.aiNextInCell[iPrev] = (int16_t)iNext;
+    else
+        s_gridHead[iBucket] = iNext;
+    if (iNext != -1)
+        s_hot.aiPrevInCell[iNext] = (int16_t)iPrev;
+
+    s_hot.aiBucket[_iIndex] = -1;
+    if (--s_auGridBucketCount[iBucket] == 0)
+        s_uGridOccupied--;
+    s_uGridLinked--;
+}
+
+/* Grid: drop all links */
+static void space_grid_reset(void)
+{
+    memset(s_gridHead, 0xFF, sizeof(s_gridHead));
+    memset(s_hot.aiBucket, 0xFF, sizeof(s_hot.aiBucket));
+    memset(s_auGridBucketCount, 0, sizeof(s_auGridBucketCount));
+    s_uGridOccupied = 0;
+    s_uGridLinked = 0;
+    s_iGridMinCellX = 0;
+    s_iGridMaxCellX = -1;
+    s_iGridMinCellY = 0;
+    s_iGridMaxCellY = -1;
+}
+
+/* Dormant sectors: drop all parked meteors */
+static void space_dormant_reset(void)
+{
+    memset(s_aiSectorHead, 0xFF, sizeof(s_aiSectorHead));
+    for (int i = 0; i < SPACE_DORMANT_MAX; i++)
+        s_dormant[i].iNext = (int16_t)((i + 1 < SPACE_DORMANT_MAX) ? i + 1 : -1);
+    s_iDormantFreeHead = 0;
+    s_uDormantCount = 0;
+    s_fDormantClock = 0.0f;
+    s_fDormantMaxSpeed = 0.0f;
+    s_iDormantSweepBucket = 0;
+    s_fDormantSweepClock = 0.0f;
+    s_fDormantSectorClock = 0.0f;
+}
+
+static inline int space_sector_hash(int _iSectorX, int _iSectorY)
+{
+    return (int)(((uint32_t)_iSectorX * 73856093u) ^ ((uint32_t)_iSectorY * 19349663u)) & SPACE_SECTOR_BUCKET_MASK;
+}
+
+/* Start a new query: objects stamped before count as untested again */
+static inline void space_query_stamp_next(void)
+{
+    s_queryStampCounter++;
+    if (s_queryStampCounter == 0)
+    {
+        memset(s_queryStamp, 0, sizeof(s_queryStamp));
+        s_queryStampCounter = 1;
+    }
+}
+
 void space_objects_init(void)
 {
     /* Clear and reset the space objects array */
@@ -147,19 +386,25 @@ void space_objects_clear(void)
 {
     /* Clear all objects and reset spatial hash, but keep memory allocated */
     memset(s_objects, 0, sizeof(s_objects));
+    memset(s_objectData, 0, sizeof(s_objectData));
+    s_hot.uLiveCount = 0;
+    s_hot.uMovingCount = 0;
     s_aliveCount = 0;
-    memset(s_gridHead, 0xFF, sizeof(s_gridHead));
+    memset(s_auSlotMask, 0, sizeof(s_auSlotMask));
+    space_grid_reset();
+    space_dormant_reset();
 }
 
 void space_objects_free(void)
 {
     /* Destroy individual objects first to free per-instance resources */
-    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+    for (int k = 0; k < s_aliveCount; k++)
     {
-        if (s_objects[i].bAllocated && s_objects[i].type == SO_NPC)
+        SpaceObject *obj = &s_objects[s_auActive[k]];
+        if (obj->type == SO_NPC)
         {
             /* NPC might have cleanup needs (sprites, paths) */
-            npc_alien_destroy((NpcAlienInstance *)&s_objects[i]);
+            npc_alien_destroy((NpcAlienInstance *)obj);
         }
     }
 
@@ -183,20 +428,54 @@ void space_objects_free(void)
 
 static SpaceObject *alloc_object(SpaceObjectType type)
 {
-    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+    int w = 0;
+    while (w < SPACE_SLOT_WORDS && s_auSlotMask[w] == 0xFFFFFFFFu)
+        w++;
+    if (w == SPACE_SLOT_WORDS)
+        return NULL;
+
+    int i = w * 32 + __builtin_ctz(~s_auSlotMask[w]);
+    s_auSlotMask[w] |= 1u << (i & 31);
+
+    memset(&s_objects[i], 0, sizeof(SpaceObject));
+    memset(&s_objectData[i], 0, sizeof(SpaceObjectData));
+    s_objects[i].bAllocated = true;
+    s_objects[i].type = type;
+    s_objects[i].pData = &s_objectData[i];
+    s_objects[i].entity.uLayerMask = ENTITY_LAYER_GAMEPLAY;
+    s_objects[i].entity.uFlags = ENTITY_FLAG_ACTIVE | ENTITY_FLAG_VISIBLE | ENTITY_FLAG_COLLIDABLE;
+    s_hot.afPosX[i] = 0.0f;
+    s_hot.afPosY[i] = 0.0f;
+    s_hot.afVelX[i] = 0.0f;
+    s_hot.afVelY[i] = 0.0f;
+    s_hot.auState[i] = SO_HOT_MOVED;
+    s_auActive[s_aliveCount++] = (uint16_t)i;
+    return &s_objects[i];
+}
+
+/* Deferred deletion: release objects marked for delete and rebuild the active list in slot order (which also
+ * sorts in the objects spawned since the last update) */
+static void space_objects_compact(void)
+{
+    int iKept = 0;
+    for (int w = 0; w < SPACE_SLOT_WORDS; w++)
     {
-        if (!s_objects[i].bAllocated)
+        uint32_t uBits = s_auSlotMask[w];
+        while (uBits)
         {
-            memset(&s_objects[i], 0, sizeof(SpaceObject));
-            s_objects[i].bAllocated = true;
-            s_objects[i].type = type;
-            s_objects[i].entity.uLayerMask = ENTITY_LAYER_GAMEPLAY;
-            s_objects[i].entity.uFlags = ENTITY_FLAG_ACTIVE | ENTITY_FLAG_VISIBLE | ENTITY_FLAG_COLLIDABLE;
-            s_aliveCount++;
-            return &s_objects[i];
+            int i = w * 32 + __builtin_ctz(uBits);
+            uBits &= uBits - 1;
+            if (s_objects[i].markForDelete)
+            {
+                space_grid_unlink(i);
+                s_objects[i].bAllocated = false;
+                s_auSlotMask[w] &= ~(1u << (i & 31));
+                continue;
+            }
+            s_auActive[iKept++] = (uint16_t)i;
         }
     }
-    return NULL;
+    s_aliveCount = iKept;
 }
 
 SpaceObject *space_objects_spawn_meteor(struct vec2 pos)
@@ -205,7 +484,7 @@ SpaceObject *space_objects_spawn_meteor(struct vec2 pos)
     if (!obj)
         return NULL;
 
-    obj->entity.vPos = pos;
+    space_object_set_position(obj, pos);
     /* Meteor specific init will be done by caller or we can move it here if we want strict coupling.
        The plan says "Update meteors_init to use space_objects_spawn_meteor", so the caller (meteors.c)
        will populate the rest (sprites, velocity, etc).
@@ -218,7 +497,7 @@ SpaceObject *space_objects_spawn_npc(int type)
     SpaceObject *obj = alloc_object(SO_NPC);
     if (!obj)
         return NULL;
-    obj->data.npc.type = type;
+    obj->pData->npc.type = type;
     return obj;
 }
 
@@ -227,13 +506,271 @@ SpaceObject *space_objects_spawn_piece(int direction, uint16_t unlock_flag, stru
     SpaceObject *obj = alloc_object(SO_PIECE);
     if (!obj)
         return NULL;
-    obj->entity.vPos = pos;
-    obj->data.piece.eDirection = direction;
-    obj->data.piece.uUnlockFlag = unlock_flag;
-    obj->data.piece.bAssembleMode = false; /* Default to false, can be overridden by caller */
+    space_object_set_position(obj, pos);
+    obj->pData->piece.eDirection = direction;
+    obj->pData->piece.uUnlockFlag = unlock_flag;
+    obj->pData->piece.bAssembleMode = false; /* Default to false, can be overridden by caller */
     return obj;
 }
 
+/* Dormant sectors: chain a record into the sector of its position */
+static void space_dormant_link(int _iIndex)
+{
+    space_dormant_t *pRec = &s_dormant[_iIndex];
+    pRec->iSectorX = (int16_t)fm_floorf(pRec->vPos.fX / SPACE_SECTOR_SIZE);
+    pRec->iSectorY = (int16_t)fm_floorf(pRec->vPos.fY / SPACE_SECTOR_SIZE);
+
+    int iBucket = space_sector_hash(pRec->iSectorX, pRec->iSectorY);
+    pRec->iNext = s_aiSectorHead[iBucket];
+    s_aiSectorHead[iBucket] = (int16_t)_iIndex;
+}
+
+/* Dormant sectors: store a record in the sector of its position. Returns false if the storage is full. */
+static bool space_dormant_store(const space_dormant_t *_pRecord)
+{
+    int iIndex = s_iDormantFreeHead;
+    if (iIndex < 0)
+        return false;
+    s_iDormantFreeHead = s_dormant[iIndex].iNext;
+
+    space_dormant_t *pRec = &s_dormant[iIndex];
+    *pRec = *_pRecord;
+    pRec->fParkedClock = s_fDormantClock;
+    space_dormant_link(iIndex);
+    s_uDormantCount++;
+
+    float fSpeed = vec2_mag(pRec->vVel);
+    if (fSpeed > s_fDormantMaxSpeed)
+        s_fDormantMaxSpeed = fSpeed;
+    return true;
+}
+
+/* Advance a parked meteor by _fFrames frames of the meteor logic in closed form: linear drift, or the
+ * geometric sum of the damped steps for currency meteors (p += v * (1 - d^n) / (1 - d), v *= d^n) */
+static void space_dormant_advance(space_dormant_t *_pRec, float _fFrames)
+{
+    if (_fFrames <= 0.0f)
+        return;
+
+    if (!_pRec->bSleeping)
+    {
+        if (_pRec->uCurrencyId > 0)
+        {
+            float fDecay = powf(METEOR_CURRENCY_VELOCITY_DAMPING, _fFrames);
+            _pRec->vPos = vec2_add(_pRec->vPos, vec2_scale(_pRec->vVel, (1.0f - fDecay) / (1.0f - METEOR_CURRENCY_VELOCITY_DAMPING)));
+            _pRec->vVel = vec2_scale(_pRec->vVel, fDecay);
+            if (vec2_mag_sq(_pRec->vVel) <= METEOR_CURRENCY_SLEEP_VEL_SQ)
+            {
+                _pRec->vVel = vec2_zero();
+                _pRec->bSleeping = true;
+            }
+        }
+        else
+        {
+            _pRec->vPos = vec2_add(_pRec->vPos, vec2_scale(_pRec->vVel, _fFrames));
+        }
+    }
+
+    _pRec->fAngleRad = angle_wrap_rad(fmodf(_pRec->fAngleRad + _pRec->fRotationSpeed * _fFrames, 2.0f * FM_PI));
+    float fFramesAlive = (float)_pRec->uFramesAlive + _fFrames;
+    _pRec->uFramesAlive = (uint8_t)((fFramesAlive < (float)METEOR_SLEEP_COOLDOWN_FRAMES) ? (int)fFramesAlive : METEOR_SLEEP_COOLDOWN_FRAMES);
+}
+
+/* Move a live meteor into dormant storage. The slot is released like a destroyed meteor (marked for delete,
+ * freed by the next compaction), so pointers held elsewhere see an inactive entity. */
+static bool space_objects_park_meteor(SpaceObject *obj)
+{
+    int i = space_object_slot(obj);
+    space_dormant_t record = {
+        .vPos = vec2_make(s_hot.afPosX[i], s_hot.afPosY[i]),
+        .vVel = vec2_make(s_hot.afVelX[i], s_hot.afVelY[i]),
+        .fAngleRad = obj->entity.fAngleRad,
+        .fRotationSpeed = obj->pData->meteor.fRotationSpeed,
+        .pSprite = obj->entity.pSprite,
+        .iHitPoints = (int16_t)obj->iHitPoints,
+        .uCollisionRadius = (uint8_t)obj->entity.iCollisionRadius,
+        .uCurrencyId = obj->pData->meteor.uCurrencyId,
+        .uFramesAlive = (uint8_t)obj->pData->meteor.iFramesAlive,
+        .bSleeping = (s_hot.auState[i] & SO_HOT_SLEEPING) != 0,
+    };
+    if (!space_dormant_store(&record))
+        return false;
+
+    entity2d_deactivate(&obj->entity);
+    obj->markForDelete = true;
+    obj->entity.pSprite = NULL;
+    ufo_deselect_entity_lock_and_marker(&obj->entity);
+    return true;
+}
+
+/* Bring a parked meteor back into the pool, caught up to the current clock. Returns false if the pool is full. */
+static bool space_dormant_wake(space_dormant_t *_pRec)
+{
+    SpaceObject *obj = alloc_object(SO_METEOR);
+    if (!obj)
+        return false;
+
+    space_dormant_advance(_pRec, s_fDormantClock - _pRec->fParkedClock);
+
+    uint16_t uFlags = ENTITY_FLAG_ACTIVE | ENTITY_FLAG_VISIBLE | ENTITY_FLAG_COLLIDABLE;
+    entity2d_init_from_sprite(&obj->entity, _pRec->vPos, _pRec->pSprite, uFlags, ENTITY_LAYER_GAMEPLAY);
+    space_object_set_position(obj, _pRec->vPos);
+    space_object_set_velocity(obj, _pRec->vVel);
+    space_object_set_sleeping(obj, _pRec->bSleeping);
+    obj->entity.fAngleRad = _pRec->fAngleRad;
+    obj->entity.iCollisionRadius = _pRec->uCollisionRadius;
+    obj->pData->meteor.fRotationSpeed = _pRec->fRotationSpeed;
+    obj->pData->meteor.iFramesAlive = _pRec->uFramesAlive;
+    obj->pData->meteor.uCurrencyId = _pRec->uCurrencyId;
+    obj->iHitPoints = _pRec->iHitPoints;
+    return true;
+}
+
+/* Dormant sectors: catch up the records of the next few buckets and move those that drifted out of their
+ * sector. Unmoved records keep their parked state, so they are still advanced in one step when woken. */
+static void space_dormant_sweep(void)
+{
+    for (int b = 0; b < SPACE_DORMANT_SWEEP_BUCKETS; b++)
+    {
+        if (s_iDormantSweepBucket == 0)
+        {
+            s_fDormantSectorClock = s_fDormantSweepClock;
+            s_fDormantSweepClock = s_fDormantClock;
+        }
+
+        int16_t *pLink = &s_aiSectorHead[s_iDormantSweepBucket];
+        while (*pLink != -1)
+        {
+            int iIndex = *pLink;
+            space_dormant_t record = s_dormant[iIndex];
+            space_dormant_advance(&record, s_fDormantClock - record.fParkedClock);
+            if ((int)fm_floorf(record.vPos.fX / SPACE_SECTOR_SIZE) == record.iSectorX && (int)fm_floorf(record.vPos.fY / SPACE_SECTOR_SIZE) == record.iSectorY)
+            {
+                pLink = &s_dormant[iIndex].iNext;
+                continue;
+            }
+
+            *pLink = record.iNext;
+            record.fParkedClock = s_fDormantClock;
+            s_dormant[iIndex] = record;
+            space_dormant_link(iIndex);
+        }
+        s_iDormantSweepBucket = (s_iDormantSweepBucket + 1) & SPACE_SECTOR_BUCKET_MASK;
+    }
+}
+
+/* Park live meteors beyond the park radius and wake parked ones inside the wake radius around the camera.
+ * The gap between the radii keeps meteors at the border from flipping every frame. Parked records are
+ * tested at their position caught up to the clock. A record has been in its sector at most since the start
+ * of the previous sweep, so the sectors scanned reach as far beyond the wake radius as the fastest record
+ * can have drifted since. */
+static void space_objects_update_dormancy(void)
+{
+    const struct camera2D *pCamera = &g_mainCamera;
+    float fInvZoom = 1.0f / camera_get_zoom(pCamera);
+    float fHalfX = (float)pCamera->vHalf.iX * fInvZoom;
+    float fHalfY = (float)pCamera->vHalf.iY * fInvZoom;
+    float fWakeRadius = sqrtf(fHalfX * fHalfX + fHalfY * fHalfY) + SPACE_DORMANT_WAKE_MARGIN;
+    float fParkRadius = fWakeRadius + SPACE_DORMANT_PARK_HYSTERESIS;
+    float fWakeRadiusSq = fWakeRadius * fWakeRadius;
+    float fParkRadiusSq = fParkRadius * fParkRadius;
+    struct vec2 vCenter = pCamera->vPos;
+
+    for (int k = 0; k < s_aliveCount; k++)
+    {
+        int i = s_auActive[k];
+        SpaceObject *obj = &s_objects[i];
+        if (obj->type != SO_METEOR || obj->markForDelete || obj->entity.bGrabbed || !entity2d_is_active(&obj->entity) || !obj->entity.pSprite)
+            continue;
+        float fDX = s_hot.afPosX[i] - vCenter.fX;
+        float fDY = s_hot.afPosY[i] - vCenter.fY;
+        if (fDX * fDX + fDY * fDY <= fParkRadiusSq)
+            continue;
+        if (!space_objects_park_meteor(obj))
+            break; /* Dormant storage full */
+        s_uDormantTransfers++;
+    }
+
+    if (s_uDormantCount == 0)
+        return;
+
+    space_dormant_sweep();
+
+    float fScanRadius = fWakeRadius + s_fDormantMaxSpeed * (s_fDormantClock - s_fDormantSectorClock);
+    int iMinX = (int)fm_floorf((vCenter.fX - fScanRadius) / SPACE_SECTOR_SIZE);
+    int iMaxX = (int)fm_floorf((vCenter.fX + fScanRadius) / SPACE_SECTOR_SIZE);
+    int iMinY = (int)fm_floorf((vCenter.fY - fScanRadius) / SPACE_SECTOR_SIZE);
+    int iMaxY = (int)fm_floorf((vCenter.fY + fScanRadius) / SPACE_SECTOR_SIZE);
+    for (int iSx = iMinX; iSx <= iMaxX; iSx++)
+    {
+        for (int iSy = iMinY; iSy <= iMaxY; iSy++)
+        {
+            int16_t *pLink = &s_aiSectorHead[space_sector_hash(iSx, iSy)];
+            while (*pLink != -1)
+            {
+                int iIndex = *pLink;
+                if (s_dormant[iIndex].iSectorX != iSx || s_dormant[iIndex].iSectorY != iSy)
+                {
+                    pLink = &s_dormant[iIndex].iNext;
+                    continue;
+                }
+
+                /* Test the caught-up position; records that drifted out of their sector are moved by the sweep */
+                space_dormant_t record = s_dormant[iIndex];
+                space_dormant_advance(&record, s_fDormantClock - record.fParkedClock);
+                record.fParkedClock = s_fDormantClock;
+                if (vec2_dist_sq(record.vPos, vCenter) > fWakeRadiusSq)
+                {
+                    pLink = &s_dormant[iIndex].iNext;
+                    continue;
+                }
+                if (!space_dormant_wake(&record))
+                    return; /* Pool full, retry next update */
+
+                *pLink = record.iNext;
+                s_dormant[iIndex].iNext = s_iDormantFreeHead;
+                s_iDormantFreeHead = (int16_t)iIndex;
+                s_uDormantCount--;
+                s_uDormantTransfers++;
+            }
+        }
+    }
+
+    if (s_uDormantCount == 0)
+        s_fDormantMaxSpeed = 0.0f;
+}
+
+bool space_objects_spawn_meteor_dormant(struct vec2 vPos, sprite_t *pSprite, float fAngleRad, float fRotationSpeed, int iCollisionRadius, int iHitPoints,
+                                        uint8_t uCurrencyId)
+{
+    if (!pSprite)
+        return false;
+
+    space_dormant_t record = {
+        .vPos = vPos,
+        .vVel = vec2_zero(),
+        .fAngleRad = fAngleRad,
+        .fRotationSpeed = fRotationSpeed,
+        .pSprite = pSprite,
+        .iHitPoints = (int16_t)iHitPoints,
+        .uCollisionRadius = (uint8_t)iCollisionRadius,
+        .uCurrencyId = uCurrencyId,
+        .uFramesAlive = 0,
+        .bSleeping = false,
+    };
+    return space_dormant_store(&record);
+}
+
+void space_objects_clear_dormant(void)
+{
+    space_dormant_reset();
+}
+
+int space_objects_get_dormant_count(void)
+{
+    return s_uDormantCount;
+}
+
 static void meteor_reflect_velocity(struct vec2 *pVel, struct vec2 vNormal)
 {
     float fLenSq = vec2_mag_sq(vNormal);
@@ -246,12 +783,13 @@ static void meteor_reflect_velocity(struct vec2 *pVel, struct vec2 vNormal)
     *pVel = vec2_sub(*pVel, vec2_scale(vN, 2.0f * fDot));
 }
 
-static void resolve_collision(SpaceObject *a, SpaceObject *b)
+/* Elastic bounce of two touching slots, on the object arrays */
+static void space_objects_resolve_pair(int a, int b)
 {
-    /* Elastic bounce */
-    struct vec2 vDelta = vec2_sub(b->entity.vPos, a->entity.vPos);
-    float fDistSq = vec2_mag_sq(vDelta);
-    float fRadSum = (float)(a->entity.iCollisionRadius + b->entity.iCollisionRadius);
+    float fDX = s_hot.afPosX[b] - s_hot.afPosX[a];
+    float fDY = s_hot.afPosY[b] - s_hot.afPosY[a];
+    float fDistSq = fDX * fDX + fDY * fDY;
+    float fRadSum = s_hot.afRadius[a] + s_hot.afRadius[b];
     float fRadSumSq = fRadSum * fRadSum;
 
     if (fDistSq >= fRadSumSq || fDistSq <= 1e-6f)
@@ -259,25 +797,32 @@ static void resolve_collision(SpaceObject *a, SpaceObject *b)
 
     float fDist = sqrtf(fDistSq);
     float fInvDist = 1.0f / fDist;
-    struct vec2 vNormal = vec2_scale(vDelta, fInvDist);
+    float fNX = fDX * fInvDist;
+    float fNY = fDY * fInvDist;
 
     /* Separate overlap equally. */
-    float fPenetration = fRadSum - fDist;
-    struct vec2 vCorrection = vec2_scale(vNormal, fPenetration * 0.5f);
-    a->entity.vPos = vec2_sub(a->entity.vPos, vCorrection);
-    b->entity.vPos = vec2_add(b->entity.vPos, vCorrection);
-
-    /* Reflect velocities */
-    float fDotA = vec2_dot(a->entity.vVel, vNormal);
-    float fDotB = vec2_dot(b->entity.vVel, vNormal);
-    struct vec2 vProjA = vec2_scale(vNormal, fDotA);
-    struct vec2 vProjB = vec2_scale(vNormal, fDotB);
-
-    a->entity.vVel = vec2_add(vec2_sub(a->entity.vVel, vProjA), vProjB);
-    b->entity.vVel = vec2_add(vec2_sub(b->entity.vVel, vProjB), vProjA);
-
-    a->bSleeping = false;
-    b->bSleeping = false;
+    float fHalfPenetration = (fRadSum - fDist) * 0.5f;
+    float fCorrX = fNX * fHalfPenetration;
+    float fCorrY = fNY * fHalfPenetration;
+    s_hot.afPosX[a] -= fCorrX;
+    s_hot.afPosY[a] -= fCorrY;
+    s_hot.afPosX[b] += fCorrX;
+    s_hot.afPosY[b] += fCorrY;
+
+    /* Reflect velocities: swap the normal components */
+    float fDotA = s_hot.afVelX[a] * fNX + s_hot.afVelY[a] * fNY;
+    float fDotB = s_hot.afVelX[b] * fNX + s_hot.afVelY[b] * fNY;
+    float fProjAX = fNX * fDotA;
+    float fProjAY = fNY * fDotA;
+    float fProjBX = fNX * fDotB;
+    float fProjBY = fNY * fDotB;
+    s_hot.afVelX[a] = (s_hot.afVelX[a] - fProjAX) + fProjBX;
+    s_hot.afVelY[a] = (s_hot.afVelY[a] - fProjAY) + fProjBY;
+    s_hot.afVelX[b] = (s_hot.afVelX[b] - fProjBX) + fProjAX;
+    s_hot.afVelY[b] = (s_hot.afVelY[b] - fProjBY) + fProjAY;
+
+    s_hot.auState[a] = (uint8_t)((s_hot.auState[a] & ~SO_HOT_SLEEPING) | SO_HOT_MOVED);
+    s_hot.auState[b] = (uint8_t)((s_hot.auState[b] & ~SO_HOT_SLEEPING) | SO_HOT_MOVED);
 }
 
 static void check_ufo_meteor_collisions(const struct entity2D *pUfo, int iMinCellX, int iMaxCellX, int iMinCellY, int iMaxCellY)
@@ -325,8 +870,10 @@ static void check_ufo_meteor_collisions(const struct entity2D *pUfo, int iMinCel
             bHadBounce = true;
             struct vec2 vUfoVel = vec2_scale(ufo_get_velocity(), -0.5f);
             ufo_set_velocity(vUfoVel);
-            meteor_reflect_velocity(&obj->entity.vVel, vNormal);
-            obj->bSleeping = false;
+            struct vec2 vVel = obj->entity.vVel;
+            meteor_reflect_velocity(&vVel, vNormal);
+            space_object_set_velocity(obj, vVel);
+            space_object_set_sleeping(obj, false);
         }
     }
 
@@ -390,13 +937,13 @@ void space_objects_resolve_ufo_solid_collision(SpaceObject *obj, const struct en
         else
         {
             struct vec2 vCorrection = vec2_scale(vNormal, fSeparation);
-            obj->entity.vPos = vec2_add(obj->entity.vPos, vCorrection);
+            space_object_set_position(obj, vec2_add(obj->entity.vPos, vCorrection));
 
             /* Cancel object velocity into UFO */
             float fVelDot = vec2_dot(obj->entity.vVel, vNormal);
             if (fVelDot < 0.0f)
             {
-                obj->entity.vVel = vec2_sub(obj->entity.vVel, vec2_scale(vNormal, fVelDot));
+                space_object_set_velocity(obj, vec2_sub(obj->entity.vVel, vec2_scale(vNormal, fVelDot)));
             }
         }
     }
@@ -412,8 +959,8 @@ void space_objects_resolve_ufo_solid_collision(SpaceObject *obj, const struct en
         if (!bPushUfo)
         {
             /* Objects get pushed away */
-            obj->entity.vVel = vec2_add(obj->entity.vVel, vec2_scale(vNormal, SO_BOUNCE_FORCE_OBJECT));
-            obj->bSleeping = false;
+            space_object_set_velocity(obj, vec2_add(obj->entity.vVel, vec2_scale(vNormal, SO_BOUNCE_FORCE_OBJECT)));
+            space_object_set_sleeping(obj, false);
         }
     }
 }
@@ -435,7 +982,7 @@ static void check_ufo_collision(SpaceObject *obj)
         if (obj->type == SO_PIECE)
         {
             /* Skip collection for pieces in assemble mode (they can still collide physically) */
-            if (obj->data.piece.bAssembleMode)
+            if (obj->pData->piece.bAssembleMode)
             {
                 space_objects_resolve_ufo_solid_collision(obj, pUfo, events, false, SO_BOUNCE_FORCE_UFO, SO_BOUNCE_COOLDOWN_MS);
             }
@@ -451,26 +998,189 @@ static void check_ufo_collision(SpaceObject *obj)
     }
 }
 
-void space_objects_update(void)
+/* Integration kernel: move the meteors listed by the logic pass, damp currency meteors and put slow ones to
+ * sleep, all on the object arrays */
+static void space_objects_integrate(float _fFrameMul)
 {
-    float fFrameMul = frame_time_mul();
-    bool bMinimapActive = minimap_is_active();
+    float fDamping = powf(METEOR_CURRENCY_VELOCITY_DAMPING, _fFrameMul);
+    for (uint16_t k = 0; k < s_hot.uMovingCount; k++)
+    {
+        int i = s_hot.auMoving[k];
+        uint8_t uState = s_hot.auState[i];
+        uint8_t uMotion = s_hot.auMotion[i];
+        if (!(uState & SO_HOT_SLEEPING))
+        {
+            s_hot.afPosX[i] += s_hot.afVelX[i] * _fFrameMul;
+            s_hot.afPosY[i] += s_hot.afVelY[i] * _fFrameMul;
+            uState |= SO_HOT_MOVED;
 
-    /* Reset Grid - Always reset to ensure it's empty if we skip filling it */
-    memset(s_gridHead, 0xFF, sizeof(s_gridHead));
+            if (uMotion & SO_HOT_MOTION_DAMPED)
+            {
+                s_hot.afVelX[i] *= fDamping;
+                s_hot.afVelY[i] *= fDamping;
+                if (s_hot.afVelX[i] * s_hot.afVelX[i] + s_hot.afVelY[i] * s_hot.afVelY[i] <= METEOR_CURRENCY_SLEEP_VEL_SQ)
+                {
+                    s_hot.afVelX[i] = 0.0f;
+                    s_hot.afVelY[i] = 0.0f;
+                    uState |= SO_HOT_SLEEPING;
+                }
+            }
+        }
+
+        if ((uMotion & SO_HOT_MOTION_MAY_SLEEP) && s_hot.afVelX[i] * s_hot.afVelX[i] + s_hot.afVelY[i] * s_hot.afVelY[i] < 1e-6f)
+            uState |= SO_HOT_SLEEPING;
+        s_hot.auState[i] = uState;
+    }
+    s_hot.uMovingCount = 0;
+}
 
-    /* Update & Fill Grid */
-    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+/* Gather kernel: list the live objects (allocated, active, not marked for delete) with their radius and
+ * collidability, and bring the grid up to date. Objects that stayed in their cell keep their link; objects
+ * whose position was not written since they were linked skip the cell computation. */
+static void space_objects_gather_hot(void)
+{
+    uint16_t uLiveCount = 0;
+    for (int k = 0; k < s_aliveCount; k++)
     {
-        SpaceObject *obj = &s_objects[i];
-        if (obj->markForDelete)
+        int i = s_auActive[k];
+        const SpaceObject *pObj = &s_objects[i];
+        if (pObj->markForDelete || !entity2d_is_active(&pObj->entity))
+        {
+            space_grid_unlink(i);
+            continue;
+        }
+
+        uint8_t uState = s_hot.auState[i];
+        bool bResting = s_hot.aiBucket[i] >= 0 && !(uState & SO_HOT_MOVED);
+
+        s_hot.afRadius[i] = (float)pObj->entity.iCollisionRadius;
+        s_hot.auState[i] = (uint8_t)((uState & SO_HOT_SLEEPING) | (entity2d_is_collidable(&pObj->entity) ? SO_HOT_COLLIDABLE : 0));
+        s_hot.auLive[uLiveCount++] = (uint16_t)i;
+
+        if (bResting)
+            continue;
+
+        int iCellX = (int)fm_floorf(s_hot.afPosX[i] / SPACE_GRID_CELL);
+        int iCellY = (int)fm_floorf(s_hot.afPosY[i] / SPACE_GRID_CELL);
+        if (s_hot.aiBucket[i] >= 0)
         {
-            obj->bAllocated = false;
-            s_aliveCount--;
+            if (s_hot.aiCellX[i] == iCellX && s_hot.aiCellY[i] == iCellY)
+                continue;
+            space_grid_unlink(i);
+        }
+        space_grid_link(i, space_hash_cell(iCellX, iCellY), iCellX, iCellY);
+    }
+    s_hot.uLiveCount = uLiveCount;
+
+    /* Cell range of the links, so queries never walk empty space (objects are only linked here) */
+    s_iGridMinCellX = INT32_MAX;
+    s_iGridMaxCellX = INT32_MIN;
+    s_iGridMinCellY = INT32_MAX;
+    s_iGridMaxCellY = INT32_MIN;
+    for (uint16_t k = 0; k < uLiveCount; k++)
+    {
+        int i = s_hot.auLive[k];
+        s_iGridMinCellX = (s_hot.aiCellX[i] < s_iGridMinCellX) ? s_hot.aiCellX[i] : s_iGridMinCellX;
+        s_iGridMaxCellX = (s_hot.aiCellX[i] > s_iGridMaxCellX) ? s_hot.aiCellX[i] : s_iGridMaxCellX;
+        s_iGridMinCellY = (s_hot.aiCellY[i] < s_iGridMinCellY) ? s_hot.aiCellY[i] : s_iGridMinCellY;
+        s_iGridMaxCellY = (s_hot.aiCellY[i] > s_iGridMaxCellY) ? s_hot.aiCellY[i] : s_iGridMaxCellY;
+    }
+}
+
+/* Mirror the array state of the live objects into their entities (after the kernels moved them) */
+static void space_objects_publish(void)
+{
+    for (uint16_t k = 0; k < s_hot.uLiveCount; k++)
+    {
+        int i = s_hot.auLive[k];
+        s_objects[i].entity.vPos = vec2_make(s_hot.afPosX[i], s_hot.afPosY[i]);
+        s_objects[i].entity.vVel = vec2_make(s_hot.afVelX[i], s_hot.afVelY[i]);
+    }
+}
+
+/* Grid statistics for tuning SPACE_GRID_CELL / SPACE_GRID_BUCKETS */
+static void space_grid_report(void)
+{
+#ifdef PROFILER_ENABLED
+    uint16_t uLongestChain = 0;
+    for (int i = 0; i < SPACE_GRID_BUCKETS; i++)
+    {
+        if (s_auGridBucketCount[i] > uLongestChain)
+            uLongestChain = s_auGridBucketCount[i];
+    }
+    PROF_COUNTER_ADD(PROF_COUNTER_GRID_RELINKS, s_uGridRelinks);
+    PROF_COUNTER_ADD(PROF_COUNTER_GRID_BUCKETS, s_uGridOccupied);
+    PROF_COUNTER_ADD(PROF_COUNTER_GRID_CHAIN, uLongestChain);
+#endif
+    s_uGridRelinks = 0;
+}
+
+/* Pair kernel: object vs. object bounces on the object arrays. Candidates are rejected on order, collidable,
+ * both asleep and circle overlap; touching pairs are resolved in place. */
+static void space_objects_collide_pairs(void)
+{
+    for (uint16_t k = 0; k < s_hot.uLiveCount; k++)
+    {
+        int a = s_hot.auLive[k];
+        if (!(s_hot.auState[a] & SO_HOT_COLLIDABLE))
             continue;
+
+        int iCellX = (int)fm_floorf(s_hot.afPosX[a] / SPACE_GRID_CELL);
+        int iCellY = (int)fm_floorf(s_hot.afPosY[a] / SPACE_GRID_CELL);
+
+        for (int iCx = iCellX - 1; iCx <= iCellX + 1; iCx++)
+        {
+            for (int iCy = iCellY - 1; iCy <= iCellY + 1; iCy++)
+            {
+                for (int b = s_gridHead[space_hash_cell(iCx, iCy)]; b != -1; b = s_hot.aiNextInCell[b])
+                {
+                    if (b <= a)
+                        continue; /* Avoid duplicates and self */
+
+                    uint8_t uStateB = s_hot.auState[b];
+                    if (!(uStateB & SO_HOT_COLLIDABLE))
+                        continue;
+                    if (s_hot.auState[a] & uStateB & SO_HOT_SLEEPING)
+                        continue;
+
+                    float fDX = s_hot.afPosX[b] - s_hot.afPosX[a];
+                    float fDY = s_hot.afPosY[b] - s_hot.afPosY[a];
+                    float fRadSum = s_hot.afRadius[a] + s_hot.afRadius[b];
+                    if (fDX * fDX + fDY * fDY >= fRadSum * fRadSum)
+                        continue;
+
+                    space_objects_resolve_pair(a, b);
+                }
+            }
         }
+    }
+}
+
+void space_objects_update(void)
+{
+    float fFrameMul = frame_time_mul();
+    bool bMinimapActive = minimap_is_active();
+
+    /* Release objects marked for delete since the last update */
+    space_objects_compact();
+
+    /* Meteor logic is paused while the minimap is open, and so is the dormant clock */
+    if (!bMinimapActive)
+    {
+        space_objects_update_dormancy();
+        s_fDormantClock += fFrameMul;
+    }
+    PROF_COUNTER_ADD(PROF_COUNTER_SPACE_DORMANT, s_uDormantCount);
+    PROF_COUNTER_ADD(PROF_COUNTER_SPACE_TRANSFERS, s_uDormantTransfers);
+    s_uDormantTransfers = 0;
 
-        if (!obj->bAllocated || !entity2d_is_active(&obj->entity))
+    /* Logic pass in slot order (objects spawned during the pass are appended and first updated next frame) */
+    int iLogicCount = s_aliveCount;
+    for (int k = 0; k < iLogicCount; k++)
+    {
+        int i = s_auActive[k];
+        SpaceObject *obj = &s_objects[i];
+        if (obj->markForDelete || !entity2d_is_active(&obj->entity))
             continue;
 
         /* Clear event flag after update loop read it? No, set it false here so next frame reads it correctly?
@@ -509,96 +1219,49 @@ void space_objects_update(void)
             if (obj->entity.bGrabbed)
             {
                 /* Wake up if grabbed */
-                obj->bSleeping = false;
-                obj->data.meteor.iFramesAlive = 0;
-                obj->data.meteor.fRotationSpeed = 0.0f;
+                s_hot.auState[i] &= (uint8_t)~SO_HOT_SLEEPING;
+                obj->pData->meteor.iFramesAlive = 0;
+                obj->pData->meteor.fRotationSpeed = 0.0f;
             }
             else
             {
-                obj->entity.fAngleRad += obj->data.meteor.fRotationSpeed * fFrameMul;
+                obj->entity.fAngleRad += obj->pData->meteor.fRotationSpeed * fFrameMul;
                 obj->entity.fAngleRad = angle_wrap_rad(obj->entity.fAngleRad);
             }
 
             /* Tint decay should be time-based, not render-based */
-            if (obj->data.meteor.fTintFrames > 0.0f)
-            {
-                obj->data.meteor.fTintFrames -= fFrameMul;
-                if (obj->data.meteor.fTintFrames < 0.0f)
-                    obj->data.meteor.fTintFrames = 0.0f;
-            }
-
-            /* Position update - always happens unless sleeping (original logic) */
-            /* Tractor beam might override position later in tractor_beam_update,
-               but originally meteors updated pos here too. */
-            if (!obj->bSleeping)
-            {
-                obj->entity.vPos = vec2_add(obj->entity.vPos, vec2_scale(obj->entity.vVel, fFrameMul));
-            }
-
-            if (obj->data.meteor.uCurrencyId > 0 && !obj->entity.bGrabbed && !obj->bSleeping)
+            if (obj->pData->meteor.fTintFrames > 0.0f)
             {
-                float fDamping = powf(METEOR_CURRENCY_VELOCITY_DAMPING, fFrameMul);
-                obj->entity.vVel = vec2_scale(obj->entity.vVel, fDamping);
-                if (vec2_mag_sq(obj->entity.vVel) <= METEOR_CURRENCY_SLEEP_VEL_SQ)
-                {
-                    obj->entity.vVel = vec2_zero();
-                    obj->bSleeping = true;
-                }
+                obj->pData->meteor.fTintFrames -= fFrameMul;
+                if (obj->pData->meteor.fTintFrames < 0.0f)
+                    obj->pData->meteor.fTintFrames = 0.0f;
             }
 
-            /* Sleeping logic */
-            if (obj->data.meteor.iFramesAlive < METEOR_SLEEP_COOLDOWN_FRAMES)
-                obj->data.meteor.iFramesAlive++;
+            if (obj->pData->meteor.iFramesAlive < METEOR_SLEEP_COOLDOWN_FRAMES)
+                obj->pData->meteor.iFramesAlive++;
 
-            if (!obj->entity.bGrabbed && obj->data.meteor.iFramesAlive >= METEOR_SLEEP_COOLDOWN_FRAMES)
-            {
-                float fVelMagSq = vec2_mag_sq(obj->entity.vVel);
-                if (fVelMagSq < 1e-6f)
-                    obj->bSleeping = true;
-            }
+            /* Position, currency damping and sleep run in space_objects_integrate. Tractor beam might override
+               position later in tractor_beam_update. */
+            s_hot.auMotion[i] = (uint8_t)((obj->pData->meteor.uCurrencyId > 0 && !obj->entity.bGrabbed ? SO_HOT_MOTION_DAMPED : 0) |
+                                          (!obj->entity.bGrabbed && obj->pData->meteor.iFramesAlive >= METEOR_SLEEP_COOLDOWN_FRAMES ? SO_HOT_MOTION_MAY_SLEEP : 0));
+            s_hot.auMoving[s_hot.uMovingCount++] = (uint16_t)i;
             break;
         }
-
-        /* Insert into grid only if minimap is NOT active */
-        if (!bMinimapActive)
-        {
-            int cellX = (int)fm_floorf(obj->entity.vPos.fX / SPACE_GRID_CELL);
-            int cellY = (int)fm_floorf(obj->entity.vPos.fY / SPACE_GRID_CELL);
-            int bucket = space_hash_cell(cellX, cellY);
-
-            obj->next_in_cell = s_gridHead[bucket];
-            s_gridHead[bucket] = i;
-        }
     }
 
-    /* Collision Pass - Skip entirely if minimap is active */
+    /* Collision Pass - Skip entirely if minimap is active (grid is emptied, queries find nothing) */
     if (bMinimapActive)
     {
+        if (s_uGridLinked > 0)
+            space_grid_reset();
         return;
     }
 
-    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
-    {
-        SpaceObject *a = &s_objects[i];
-        if (!a->bAllocated || !entity2d_is_active(&a->entity) || !entity2d_is_collidable(&a->entity))
-            continue;
-
-        int cellX = (int)fm_floorf(a->entity.vPos.fX / SPACE_GRID_CELL);
-        int cellY = (int)fm_floorf(a->entity.vPos.fY / SPACE_GRID_CELL);
-
-        /* Check neighbors using optimized macro */
-        SPACE_GRID_LOOP(cellX - 1, cellX + 1, cellY - 1, cellY + 1, b)
-        {
-            if (b <= a)
-                continue; /* Avoid duplicates and self */
-            if (!entity2d_is_collidable(&b->entity))
-                continue;
-            if (a->bSleeping && b->bSleeping)
-                continue;
-
-            resolve_collision(a, b);
-        }
-    }
+    space_objects_integrate(fFrameMul);
+    space_objects_gather_hot();
+    space_grid_report();
+    space_objects_collide_pairs();
+    space_objects_publish();
 
     /* UFO Collision Pass - Optimization: Only check objects in UFO's vicinity */
     const struct entity2D *pUfo = ufo_get_entity();
@@ -644,15 +1307,21 @@ void space_objects_update(void)
     satellite_pieces_check_center_collision();
 }
 
-/* Helper: Render a single object if visible */
+/* Render queue callback for NPCs (obj stays valid until the flush) */
+static void render_npc_object(void *_pContext, int _iX, int _iY, float _fScale)
+{
+    npc_alien_render_object((SpaceObject *)_pContext, vec2i_make(_iX, _iY), _fScale);
+}
+
+/* Helper: Queue a single object if visible */
 static inline void render_single_object(SpaceObject *obj, float fBaseX, float fBaseY, float fZoom, float fCamLeft, float fCamRight, float fCamTop, float fCamBottom,
-                                        int *iLastRenderType, bool bMinimapActive, int iIndex)
+                                        bool bMinimapActive, int iIndex)
 {
     if (!obj->bAllocated || !entity2d_is_active(&obj->entity) || !entity2d_is_visible(&obj->entity))
         return;
 
     /* Minimap culling optimization for meteors */
-    if (bMinimapActive && obj->type == SO_METEOR && (iIndex % METEOR_MINIMAP_RENDER_INTERVAL != 0) && obj->data.meteor.uCurrencyId == 0)
+    if (bMinimapActive && obj->type == SO_METEOR && (iIndex % METEOR_MINIMAP_RENDER_INTERVAL != 0) && obj->pData->meteor.uCurrencyId == 0)
         return;
 
     const struct entity2D *pEnt = &obj->entity;
@@ -673,30 +1342,42 @@ static inline void render_single_object(SpaceObject *obj, float fBaseX, float fB
     vScreen.iX = (int)fm_floorf(fBaseX + pEnt->vPos.fX * fZoom);
     vScreen.iY = (int)fm_floorf(fBaseY + pEnt->vPos.fY * fZoom);
 
-    /* Render Dispatch */
+    /* Render Dispatch: queued, the render queue batches state and uploads across objects */
     if (obj->type == SO_METEOR)
-    {
-        if (*iLastRenderType != 0)
-        {
-            rdpq_set_mode_standard();
-            rdpq_mode_combiner(RDPQ_COMBINER_TEX_FLAT);
-            rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
-            rdpq_mode_filter(FILTER_BILINEAR);
-            rdpq_set_prim_color(RGBA32(255, 255, 255, 255));
-            *iLastRenderType = 0;
-        }
         meteor_render_object(obj, vScreen, fZoom);
-    }
-    else
+    else if (obj->type == SO_NPC)
+        render_queue_custom(RENDER_LAYER_OBJECTS, render_npc_object, obj, vScreen.iX, vScreen.iY, fZoom); /* Multi-sprite, sets its own state */
+    else if (obj->type == SO_PIECE)
+        satellite_piece_render_object(obj, vScreen, fZoom);
+}
+
+/* Minimap: parked meteors at their caught-up positions, through the same path as live ones. They can outnumber
+ * every other draw of the frame, so they skip the render queue and draw right away (below the queued layers). */
+static void render_dormant_meteors(float fBaseX, float fBaseY, float fZoom, float fCamLeft, float fCamRight, float fCamTop, float fCamBottom)
+{
+    SpaceObject obj;
+    SpaceObjectData data;
+    memset(&obj, 0, sizeof(obj));
+    memset(&data, 0, sizeof(data));
+    obj.type = SO_METEOR;
+    obj.pData = &data;
+    obj.bAllocated = true;
+
+    render_queue_set_immediate(true);
+    for (int iBucket = 0; iBucket < SPACE_SECTOR_BUCKETS; iBucket++)
     {
-        /* NPC and PIECE handle their own state */
-        if (obj->type == SO_NPC)
-            npc_alien_render_object(obj, vScreen, fZoom);
-        else if (obj->type == SO_PIECE)
-            satellite_piece_render_object(obj, vScreen, fZoom);
+        for (int i = s_aiSectorHead[iBucket]; i != -1; i = s_dormant[i].iNext)
+        {
+            space_dormant_t record = s_dormant[i];
+            space_dormant_advance(&record, s_fDormantClock - record.fParkedClock);
 
-        *iLastRenderType = 1;
+            entity2d_init_from_sprite(&obj.entity, record.vPos, record.pSprite, ENTITY_FLAG_ACTIVE | ENTITY_FLAG_VISIBLE, ENTITY_LAYER_GAMEPLAY);
+            obj.entity.fAngleRad = record.fAngleRad;
+            data.meteor.uCurrencyId = record.uCurrencyId;
+            render_single_object(&obj, fBaseX, fBaseY, fZoom, fCamLeft, fCamRight, fCamTop, fCamBottom, true, i);
+        }
     }
+    render_queue_set_immediate(false);
 }
 
 void space_objects_render(void)
@@ -713,7 +1394,6 @@ void space_objects_render(void)
     float fCamBottom = pCamera->vPos.fY + fCamHalfY;
     float fBaseX = (float)pCamera->vHalf.iX - pCamera->vPos.fX * fZoom;
     float fBaseY = (float)pCamera->vHalf.iY - pCamera->vPos.fY * fZoom;
-    int iLastRenderType = -1; /* -1: None, 0: Meteor, 1: Other */
 
     if (!bMinimapActive)
     {
@@ -735,16 +1415,19 @@ void space_objects_render(void)
                 continue;
             s_renderStamp[j] = s_renderStampCounter;
 
-            render_single_object(obj, fBaseX, fBaseY, fZoom, fCamLeft, fCamRight, fCamTop, fCamBottom, &iLastRenderType, false, j);
+            render_single_object(obj, fBaseX, fBaseY, fZoom, fCamLeft, fCamRight, fCamTop, fCamBottom, false, j);
         }
         return;
     }
 
-    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+    for (int k = 0; k < s_aliveCount; k++)
     {
-        SpaceObject *obj = &s_objects[i];
-        render_single_object(obj, fBaseX, fBaseY, fZoom, fCamLeft, fCamRight, fCamTop, fCamBottom, &iLastRenderType, true, i);
+        int i = s_auActive[k];
+        render_single_object(&s_objects[i], fBaseX, fBaseY, fZoom, fCamLeft, fCamRight, fCamTop, fCamBottom, true, i);
     }
+
+    if (s_uDormantCount > 0)
+        render_dormant_meteors(fBaseX, fBaseY, fZoom, fCamLeft, fCamRight, fCamTop, fCamBottom);
 }
 
 /* API Helpers */
@@ -765,6 +1448,13 @@ int space_objects_get_max_count(void)
     return MAX_SPACE_OBJECTS;
 }
 
+SpaceObject *space_objects_get_active(int index)
+{
+    if (index < 0 || index >= s_aliveCount)
+        return NULL;
+    return &s_objects[s_auActive[index]];
+}
+
 void space_object_apply_damage(SpaceObject *obj, int iDamage, struct vec2 vImpactDir)
 {
     if (!obj || !obj->bAllocated || !entity2d_is_active(&obj->entity))
@@ -774,16 +1464,16 @@ void space_object_apply_damage(SpaceObject *obj, int iDamage, struct vec2 vImpac
     {
     case SO_METEOR:
         meteor_apply_damage(obj, iDamage, vImpactDir);
-        if (obj->data.meteor.uCurrencyId > 0 && vec2_mag_sq(vImpactDir) > 1e-6f)
+        if (obj->pData->meteor.uCurrencyId > 0 && vec2_mag_sq(vImpactDir) > 1e-6f)
         {
-            obj->bSleeping = false;
-            obj->data.meteor.iFramesAlive = 0;
+            space_object_set_sleeping(obj, false);
+            obj->pData->meteor.iFramesAlive = 0;
         }
         break;
     case SO_NPC:
         /* NPCs cannot be destroyed - show shield effect and apply impact force */
         {
-            NpcData *pData = &obj->data.npc;
+            NpcData *pData = &obj->pData->npc;
             uint32_t uCurrentMs = get_ticks_ms();
             pData->uShieldEndMs = uCurrentMs + 300; /* 300ms shield duration (matches NPC_ALIEN_SHIELD_DURATION_MS) */
 
@@ -798,235 +1488,522 @@ void space_object_apply_damage(SpaceObject *obj, int iDamage, struct vec2 vImpac
         /* Wake up the piece so it starts moving */
         if (vec2_mag_sq(vImpactDir) > 1e-6f)
         {
-            obj->bSleeping = false;
+            space_object_set_sleeping(obj, false);
         }
         break;
     }
 }
 
-/* Queries - adapted from meteors.c */
-const struct entity2D *space_objects_get_closest_entity_on_screen(struct vec2 vFrom, const struct camera2D *pCamera, float fActivationMargin)
+/* =========================
+   Spatial queries
+   ========================= */
+
+void space_query_circle(SpaceQuery *pQuery, struct vec2 vCenter, float fRadius)
 {
-    if (s_aliveCount == 0 || !pCamera)
-        return NULL;
+    memset(pQuery, 0, sizeof(*pQuery));
+    pQuery->vCenter = vCenter;
+    pQuery->fMaxRadius = fRadius;
+}
 
-    /* Optimized Grid Search */
-    float fBestDistSq = 0.0f;
-    const SpaceObject *pBest = NULL;
+void space_query_annulus(SpaceQuery *pQuery, struct vec2 vCenter, float fInnerRadius, float fOuterRadius)
+{
+    space_query_circle(pQuery, vCenter, fOuterRadius);
+    pQuery->fMinRadius = fInnerRadius;
+}
 
-    int iMinCellX, iMaxCellX, iMinCellY, iMaxCellY;
-    space_calc_camera_grid_bounds(pCamera, fActivationMargin, &iMinCellX, &iMaxCellX, &iMinCellY, &iMaxCellY);
+void space_query_cone(SpaceQuery *pQuery, struct vec2 vApex, float fFacingAngleRad, float fHalfAngleRad, float fRange)
+{
+    space_query_circle(pQuery, vApex, fRange);
+    pQuery->bCone = true;
+    pQuery->vFacing = vec2_make(fm_sinf(fFacingAngleRad), -fm_cosf(fFacingAngleRad));
+    pQuery->fCosHalfAngle = cosf(fHalfAngleRad);
+}
 
-    /* Precalculate camera bounds for fast visibility check */
-    float fCamLeft, fCamRight, fCamTop, fCamBottom;
-    space_calc_camera_bounds(pCamera, fActivationMargin, &fCamLeft, &fCamRight, &fCamTop, &fCamBottom);
+void space_query_set_bounds(SpaceQuery *pQuery, float fLeft, float fRight, float fTop, float fBottom)
+{
+    pQuery->bBounds = true;
+    pQuery->fLeft = fLeft;
+    pQuery->fRight = fRight;
+    pQuery->fTop = fTop;
+    pQuery->fBottom = fBottom;
+}
 
-    SPACE_GRID_LOOP(iMinCellX, iMaxCellX, iMinCellY, iMaxCellY, obj)
+/* Query helper: cell range that can hold matches (radius box, clipped to the bounds rect and the linked cells).
+ * Returns true if testing every live object is cheaper than walking the range: annuli and cones of a few
+ * hundred pixels, unlimited radii and nearest queries in sparse fields. A nearest query (_uK > 0) expects to stop
+ * after the rings that hold about 4 * _uK objects at the average density of the linked cells. */
+static bool space_query_cell_range(const SpaceQuery *pQuery, uint16_t _uK, int *pMinX, int *pMaxX, int *pMinY, int *pMaxY)
+{
+    float fMinX = pQuery->vCenter.fX - pQuery->fMaxRadius;
+    float fMaxX = pQuery->vCenter.fX + pQuery->fMaxRadius;
+    float fMinY = pQuery->vCenter.fY - pQuery->fMaxRadius;
+    float fMaxY = pQuery->vCenter.fY + pQuery->fMaxRadius;
+    if (pQuery->bBounds)
     {
-        /* Fast visibility check (grid cells are rough approximations) */
-        if (obj->entity.vPos.fX < fCamLeft || obj->entity.vPos.fX > fCamRight || obj->entity.vPos.fY < fCamTop || obj->entity.vPos.fY > fCamBottom)
-            continue;
+        fMinX = (pQuery->fLeft > fMinX) ? pQuery->fLeft : fMinX;
+        fMaxX = (pQuery->fRight < fMaxX) ? pQuery->fRight : fMaxX;
+        fMinY = (pQuery->fTop > fMinY) ? pQuery->fTop : fMinY;
+        fMaxY = (pQuery->fBottom < fMaxY) ? pQuery->fBottom : fMaxY;
+    }
 
-        struct vec2 vDelta = vec2_sub(obj->entity.vPos, vFrom);
-        float fDistSq = vec2_mag_sq(vDelta);
+    /* Keep unbounded queries in int range */
+    fMinX = (fMinX < -SPACE_QUERY_WORLD_LIMIT) ? -SPACE_QUERY_WORLD_LIMIT : fMinX;
+    fMaxX = (fMaxX > SPACE_QUERY_WORLD_LIMIT) ? SPACE_QUERY_WORLD_LIMIT : fMaxX;
+    fMinY = (fMinY < -SPACE_QUERY_WORLD_LIMIT) ? -SPACE_QUERY_WORLD_LIMIT : fMinY;
+    fMaxY = (fMaxY > SPACE_QUERY_WORLD_LIMIT) ? SPACE_QUERY_WORLD_LIMIT : fMaxY;
+    space_calc_grid_bounds(fMinX, fMaxX, fMinY, fMaxY, pMinX, pMaxX, pMinY, pMaxY);
+
+    *pMinX = (s_iGridMinCellX > *pMinX) ? s_iGridMinCellX : *pMinX;
+    *pMaxX = (s_iGridMaxCellX < *pMaxX) ? s_iGridMaxCellX : *pMaxX;
+    *pMinY = (s_iGridMinCellY > *pMinY) ? s_iGridMinCellY : *pMinY;
+    *pMaxY = (s_iGridMaxCellY < *pMaxY) ? s_iGridMaxCellY : *pMaxY;
+    if (*pMinX > *pMaxX || *pMinY > *pMaxY)
+        return false;
 
-        if (!pBest || fDistSq < fBestDistSq)
-        {
-            fBestDistSq = fDistSq;
-            pBest = obj;
-        }
+    int64_t iCells = (int64_t)(*pMaxX - *pMinX + 1) * (int64_t)(*pMaxY - *pMinY + 1);
+    if (_uK > 0)
+    {
+        int64_t iLinkedCells = (int64_t)(s_iGridMaxCellX - s_iGridMinCellX + 1) * (int64_t)(s_iGridMaxCellY - s_iGridMinCellY + 1);
+        int64_t iRingCells = 4 * (int64_t)_uK * iLinkedCells / s_uGridLinked + 9;
+        iCells = (iRingCells < iCells) ? iRingCells : iCells;
     }
-    return pBest ? &pBest->entity : NULL;
+    return iCells * SPACE_QUERY_CELL_COST >= (int64_t)s_hot.uLiveCount;
 }
 
-const struct entity2D *space_objects_get_closest_entity_in_viewcone(struct vec2 vFrom, float fFacingAngleRad, const struct camera2D *pCamera, float fViewconeHalfAngleRad,
-                                                                    float fActivationMargin)
+/* Query helper: test one object against all constraints, returns its squared distance via pOutDistSq */
+static inline bool space_query_match(const SpaceQuery *pQuery, const SpaceObject *obj, float *pOutDistSq)
 {
-    if (s_aliveCount == 0 || !pCamera)
-        return NULL;
-
-    if (minimap_is_active())
-        return NULL;
-
-    /* --- Optimized Grid Search --- */
+    float fX = obj->entity.vPos.fX;
+    float fY = obj->entity.vPos.fY;
+    if (pQuery->bBounds && (fX < pQuery->fLeft || fX > pQuery->fRight || fY < pQuery->fTop || fY > pQuery->fBottom))
+        return false;
 
-    float fBestDistSq = 0.0f;
-    const SpaceObject *pBest = NULL;
+    float fDX = fX - pQuery->vCenter.fX;
+    float fDY = fY - pQuery->vCenter.fY;
+    float fDistSq = fDX * fDX + fDY * fDY;
+    if (fDistSq > pQuery->fMaxRadius * pQuery->fMaxRadius || fDistSq < pQuery->fMinRadius * pQuery->fMinRadius)
+        return false;
 
-    /* Precompute Facing Vector & Dot Product Thresholds */
-    float fFaceX = fm_sinf(fFacingAngleRad);
-    float fFaceY = -fm_cosf(fFacingAngleRad);
-    struct vec2 vFacing = {fFaceX, fFaceY};
+    if (pQuery->bCone)
+    {
+        if (fDistSq <= 1e-6f)
+            return false;
 
-    float fCosHalfAngle = cosf(fViewconeHalfAngleRad);
-    float fCosHalfAngleSq = fCosHalfAngle * fCosHalfAngle;
+        /* In front and within the half angle (compare squares) */
+        float fDot = fDX * pQuery->vFacing.fX + fDY * pQuery->vFacing.fY;
+        if (fDot < 0.0f || (fDot * fDot) < (fDistSq * pQuery->fCosHalfAngle * pQuery->fCosHalfAngle))
+            return false;
+    }
 
-    int iMinCellX, iMaxCellX, iMinCellY, iMaxCellY;
-    space_calc_camera_grid_bounds(pCamera, fActivationMargin, &iMinCellX, &iMaxCellX, &iMinCellY, &iMaxCellY);
+    *pOutDistSq = fDistSq;
+    return true;
+}
 
-    /* Precalculate camera bounds for fast visibility check */
-    float fCamLeft, fCamRight, fCamTop, fCamBottom;
-    space_calc_camera_bounds(pCamera, fActivationMargin, &fCamLeft, &fCamRight, &fCamTop, &fCamBottom);
+/* Query helper: test the objects of one bucket chain, calling the collector for each new match */
+#define SPACE_QUERY_BUCKET(pQuery, iBucket, iIndexName, fDistSqName, collect)                                                                                                       \
+    for (int iIndexName = s_gridHead[(iBucket)]; iIndexName != -1; iIndexName = s_hot.aiNextInCell[iIndexName])                                                                    \
+    {                                                                                                                                                                              \
+        if (s_queryStamp[iIndexName] == s_queryStampCounter)                                                                                                                       \
+            continue;                                                                                                                                                              \
+        s_queryStamp[iIndexName] = s_queryStampCounter;                                                                                                                            \
+        const SpaceObject *_pObj = &s_objects[iIndexName];                                                                                                                         \
+        float fDistSqName;                                                                                                                                                         \
+        if (_pObj->markForDelete || !entity2d_is_active(&_pObj->entity) || !space_query_match((pQuery), _pObj, &fDistSqName))                                                     \
+            continue;                                                                                                                                                              \
+        collect;                                                                                                                                                                   \
+    }
 
-    SPACE_GRID_LOOP(iMinCellX, iMaxCellX, iMinCellY, iMaxCellY, obj)
-    {
-        /* Fast visibility check (grid cells are rough approximations) */
-        if (obj->entity.vPos.fX < fCamLeft || obj->entity.vPos.fX > fCamRight || obj->entity.vPos.fY < fCamTop || obj->entity.vPos.fY > fCamBottom)
-            continue;
+/* Query helper: test every live object (the objects linked in the grid), calling the collector for each match */
+#define SPACE_QUERY_LIVE(pQuery, iIndexName, fDistSqName, collect)                                                                                                                  \
+    for (const uint16_t *_pLive = s_hot.auLive, *_pEnd = s_hot.auLive + s_hot.uLiveCount; _pLive != _pEnd; _pLive++)                                                              \
+    {                                                                                                                                                                              \
+        int iIndexName = *_pLive;                                                                                                                                                  \
+        const SpaceObject *_pObj = &s_objects[iIndexName];                                                                                                                         \
+        float fDistSqName;                                                                                                                                                         \
+        if (_pObj->markForDelete || !entity2d_is_active(&_pObj->entity) || !space_query_match((pQuery), _pObj, &fDistSqName))                                                     \
+            continue;                                                                                                                                                              \
+        collect;                                                                                                                                                                   \
+    }
 
-        /* Viewcone Math (Dot Product) */
-        struct vec2 vDelta = vec2_sub(obj->entity.vPos, vFrom);
-        float fDistSq = vec2_mag_sq(vDelta);
-        if (fDistSq <= 1e-6f)
-            continue;
+uint16_t space_objects_query(const SpaceQuery *pQuery, uint16_t *pOutIndices, uint16_t uMaxResults)
+{
+    if (!pQuery || !pOutIndices || uMaxResults == 0 || s_uGridLinked == 0)
+        return 0;
 
-        float fDot = vec2_dot(vDelta, vFacing);
+    int iMinX, iMaxX, iMinY, iMaxY;
+    bool bScan = space_query_cell_range(pQuery, 0, &iMinX, &iMaxX, &iMinY, &iMaxY);
 
-        /* 1. Behind check */
-        if (fDot < 0.0f)
-            continue;
+    uint16_t uCount = 0;
+    if (bScan)
+    {
+        SPACE_QUERY_LIVE(pQuery, j, fDistSq, {
+            (void)fDistSq;
+            pOutIndices[uCount++] = (uint16_t)j;
+            if (uCount == uMaxResults)
+                return uCount;
+        })
+        return uCount;
+    }
 
-        /* 2. Angle check (compare squares) */
-        if ((fDot * fDot) < (fDistSq * fCosHalfAngleSq))
-            continue;
+    space_query_stamp_next();
 
-        /* Found valid candidate */
-        if (!pBest || fDistSq < fBestDistSq)
+    for (int iCx = iMinX; iCx <= iMaxX; iCx++)
+    {
+        for (int iCy = iMinY; iCy <= iMaxY; iCy++)
         {
-            fBestDistSq = fDistSq;
-            pBest = obj;
+            SPACE_QUERY_BUCKET(pQuery, space_hash_cell(iCx, iCy), j, fDistSq, {
+                (void)fDistSq;
+                pOutIndices[uCount++] = (uint16_t)j;
+                if (uCount == uMaxResults)
+                    return uCount;
+            })
         }
     }
+    return uCount;
+}
 
-    return pBest ? &pBest->entity : NULL;
+/* Nearest query helper: keep the uK best sorted (closest first), dropping the farthest when full */
+static inline void space_query_nearest_insert(int iIndex, float fDistSq, uint16_t uK, uint16_t *pOutIndices, float *pBestDistSq, uint16_t *pCount)
+{
+    if (*pCount == uK && fDistSq >= pBestDistSq[uK - 1])
+        return;
+
+    int iPos = (*pCount < uK) ? (*pCount)++ : uK - 1;
+    while (iPos > 0 && pBestDistSq[iPos - 1] > fDistSq)
+    {
+        pBestDistSq[iPos] = pBestDistSq[iPos - 1];
+        pOutIndices[iPos] = pOutIndices[iPos - 1];
+        iPos--;
+    }
+    pBestDistSq[iPos] = fDistSq;
+    pOutIndices[iPos] = (uint16_t)iIndex;
 }
 
-void space_objects_damage_in_radius(struct vec2 vCenter, float fRadius, int iDamage, struct vec2 vImpactDir)
+/* Nearest query helper: test the objects of one bucket chain */
+static inline void space_query_nearest_bucket(const SpaceQuery *pQuery, int iBucket, uint16_t uK, uint16_t *pOutIndices, float *pBestDistSq, uint16_t *pCount)
 {
-    float fRadiusSq = fRadius * fRadius;
+    SPACE_QUERY_BUCKET(pQuery, iBucket, j, fDistSq, space_query_nearest_insert(j, fDistSq, uK, pOutIndices, pBestDistSq, pCount))
+}
 
-    /* Using grid for efficiency */
-    int minX, maxX, minY, maxY;
-    space_calc_grid_bounds(vCenter.fX - fRadius, vCenter.fX + fRadius, vCenter.fY - fRadius, vCenter.fY + fRadius, &minX, &maxX, &minY, &maxY);
+/* Rings of cells around the query center (Chebyshev distance r), clipped to the cell range. Anything in a ring
+ * beyond r is at least r cells away, so the search stops once the k-th best is closer than r * SPACE_GRID_CELL.
+ * Rings start at the first one that reaches the cell range. */
+uint16_t space_objects_query_nearest(const SpaceQuery *pQuery, uint16_t uK, uint16_t *pOutIndices)
+{
+    if (!pQuery || !pOutIndices || uK == 0 || s_uGridLinked == 0)
+        return 0;
+    if (uK > SPACE_QUERY_MAX_K)
+        uK = SPACE_QUERY_MAX_K;
+
+    int iMinX, iMaxX, iMinY, iMaxY;
+    bool bScan = space_query_cell_range(pQuery, uK, &iMinX, &iMaxX, &iMinY, &iMaxY);
+    if (iMinX > iMaxX || iMinY > iMaxY)
+        return 0;
+
+    float afBestDistSq[SPACE_QUERY_MAX_K];
+    uint16_t uCount = 0;
+    if (bScan)
+    {
+        SPACE_QUERY_LIVE(pQuery, j, fDistSq, space_query_nearest_insert(j, fDistSq, uK, pOutIndices, afBestDistSq, &uCount))
+        return uCount;
+    }
 
-    SPACE_GRID_LOOP(minX, maxX, minY, maxY, obj)
+    space_query_stamp_next();
+
+    /* Center cell clamped into int range like the cell range; rings stay measured from it */
+    float fCenterX = fmaxf(fminf(pQuery->vCenter.fX, SPACE_QUERY_WORLD_LIMIT), -SPACE_QUERY_WORLD_LIMIT);
+    float fCenterY = fmaxf(fminf(pQuery->vCenter.fY, SPACE_QUERY_WORLD_LIMIT), -SPACE_QUERY_WORLD_LIMIT);
+    int iCenterX = (int)fm_floorf(fCenterX / SPACE_GRID_CELL);
+    int iCenterY = (int)fm_floorf(fCenterY / SPACE_GRID_CELL);
+    int iFirstRing = 0;
+    iFirstRing = (iMinX - iCenterX > iFirstRing) ? iMinX - iCenterX : iFirstRing;
+    iFirstRing = (iCenterX - iMaxX > iFirstRing) ? iCenterX - iMaxX : iFirstRing;
+    iFirstRing = (iMinY - iCenterY > iFirstRing) ? iMinY - iCenterY : iFirstRing;
+    iFirstRing = (iCenterY - iMaxY > iFirstRing) ? iCenterY - iMaxY : iFirstRing;
+    int iMaxRing = 0;
+    iMaxRing = (iCenterX - iMinX > iMaxRing) ? iCenterX - iMinX : iMaxRing;
+    iMaxRing = (iMaxX - iCenterX > iMaxRing) ? iMaxX - iCenterX : iMaxRing;
+    iMaxRing = (iCenterY - iMinY > iMaxRing) ? iCenterY - iMinY : iMaxRing;
+    iMaxRing = (iMaxY - iCenterY > iMaxRing) ? iMaxY - iCenterY : iMaxRing;
+
+    for (int iRing = iFirstRing; iRing <= iMaxRing; iRing++)
     {
-        struct vec2 vDelta = vec2_sub(obj->entity.vPos, vCenter);
-        if (vec2_mag_sq(vDelta) <= fRadiusSq)
+        int iRowMin = (iCenterY - iRing > iMinY) ? iCenterY - iRing : iMinY;
+        int iRowMax = (iCenterY + iRing < iMaxY) ? iCenterY + iRing : iMaxY;
+        int iColMin = (iCenterX - iRing > iMinX) ? iCenterX - iRing : iMinX;
+        int iColMax = (iCenterX + iRing < iMaxX) ? iCenterX + iRing : iMaxX;
+        for (int iCy = iRowMin; iCy <= iRowMax; iCy++)
         {
-            /* For radius damage, calculate direction from center to target */
-            struct vec2 vImpactToTarget = vec2_normalize(vDelta);
-            /* Use the magnitude of the impact direction vector (which contains the impact strength) */
-            float fImpactStrength = vec2_mag(vImpactDir);
-            struct vec2 vFinalImpact = vec2_scale(vImpactToTarget, fImpactStrength);
-            space_object_apply_damage(obj, iDamage, vFinalImpact);
+            /* Full rows at the top and bottom of the ring, only the two end cells in between */
+            if (iCy == iCenterY - iRing || iCy == iCenterY + iRing)
+            {
+                for (int iCx = iColMin; iCx <= iColMax; iCx++)
+                    space_query_nearest_bucket(pQuery, space_hash_cell(iCx, iCy), uK, pOutIndices, afBestDistSq, &uCount);
+                continue;
+            }
+            if (iCenterX - iRing >= iMinX)
+                space_query_nearest_bucket(pQuery, space_hash_cell(iCenterX - iRing, iCy), uK, pOutIndices, afBestDistSq, &uCount);
+            if (iCenterX + iRing <= iMaxX)
+                space_query_nearest_bucket(pQuery, space_hash_cell(iCenterX + iRing, iCy), uK, pOutIndices, afBestDistSq, &uCount);
         }
+
+        float fRingDist = (float)iRing * SPACE_GRID_CELL;
+        if (uCount == uK && afBestDistSq[uK - 1] <= fRingDist * fRingDist)
+            break;
     }
+    return uCount;
 }
 
-bool space_objects_check_bullet_collision(const struct entity2D *pBullet, int iDamage)
+const struct entity2D *space_objects_get_closest_entity_on_screen(struct vec2 vFrom, const struct camera2D *pCamera, float fActivationMargin)
 {
-    int cellX = (int)fm_floorf(pBullet->vPos.fX / SPACE_GRID_CELL);
-    int cellY = (int)fm_floorf(pBullet->vPos.fY / SPACE_GRID_CELL);
+    if (s_aliveCount == 0 || !pCamera)
+        return NULL;
 
-    /* Don't normalize velocity until we actually have a collision - this avoids expensive sqrtf() calls */
-    SPACE_GRID_LOOP(cellX - 1, cellX + 1, cellY - 1, cellY + 1, obj)
+    float fCamLeft, fCamRight, fCamTop, fCamBottom;
+    space_calc_camera_bounds(pCamera, fActivationMargin, &fCamLeft, &fCamRight, &fCamTop, &fCamBottom);
+
+    SpaceQuery query;
+    space_query_circle(&query, vFrom, SPACE_QUERY_UNLIMITED);
+    space_query_set_bounds(&query, fCamLeft, fCamRight, fCamTop, fCamBottom);
+
+    uint16_t uIndex;
+    if (space_objects_query_nearest(&query, 1, &uIndex) == 0)
+        return NULL;
+    return &s_objects[uIndex].entity;
+}
+
+const struct entity2D *space_objects_get_closest_entity_in_viewcone(struct vec2 vFrom, float fFacingAngleRad, const struct camera2D *pCamera, float fViewconeHalfAngleRad,
+                                                                    float fActivationMargin)
+{
+    if (s_aliveCount == 0 || !pCamera)
+        return NULL;
+
+    if (minimap_is_active())
+        return NULL;
+
+    float fCamLeft, fCamRight, fCamTop, fCamBottom;
+    space_calc_camera_bounds(pCamera, fActivationMargin, &fCamLeft, &fCamRight, &fCamTop, &fCamBottom);
+
+    SpaceQuery query;
+    space_query_cone(&query, vFrom, fFacingAngleRad, fViewconeHalfAngleRad, SPACE_QUERY_UNLIMITED);
+    space_query_set_bounds(&query, fCamLeft, fCamRight, fCamTop, fCamBottom);
+
+    uint16_t uIndex;
+    if (space_objects_query_nearest(&query, 1, &uIndex) == 0)
+        return NULL;
+    return &s_objects[uIndex].entity;
+}
+
+void space_objects_damage_in_radius(struct vec2 vCenter, float fRadius, int iDamage, struct vec2 vImpactDir)
+{
+    SpaceQuery query;
+    space_query_circle(&query, vCenter, fRadius);
+
+    uint16_t auHits[MAX_SPACE_OBJECTS];
+    uint16_t uHitCount = space_objects_query(&query, auHits, MAX_SPACE_OBJECTS);
+
+    /* Use the magnitude of the impact direction vector (which contains the impact strength) */
+    float fImpactStrength = vec2_mag(vImpactDir);
+    for (uint16_t i = 0; i < uHitCount; i++)
     {
-        if (entity2d_check_collision_circle(pBullet, &obj->entity))
-        {
-            /* Only normalize velocity when we actually have a collision */
-            struct vec2 vBulletDir = vec2_normalize(pBullet->vVel);
-            struct vec2 vImpactDir = vec2_scale(vBulletDir, IMPACT_STRENGTH_BULLET);
-            space_object_apply_damage(obj, iDamage, vImpactDir);
-            return true;
-        }
+        SpaceObject *obj = &s_objects[auHits[i]];
+
+        /* For radius damage, calculate direction from center to target */
+        struct vec2 vImpactToTarget = vec2_normalize(vec2_sub(obj->entity.vPos, vCenter));
+        space_object_apply_damage(obj, iDamage, vec2_scale(vImpactToTarget, fImpactStrength));
     }
-    return false;
 }
 
-bool space_objects_check_laser_collision(struct vec2 vStart, struct vec2 vEnd, struct vec2 *pOutHitPoint, SpaceObject **ppOutTarget)
+void space_ray_init(SpaceRay *pRay, struct vec2 vStart, struct vec2 vEnd)
 {
-    if (!pOutHitPoint || !ppOutTarget)
-        return false;
+    struct vec2 vLine = vec2_sub(vEnd, vStart);
+    float fLineLenSq = vec2_mag_sq(vLine);
 
-    if (s_aliveCount == 0)
-        return false;
+    pRay->vStart = vStart;
+    pRay->vEnd = vEnd;
+    if (fLineLenSq <= 1e-6f)
+    {
+        pRay->vDir = vec2_zero();
+        pRay->fLength = 0.0f;
+        return;
+    }
+    pRay->fLength = sqrtf(fLineLenSq);
+    pRay->vDir = vec2_scale(vLine, 1.0f / pRay->fLength);
+}
 
-    bool bFoundHit = false;
-    float fClosestDistSq = 0.0f;
-    struct vec2 vClosestHit = vEnd;
-    SpaceObject *pClosestTarget = NULL;
-
-    /* Calculate bounding box of line segment for spatial grid optimization */
-    float fMinX = (vStart.fX < vEnd.fX) ? vStart.fX : vEnd.fX;
-    float fMaxX = (vStart.fX > vEnd.fX) ? vStart.fX : vEnd.fX;
-    float fMinY = (vStart.fY < vEnd.fY) ? vStart.fY : vEnd.fY;
-    float fMaxY = (vStart.fY > vEnd.fY) ? vStart.fY : vEnd.fY;
-
-    /* Expand by max radius (assuming 16 for safety, meteors are 12) */
-    float fMaxRadius = 16.0f;
-    fMinX -= fMaxRadius;
-    fMaxX += fMaxRadius;
-    fMinY -= fMaxRadius;
-    fMaxY += fMaxRadius;
-
-    /* Calculate grid cells covered by the bounding box */
-    int iMinCellX, iMaxCellX, iMinCellY, iMaxCellY;
-    space_calc_grid_bounds(fMinX, fMaxX, fMinY, fMaxY, &iMinCellX, &iMaxCellX, &iMinCellY, &iMaxCellY);
-
-    /* Check all objects in the grid cells covered by the line */
-    SPACE_GRID_LOOP(iMinCellX, iMaxCellX, iMinCellY, iMaxCellY, obj)
+/* Sweep helper: test the objects of one cell against the segment, keep the nearest hit. An object is hit when
+ * the segment passes within its collision radius + fInflate. With bEntry the hit distance is the first contact
+ * along the segment (swept circle), otherwise the segment point closest to the center (laser). */
+static inline void space_sweep_test_cell(const SpaceRay *pRay, float fInflate, bool bEntry, int iCellX, int iCellY, float *pBestT, SpaceObject **ppBest)
+{
+    for (int j = s_gridHead[space_hash_cell(iCellX, iCellY)]; j != -1; j = s_hot.aiNextInCell[j])
     {
-        /* Line vs Circle intersection check (inline to avoid dependency on meteor function) */
-        struct vec2 vLine = vec2_sub(vEnd, vStart);
-        float fLineLenSq = vec2_mag_sq(vLine);
-        bool bIntersect = false;
-        struct vec2 vHit = vStart;
+        if (s_queryStamp[j] == s_queryStampCounter)
+            continue;
+        s_queryStamp[j] = s_queryStampCounter;
+        s_uSweepTests++;
+
+        SpaceObject *obj = &s_objects[j];
+        if (obj->markForDelete || !entity2d_is_active(&obj->entity))
+            continue;
 
-        if (fLineLenSq <= 1e-6f)
+        float fToX = obj->entity.vPos.fX - pRay->vStart.fX;
+        float fToY = obj->entity.vPos.fY - pRay->vStart.fY;
+        float fProj = fToX * pRay->vDir.fX + fToY * pRay->vDir.fY;
+        float fT;
+        if (bEntry)
         {
-            if (vec2_dist_sq(vStart, obj->entity.vPos) <= (float)(obj->entity.iCollisionRadius * obj->entity.iCollisionRadius))
+            float fRadius = (float)obj->entity.iCollisionRadius + fInflate;
+            float fRadiusSq = fRadius * fRadius;
+            float fDistSq = fToX * fToX + fToY * fToY;
+            if (fDistSq <= fRadiusSq)
             {
-                bIntersect = true;
-                vHit = vStart;
+                fT = 0.0f; /* Overlapping at the start */
+            }
+            else
+            {
+                float fPerpSq = fDistSq - fProj * fProj;
+                if (fProj <= 0.0f || fPerpSq > fRadiusSq)
+                    continue;
+                fT = fProj - sqrtf(fRadiusSq - fPerpSq);
+                if (fT > pRay->fLength)
+                    continue;
             }
         }
         else
         {
-            float fLineLen = sqrtf(fLineLenSq);
-            struct vec2 vLineDir = vec2_scale(vLine, 1.0f / fLineLen);
-            struct vec2 vToCenter = vec2_sub(obj->entity.vPos, vStart);
-            float fProj = vec2_dot(vToCenter, vLineDir);
-            float fClampedProj = (fProj < 0.0f) ? 0.0f : ((fProj > fLineLen) ? fLineLen : fProj);
-            struct vec2 vClosest = vec2_add(vStart, vec2_scale(vLineDir, fClampedProj));
-            if (vec2_dist_sq(vClosest, obj->entity.vPos) <= (float)(obj->entity.iCollisionRadius * obj->entity.iCollisionRadius))
-            {
-                bIntersect = true;
-                vHit = vClosest;
-            }
+            /* Closest point of the segment to the object center */
+            fT = (fProj < 0.0f) ? 0.0f : ((fProj > pRay->fLength) ? pRay->fLength : fProj);
+            float fDX = fToX - pRay->vDir.fX * fT;
+            float fDY = fToY - pRay->vDir.fY * fT;
+            if (fDX * fDX + fDY * fDY > (float)(obj->entity.iCollisionRadius * obj->entity.iCollisionRadius))
+                continue;
         }
 
-        if (bIntersect)
+        if (!*ppBest || fT < *pBestT)
         {
-            float fDistSq = vec2_dist_sq(vStart, vHit);
-            if (!bFoundHit || fDistSq < fClosestDistSq)
-            {
-                bFoundHit = true;
-                fClosestDistSq = fDistSq;
-                vClosestHit = vHit;
-                pClosestTarget = obj;
-            }
+            *pBestT = fT;
+            *ppBest = obj;
         }
     }
+}
+
+/* Walks the cells the segment crosses front to back (grid DDA). Each visited cell is tested with its 8
+ * neighbours, which covers any object whose hit radius (collision radius + fInflate) is below SPACE_GRID_CELL.
+ * A hit is found no later than the cell containing the segment point closest to the object, so the walk stops
+ * once the current cell exits past the nearest hit (plus one cell for first-contact distances, which lie up to
+ * one hit radius before that point). */
+static inline SpaceObject *space_grid_sweep(const SpaceRay *pRay, float fInflate, bool bEntry, float *pOutT)
+{
+    space_query_stamp_next();
+
+    int iCellX = (int)fm_floorf(pRay->vStart.fX / SPACE_GRID_CELL);
+    int iCellY = (int)fm_floorf(pRay->vStart.fY / SPACE_GRID_CELL);
+
+    /* Distance along the ray to the next vertical / horizontal cell border, and between borders */
+    const float fFar = 1e30f;
+    int iStepX = (pRay->vDir.fX > 0.0f) ? 1 : ((pRay->vDir.fX < 0.0f) ? -1 : 0);
+    int iStepY = (pRay->vDir.fY > 0.0f) ? 1 : ((pRay->vDir.fY < 0.0f) ? -1 : 0);
+    float fTMaxX = fFar, fTDeltaX = fFar;
+    float fTMaxY = fFar, fTDeltaY = fFar;
+    if (iStepX != 0)
+    {
+        float fBorderX = (float)(iCellX + (iStepX > 0 ? 1 : 0)) * SPACE_GRID_CELL;
+        fTMaxX = (fBorderX - pRay->vStart.fX) / pRay->vDir.fX;
+        fTDeltaX = SPACE_GRID_CELL / fabsf(pRay->vDir.fX);
+    }
+    if (iStepY != 0)
+    {
+        float fBorderY = (float)(iCellY + (iStepY > 0 ? 1 : 0)) * SPACE_GRID_CELL;
+        fTMaxY = (fBorderY - pRay->vStart.fY) / pRay->vDir.fY;
+        fTDeltaY = SPACE_GRID_CELL / fabsf(pRay->vDir.fY);
+    }
 
-    if (bFoundHit)
+    const float fStopSlack = bEntry ? SPACE_GRID_CELL : 0.0f;
+    float fBestT = 0.0f;
+    SpaceObject *pBest = NULL;
+    for (;;)
     {
-        *pOutHitPoint = vClosestHit;
-        *ppOutTarget = pClosestTarget;
-        return true;
+        for (int iCx = iCellX - 1; iCx <= iCellX + 1; iCx++)
+        {
+            for (int iCy = iCellY - 1; iCy <= iCellY + 1; iCy++)
+                space_sweep_test_cell(pRay, fInflate, bEntry, iCx, iCy, &fBestT, &pBest);
+        }
+
+        float fTExit = (fTMaxX < fTMaxY) ? fTMaxX : fTMaxY;
+        if ((pBest && fBestT + fStopSlack <= fTExit) || fTExit >= pRay->fLength)
+            break;
+
+        if (fTMaxX < fTMaxY)
+        {
+            iCellX += iStepX;
+            fTMaxX += fTDeltaX;
+        }
+        else
+        {
+            iCellY += iStepY;
+            fTMaxY += fTDeltaY;
+        }
     }
 
-    *pOutHitPoint = vEnd;
+    *pOutT = fBestT;
+    return pBest;
+}
+
+bool space_objects_raycast(const SpaceRay *pRay, struct vec2 *pOutHitPoint, SpaceObject **ppOutTarget)
+{
+    if (!pRay || !pOutHitPoint || !ppOutTarget)
+        return false;
+
+    *pOutHitPoint = pRay->vEnd;
     *ppOutTarget = NULL;
-    return false;
+    if (s_aliveCount == 0)
+        return false;
+
+    float fT;
+    SpaceObject *pHit = space_grid_sweep(pRay, 0.0f, false, &fT);
+    if (!pHit)
+        return false;
+
+    *pOutHitPoint = vec2_add(pRay->vStart, vec2_scale(pRay->vDir, fT));
+    *ppOutTarget = pHit;
+    return true;
+}
+
+uint16_t space_objects_check_bullet_sweeps(SpaceSweep *pSweeps, uint16_t uCount, int iDamage)
+{
+    if (!pSweeps)
+        return 0;
+
+    for (uint16_t i = 0; i < uCount; i++)
+        pSweeps[i].pHit = NULL;
+    if (s_aliveCount == 0)
+        return 0;
+
+    uint16_t uHits = 0;
+    for (uint16_t i = 0; i < uCount; i++)
+    {
+        SpaceSweep *pSweep = &pSweeps[i];
+        SpaceRay ray;
+        space_ray_init(&ray, pSweep->vFrom, pSweep->vTo);
+
+        /* Earlier sweeps of the batch may have destroyed objects, which the grid walk skips */
+        float fT;
+        SpaceObject *pHit = space_grid_sweep(&ray, pSweep->fRadius, true, &fT);
+        if (!pHit)
+            continue;
+
+        pSweep->pHit = pHit;
+        pSweep->fHitT = (ray.fLength > 0.0f) ? fT / ray.fLength : 0.0f;
+        space_object_apply_damage(pHit, iDamage, vec2_scale(ray.vDir, IMPACT_STRENGTH_BULLET));
+        uHits++;
+    }
+    return uHits;
+}
+
+bool space_objects_check_laser_collision(struct vec2 vStart, struct vec2 vEnd, struct vec2 *pOutHitPoint, SpaceObject **ppOutTarget)
+{
+    SpaceRay ray;
+    space_ray_init(&ray, vStart, vEnd);
+    return space_objects_raycast(&ray, pOutHitPoint, ppOutTarget);
 }
@@ -68,30 +68,69 @@ typedef struct
     bool bAssembleMode;
 } PieceData;
 
+/* Type-specific data, kept in a table parallel to the object pool so the physics and collision passes
+ * don't stride over it */
+typedef union
+{
+    MeteorData meteor;
+    NpcData npc;
+    PieceData piece;
+} SpaceObjectData;
+
+/* Position, velocity and sleep state of pooled objects are stored in the object arrays of space_objects.c;
+ * entity.vPos and entity.vVel mirror them for readers. Write them with the space_object_set_* functions. */
 typedef struct SpaceObject
 {
     struct entity2D entity;
     SpaceObjectType type;
-
-    union
-    {
-        MeteorData meteor;
-        NpcData npc;
-        PieceData piece;
-    } data;
+    SpaceObjectData *pData; /* Entry of this slot in the data table, set on spawn */
 
     int iHitPoints;
-    bool bSleeping;
     bool markForDelete;
     bool bAllocated;
 
     /* Frame events */
     bool bCollisionEventUfo;
-
-    /* Spatial hash connectivity */
-    int next_in_cell;
 } SpaceObject;
 
+/* Segment for grid raycasts (laser, line-of-sight checks); set up once per beam with space_ray_init */
+typedef struct
+{
+    struct vec2 vStart;
+    struct vec2 vEnd;
+    struct vec2 vDir; /* Unit direction, zero for a degenerate segment */
+    float fLength;
+} SpaceRay;
+
+/* Swept circle for batched continuous hit tests (bullets), one per moving object per frame */
+typedef struct
+{
+    struct vec2 vFrom; /* Position at the start of the step */
+    struct vec2 vTo;   /* Position at the end of the step */
+    float fRadius;
+    SpaceObject *pHit; /* Out: first object touched along the step, NULL if none */
+    float fHitT;       /* Out: fraction of the step at first contact (0..1) */
+} SpaceSweep;
+
+/* Spatial query over the space object grid. Set up with one of the space_query_* shapes, optionally
+ * restricted to a rect (e.g. the camera view). Results are object slots (space_objects_get_object). */
+#define SPACE_QUERY_MAX_K 16           /* Largest k for space_objects_query_nearest */
+#define SPACE_QUERY_UNLIMITED 1.0e18f /* Radius for queries bounded only by their rect */
+
+typedef struct
+{
+    struct vec2 vCenter;
+    float fMinRadius; /* Annulus inner radius, 0 for a full circle */
+    float fMaxRadius;
+
+    bool bCone; /* Only objects within the half angle around vFacing (apex at vCenter) */
+    struct vec2 vFacing;
+    float fCosHalfAngle;
+
+    bool bBounds; /* Only objects whose center lies in the rect */
+    float fLeft, fRight, fTop, fBottom;
+} SpaceQuery;
+
 /* Initialization and Cleanup */
 void space_objects_init(void);
 void space_objects_free(void);
@@ -104,20 +143,55 @@ void space_objects_render(void);
 SpaceObject *space_objects_spawn_meteor(struct vec2 pos);
 SpaceObject *space_objects_spawn_npc(int type);
 SpaceObject *space_objects_spawn_piece(int direction, uint16_t unlock_flag, struct vec2 pos);
+/* Meteors far from the camera are parked in dormant sector records and woken (advanced analytically) once the
+ * camera or their drift brings them close; parked meteors are not in the object pool, so the total can exceed
+ * it. Stores a meteor directly as dormant, e.g. when the pool is full. Returns false if the dormant storage is
+ * full. */
+bool space_objects_spawn_meteor_dormant(struct vec2 vPos, sprite_t *pSprite, float fAngleRad, float fRotationSpeed, int iCollisionRadius, int iHitPoints,
+                                        uint8_t uCurrencyId);
+void space_objects_clear_dormant(void);
 
 /* Helpers */
 int space_objects_get_active_count(void);
 SpaceObject *space_objects_get_object(int index);
 int space_objects_get_max_count(void);
+/* Allocated objects in slot order, 0 <= index < space_objects_get_active_count() (includes objects marked
+ * for delete this frame). Objects spawned since the last update, also while iterating, are appended. */
+SpaceObject *space_objects_get_active(int index);
+int space_objects_get_dormant_count(void);
+/* Pooled object owning the entity, NULL for any other entity (UFO, stack copies) */
+SpaceObject *space_objects_from_entity(const struct entity2D *pEntity);
+
+/* State setters: write the object arrays and the entity mirror (objects outside the pool: the entity only) */
+void space_object_set_position(SpaceObject *obj, struct vec2 vPos);
+void space_object_set_velocity(SpaceObject *obj, struct vec2 vVel);
+void space_object_set_sleeping(SpaceObject *obj, bool bSleeping);
+/* Sleeping objects skip integration and pair tests against other sleepers (false outside the pool) */
+bool space_object_is_sleeping(const SpaceObject *obj);
 
 /* Queries */
 const struct entity2D *space_objects_get_closest_entity_on_screen(struct vec2 vFrom, const struct camera2D *pCamera, float fActivationMargin);
 const struct entity2D *space_objects_get_closest_entity_in_viewcone(struct vec2 vFrom, float fFacingAngleRad, const struct camera2D *pCamera, float fViewconeHalfAngleRad,
                                                                     float fActivationMargin);
-bool space_objects_check_bullet_collision(const struct entity2D *pBullet, int iDamage);
+/* Resolve a batch of swept bullets against the grid in order: each one hits the first object it touches along
+ * its step, which takes iDamage. Returns the number of hits. */
+uint16_t space_objects_check_bullet_sweeps(SpaceSweep *pSweeps, uint16_t uCount, int iDamage);
 bool space_objects_check_laser_collision(struct vec2 vStart, struct vec2 vEnd, struct vec2 *pOutHitPoint, SpaceObject **ppOutTarget);
+/* First object along the ray (nearest point of the segment inside its collision circle), visiting only the
+ * grid cells the ray crosses. Returns false and the ray end if nothing is hit. */
+void space_ray_init(SpaceRay *pRay, struct vec2 vStart, struct vec2 vEnd);
+bool space_objects_raycast(const SpaceRay *pRay, struct vec2 *pOutHitPoint, SpaceObject **ppOutTarget);
 void space_objects_damage_in_radius(struct vec2 vCenter, float fRadius, int iDamage, struct vec2 vImpactDir);
 
+void space_query_circle(SpaceQuery *pQuery, struct vec2 vCenter, float fRadius);
+void space_query_annulus(SpaceQuery *pQuery, struct vec2 vCenter, float fInnerRadius, float fOuterRadius);
+void space_query_cone(SpaceQuery *pQuery, struct vec2 vApex, float fFacingAngleRad, float fHalfAngleRad, float fRange);
+void space_query_set_bounds(SpaceQuery *pQuery, float fLeft, float fRight, float fTop, float fBottom);
+/* All matches (grid order), at most uMaxResults. Returns the number written to pOutIndices. */
+uint16_t space_objects_query(const SpaceQuery *pQuery, uint16_t *pOutIndices, uint16_t uMaxResults);
+/* The uK nearest matches, closest first, searched outward ring by ring with early stop. Returns the count. */
+uint16_t space_objects_query_nearest(const SpaceQuery *pQuery, uint16_t uK, uint16_t *pOutIndices);
+
 /* Helper */
 void space_object_apply_damage(SpaceObject *obj, int iDamage, struct vec2 vImpactDir);
 void space_objects_play_explosion(struct vec2 vPos);
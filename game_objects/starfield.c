@@ -3,10 +3,14 @@
 #include "../external/squirrel_noise5.h"
 #include "../frame_time.h"
 #include "../math2d.h"
+#include "../minimap.h"
 #include "../palette.h"
+#include "../profiler.h"
 #include "../resource_helper.h"
 #include "rdpq_mode.h"
 #include "ufo.h" /* for ufo_get_speed() */
+#include <assert.h>
+#include <malloc.h> /* for memalign */
 #include <math.h>
 #include <stdio.h> /* for snprintf */
 
@@ -18,6 +22,10 @@
 #define STARFIELD_NUM_STARS 4096
 #define STARFIELD_CELL_SIZE 512
 
+/* Stars per grid cell are layer weight * this; a cell holds at most STARFIELD_MAX_STARS_PER_CELL. */
+#define STARFIELD_STARS_PER_WEIGHT 8
+#define STARFIELD_MAX_STARS_PER_CELL 64
+
 #define STARFIELD_STREAK_LENGTH_SCALE 1.0f
 
 /* Velocity threshold for streak activation (when streaks start growing).
@@ -68,13 +76,51 @@
 /* Distribution weights per layer (more small stars, fewer big ones).
  * Last entry (planet layer) is 0 so stars never spawn there.
  */
-static const int m_aLayerWeights[STARFIELD_NUM_LAYERS] = {8, 6, 4, 2, 1, 0};
+#define STARFIELD_LAYER_WEIGHT_0 8
+#define STARFIELD_LAYER_WEIGHT_1 6
+#define STARFIELD_LAYER_WEIGHT_2 4
+#define STARFIELD_LAYER_WEIGHT_3 2
+#define STARFIELD_LAYER_WEIGHT_4 1
+static const int m_aLayerWeights[STARFIELD_NUM_LAYERS] = {STARFIELD_LAYER_WEIGHT_0, STARFIELD_LAYER_WEIGHT_1, STARFIELD_LAYER_WEIGHT_2, STARFIELD_LAYER_WEIGHT_3, STARFIELD_LAYER_WEIGHT_4, 0};
 
 /* Pixel size per layer (drawn as squares via rdpq_fill_rectangle).
  * Planet layer uses sprites, so size 0 is fine here.
  */
 static const int m_aLayerSizes[STARFIELD_NUM_LAYERS] = {1, 1, 2, 2, 3, 0};
 
+/* Cached grid per star layer: the most cells the layer's view can span, i.e. the screen at the smallest layer zoom
+ * scale it shows (percent; starfield_calc_grid_bounds floors the scale there) plus the view margin on both sides.
+ * A span of S units touches at most S / cell size + 2 cells. Small layers are culled below zoom 0.5 (scale 0.656
+ * there), medium ones below zoom 0.3 (scale 0.352), the large one is clamped to 0.1. */
+#define STARFIELD_CACHE_SCREEN_W 320
+#define STARFIELD_CACHE_SCREEN_H 240
+#define STARFIELD_STAR_VIEW_MARGIN 64 /* World units around the view (covers the longest streak) */
+#define STARFIELD_LAYER_MIN_SCALE_PCT_0 65
+#define STARFIELD_LAYER_MIN_SCALE_PCT_1 65
+#define STARFIELD_LAYER_MIN_SCALE_PCT_2 35
+#define STARFIELD_LAYER_MIN_SCALE_PCT_3 35
+#define STARFIELD_LAYER_MIN_SCALE_PCT_4 10
+#define STARFIELD_CACHE_SPAN(_iScreen, _iScalePct) ((((_iScreen) * 100 + (_iScalePct) - 1) / (_iScalePct) + 2 * STARFIELD_STAR_VIEW_MARGIN) / STARFIELD_CELL_SIZE + 2)
+#define STARFIELD_LAYER_CACHE_COLS(_iLayer) STARFIELD_CACHE_SPAN(STARFIELD_CACHE_SCREEN_W, STARFIELD_LAYER_MIN_SCALE_PCT_##_iLayer)
+#define STARFIELD_LAYER_CACHE_ROWS(_iLayer) STARFIELD_CACHE_SPAN(STARFIELD_CACHE_SCREEN_H, STARFIELD_LAYER_MIN_SCALE_PCT_##_iLayer)
+#define STARFIELD_LAYER_CACHE_CELLS(_iLayer) (STARFIELD_LAYER_CACHE_COLS(_iLayer) * STARFIELD_LAYER_CACHE_ROWS(_iLayer))
+#define STARFIELD_LAYER_CACHE_SEEDS(_iLayer) (STARFIELD_LAYER_CACHE_CELLS(_iLayer) * STARFIELD_LAYER_WEIGHT_##_iLayer * STARFIELD_STARS_PER_WEIGHT)
+#define STARFIELD_CACHE_CELLS \
+    (STARFIELD_LAYER_CACHE_CELLS(0) + STARFIELD_LAYER_CACHE_CELLS(1) + STARFIELD_LAYER_CACHE_CELLS(2) + STARFIELD_LAYER_CACHE_CELLS(3) + STARFIELD_LAYER_CACHE_CELLS(4))
+#define STARFIELD_CACHE_SEEDS \
+    (STARFIELD_LAYER_CACHE_SEEDS(0) + STARFIELD_LAYER_CACHE_SEEDS(1) + STARFIELD_LAYER_CACHE_SEEDS(2) + STARFIELD_LAYER_CACHE_SEEDS(3) + STARFIELD_LAYER_CACHE_SEEDS(4))
+
+_Static_assert(STARFIELD_PLANET_LAYER_INDEX == 5, "cell cache sums cover star layers 0-4");
+_Static_assert(STARFIELD_CACHE_CELLS <= 256, "cell slots are indexed with uint8_t");
+
+static const int m_aLayerCacheCols[STARFIELD_NUM_LAYERS] = {STARFIELD_LAYER_CACHE_COLS(0), STARFIELD_LAYER_CACHE_COLS(1), STARFIELD_LAYER_CACHE_COLS(2),
+                                                            STARFIELD_LAYER_CACHE_COLS(3), STARFIELD_LAYER_CACHE_COLS(4), 0};
+static const int m_aLayerCacheRows[STARFIELD_NUM_LAYERS] = {STARFIELD_LAYER_CACHE_ROWS(0), STARFIELD_LAYER_CACHE_ROWS(1), STARFIELD_LAYER_CACHE_ROWS(2),
+                                                            STARFIELD_LAYER_CACHE_ROWS(3), STARFIELD_LAYER_CACHE_ROWS(4), 0};
+static const float m_aLayerMinZoomScale[STARFIELD_NUM_LAYERS] = {STARFIELD_LAYER_MIN_SCALE_PCT_0 / 100.0f, STARFIELD_LAYER_MIN_SCALE_PCT_1 / 100.0f,
+                                                                 STARFIELD_LAYER_MIN_SCALE_PCT_2 / 100.0f, STARFIELD_LAYER_MIN_SCALE_PCT_3 / 100.0f,
+                                                                 STARFIELD_LAYER_MIN_SCALE_PCT_4 / 100.0f, 0.1f};
+
 /* Speed factor per layer, multiplied with the global base velocity. */
 static const float m_aLayerSpeedFactors[STARFIELD_NUM_LAYERS] = {0.1f, 0.15f, 0.25f, 0.3f, 0.4f, 0.075f}; // planet layer used for nebulas etc now, super slow movement
 
@@ -141,16 +187,30 @@ static const char *m_aPlanetSpritePaths[STARFIELD_ORIGINAL_PLANET_TYPES] = {
  */
 #define STARFIELD_PLANET_ZOOM_RESPONSE 1.0f
 
+/* Scroll texture cache: while streaks are dots and the layer zoom scale is 1.0, the slowest layers can be
+ * drawn from a CI4 texture of their stars around the screen, scrolled by whole pixels. Only the screen
+ * bands (one blit strip of rows each) holding a star are blitted, so a sparse layer costs a strip per
+ * occupied band instead of a rectangle per star. A layer only uses it while its per-star draws outnumber
+ * those strips; flickering stars are drawn on top. Other frames take the per-star path.
+ * Textures are allocated the first time a layer qualifies. */
+#define STARFIELD_SCROLL_CACHE_LAYERS 2         /* layers 0..N-1 (size 1, speed 0.1 / 0.15) */
+#define STARFIELD_SCROLL_CACHE_MARGIN 32        /* texture extent past each screen edge, px (within the 64 px populate margin) */
+#define STARFIELD_SCROLL_CACHE_STRIP_BYTES 2048 /* CI4 texels per blit strip: TMEM half next to the TLUT */
+#define STARFIELD_SCROLL_CACHE_REUSE_FRAMES 2   /* frames until the RDP is done with a blit (2 display buffers) */
+#define STARFIELD_SCROLL_CACHE_MAX_BANDS 64     /* bits of starfield_layer_draw_t.uScrollBands */
+
 /* -------------------------------------------------------------------------
  * Internal data structures
  * ------------------------------------------------------------------------- */
 
-typedef struct star_s
+/* Cached grid cell of a star layer: the hashed star seeds, grouped by color choice (seeds
+ * [aColorEnd[c - 1], aColorEnd[c]) have color c). Position, color and phase all derive from the seed. */
+typedef struct starfield_cell_s
 {
-    struct vec2 vPos;      /* Layer-local "world" position. */
-    int iLayer;            /* Layer index [0..STARFIELD_NUM_LAYERS-1]. */
-    enum eCGAColor eColor; /* CGA palette index. */
-} star_t;
+    int iGridX, iGridY;
+    bool bValid;
+    uint8_t aColorEnd[STARFIELD_NUM_COLOR_CHOICES];
+} starfield_cell_t;
 
 typedef struct star_layer_bounds_s
 {
@@ -173,6 +233,46 @@ typedef struct starfield_grid_bounds_s
     struct vec2 vLayerCamPos;
 } starfield_grid_bounds_t;
 
+/* Per-layer draw constants for the star kernel (zoom scale and streak geometry applied once per layer) */
+typedef struct starfield_layer_draw_s
+{
+    bool bDrawAsDot;
+    int iSizeScaled;  /* Dot edge: ceil(size * scale) */
+    float fSizeScaled;
+    float fDiagShift;
+    struct vec2 vBack; /* Scaled streak offsets */
+    struct vec2 vFront;
+    struct vec2 vPerp;
+    int iCmdStart;
+    int iCmdCount;
+    bool bScrollCached; /* Drawn from the scroll texture; the commands are its flickering stars */
+    int iScrollS0;      /* Texel at the screen's top-left */
+    int iScrollT0;
+    uint64_t uScrollBands; /* Screen bands with a star (bit b: rows from b * m_iScrollBandRows) */
+    int iScrollSaved;      /* Per-star draws minus blit strips and flicker draws */
+} starfield_layer_draw_t;
+
+/* Scroll texture of a star layer: base colors of its stars (CGA index, 0 transparent) over a fixed layer
+ * window, written by the CPU. Valid until the screen leaves the window. */
+typedef struct starfield_scroll_cache_s
+{
+    surface_t surface; /* CI4, screen + margin on each side; buffer NULL if not allocated */
+    int iWindowX;      /* Layer position of texel (0, 0) */
+    int iWindowY;
+    uint32_t uLastBlitFrame; /* Render frame of the last blit, 0 if never */
+    bool bValid;
+    bool bAllocFailed; /* Do not retry the allocation every frame */
+} starfield_scroll_cache_t;
+
+/* Star draw command: snapped top-left of the star rect and its draw color. Dots span iSizeScaled from
+ * there, streak quads are expanded from the layer's offsets at issue. */
+typedef struct starfield_cmd_s
+{
+    int16_t iX;
+    int16_t iY;
+    uint8_t uColor; /* enum eCGAColor, flicker applied */
+} starfield_cmd_t;
+
 /* -------------------------------------------------------------------------
  * Module state
  * ------------------------------------------------------------------------- */
@@ -180,9 +280,37 @@ typedef struct starfield_grid_bounds_s
 static int m_iScreenW = 0;
 static int m_iScreenH = 0;
 
-/* Static allocation for stars to avoid heap fragmentation */
-static star_t m_aStars[STARFIELD_NUM_STARS];
+/* Static allocation for stars to avoid heap fragmentation.
+ * Visible stars as parallel arrays, each layer's stars one segment sorted by color. Positions are integer
+ * offsets from the layer's grid origin (world stars sit on whole units, so this is exact). */
+static int16_t m_aiStarX[STARFIELD_NUM_STARS];
+static int16_t m_aiStarY[STARFIELD_NUM_STARS];
+static uint8_t m_auStarColor[STARFIELD_NUM_STARS]; /* enum eCGAColor */
+static uint8_t m_auStarPhase[STARFIELD_NUM_STARS]; /* Flicker phase (from the star seed) */
 static int m_iStarCount = 0;
+static int m_aLayerStarStart[STARFIELD_NUM_LAYERS];
+static int m_aLayerStarCount[STARFIELD_NUM_LAYERS];
+static int m_aLayerOriginX[STARFIELD_NUM_LAYERS]; /* World position of the grid origin (min cell corner) */
+static int m_aLayerOriginY[STARFIELD_NUM_LAYERS];
+static struct vec2 m_aLayerCamPos[STARFIELD_NUM_LAYERS];
+
+/* Star draw commands for the frame, written by the kernel before any rdpq call */
+static starfield_cmd_t m_aStarCmds[STARFIELD_NUM_STARS];
+static starfield_layer_draw_t m_aLayerDraw[STARFIELD_NUM_LAYERS];
+
+/* Scroll texture cache of the slow layers (STARFIELD_SCROLL_CACHE_*) */
+static starfield_scroll_cache_t m_aScrollCache[STARFIELD_SCROLL_CACHE_LAYERS];
+static uint16_t m_aScrollTlut[CGA_COLOR_COUNT] __attribute__((aligned(8)));
+static int m_iScrollBandRows = 0;   /* Screen rows per blitted band */
+static int m_iScrollBandStrips = 0; /* Blit strips per band */
+static uint32_t m_uRenderFrame = 0;
+
+/* Star cell cache: per layer, cols x rows cells from m_aLayerCellBase[L] with seeds at m_aLayerSeedBase[L] + slot * stars per cell.
+ * Grid cell (gx, gy) lives in slot (gy mod rows) * cols + (gx mod cols). */
+static starfield_cell_t m_aCells[STARFIELD_CACHE_CELLS];
+static uint32_t m_aCellSeeds[STARFIELD_CACHE_SEEDS];
+static int m_aLayerCellBase[STARFIELD_NUM_LAYERS];
+static int m_aLayerSeedBase[STARFIELD_NUM_LAYERS];
 
 static int m_iLayerWeightSum = 0;
 static int m_iStarColorWeightSum = 0;
@@ -257,16 +385,66 @@ static void starfield_clear_layer_state(int _iLayer)
     m_aLayerPerpOffset[_iLayer] = vec2_zero();
 }
 
+/* Streak geometry of a star layer from the smoothed direction and length (shared by dot and streak drawing) */
+static void starfield_set_layer_geometry(int _iLayer, struct vec2 _vDir, struct vec2 _vRight, float _fLen)
+{
+    float fSize = (float)m_aLayerSizes[_iLayer];
+    float fHalfSize = 0.5f * fSize;
+    float fLen = _fLen;
+
+    /* Match render fallback exactly to avoid jitter.
+     * Check smoothed length, not target, to prevent direction changes during lerp. */
+    struct vec2 vDir = _vDir;
+    struct vec2 vRight = _vRight;
+    float fDirLenSq = vDir.fX * vDir.fX + vDir.fY * vDir.fY;
+    bool bUseCardinalFallback = (fDirLenSq < 0.001f) || (fLen < 0.5f);
+    if (bUseCardinalFallback)
+    {
+        vDir = vec2_make(1.0f, 0.0f);
+        vRight = vec2_make(0.0f, 1.0f);
+        fLen = 0.0f; /* Use smoothed length, not target */
+    }
+
+    float fDiagonalness = fabsf(vDir.fX * vDir.fY);
+    float fDiagonalShift = fDiagonalness * 1.0f;
+
+    /* Derived offsets shared with render. */
+    float fBackDist = -fHalfSize;
+    float fFrontDist = fHalfSize + fLen;
+
+    struct vec2 vBackOffset = vec2_scale(vDir, fBackDist);
+    struct vec2 vFrontOffset = vec2_scale(vDir, fFrontDist);
+    struct vec2 vPerpOffset = vec2_scale(vRight, fHalfSize);
+
+    /* Cached culling helpers (unscaled; scaled later per-layer). */
+    float fRadius = fLen + fHalfSize;
+    int iCullMargin = (int)fm_ceilf(fLen) + 2; // small bias to avoid pop at edges
+
+    m_aLayerDir[_iLayer] = vDir;
+    m_aLayerRight[_iLayer] = vRight;
+    m_aLayerLen[_iLayer] = fLen;
+    m_aLayerHalfWidth[_iLayer] = fHalfSize;
+    m_aLayerRadius[_iLayer] = (int)(fRadius + 1.0f);
+    m_aLayerCullMargin[_iLayer] = iCullMargin;
+    /* Use dot rendering when length has lerped to essentially zero (more performant) */
+    m_aLayerDrawAsDot[_iLayer] = (fLen < (fSize * STARFIELD_DOT_RENDER_THRESHOLD));
+    m_aLayerDiagShift[_iLayer] = fDiagonalShift;
+    m_aLayerBackOffset[_iLayer] = vBackOffset;
+    m_aLayerFrontOffset[_iLayer] = vFrontOffset;
+    m_aLayerPerpOffset[_iLayer] = vPerpOffset;
+}
+
 /* Optimization: Calculate grid bounds common to stars and planets */
 static void starfield_calc_grid_bounds(int _iLayer, starfield_grid_bounds_t *_pOut)
 {
     float fSpeedMul = m_aLayerSpeedFactors[_iLayer];
     _pOut->vLayerCamPos = vec2_scale(g_mainCamera.vPos, fSpeedMul);
 
-    /* Determine visible world bounds for this layer, accounting for Zoom */
+    /* Determine visible world bounds for this layer, accounting for Zoom. The floor is the smallest scale the
+     * layer shows before it is culled, which its cell cache grid is sized for. */
     float fScale = m_aLayerZoomScale[_iLayer];
-    if (fScale < 0.1f)
-        fScale = 0.1f; /* Safety clamp */
+    if (fScale < m_aLayerMinZoomScale[_iLayer])
+        fScale = m_aLayerMinZoomScale[_iLayer];
 
     float fScaledScreenW = (float)m_iScreenW / fScale;
     float fScaledScreenH = (float)m_iScreenH / fScale;
@@ -278,7 +456,7 @@ static void starfield_calc_grid_bounds(int _iLayer, starfield_grid_bounds_t *_pO
      * - Star layers: 64 units (covers max streak length)
      * This works at any zoom level because streaks/sprites scale with zoom.
      */
-    float fFixedMargin = (_iLayer == STARFIELD_PLANET_LAYER_INDEX) ? 128.0f : 64.0f;
+    float fFixedMargin = (_iLayer == STARFIELD_PLANET_LAYER_INDEX) ? 128.0f : (float)STARFIELD_STAR_VIEW_MARGIN;
 
     _pOut->fViewMinX = _pOut->vLayerCamPos.fX - fScaledScreenW * 0.5f - fFixedMargin;
     _pOut->fViewMinY = _pOut->vLayerCamPos.fY - fScaledScreenH * 0.5f - fFixedMargin;
@@ -290,6 +468,16 @@ static void starfield_calc_grid_bounds(int _iLayer, starfield_grid_bounds_t *_pO
     _pOut->iGridMinY = (int)floorf(_pOut->fViewMinY / STARFIELD_CELL_SIZE);
     _pOut->iGridMaxX = (int)floorf(_pOut->fViewMaxX / STARFIELD_CELL_SIZE);
     _pOut->iGridMaxY = (int)floorf(_pOut->fViewMaxY / STARFIELD_CELL_SIZE);
+
+    /* Star layers never span more cells than their cache grid (only reachable on a screen larger than
+     * STARFIELD_CACHE_SCREEN_W x H, where the far edge loses its last cells) */
+    if (m_aLayerCacheCols[_iLayer] > 0)
+    {
+        if (_pOut->iGridMaxX - _pOut->iGridMinX >= m_aLayerCacheCols[_iLayer])
+            _pOut->iGridMaxX = _pOut->iGridMinX + m_aLayerCacheCols[_iLayer] - 1;
+        if (_pOut->iGridMaxY - _pOut->iGridMinY >= m_aLayerCacheRows[_iLayer])
+            _pOut->iGridMaxY = _pOut->iGridMinY + m_aLayerCacheRows[_iLayer] - 1;
+    }
 }
 
 /* Helper to build color lookup table */
@@ -351,134 +539,410 @@ static void starfield_build_layer_bounds(void)
 }
 
 /* Determine the current draw color of a star, handling flickering for white/grey stars. */
-static inline enum eCGAColor starfield_get_star_color(const star_t *_pStar, int _iFlickerFrame, int _iStarIndex)
+static inline enum eCGAColor starfield_get_star_color(enum eCGAColor _eColor, int _iLayer, int _iPhase, int _iFlickerFrame)
 {
-    enum eCGAColor eColor = _pStar->eColor;
-    int iLayer = _pStar->iLayer;
-
     /* Only flicker stars in middle layers (1-3) that are White or Light Grey */
-    if (iLayer >= 1 && iLayer <= 3 && (eColor == CGA_WHITE || eColor == CGA_LIGHT_GREY))
+    if (_iLayer >= 1 && _iLayer <= 3 && (_eColor == CGA_WHITE || _eColor == CGA_LIGHT_GREY))
     {
-        int iPhase = (_iFlickerFrame + _iStarIndex * 7) & 0xAF;
+        int iPhase = (_iFlickerFrame + _iPhase * 7) & 0xAF;
         if (iPhase == 0)
         {
-            return (eColor == CGA_WHITE) ? CGA_LIGHT_GREY : CGA_DARK_GREY;
+            return (_eColor == CGA_WHITE) ? CGA_LIGHT_GREY : CGA_DARK_GREY;
         }
     }
-    return eColor;
+    return _eColor;
 }
 
-static int starfield_compare_star(const void *_pA, const void *_pB)
+/* Zoom culling: layers whose stars are too small at the current global zoom are hidden */
+static bool starfield_layer_culled(int _iLayer, float _fGlobalZoom)
 {
-    const star_t *pA = (const star_t *)_pA;
-    const star_t *pB = (const star_t *)_pB;
+    float fCullThreshold = STARFIELD_CULL_ZOOM_SMALL;
+    int iSize = m_aLayerSizes[_iLayer];
+
+    if (iSize == 2)
+        fCullThreshold = STARFIELD_CULL_ZOOM_MEDIUM;
+    else if (iSize >= 3)
+        fCullThreshold = STARFIELD_CULL_ZOOM_LARGE;
 
-    /* primary: layer (background first) */
-    if (pA->iLayer != pB->iLayer)
-        return pA->iLayer - pB->iLayer;
+    /* If threshold > 0, hide layer when zoom is BELOW threshold.
+     * When zooming back IN (zoom > threshold), they should naturally reappear
+     * because this condition will fail and we'll proceed to generate them.
+     */
+    return fCullThreshold > 0.0f && _fGlobalZoom < fCullThreshold;
+}
+
+/* -------------------------------------------------------------------------
+ * Scroll texture cache
+ * ------------------------------------------------------------------------- */
 
-    /* secondary: color */
-    if ((int)pA->eColor != (int)pB->eColor)
-        return (int)pA->eColor - (int)pB->eColor;
+static void starfield_scroll_cache_free(void)
+{
+    for (int i = 0; i < STARFIELD_SCROLL_CACHE_LAYERS; ++i)
+    {
+        if (m_aScrollCache[i].surface.buffer)
+            free(m_aScrollCache[i].surface.buffer);
+        memset(&m_aScrollCache[i], 0, sizeof(m_aScrollCache[i]));
+    }
+}
 
-    return 0;
+/* Allocate a layer texture (cached RAM, written by the CPU) the first time the layer qualifies.
+ * Failure is not fatal: a layer without a texture stays on the per-star path. */
+static bool starfield_scroll_cache_alloc(int _iLayer)
+{
+    starfield_scroll_cache_t *pCache = &m_aScrollCache[_iLayer];
+    if (pCache->surface.buffer)
+        return true;
+    if (pCache->bAllocFailed)
+        return false;
+
+    int iTexW = m_iScreenW + 2 * STARFIELD_SCROLL_CACHE_MARGIN;
+    int iTexH = m_iScreenH + 2 * STARFIELD_SCROLL_CACHE_MARGIN;
+    void *pBuffer = memalign(64, (size_t)iTexW * (size_t)iTexH / 2);
+    if (!pBuffer)
+    {
+        debugf("Starfield: no scroll texture for layer %d\n", _iLayer);
+        pCache->bAllocFailed = true;
+        return false;
+    }
+    pCache->surface = surface_make_linear(pBuffer, FMT_CI4, (uint16_t)iTexW, (uint16_t)iTexH);
+    return true;
 }
 
-static void starfield_populate_stars(void)
+/* Set up the CGA TLUT and the screen bands; layer textures are allocated on first use */
+static void starfield_scroll_cache_init(void)
 {
-    m_iStarCount = 0;
+    starfield_scroll_cache_free();
+
+    /* Index 0 has alpha 0 and is dropped by the copy-mode alpha compare; stars are never black */
+    m_aScrollTlut[CGA_BLACK] = 0;
+    for (int c = 1; c < CGA_COLOR_COUNT; ++c)
+        m_aScrollTlut[c] = color_to_packed16(palette_get_cga_color((enum eCGAColor)c));
+    data_cache_hit_writeback(m_aScrollTlut, sizeof(m_aScrollTlut));
+
+    /* A band is one strip of rows, widened if the screen would need more bands than the mask holds */
+    int iRowBytes = (m_iScreenW + 1) / 2;
+    m_iScrollBandRows = STARFIELD_SCROLL_CACHE_STRIP_BYTES / iRowBytes;
+    if (m_iScrollBandRows < 1)
+        m_iScrollBandRows = 1;
+    int iMinRows = (m_iScreenH + STARFIELD_SCROLL_CACHE_MAX_BANDS - 1) / STARFIELD_SCROLL_CACHE_MAX_BANDS;
+    if (m_iScrollBandRows < iMinRows)
+        m_iScrollBandRows = iMinRows;
+    m_iScrollBandStrips = (m_iScrollBandRows * iRowBytes + STARFIELD_SCROLL_CACHE_STRIP_BYTES - 1) / STARFIELD_SCROLL_CACHE_STRIP_BYTES;
+}
 
-    /* Rebuild stars based on camera position for each layer.
-     * Iterate layers in reverse (largest to smallest) so that if we hit the
-     * star limit, we prioritize the large stars (foreground) over background dots. */
-    for (int iLayer = STARFIELD_NUM_LAYERS - 1; iLayer >= 0; --iLayer)
+/* Rasterize the layer's stars (base colors) into its texture with texel (0, 0) at layer position
+ * (_iWindowX, _iWindowY). The star segment must cover the window. */
+static void starfield_scroll_cache_rebuild(int _iLayer, int _iWindowX, int _iWindowY)
+{
+    starfield_scroll_cache_t *pCache = &m_aScrollCache[_iLayer];
+    uint8_t *pTexels = (uint8_t *)pCache->surface.buffer;
+    int iTexW = (int)pCache->surface.width;
+    int iTexH = (int)pCache->surface.height;
+    int iStride = (int)pCache->surface.stride;
+    int iSize = m_aLayerSizes[_iLayer];
+
+    memset(pTexels, 0, (size_t)iStride * (size_t)iTexH);
+
+    int iBaseX = m_aLayerOriginX[_iLayer] - _iWindowX;
+    int iBaseY = m_aLayerOriginY[_iLayer] - _iWindowY;
+    int iEnd = m_aLayerStarStart[_iLayer] + m_aLayerStarCount[_iLayer];
+    for (int i = m_aLayerStarStart[_iLayer]; i < iEnd; ++i)
     {
-        /* Skip empty or planet layers in this pass */
-        if (m_aLayerSizes[iLayer] <= 0)
+        int iX0 = iBaseX + m_aiStarX[i];
+        int iY0 = iBaseY + m_aiStarY[i];
+        if (iX0 + iSize <= 0 || iX0 >= iTexW || iY0 + iSize <= 0 || iY0 >= iTexH)
             continue;
 
-        /* Check Global Zoom Culling */
-        float fGlobalZoom = camera_get_zoom(&g_mainCamera);
-        float fCullThreshold = STARFIELD_CULL_ZOOM_SMALL;
-        int iSize = m_aLayerSizes[iLayer];
+        uint8_t uColor = m_auStarColor[i];
+        for (int iY = iY0; iY < iY0 + iSize; ++iY)
+        {
+            if (iY < 0 || iY >= iTexH)
+                continue;
+            for (int iX = iX0; iX < iX0 + iSize; ++iX)
+            {
+                if (iX < 0 || iX >= iTexW)
+                    continue;
+                /* CI4: even texel in the high nibble */
+                uint8_t *pByte = &pTexels[iY * iStride + (iX >> 1)];
+                *pByte = (iX & 1) ? (uint8_t)((*pByte & 0xF0) | uColor) : (uint8_t)((*pByte & 0x0F) | (uColor << 4));
+            }
+        }
+    }
 
-        if (iSize == 2)
-            fCullThreshold = STARFIELD_CULL_ZOOM_MEDIUM;
-        else if (iSize >= 3)
-            fCullThreshold = STARFIELD_CULL_ZOOM_LARGE;
+    CACHE_FLUSH_DATA(pTexels, (size_t)iStride * (size_t)iTexH);
+    pCache->iWindowX = _iWindowX;
+    pCache->iWindowY = _iWindowY;
+    pCache->bValid = true;
+}
+
+/* Flickering stars of a cached layer at whole-pixel screen offset (_iOffsetX, _iOffsetY), written to
+ * _pOut as draw commands (counted only if _pOut is NULL). Returns the count. */
+static int starfield_scroll_cache_flicker_cmds(int _iLayer, int _iOffsetX, int _iOffsetY, int _iSize, int _iFlickerFrame, starfield_cmd_t *_pOut)
+{
+    if (_iLayer < 1 || _iLayer > 3)
+        return 0;
+
+    int iCount = 0;
+    int iBaseX = m_aLayerOriginX[_iLayer] + _iOffsetX;
+    int iBaseY = m_aLayerOriginY[_iLayer] + _iOffsetY;
+    int iEnd = m_aLayerStarStart[_iLayer] + m_aLayerStarCount[_iLayer];
+    for (int i = m_aLayerStarStart[_iLayer]; i < iEnd; ++i)
+    {
+        enum eCGAColor eColor = (enum eCGAColor)m_auStarColor[i];
+        enum eCGAColor eDrawColor = starfield_get_star_color(eColor, _iLayer, m_auStarPhase[i], _iFlickerFrame);
+        if (eDrawColor == eColor)
+            continue;
 
-        /* If threshold > 0, hide layer when zoom is BELOW threshold.
-         * When zooming back IN (zoom > threshold), they should naturally reappear
-         * because this condition will fail and we'll proceed to generate them.
-         */
-        if (fCullThreshold > 0.0f && fGlobalZoom < fCullThreshold)
+        int iX = iBaseX + m_aiStarX[i];
+        int iY = iBaseY + m_aiStarY[i];
+        if (iX + _iSize <= 0 || iX >= m_iScreenW || iY + _iSize <= 0 || iY >= m_iScreenH)
             continue;
 
-        /* Determine star count for this layer per cell.
-         * removed density scaling to prevent "popping" of specific stars.
-         * We rely on LOD culling and the larger star buffer (4096) to handle the load.
-         */
-        int iBaseStars = m_aLayerWeights[iLayer] * 8;
-        int iCount = iBaseStars;
+        if (_pOut)
+        {
+            _pOut[iCount].iX = (int16_t)iX;
+            _pOut[iCount].iY = (int16_t)iY;
+            _pOut[iCount].uColor = (uint8_t)eDrawColor;
+        }
+        ++iCount;
+    }
+    return iCount;
+}
+
+/* Screen bands covered by a layer's per-star commands: the texture is empty outside them */
+static uint64_t starfield_scroll_cache_bands(const starfield_layer_draw_t *_pDraw)
+{
+    uint64_t uBands = 0;
+    const starfield_cmd_t *pCmd = &m_aStarCmds[_pDraw->iCmdStart];
+    const starfield_cmd_t *pEnd = pCmd + _pDraw->iCmdCount;
+    for (; pCmd < pEnd; ++pCmd)
+    {
+        int iTop = pCmd->iY < 0 ? 0 : pCmd->iY;
+        int iBottom = pCmd->iY + _pDraw->iSizeScaled - 1;
+        if (iBottom >= m_iScreenH)
+            iBottom = m_iScreenH - 1;
+        for (int b = iTop / m_iScrollBandRows; b <= iBottom / m_iScrollBandRows; ++b)
+            uBands |= 1ull << b;
+    }
+    return uBands;
+}
+
+static int starfield_scroll_cache_band_count(uint64_t _uBands)
+{
+    return __builtin_popcountll(_uBands);
+}
+
+/* Switch a layer's draw to its scroll texture when that needs fewer RDP draws than its _pDraw->iCmdCount
+ * per-star commands: rebuilds the texture if the screen left its window, then replaces the commands
+ * with the flickering stars. Returns false (commands untouched) if the layer stays per star. */
+static bool starfield_scroll_cache_use(int _iLayer, starfield_layer_draw_t *_pDraw, int _iFlickerFrame)
+{
+    starfield_scroll_cache_t *pCache = &m_aScrollCache[_iLayer];
+    if (!_pDraw->bDrawAsDot || m_aLayerZoomScale[_iLayer] != 1.0f)
+        return false;
+
+    /* Cannot pay off even without flickering stars: skip the flicker scan */
+    uint64_t uBands = starfield_scroll_cache_bands(_pDraw);
+    int iBlitDraws = starfield_scroll_cache_band_count(uBands) * m_iScrollBandStrips;
+    if (_pDraw->iCmdCount <= iBlitDraws)
+        return false;
+
+    /* At scale 1 every star rect of the layer lands on its layer position plus the same whole-pixel offset */
+    int iOffsetX = (int)fm_floorf((float)m_iScreenW * 0.5f - m_aLayerCamPos[_iLayer].fX - m_aLayerHalfWidth[_iLayer] + 0.5f);
+    int iOffsetY = (int)fm_floorf((float)m_iScreenH * 0.5f - m_aLayerCamPos[_iLayer].fY - m_aLayerHalfWidth[_iLayer] + 0.5f);
+
+    int iFlickerCount = starfield_scroll_cache_flicker_cmds(_iLayer, iOffsetX, iOffsetY, _pDraw->iSizeScaled, _iFlickerFrame, NULL);
+    if (_pDraw->iCmdCount - iFlickerCount <= iBlitDraws)
+        return false;
+
+    if (!starfield_scroll_cache_alloc(_iLayer))
+        return false;
+
+    int iS0 = -iOffsetX - pCache->iWindowX;
+    int iT0 = -iOffsetY - pCache->iWindowY;
+    bool bInside = pCache->bValid && iS0 >= 0 && iT0 >= 0 && iS0 + m_iScreenW <= (int)pCache->surface.width && iT0 + m_iScreenH <= (int)pCache->surface.height;
+    if (!bInside)
+    {
+        /* The RDP may still be reading a recent blit: stay per star until it is done */
+        if (pCache->uLastBlitFrame != 0 && m_uRenderFrame - pCache->uLastBlitFrame < STARFIELD_SCROLL_CACHE_REUSE_FRAMES)
+            return false;
+        /* A truncated star buffer would bake the missing stars into the texture */
+        if (m_iStarCount >= STARFIELD_NUM_STARS)
+            return false;
+
+        starfield_scroll_cache_rebuild(_iLayer, -iOffsetX - STARFIELD_SCROLL_CACHE_MARGIN, -iOffsetY - STARFIELD_SCROLL_CACHE_MARGIN);
+        iS0 = STARFIELD_SCROLL_CACHE_MARGIN;
+        iT0 = STARFIELD_SCROLL_CACHE_MARGIN;
+    }
+
+    int iPerStarDraws = _pDraw->iCmdCount;
+    _pDraw->iCmdCount = starfield_scroll_cache_flicker_cmds(_iLayer, iOffsetX, iOffsetY, _pDraw->iSizeScaled, _iFlickerFrame, &m_aStarCmds[_pDraw->iCmdStart]);
+    _pDraw->bScrollCached = true;
+    _pDraw->iScrollS0 = iS0;
+    _pDraw->iScrollT0 = iT0;
+    _pDraw->uScrollBands = uBands;
+    _pDraw->iScrollSaved = iPerStarDraws - (iBlitDraws + _pDraw->iCmdCount);
+    return true;
+}
 
-        /* Calculate common bounds */
-        starfield_grid_bounds_t bounds;
-        starfield_calc_grid_bounds(iLayer, &bounds);
+/* Split the cell cache between the star layers (called during init). */
+static void starfield_build_cell_cache(void)
+{
+    int iCellBase = 0;
+    int iSeedBase = 0;
+    for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+    {
+        m_aLayerCellBase[iLayer] = iCellBase;
+        m_aLayerSeedBase[iLayer] = iSeedBase;
+        iCellBase += m_aLayerCacheCols[iLayer] * m_aLayerCacheRows[iLayer];
+        iSeedBase += m_aLayerCacheCols[iLayer] * m_aLayerCacheRows[iLayer] * m_aLayerWeights[iLayer] * STARFIELD_STARS_PER_WEIGHT;
+    }
+
+    memset(m_aCells, 0, sizeof(m_aCells));
+}
+
+/* Slot coordinate of a grid coordinate (non-negative modulo) */
+static inline int starfield_cell_slot_mod(int _iGrid, int _iCount)
+{
+    int iMod = _iGrid % _iCount;
+    return (iMod < 0) ? iMod + _iCount : iMod;
+}
+
+/* Generate the stars of one cell: hash the seeds and group them by color choice (counting sort). */
+static void starfield_generate_cell(int _iLayer, starfield_cell_t *_pCell, uint32_t *_pSeeds)
+{
+    int iCount = m_aLayerWeights[_iLayer] * STARFIELD_STARS_PER_WEIGHT;
+    uint32_t uCellSeed = sq5_get_4d_u32(_pCell->iGridX, _pCell->iGridY, _iLayer, 0, m_uSeed);
+
+    uint32_t aSeeds[STARFIELD_MAX_STARS_PER_CELL];
+    uint8_t aChoice[STARFIELD_MAX_STARS_PER_CELL];
+    int aColorStart[STARFIELD_NUM_COLOR_CHOICES] = {0};
+    for (int i = 0; i < iCount; ++i)
+    {
+        /* Use sequential index for stability within cell */
+        aSeeds[i] = sq5_get_1d_u32(i, uCellSeed);
+
+        /* Color from the bits above the 9+9 bit X/Y offsets */
+        aChoice[i] = (uint8_t)starfield_deterministic_choice(NULL, STARFIELD_NUM_COLOR_CHOICES, m_iStarColorWeightSum, aSeeds[i] >> 18);
+        aColorStart[aChoice[i]]++;
+    }
+
+    int iStart = 0;
+    for (int c = 0; c < STARFIELD_NUM_COLOR_CHOICES; ++c)
+    {
+        int iColorCount = aColorStart[c];
+        aColorStart[c] = iStart;
+        iStart += iColorCount;
+        _pCell->aColorEnd[c] = (uint8_t)iStart;
+    }
+
+    for (int i = 0; i < iCount; ++i)
+        _pSeeds[aColorStart[aChoice[i]]++] = aSeeds[i];
+}
+
+/* Bring the layer's cell cache up to the current view (evict cells that left it, generate cells that entered)
+ * and append the visible stars as the layer's segment, in color order. Returns false once the buffer is full. */
+static bool starfield_populate_layer(int _iLayer)
+{
+    starfield_grid_bounds_t bounds;
+    starfield_calc_grid_bounds(_iLayer, &bounds);
+
+    starfield_cell_t *pCells = &m_aCells[m_aLayerCellBase[_iLayer]];
+    const int iCols = m_aLayerCacheCols[_iLayer];
+    const int iRows = m_aLayerCacheRows[_iLayer];
+    int iStride = m_aLayerWeights[_iLayer] * STARFIELD_STARS_PER_WEIGHT;
+    uint32_t *pSeedBase = &m_aCellSeeds[m_aLayerSeedBase[_iLayer]];
+
+    /* Look up the visible cells by grid position. The grid spans at most cols x rows cells, so visible cells never
+     * share a slot; a slot holding another cell is regenerated in place. */
+    uint8_t aVisible[STARFIELD_CACHE_CELLS];
+    int iVisibleCount = 0;
+    for (int gy = bounds.iGridMinY; gy <= bounds.iGridMaxY; ++gy)
+    {
+        int iRowSlot = starfield_cell_slot_mod(gy, iRows) * iCols;
+        for (int gx = bounds.iGridMinX; gx <= bounds.iGridMaxX; ++gx)
+        {
+            int iSlot = iRowSlot + starfield_cell_slot_mod(gx, iCols);
+            starfield_cell_t *pCell = &pCells[iSlot];
+            if (!pCell->bValid || pCell->iGridX != gx || pCell->iGridY != gy)
+            {
+                pCell->iGridX = gx;
+                pCell->iGridY = gy;
+                pCell->bValid = true;
+                starfield_generate_cell(_iLayer, pCell, pSeedBase + iSlot * iStride);
+            }
+            aVisible[iVisibleCount++] = (uint8_t)iSlot;
+        }
+    }
 
-        for (int gy = bounds.iGridMinY; gy <= bounds.iGridMaxY; ++gy)
+    /* Color-major over the visible cells, so the segment needs no sort */
+    int iOriginX = bounds.iGridMinX * STARFIELD_CELL_SIZE;
+    int iOriginY = bounds.iGridMinY * STARFIELD_CELL_SIZE;
+    m_aLayerOriginX[_iLayer] = iOriginX;
+    m_aLayerOriginY[_iLayer] = iOriginY;
+    m_aLayerCamPos[_iLayer] = bounds.vLayerCamPos;
+    m_aLayerStarStart[_iLayer] = m_iStarCount;
+    for (int c = 0; c < STARFIELD_NUM_COLOR_CHOICES; ++c)
+    {
+        uint8_t uColor = (uint8_t)m_aStarColors[c];
+        for (int v = 0; v < iVisibleCount; ++v)
         {
-            for (int gx = bounds.iGridMinX; gx <= bounds.iGridMaxX; ++gx)
+            const starfield_cell_t *pCell = &pCells[aVisible[v]];
+            const uint32_t *pSeeds = pSeedBase + aVisible[v] * iStride;
+            int iCellX = pCell->iGridX * STARFIELD_CELL_SIZE;
+            int iCellY = pCell->iGridY * STARFIELD_CELL_SIZE;
+            float fCellX = (float)iCellX;
+            float fCellY = (float)iCellY;
+
+            for (int i = (c > 0) ? pCell->aColorEnd[c - 1] : 0; i < pCell->aColorEnd[c]; ++i)
             {
-                /* Seed for this cell + layer */
-                uint32_t uCellSeed = sq5_get_4d_u32(gx, gy, iLayer, 0, m_uSeed);
+                /* Optimized: extract X, Y from single u32 (9 bits each for 512 cell size) */
+                uint32_t uStarSeed = pSeeds[i];
+                float fWorldX = fCellX + (float)(uStarSeed & 0x1FF);
+                float fWorldY = fCellY + (float)((uStarSeed >> 9) & 0x1FF);
 
-                /* No stochastic rounding needed with fixed count */
-                if (iCount <= 0)
+                /* Check coarse bounds using the cached floats */
+                if (fWorldX < bounds.fViewMinX || fWorldX > bounds.fViewMaxX || fWorldY < bounds.fViewMinY || fWorldY > bounds.fViewMaxY)
                     continue;
 
-                for (int i = 0; i < iCount; ++i)
+                if (m_iStarCount >= STARFIELD_NUM_STARS)
                 {
-                    if (m_iStarCount >= STARFIELD_NUM_STARS)
-                        goto done_stars;
-
-                    /* Use sequential index for stability within cell */
-                    uint32_t uStarSeed = sq5_get_1d_u32(i, uCellSeed);
-
-                    /* Optimized: extract X, Y from single u32 (9 bits each for 512 cell size) */
-                    float fOffX = (float)(uStarSeed & 0x1FF);
-                    float fOffY = (float)((uStarSeed >> 9) & 0x1FF);
-
-                    float fWorldX = (float)(gx * STARFIELD_CELL_SIZE) + fOffX;
-                    float fWorldY = (float)(gy * STARFIELD_CELL_SIZE) + fOffY;
-
-                    /* Check coarse bounds using the cached floats */
-                    if (fWorldX < bounds.fViewMinX || fWorldX > bounds.fViewMaxX || fWorldY < bounds.fViewMinY || fWorldY > bounds.fViewMaxY)
-                    {
-                        continue;
-                    }
-
-                    /* Convert to Screen Space */
-                    float fScreenX = (fWorldX - bounds.vLayerCamPos.fX) + (float)m_iScreenW * 0.5f;
-                    float fScreenY = (fWorldY - bounds.vLayerCamPos.fY) + (float)m_iScreenH * 0.5f;
-
-                    /* Generate Color using remaining bits */
-                    uint32_t uColorSeed = (uStarSeed >> 18);
-                    int iColorIndex = starfield_deterministic_choice(NULL, STARFIELD_NUM_COLOR_CHOICES, m_iStarColorWeightSum, uColorSeed);
-
-                    star_t *pStar = &m_aStars[m_iStarCount++];
-                    pStar->vPos.fX = fScreenX;
-                    pStar->vPos.fY = fScreenY;
-                    pStar->iLayer = iLayer;
-                    pStar->eColor = m_aStarColors[iColorIndex];
+                    m_aLayerStarCount[_iLayer] = m_iStarCount - m_aLayerStarStart[_iLayer];
+                    return false;
                 }
+
+                /* Screen space transform happens in the render kernel */
+                int iStar = m_iStarCount++;
+                m_aiStarX[iStar] = (int16_t)(iCellX - iOriginX + (int)(uStarSeed & 0x1FF));
+                m_aiStarY[iStar] = (int16_t)(iCellY - iOriginY + (int)((uStarSeed >> 9) & 0x1FF));
+                m_auStarColor[iStar] = uColor;
+                m_auStarPhase[iStar] = (uint8_t)(uStarSeed >> 24);
             }
         }
     }
+    m_aLayerStarCount[_iLayer] = m_iStarCount - m_aLayerStarStart[_iLayer];
+    return true;
+}
+
+static void starfield_populate_stars(void)
+{
+    m_iStarCount = 0;
+    memset(m_aLayerStarCount, 0, sizeof(m_aLayerStarCount));
+
+    /* Check Global Zoom Culling */
+    float fGlobalZoom = camera_get_zoom(&g_mainCamera);
+
+    /* Iterate layers in reverse (largest to smallest) so that if we hit the
+     * star limit, we prioritize the large stars (foreground) over background dots. */
+    for (int iLayer = STARFIELD_NUM_LAYERS - 1; iLayer >= 0; --iLayer)
+    {
+        /* Skip empty or planet layers in this pass */
+        if (m_aLayerSizes[iLayer] <= 0 || starfield_layer_culled(iLayer, fGlobalZoom))
+            continue;
 
-done_stars:
-    /* Sort for batching */
-    if (m_iStarCount > 0)
-        qsort(m_aStars, (size_t)m_iStarCount, sizeof(star_t), starfield_compare_star);
+        if (!starfield_populate_layer(iLayer))
+            break;
+    }
 }
 
 static void starfield_populate_planets(void)
@@ -590,6 +1054,8 @@ void starfield_free(void)
         m_aPlanets[i].pSprite = NULL;
     }
 
+    starfield_scroll_cache_free();
+
     m_bInitialized = false;
 }
 
@@ -605,6 +1071,7 @@ void starfield_init(int _iScreenW, int _iScreenH, uint32_t _uSeed)
     m_uSeed = _uSeed;
     // m_iNoiseIndex = 0;
 
+    assert(_iScreenW <= STARFIELD_CACHE_SCREEN_W && _iScreenH <= STARFIELD_CACHE_SCREEN_H && "Star cell cache grids are sized for STARFIELD_CACHE_SCREEN_W x H");
     m_iScreenW = _iScreenW;
     m_iScreenH = _iScreenH;
     m_iStarCount = 0;
@@ -638,6 +1105,11 @@ void starfield_init(int _iScreenW, int _iScreenH, uint32_t _uSeed)
     /* Precompute color lookup for performance */
     starfield_build_color_lookup();
 
+    /* Empty star cell cache */
+    starfield_build_cell_cache();
+
+    starfield_scroll_cache_init();
+
     /* NOTE: Do NOT call srand() here, to not interfere with global RNG. */
 
     /* Initialize stars (initial population) */
@@ -788,7 +1260,6 @@ void starfield_update(void)
 
         /* Geometry derived from star size for this layer (before fallback). */
         float fSize = (float)iSize;
-        float fHalfSize = 0.5f * fSize;
         float fTargetLen = fSize * fGlobalLenFactor; /* target length */
 
         /* Smoothly lerp the length towards the target to avoid jumps.
@@ -799,46 +1270,7 @@ void starfield_update(void)
         float fLayerLerp = 1.0f - powf(1.0f - fLayerLerpFactor, fFrameMul);
         fLen += (fTargetLen - fLen) * fLayerLerp;
 
-        /* Match render fallback exactly to avoid jitter.
-         * Check smoothed length, not target, to prevent direction changes during lerp. */
-        struct vec2 vDir = vGlobalDir;
-        struct vec2 vRight = vGlobalRight;
-        float fDirLenSq = vDir.fX * vDir.fX + vDir.fY * vDir.fY;
-        bool bUseCardinalFallback = (fDirLenSq < 0.001f) || (fLen < 0.5f);
-        if (bUseCardinalFallback)
-        {
-            vDir = vec2_make(1.0f, 0.0f);
-            vRight = vec2_make(0.0f, 1.0f);
-            fLen = 0.0f; /* Use smoothed length, not target */
-        }
-
-        float fDiagonalness = fabsf(vDir.fX * vDir.fY);
-        float fDiagonalShift = fDiagonalness * 1.0f;
-
-        /* Derived offsets shared with render. */
-        float fBackDist = -fHalfSize;
-        float fFrontDist = fHalfSize + fLen;
-
-        struct vec2 vBackOffset = vec2_scale(vDir, fBackDist);
-        struct vec2 vFrontOffset = vec2_scale(vDir, fFrontDist);
-        struct vec2 vPerpOffset = vec2_scale(vRight, fHalfSize);
-
-        /* Cached culling helpers (unscaled; scaled later per-layer). */
-        float fRadius = fLen + fHalfSize;
-        int iCullMargin = (int)fm_ceilf(fLen) + 2; // small bias to avoid pop at edges
-
-        m_aLayerDir[iLayer] = vDir;
-        m_aLayerRight[iLayer] = vRight;
-        m_aLayerLen[iLayer] = fLen;
-        m_aLayerHalfWidth[iLayer] = fHalfSize;
-        m_aLayerRadius[iLayer] = (int)(fRadius + 1.0f);
-        m_aLayerCullMargin[iLayer] = iCullMargin;
-        /* Use dot rendering when length has lerped to essentially zero (more performant) */
-        m_aLayerDrawAsDot[iLayer] = (fLen < (fSize * STARFIELD_DOT_RENDER_THRESHOLD));
-        m_aLayerDiagShift[iLayer] = fDiagonalShift;
-        m_aLayerBackOffset[iLayer] = vBackOffset;
-        m_aLayerFrontOffset[iLayer] = vFrontOffset;
-        m_aLayerPerpOffset[iLayer] = vPerpOffset;
+        starfield_set_layer_geometry(iLayer, vGlobalDir, vGlobalRight, fLen);
     }
 
     /* Global flicker phase counter. */
@@ -851,8 +1283,122 @@ void starfield_update(void)
     starfield_populate_planets();
 }
 
+/* Star kernel: one layer segment at a time with the layer constants (zoom scale, rounding offset, cull
+ * range, flicker eligibility) hoisted, writing the snapped rects of on-screen stars as draw commands.
+ * Same float operations in the same order as the per-star path it replaces, so the output is identical.
+ * Returns the number of commands. */
+static int starfield_build_star_cmds(void)
+{
+    float fScreenHalfW = (float)m_iScreenW * 0.5f;
+    float fScreenHalfH = (float)m_iScreenH * 0.5f;
+    float fGlobalZoom = camera_get_zoom(&g_mainCamera);
+    int iFlickerFrame = (int)m_fFlickerFrame;
+    int iCmdCount = 0;
+
+    for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+    {
+        starfield_layer_draw_t *pDraw = &m_aLayerDraw[iLayer];
+        pDraw->iCmdStart = iCmdCount;
+        pDraw->iCmdCount = 0;
+        pDraw->bScrollCached = false;
+        pDraw->iScrollSaved = 0;
+
+        /* Cheap LOD: drop very small stars when zoomed out */
+        int iSize = m_aLayerSizes[iLayer];
+        if (iSize <= 0 || m_aLayerStarCount[iLayer] == 0)
+            continue;
+        if (fGlobalZoom < 0.5f && iSize < 2)
+            continue;
+        if (fGlobalZoom < 0.3f && iSize < 3)
+            continue;
+
+        float fScale = m_aLayerZoomScale[iLayer];
+        float fOffsetX = fScreenHalfW * (1.0f - fScale);
+        float fOffsetY = fScreenHalfH * (1.0f - fScale);
+        float fHalfSize = m_aLayerHalfWidth[iLayer] * fScale;
+        pDraw->bDrawAsDot = m_aLayerDrawAsDot[iLayer];
+        pDraw->fSizeScaled = (float)iSize * fScale;
+        pDraw->iSizeScaled = (int)fm_ceilf(pDraw->fSizeScaled);
+        pDraw->fDiagShift = m_aLayerDiagShift[iLayer] * fScale;
+        pDraw->vBack = vec2_scale(m_aLayerBackOffset[iLayer], fScale);
+        pDraw->vFront = vec2_scale(m_aLayerFrontOffset[iLayer], fScale);
+        pDraw->vPerp = vec2_scale(m_aLayerPerpOffset[iLayer], fScale);
+
+        /* Screen-space cull as a range on the snapped rect origin: drawn extent is [x - margin, x + size + margin] */
+        int iCullMargin = 0;
+        if (!pDraw->bDrawAsDot)
+        {
+            iCullMargin = (int)fm_ceilf((float)m_aLayerCullMargin[iLayer] * fScale);
+            if (iCullMargin < 1)
+                iCullMargin = 1;
+        }
+        int iMinX = -(pDraw->iSizeScaled + iCullMargin);
+        int iMaxX = m_iScreenW + iCullMargin;
+        int iMinY = -(pDraw->iSizeScaled + iCullMargin);
+        int iMaxY = m_iScreenH + iCullMargin;
+
+        /* Layer-space to screen: ((origin + offset) - camera + half screen) * scale + zoom offset */
+        int iOriginX = m_aLayerOriginX[iLayer];
+        int iOriginY = m_aLayerOriginY[iLayer];
+        float fCamX = m_aLayerCamPos[iLayer].fX;
+        float fCamY = m_aLayerCamPos[iLayer].fY;
+        bool bFlickerLayer = (iLayer >= 1 && iLayer <= 3);
+
+        int iStart = m_aLayerStarStart[iLayer];
+        int iEnd = iStart + m_aLayerStarCount[iLayer];
+        for (int i = iStart; i < iEnd; ++i)
+        {
+            float fPosX = ((float)(iOriginX + m_aiStarX[i]) - fCamX) + fScreenHalfW;
+            float fPosY = ((float)(iOriginY + m_aiStarY[i]) - fCamY) + fScreenHalfH;
+            int iRectX = (int)fm_floorf(fPosX * fScale + fOffsetX - fHalfSize + 0.5f);
+            int iRectY = (int)fm_floorf(fPosY * fScale + fOffsetY - fHalfSize + 0.5f);
+            if (iRectX < iMinX || iRectX >= iMaxX || iRectY < iMinY || iRectY >= iMaxY)
+                continue;
+
+            enum eCGAColor eColor = (enum eCGAColor)m_auStarColor[i];
+            if (bFlickerLayer)
+                eColor = starfield_get_star_color(eColor, iLayer, m_auStarPhase[i], iFlickerFrame);
+
+            starfield_cmd_t *pCmd = &m_aStarCmds[iCmdCount++];
+            pCmd->iX = (int16_t)iRectX;
+            pCmd->iY = (int16_t)iRectY;
+            pCmd->uColor = (uint8_t)eColor;
+        }
+        pDraw->iCmdCount = iCmdCount - pDraw->iCmdStart;
+
+        if (iLayer < STARFIELD_SCROLL_CACHE_LAYERS && starfield_scroll_cache_use(iLayer, pDraw, iFlickerFrame))
+            iCmdCount = pDraw->iCmdStart + pDraw->iCmdCount;
+    }
+    return iCmdCount;
+}
+
+/* Streak quad of a command (v0, v1 at the back, v2, v3 at the front) */
+static inline void starfield_streak_quad(const starfield_layer_draw_t *_pDraw, const starfield_cmd_t *_pCmd, float *_pOut)
+{
+    float fLeft = (float)_pCmd->iX;
+    float fTop = (float)_pCmd->iY;
+    float fRight = fLeft + _pDraw->fSizeScaled;
+    float fBottom = fTop + _pDraw->fSizeScaled;
+
+    float fCenterX = (fLeft + fRight) * 0.5f - _pDraw->fDiagShift;
+    float fCenterY = (fTop + fBottom) * 0.5f - _pDraw->fDiagShift;
+
+    _pOut[0] = fCenterX + _pDraw->vBack.fX - _pDraw->vPerp.fX;
+    _pOut[1] = fCenterY + _pDraw->vBack.fY - _pDraw->vPerp.fY;
+    _pOut[2] = fCenterX + _pDraw->vBack.fX + _pDraw->vPerp.fX;
+    _pOut[3] = fCenterY + _pDraw->vBack.fY + _pDraw->vPerp.fY;
+    _pOut[4] = fCenterX + _pDraw->vFront.fX - _pDraw->vPerp.fX;
+    _pOut[5] = fCenterY + _pDraw->vFront.fY - _pDraw->vPerp.fY;
+    _pOut[6] = fCenterX + _pDraw->vFront.fX + _pDraw->vPerp.fX;
+    _pOut[7] = fCenterY + _pDraw->vFront.fY + _pDraw->vPerp.fY;
+}
+
 void starfield_render(void)
 {
+    /* Star commands first, so the rdpq calls below run back to back */
+    ++m_uRenderFrame;
+    starfield_build_star_cmds();
+
     /* ---------------------------------------------------------------------
      * Planets: sprite layer, independent of camera.
      * --------------------------------------------------------------------- */
@@ -897,142 +1443,73 @@ void starfield_render(void)
     }
 
     /* ---------------------------------------------------------------------
-     * Stars
+     * Stars: issue the kernel's commands, per layer background first
      * --------------------------------------------------------------------- */
-    if (m_iStarCount > 0)
-    {
-        rdpq_set_mode_standard();
-        rdpq_mode_combiner(RDPQ_COMBINER_FLAT);
-
-        int iCurrentColor = -1;
-        float fScreenHalfW = (float)m_iScreenW * 0.5f;
-        float fScreenHalfH = (float)m_iScreenH * 0.5f;
-
-        /* Precompute layer offsets */
-        float fLayerOffsetX[STARFIELD_NUM_LAYERS];
-        float fLayerOffsetY[STARFIELD_NUM_LAYERS];
-        for (int i = 0; i < STARFIELD_NUM_LAYERS; ++i)
-        {
-            float fScale = m_aLayerZoomScale[i];
-            fLayerOffsetX[i] = fScreenHalfW * (1.0f - fScale);
-            fLayerOffsetY[i] = fScreenHalfH * (1.0f - fScale);
-        }
+    rdpq_set_mode_standard();
+    rdpq_mode_combiner(RDPQ_COMBINER_FLAT);
 
-        /* Precompute global cull threshold */
-        float fGlobalZoom = camera_get_zoom(&g_mainCamera);
-
-        /* Cache screen bounds for inlined culling */
-        int iScreenW = m_iScreenW;
-        int iScreenH = m_iScreenH;
-
-        for (int iStar = 0; iStar < m_iStarCount; ++iStar)
+    uint32_t uDrawsSaved = 0;
+    int iCurrentColor = -1;
+    for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+    {
+        const starfield_layer_draw_t *pDraw = &m_aLayerDraw[iLayer];
+        if (pDraw->bScrollCached)
         {
-            star_t *pStar = &m_aStars[iStar];
-            int iLayer = pStar->iLayer;
-
-            /* Cheap LOD: drop very small stars when zoomed out */
-            /* Inlined check: avoid repeated conditional branch setup */
-            int iSize = m_aLayerSizes[iLayer];
-            if (iSize <= 0)
-                continue;
-
-            if (fGlobalZoom < 0.5f && iSize < 2)
-                continue;
-            if (fGlobalZoom < 0.3f && iSize < 3)
-                continue;
-
-            float fScale = m_aLayerZoomScale[iLayer];
-            float fSizeScaled = (float)iSize * fScale;
-
-            /* Optimized coordinate calculation using precomputed offsets */
-            /* Original: fCenterX = ((vCenter.fX - fScreenHalfW) * fScale) + fScreenHalfW */
-            /* Optimized: fCenterX = vCenter.fX * fScale + fLayerOffsetX[iLayer] */
-            float fCenterX = pStar->vPos.fX * fScale + fLayerOffsetX[iLayer];
-            float fCenterY = pStar->vPos.fY * fScale + fLayerOffsetY[iLayer];
-
-            float fHalfSize = m_aLayerHalfWidth[iLayer] * fScale;
-            bool bDrawAsDot = m_aLayerDrawAsDot[iLayer];
-            int iCullMargin = (int)fm_ceilf((float)m_aLayerCullMargin[iLayer] * fScale);
-            if (iCullMargin < 1)
-                iCullMargin = 1;
-
-            int iRectX = (int)fm_floorf(fCenterX - fHalfSize + 0.5f);
-            int iRectY = (int)fm_floorf(fCenterY - fHalfSize + 0.5f);
-
-            /* Inlined Screen-Space Culling */
-            int iMinX, iMinY, iMaxX, iMaxY;
-            if (bDrawAsDot)
+            /* Window of the layer texture, one blit per run of occupied bands; its flickering stars follow as commands */
+            starfield_scroll_cache_t *pCache = &m_aScrollCache[iLayer];
+            rdpq_set_mode_copy(true);
+            rdpq_mode_tlut(TLUT_RGBA16);
+            rdpq_tex_upload_tlut(m_aScrollTlut, 0, CGA_COLOR_COUNT);
+            int iBandCount = (m_iScreenH + m_iScrollBandRows - 1) / m_iScrollBandRows;
+            for (int iBand = 0; iBand < iBandCount;)
             {
-                iMinX = iRectX;
-                iMinY = iRectY;
-                int iSizeScaledInt = (int)fm_ceilf(fSizeScaled);
-                iMaxX = iRectX + iSizeScaledInt;
-                iMaxY = iRectY + iSizeScaledInt;
-            }
-            else
-            {
-                iMinX = iRectX - iCullMargin;
-                iMinY = iRectY - iCullMargin;
-                int iSizeScaledInt = (int)fm_ceilf(fSizeScaled);
-                iMaxX = iRectX + iSizeScaledInt + iCullMargin;
-                iMaxY = iRectY + iSizeScaledInt + iCullMargin;
+                if (!(pDraw->uScrollBands & (1ull << iBand)))
+                {
+                    ++iBand;
+                    continue;
+                }
+                int iBandEnd = iBand + 1;
+                while (iBandEnd < iBandCount && (pDraw->uScrollBands & (1ull << iBandEnd)))
+                    ++iBandEnd;
+
+                int iY0 = iBand * m_iScrollBandRows;
+                int iY1 = iBandEnd * m_iScrollBandRows;
+                if (iY1 > m_iScreenH)
+                    iY1 = m_iScreenH;
+                rdpq_tex_blit(&pCache->surface, 0, iY0, &(rdpq_blitparms_t){.s0 = pDraw->iScrollS0, .t0 = pDraw->iScrollT0 + iY0, .width = m_iScreenW, .height = iY1 - iY0});
+                iBand = iBandEnd;
             }
+            pCache->uLastBlitFrame = m_uRenderFrame;
+            uDrawsSaved += (uint32_t)pDraw->iScrollSaved;
 
-            /* Rect Culling: skip if completely outside screen [0,0] to [W,H] */
-            if (iMaxX < 0 || iMinX >= iScreenW || iMaxY < 0 || iMinY >= iScreenH)
-                continue;
-
-            /* Color (with flicker effect) */
-            int iFlickerFrame = (int)m_fFlickerFrame;
-            enum eCGAColor eDrawColor = starfield_get_star_color(pStar, iFlickerFrame, iStar);
+            rdpq_set_mode_standard();
+            rdpq_mode_combiner(RDPQ_COMBINER_FLAT);
+            iCurrentColor = -1;
+        }
 
-            if ((int)eDrawColor != iCurrentColor)
+        const starfield_cmd_t *pCmd = &m_aStarCmds[pDraw->iCmdStart];
+        const starfield_cmd_t *pEnd = pCmd + pDraw->iCmdCount;
+        for (; pCmd < pEnd; ++pCmd)
+        {
+            if ((int)pCmd->uColor != iCurrentColor)
             {
-                iCurrentColor = (int)eDrawColor;
-                rdpq_set_prim_color(palette_get_cga_color(eDrawColor));
+                iCurrentColor = (int)pCmd->uColor;
+                rdpq_set_prim_color(palette_get_cga_color((enum eCGAColor)pCmd->uColor));
             }
 
-            /* Draw as dot (rect) or streak (triangle quad) */
-            if (bDrawAsDot)
+            if (pDraw->bDrawAsDot)
             {
-                int iSizeScaled = (int)fm_ceilf((float)iSize * fScale);
-                rdpq_fill_rectangle(iRectX, iRectY, iRectX + iSizeScaled, iRectY + iSizeScaled);
+                rdpq_fill_rectangle(pCmd->iX, pCmd->iY, pCmd->iX + pDraw->iSizeScaled, pCmd->iY + pDraw->iSizeScaled);
             }
             else
             {
-                /* Build triangle quad from snapped integer rect coordinates */
-                float fScaleLayer = fScale; // use local var for register
-                struct vec2 vBack = vec2_scale(m_aLayerBackOffset[iLayer], fScaleLayer);
-                struct vec2 vFront = vec2_scale(m_aLayerFrontOffset[iLayer], fScaleLayer);
-                struct vec2 vPerp = vec2_scale(m_aLayerPerpOffset[iLayer], fScaleLayer);
-
-                float fDiagonalShift = m_aLayerDiagShift[iLayer] * fScaleLayer;
-
-                float fLeft = (float)iRectX;
-                float fTop = (float)iRectY;
-                float fRight = fLeft + fSizeScaled;
-                float fBottom = fTop + fSizeScaled;
-
-                float fCenterX = (fLeft + fRight) * 0.5f - fDiagonalShift;
-                float fCenterY = (fTop + fBottom) * 0.5f - fDiagonalShift;
-
-                float v0x = fCenterX + vBack.fX - vPerp.fX;
-                float v0y = fCenterY + vBack.fY - vPerp.fY;
-                float v1x = fCenterX + vBack.fX + vPerp.fX;
-                float v1y = fCenterY + vBack.fY + vPerp.fY;
-                float v2x = fCenterX + vFront.fX - vPerp.fX;
-                float v2y = fCenterY + vFront.fY - vPerp.fY;
-                float v3x = fCenterX + vFront.fX + vPerp.fX;
-                float v3y = fCenterY + vFront.fY + vPerp.fY;
-
-                float t0[2] = {v0x, v0y};
-                float t1[2] = {v1x, v1y};
-                float t2[2] = {v2x, v2y};
-                float t3[2] = {v3x, v3y};
-
-                rdpq_triangle(&TRIFMT_FILL, t0, t1, t2);
-                rdpq_triangle(&TRIFMT_FILL, t2, t1, t3);
+                float aQuad[8];
+                starfield_streak_quad(pDraw, pCmd, aQuad);
+                rdpq_triangle(&TRIFMT_FILL, &aQuad[0], &aQuad[2], &aQuad[4]);
+                rdpq_triangle(&TRIFMT_FILL, &aQuad[4], &aQuad[2], &aQuad[6]);
             }
         }
     }
+
+    PROF_COUNTER_ADD(PROF_COUNTER_STAR_DRAWS_SAVED, uDrawsSaved);
 }
@@ -17,6 +17,7 @@
 #include "rdpq_sprite.h"
 #include "rdpq_tex.h"
 #include "rdpq_tri.h"
+#include "space_objects.h"
 #include "ufo.h"
 #include <math.h>
 #include <stdint.h>
@@ -55,6 +56,25 @@ static struct entity2D *tractor_beam_target_mutable(void)
     return (struct entity2D *)ufo_get_locked_target();
 }
 
+/* Targets are space objects: move them through the object arrays, other entities directly */
+static void tractor_beam_set_target_pos(struct entity2D *_pTarget, struct vec2 _vPos)
+{
+    SpaceObject *pObj = space_objects_from_entity(_pTarget);
+    if (pObj)
+        space_object_set_position(pObj, _vPos);
+    else
+        _pTarget->vPos = _vPos;
+}
+
+static void tractor_beam_set_target_vel(struct entity2D *_pTarget, struct vec2 _vVel)
+{
+    SpaceObject *pObj = space_objects_from_entity(_pTarget);
+    if (pObj)
+        space_object_set_velocity(pObj, _vVel);
+    else
+        _pTarget->vVel = _vVel;
+}
+
 static void tractor_beam_stop_audio(void)
 {
     if (mixer_ch_playing(MIXER_CHANNEL_WEAPONS))
@@ -97,7 +117,7 @@ static void tractor_beam_clamp_distance(struct entity2D *_pTarget, const struct
 
     float fClampedDist = clampf(fDist, TRACTOR_MIN_DISTANCE, TRACTOR_MAX_DISTANCE);
 
-    _pTarget->vPos = vec2_add(*_pUfoPos, vec2_scale(vDir, fClampedDist));
+    tractor_beam_set_target_pos(_pTarget, vec2_add(*_pUfoPos, vec2_scale(vDir, fClampedDist)));
 }
 
 /* Check if there's a valid target (locked or potential) within tractor beam range. */
@@ -302,7 +322,7 @@ void tractor_beam_update(bool _bBeamPressed, bool _bTurnCW, bool _bTurnCCW, bool
     /* Match target velocity to the UFO (every frame while active). */
     struct vec2 vUfoPos = ufo_get_position();
     struct vec2 vUfoVel = ufo_get_velocity();
-    pTarget->vVel = vUfoVel;
+    tractor_beam_set_target_vel(pTarget, vUfoVel);
 
     /* When first activated, clamp distance if target is too far away. */
     if (bJustActivated)
@@ -335,7 +355,7 @@ void tractor_beam_update(bool _bBeamPressed, bool _bTurnCW, bool _bTurnCCW, bool
         float s = fm_sinf(fOrbitDelta);
         float c = fm_cosf(fOrbitDelta);
         struct vec2 vRot = vec2_make(vDelta.fX * c - vDelta.fY * s, vDelta.fX * s + vDelta.fY * c);
-        pTarget->vPos = vec2_add(vUfoPos, vRot);
+        tractor_beam_set_target_pos(pTarget, vec2_add(vUfoPos, vRot));
         /* Clamp distance after rotation to ensure it stays within bounds. */
         tractor_beam_clamp_distance(pTarget, &vUfoPos);
     }
@@ -362,7 +382,7 @@ void tractor_beam_update(bool _bBeamPressed, bool _bTurnCW, bool _bTurnCCW, bool
         if (fNewDist > TRACTOR_MAX_DISTANCE)
             fNewDist = TRACTOR_MAX_DISTANCE;
 
-        pTarget->vPos = vec2_add(vUfoPos, vec2_scale(vDir, fNewDist));
+        tractor_beam_set_target_pos(pTarget, vec2_add(vUfoPos, vec2_scale(vDir, fNewDist)));
     }
 
     /* Always enforce distance limits to handle:
@@ -47,6 +47,7 @@
 #include "player_jnr.h"
 #include "player_surface.h"
 #include "profiler.h"
+#include "render_queue.h"
 #include "rng.h"
 #include "satellite_pieces.h"
 #include "save.h"
@@ -194,6 +195,8 @@ void render()
         {
             minimap_render_bg();
         }
+        /* World objects are queued, then drawn sorted by layer, mode and sprite */
+        render_queue_begin();
         planets_render();
         race_handler_render();
         item_turbo_render();
@@ -201,6 +204,7 @@ void render()
         satellite_pieces_render_satellite();
         space_objects_render();
         currency_handler_render();
+        render_queue_flush();
     }
     else if (currentState == SURFACE)
     {
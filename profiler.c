@@ -5,6 +5,7 @@
 #include "libdragon.h"
 #include <limits.h>
 #include <stddef.h>
+#include <stdio.h>
 
 #define PROFILER_TARGET_FPS 60.0f
 #define PROFILER_REPORT_FRAMES 60
@@ -23,6 +24,15 @@ struct ProfSectionStats
 
 static struct ProfSectionStats m_aProfilerSections[PROF_SECTION_MAX];
 
+struct ProfCounterStats
+{
+    uint64_t uTotal;
+    uint32_t uFrameValue;
+    uint32_t uMaxPerFrame;
+};
+
+static struct ProfCounterStats m_aProfilerCounters[PROF_COUNTER_MAX];
+
 static uint64_t m_uBootStartTicks;
 static uint64_t m_uBootTicks;
 static int m_bBootDone = 0;
@@ -43,6 +53,7 @@ static float m_fFpsSum;
 #ifdef SHOW_DETAILS
 static const char *m_aSectionNames[PROF_SECTION_MAX] = {"BOOT", "FRAME", "UPDATE", "RENDER", "AUDIO", "USER0", "USER1", "USER2"};
 #endif
+static const char *m_aCounterNames[PROF_COUNTER_MAX] = {"TILES", "TDRAW", "TDRAW0", "MHIT", "MMISS", "MEVICT", "GRELNK", "GBUCKT", "GCHAIN", "SDORM", "SXFER", "SSAVED", "RQITEM", "RQMODE", "RQLOAD"};
 
 static void profiler_reset_sections(void)
 {
@@ -58,6 +69,13 @@ static void profiler_reset_sections(void)
         pProfSection->bActive = 0;
     }
 
+    for (int iIndex = 0; iIndex < PROF_COUNTER_MAX; ++iIndex)
+    {
+        m_aProfilerCounters[iIndex].uTotal = 0;
+        m_aProfilerCounters[iIndex].uFrameValue = 0;
+        m_aProfilerCounters[iIndex].uMaxPerFrame = 0;
+    }
+
     m_uFrameTotalTicks = 0;
     m_uFrameMinTicks = UINT64_MAX;
     m_uFrameMaxTicks = 0;
@@ -153,6 +171,14 @@ void profiler_section_end(enum eProfilerSection _eSection)
     profiler_accumulate_section(_eSection, uDelta);
 }
 
+void profiler_counter_add(enum eProfilerCounter _eCounter, uint32_t _uValue)
+{
+    if (_eCounter < 0 || _eCounter >= PROF_COUNTER_MAX)
+        return;
+
+    m_aProfilerCounters[_eCounter].uFrameValue += _uValue;
+}
+
 static void profiler_print_report(void)
 {
     if (m_iFramesInBatch <= 0)
@@ -261,6 +287,24 @@ static void profiler_print_report(void)
            fAudioPct,
            fSystemPct);
 
+    /* Counters on one line: per-frame avg (max), only if used.
+     * Example:
+     * [PROFILE] GRELNK 3(12)  GBUCKT 180(184)  GCHAIN 3(4)  SDORM 412(412)  RQITEM 96(130)  RQMODE 9(14)  RQLOAD 21(30)
+     */
+    char szCounters[384];
+    int iCountersLen = 0;
+    for (int iIndex = 0; iIndex < PROF_COUNTER_MAX && iCountersLen < (int)sizeof(szCounters); ++iIndex)
+    {
+        struct ProfCounterStats *pCounter = &m_aProfilerCounters[iIndex];
+        if (pCounter->uTotal == 0)
+            continue;
+
+        unsigned long uAvg = (unsigned long)(pCounter->uTotal / (uint64_t)m_iFramesInBatch);
+        iCountersLen += snprintf(szCounters + iCountersLen, sizeof(szCounters) - (size_t)iCountersLen, "%s%s %lu(%lu)", iCountersLen ? "  " : "", m_aCounterNames[iIndex], uAvg, (unsigned long)pCounter->uMaxPerFrame);
+    }
+    if (iCountersLen > 0)
+        debugf("[PROFILE] %s\n", szCounters);
+
 #ifdef SHOW_DETAILS
     /* Frame summary. */
     debugf("[PROFILE] FRAMES:\t%07.3f\t(%07.3f\t|\t%07.3f)\n", fFrameAvgMs, fFrameMinMs, fFrameMaxMs);
@@ -341,6 +385,16 @@ void profiler_frame_end(float _fFps)
     if (uSystemDelta > m_uFrameMaxSystemTicks)
         m_uFrameMaxSystemTicks = uSystemDelta;
 
+    /* Close this frame's counters. */
+    for (int iIndex = 0; iIndex < PROF_COUNTER_MAX; ++iIndex)
+    {
+        struct ProfCounterStats *pCounter = &m_aProfilerCounters[iIndex];
+        pCounter->uTotal += pCounter->uFrameValue;
+        if (pCounter->uFrameValue > pCounter->uMaxPerFrame)
+            pCounter->uMaxPerFrame = pCounter->uFrameValue;
+        pCounter->uFrameValue = 0;
+    }
+
     m_fFpsSum += _fFps;
     m_iFramesInBatch++;
 
@@ -16,6 +16,27 @@ enum eProfilerSection
     PROF_SECTION_MAX
 };
 
+/* Per-frame work counters (summed over a frame, reported as avg / max per frame). */
+enum eProfilerCounter
+{
+    PROF_COUNTER_TILES_TOUCHED = 0,   /* Tile cells sampled or dropped by tilemap_update */
+    PROF_COUNTER_TILE_DRAWS,          /* Tilemap RDP draws issued (tile rects, chunk fills and blits) */
+    PROF_COUNTER_TILE_DRAWS_UNCACHED, /* Tile rects the per-tile renderer would issue for the same frame */
+    PROF_COUNTER_MAP_HITS,            /* Tilemap loads served by the residency cache */
+    PROF_COUNTER_MAP_MISSES,          /* Tilemap loads read from ROM */
+    PROF_COUNTER_MAP_EVICTS,          /* Resident tilemaps released (LRU or flush) */
+    PROF_COUNTER_GRID_RELINKS,        /* Space objects (re)linked into the spatial hash */
+    PROF_COUNTER_GRID_BUCKETS,        /* Occupied spatial hash buckets */
+    PROF_COUNTER_GRID_CHAIN,          /* Longest spatial hash bucket chain */
+    PROF_COUNTER_SPACE_DORMANT,       /* Meteors parked in dormant sectors */
+    PROF_COUNTER_SPACE_TRANSFERS,     /* Meteors parked or woken this frame */
+    PROF_COUNTER_STAR_DRAWS_SAVED,    /* Star RDP draws replaced by scroll texture blits (net of blit strips) */
+    PROF_COUNTER_RQ_ITEMS,            /* Draw items issued by the render queue */
+    PROF_COUNTER_RQ_MODES,            /* Render queue mode switches (incl. custom items setting their own) */
+    PROF_COUNTER_RQ_LOADS,            /* Render queue texture loads (sprite uploads and blits) */
+    PROF_COUNTER_MAX
+};
+
 #ifdef PROFILER_ENABLED
 
 void profiler_init(void);
@@ -24,6 +45,7 @@ void profiler_frame_begin(void);
 void profiler_frame_end(float _fFps);
 void profiler_section_begin(enum eProfilerSection _eSection);
 void profiler_section_end(enum eProfilerSection _eSection);
+void profiler_counter_add(enum eProfilerCounter _eCounter, uint32_t _uValue);
 
 /* Convenience macros so game code never needs #ifdef PROFILER_ENABLED. */
 #define PROF_INIT() profiler_init()
@@ -32,6 +54,7 @@ void profiler_section_end(enum eProfilerSection _eSection);
 #define PROF_FRAME_END(_fFps) profiler_frame_end(_fFps)
 #define PROF_SECTION_BEGIN(_sec) profiler_section_begin(_sec)
 #define PROF_SECTION_END(_sec) profiler_section_end(_sec)
+#define PROF_COUNTER_ADD(_ctr, _val) profiler_counter_add(_ctr, _val)
 
 #else /* !PROFILER_ENABLED */
 
@@ -42,5 +65,6 @@ void profiler_section_end(enum eProfilerSection _eSection);
 #define PROF_FRAME_END(_fFps) ((void)0)
 #define PROF_SECTION_BEGIN(_sec) ((void)0)
 #define PROF_SECTION_END(_sec) ((void)0)
+#define PROF_COUNTER_ADD(_ctr, _val) ((void)0)
 
 #endif /* PROFILER_ENABLED */
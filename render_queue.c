@@ -0,0 +1,379 @@
+#include "render_queue.h"
+#include "camera.h"
+#include "entity2d.h"
+#include "libdragon.h"
+#include "profiler.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Sort key: layer (3 bits) | phase (5 bits) | mode (3 bits) | sprite group (8 bits), sorted in stable 7-bit radix
+ * passes. The phase is the number of custom items submitted before the item in its layer, so sprites never move
+ * across a custom item; past the last phase, sprites draw before the remaining custom items of the layer. */
+#define RENDER_QUEUE_KEY_SPRITE_BITS 8
+#define RENDER_QUEUE_KEY_MODE_BITS 3
+#define RENDER_QUEUE_KEY_PHASE_BITS 5
+#define RENDER_QUEUE_KEY_LAYER_BITS 3
+#define RENDER_QUEUE_KEY_BITS (RENDER_QUEUE_KEY_LAYER_BITS + RENDER_QUEUE_KEY_PHASE_BITS + RENDER_QUEUE_KEY_MODE_BITS + RENDER_QUEUE_KEY_SPRITE_BITS)
+#define RENDER_QUEUE_MAX_PHASE ((1 << RENDER_QUEUE_KEY_PHASE_BITS) - 1)
+#define RENDER_QUEUE_RADIX_BITS 7
+#define RENDER_QUEUE_RADIX_SIZE (1 << RENDER_QUEUE_RADIX_BITS)
+
+_Static_assert(RENDER_LAYER_COUNT <= (1 << RENDER_QUEUE_KEY_LAYER_BITS), "render layer must fit in 3 key bits");
+_Static_assert(RENDER_MODE_COUNT <= (1 << RENDER_QUEUE_KEY_MODE_BITS), "render mode must fit in 3 key bits");
+_Static_assert(RENDER_QUEUE_MAX_SPRITES < (1 << RENDER_QUEUE_KEY_SPRITE_BITS), "sprite group must fit in 8 key bits");
+_Static_assert(RENDER_QUEUE_MAX_ITEMS <= UINT16_MAX, "item indices are 16-bit");
+
+typedef struct
+{
+    sprite_t *pSprite;              /* NULL for custom items */
+    render_queue_draw_fn_t fnDraw;  /* Custom items only */
+    void *pContext;                 /* Custom items only */
+    float fScale;
+    float fTheta;
+    int16_t iX, iY;
+    int16_t iCx, iCy;
+    color_t color;
+    uint8_t uLayer;
+    uint8_t uMode;
+} render_queue_item_t;
+
+/* RDP state as left by the previous draw; invalid after custom items. The counts cover every draw since the last
+ * flush: sorted, immediate and overflow ones. */
+typedef struct
+{
+    render_mode_t eMode;   /* RENDER_MODE_COUNT: unknown */
+    sprite_t *pUploaded;   /* Sprite whose texture is loaded in TILE0, NULL if unknown */
+    bool bPrimValid;
+    uint32_t uPrim;
+    uint32_t uItemsDrawn;
+    uint32_t uModeSwitches;
+    uint32_t uTextureLoads;
+} render_queue_state_t;
+
+static render_queue_item_t m_aItems[RENDER_QUEUE_MAX_ITEMS];
+static uint32_t m_auKey[RENDER_QUEUE_MAX_ITEMS];
+static uint16_t m_auOrder[RENDER_QUEUE_MAX_ITEMS];
+static uint16_t m_auOrderTmp[RENDER_QUEUE_MAX_ITEMS];
+static uint16_t m_uItemCount = 0;
+static uint8_t m_auLayerPhase[RENDER_LAYER_COUNT]; /* Custom items submitted so far per layer (capped) */
+
+/* Sprite groups are numbered in first-submitted order, so equal frames sort equally */
+static sprite_t *m_apSprites[RENDER_QUEUE_MAX_SPRITES];
+static uint16_t m_uSpriteCount = 0;
+static sprite_t *m_pLastSprite = NULL;
+static uint16_t m_uLastSpriteGroup = 0;
+
+static render_queue_state_t m_state;
+static bool m_bOverflowReported = false;
+static bool m_bImmediate = false; /* render_queue_set_immediate */
+
+static void render_queue_state_invalidate(void)
+{
+    m_state.eMode = RENDER_MODE_COUNT;
+    m_state.pUploaded = NULL;
+    m_state.bPrimValid = false;
+}
+
+static uint16_t render_queue_sprite_group(sprite_t *_pSprite)
+{
+    if (_pSprite == m_pLastSprite)
+        return m_uLastSpriteGroup;
+
+    uint16_t uGroup = RENDER_QUEUE_MAX_SPRITES; /* Shared group once the table is full */
+    for (uint16_t i = 0; i < m_uSpriteCount; ++i)
+    {
+        if (m_apSprites[i] == _pSprite)
+        {
+            uGroup = i;
+            break;
+        }
+    }
+
+    if (uGroup == RENDER_QUEUE_MAX_SPRITES && m_uSpriteCount < RENDER_QUEUE_MAX_SPRITES)
+    {
+        uGroup = m_uSpriteCount;
+        m_apSprites[m_uSpriteCount++] = _pSprite;
+    }
+
+    m_pLastSprite = _pSprite;
+    m_uLastSpriteGroup = uGroup;
+    return uGroup;
+}
+
+/* Whole sprite fits a single TMEM load (rows padded to 8 bytes, palette in the upper half for CI) */
+static bool render_queue_fits_tmem(sprite_t *_pSprite)
+{
+    tex_format_t eFormat = sprite_get_format(_pSprite);
+    int iStride = (TEX_FORMAT_PIX2BYTES(eFormat, _pSprite->width) + 7) & ~7;
+    int iBytes = iStride * _pSprite->height;
+
+    if (eFormat == FMT_CI4 || eFormat == FMT_CI8)
+        return iBytes <= 2048;
+    return iBytes <= 4096;
+}
+
+static void render_queue_apply_mode(render_mode_t _eMode)
+{
+    rdpq_set_mode_standard();
+
+    switch (_eMode)
+    {
+    case RENDER_MODE_SPRITE:
+        rdpq_mode_alphacompare(1); /* draw pixels with alpha >= 1 (colorkey style) */
+        rdpq_mode_filter(FILTER_POINT);
+        break;
+    case RENDER_MODE_SPRITE_SMOOTH:
+        rdpq_mode_alphacompare(1);
+        rdpq_mode_filter(FILTER_BILINEAR);
+        break;
+    case RENDER_MODE_TINTED:
+        rdpq_mode_combiner(RDPQ_COMBINER_TEX_FLAT);
+        rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
+        rdpq_mode_filter(FILTER_BILINEAR);
+        break;
+    case RENDER_MODE_TRANSLUCENT:
+        rdpq_mode_alphacompare(1);
+        rdpq_mode_filter(FILTER_POINT);
+        rdpq_mode_combiner(RDPQ_COMBINER_TEX);
+        rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
+        break;
+    default:
+        break;
+    }
+
+    m_state.eMode = _eMode;
+    m_state.pUploaded = NULL; /* Mode change resets the TLUT mode the last upload configured */
+    m_state.uModeSwitches++;
+}
+
+static void render_queue_draw_item(const render_queue_item_t *_pItem)
+{
+    render_mode_t eMode = (render_mode_t)_pItem->uMode;
+    m_state.uItemsDrawn++;
+
+    if (eMode == RENDER_MODE_CUSTOM)
+    {
+        _pItem->fnDraw(_pItem->pContext, _pItem->iX, _pItem->iY, _pItem->fScale);
+        render_queue_state_invalidate();
+        m_state.uModeSwitches++;
+        return;
+    }
+
+    if (eMode != m_state.eMode)
+        render_queue_apply_mode(eMode);
+
+    if (eMode == RENDER_MODE_TINTED || eMode == RENDER_MODE_TRANSLUCENT)
+    {
+        uint32_t uPrim = color_to_packed32(_pItem->color);
+        if (!m_state.bPrimValid || m_state.uPrim != uPrim)
+        {
+            rdpq_set_prim_color(_pItem->color);
+            m_state.uPrim = uPrim;
+            m_state.bPrimValid = true;
+        }
+    }
+
+    sprite_t *pSprite = _pItem->pSprite;
+
+#if RENDER_QUEUE_REUSE_UPLOADS
+    /* Unrotated sprite that fits TMEM: load once per run, then draw plain texture rectangles */
+    if (_pItem->fTheta == 0.0f && (pSprite == m_state.pUploaded || render_queue_fits_tmem(pSprite)))
+    {
+        if (pSprite != m_state.pUploaded)
+        {
+            rdpq_sprite_upload(TILE0, pSprite, NULL);
+            m_state.pUploaded = pSprite;
+            m_state.uTextureLoads++;
+        }
+
+        float fX0 = (float)_pItem->iX - (float)_pItem->iCx * _pItem->fScale;
+        float fY0 = (float)_pItem->iY - (float)_pItem->iCy * _pItem->fScale;
+        float fW = (float)pSprite->width;
+        float fH = (float)pSprite->height;
+        rdpq_texture_rectangle_scaled(TILE0, fX0, fY0, fX0 + fW * _pItem->fScale, fY0 + fH * _pItem->fScale, 0.0f, 0.0f, fW, fH);
+        return;
+    }
+#endif
+
+    rdpq_blitparms_t parms = {.cx = _pItem->iCx, .cy = _pItem->iCy, .scale_x = _pItem->fScale, .scale_y = _pItem->fScale, .theta = _pItem->fTheta};
+    rdpq_sprite_blit(pSprite, _pItem->iX, _pItem->iY, &parms);
+    m_state.pUploaded = NULL; /* Blit loads its own texture (possibly in slices) */
+    m_state.uTextureLoads++;
+}
+
+static render_queue_item_t *render_queue_alloc(render_layer_t _eLayer, render_mode_t _eMode, sprite_t *_pSprite)
+{
+    if (m_uItemCount >= RENDER_QUEUE_MAX_ITEMS)
+    {
+        if (!m_bOverflowReported)
+        {
+            debugf("[RenderQueue] Queue full (%d items), drawing immediately\n", RENDER_QUEUE_MAX_ITEMS);
+            m_bOverflowReported = true;
+        }
+        return NULL;
+    }
+
+    uint16_t uGroup = _pSprite ? render_queue_sprite_group(_pSprite) : 0;
+    uint32_t uPhase = m_auLayerPhase[_eLayer];
+    m_auKey[m_uItemCount] = ((uint32_t)_eLayer << (RENDER_QUEUE_KEY_PHASE_BITS + RENDER_QUEUE_KEY_MODE_BITS + RENDER_QUEUE_KEY_SPRITE_BITS)) |
+                            (uPhase << (RENDER_QUEUE_KEY_MODE_BITS + RENDER_QUEUE_KEY_SPRITE_BITS)) | ((uint32_t)_eMode << RENDER_QUEUE_KEY_SPRITE_BITS) | uGroup;
+
+    /* Custom items sort last within their phase; later items of the layer start the next one */
+    if (_eMode == RENDER_MODE_CUSTOM && uPhase < RENDER_QUEUE_MAX_PHASE)
+        m_auLayerPhase[_eLayer] = (uint8_t)(uPhase + 1);
+
+    render_queue_item_t *pItem = &m_aItems[m_uItemCount++];
+    memset(pItem, 0, sizeof(*pItem));
+    pItem->uLayer = (uint8_t)_eLayer;
+    pItem->uMode = (uint8_t)_eMode;
+    pItem->pSprite = _pSprite;
+    return pItem;
+}
+
+void render_queue_begin(void)
+{
+    m_uItemCount = 0;
+    memset(m_auLayerPhase, 0, sizeof(m_auLayerPhase));
+    m_uSpriteCount = 0;
+    m_pLastSprite = NULL;
+    m_bOverflowReported = false;
+    m_bImmediate = false;
+}
+
+void render_queue_set_immediate(bool _bImmediate)
+{
+    /* Nothing is assumed about the RDP state across the start or end of an immediate run */
+    render_queue_state_invalidate();
+    m_bImmediate = _bImmediate;
+}
+
+void render_queue_sprite(render_layer_t _eLayer, render_mode_t _eMode, sprite_t *_pSprite, int _iX, int _iY, const rdpq_blitparms_t *_pParms, color_t _color)
+{
+    if (!_pSprite || _eLayer >= RENDER_LAYER_COUNT || _eMode >= RENDER_MODE_CUSTOM)
+        return;
+
+    /* Immediate run or overflow: draw now, outside the sorted order */
+    render_queue_item_t item = {.uLayer = (uint8_t)_eLayer, .uMode = (uint8_t)_eMode, .pSprite = _pSprite};
+    render_queue_item_t *pItem = m_bImmediate ? NULL : render_queue_alloc(_eLayer, _eMode, _pSprite);
+    if (!pItem)
+        pItem = &item;
+
+    pItem->iX = (int16_t)_iX;
+    pItem->iY = (int16_t)_iY;
+    pItem->iCx = _pParms ? (int16_t)_pParms->cx : 0;
+    pItem->iCy = _pParms ? (int16_t)_pParms->cy : 0;
+    pItem->fScale = (_pParms && _pParms->scale_x != 0.0f) ? _pParms->scale_x : 1.0f;
+    pItem->fTheta = _pParms ? _pParms->theta : 0.0f;
+    pItem->color = _color;
+
+    if (pItem == &item && m_bImmediate)
+    {
+        render_queue_draw_item(pItem); /* State stays tracked until the run ends */
+    }
+    else if (pItem == &item)
+    {
+        render_queue_state_invalidate();
+        render_queue_draw_item(pItem);
+        render_queue_state_invalidate();
+    }
+}
+
+bool render_queue_entity(render_layer_t _eLayer, const struct entity2D *_pEnt, bool _bRotate)
+{
+    struct vec2i vScreen;
+    if (!entity2d_will_render(_pEnt, &vScreen))
+        return false;
+
+    /* Same filter rule as entity2d_render_impl_with_screen */
+    float fZoom = camera_get_zoom(&g_mainCamera);
+    render_mode_t eMode = (_bRotate || fZoom != 1.0f) ? RENDER_MODE_SPRITE_SMOOTH : RENDER_MODE_SPRITE;
+
+    rdpq_blitparms_t parms = {.cx = _pEnt->vHalf.iX, .cy = _pEnt->vHalf.iY, .scale_x = fZoom, .scale_y = fZoom, .theta = _bRotate ? _pEnt->fAngleRad : 0.0f};
+    render_queue_sprite(_eLayer, eMode, _pEnt->pSprite, vScreen.iX, vScreen.iY, &parms, RGBA32(255, 255, 255, 255));
+    return true;
+}
+
+void render_queue_custom(render_layer_t _eLayer, render_queue_draw_fn_t _fnDraw, void *_pContext, int _iX, int _iY, float _fScale)
+{
+    if (!_fnDraw || _eLayer >= RENDER_LAYER_COUNT)
+        return;
+
+    /* Immediate run or overflow: draw now */
+    render_queue_item_t item = {.uLayer = (uint8_t)_eLayer, .uMode = (uint8_t)RENDER_MODE_CUSTOM};
+    render_queue_item_t *pItem = m_bImmediate ? NULL : render_queue_alloc(_eLayer, RENDER_MODE_CUSTOM, NULL);
+    if (!pItem)
+        pItem = &item;
+
+    pItem->fnDraw = _fnDraw;
+    pItem->pContext = _pContext;
+    pItem->iX = (int16_t)_iX;
+    pItem->iY = (int16_t)_iY;
+    pItem->fScale = _fScale;
+    pItem->fTheta = 0.0f;
+
+    if (pItem == &item)
+        render_queue_draw_item(pItem);
+}
+
+/* Stable LSD radix sort of item indices by key; returns the sorted index array */
+static const uint16_t *render_queue_sort(void)
+{
+    uint16_t *pSrc = m_auOrderTmp;
+    uint16_t *pDst = m_auOrder;
+    for (uint16_t i = 0; i < m_uItemCount; ++i)
+        pSrc[i] = i;
+
+    for (int iShift = 0; iShift < RENDER_QUEUE_KEY_BITS; iShift += RENDER_QUEUE_RADIX_BITS)
+    {
+        uint16_t auCount[RENDER_QUEUE_RADIX_SIZE];
+        memset(auCount, 0, sizeof(auCount));
+
+        for (uint16_t i = 0; i < m_uItemCount; ++i)
+            auCount[(m_auKey[i] >> iShift) & (RENDER_QUEUE_RADIX_SIZE - 1)]++;
+
+        uint16_t uSum = 0;
+        for (int iDigit = 0; iDigit < RENDER_QUEUE_RADIX_SIZE; ++iDigit)
+        {
+            uint16_t uCount = auCount[iDigit];
+            auCount[iDigit] = uSum;
+            uSum += uCount;
+        }
+
+        for (uint16_t i = 0; i < m_uItemCount; ++i)
+        {
+            uint16_t uIndex = pSrc[i];
+            pDst[auCount[(m_auKey[uIndex] >> iShift) & (RENDER_QUEUE_RADIX_SIZE - 1)]++] = uIndex;
+        }
+
+        uint16_t *pSwap = pSrc;
+        pSrc = pDst;
+        pDst = pSwap;
+    }
+
+    return pSrc;
+}
+
+void render_queue_flush(void)
+{
+    render_queue_state_invalidate();
+
+    if (m_uItemCount > 0)
+    {
+        const uint16_t *pOrder = render_queue_sort();
+        for (uint16_t i = 0; i < m_uItemCount; ++i)
+            render_queue_draw_item(&m_aItems[pOrder[i]]);
+    }
+
+    /* Includes the immediate and overflow draws made since the last flush */
+    PROF_COUNTER_ADD(PROF_COUNTER_RQ_ITEMS, m_state.uItemsDrawn);
+    PROF_COUNTER_ADD(PROF_COUNTER_RQ_MODES, m_state.uModeSwitches);
+    PROF_COUNTER_ADD(PROF_COUNTER_RQ_LOADS, m_state.uTextureLoads);
+    m_state.uItemsDrawn = 0;
+    m_state.uModeSwitches = 0;
+    m_state.uTextureLoads = 0;
+
+    /* Later renderers set their own mode; leave no state assumptions behind */
+    render_queue_state_invalidate();
+    render_queue_begin();
+}
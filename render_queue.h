@@ -0,0 +1,68 @@
+#pragma once
+
+#include "libdragon.h"
+#include "sprite.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Per-frame render queue for the SPACE world pass.
+ * Renderers submit draw items instead of setting RDP state and blitting themselves; render_queue_flush
+ * issues them layer by layer (back to front), sorted by mode and sprite within each layer, so render
+ * modes are set once per run and sprites that fit TMEM are uploaded once per run. Custom items keep their
+ * submission order relative to the sprites of their layer; sprites only batch between them. */
+
+struct entity2D;
+
+#define RENDER_QUEUE_MAX_ITEMS 512    /* Items per frame (on-screen SPACE draws, thinned live meteors on the minimap); overflow draws immediately */
+#define RENDER_QUEUE_MAX_SPRITES 255  /* Distinct sprites sorted apart per frame; the rest share one group */
+#define RENDER_QUEUE_REUSE_UPLOADS 1  /* Draw unrotated runs of one sprite from a single TMEM upload */
+
+/* Layers are flushed in this order; it matches the order the SPACE renderers used to draw in */
+typedef enum
+{
+    RENDER_LAYER_DECO = 0,      /* Planet decoration */
+    RENDER_LAYER_PLANETS,       /* Planets */
+    RENDER_LAYER_PLANET_LABELS, /* Planet names (minimap) */
+    RENDER_LAYER_RACE_TRACK,    /* Race track */
+    RENDER_LAYER_PICKUPS,       /* Race coin, turbo items, bounce obstacles */
+    RENDER_LAYER_SATELLITE,     /* Satellite repair slots */
+    RENDER_LAYER_OBJECTS,       /* Meteors, NPCs, satellite pieces */
+    RENDER_LAYER_CURRENCY,      /* Currency pickups */
+    RENDER_LAYER_COUNT
+} render_layer_t;
+
+/* Mode keys: each one is a complete RDP mode setup, applied when the key changes */
+typedef enum
+{
+    RENDER_MODE_SPRITE = 0,    /* Standard, alpha compare, point filter */
+    RENDER_MODE_SPRITE_SMOOTH, /* Standard, alpha compare, bilinear filter (scaled or rotated) */
+    RENDER_MODE_TINTED,        /* Texture times prim color, multiply blender, bilinear filter */
+    RENDER_MODE_TRANSLUCENT,   /* Alpha compare, multiply blender, point filter, prim color set per item */
+    RENDER_MODE_CUSTOM,        /* Callback sets its own state; drawn in submission order within its layer (first 31 per layer) */
+    RENDER_MODE_COUNT
+} render_mode_t;
+
+/* Custom draw callback: _iX/_iY/_fScale are the values passed to render_queue_custom */
+typedef void (*render_queue_draw_fn_t)(void *_pContext, int _iX, int _iY, float _fScale);
+
+/* Start collecting items for this frame (drops anything left over from an unflushed frame) */
+void render_queue_begin(void);
+
+/* Queue a sprite blit: same parameters as rdpq_sprite_blit (cx, cy, scale_x and theta are used).
+ * _color is the prim color for RENDER_MODE_TINTED/RENDER_MODE_TRANSLUCENT and ignored otherwise. */
+void render_queue_sprite(render_layer_t _eLayer, render_mode_t _eMode, sprite_t *_pSprite, int _iX, int _iY, const rdpq_blitparms_t *_pParms, color_t _color);
+
+/* Queue an entity like entity2d_render_simple (_bRotate: apply the entity angle).
+ * Returns false if the entity is not visible. */
+bool render_queue_entity(render_layer_t _eLayer, const struct entity2D *_pEnt, bool _bRotate);
+
+/* Queue a callback that draws with its own RDP state. _pContext must stay valid until the flush. */
+void render_queue_custom(render_layer_t _eLayer, render_queue_draw_fn_t _fnDraw, void *_pContext, int _iX, int _iY, float _fScale);
+
+/* While set, submitted items skip the queue and draw right away, below everything queued this frame, like
+ * items that overflow it. RDP state is kept between the draws of one immediate run. For bulk draws that only
+ * one view shows (parked meteors on the minimap), so the queue is not sized for them. */
+void render_queue_set_immediate(bool _bImmediate);
+
+/* Sort and issue all queued items, then empty the queue */
+void render_queue_flush(void);
@@ -13,6 +13,7 @@
 #include "rdpq.h"
 #include "rdpq_mode.h"
 #include "rdpq_sprite.h"
+#include "render_queue.h"
 #include "resource_helper.h"
 #include "rng.h"
 #include "ui.h"
@@ -490,14 +491,14 @@ void satellite_pieces_refresh(void)
 }
 
 /* Helper: Check if a piece with the given unlock flag already exists */
-/* We iterate space_objects to check. This is slow but safe, and only called on create. */
+/* We iterate the active space objects to check. Only called on create. */
 static bool piece_already_exists(uint16_t _uUnlockFlag)
 {
-    int iMax = space_objects_get_max_count();
-    for (int i = 0; i < iMax; i++)
+    int iCount = space_objects_get_active_count();
+    for (int i = 0; i < iCount; i++)
     {
-        SpaceObject *obj = space_objects_get_object(i);
-        if (obj && obj->bAllocated && obj->type == SO_PIECE && obj->data.piece.uUnlockFlag == _uUnlockFlag)
+        SpaceObject *obj = space_objects_get_active(i);
+        if (obj && obj->bAllocated && obj->type == SO_PIECE && obj->pData->piece.uUnlockFlag == _uUnlockFlag)
         {
             return true;
         }
@@ -514,11 +515,11 @@ const struct entity2D *satellite_pieces_get_entity_by_unlock_flag(uint16_t _uUnl
     }
 
     /* Iterate space_objects to find the piece */
-    int iMax = space_objects_get_max_count();
-    for (int i = 0; i < iMax; i++)
+    int iCount = space_objects_get_active_count();
+    for (int i = 0; i < iCount; i++)
     {
-        SpaceObject *obj = space_objects_get_object(i);
-        if (obj && obj->bAllocated && obj->type == SO_PIECE && obj->data.piece.uUnlockFlag == _uUnlockFlag)
+        SpaceObject *obj = space_objects_get_active(i);
+        if (obj && obj->bAllocated && obj->type == SO_PIECE && obj->pData->piece.uUnlockFlag == _uUnlockFlag)
         {
             /* Check if entity is active and loaded */
             if (entity2d_is_active(&obj->entity))
@@ -556,8 +557,8 @@ bool satellite_pieces_create(uint16_t _uUnlockFlag, struct vec2 _vPos, bool _bAs
     entity2d_init_from_sprite(&pPiece->entity, _vPos, pSprite, uFlags, uLayerMask);
 
     pPiece->entity.fAngleRad = rngf(0.0f, 6.28318530718f);
-    pPiece->data.piece.fRotationSpeed = rngb(0.5f) ? PIECE_ROT_SPEED : -PIECE_ROT_SPEED;
-    pPiece->data.piece.bAssembleMode = _bAssembleMode;
+    pPiece->pData->piece.fRotationSpeed = rngb(0.5f) ? PIECE_ROT_SPEED : -PIECE_ROT_SPEED;
+    pPiece->pData->piece.bAssembleMode = _bAssembleMode;
     if (_bAssembleMode)
     {
         pPiece->entity.iCollisionRadius = scale_assemble_collision_radius(pPiece->entity.iCollisionRadius);
@@ -578,20 +579,20 @@ void satellite_piece_update_object(SpaceObject *pPiece)
     }
 
     /* Check if piece is in assemble mode */
-    if (pPiece->data.piece.bAssembleMode)
+    if (pPiece->pData->piece.bAssembleMode)
     {
-        ePieceDirection eDir = (ePieceDirection)pPiece->data.piece.eDirection;
+        ePieceDirection eDir = (ePieceDirection)pPiece->pData->piece.eDirection;
 
         /* Check if piece is already snapped */
         if (s_aPiecesSnapped[eDir])
         {
             /* Piece is snapped - lock position and skip all movement updates */
             struct vec2 vTargetPos = get_slot_position_for_direction(eDir);
-            pPiece->entity.vPos = vTargetPos;
+            space_object_set_position(pPiece, vTargetPos);
             pPiece->entity.fAngleRad = 0.0f;
-            pPiece->entity.vVel = vec2_zero();
-            pPiece->data.piece.fRotationSpeed = 0.0f;
-            pPiece->bSleeping = true;
+            space_object_set_velocity(pPiece, vec2_zero());
+            pPiece->pData->piece.fRotationSpeed = 0.0f;
+            space_object_set_sleeping(pPiece, true);
             return;
         }
 
@@ -604,11 +605,11 @@ void satellite_piece_update_object(SpaceObject *pPiece)
         {
             /* Snap the piece into place */
             s_aPiecesSnapped[eDir] = true;
-            pPiece->entity.vPos = vTargetPos;
+            space_object_set_position(pPiece, vTargetPos);
             pPiece->entity.fAngleRad = 0.0f;
-            pPiece->entity.vVel = vec2_zero();
-            pPiece->data.piece.fRotationSpeed = 0.0f;
-            pPiece->bSleeping = true;
+            space_object_set_velocity(pPiece, vec2_zero());
+            pPiece->pData->piece.fRotationSpeed = 0.0f;
+            space_object_set_sleeping(pPiece, true);
             debugf("satellite_piece_update_object: Piece snapped into slot (direction %d)\n", eDir);
 
             /* Play piece connect sound */
@@ -638,37 +639,38 @@ void satellite_piece_update_object(SpaceObject *pPiece)
 
     if (!pPiece->entity.bGrabbed)
     {
-        pPiece->entity.fAngleRad += pPiece->data.piece.fRotationSpeed * fFrameMul;
+        pPiece->entity.fAngleRad += pPiece->pData->piece.fRotationSpeed * fFrameMul;
         pPiece->entity.fAngleRad = angle_wrap_rad(pPiece->entity.fAngleRad);
     }
     else
     {
         /* Follow UFO movement directly when grabbed (no damping/sleep). */
-        pPiece->bSleeping = false;
-        pPiece->data.piece.fRotationSpeed = 0.0f;
-        pPiece->entity.vPos = vec2_add(pPiece->entity.vPos, vec2_scale(pPiece->entity.vVel, fFrameMul));
+        space_object_set_sleeping(pPiece, false);
+        pPiece->pData->piece.fRotationSpeed = 0.0f;
+        space_object_set_position(pPiece, vec2_add(pPiece->entity.vPos, vec2_scale(pPiece->entity.vVel, fFrameMul)));
         return;
     }
 
-    if (pPiece->bSleeping)
+    if (space_object_is_sleeping(pPiece))
     {
         if (vec2_mag_sq(pPiece->entity.vVel) <= PIECE_SLEEP_VEL_SQ)
             return;
-        pPiece->bSleeping = false;
+        space_object_set_sleeping(pPiece, false);
     }
 
     /* Update position using velocity BEFORE damping */
-    pPiece->entity.vPos = vec2_add(pPiece->entity.vPos, vec2_scale(pPiece->entity.vVel, fFrameMul));
+    space_object_set_position(pPiece, vec2_add(pPiece->entity.vPos, vec2_scale(pPiece->entity.vVel, fFrameMul)));
 
     /* Apply damping to velocity for next frame */
     float fDamping = powf(PIECE_VELOCITY_DAMPING, fFrameMul);
-    pPiece->entity.vVel = vec2_scale(pPiece->entity.vVel, fDamping);
+    struct vec2 vVel = vec2_scale(pPiece->entity.vVel, fDamping);
 
-    if (vec2_mag_sq(pPiece->entity.vVel) <= PIECE_SLEEP_VEL_SQ)
+    if (vec2_mag_sq(vVel) <= PIECE_SLEEP_VEL_SQ)
     {
-        pPiece->entity.vVel = vec2_zero();
-        pPiece->bSleeping = true;
+        vVel = vec2_zero();
+        space_object_set_sleeping(pPiece, true);
     }
+    space_object_set_velocity(pPiece, vVel);
 }
 
 void satellite_piece_render_object(SpaceObject *pPiece, struct vec2i vScreen, float fZoom)
@@ -680,8 +682,6 @@ void satellite_piece_render_object(SpaceObject *pPiece, struct vec2i vScreen, fl
     if (!pEnt->pSprite)
         return;
 
-    rdpq_mode_filter(FILTER_BILINEAR);
-
     rdpq_blitparms_t parms = {
         .cx = pEnt->vHalf.iX,
         .cy = pEnt->vHalf.iY,
@@ -689,7 +689,7 @@ void satellite_piece_render_object(SpaceObject *pPiece, struct vec2i vScreen, fl
         .scale_y = fZoom,
         .theta = pEnt->fAngleRad,
     };
-    rdpq_sprite_blit(pEnt->pSprite, vScreen.iX, vScreen.iY, &parms);
+    render_queue_sprite(RENDER_LAYER_OBJECTS, RENDER_MODE_TINTED, pEnt->pSprite, vScreen.iX, vScreen.iY, &parms, RGBA32(255, 255, 255, 255));
 }
 
 void satellite_piece_collect(SpaceObject *pPiece)
@@ -697,7 +697,7 @@ void satellite_piece_collect(SpaceObject *pPiece)
     if (!pPiece)
         return;
 
-    gp_state_unlock_set(pPiece->data.piece.uUnlockFlag, true);
+    gp_state_unlock_set(pPiece->pData->piece.uUnlockFlag, true);
 
     /* Play collect sound */
     if (s_pSoundPieceCollect)
@@ -754,11 +754,11 @@ void satellite_pieces_spawn_assemble_pieces(void)
         s_aPiecesSnapped[aPieces[i].eDir] = false;
 
         /* Delete any existing piece objects */
-        int iMax = space_objects_get_max_count();
-        for (int j = 0; j < iMax; j++)
+        int iCount = space_objects_get_active_count();
+        for (int j = 0; j < iCount; j++)
         {
-            SpaceObject *pObj = space_objects_get_object(j);
-            if (pObj && pObj->bAllocated && pObj->type == SO_PIECE && pObj->data.piece.uUnlockFlag == aPieces[i].uUnlockFlag)
+            SpaceObject *pObj = space_objects_get_active(j);
+            if (pObj && pObj->bAllocated && pObj->type == SO_PIECE && pObj->pData->piece.uUnlockFlag == aPieces[i].uUnlockFlag)
             {
                 entity2d_deactivate(&pObj->entity);
                 pObj->markForDelete = true;
@@ -792,13 +792,13 @@ void satellite_pieces_spawn_assemble_pieces(void)
             entity2d_init_from_sprite(&pPiece->entity, vSpawnPos, pSprite, uFlags, uLayerMask);
 
             pPiece->entity.fAngleRad = rngf(0.0f, 6.28318530718f);
-            pPiece->data.piece.fRotationSpeed = rngb(0.5f) ? PIECE_ROT_SPEED : -PIECE_ROT_SPEED;
-            pPiece->data.piece.bAssembleMode = true;
+            pPiece->pData->piece.fRotationSpeed = rngb(0.5f) ? PIECE_ROT_SPEED : -PIECE_ROT_SPEED;
+            pPiece->pData->piece.bAssembleMode = true;
             pPiece->entity.iCollisionRadius = scale_assemble_collision_radius(pPiece->entity.iCollisionRadius);
 
             /* Set velocity */
-            pPiece->entity.vVel = vVelocity;
-            pPiece->bSleeping = false; /* Ensure it's not sleeping so velocity applies */
+            space_object_set_velocity(pPiece, vVelocity);
+            space_object_set_sleeping(pPiece, false); /* Ensure it's not sleeping so velocity applies */
 
             iCreatedCount++;
         }
@@ -832,30 +832,17 @@ void satellite_pieces_render_satellite(void)
         camera_world_to_screen(&g_mainCamera, vSlotPos, &vScreenPos);
 
         /* Render missing sprite at 50% alpha */
-        rdpq_set_mode_standard();
-        rdpq_mode_alphacompare(1);
-        rdpq_mode_filter(FILTER_POINT);
-        rdpq_mode_combiner(RDPQ_COMBINER_TEX);
-        rdpq_mode_blender(RDPQ_BLENDER_MULTIPLY);
-        rdpq_set_prim_color(RGBA32(255, 255, 255, 128)); /* 50% alpha */
-
         rdpq_blitparms_t parms = {.cx = pSprite->width / 2, .cy = pSprite->height / 2, .scale_x = fZoom, .scale_y = fZoom};
-
-        rdpq_sprite_blit(pSprite, vScreenPos.iX, vScreenPos.iY, &parms);
+        render_queue_sprite(RENDER_LAYER_SATELLITE, RENDER_MODE_TRANSLUCENT, pSprite, vScreenPos.iX, vScreenPos.iY, &parms, RGBA32(255, 255, 255, 128));
     }
 
     /* Render center piece last */
     struct vec2i vCenterScreenPos;
     camera_world_to_screen(&g_mainCamera, s_vSatelliteRepairPos, &vCenterScreenPos);
 
-    rdpq_set_mode_standard();
-    rdpq_mode_alphacompare(1);
-    rdpq_mode_filter(FILTER_POINT);
-    rdpq_mode_combiner(RDPQ_COMBINER_TEX);
-
+    /* Point filter at any zoom, like the missing pieces */
     rdpq_blitparms_t parmsCenter = {.cx = s_pSpriteCenter->width / 2, .cy = s_pSpriteCenter->height / 2, .scale_x = fZoom, .scale_y = fZoom};
-
-    rdpq_sprite_blit(s_pSpriteCenter, vCenterScreenPos.iX, vCenterScreenPos.iY, &parmsCenter);
+    render_queue_sprite(RENDER_LAYER_SATELLITE, RENDER_MODE_SPRITE, s_pSpriteCenter, vCenterScreenPos.iX, vCenterScreenPos.iY, &parmsCenter, RGBA32(255, 255, 255, 255));
 }
 
 void satellite_pieces_check_center_collision(void)
@@ -876,13 +863,13 @@ void satellite_pieces_check_center_collision(void)
     float fCenterRadius = (float)iCenterRadius * ASSEMBLE_COLLISION_RADIUS_SCALE;
 
     /* Resolve collisions with assemble-mode pieces */
-    int iMax = space_objects_get_max_count();
-    for (int i = 0; i < iMax; i++)
+    int iCount = space_objects_get_active_count();
+    for (int i = 0; i < iCount; i++)
     {
-        SpaceObject *pPiece = space_objects_get_object(i);
+        SpaceObject *pPiece = space_objects_get_active(i);
         if (!pPiece || !pPiece->bAllocated || pPiece->type != SO_PIECE)
             continue;
-        if (!pPiece->data.piece.bAssembleMode)
+        if (!pPiece->pData->piece.bAssembleMode)
             continue;
         if (!entity2d_is_active(&pPiece->entity) || !entity2d_is_collidable(&pPiece->entity))
             continue;
@@ -899,15 +886,15 @@ void satellite_pieces_check_center_collision(void)
 
         float fPenetration = fRadSum - fDist;
         struct vec2 vCorrection = vec2_scale(vNormal, fPenetration + 0.5f);
-        pPiece->entity.vPos = vec2_add(pPiece->entity.vPos, vCorrection);
+        space_object_set_position(pPiece, vec2_add(pPiece->entity.vPos, vCorrection));
 
         /* Cancel piece velocity into center */
         float fVelDot = vec2_dot(pPiece->entity.vVel, vNormal);
         if (fVelDot < 0.0f)
         {
-            pPiece->entity.vVel = vec2_sub(pPiece->entity.vVel, vec2_scale(vNormal, fVelDot));
+            space_object_set_velocity(pPiece, vec2_sub(pPiece->entity.vVel, vec2_scale(vNormal, fVelDot)));
         }
-        pPiece->bSleeping = false;
+        space_object_set_sleeping(pPiece, false);
     }
 
     /* Check circle-circle collision */
@@ -0,0 +1,51 @@
+#pragma once
+
+/* Host stand-in for libdragon's fmath.h: the fast approximations map to libm */
+
+#include <math.h>
+
+static inline float fm_floorf(float _fX)
+{
+    return floorf(_fX);
+}
+
+static inline float fm_ceilf(float _fX)
+{
+    return ceilf(_fX);
+}
+
+static inline float fm_truncf(float _fX)
+{
+    return truncf(_fX);
+}
+
+static inline float fm_fmodf(float _fX, float _fY)
+{
+    return fmodf(_fX, _fY);
+}
+
+static inline float fm_sinf(float _fX)
+{
+    return sinf(_fX);
+}
+
+static inline float fm_cosf(float _fX)
+{
+    return cosf(_fX);
+}
+
+static inline void fm_sincosf(float _fX, float *_pSin, float *_pCos)
+{
+    *_pSin = sinf(_fX);
+    *_pCos = cosf(_fX);
+}
+
+static inline float fm_atan2f(float _fY, float _fX)
+{
+    return atan2f(_fY, _fX);
+}
+
+static inline float fm_exp(float _fX)
+{
+    return expf(_fX);
+}
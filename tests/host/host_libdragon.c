@@ -0,0 +1,206 @@
+#include "libdragon.h"
+#include "../../tools/png_decode.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+host_libdragon_stats_t g_hostLibdragonStats;
+bool g_bHostLibdragonQuiet = false;
+bool g_bHostMemoryExpanded = true;
+
+static uint16_t host_format_bytes_per_pixel(tex_format_t _eFormat)
+{
+    return (_eFormat == FMT_RGBA32) ? 4 : 2;
+}
+
+surface_t surface_alloc(tex_format_t _eFormat, uint16_t _uWidth, uint16_t _uHeight)
+{
+    uint16_t uStride = (uint16_t)(_uWidth * host_format_bytes_per_pixel(_eFormat));
+    surface_t surface = surface_make(malloc((size_t)uStride * _uHeight), _eFormat, _uWidth, _uHeight, uStride);
+    if (surface.buffer)
+    {
+        surface.flags |= SURFACE_FLAGS_OWNEDBUFFER;
+        g_hostLibdragonStats.iLiveSurfaces++;
+        g_hostLibdragonStats.uSurfaceAllocs++;
+    }
+    return surface;
+}
+
+surface_t surface_make(void *_pBuffer, tex_format_t _eFormat, uint16_t _uWidth, uint16_t _uHeight, uint16_t _uStride)
+{
+    surface_t surface = {(uint16_t)_eFormat, _uWidth, _uHeight, _uStride, _pBuffer};
+    return surface;
+}
+
+surface_t surface_make_linear(void *_pBuffer, tex_format_t _eFormat, uint16_t _uWidth, uint16_t _uHeight)
+{
+    return surface_make(_pBuffer, _eFormat, _uWidth, _uHeight, tex_format_row_bytes(_eFormat, _uWidth));
+}
+
+uint16_t tex_format_row_bytes(tex_format_t _eFormat, int _iWidth)
+{
+    switch (_eFormat)
+    {
+    case FMT_CI4:
+    case FMT_I4:
+    case FMT_IA4:
+        return (uint16_t)((_iWidth + 1) / 2);
+    case FMT_CI8:
+    case FMT_I8:
+    case FMT_IA8:
+        return (uint16_t)_iWidth;
+    default:
+        return (uint16_t)(_iWidth * host_format_bytes_per_pixel(_eFormat));
+    }
+}
+
+uint16_t color_to_packed16(color_t _color)
+{
+    return (uint16_t)(((_color.r >> 3) << 11) | ((_color.g >> 3) << 6) | ((_color.b >> 3) << 1) | (_color.a >> 7));
+}
+
+uint32_t color_to_packed32(color_t _color)
+{
+    return ((uint32_t)_color.r << 24) | ((uint32_t)_color.g << 16) | ((uint32_t)_color.b << 8) | _color.a;
+}
+
+tex_format_t surface_get_format(const surface_t *_pSurface)
+{
+    return (tex_format_t)(_pSurface->flags & SURFACE_FLAGS_TEXFORMAT);
+}
+
+void surface_free(surface_t *_pSurface)
+{
+    if (_pSurface->buffer && (_pSurface->flags & SURFACE_FLAGS_OWNEDBUFFER))
+    {
+        free(_pSurface->buffer);
+        g_hostLibdragonStats.iLiveSurfaces--;
+    }
+    memset(_pSurface, 0, sizeof(*_pSurface));
+}
+
+sprite_t *sprite_load(const char *_pPath)
+{
+    /* "rom:/<path>.sprite" -> "rom:/<path>.png" */
+    char szPath[256];
+    size_t uLength = strlen(_pPath);
+    const char *pExt = ".sprite";
+    if (uLength < strlen(pExt) || uLength - strlen(pExt) + 5 > sizeof(szPath) || strcmp(_pPath + uLength - strlen(pExt), pExt) != 0)
+        return NULL;
+    memcpy(szPath, _pPath, uLength - strlen(pExt));
+    strcpy(szPath + uLength - strlen(pExt), ".png");
+
+    uint8_t *pRGBA = NULL;
+    uint32_t uWidth = 0;
+    uint32_t uHeight = 0;
+    if (!png_decode_file(szPath, &pRGBA, &uWidth, &uHeight))
+        return NULL;
+
+    /* Tiles are built with "mksprite --format RGBA16": RGBA5551, alpha bit set above 127 */
+    sprite_t *pSprite = (sprite_t *)malloc(sizeof(sprite_t));
+    uint16_t *pPixels = (uint16_t *)malloc(sizeof(uint16_t) * uWidth * uHeight);
+    if (!pSprite || !pPixels)
+    {
+        free(pSprite);
+        free(pPixels);
+        free(pRGBA);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < uWidth * uHeight; ++i)
+    {
+        const uint8_t *pSrc = &pRGBA[i * 4];
+        pPixels[i] = (uint16_t)(((pSrc[0] >> 3) << 11) | ((pSrc[1] >> 3) << 6) | ((pSrc[2] >> 3) << 1) | (pSrc[3] > 127 ? 1 : 0));
+    }
+    free(pRGBA);
+    pSprite->width = (uint16_t)uWidth;
+    pSprite->height = (uint16_t)uHeight;
+    pSprite->surface = surface_make(pPixels, FMT_RGBA16, (uint16_t)uWidth, (uint16_t)uHeight, (uint16_t)(uWidth * 2));
+
+    g_hostLibdragonStats.iLiveSprites++;
+    g_hostLibdragonStats.uSpriteLoads++;
+    return pSprite;
+}
+
+void sprite_free(sprite_t *_pSprite)
+{
+    if (!_pSprite)
+        return;
+    free(_pSprite->surface.buffer);
+    free(_pSprite);
+    g_hostLibdragonStats.iLiveSprites--;
+}
+
+surface_t sprite_get_pixels(sprite_t *_pSprite)
+{
+    return _pSprite->surface;
+}
+
+tex_format_t sprite_get_format(sprite_t *_pSprite)
+{
+    return surface_get_format(&_pSprite->surface);
+}
+
+uint16_t *sprite_get_palette(sprite_t *_pSprite)
+{
+    (void)_pSprite;
+    return NULL;
+}
+
+const char *tex_format_name(tex_format_t _eFormat)
+{
+    return (_eFormat == FMT_RGBA32) ? "RGBA32" : (_eFormat == FMT_RGBA16) ? "RGBA16" : "other";
+}
+
+/* An 8 MB system (Expansion Pak) with 1 MB in use */
+void sys_get_heap_stats(heap_stats_t *_pStats)
+{
+    _pStats->total = 8 * 1024 * 1024;
+    _pStats->used = 1024 * 1024;
+}
+
+bool is_memory_expanded(void)
+{
+    return g_bHostMemoryExpanded;
+}
+
+uint64_t get_ticks_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint32_t get_ticks_ms(void)
+{
+    return (uint32_t)(get_ticks_us() / 1000u);
+}
+
+void data_cache_hit_writeback(volatile const void *_pAddr, unsigned long _uLength)
+{
+    (void)_pAddr;
+    (void)_uLength;
+}
+
+void data_cache_hit_writeback_invalidate(volatile void *_pAddr, unsigned long _uLength)
+{
+    (void)_pAddr;
+    (void)_uLength;
+}
+
+void data_cache_hit_invalidate(volatile void *_pAddr, unsigned long _uLength)
+{
+    (void)_pAddr;
+    (void)_uLength;
+}
+
+void debugf(const char *_pFormat, ...)
+{
+    if (g_bHostLibdragonQuiet)
+        return;
+
+    va_list args;
+    va_start(args, _pFormat);
+    vprintf(_pFormat, args);
+    va_end(args);
+}
@@ -0,0 +1,190 @@
+#include "rdpq.h"
+
+/* rdpq stand-in: no rasterization, draw calls are counted in g_hostLibdragonStats.uRdpqDraws */
+
+const rdpq_trifmt_t TRIFMT_FILL = {.pos_offset = 0, .shade_offset = -1, .tex_offset = -1, .z_offset = -1};
+const rdpq_trifmt_t TRIFMT_SHADE = {.pos_offset = 0, .shade_offset = 2, .tex_offset = -1, .z_offset = -1};
+const rdpq_trifmt_t TRIFMT_TEX = {.pos_offset = 0, .shade_offset = -1, .tex_offset = 2, .z_offset = -1};
+const rdpq_trifmt_t TRIFMT_SHADE_TEX = {.pos_offset = 0, .shade_offset = 2, .tex_offset = 6, .z_offset = -1};
+
+void rdpq_attach(const surface_t *_pColor, const surface_t *_pDepth)
+{
+    (void)_pColor;
+    (void)_pDepth;
+}
+
+void rdpq_attach_clear(const surface_t *_pColor, const surface_t *_pDepth)
+{
+    (void)_pColor;
+    (void)_pDepth;
+}
+
+void rdpq_detach(void)
+{
+}
+
+void rdpq_detach_wait(void)
+{
+}
+
+void rdpq_set_mode_standard(void)
+{
+}
+
+void rdpq_set_mode_copy(bool _bTransparency)
+{
+    (void)_bTransparency;
+}
+
+void rdpq_set_mode_fill(color_t _color)
+{
+    (void)_color;
+}
+
+void rdpq_set_prim_color(color_t _color)
+{
+    (void)_color;
+}
+
+void rdpq_set_fog_color(color_t _color)
+{
+    (void)_color;
+}
+
+void rdpq_set_blend_color(color_t _color)
+{
+    (void)_color;
+}
+
+void rdpq_set_env_color(color_t _color)
+{
+    (void)_color;
+}
+
+void rdpq_mode_push(void)
+{
+}
+
+void rdpq_mode_pop(void)
+{
+}
+
+void rdpq_mode_filter(rdpq_filter_t _eFilter)
+{
+    (void)_eFilter;
+}
+
+void rdpq_mode_alphacompare(int _iThreshold)
+{
+    (void)_iThreshold;
+}
+
+void rdpq_mode_combiner(rdpq_combiner_t _combiner)
+{
+    (void)_combiner;
+}
+
+void rdpq_mode_blender(rdpq_blender_t _blender)
+{
+    (void)_blender;
+}
+
+void rdpq_mode_dithering(rdpq_dither_t _eDither)
+{
+    (void)_eDither;
+}
+
+void rdpq_mode_tlut(rdpq_tlut_t _eTlut)
+{
+    (void)_eTlut;
+}
+
+void rdpq_mode_antialias(int _iMode)
+{
+    (void)_iMode;
+}
+
+int rdpq_tex_upload(rdpq_tile_t _eTile, const surface_t *_pSurface, const rdpq_texparms_t *_pParms)
+{
+    (void)_eTile;
+    (void)_pParms;
+    return _pSurface ? _pSurface->stride * _pSurface->height : 0;
+}
+
+int rdpq_tex_upload_sub(rdpq_tile_t _eTile, const surface_t *_pSurface, const rdpq_texparms_t *_pParms, int _iS0, int _iT0, int _iS1, int _iT1)
+{
+    (void)_eTile;
+    (void)_pSurface;
+    (void)_pParms;
+    (void)_iS0;
+    (void)_iS1;
+    return _pSurface ? _pSurface->stride * (_iT1 - _iT0) : 0;
+}
+
+void rdpq_tex_upload_tlut(uint16_t *_pTlut, int _iColorIdx, int _iNumColors)
+{
+    (void)_pTlut;
+    (void)_iColorIdx;
+    (void)_iNumColors;
+}
+
+/* Counts one draw per TMEM strip, as rdpq splits an unscaled blit (half of TMEM next to a CI palette) */
+void rdpq_tex_blit(const surface_t *_pSurface, float _fX, float _fY, const rdpq_blitparms_t *_pParms)
+{
+    (void)_fX;
+    (void)_fY;
+    tex_format_t eFormat = surface_get_format(_pSurface);
+    int iWidth = (_pParms && _pParms->width) ? _pParms->width : _pSurface->width;
+    int iHeight = (_pParms && _pParms->height) ? _pParms->height : _pSurface->height;
+    int iTmemBytes = (eFormat == FMT_CI4 || eFormat == FMT_CI8) ? 2048 : 4096;
+    int iStripRows = iTmemBytes / tex_format_row_bytes(eFormat, iWidth);
+    if (iStripRows < 1)
+        iStripRows = 1;
+    g_hostLibdragonStats.uRdpqDraws += (uint32_t)((iHeight + iStripRows - 1) / iStripRows);
+}
+
+int rdpq_sprite_upload(rdpq_tile_t _eTile, sprite_t *_pSprite, const rdpq_texparms_t *_pParms)
+{
+    return _pSprite ? rdpq_tex_upload(_eTile, &_pSprite->surface, _pParms) : 0;
+}
+
+void rdpq_sprite_blit(sprite_t *_pSprite, float _fX, float _fY, const rdpq_blitparms_t *_pParms)
+{
+    (void)_pSprite;
+    (void)_fX;
+    (void)_fY;
+    (void)_pParms;
+    g_hostLibdragonStats.uRdpqDraws++;
+}
+
+void rdpq_fill_rectangle(float _fX0, float _fY0, float _fX1, float _fY1)
+{
+    (void)_fX0;
+    (void)_fY0;
+    (void)_fX1;
+    (void)_fY1;
+    g_hostLibdragonStats.uRdpqDraws++;
+}
+
+void rdpq_texture_rectangle_scaled(rdpq_tile_t _eTile, float _fX0, float _fY0, float _fX1, float _fY1, float _fS0, float _fT0, float _fS1, float _fT1)
+{
+    (void)_eTile;
+    (void)_fX0;
+    (void)_fY0;
+    (void)_fX1;
+    (void)_fY1;
+    (void)_fS0;
+    (void)_fT0;
+    (void)_fS1;
+    (void)_fT1;
+    g_hostLibdragonStats.uRdpqDraws++;
+}
+
+void rdpq_triangle(const rdpq_trifmt_t *_pFmt, const float *_pV1, const float *_pV2, const float *_pV3)
+{
+    (void)_pFmt;
+    (void)_pV1;
+    (void)_pV2;
+    (void)_pV3;
+    g_hostLibdragonStats.uRdpqDraws++;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+/* Host stand-in for the parts of libdragon used by the tilemap loader, so it can be tested on the build
+ * machine (see tests/tilemap_loader_test.c). Surfaces live in host memory; sprite_load("rom:/<path>.sprite")
+ * decodes the source PNG "rom:/<path>.png" into an RGBA16 sprite like "mksprite --format RGBA16", so the
+ * test runs from a directory where "rom:" points at assets/. Sources are compiled with -include libdragon.h,
+ * as some repo headers rely on libdragon being included first. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h> /* libdragon's headers pull in the C library basics some sources rely on */
+#include <string.h>
+
+#define FM_PI 3.14159265358979f /* fmath.h */
+
+typedef struct
+{
+    uint8_t r, g, b, a;
+} color_t;
+
+#define RGBA32(_r, _g, _b, _a) ((color_t){.r = (_r), .g = (_g), .b = (_b), .a = (_a)})
+
+typedef enum
+{
+    FMT_NONE = 0,
+    FMT_RGBA16,
+    FMT_RGBA32,
+    FMT_CI4,
+    FMT_CI8,
+    FMT_I4,
+    FMT_I8,
+    FMT_IA4,
+    FMT_IA8,
+    FMT_IA16
+} tex_format_t;
+
+#define SURFACE_FLAGS_TEXFORMAT 0x1F   /* Format bits of surface_t.flags */
+#define SURFACE_FLAGS_OWNEDBUFFER 0x20 /* Buffer allocated by surface_alloc (surface_free releases it) */
+
+typedef struct
+{
+    uint16_t flags;
+    uint16_t width;
+    uint16_t height;
+    uint16_t stride;
+    void *buffer;
+} surface_t;
+
+typedef struct
+{
+    uint16_t width;
+    uint16_t height;
+    surface_t surface; /* RGBA16 (RGBA5551) */
+} sprite_t;
+
+surface_t surface_alloc(tex_format_t _eFormat, uint16_t _uWidth, uint16_t _uHeight);
+surface_t surface_make(void *_pBuffer, tex_format_t _eFormat, uint16_t _uWidth, uint16_t _uHeight, uint16_t _uStride);
+surface_t surface_make_linear(void *_pBuffer, tex_format_t _eFormat, uint16_t _uWidth, uint16_t _uHeight);
+void surface_free(surface_t *_pSurface);
+tex_format_t surface_get_format(const surface_t *_pSurface);
+uint16_t tex_format_row_bytes(tex_format_t _eFormat, int _iWidth); /* Host helper: bytes of _iWidth texels */
+#define TEX_FORMAT_PIX2BYTES(_eFormat, _iPixels) tex_format_row_bytes((_eFormat), (_iPixels))
+uint16_t color_to_packed16(color_t _color);
+uint32_t color_to_packed32(color_t _color);
+
+sprite_t *sprite_load(const char *_pPath);
+void sprite_free(sprite_t *_pSprite);
+surface_t sprite_get_pixels(sprite_t *_pSprite);
+tex_format_t sprite_get_format(sprite_t *_pSprite);
+uint16_t *sprite_get_palette(sprite_t *_pSprite);
+const char *tex_format_name(tex_format_t _eFormat);
+
+typedef struct wav64_s wav64_t; /* Sounds are never loaded on the host (audio.c is not linked) */
+
+typedef struct
+{
+    int total;
+    int used;
+} heap_stats_t;
+
+void sys_get_heap_stats(heap_stats_t *_pStats);
+bool is_memory_expanded(void);
+
+uint64_t get_ticks_us(void);
+uint32_t get_ticks_ms(void);
+void data_cache_hit_writeback(volatile const void *_pAddr, unsigned long _uLength);
+void data_cache_hit_writeback_invalidate(volatile void *_pAddr, unsigned long _uLength);
+void data_cache_hit_invalidate(volatile void *_pAddr, unsigned long _uLength);
+void debugf(const char *_pFormat, ...) __attribute__((format(printf, 1, 2)));
+
+/* Test hooks: live objects and calls since start, to check leaks and per-step work */
+typedef struct
+{
+    int iLiveSprites;
+    int iLiveSurfaces;
+    uint32_t uSpriteLoads;
+    uint32_t uSurfaceAllocs;
+    uint32_t uRdpqDraws; /* Rectangles, triangles and blit strips (see rdpq.h) */
+} host_libdragon_stats_t;
+
+extern host_libdragon_stats_t g_hostLibdragonStats;
+extern bool g_bHostLibdragonQuiet; /* Drop debugf output */
+extern bool g_bHostMemoryExpanded; /* is_memory_expanded() (default true) */
+
+#include "rdpq.h"
@@ -0,0 +1,154 @@
+#pragma once
+
+/* Host stand-in for the rdpq API used by the game renderers: types and modes are declared so render code
+ * compiles, every call is a no-op that only counts draws (g_hostLibdragonStats.uRdpqDraws). The rdpq_*.h
+ * sub-headers include this one. */
+
+#include "libdragon.h"
+
+typedef enum
+{
+    TILE0 = 0,
+    TILE1,
+    TILE2,
+    TILE3,
+    TILE4,
+    TILE5,
+    TILE6,
+    TILE7
+} rdpq_tile_t;
+
+typedef enum
+{
+    FILTER_POINT = 0,
+    FILTER_BILINEAR,
+    FILTER_MEDIAN
+} rdpq_filter_t;
+
+typedef enum
+{
+    DITHER_SQUARE_SQUARE = 0,
+    DITHER_SQUARE_INVSQUARE,
+    DITHER_SQUARE_NOISE,
+    DITHER_SQUARE_NONE,
+    DITHER_BAYER_BAYER,
+    DITHER_BAYER_INVBAYER,
+    DITHER_BAYER_NOISE,
+    DITHER_BAYER_NONE,
+    DITHER_NOISE_SQUARE,
+    DITHER_NOISE_INVSQUARE,
+    DITHER_NOISE_NOISE,
+    DITHER_NOISE_NONE,
+    DITHER_NONE_SQUARE,
+    DITHER_NONE_INVSQUARE,
+    DITHER_NONE_NOISE,
+    DITHER_NONE_NONE
+} rdpq_dither_t;
+
+typedef enum
+{
+    TLUT_NONE = 0,
+    TLUT_RGBA16,
+    TLUT_IA16
+} rdpq_tlut_t;
+
+typedef uint64_t rdpq_combiner_t;
+typedef uint32_t rdpq_blender_t;
+
+#define RDPQ_COMBINER_FLAT ((rdpq_combiner_t)1)
+#define RDPQ_COMBINER_SHADE ((rdpq_combiner_t)2)
+#define RDPQ_COMBINER_TEX ((rdpq_combiner_t)3)
+#define RDPQ_COMBINER_TEX_FLAT ((rdpq_combiner_t)4)
+#define RDPQ_COMBINER_TEX_SHADE ((rdpq_combiner_t)5)
+#define RDPQ_COMBINER1(_rgb, _alpha) ((rdpq_combiner_t)6)
+#define RDPQ_BLENDER_MULTIPLY ((rdpq_blender_t)1)
+#define RDPQ_BLENDER_MULTIPLY_CONST ((rdpq_blender_t)2)
+#define RDPQ_BLENDER_ADDITIVE ((rdpq_blender_t)3)
+#define RDPQ_BLENDER(_formula) ((rdpq_blender_t)4)
+
+#define REPEAT_INFINITE 2048
+#define MIRROR_NONE false
+#define MIRROR_REPEAT true
+
+typedef struct
+{
+    rdpq_tile_t tile;
+    int s0;
+    int t0;
+    int width;
+    int height;
+    bool flip_x;
+    bool flip_y;
+    int cx;
+    int cy;
+    float scale_x;
+    float scale_y;
+    float theta;
+    bool filtering;
+    int nx;
+    int ny;
+} rdpq_blitparms_t;
+
+typedef struct
+{
+    int tmem_addr;
+    int palette;
+    struct
+    {
+        float translate;
+        int scale_log;
+        float repeats;
+        bool mirror;
+    } s, t;
+} rdpq_texparms_t;
+
+typedef struct
+{
+    int pos_offset;
+    int shade_offset;
+    bool shade_flat;
+    int tex_offset;
+    rdpq_tile_t tex_tile;
+    int tex_mipmaps;
+    int z_offset;
+} rdpq_trifmt_t;
+
+extern const rdpq_trifmt_t TRIFMT_FILL;
+extern const rdpq_trifmt_t TRIFMT_SHADE;
+extern const rdpq_trifmt_t TRIFMT_TEX;
+extern const rdpq_trifmt_t TRIFMT_SHADE_TEX;
+
+void rdpq_attach(const surface_t *_pColor, const surface_t *_pDepth);
+void rdpq_attach_clear(const surface_t *_pColor, const surface_t *_pDepth);
+void rdpq_detach(void);
+void rdpq_detach_wait(void);
+
+void rdpq_set_mode_standard(void);
+void rdpq_set_mode_copy(bool _bTransparency);
+void rdpq_set_mode_fill(color_t _color);
+void rdpq_set_prim_color(color_t _color);
+void rdpq_set_fog_color(color_t _color);
+void rdpq_set_blend_color(color_t _color);
+void rdpq_set_env_color(color_t _color);
+void rdpq_mode_push(void);
+void rdpq_mode_pop(void);
+void rdpq_mode_filter(rdpq_filter_t _eFilter);
+void rdpq_mode_alphacompare(int _iThreshold);
+void rdpq_mode_combiner(rdpq_combiner_t _combiner);
+void rdpq_mode_blender(rdpq_blender_t _blender);
+void rdpq_mode_dithering(rdpq_dither_t _eDither);
+void rdpq_mode_tlut(rdpq_tlut_t _eTlut);
+void rdpq_mode_antialias(int _iMode);
+
+int rdpq_tex_upload(rdpq_tile_t _eTile, const surface_t *_pSurface, const rdpq_texparms_t *_pParms);
+int rdpq_tex_upload_sub(rdpq_tile_t _eTile, const surface_t *_pSurface, const rdpq_texparms_t *_pParms, int _iS0, int _iT0, int _iS1, int _iT1);
+void rdpq_tex_upload_tlut(uint16_t *_pTlut, int _iColorIdx, int _iNumColors);
+void rdpq_tex_blit(const surface_t *_pSurface, float _fX, float _fY, const rdpq_blitparms_t *_pParms);
+int rdpq_sprite_upload(rdpq_tile_t _eTile, sprite_t *_pSprite, const rdpq_texparms_t *_pParms);
+void rdpq_sprite_blit(sprite_t *_pSprite, float _fX, float _fY, const rdpq_blitparms_t *_pParms);
+
+void rdpq_fill_rectangle(float _fX0, float _fY0, float _fX1, float _fY1);
+void rdpq_texture_rectangle_scaled(rdpq_tile_t _eTile, float _fX0, float _fY0, float _fX1, float _fY1, float _fS0, float _fT0, float _fS1, float _fT1);
+#define rdpq_texture_rectangle(_eTile, _fX0, _fY0, _fX1, _fY1, _fS, _fT) \
+    rdpq_texture_rectangle_scaled((_eTile), (_fX0), (_fY0), (_fX1), (_fY1), (_fS), (_fT), (_fS) + (_fX1) - (_fX0), (_fT) + (_fY1) - (_fY0))
+void rdpq_triangle(const rdpq_trifmt_t *_pFmt, const float *_pV1, const float *_pV2, const float *_pV3);
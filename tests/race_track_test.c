@@ -0,0 +1,262 @@
+/* Headless test of the race track closest-segment grid (make host-tests).
+ *
+ * Loads real races through race_track_init and checks find_closest_segment against a scan over all
+ * segments:
+ * - positions across the track corridor (every segment, up to RACE_TRACK_GRID_COVERAGE to either side) are
+ *   answered by a grid cell and get the same nearest distance, and the same closest point when the same
+ *   segment wins,
+ * - positions anywhere around the track (grid cells, chunk fallback and outside the grid) get the same
+ *   nearest distance (timings of both are logged).
+ *
+ * Usage: race_track_test <folder>:<race> ...
+ * Run where "rom:" points at assets/. */
+
+#include "../game_objects/race_track.c"
+#include "test_common.h"
+
+/* gp_state.c and ufo.c are not linked: the test picks the folder itself and never runs race_track_update */
+static const char *m_pFolder = NULL;
+
+const char *gp_state_get_current_folder(void)
+{
+    return m_pFolder;
+}
+
+struct vec2 ufo_get_position(void)
+{
+    return vec2_zero();
+}
+
+struct vec2 ufo_get_velocity(void)
+{
+    return vec2_zero();
+}
+
+void ufo_set_position(struct vec2 _vPos)
+{
+    (void)_vPos;
+}
+
+void ufo_set_velocity(struct vec2 _vVel)
+{
+    (void)_vVel;
+}
+
+void ufo_apply_bounce_effect(uint32_t _uDurationMs)
+{
+    (void)_uDurationMs;
+}
+
+/* Reference: nearest segment by scanning all of them (lowest index wins ties, like test_segment) */
+static float test_closest_segment_reference(struct vec2 _vPos, uint16_t *_pOutSegIndex, struct vec2 *_pOutClosest)
+{
+    float fBestDistSq = 1e10f;
+    for (uint16_t i = 0; i < m_track.uSampleCount; ++i)
+    {
+        struct vec2 vClosest;
+        float fDistSq = segment_closest_point(i, _vPos, NULL, &vClosest);
+        if (fDistSq < fBestDistSq)
+        {
+            fBestDistSq = fDistSq;
+            *_pOutSegIndex = i;
+            *_pOutClosest = vClosest;
+        }
+    }
+    return fBestDistSq;
+}
+
+/* Number of grid candidates of the cell containing _vPos (0 outside the grid) */
+static uint16_t test_grid_candidates(struct vec2 _vPos)
+{
+    int iCellX = (int)floorf((_vPos.fX - m_grid.fOriginX) * m_grid.fInvCellSize);
+    int iCellY = (int)floorf((_vPos.fY - m_grid.fOriginY) * m_grid.fInvCellSize);
+    if (iCellX < 0 || iCellX >= (int)m_grid.uCellsX || iCellY < 0 || iCellY >= (int)m_grid.uCellsY)
+        return 0;
+    uint32_t uCell = (uint32_t)iCellY * m_grid.uCellsX + (uint32_t)iCellX;
+    return (uint16_t)(m_grid.pCellStart[uCell + 1] - m_grid.pCellStart[uCell]);
+}
+
+/* Every segment at 4 points along it, each pushed 9 steps across the corridor along the segment normal */
+static void test_check_corridor(const char *_pName)
+{
+    int iQueries = 0;
+    int iUncovered = 0;
+    int iMismatches = 0;
+    uint32_t uCandidates = 0;
+
+    for (uint16_t i = 0; i < m_track.uSampleCount; ++i)
+    {
+        uint16_t uNext = (i == m_track.uSampleCount - 1) ? 0 : (i + 1);
+        for (int iAlong = 0; iAlong < 4; ++iAlong)
+        {
+            struct vec2 vBase = vec2_mix(m_track.pSamples[i].vPos, m_track.pSamples[uNext].vPos, (float)iAlong * 0.25f);
+            for (int iAcross = -4; iAcross <= 4; ++iAcross)
+            {
+                struct vec2 vPos = vec2_add(vBase, vec2_scale(m_track.pSamples[i].vNormal, (float)iAcross * 0.25f * RACE_TRACK_GRID_COVERAGE));
+
+                uint16_t uCount = test_grid_candidates(vPos);
+                uCandidates += uCount;
+                if (uCount == 0)
+                    iUncovered++;
+
+                uint16_t uSegIndex;
+                float fT;
+                struct vec2 vClosest;
+                find_closest_segment(vPos, &uSegIndex, &fT, &vClosest);
+
+                uint16_t uRefIndex = 0;
+                struct vec2 vRefClosest = vec2_zero();
+                float fRefDistSq = test_closest_segment_reference(vPos, &uRefIndex, &vRefClosest);
+                float fDistSq = vec2_mag_sq(vec2_sub(vPos, vClosest));
+
+                /* Same nearest distance; equidistant segments may differ */
+                bool bMatch = (fDistSq == fRefDistSq) && (uSegIndex != uRefIndex || (vClosest.fX == vRefClosest.fX && vClosest.fY == vRefClosest.fY));
+                if (!bMatch && iMismatches < 8)
+                    TEST_CHECK(false,
+                               "%s corridor (%.1f, %.1f): grid segment %u dist^2 %.3f, scan segment %u dist^2 %.3f",
+                               _pName,
+                               vPos.fX,
+                               vPos.fY,
+                               uSegIndex,
+                               fDistSq,
+                               uRefIndex,
+                               fRefDistSq);
+                if (!bMatch)
+                    iMismatches++;
+                iQueries++;
+            }
+        }
+    }
+
+    TEST_CHECK(iUncovered == 0, "%s: %d of %d corridor positions not covered by the grid", _pName, iUncovered, iQueries);
+    TEST_CHECK(iMismatches == 0, "%s: %d of %d corridor positions differ from the scan", _pName, iMismatches, iQueries);
+    printf("  %s corridor: %d queries, %.1f candidates per query\n", _pName, iQueries, iQueries ? (double)uCandidates / iQueries : 0.0);
+}
+
+/* Random positions in the bounding box grown by a quarter on each side: grid cells, fallback cells and
+ * positions outside the grid */
+static void test_check_anywhere(const char *_pName)
+{
+    const int iQueries = 20000;
+    const float fGrowX = (m_fTrackMaxX - m_fTrackMinX) * 0.25f;
+    const float fGrowY = (m_fTrackMaxY - m_fTrackMinY) * 0.25f;
+    uint32_t uSeed = 0x27D4EB2Fu;
+    struct vec2 *pPositions = (struct vec2 *)malloc(sizeof(struct vec2) * iQueries);
+    float *pGridDistSq = (float *)malloc(sizeof(float) * iQueries);
+    float *pScanDistSq = (float *)malloc(sizeof(float) * iQueries);
+    if (!pPositions || !pGridDistSq || !pScanDistSq)
+    {
+        TEST_CHECK(false, "%s: out of memory", _pName);
+        free(pPositions);
+        free(pGridDistSq);
+        free(pScanDistSq);
+        return;
+    }
+
+    int iFallbacks = 0;
+    for (int q = 0; q < iQueries; ++q)
+    {
+        uSeed = uSeed * 1664525u + 1013904223u;
+        float fU = (float)(uSeed >> 8) * (1.0f / 16777216.0f);
+        uSeed = uSeed * 1664525u + 1013904223u;
+        float fV = (float)(uSeed >> 8) * (1.0f / 16777216.0f);
+        pPositions[q] = vec2_make(m_fTrackMinX - fGrowX + fU * (m_fTrackMaxX - m_fTrackMinX + 2.0f * fGrowX),
+                                  m_fTrackMinY - fGrowY + fV * (m_fTrackMaxY - m_fTrackMinY + 2.0f * fGrowY));
+        if (test_grid_candidates(pPositions[q]) == 0)
+            iFallbacks++;
+    }
+
+    uint64_t uStartUs = get_ticks_us();
+    for (int q = 0; q < iQueries; ++q)
+    {
+        uint16_t uSegIndex;
+        float fT;
+        struct vec2 vClosest;
+        find_closest_segment(pPositions[q], &uSegIndex, &fT, &vClosest);
+        pGridDistSq[q] = vec2_mag_sq(vec2_sub(pPositions[q], vClosest));
+    }
+    uint64_t uGridUs = get_ticks_us() - uStartUs;
+
+    uStartUs = get_ticks_us();
+    for (int q = 0; q < iQueries; ++q)
+    {
+        uint16_t uRefIndex = 0;
+        struct vec2 vRefClosest = vec2_zero();
+        pScanDistSq[q] = test_closest_segment_reference(pPositions[q], &uRefIndex, &vRefClosest);
+    }
+    uint64_t uScanUs = get_ticks_us() - uStartUs;
+
+    int iMismatches = 0;
+    for (int q = 0; q < iQueries; ++q)
+    {
+        if (pGridDistSq[q] == pScanDistSq[q])
+            continue;
+        if (iMismatches < 8)
+            TEST_CHECK(false, "%s (%.1f, %.1f): dist^2 %.3f, scan %.3f", _pName, pPositions[q].fX, pPositions[q].fY, pGridDistSq[q], pScanDistSq[q]);
+        iMismatches++;
+    }
+    TEST_CHECK(iMismatches == 0, "%s: %d of %d positions differ from the scan", _pName, iMismatches, iQueries);
+    printf("  %s anywhere: %d queries (%d without grid candidates), grid %lu us, scan %lu us\n",
+           _pName,
+           iQueries,
+           iFallbacks,
+           (unsigned long)uGridUs,
+           (unsigned long)uScanUs);
+
+    free(pPositions);
+    free(pGridDistSq);
+    free(pScanDistSq);
+}
+
+static void test_race(const char *_pFolder, const char *_pRace)
+{
+    m_pFolder = _pFolder;
+    race_track_init(_pRace);
+    TEST_CHECK(m_track.bInitialized, "%s:%s: race_track_init failed", _pFolder, _pRace);
+    if (!m_track.bInitialized)
+        return;
+
+    TEST_CHECK(m_grid.bValid, "%s: closest-segment grid not built", _pRace);
+    printf("%s:%s: %u segments, grid %ux%u, %u candidates\n",
+           _pFolder,
+           _pRace,
+           m_track.uSampleCount,
+           m_grid.uCellsX,
+           m_grid.uCellsY,
+           m_grid.bValid ? m_grid.pCellStart[(uint32_t)m_grid.uCellsX * m_grid.uCellsY] : 0);
+
+    test_check_corridor(_pRace);
+    test_check_anywhere(_pRace);
+
+    race_track_free();
+}
+
+int main(int _iArgc, char **_ppArgv)
+{
+    if (_iArgc < 2)
+    {
+        printf("usage: %s <folder>:<race> ...\n", _ppArgv[0]);
+        return 2;
+    }
+
+    for (int i = 1; i < _iArgc; ++i)
+    {
+        char szFolder[64];
+        const char *pRace = strchr(_ppArgv[i], ':');
+        if (!pRace)
+        {
+            printf("usage: %s <folder>:<race> ...\n", _ppArgv[0]);
+            return 2;
+        }
+        size_t uLength = (size_t)(pRace - _ppArgv[i]);
+        if (uLength >= sizeof(szFolder))
+            uLength = sizeof(szFolder) - 1;
+        memcpy(szFolder, _ppArgv[i], uLength);
+        szFolder[uLength] = '\0';
+
+        test_race(szFolder, pRace + 1);
+    }
+
+    printf("%s (%d failures)\n", m_iFailures ? "FAILED" : "OK", m_iFailures);
+    return m_iFailures ? 1 : 0;
+}
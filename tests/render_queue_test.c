@@ -0,0 +1,214 @@
+/* Headless test of the render queue (make host-tests).
+ *
+ * Submits synthetic frames and checks:
+ * - render_queue_sort keeps the layers in order and, within a layer, every custom item in its submission order
+ *   relative to all other items of the layer, while the sprites between two custom items still sort by mode
+ *   and sprite; past the last phase, custom items at least keep their order among themselves,
+ * - render_queue_flush calls the custom items in submission order,
+ * - the RQITEM/RQMODE/RQLOAD counters reported at the flush include the immediate and overflow draws made
+ *   since the previous flush, and start from zero again after it.
+ *
+ * Usage: render_queue_test */
+
+#define PROFILER_ENABLED
+#include "../render_queue.c"
+#include "test_common.h"
+
+/* profiler.c is not linked: the flush reports into these */
+static uint32_t m_auCounters[PROF_COUNTER_MAX];
+
+void profiler_counter_add(enum eProfilerCounter _eCounter, uint32_t _uValue)
+{
+    m_auCounters[_eCounter] += _uValue;
+}
+
+static sprite_t m_aSprites[3];
+
+static void test_sprites_init(void)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        m_aSprites[i].width = 16;
+        m_aSprites[i].height = 16;
+        m_aSprites[i].surface = surface_make_linear(NULL, FMT_RGBA16, 16, 16);
+    }
+}
+
+static uint32_t m_uRandom = 0x2545F491u;
+
+static uint32_t test_random(uint32_t _uRange)
+{
+    m_uRandom = m_uRandom * 1664525u + 1013904223u;
+    return (m_uRandom >> 8) % _uRange;
+}
+
+/* ---------- Custom item order ---------- */
+
+static int m_aiCustomLog[RENDER_QUEUE_MAX_ITEMS];
+static int m_iCustomLogCount = 0;
+
+static void test_custom_draw(void *_pContext, int _iX, int _iY, float _fScale)
+{
+    (void)_iY;
+    (void)_fScale;
+    (void)_pContext;
+    if (m_iCustomLogCount < RENDER_QUEUE_MAX_ITEMS)
+        m_aiCustomLog[m_iCustomLogCount++] = _iX;
+}
+
+/* Submits _iCount items over the OBJECTS and CURRENCY layers, one in _iCustomOdds a custom item; the X position
+ * is the submission index */
+static void test_submit_frame(int _iCount, int _iCustomOdds)
+{
+    static const render_mode_t aModes[] = {RENDER_MODE_SPRITE, RENDER_MODE_SPRITE_SMOOTH, RENDER_MODE_TINTED};
+    render_queue_begin();
+    for (int i = 0; i < _iCount; ++i)
+    {
+        render_layer_t eLayer = test_random(4) == 0 ? RENDER_LAYER_CURRENCY : RENDER_LAYER_OBJECTS;
+        if (test_random((uint32_t)_iCustomOdds) == 0)
+        {
+            render_queue_custom(eLayer, test_custom_draw, NULL, i, 0, 1.0f);
+        }
+        else
+        {
+            rdpq_blitparms_t parms = {.scale_x = 1.0f, .scale_y = 1.0f};
+            render_queue_sprite(eLayer, aModes[test_random(3)], &m_aSprites[test_random(3)], i, 0, &parms, RGBA32(255, 255, 255, 255));
+        }
+    }
+}
+
+/* Checks the sorted order of the queued items; _bFullOrder: every pair with a custom item keeps submission order */
+static void test_check_sorted_order(const char *_pName, bool _bFullOrder)
+{
+    static int aiPos[RENDER_QUEUE_MAX_ITEMS];
+    const uint16_t *pOrder = render_queue_sort();
+    int iMismatches = 0;
+    int iBatchBreaks = 0;
+
+    for (uint16_t i = 0; i < m_uItemCount; ++i)
+    {
+        aiPos[pOrder[i]] = i;
+        if (i > 0 && m_auKey[pOrder[i]] < m_auKey[pOrder[i - 1]])
+            iBatchBreaks++;
+        if (i > 0 && m_aItems[pOrder[i]].uLayer < m_aItems[pOrder[i - 1]].uLayer)
+            iMismatches++;
+    }
+
+    for (uint16_t i = 0; i < m_uItemCount; ++i)
+    {
+        for (uint16_t j = (uint16_t)(i + 1); j < m_uItemCount; ++j)
+        {
+            bool bCustomI = m_aItems[i].uMode == RENDER_MODE_CUSTOM;
+            bool bCustomJ = m_aItems[j].uMode == RENDER_MODE_CUSTOM;
+            if (m_aItems[i].uLayer != m_aItems[j].uLayer || !(bCustomI || bCustomJ))
+                continue;
+            if (!_bFullOrder && !(bCustomI && bCustomJ))
+                continue;
+            if (aiPos[i] > aiPos[j])
+            {
+                if (iMismatches < 3)
+                    TEST_CHECK(false, "%s: item %d (%s) drawn after item %d (%s)", _pName, i, bCustomI ? "custom" : "sprite", j, bCustomJ ? "custom" : "sprite");
+                iMismatches++;
+            }
+        }
+    }
+
+    printf("  %-22s %3u items, %d out of order, %d key breaks\n", _pName, m_uItemCount, iMismatches, iBatchBreaks);
+    TEST_CHECK(iMismatches == 0, "%s: %d items out of submission order", _pName, iMismatches);
+    TEST_CHECK(iBatchBreaks == 0, "%s: sorted keys decrease %d times", _pName, iBatchBreaks);
+}
+
+static void test_check_custom_order(void)
+{
+    printf("Custom item order:\n");
+
+    test_submit_frame(200, 12);
+    test_check_sorted_order("sparse custom items", true);
+
+    /* Sprites between two custom items still batch: fewer mode and sprite changes than in submission order */
+    int iRuns = 0;
+    int iSubmittedRuns = 0;
+    const uint16_t *pOrder = render_queue_sort();
+    for (uint16_t i = 0; i < m_uItemCount; ++i)
+    {
+        iRuns += (i == 0 || m_auKey[pOrder[i]] != m_auKey[pOrder[i - 1]]) ? 1 : 0;
+        iSubmittedRuns += (i == 0 || m_auKey[i] != m_auKey[i - 1]) ? 1 : 0;
+    }
+    printf("  %-22s %3d key runs (%d in submission order)\n", "", iRuns, iSubmittedRuns);
+    TEST_CHECK(iRuns * 3 < iSubmittedRuns * 2, "sparse custom items: %d key runs, %d in submission order", iRuns, iSubmittedRuns);
+
+    /* Custom items in submission order at the flush */
+    int aiExpected[RENDER_QUEUE_MAX_ITEMS];
+    int iExpectedCount = 0;
+    for (int iLayer = 0; iLayer < RENDER_LAYER_COUNT; ++iLayer)
+        for (uint16_t i = 0; i < m_uItemCount; ++i)
+            if (m_aItems[i].uLayer == iLayer && m_aItems[i].uMode == RENDER_MODE_CUSTOM)
+                aiExpected[iExpectedCount++] = m_aItems[i].iX;
+    m_iCustomLogCount = 0;
+    render_queue_flush();
+    bool bSame = m_iCustomLogCount == iExpectedCount;
+    for (int i = 0; bSame && i < iExpectedCount; ++i)
+        bSame = m_aiCustomLog[i] == aiExpected[i];
+    TEST_CHECK(bSame, "flush: %d custom calls, not the %d submitted ones in layer and submission order", m_iCustomLogCount, iExpectedCount);
+
+    /* Past the last phase, sprites may move ahead of later custom items */
+    test_submit_frame(400, 3);
+    test_check_sorted_order("dense custom items", false);
+    render_queue_flush();
+}
+
+/* ---------- Counters ---------- */
+
+static void test_check_counts(const char *_pName, uint32_t _uItems, uint32_t _uModes, uint32_t _uLoads)
+{
+    printf("  %-22s RQITEM %4u RQMODE %2u RQLOAD %2u\n", _pName, m_auCounters[PROF_COUNTER_RQ_ITEMS], m_auCounters[PROF_COUNTER_RQ_MODES], m_auCounters[PROF_COUNTER_RQ_LOADS]);
+    TEST_CHECK(m_auCounters[PROF_COUNTER_RQ_ITEMS] == _uItems, "%s: RQITEM %u, expected %u", _pName, m_auCounters[PROF_COUNTER_RQ_ITEMS], _uItems);
+    TEST_CHECK(m_auCounters[PROF_COUNTER_RQ_MODES] == _uModes, "%s: RQMODE %u, expected %u", _pName, m_auCounters[PROF_COUNTER_RQ_MODES], _uModes);
+    TEST_CHECK(m_auCounters[PROF_COUNTER_RQ_LOADS] == _uLoads, "%s: RQLOAD %u, expected %u", _pName, m_auCounters[PROF_COUNTER_RQ_LOADS], _uLoads);
+    memset(m_auCounters, 0, sizeof(m_auCounters));
+}
+
+static void test_check_counters(void)
+{
+    printf("Counters:\n");
+    rdpq_blitparms_t parms = {.scale_x = 1.0f, .scale_y = 1.0f};
+    color_t white = RGBA32(255, 255, 255, 255);
+    memset(m_auCounters, 0, sizeof(m_auCounters));
+
+    /* Immediate run of one sprite (one mode, one upload), then two queued sprites of another */
+    render_queue_begin();
+    render_queue_set_immediate(true);
+    for (int i = 0; i < 4; ++i)
+        render_queue_sprite(RENDER_LAYER_OBJECTS, RENDER_MODE_SPRITE, &m_aSprites[0], i, 0, &parms, white);
+    render_queue_set_immediate(false);
+    for (int i = 0; i < 2; ++i)
+        render_queue_sprite(RENDER_LAYER_OBJECTS, RENDER_MODE_SPRITE, &m_aSprites[1], i, 0, &parms, white);
+    render_queue_flush();
+    test_check_counts("immediate run", 6, 2, 2);
+
+    /* Full queue of one sprite, then an overflowing sprite and custom item */
+    render_queue_begin();
+    g_bHostLibdragonQuiet = true; /* Queue full message */
+    for (int i = 0; i < RENDER_QUEUE_MAX_ITEMS; ++i)
+        render_queue_sprite(RENDER_LAYER_OBJECTS, RENDER_MODE_SPRITE, &m_aSprites[0], i, 0, &parms, white);
+    render_queue_sprite(RENDER_LAYER_OBJECTS, RENDER_MODE_SPRITE, &m_aSprites[0], 0, 0, &parms, white);
+    render_queue_custom(RENDER_LAYER_OBJECTS, test_custom_draw, NULL, 0, 0, 1.0f);
+    g_bHostLibdragonQuiet = false;
+    render_queue_flush();
+    test_check_counts("overflow", RENDER_QUEUE_MAX_ITEMS + 2, 3, 2);
+
+    /* Nothing carried over */
+    render_queue_begin();
+    render_queue_flush();
+    test_check_counts("empty frame", 0, 0, 0);
+}
+
+int main(void)
+{
+    test_sprites_init();
+    test_check_custom_order();
+    test_check_counters();
+
+    printf("%s (%d failures)\n", m_iFailures ? "FAILED" : "OK", m_iFailures);
+    return m_iFailures ? 1 : 0;
+}
@@ -0,0 +1,1253 @@
+/* Headless test of the space object passes (make host-tests).
+ *
+ * Fills the object pool with synthetic meteor fields and checks the optimized paths of space_objects.c
+ * against scans over all objects:
+ * - space_objects_query (circle, annulus, cone, rect bounds, SPACE_QUERY_UNLIMITED radius) returns the same
+ *   set as testing every object, and space_objects_query_nearest the same distances in the same order
+ *   (timings of both are logged, with the queries that test the live objects instead of the grid; unbounded
+ *   radii always do),
+ * - both honor the result limit, the SPACE_QUERY_MAX_K cap, empty rects and objects marked for delete,
+ * - freed slots are reused lowest first, the active list is back in slot order after each update, and objects
+ *   spawned during the logic pass are first updated the next frame,
+ * - space_objects_update (integration, currency damping, sleep and bounces on the object arrays) ends in the
+ *   same state, bit for bit, as the per-record loop it replaced, and the entities mirror the arrays
+ *   (64/256/512 meteors, timings of both are logged); a sleeping meteor moved by a setter is relinked,
+ * - parked meteors drifting in from outside the scanned sectors wake on the update they cross the wake radius,
+ * - the laser raycast hits the same object at the same point as the bounding-box scan it replaced, for beams
+ *   fanned out at laser range, long beams, beams along cell borders and zero-length beams (timings logged),
+ * - space_objects_check_bullet_sweeps hits the same object at the same step fraction as a swept-circle scan
+ *   over all objects, for fast bullets crossing several cells, bullets passing through a meteor within one
+ *   step, bullets on cell borders and corners, and short or resting bullets; each sweep tests every object
+ *   of the 3x3 cells around the cells it crosses, and each only once. In a batch, later bullets pass through
+ *   meteors destroyed by earlier ones.
+ *
+ * Usage: space_objects_test */
+
+#include "../game_objects/space_objects.c"
+#include "test_common.h"
+
+/* The game modules around the object pool are not linked: the test spawns bare meteors, runs no UFO, and
+ * nothing it does loads sounds or draws. Piece updates can spawn meteors, like pieces and NPCs may do. */
+static bool m_bMinimapActive = false;
+static int m_iPieceSpawns = 0; /* Meteors the next piece update spawns */
+static SpaceObject *m_apPieceSpawned[4];
+static int m_aiMeteorDamage[MAX_SPACE_OBJECTS]; /* Damage taken per slot */
+static bool m_bDamageDestroys = false;          /* Every hit destroys the meteor */
+
+float frame_time_mul(void)
+{
+    return 1.0f;
+}
+
+bool minimap_is_active(void)
+{
+    return m_bMinimapActive;
+}
+
+bool anim_effects_play(eAnimEffectType _eType, struct vec2 _vPos)
+{
+    (void)_eType;
+    (void)_vPos;
+    return false;
+}
+
+void audio_sound_group_init_impl(audio_sound_group_t *group, const char **paths, int count, int channel, wav64_t **sound_array)
+{
+    (void)group;
+    (void)paths;
+    (void)count;
+    (void)channel;
+    (void)sound_array;
+}
+
+void audio_sound_group_play_random(audio_sound_group_t *group, bool stop_current)
+{
+    (void)group;
+    (void)stop_current;
+}
+
+void audio_sound_group_free(audio_sound_group_t *group)
+{
+    (void)group;
+}
+
+void render_queue_custom(render_layer_t _eLayer, render_queue_draw_fn_t _fnDraw, void *_pContext, int _iX, int _iY, float _fScale)
+{
+    (void)_eLayer;
+    (void)_fnDraw;
+    (void)_pContext;
+    (void)_iX;
+    (void)_iY;
+    (void)_fScale;
+}
+
+void render_queue_set_immediate(bool _bImmediate)
+{
+    (void)_bImmediate;
+}
+
+void meteors_init(void)
+{
+}
+
+void meteors_free(void)
+{
+}
+
+void meteor_render_object(SpaceObject *obj, struct vec2i vScreen, float fZoom)
+{
+    (void)obj;
+    (void)vScreen;
+    (void)fZoom;
+}
+
+void meteor_apply_damage(SpaceObject *obj, int iDamage, struct vec2 vImpactDir)
+{
+    (void)vImpactDir;
+    m_aiMeteorDamage[obj - s_objects] += iDamage;
+    if (m_bDamageDestroys)
+        obj->markForDelete = true;
+}
+
+void npc_handler_init(void)
+{
+}
+
+void npc_alien_destroy(NpcAlienInstance *pInstance)
+{
+    (void)pInstance;
+}
+
+void npc_alien_update_object(SpaceObject *pInstance)
+{
+    (void)pInstance;
+}
+
+void npc_alien_render_object(SpaceObject *pInstance, struct vec2i vScreen, float fZoom)
+{
+    (void)pInstance;
+    (void)vScreen;
+    (void)fZoom;
+}
+
+void satellite_pieces_init(void)
+{
+}
+
+void satellite_pieces_free(void)
+{
+}
+
+void satellite_pieces_check_center_collision(void)
+{
+}
+
+void satellite_piece_update_object(SpaceObject *obj)
+{
+    (void)obj;
+    for (int i = 0; i < m_iPieceSpawns; i++)
+        m_apPieceSpawned[i] = space_objects_spawn_meteor(vec2_make(2000.0f + (float)i * 100.0f, 0.0f));
+    m_iPieceSpawns = 0;
+}
+
+void satellite_piece_render_object(SpaceObject *obj, struct vec2i vScreen, float fZoom)
+{
+    (void)obj;
+    (void)vScreen;
+    (void)fZoom;
+}
+
+void satellite_piece_collect(SpaceObject *obj)
+{
+    (void)obj;
+}
+
+bool tractor_beam_is_active(void)
+{
+    return false;
+}
+
+const struct entity2D *ufo_get_entity(void)
+{
+    return NULL;
+}
+
+struct vec2 ufo_get_velocity(void)
+{
+    return vec2_zero();
+}
+
+void ufo_set_position(struct vec2 _vPos)
+{
+    (void)_vPos;
+}
+
+void ufo_set_velocity(struct vec2 _vVel)
+{
+    (void)_vVel;
+}
+
+void ufo_apply_bounce_effect(uint32_t _uDurationMs)
+{
+    (void)_uDurationMs;
+}
+
+void ufo_deselect_entity_lock_and_marker(const struct entity2D *_pEntity)
+{
+    (void)_pEntity;
+}
+
+static float test_randf(uint32_t *_pSeed)
+{
+    *_pSeed = *_pSeed * 1664525u + 1013904223u;
+    return (float)(*_pSeed >> 8) * (1.0f / 16777216.0f);
+}
+
+/* Empty pool, then _uCount meteors (radius 12) at random positions in a _fWidth x _fHeight field */
+static void test_spawn_field(uint16_t _uCount, float _fWidth, float _fHeight, uint32_t _uSeed)
+{
+    space_objects_clear();
+    for (uint16_t i = 0; i < _uCount; i++)
+    {
+        float fX = test_randf(&_uSeed) * _fWidth;
+        float fY = test_randf(&_uSeed) * _fHeight;
+        SpaceObject *obj = space_objects_spawn_meteor(vec2_make(fX, fY));
+        if (!obj)
+            break;
+        obj->entity.iCollisionRadius = 12;
+    }
+}
+
+/* Reference: every allocated object through the same match test, all matches (_uK == 0) or the _uK nearest
+ * sorted by distance. Returns the count. */
+static uint16_t test_query_reference(const SpaceQuery *_pQuery, uint16_t _uK, uint16_t *_pOutIndices, float *_pOutDistSq)
+{
+    uint16_t uCount = 0;
+    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+    {
+        float fDistSq;
+        if (!s_objects[i].bAllocated || s_objects[i].markForDelete || !entity2d_is_active(&s_objects[i].entity) ||
+            !space_query_match(_pQuery, &s_objects[i], &fDistSq))
+            continue;
+        if (!_uK)
+        {
+            _pOutIndices[uCount++] = (uint16_t)i;
+            continue;
+        }
+        if (uCount == _uK && fDistSq >= _pOutDistSq[_uK - 1])
+            continue;
+        int iPos = (uCount < _uK) ? uCount++ : _uK - 1;
+        while (iPos > 0 && _pOutDistSq[iPos - 1] > fDistSq)
+        {
+            _pOutDistSq[iPos] = _pOutDistSq[iPos - 1];
+            _pOutIndices[iPos] = _pOutIndices[iPos - 1];
+            iPos--;
+        }
+        _pOutDistSq[iPos] = fDistSq;
+        _pOutIndices[iPos] = (uint16_t)i;
+    }
+    return uCount;
+}
+
+typedef enum
+{
+    TEST_QUERY_CIRCLE,
+    TEST_QUERY_ANNULUS,
+    TEST_QUERY_CONE,
+    TEST_QUERY_BOUNDS,
+    TEST_QUERY_UNLIMITED,
+    TEST_QUERY_UNLIMITED_CONE,
+    TEST_QUERY_NEAREST_1,
+    TEST_QUERY_NEAREST_8,
+    TEST_QUERY_NEAREST_UNLIMITED,
+    TEST_QUERY_NEAREST_ON_SCREEN,
+    TEST_QUERY_NEAREST_VIEWCONE,
+    TEST_QUERY_COUNT
+} test_query_type_t;
+
+static const char *const m_apQueryNames[TEST_QUERY_COUNT] = {
+    "circle",    "annulus",           "cone",         "bounds",         "unlimited", "unlimited-cone",
+    "nearest-1", "nearest-8",         "nearest-all",  "nearest-screen", "nearest-viewcone",
+};
+
+/* Query of _eType around _vCenter; returns k for the nearest types, 0 for the all-matches types */
+static uint16_t test_make_query(test_query_type_t _eType, struct vec2 _vCenter, float _fAngle, SpaceQuery *_pQuery)
+{
+    switch (_eType)
+    {
+    case TEST_QUERY_CIRCLE:
+        space_query_circle(_pQuery, _vCenter, 96.0f);
+        return 0;
+    case TEST_QUERY_ANNULUS:
+        space_query_annulus(_pQuery, _vCenter, 26.0f, 320.0f);
+        return 0;
+    case TEST_QUERY_CONE:
+        space_query_cone(_pQuery, _vCenter, _fAngle, 0.5f, 320.0f);
+        return 0;
+    case TEST_QUERY_BOUNDS:
+        space_query_circle(_pQuery, _vCenter, 200.0f);
+        space_query_set_bounds(_pQuery, _vCenter.fX - 60.0f, _vCenter.fX + 250.0f, _vCenter.fY - 150.0f, _vCenter.fY + 40.0f);
+        return 0;
+    case TEST_QUERY_UNLIMITED:
+        space_query_circle(_pQuery, _vCenter, SPACE_QUERY_UNLIMITED);
+        return 0;
+    case TEST_QUERY_UNLIMITED_CONE:
+        space_query_cone(_pQuery, _vCenter, _fAngle, 0.3f, SPACE_QUERY_UNLIMITED);
+        return 0;
+    case TEST_QUERY_NEAREST_1:
+        space_query_circle(_pQuery, _vCenter, 160.0f);
+        return 1;
+    case TEST_QUERY_NEAREST_8:
+        space_query_circle(_pQuery, _vCenter, 400.0f);
+        return 8;
+    case TEST_QUERY_NEAREST_UNLIMITED:
+        space_query_circle(_pQuery, _vCenter, SPACE_QUERY_UNLIMITED);
+        return SPACE_QUERY_MAX_K;
+    case TEST_QUERY_NEAREST_ON_SCREEN:
+        /* space_objects_get_closest_entity_on_screen */
+        space_query_circle(_pQuery, _vCenter, SPACE_QUERY_UNLIMITED);
+        space_query_set_bounds(_pQuery, _vCenter.fX - 176.0f, _vCenter.fX + 176.0f, _vCenter.fY - 136.0f, _vCenter.fY + 136.0f);
+        return 1;
+    default:
+        /* space_objects_get_closest_entity_in_viewcone */
+        space_query_cone(_pQuery, _vCenter, _fAngle, 0.4f, SPACE_QUERY_UNLIMITED);
+        space_query_set_bounds(_pQuery, _vCenter.fX - 176.0f, _vCenter.fX + 176.0f, _vCenter.fY - 136.0f, _vCenter.fY + 136.0f);
+        return 1;
+    }
+}
+
+/* 64 queries of each type over the current field, grid vs. reference. Centers are spread over the field
+ * and a margin around it; _pName labels the field in the log. */
+static void test_check_queries(const char *_pName, float _fWidth, float _fHeight)
+{
+    static uint16_t s_auGrid[MAX_SPACE_OBJECTS];
+    static uint16_t s_auScan[MAX_SPACE_OBJECTS];
+    float afScanDistSq[SPACE_QUERY_MAX_K];
+    const int iQueries = 64;
+
+    printf("  %s:\n", _pName);
+    for (int iType = 0; iType < TEST_QUERY_COUNT; iType++)
+    {
+        uint32_t uSeed = 0x85EBCA6Bu + (uint32_t)iType;
+        uint64_t uGridUs = 0;
+        uint64_t uScanUs = 0;
+        uint32_t uResults = 0;
+        int iMismatches = 0;
+        int iScanned = 0;
+        for (int q = 0; q < iQueries; q++)
+        {
+            struct vec2 vCenter = vec2_make(test_randf(&uSeed) * (_fWidth + 400.0f) - 200.0f, test_randf(&uSeed) * (_fHeight + 400.0f) - 200.0f);
+            SpaceQuery query;
+            uint16_t uK = test_make_query((test_query_type_t)iType, vCenter, (float)q * 0.37f, &query);
+            int iMinX, iMaxX, iMinY, iMaxY;
+            iScanned += space_query_cell_range(&query, uK, &iMinX, &iMaxX, &iMinY, &iMaxY) ? 1 : 0;
+
+            uint64_t uStartUs = get_ticks_us();
+            uint16_t uGridCount = uK ? space_objects_query_nearest(&query, uK, s_auGrid) : space_objects_query(&query, s_auGrid, MAX_SPACE_OBJECTS);
+            uGridUs += get_ticks_us() - uStartUs;
+
+            uStartUs = get_ticks_us();
+            uint16_t uScanCount = test_query_reference(&query, uK, s_auScan, afScanDistSq);
+            uScanUs += get_ticks_us() - uStartUs;
+
+            uResults += uGridCount;
+            bool bMatch = (uGridCount == uScanCount);
+            if (bMatch && uK)
+            {
+                /* Same distances in the same order (equidistant objects may swap) */
+                for (uint16_t i = 0; i < uGridCount && bMatch; i++)
+                    bMatch = (vec2_dist_sq(s_objects[s_auGrid[i]].entity.vPos, vCenter) == afScanDistSq[i]);
+            }
+            else if (bMatch)
+            {
+                /* Same set: stamp the scan results, every grid result must carry the stamp once */
+                space_query_stamp_next();
+                for (uint16_t i = 0; i < uScanCount; i++)
+                    s_queryStamp[s_auScan[i]] = s_queryStampCounter;
+                for (uint16_t i = 0; i < uGridCount && bMatch; i++)
+                {
+                    bMatch = (s_queryStamp[s_auGrid[i]] == s_queryStampCounter);
+                    s_queryStamp[s_auGrid[i]] = 0;
+                }
+            }
+            if (!bMatch && iMismatches < 4)
+                TEST_CHECK(false,
+                           "%s %s at (%.1f, %.1f): grid %u results, scan %u results",
+                           _pName,
+                           m_apQueryNames[iType],
+                           vCenter.fX,
+                           vCenter.fY,
+                           uGridCount,
+                           uScanCount);
+            if (!bMatch)
+                iMismatches++;
+        }
+
+        TEST_CHECK(iMismatches == 0, "%s %s: %d of %d queries differ from the scan", _pName, m_apQueryNames[iType], iMismatches, iQueries);
+        if (iType == TEST_QUERY_UNLIMITED || iType == TEST_QUERY_UNLIMITED_CONE)
+            TEST_CHECK(iScanned == iQueries, "%s %s: %d of %d unbounded queries walk the grid instead of the live objects", _pName, m_apQueryNames[iType], iQueries - iScanned, iQueries);
+        printf("    %-16s %d queries (%2d scanned), %5lu results, query %5lu us, scan %5lu us\n",
+               m_apQueryNames[iType],
+               iQueries,
+               iScanned,
+               (unsigned long)uResults,
+               (unsigned long)uGridUs,
+               (unsigned long)uScanUs);
+    }
+}
+
+/* Result buffer limits and empty results */
+static void test_check_query_limits(void)
+{
+    test_spawn_field(64, 320.0f, 240.0f, 0x1B873593u);
+    space_objects_gather_hot();
+
+    SpaceQuery query;
+    uint16_t auIndices[MAX_SPACE_OBJECTS];
+    float afDistSq[SPACE_QUERY_MAX_K];
+    space_query_circle(&query, vec2_make(160.0f, 120.0f), SPACE_QUERY_UNLIMITED);
+    uint16_t uCount = space_objects_query(&query, auIndices, 10);
+    TEST_CHECK(uCount == 10, "query stopped at %u of 10 results", uCount);
+    for (uint16_t i = 0; i < uCount; i++)
+    {
+        float fDistSq;
+        TEST_CHECK(space_query_match(&query, &s_objects[auIndices[i]], &fDistSq), "limited query result %u does not match", auIndices[i]);
+    }
+
+    uCount = space_objects_query_nearest(&query, SPACE_QUERY_MAX_K + 8, auIndices);
+    TEST_CHECK(uCount == SPACE_QUERY_MAX_K, "nearest returned %u, expected the SPACE_QUERY_MAX_K cap", uCount);
+    uint16_t uScanCount = test_query_reference(&query, SPACE_QUERY_MAX_K, auIndices + SPACE_QUERY_MAX_K, afDistSq);
+    for (uint16_t i = 0; i < uCount && i < uScanCount; i++)
+        TEST_CHECK(vec2_dist_sq(s_objects[auIndices[i]].entity.vPos, query.vCenter) == afDistSq[i], "capped nearest result %u out of order", i);
+
+    /* Nothing in the rect: no results, also for the unlimited radius */
+    space_query_set_bounds(&query, 5000.0f, 5100.0f, 5000.0f, 5100.0f);
+    TEST_CHECK(space_objects_query(&query, auIndices, MAX_SPACE_OBJECTS) == 0, "query found objects in an empty rect");
+    TEST_CHECK(space_objects_query_nearest(&query, 4, auIndices) == 0, "nearest found objects in an empty rect");
+
+    /* Objects marked for delete are skipped before the next compaction */
+    space_query_circle(&query, vec2_make(160.0f, 120.0f), SPACE_QUERY_UNLIMITED);
+    for (int k = 0; k < s_aliveCount; k += 2)
+        s_objects[s_auActive[k]].markForDelete = true;
+    uCount = space_objects_query(&query, auIndices, MAX_SPACE_OBJECTS);
+    TEST_CHECK(uCount == 32, "query returned %u objects, expected the 32 not marked for delete", uCount);
+
+    space_objects_clear();
+}
+
+/* Per-slot state of the record reference that the records no longer carry */
+static bool m_abRefSleeping[MAX_SPACE_OBJECTS];
+static int m_aiRefFramesAlive[MAX_SPACE_OBJECTS];
+
+/* Meteor field for the update benchmark at one meteor per 40x40 px: random drift, every 16th meteor at rest
+ * (falls asleep after the cooldown), every 8th a slow currency meteor (damped until it sleeps) */
+static void test_spawn_update_field(uint16_t _uCount)
+{
+    float fSide = sqrtf((float)_uCount) * 40.0f;
+    uint32_t uSeed = 0x2545F491u;
+
+    space_objects_clear();
+    for (uint16_t i = 0; i < _uCount; i++)
+    {
+        float fX = test_randf(&uSeed) * fSide;
+        float fY = test_randf(&uSeed) * fSide;
+        struct vec2 vVel = vec2_make(test_randf(&uSeed) * 2.0f - 1.0f, test_randf(&uSeed) * 2.0f - 1.0f);
+        SpaceObject *obj = space_objects_spawn_meteor(vec2_make(fX, fY));
+        if (!obj)
+            break;
+        obj->entity.iCollisionRadius = 12;
+        if (i % 8 == 0)
+        {
+            obj->pData->meteor.uCurrencyId = 1;
+            vVel = vec2_scale(vVel, 0.05f);
+        }
+        else if (i % 16 == 4)
+        {
+            vVel = vec2_zero();
+        }
+        space_object_set_velocity(obj, vVel);
+        m_abRefSleeping[i] = false;
+        m_aiRefFramesAlive[i] = 0;
+    }
+}
+
+/* Reference: elastic bounce on the records */
+static void test_resolve_reference(SpaceObject *a, SpaceObject *b)
+{
+    struct vec2 vDelta = vec2_sub(b->entity.vPos, a->entity.vPos);
+    float fDistSq = vec2_mag_sq(vDelta);
+    float fRadSum = (float)(a->entity.iCollisionRadius + b->entity.iCollisionRadius);
+    if (fDistSq >= fRadSum * fRadSum || fDistSq <= 1e-6f)
+        return;
+
+    float fDist = sqrtf(fDistSq);
+    struct vec2 vNormal = vec2_scale(vDelta, 1.0f / fDist);
+    struct vec2 vCorrection = vec2_scale(vNormal, (fRadSum - fDist) * 0.5f);
+    a->entity.vPos = vec2_sub(a->entity.vPos, vCorrection);
+    b->entity.vPos = vec2_add(b->entity.vPos, vCorrection);
+
+    struct vec2 vProjA = vec2_scale(vNormal, vec2_dot(a->entity.vVel, vNormal));
+    struct vec2 vProjB = vec2_scale(vNormal, vec2_dot(b->entity.vVel, vNormal));
+    a->entity.vVel = vec2_add(vec2_sub(a->entity.vVel, vProjA), vProjB);
+    b->entity.vVel = vec2_add(vec2_sub(b->entity.vVel, vProjB), vProjA);
+
+    m_abRefSleeping[a - s_objects] = false;
+    m_abRefSleeping[b - s_objects] = false;
+}
+
+/* Reference frame on the records of a field spawned in slot order, as space_objects_update ran it before the
+ * object arrays: compaction and dormancy, meteor logic with integration, currency damping and sleep per
+ * record, grid update, then the pair loop over the records */
+static void test_update_reference(uint16_t _uCount)
+{
+    space_objects_compact();
+    space_objects_update_dormancy();
+
+    for (uint16_t i = 0; i < _uCount; i++)
+    {
+        SpaceObject *obj = &s_objects[i];
+        obj->entity.fAngleRad = angle_wrap_rad(obj->entity.fAngleRad + obj->pData->meteor.fRotationSpeed * 1.0f);
+        if (obj->pData->meteor.fTintFrames > 0.0f)
+            obj->pData->meteor.fTintFrames = fmaxf(obj->pData->meteor.fTintFrames - 1.0f, 0.0f);
+
+        if (!m_abRefSleeping[i])
+            obj->entity.vPos = vec2_add(obj->entity.vPos, vec2_scale(obj->entity.vVel, 1.0f));
+        if (obj->pData->meteor.uCurrencyId > 0 && !m_abRefSleeping[i])
+        {
+            obj->entity.vVel = vec2_scale(obj->entity.vVel, powf(METEOR_CURRENCY_VELOCITY_DAMPING, 1.0f));
+            if (vec2_mag_sq(obj->entity.vVel) <= METEOR_CURRENCY_SLEEP_VEL_SQ)
+            {
+                obj->entity.vVel = vec2_zero();
+                m_abRefSleeping[i] = true;
+            }
+        }
+        if (m_aiRefFramesAlive[i] < METEOR_SLEEP_COOLDOWN_FRAMES)
+            m_aiRefFramesAlive[i]++;
+        if (m_aiRefFramesAlive[i] >= METEOR_SLEEP_COOLDOWN_FRAMES && vec2_mag_sq(obj->entity.vVel) < 1e-6f)
+            m_abRefSleeping[i] = true;
+    }
+
+    for (uint16_t i = 0; i < _uCount; i++)
+    {
+        int iCellX = (int)fm_floorf(s_objects[i].entity.vPos.fX / SPACE_GRID_CELL);
+        int iCellY = (int)fm_floorf(s_objects[i].entity.vPos.fY / SPACE_GRID_CELL);
+        if (s_hot.aiBucket[i] >= 0)
+        {
+            if (s_hot.aiCellX[i] == iCellX && s_hot.aiCellY[i] == iCellY)
+                continue;
+            space_grid_unlink(i);
+        }
+        space_grid_link(i, space_hash_cell(iCellX, iCellY), iCellX, iCellY);
+    }
+
+    for (uint16_t i = 0; i < _uCount; i++)
+    {
+        SpaceObject *a = &s_objects[i];
+        int iCellX = (int)fm_floorf(a->entity.vPos.fX / SPACE_GRID_CELL);
+        int iCellY = (int)fm_floorf(a->entity.vPos.fY / SPACE_GRID_CELL);
+        for (int iCx = iCellX - 1; iCx <= iCellX + 1; iCx++)
+            for (int iCy = iCellY - 1; iCy <= iCellY + 1; iCy++)
+                for (int j = s_gridHead[space_hash_cell(iCx, iCy)]; j != -1; j = s_hot.aiNextInCell[j])
+                {
+                    if (j <= (int)i || (m_abRefSleeping[i] && m_abRefSleeping[j]))
+                        continue;
+                    test_resolve_reference(a, &s_objects[j]);
+                }
+    }
+}
+
+/* space_objects_update on the object arrays against the record reference from the same start state: final
+ * position, velocity and sleep state bit for bit, and the entity mirrors (timings of both are logged) */
+static void test_check_update(uint16_t _uCount)
+{
+    const int iFrames = 128;
+    bool abRefSleeping[MAX_SPACE_OBJECTS];
+    struct vec2 *pRefState = (struct vec2 *)malloc(sizeof(struct vec2) * 2 * _uCount);
+    if (!pRefState)
+    {
+        TEST_CHECK(false, "%u meteors: out of memory", _uCount);
+        return;
+    }
+
+    test_spawn_update_field(_uCount);
+    uint64_t uStartUs = get_ticks_us();
+    for (int iFrame = 0; iFrame < iFrames; iFrame++)
+        test_update_reference(_uCount);
+    uint64_t uRefUs = get_ticks_us() - uStartUs;
+    int iRefSleeping = 0;
+    for (uint16_t i = 0; i < _uCount; i++)
+    {
+        pRefState[i] = s_objects[i].entity.vPos;
+        pRefState[_uCount + i] = s_objects[i].entity.vVel;
+        abRefSleeping[i] = m_abRefSleeping[i];
+        iRefSleeping += m_abRefSleeping[i] ? 1 : 0;
+    }
+
+    test_spawn_update_field(_uCount);
+    uStartUs = get_ticks_us();
+    for (int iFrame = 0; iFrame < iFrames; iFrame++)
+        space_objects_update();
+    uint64_t uUpdateUs = get_ticks_us() - uStartUs;
+
+    int iMismatches = 0;
+    int iMirrorMismatches = 0;
+    for (uint16_t i = 0; i < _uCount; i++)
+    {
+        bool bMatch = s_hot.afPosX[i] == pRefState[i].fX && s_hot.afPosY[i] == pRefState[i].fY && s_hot.afVelX[i] == pRefState[_uCount + i].fX &&
+                      s_hot.afVelY[i] == pRefState[_uCount + i].fY && space_object_is_sleeping(&s_objects[i]) == abRefSleeping[i];
+        if (!bMatch && iMismatches < 4)
+            TEST_CHECK(false,
+                       "%u meteors, slot %u: (%.3f, %.3f) v (%.4f, %.4f), reference (%.3f, %.3f) v (%.4f, %.4f)",
+                       _uCount,
+                       i,
+                       s_hot.afPosX[i],
+                       s_hot.afPosY[i],
+                       s_hot.afVelX[i],
+                       s_hot.afVelY[i],
+                       pRefState[i].fX,
+                       pRefState[i].fY,
+                       pRefState[_uCount + i].fX,
+                       pRefState[_uCount + i].fY);
+        if (!bMatch)
+            iMismatches++;
+        if (s_objects[i].entity.vPos.fX != s_hot.afPosX[i] || s_objects[i].entity.vPos.fY != s_hot.afPosY[i] || s_objects[i].entity.vVel.fX != s_hot.afVelX[i] ||
+            s_objects[i].entity.vVel.fY != s_hot.afVelY[i])
+            iMirrorMismatches++;
+    }
+    TEST_CHECK(iMismatches == 0, "%u meteors: %d differ from the record reference", _uCount, iMismatches);
+    TEST_CHECK(iMirrorMismatches == 0, "%u meteors: %d entities do not mirror the arrays", _uCount, iMirrorMismatches);
+    printf("  %3u meteors, %d frames (%d asleep at the end): records %lu us/frame, arrays %lu us/frame\n",
+           _uCount,
+           iFrames,
+           iRefSleeping,
+           (unsigned long)(uRefUs / (uint64_t)iFrames),
+           (unsigned long)(uUpdateUs / (uint64_t)iFrames));
+
+    free(pRefState);
+    space_objects_clear();
+}
+
+/* A sleeping meteor moved by space_object_set_position is relinked at its new cell and stays asleep */
+static void test_check_setter_relink(void)
+{
+    space_objects_clear();
+    SpaceObject *obj = space_objects_spawn_meteor(vec2_make(100.0f, 100.0f));
+    obj->entity.iCollisionRadius = 12;
+    for (int iFrame = 0; iFrame <= METEOR_SLEEP_COOLDOWN_FRAMES; iFrame++)
+        space_objects_update();
+    TEST_CHECK(space_object_is_sleeping(obj), "meteor at rest not asleep after the sleep cooldown");
+
+    space_object_set_position(obj, vec2_make(1000.0f, 700.0f));
+    space_objects_update();
+
+    SpaceQuery query;
+    uint16_t auIndices[4];
+    space_query_circle(&query, vec2_make(1000.0f, 700.0f), 20.0f);
+    TEST_CHECK(space_objects_query(&query, auIndices, 4) == 1, "sleeping meteor not found where the setter moved it");
+    space_query_circle(&query, vec2_make(100.0f, 100.0f), 20.0f);
+    TEST_CHECK(space_objects_query(&query, auIndices, 4) == 0, "sleeping meteor still found where it was");
+    TEST_CHECK(space_object_is_sleeping(obj), "moved meteor woke up");
+
+    space_objects_clear();
+}
+
+/* Slot order of the active list after an update */
+static bool test_active_in_slot_order(void)
+{
+    for (int k = 1; k < s_aliveCount; k++)
+    {
+        if (s_auActive[k] <= s_auActive[k - 1])
+            return false;
+    }
+    return true;
+}
+
+/* Freed slots are reused lowest first, the logic pass runs in slot order, and objects spawned during it (below
+ * and above the spawning object) are first updated the next frame */
+static void test_check_active_order(void)
+{
+    space_objects_clear();
+    for (int i = 0; i < 8; i++)
+        space_objects_spawn_meteor(vec2_make((float)i * 100.0f, 0.0f));
+    s_objects[5].markForDelete = true;
+    s_objects[2].markForDelete = true;
+    space_objects_update();
+    TEST_CHECK(s_aliveCount == 6 && test_active_in_slot_order(), "active list not in slot order after deletes");
+
+    SpaceObject *pFirst = space_objects_spawn_meteor(vec2_make(0.0f, 500.0f));
+    SpaceObject *pSecond = space_objects_spawn_meteor(vec2_make(100.0f, 500.0f));
+    TEST_CHECK(pFirst == &s_objects[2] && pSecond == &s_objects[5], "freed slots not reused lowest first");
+    space_objects_update();
+    TEST_CHECK(s_aliveCount == 8 && test_active_in_slot_order(), "spawned objects not sorted in by the next update");
+
+    /* A piece in slot 3 spawns into the free slot 1 and into slot 8 during the logic pass */
+    s_objects[1].markForDelete = true;
+    s_objects[3].type = SO_PIECE;
+    m_iPieceSpawns = 2;
+    space_objects_update();
+    TEST_CHECK(m_apPieceSpawned[0] == &s_objects[1] && m_apPieceSpawned[1] == &s_objects[8], "piece spawns not in slots 1 and 8");
+    TEST_CHECK(m_apPieceSpawned[0]->pData->meteor.iFramesAlive == 0 && m_apPieceSpawned[1]->pData->meteor.iFramesAlive == 0,
+               "meteors spawned during the logic pass were updated the same frame");
+    space_objects_update();
+    TEST_CHECK(m_apPieceSpawned[0]->pData->meteor.iFramesAlive == 1 && m_apPieceSpawned[1]->pData->meteor.iFramesAlive == 1,
+               "meteors spawned during the logic pass not updated the next frame");
+    TEST_CHECK(s_aliveCount == 9 && test_active_in_slot_order(), "active list not in slot order after spawns during the pass");
+
+    space_objects_clear();
+}
+
+/* Parked meteors drifting towards the camera from sectors outside the wake radius (along X, along the diagonal,
+ * and along Y faster than a sweep over all buckets lets records drift) wake on the update their caught-up
+ * position crosses the wake radius, where the live meteor continues the drift. Positions and velocities are
+ * whole pixels, so catching up in steps is exact. The sectors scanned beyond the wake radius stay bounded. */
+static void test_check_dormant_drift(void)
+{
+    static sprite_t meteorSprite = {.width = 24, .height = 24};
+    const struct vec2 avStart[3] = {{3000.0f, 40.0f}, {-2200.0f, -2160.0f}, {-20.0f, -7000.0f}};
+    const struct vec2 avVel[3] = {{-4.0f, 0.0f}, {3.0f, 3.0f}, {0.0f, 40.0f}};
+    const float fHalfX = (float)g_mainCamera.vHalf.iX / camera_get_zoom(&g_mainCamera);
+    const float fHalfY = (float)g_mainCamera.vHalf.iY / camera_get_zoom(&g_mainCamera);
+    const float fWakeRadius = sqrtf(fHalfX * fHalfX + fHalfY * fHalfY) + SPACE_DORMANT_WAKE_MARGIN;
+
+    space_objects_clear();
+    int aiWakeUpdate[3];
+    for (int m = 0; m < 3; m++)
+    {
+        SpaceObject *obj = space_objects_spawn_meteor(avStart[m]);
+        obj->entity.pSprite = &meteorSprite;
+        obj->entity.iCollisionRadius = 12;
+        space_object_set_velocity(obj, avVel[m]);
+
+        /* First update whose dormancy pass (run at clock n) sees the meteor inside the wake radius */
+        aiWakeUpdate[m] = -1;
+        for (int n = 0; n < 2000 && aiWakeUpdate[m] < 0; n++)
+        {
+            if (vec2_dist_sq(vec2_add(avStart[m], vec2_scale(avVel[m], (float)n)), g_mainCamera.vPos) <= fWakeRadius * fWakeRadius)
+                aiWakeUpdate[m] = n;
+        }
+    }
+
+    space_objects_update();
+    TEST_CHECK(space_objects_get_dormant_count() == 3, "drifting meteors not parked (%d records)", space_objects_get_dormant_count());
+
+    int aiWoken[3] = {-1, -1, -1};
+    float fMaxLag = 0.0f;
+    for (int n = 1; n < 2000 && (aiWoken[0] < 0 || aiWoken[1] < 0 || aiWoken[2] < 0); n++)
+    {
+        space_objects_update();
+        if (s_fDormantClock - s_fDormantSectorClock > fMaxLag)
+            fMaxLag = s_fDormantClock - s_fDormantSectorClock;
+        for (int k = 0; k < s_aliveCount; k++)
+        {
+            SpaceObject *obj = &s_objects[s_auActive[k]];
+            if (obj->type != SO_METEOR || obj->markForDelete)
+                continue;
+            int m = (obj->entity.vVel.fX < 0.0f) ? 0 : ((obj->entity.vVel.fX > 0.0f) ? 1 : 2);
+            if (aiWoken[m] >= 0)
+                continue;
+            aiWoken[m] = n;
+            struct vec2 vExpected = vec2_add(avStart[m], vec2_scale(avVel[m], (float)(n + 1)));
+            TEST_CHECK(obj->entity.vPos.fX == vExpected.fX && obj->entity.vPos.fY == vExpected.fY,
+                       "meteor %d woke at (%.1f, %.1f), drift puts it at (%.1f, %.1f)",
+                       m,
+                       obj->entity.vPos.fX,
+                       obj->entity.vPos.fY,
+                       vExpected.fX,
+                       vExpected.fY);
+        }
+    }
+    for (int m = 0; m < 3; m++)
+        TEST_CHECK(aiWoken[m] == aiWakeUpdate[m], "meteor %d woke on update %d, crossed the wake radius on update %d", m, aiWoken[m], aiWakeUpdate[m]);
+    TEST_CHECK(fMaxLag <= 2.0f * SPACE_SECTOR_BUCKETS / SPACE_DORMANT_SWEEP_BUCKETS,
+               "records left in their sectors for up to %.0f frames, sweeps cover all buckets every %d",
+               fMaxLag,
+               SPACE_SECTOR_BUCKETS / SPACE_DORMANT_SWEEP_BUCKETS);
+    printf("  dormant drift: woken on updates %d, %d and %d, sectors up to %.0f frames old\n", aiWoken[0], aiWoken[1], aiWoken[2], fMaxLag);
+
+    space_objects_clear();
+}
+
+/* ---------- Laser raycast ---------- */
+
+/* Laser query as it was before the raycast: every object in the grid cells of the segment's bounding box
+ * (grown by 16 px), sqrtf and normalize per candidate */
+static bool test_laser_reference(struct vec2 vStart, struct vec2 vEnd, struct vec2 *pOutHitPoint, SpaceObject **ppOutTarget)
+{
+    if (!pOutHitPoint || !ppOutTarget)
+        return false;
+
+    if (s_aliveCount == 0)
+        return false;
+
+    bool bFoundHit = false;
+    float fClosestDistSq = 0.0f;
+    struct vec2 vClosestHit = vEnd;
+    SpaceObject *pClosestTarget = NULL;
+
+    /* Calculate bounding box of line segment for spatial grid optimization */
+    float fMinX = (vStart.fX < vEnd.fX) ? vStart.fX : vEnd.fX;
+    float fMaxX = (vStart.fX > vEnd.fX) ? vStart.fX : vEnd.fX;
+    float fMinY = (vStart.fY < vEnd.fY) ? vStart.fY : vEnd.fY;
+    float fMaxY = (vStart.fY > vEnd.fY) ? vStart.fY : vEnd.fY;
+
+    /* Expand by max radius (assuming 16 for safety, meteors are 12) */
+    float fMaxRadius = 16.0f;
+    fMinX -= fMaxRadius;
+    fMaxX += fMaxRadius;
+    fMinY -= fMaxRadius;
+    fMaxY += fMaxRadius;
+
+    /* Calculate grid cells covered by the bounding box */
+    int iMinCellX, iMaxCellX, iMinCellY, iMaxCellY;
+    space_calc_grid_bounds(fMinX, fMaxX, fMinY, fMaxY, &iMinCellX, &iMaxCellX, &iMinCellY, &iMaxCellY);
+
+    /* Check all objects in the grid cells covered by the line */
+    SPACE_GRID_LOOP(iMinCellX, iMaxCellX, iMinCellY, iMaxCellY, obj)
+    {
+        /* Line vs Circle intersection check (inline to avoid dependency on meteor function) */
+        struct vec2 vLine = vec2_sub(vEnd, vStart);
+        float fLineLenSq = vec2_mag_sq(vLine);
+        bool bIntersect = false;
+        struct vec2 vHit = vStart;
+
+        if (fLineLenSq <= 1e-6f)
+        {
+            if (vec2_dist_sq(vStart, obj->entity.vPos) <= (float)(obj->entity.iCollisionRadius * obj->entity.iCollisionRadius))
+            {
+                bIntersect = true;
+                vHit = vStart;
+            }
+        }
+        else
+        {
+            float fLineLen = sqrtf(fLineLenSq);
+            struct vec2 vLineDir = vec2_scale(vLine, 1.0f / fLineLen);
+            struct vec2 vToCenter = vec2_sub(obj->entity.vPos, vStart);
+            float fProj = vec2_dot(vToCenter, vLineDir);
+            float fClampedProj = (fProj < 0.0f) ? 0.0f : ((fProj > fLineLen) ? fLineLen : fProj);
+            struct vec2 vClosest = vec2_add(vStart, vec2_scale(vLineDir, fClampedProj));
+            if (vec2_dist_sq(vClosest, obj->entity.vPos) <= (float)(obj->entity.iCollisionRadius * obj->entity.iCollisionRadius))
+            {
+                bIntersect = true;
+                vHit = vClosest;
+            }
+        }
+
+        if (bIntersect)
+        {
+            float fDistSq = vec2_dist_sq(vStart, vHit);
+            if (!bFoundHit || fDistSq < fClosestDistSq)
+            {
+                bFoundHit = true;
+                fClosestDistSq = fDistSq;
+                vClosestHit = vHit;
+                pClosestTarget = obj;
+            }
+        }
+    }
+
+    if (bFoundHit)
+    {
+        *pOutHitPoint = vClosestHit;
+        *ppOutTarget = pClosestTarget;
+        return true;
+    }
+
+    *pOutHitPoint = vEnd;
+    *ppOutTarget = NULL;
+    return false;
+}
+
+/* Beam _iBeam of _iBeams over a _fWidth x _fHeight field: a fan from the center at laser range, then long
+ * beams between random points, beams along cell borders and axes, and zero-length beams */
+static void test_make_beam(int _iBeam, int _iBeams, float _fWidth, float _fHeight, uint32_t *_pSeed, struct vec2 *_pStart, struct vec2 *_pEnd)
+{
+    struct vec2 vCenter = vec2_make(_fWidth * 0.5f, _fHeight * 0.5f);
+    int iKind = _iBeam % 4;
+    if (iKind == 0 || iKind == 1)
+    {
+        float fAngle = (float)_iBeam * (FM_PI * 2.0f / (float)_iBeams);
+        *_pStart = vec2_add(vCenter, vec2_make(fm_sinf(fAngle) * 8.0f, -fm_cosf(fAngle) * 8.0f));
+        *_pEnd = vec2_add(vCenter, vec2_make(fm_sinf(fAngle) * 320.0f, -fm_cosf(fAngle) * 320.0f));
+        return;
+    }
+    if (iKind == 2)
+    {
+        *_pStart = vec2_make(test_randf(_pSeed) * _fWidth, test_randf(_pSeed) * _fHeight);
+        *_pEnd = vec2_make(test_randf(_pSeed) * _fWidth, test_randf(_pSeed) * _fHeight);
+        return;
+    }
+
+    float fBorder = SPACE_GRID_CELL * (float)(1 + (_iBeam / 4) % 8);
+    switch ((_iBeam / 4) % 4)
+    {
+    case 0:
+        *_pStart = vec2_make(fBorder, 0.0f);
+        *_pEnd = vec2_make(fBorder, _fHeight);
+        break;
+    case 1:
+        *_pStart = vec2_make(_fWidth, fBorder);
+        *_pEnd = vec2_make(0.0f, fBorder);
+        break;
+    case 2:
+        *_pStart = vec2_make(fBorder, fBorder);
+        *_pEnd = vec2_make(fBorder + 400.0f, fBorder + 400.0f);
+        break;
+    default:
+        *_pStart = vec2_make(test_randf(_pSeed) * _fWidth, test_randf(_pSeed) * _fHeight);
+        *_pEnd = *_pStart;
+        break;
+    }
+}
+
+/* _iBeams laser beams over the current field, raycast vs. the bounding-box scan: same targets (equidistant
+ * candidates may resolve to either object) and hit points; timings of both are logged */
+static void test_check_raycast(const char *_pName, float _fWidth, float _fHeight, int _iBeams)
+{
+    uint32_t uSeed = 0x27D4EB2Fu;
+    uint64_t uScanUs = 0;
+    uint64_t uRayUs = 0;
+    int iHits = 0;
+    int iMismatches = 0;
+    for (int b = 0; b < _iBeams; b++)
+    {
+        struct vec2 vStart, vEnd;
+        test_make_beam(b, _iBeams, _fWidth, _fHeight, &uSeed, &vStart, &vEnd);
+
+        SpaceObject *apTarget[2];
+        struct vec2 avHit[2];
+        uint64_t uStartUs = get_ticks_us();
+        test_laser_reference(vStart, vEnd, &avHit[0], &apTarget[0]);
+        uScanUs += get_ticks_us() - uStartUs;
+
+        uStartUs = get_ticks_us();
+        space_objects_check_laser_collision(vStart, vEnd, &avHit[1], &apTarget[1]);
+        uRayUs += get_ticks_us() - uStartUs;
+
+        if (apTarget[0])
+            iHits++;
+        float fDistDiff = fabsf(vec2_dist(avHit[0], vStart) - vec2_dist(avHit[1], vStart));
+        bool bSameTarget = apTarget[0] == apTarget[1] || (apTarget[0] && apTarget[1] && fDistDiff <= 1e-2f);
+        if (!bSameTarget || fDistDiff > 1e-2f)
+        {
+            if (iMismatches++ < 4)
+                TEST_CHECK(false,
+                           "%s beam %d (%.1f, %.1f)-(%.1f, %.1f): raycast hit %d at %.2f, scan hit %d at %.2f",
+                           _pName,
+                           b,
+                           vStart.fX,
+                           vStart.fY,
+                           vEnd.fX,
+                           vEnd.fY,
+                           apTarget[1] ? (int)(apTarget[1] - s_objects) : -1,
+                           vec2_dist(avHit[1], vStart),
+                           apTarget[0] ? (int)(apTarget[0] - s_objects) : -1,
+                           vec2_dist(avHit[0], vStart));
+        }
+    }
+
+    TEST_CHECK(iHits > 0 && iHits < _iBeams, "%s: %d of %d beams hit, expected some of each", _pName, iHits, _iBeams);
+    TEST_CHECK(iMismatches == 0, "%s: %d of %d beams differ from the bounding-box scan", _pName, iMismatches, _iBeams);
+    printf("  %s: %d beams (%d hits), bbox scan %lu us, grid raycast %lu us\n", _pName, _iBeams, iHits, (unsigned long)uScanUs, (unsigned long)uRayUs);
+}
+
+/* ---------- Bullet sweeps ---------- */
+
+/* Swept circle over all live slots in double precision: first contact of a circle of _fRadius moving from
+ * _vFrom to _vTo with an object's collision circle, skipping slots set in _abGone. Returns the slot or -1, and
+ * the step fraction of the contact in *_pT (0 if overlapping at the start). */
+static int test_sweep_reference(struct vec2 _vFrom, struct vec2 _vTo, float _fRadius, const bool *_abGone, double *_pT)
+{
+    double dDX = (double)_vTo.fX - (double)_vFrom.fX;
+    double dDY = (double)_vTo.fY - (double)_vFrom.fY;
+    double dA = dDX * dDX + dDY * dDY;
+    int iBest = -1;
+    double dBestT = 0.0;
+    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+    {
+        const SpaceObject *obj = &s_objects[i];
+        if (!obj->bAllocated || obj->markForDelete || !entity2d_is_active(&obj->entity) || (_abGone && _abGone[i]))
+            continue;
+
+        double dR = (double)obj->entity.iCollisionRadius + (double)_fRadius;
+        double dFX = (double)_vFrom.fX - (double)obj->entity.vPos.fX;
+        double dFY = (double)_vFrom.fY - (double)obj->entity.vPos.fY;
+        double dC = dFX * dFX + dFY * dFY - dR * dR;
+        double dT = 0.0;
+        if (dC > 0.0)
+        {
+            double dB = dFX * dDX + dFY * dDY;
+            double dDisc = dB * dB - dA * dC;
+            if (dA <= 1e-12 || dB >= 0.0 || dDisc < 0.0)
+                continue;
+            dT = (-dB - sqrt(dDisc)) / dA;
+            if (dT > 1.0)
+                continue;
+        }
+        if (iBest < 0 || dT < dBestT)
+        {
+            iBest = i;
+            dBestT = dT;
+        }
+    }
+    *_pT = dBestT;
+    return iBest;
+}
+
+/* Bullet _iSweep of a batch over a _fWidth x _fHeight field (meteors of radius 12, grid cells of 48 px) */
+static void test_make_sweep(int _iSweep, float _fWidth, float _fHeight, uint32_t *_pSeed, SpaceSweep *_pSweep)
+{
+    float fAngle = test_randf(_pSeed) * FM_PI * 2.0f;
+    struct vec2 vDir = vec2_make(fm_cosf(fAngle), fm_sinf(fAngle));
+    memset(_pSweep, 0, sizeof(*_pSweep));
+    _pSweep->fRadius = 2.0f;
+    switch (_iSweep % 4)
+    {
+    case 0:
+    {
+        /* Fast bullet: 60..300 px per step, several cells */
+        _pSweep->vFrom = vec2_make(test_randf(_pSeed) * _fWidth, test_randf(_pSeed) * _fHeight);
+        _pSweep->vTo = vec2_add(_pSweep->vFrom, vec2_scale(vDir, 60.0f + test_randf(_pSeed) * 240.0f));
+        break;
+    }
+    case 1:
+    {
+        /* Through a meteor within one step: both ends clear of it, the path off center by up to the hit radius */
+        const SpaceObject *obj = &s_objects[s_auActive[(uint32_t)(test_randf(_pSeed) * (float)s_aliveCount)]];
+        float fReach = (float)obj->entity.iCollisionRadius + _pSweep->fRadius;
+        struct vec2 vSide = vec2_scale(vec2_make(-vDir.fY, vDir.fX), (test_randf(_pSeed) * 2.0f - 1.0f) * fReach);
+        struct vec2 vPass = vec2_add(obj->entity.vPos, vSide);
+        _pSweep->vFrom = vec2_sub(vPass, vec2_scale(vDir, fReach + 20.0f));
+        _pSweep->vTo = vec2_add(vPass, vec2_scale(vDir, fReach + 20.0f));
+        break;
+    }
+    case 2:
+    {
+        /* On cell borders: along a border line, or diagonally through cell corners */
+        float fX = SPACE_GRID_CELL * (float)(1 + (int)(test_randf(_pSeed) * (_fWidth / SPACE_GRID_CELL - 2.0f)));
+        float fY = SPACE_GRID_CELL * (float)(1 + (int)(test_randf(_pSeed) * (_fHeight / SPACE_GRID_CELL - 2.0f)));
+        static const struct vec2 s_aDirs[] = {{1.0f, 0.0f}, {-1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, -1.0f}, {0.70710678f, 0.70710678f}, {-0.70710678f, 0.70710678f}};
+        struct vec2 vBorderDir = s_aDirs[(_iSweep / 4) % 6];
+        _pSweep->vFrom = vec2_make(fX, fY);
+        _pSweep->vTo = vec2_add(_pSweep->vFrom, vec2_scale(vBorderDir, SPACE_GRID_CELL * 3.0f));
+        break;
+    }
+    default:
+    {
+        /* Short, resting or wide bullets, possibly starting inside a meteor */
+        _pSweep->vFrom = vec2_make(test_randf(_pSeed) * _fWidth, test_randf(_pSeed) * _fHeight);
+        float fLength = ((_iSweep / 4) % 3 == 0) ? 0.0f : test_randf(_pSeed) * 10.0f;
+        _pSweep->vTo = vec2_add(_pSweep->vFrom, vec2_scale(vDir, fLength));
+        _pSweep->fRadius = 1.0f + test_randf(_pSeed) * 19.0f;
+        break;
+    }
+    }
+}
+
+/* Every live object of the 3x3 cells around a cell the sweep crossed before its hit (or end) carries the
+ * sweep's stamp */
+static bool test_sweep_covers_neighbours(const SpaceSweep *_pSweep, double _dHitT)
+{
+    struct vec2 vStep = vec2_sub(_pSweep->vTo, _pSweep->vFrom);
+    float fLength = vec2_mag(vStep);
+    int iSamples = 1 + (int)(fLength * (float)_dHitT * 2.0f);
+    for (int k = 0; k < iSamples; k++)
+    {
+        float fT = (float)_dHitT * (float)k / (float)iSamples;
+        struct vec2 vPoint = vec2_add(_pSweep->vFrom, vec2_scale(vStep, fT));
+        int iCellX = (int)floorf(vPoint.fX / SPACE_GRID_CELL);
+        int iCellY = (int)floorf(vPoint.fY / SPACE_GRID_CELL);
+        for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+        {
+            const SpaceObject *obj = &s_objects[i];
+            if (!obj->bAllocated || obj->markForDelete || !entity2d_is_active(&obj->entity))
+                continue;
+            int iObjX = (int)floorf(obj->entity.vPos.fX / SPACE_GRID_CELL);
+            int iObjY = (int)floorf(obj->entity.vPos.fY / SPACE_GRID_CELL);
+            if (abs(iObjX - iCellX) <= 1 && abs(iObjY - iCellY) <= 1 && s_queryStamp[i] != s_queryStampCounter)
+                return false;
+        }
+    }
+    return true;
+}
+
+/* _iSweeps bullets one at a time over the current field vs. the swept-circle scan: same object (equidistant
+ * contacts may resolve to either), same contact within 0.01 px, neighbour cells covered, one test per object */
+static void test_check_bullet_sweeps(const char *_pName, float _fWidth, float _fHeight, int _iSweeps)
+{
+    uint32_t uSeed = 0x61C88647u;
+    int iHits = 0;
+    int iMismatches = 0;
+    int iUncovered = 0;
+    int iRetested = 0;
+    uint32_t uTests = 0;
+    memset(m_aiMeteorDamage, 0, sizeof(m_aiMeteorDamage));
+    for (int b = 0; b < _iSweeps; b++)
+    {
+        SpaceSweep sweep;
+        test_make_sweep(b, _fWidth, _fHeight, &uSeed, &sweep);
+        double dRefT;
+        int iRef = test_sweep_reference(sweep.vFrom, sweep.vTo, sweep.fRadius, NULL, &dRefT);
+
+        uint32_t uTestsBefore = s_uSweepTests;
+        uint16_t uHits = space_objects_check_bullet_sweeps(&sweep, 1, 1);
+        uint32_t uSweepTests = s_uSweepTests - uTestsBefore;
+        uTests += uSweepTests;
+
+        /* Each tested object is stamped once: as many stamps as tests */
+        uint32_t uStamped = 0;
+        for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+            uStamped += (s_queryStamp[i] == s_queryStampCounter) ? 1u : 0u;
+        if (uStamped != uSweepTests)
+            iRetested++;
+        if (!test_sweep_covers_neighbours(&sweep, sweep.pHit ? (double)sweep.fHitT : 1.0))
+            iUncovered++;
+
+        int iHit = sweep.pHit ? (int)(sweep.pHit - s_objects) : -1;
+        float fLength = vec2_dist(sweep.vFrom, sweep.vTo);
+        double dDiffPx = fabs((double)sweep.fHitT - dRefT) * (double)fLength;
+        bool bMatch = (uHits == (iHit >= 0 ? 1 : 0)) && (iHit == iRef || (iHit >= 0 && iRef >= 0 && dDiffPx <= 1e-2)) && (iHit < 0 || dDiffPx <= 1e-2);
+        if (iHit >= 0)
+        {
+            iHits++;
+            bMatch = bMatch && m_aiMeteorDamage[iHit] > 0;
+        }
+        if (!bMatch && iMismatches++ < 4)
+            TEST_CHECK(false,
+                       "%s bullet %d (%.1f, %.1f)-(%.1f, %.1f) r %.1f: sweep hit %d at %.4f, scan hit %d at %.4f",
+                       _pName,
+                       b,
+                       sweep.vFrom.fX,
+                       sweep.vFrom.fY,
+                       sweep.vTo.fX,
+                       sweep.vTo.fY,
+                       sweep.fRadius,
+                       iHit,
+                       sweep.fHitT,
+                       iRef,
+                       dRefT);
+    }
+
+    TEST_CHECK(iHits > 0 && iHits < _iSweeps, "%s: %d of %d bullets hit, expected some of each", _pName, iHits, _iSweeps);
+    TEST_CHECK(iMismatches == 0, "%s: %d of %d bullets differ from the swept-circle scan", _pName, iMismatches, _iSweeps);
+    TEST_CHECK(iUncovered == 0, "%s: %d of %d bullets skipped objects next to a crossed cell", _pName, iUncovered, _iSweeps);
+    TEST_CHECK(iRetested == 0, "%s: %d of %d bullets tested an object more than once", _pName, iRetested, _iSweeps);
+    printf("  %s: %d bullets (%d hits), %lu object tests\n", _pName, _iSweeps, iHits, (unsigned long)uTests);
+}
+
+/* One batch where every hit destroys the meteor: bullets aimed at the same meteor pass through to whatever
+ * lies behind once the first one destroyed it. Results must match the scan run bullet by bullet, which
+ * follows the batch's pick where contacts tie (e.g. bullets starting inside two meteors). */
+static void test_check_bullet_batch(float _fWidth, float _fHeight)
+{
+    enum
+    {
+        TEST_BATCH = 96
+    };
+    static bool s_abGone[MAX_SPACE_OBJECTS];
+    static bool s_abMarked[MAX_SPACE_OBJECTS];
+    SpaceSweep aSweeps[TEST_BATCH];
+    uint32_t uSeed = 0x7FEB352Du;
+
+    for (int b = 0; b < TEST_BATCH; b++)
+    {
+        /* Pairs of bullets along the same path */
+        if (b & 1)
+            aSweeps[b] = aSweeps[b - 1];
+        else
+            test_make_sweep(b / 2, _fWidth, _fHeight, &uSeed, &aSweeps[b]);
+    }
+
+    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+        s_abMarked[i] = s_objects[i].markForDelete;
+    m_bDamageDestroys = true;
+    uint16_t uHits = space_objects_check_bullet_sweeps(aSweeps, TEST_BATCH, 1);
+    m_bDamageDestroys = false;
+
+    /* Scan on the field as it was before the batch, bullet by bullet */
+    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+    {
+        s_abGone[i] = false;
+        s_objects[i].markForDelete = s_abMarked[i];
+    }
+    uint16_t uRefHits = 0;
+    int iMismatches = 0;
+    int iPassThrough = 0;
+    bool bPrevHit = false;
+    for (int b = 0; b < TEST_BATCH; b++)
+    {
+        double dRefT;
+        int iRef = test_sweep_reference(aSweeps[b].vFrom, aSweeps[b].vTo, aSweeps[b].fRadius, s_abGone, &dRefT);
+        int iHit = aSweeps[b].pHit ? (int)(aSweeps[b].pHit - s_objects) : -1;
+        double dDiffPx = fabs((double)aSweeps[b].fHitT - dRefT) * (double)vec2_dist(aSweeps[b].vFrom, aSweeps[b].vTo);
+        if ((iHit < 0) != (iRef < 0) || (iHit >= 0 && (dDiffPx > 1e-2 || s_abGone[iHit])))
+            iMismatches++;
+        if (iHit >= 0)
+        {
+            s_abGone[iHit] = true;
+            uRefHits++;
+        }
+        if ((b & 1) && iHit >= 0 && bPrevHit)
+            iPassThrough++;
+        bPrevHit = iHit >= 0;
+    }
+    for (int i = 0; i < MAX_SPACE_OBJECTS; i++)
+        s_objects[i].markForDelete = s_abMarked[i] || s_abGone[i];
+
+    TEST_CHECK(uHits == uRefHits, "batch reported %u hits, its bullets hit %u objects", uHits, uRefHits);
+    TEST_CHECK(iMismatches == 0, "batch: %d of %d bullets differ from the scan bullet by bullet", iMismatches, TEST_BATCH);
+    TEST_CHECK(iPassThrough > 0, "batch: no bullet passed through a meteor destroyed earlier in the batch");
+    printf("  batch: %d bullets (%u hits, %d behind a destroyed meteor)\n", TEST_BATCH, uHits, iPassThrough);
+}
+
+int main(void)
+{
+    camera_init(&g_mainCamera, 320, 240);
+
+    /* Screen-dense field, and a sparse one spread over 40000 px with a far cluster (unlimited radius) */
+    printf("queries\n");
+    test_spawn_field(320, 1280.0f, 960.0f, 0x85EBCA6Bu);
+    space_objects_gather_hot();
+    test_check_queries("320 meteors, 1280x960", 1280.0f, 960.0f);
+
+    test_spawn_field(256, 40000.0f, 30000.0f, 0xC2B2AE35u);
+    for (int i = 0; i < 16; i++)
+    {
+        SpaceObject *obj = space_objects_spawn_meteor(vec2_make(-90000.0f + (float)i * 20.0f, 70000.0f));
+        if (obj)
+            obj->entity.iCollisionRadius = 12;
+    }
+    space_objects_gather_hot();
+    test_check_queries("272 meteors, 40000x30000 + far cluster", 40000.0f, 30000.0f);
+
+    test_check_query_limits();
+    test_check_active_order();
+
+    /* Laser beams with 320 meteors on a screen-sized field, and long beams over a larger one */
+    printf("raycast\n");
+    test_spawn_field(320, 640.0f, 480.0f, 0x9E3779B9u);
+    space_objects_gather_hot();
+    test_check_raycast("320 meteors, 640x480", 640.0f, 480.0f, 256);
+    test_spawn_field(320, 1280.0f, 960.0f, 0x165667B1u);
+    space_objects_gather_hot();
+    test_check_raycast("320 meteors, 1280x960", 1280.0f, 960.0f, 256);
+
+    printf("bullet sweeps\n");
+    test_check_bullet_sweeps("320 meteors, 1280x960", 1280.0f, 960.0f, 512);
+    test_spawn_field(320, 640.0f, 480.0f, 0x2127599Bu);
+    space_objects_gather_hot();
+    test_check_bullet_sweeps("320 meteors, 640x480", 640.0f, 480.0f, 512);
+    test_check_bullet_batch(640.0f, 480.0f);
+    space_objects_clear();
+
+    /* Update pass at the field sizes of the old in-game benchmark */
+    printf("update\n");
+    test_check_update(64);
+    test_check_update(256);
+    test_check_update(MAX_SPACE_OBJECTS);
+    test_check_setter_relink();
+    test_check_dormant_drift();
+
+    printf("%s (%d failures)\n", m_iFailures ? "FAILED" : "OK", m_iFailures);
+    return m_iFailures ? 1 : 0;
+}
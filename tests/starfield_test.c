@@ -0,0 +1,649 @@
+/* Headless test of the starfield star paths (make host-tests).
+ *
+ * Replays a recorded camera flight and checks the optimized paths of starfield.c against the per-frame
+ * code they replaced:
+ * - the star cell cache produces exactly the stars (position, color, flicker phase) that regenerating every
+ *   visible cell and sorting all stars by layer and color produces (timings of both are logged),
+ * - over every zoom, no shown layer's view spans more cells than its cache grid, whose size is derived at compile
+ *   time from the layer's smallest zoom scale,
+ * - the star kernel's draw commands expand to the same rects, streak quads and colors, bit for bit, as the
+ *   per-star transform, cull and streak expansion (timings of both are logged),
+ * - the slow layers drawn from their scroll textures (occupied bands, then the flickering stars) give the
+ *   same screen as their per-star dots, and the RDP draws render saves match the SSAVED count it reports
+ *   (draws of both are logged).
+ *
+ * Usage: starfield_test
+ * Run where "rom:" points at assets/ (planet sprites). */
+
+#include "../game_objects/starfield.c"
+#include "test_common.h"
+
+/* ufo.c and frame_time.c are not linked: the test drives the camera itself and never runs starfield_update */
+float ufo_get_speed(void)
+{
+    return 0.0f;
+}
+
+float frame_time_mul(void)
+{
+    return 1.0f;
+}
+
+/* Set camera position and zoom and derive the layer zoom scales the way starfield_update does */
+static void test_set_camera(struct vec2 _vPos, float _fZoom)
+{
+    g_mainCamera.vPos = _vPos;
+    camera_set_zoom(&g_mainCamera, _fZoom);
+    for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+        m_aLayerZoomScale[iLayer] = starfield_layer_zoom_scale(iLayer, camera_get_zoom(&g_mainCamera));
+}
+
+/* Camera of frame _iFrame of the recorded flight: alternating 60-frame cruise (3 px/frame) and turbo
+ * (12 px/frame) legs along a curving heading, zooming out to the minimap level over frames 160..199 */
+static void test_flight_camera(int _iFrame, int _iFrames, struct vec2 *_pPos)
+{
+    float fHeading = 0.8f + 2.5f * (float)_iFrame / (float)_iFrames;
+    float fSpeed = ((_iFrame / 60) & 1) ? 12.0f : 3.0f;
+    *_pPos = vec2_add(*_pPos, vec2_make(cosf(fHeading) * fSpeed, sinf(fHeading) * fSpeed));
+
+    float fZoom = 1.0f;
+    if (_iFrame >= 160 && _iFrame < 200)
+        fZoom = (_iFrame < 170) ? 1.0f - (float)(_iFrame - 159) * 0.09f : (_iFrame < 190) ? MINIMAP_ZOOM_LEVEL : 0.1f + (float)(_iFrame - 189) * 0.09f;
+    test_set_camera(*_pPos, fZoom);
+}
+
+/* ---------- Star cell cache ---------- */
+
+/* Star as the regenerating population stored it: screen-space position before zoom */
+typedef struct
+{
+    struct vec2 vPos;
+    int iLayer;
+    enum eCGAColor eColor;
+    uint8_t uPhase;
+} test_star_t;
+
+/* Visible stars of the cell cache in the test_star_t form, layer segments in order. Returns the count. */
+static int test_get_stars(test_star_t *_pOut)
+{
+    int iCount = 0;
+    for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+    {
+        int iEnd = m_aLayerStarStart[iLayer] + m_aLayerStarCount[iLayer];
+        for (int i = m_aLayerStarStart[iLayer]; i < iEnd; ++i)
+        {
+            test_star_t *pStar = &_pOut[iCount++];
+            pStar->vPos.fX = ((float)(m_aLayerOriginX[iLayer] + m_aiStarX[i]) - m_aLayerCamPos[iLayer].fX) + (float)m_iScreenW * 0.5f;
+            pStar->vPos.fY = ((float)(m_aLayerOriginY[iLayer] + m_aiStarY[i]) - m_aLayerCamPos[iLayer].fY) + (float)m_iScreenH * 0.5f;
+            pStar->iLayer = iLayer;
+            pStar->eColor = (enum eCGAColor)m_auStarColor[i];
+            pStar->uPhase = m_auStarPhase[i];
+        }
+    }
+    return iCount;
+}
+
+/* Layer (background first), then color: the order the reference sorted its stars into */
+static int test_compare_star(const void *_pA, const void *_pB)
+{
+    const test_star_t *pA = (const test_star_t *)_pA;
+    const test_star_t *pB = (const test_star_t *)_pB;
+    if (pA->iLayer != pB->iLayer)
+        return pA->iLayer - pB->iLayer;
+    if ((int)pA->eColor != (int)pB->eColor)
+        return (int)pA->eColor - (int)pB->eColor;
+    return 0;
+}
+
+/* Full order (layer, color, position) to compare two star sets */
+static int test_compare_star_full(const void *_pA, const void *_pB)
+{
+    const test_star_t *pA = (const test_star_t *)_pA;
+    const test_star_t *pB = (const test_star_t *)_pB;
+    int iOrder = test_compare_star(_pA, _pB);
+    if (iOrder != 0)
+        return iOrder;
+    if (pA->vPos.fX != pB->vPos.fX)
+        return (pA->vPos.fX < pB->vPos.fX) ? -1 : 1;
+    if (pA->vPos.fY != pB->vPos.fY)
+        return (pA->vPos.fY < pB->vPos.fY) ? -1 : 1;
+    return 0;
+}
+
+/* Reference: the star population before the cell cache. Every star of every visible cell is hashed again,
+ * then all stars are sorted by layer and color. */
+static int test_populate_stars_reference(test_star_t *_pOut)
+{
+    int iStarCount = 0;
+    float fGlobalZoom = camera_get_zoom(&g_mainCamera);
+
+    for (int iLayer = STARFIELD_NUM_LAYERS - 1; iLayer >= 0; --iLayer)
+    {
+        if (m_aLayerSizes[iLayer] <= 0 || starfield_layer_culled(iLayer, fGlobalZoom))
+            continue;
+
+        int iCount = m_aLayerWeights[iLayer] * STARFIELD_STARS_PER_WEIGHT;
+        starfield_grid_bounds_t bounds;
+        starfield_calc_grid_bounds(iLayer, &bounds);
+
+        for (int gy = bounds.iGridMinY; gy <= bounds.iGridMaxY; ++gy)
+        {
+            for (int gx = bounds.iGridMinX; gx <= bounds.iGridMaxX; ++gx)
+            {
+                uint32_t uCellSeed = sq5_get_4d_u32(gx, gy, iLayer, 0, m_uSeed);
+                for (int i = 0; i < iCount; ++i)
+                {
+                    if (iStarCount >= STARFIELD_NUM_STARS)
+                        goto done_stars;
+
+                    uint32_t uStarSeed = sq5_get_1d_u32(i, uCellSeed);
+                    float fWorldX = (float)(gx * STARFIELD_CELL_SIZE) + (float)(uStarSeed & 0x1FF);
+                    float fWorldY = (float)(gy * STARFIELD_CELL_SIZE) + (float)((uStarSeed >> 9) & 0x1FF);
+                    if (fWorldX < bounds.fViewMinX || fWorldX > bounds.fViewMaxX || fWorldY < bounds.fViewMinY || fWorldY > bounds.fViewMaxY)
+                        continue;
+
+                    int iColorIndex = starfield_deterministic_choice(NULL, STARFIELD_NUM_COLOR_CHOICES, m_iStarColorWeightSum, uStarSeed >> 18);
+
+                    test_star_t *pStar = &_pOut[iStarCount++];
+                    pStar->vPos.fX = (fWorldX - bounds.vLayerCamPos.fX) + (float)m_iScreenW * 0.5f;
+                    pStar->vPos.fY = (fWorldY - bounds.vLayerCamPos.fY) + (float)m_iScreenH * 0.5f;
+                    pStar->iLayer = iLayer;
+                    pStar->eColor = m_aStarColors[iColorIndex];
+                    pStar->uPhase = (uint8_t)(uStarSeed >> 24);
+                }
+            }
+        }
+    }
+
+done_stars:
+    if (iStarCount > 0)
+        qsort(_pOut, (size_t)iStarCount, sizeof(test_star_t), test_compare_star);
+    return iStarCount;
+}
+
+/* Cell cache vs. regeneration over the recorded flight, then over jumps across the universe that land on cells
+ * whose cache slots held other cells: the star sets must match every frame */
+static void test_check_cell_cache(void)
+{
+    const int iFrames = 240;
+    const int iJumps = 64;
+    static test_star_t aRef[STARFIELD_NUM_STARS];
+    static test_star_t aCached[STARFIELD_NUM_STARS];
+
+    memset(m_aCells, 0, sizeof(m_aCells));
+    struct vec2 vPos = vec2_make(1000.0f, -400.0f);
+    uint64_t uRefUs = 0;
+    uint64_t uCacheUs = 0;
+    uint32_t uStars = 0;
+    int iMismatches = 0;
+    for (int f = 0; f < iFrames + iJumps; ++f)
+    {
+        bool bJump = f >= iFrames;
+        if (bJump)
+        {
+            static const float s_aJumpZooms[4] = {1.0f, MINIMAP_ZOOM_LEVEL, 0.4f, 0.7f};
+            vPos = vec2_make((float)((f * 3719) % 40000 - 20000), (float)((f * 2903) % 30000 - 15000));
+            test_set_camera(vPos, s_aJumpZooms[f & 3]);
+        }
+        else
+        {
+            test_flight_camera(f, iFrames, &vPos);
+        }
+
+        uint64_t uStartUs = get_ticks_us();
+        int iRefCount = test_populate_stars_reference(aRef);
+        uint64_t uMidUs = get_ticks_us();
+        starfield_populate_stars();
+        if (!bJump)
+        {
+            uRefUs += uMidUs - uStartUs;
+            uCacheUs += get_ticks_us() - uMidUs;
+            uStars += (uint32_t)m_iStarCount;
+        }
+        if (iRefCount != m_iStarCount)
+        {
+            if (iMismatches++ == 0)
+                printf("  frame %d: %d stars, reference %d\n", f, m_iStarCount, iRefCount);
+            continue;
+        }
+
+        test_get_stars(aCached);
+        qsort(aRef, (size_t)iRefCount, sizeof(test_star_t), test_compare_star_full);
+        qsort(aCached, (size_t)m_iStarCount, sizeof(test_star_t), test_compare_star_full);
+        for (int i = 0; i < iRefCount; ++i)
+        {
+            if (test_compare_star_full(&aRef[i], &aCached[i]) != 0 || aRef[i].uPhase != aCached[i].uPhase)
+            {
+                if (iMismatches++ == 0)
+                    printf("  frame %d: star %d (layer %d at %.0f,%.0f), reference layer %d at %.0f,%.0f\n",
+                           f,
+                           i,
+                           aCached[i].iLayer,
+                           (double)aCached[i].vPos.fX,
+                           (double)aCached[i].vPos.fY,
+                           aRef[i].iLayer,
+                           (double)aRef[i].vPos.fX,
+                           (double)aRef[i].vPos.fY);
+                break;
+            }
+        }
+    }
+
+    printf("  %d frames (+%d jumps), %lu stars/frame: regenerate+sort %lu us/frame, cell cache %lu us/frame\n",
+           iFrames,
+           iJumps,
+           (unsigned long)(uStars / (uint32_t)iFrames),
+           (unsigned long)(uRefUs / (uint64_t)iFrames),
+           (unsigned long)(uCacheUs / (uint64_t)iFrames));
+    TEST_CHECK(uStars > 0, "flight saw no stars");
+    TEST_CHECK(iMismatches == 0, "cell cache differs from regeneration in %d of %d frames", iMismatches, iFrames + iJumps);
+}
+
+/* Every zoom from far past the minimap level to 2x, at camera positions across a cell: no shown star layer's
+ * scale is below the floor its cache grid is sized for (the large layer's floor is the old 0.1 clamp), and its
+ * view never spans more cells than that grid, so starfield_calc_grid_bounds never has to cut cells */
+static void test_check_cell_cache_grid(void)
+{
+    int iFloored = 0;
+    int iCut = 0;
+    int aMaxCols[STARFIELD_NUM_LAYERS] = {0};
+    int aMaxRows[STARFIELD_NUM_LAYERS] = {0};
+    for (int z = 1; z <= 250; ++z)
+    {
+        float fZoom = (float)z * 0.01f;
+        for (int p = 0; p < 16; ++p)
+        {
+            test_set_camera(vec2_make(-3000.0f + (float)p * 61.3f, 700.0f - (float)p * 47.9f), fZoom);
+            for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+            {
+                if (m_aLayerSizes[iLayer] <= 0 || starfield_layer_culled(iLayer, camera_get_zoom(&g_mainCamera)))
+                    continue;
+
+                if (m_aLayerMinZoomScale[iLayer] > MINIMAP_ZOOM_LEVEL && m_aLayerZoomScale[iLayer] < m_aLayerMinZoomScale[iLayer] && iFloored++ < 3)
+                    TEST_CHECK(false, "zoom %.2f: layer %d scale %.3f is below its cache floor %.3f", (double)fZoom, iLayer, (double)m_aLayerZoomScale[iLayer],
+                               (double)m_aLayerMinZoomScale[iLayer]);
+
+                starfield_grid_bounds_t bounds;
+                starfield_calc_grid_bounds(iLayer, &bounds);
+                int iCols = (int)floorf(bounds.fViewMaxX / STARFIELD_CELL_SIZE) - (int)floorf(bounds.fViewMinX / STARFIELD_CELL_SIZE) + 1;
+                int iRows = (int)floorf(bounds.fViewMaxY / STARFIELD_CELL_SIZE) - (int)floorf(bounds.fViewMinY / STARFIELD_CELL_SIZE) + 1;
+                aMaxCols[iLayer] = (iCols > aMaxCols[iLayer]) ? iCols : aMaxCols[iLayer];
+                aMaxRows[iLayer] = (iRows > aMaxRows[iLayer]) ? iRows : aMaxRows[iLayer];
+                if ((iCols > m_aLayerCacheCols[iLayer] || iRows > m_aLayerCacheRows[iLayer]) && iCut++ < 3)
+                    TEST_CHECK(false, "zoom %.2f: layer %d sees %dx%d cells, cache grid %dx%d", (double)fZoom, iLayer, iCols, iRows, m_aLayerCacheCols[iLayer],
+                               m_aLayerCacheRows[iLayer]);
+            }
+        }
+    }
+    TEST_CHECK(iFloored == 0, "%d layer views were floored to their cache scale", iFloored);
+    TEST_CHECK(iCut == 0, "%d layer views span more cells than their cache grid", iCut);
+
+    printf("  cell cache grids (widest view seen):");
+    for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+    {
+        if (m_aLayerCacheCols[iLayer] > 0)
+            printf(" %dx%d (%dx%d)", m_aLayerCacheCols[iLayer], m_aLayerCacheRows[iLayer], aMaxCols[iLayer], aMaxRows[iLayer]);
+    }
+    printf(", %d cells, %d seeds\n", STARFIELD_CACHE_CELLS, STARFIELD_CACHE_SEEDS);
+}
+
+/* ---------- Star kernel ---------- */
+
+/* One star draw: dot rect or streak quad, and the color */
+typedef struct
+{
+    int iColor;
+    int aRect[4];
+    float aQuad[8];
+} test_draw_rec_t;
+
+/* Reference: per-star transform, cull and streak expansion as render ran it before the star kernel,
+ * recording the draws instead of issuing them */
+static int test_render_reference(const test_star_t *_pStars, int _iStarCount, test_draw_rec_t *_pOut)
+{
+    int iDrawCount = 0;
+    float fScreenHalfW = (float)m_iScreenW * 0.5f;
+    float fScreenHalfH = (float)m_iScreenH * 0.5f;
+    float fGlobalZoom = camera_get_zoom(&g_mainCamera);
+
+    for (int iStar = 0; iStar < _iStarCount; ++iStar)
+    {
+        const test_star_t *pStar = &_pStars[iStar];
+        int iLayer = pStar->iLayer;
+        int iSize = m_aLayerSizes[iLayer];
+        if (iSize <= 0)
+            continue;
+        if (fGlobalZoom < 0.5f && iSize < 2)
+            continue;
+        if (fGlobalZoom < 0.3f && iSize < 3)
+            continue;
+
+        float fScale = m_aLayerZoomScale[iLayer];
+        float fSizeScaled = (float)iSize * fScale;
+        float fCenterX = pStar->vPos.fX * fScale + fScreenHalfW * (1.0f - fScale);
+        float fCenterY = pStar->vPos.fY * fScale + fScreenHalfH * (1.0f - fScale);
+
+        float fHalfSize = m_aLayerHalfWidth[iLayer] * fScale;
+        bool bDrawAsDot = m_aLayerDrawAsDot[iLayer];
+        int iCullMargin = (int)fm_ceilf((float)m_aLayerCullMargin[iLayer] * fScale);
+        if (iCullMargin < 1)
+            iCullMargin = 1;
+        if (bDrawAsDot)
+            iCullMargin = 0;
+
+        int iRectX = (int)fm_floorf(fCenterX - fHalfSize + 0.5f);
+        int iRectY = (int)fm_floorf(fCenterY - fHalfSize + 0.5f);
+        int iSizeScaledInt = (int)fm_ceilf(fSizeScaled);
+        if (iRectX + iSizeScaledInt + iCullMargin < 0 || iRectX - iCullMargin >= m_iScreenW || iRectY + iSizeScaledInt + iCullMargin < 0 ||
+            iRectY - iCullMargin >= m_iScreenH)
+            continue;
+
+        test_draw_rec_t *pRec = &_pOut[iDrawCount++];
+        pRec->iColor = (int)starfield_get_star_color(pStar->eColor, iLayer, pStar->uPhase, (int)m_fFlickerFrame);
+        if (bDrawAsDot)
+        {
+            pRec->aRect[0] = iRectX;
+            pRec->aRect[1] = iRectY;
+            pRec->aRect[2] = iRectX + iSizeScaledInt;
+            pRec->aRect[3] = iRectY + iSizeScaledInt;
+            continue;
+        }
+
+        struct vec2 vBack = vec2_scale(m_aLayerBackOffset[iLayer], fScale);
+        struct vec2 vFront = vec2_scale(m_aLayerFrontOffset[iLayer], fScale);
+        struct vec2 vPerp = vec2_scale(m_aLayerPerpOffset[iLayer], fScale);
+        float fDiagonalShift = m_aLayerDiagShift[iLayer] * fScale;
+
+        float fLeft = (float)iRectX;
+        float fTop = (float)iRectY;
+        float fQuadCenterX = (fLeft + (fLeft + fSizeScaled)) * 0.5f - fDiagonalShift;
+        float fQuadCenterY = (fTop + (fTop + fSizeScaled)) * 0.5f - fDiagonalShift;
+        pRec->aQuad[0] = fQuadCenterX + vBack.fX - vPerp.fX;
+        pRec->aQuad[1] = fQuadCenterY + vBack.fY - vPerp.fY;
+        pRec->aQuad[2] = fQuadCenterX + vBack.fX + vPerp.fX;
+        pRec->aQuad[3] = fQuadCenterY + vBack.fY + vPerp.fY;
+        pRec->aQuad[4] = fQuadCenterX + vFront.fX - vPerp.fX;
+        pRec->aQuad[5] = fQuadCenterY + vFront.fY - vPerp.fY;
+        pRec->aQuad[6] = fQuadCenterX + vFront.fX + vPerp.fX;
+        pRec->aQuad[7] = fQuadCenterY + vFront.fY + vPerp.fY;
+    }
+    return iDrawCount;
+}
+
+/* Star kernel vs. the per-star reference over camera positions, zoom levels (down to the minimap level),
+ * streak directions and lengths and flicker frames: the recorded draws must match bit for bit */
+static void test_check_render_kernel(void)
+{
+    const int iPasses = 96;
+    const float aZooms[] = {1.0f, 0.75f, 0.4f, MINIMAP_ZOOM_LEVEL, 1.6f};
+    const float aLengths[] = {0.0f, 6.0f, 28.0f};
+    const int iZoomCount = (int)(sizeof(aZooms) / sizeof(aZooms[0]));
+    const int iLengthCount = (int)(sizeof(aLengths) / sizeof(aLengths[0]));
+    static test_star_t aStars[STARFIELD_NUM_STARS];
+    static test_draw_rec_t aRef[STARFIELD_NUM_STARS];
+    static test_draw_rec_t aKernel[STARFIELD_NUM_STARS];
+
+    /* Per-star commands only: a blit band costs more than any layer's stars */
+    int iBandStrips = m_iScrollBandStrips;
+    m_iScrollBandStrips = STARFIELD_NUM_STARS;
+    memset(m_aCells, 0, sizeof(m_aCells));
+    uint64_t uRefUs = 0;
+    uint64_t uKernelUs = 0;
+    uint32_t uDraws = 0;
+    uint32_t uStreakDraws = 0;
+    int iMismatches = 0;
+    for (int p = 0; p < iPasses; ++p)
+    {
+        float fHeading = 0.37f * (float)p;
+        struct vec2 vDir = vec2_make(cosf(fHeading), sinf(fHeading));
+        struct vec2 vRight = vec2_make(-vDir.fY, vDir.fX);
+        float fLen = aLengths[p % iLengthCount];
+
+        test_set_camera(vec2_make(-3000.0f + 71.3f * (float)p, 1200.0f - 43.9f * (float)p), aZooms[(p / iLengthCount) % iZoomCount]);
+        for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+        {
+            if (m_aLayerSizes[iLayer] > 0)
+                starfield_set_layer_geometry(iLayer, vDir, vRight, fLen * m_aLayerSpeedFactors[iLayer] * 4.0f);
+        }
+        m_fFlickerFrame = (float)(p * 29);
+        starfield_populate_stars();
+        int iStarCount = test_get_stars(aStars);
+
+        memset(aRef, 0, sizeof(aRef));
+        memset(aKernel, 0, sizeof(aKernel));
+        uint64_t uStartUs = get_ticks_us();
+        int iRefCount = test_render_reference(aStars, iStarCount, aRef);
+        uRefUs += get_ticks_us() - uStartUs;
+
+        uStartUs = get_ticks_us();
+        int iCmdCount = starfield_build_star_cmds();
+        int iKernelCount = 0;
+        for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+        {
+            const starfield_layer_draw_t *pDraw = &m_aLayerDraw[iLayer];
+            for (int i = pDraw->iCmdStart; i < pDraw->iCmdStart + pDraw->iCmdCount; ++i)
+            {
+                const starfield_cmd_t *pCmd = &m_aStarCmds[i];
+                test_draw_rec_t *pRec = &aKernel[iKernelCount++];
+                pRec->iColor = (int)pCmd->uColor;
+                if (pDraw->bDrawAsDot)
+                {
+                    pRec->aRect[0] = pCmd->iX;
+                    pRec->aRect[1] = pCmd->iY;
+                    pRec->aRect[2] = pCmd->iX + pDraw->iSizeScaled;
+                    pRec->aRect[3] = pCmd->iY + pDraw->iSizeScaled;
+                }
+                else
+                {
+                    starfield_streak_quad(pDraw, pCmd, pRec->aQuad);
+                    uStreakDraws++;
+                }
+            }
+        }
+        uKernelUs += get_ticks_us() - uStartUs;
+
+        uDraws += (uint32_t)iCmdCount;
+        if (iRefCount != iKernelCount || iCmdCount != iKernelCount || memcmp(aRef, aKernel, sizeof(test_draw_rec_t) * (size_t)iRefCount) != 0)
+        {
+            if (iMismatches++ == 0)
+                printf("  pass %d (zoom %.2f, length %.0f): %d kernel draws, reference %d\n",
+                       p,
+                       (double)camera_get_zoom(&g_mainCamera),
+                       (double)fLen,
+                       iKernelCount,
+                       iRefCount);
+        }
+    }
+
+    printf("  %d passes, %lu draws/pass (%lu streaks): per-star %lu us/pass, kernel %lu us/pass\n",
+           iPasses,
+           (unsigned long)(uDraws / (uint32_t)iPasses),
+           (unsigned long)(uStreakDraws / (uint32_t)iPasses),
+           (unsigned long)(uRefUs / (uint64_t)iPasses),
+           (unsigned long)(uKernelUs / (uint64_t)iPasses));
+    TEST_CHECK(uDraws > 0 && uStreakDraws > 0, "passes drew no dots or no streaks");
+    TEST_CHECK(iMismatches == 0, "star kernel differs from the per-star transform in %d of %d passes", iMismatches, iPasses);
+    m_iScrollBandStrips = iBandStrips;
+}
+
+/* ---------- Scroll texture cache ---------- */
+
+/* Paint a layer's dot commands into an 8-bit color image of the screen */
+static void test_paint_cmds(const starfield_layer_draw_t *_pDraw, uint8_t *_pImage)
+{
+    for (int i = _pDraw->iCmdStart; i < _pDraw->iCmdStart + _pDraw->iCmdCount; ++i)
+    {
+        const starfield_cmd_t *pCmd = &m_aStarCmds[i];
+        for (int iY = pCmd->iY; iY < pCmd->iY + _pDraw->iSizeScaled; ++iY)
+        {
+            for (int iX = pCmd->iX; iX < pCmd->iX + _pDraw->iSizeScaled; ++iX)
+            {
+                if (iX >= 0 && iX < m_iScreenW && iY >= 0 && iY < m_iScreenH)
+                    _pImage[iY * m_iScreenW + iX] = pCmd->uColor;
+            }
+        }
+    }
+}
+
+/* Paint what render blits of a cached layer: the texture window over its occupied bands (texel 0 is
+ * transparent). Returns the band count. */
+static int test_paint_scroll_bands(int _iLayer, const starfield_layer_draw_t *_pDraw, uint8_t *_pImage)
+{
+    const starfield_scroll_cache_t *pCache = &m_aScrollCache[_iLayer];
+    const uint8_t *pTexels = (const uint8_t *)pCache->surface.buffer;
+    int iBands = 0;
+    for (int iY = 0; iY < m_iScreenH; ++iY)
+    {
+        int iBand = iY / m_iScrollBandRows;
+        if (!(_pDraw->uScrollBands & (1ull << iBand)))
+            continue;
+        if (iY % m_iScrollBandRows == 0)
+            iBands++;
+
+        const uint8_t *pRow = pTexels + (_pDraw->iScrollT0 + iY) * (int)pCache->surface.stride;
+        for (int iX = 0; iX < m_iScreenW; ++iX)
+        {
+            int iS = _pDraw->iScrollS0 + iX;
+            uint8_t uTexel = (iS & 1) ? (pRow[iS >> 1] & 0x0F) : (pRow[iS >> 1] >> 4);
+            if (uTexel != 0)
+                _pImage[iY * m_iScreenW + iX] = uTexel;
+        }
+    }
+    return iBands;
+}
+
+/* Paint the cache layers as the last build drew them into _pImage; returns the layers drawn from the texture */
+static int test_paint_cache_layers(uint8_t *_pImage)
+{
+    int iCached = 0;
+    for (int iLayer = 0; iLayer < STARFIELD_SCROLL_CACHE_LAYERS; ++iLayer)
+    {
+        const starfield_layer_draw_t *pDraw = &m_aLayerDraw[iLayer];
+        if (pDraw->bScrollCached)
+        {
+            test_paint_scroll_bands(iLayer, pDraw, _pImage);
+            iCached++;
+        }
+        test_paint_cmds(pDraw, _pImage);
+    }
+    return iCached;
+}
+
+/* Flies the camera at zoom 1.0 with dot stars (slow legs, then a jump every 80 frames) and renders each frame
+ * per star and with the scroll cache as shipped. The cache layers must paint the same screen both ways, and
+ * the RDP draws of the two renders must differ by exactly the draws the cache reports saved (SSAVED). The
+ * screens are also compared with the blit threshold lifted, so every frame with a star takes the texture. */
+static void test_check_scroll_cache(void)
+{
+    const int iFrames = 240;
+    size_t uImageBytes = (size_t)m_iScreenW * (size_t)m_iScreenH;
+    uint8_t *pRef = malloc(uImageBytes);
+    uint8_t *pCached = malloc(uImageBytes);
+    uint8_t *pForced = malloc(uImageBytes);
+    int iBandStrips = m_iScrollBandStrips;
+
+    test_set_camera(vec2_make(-2500.0f, 700.0f), 1.0f);
+    for (int iLayer = 0; iLayer < STARFIELD_NUM_LAYERS; ++iLayer)
+    {
+        if (m_aLayerSizes[iLayer] > 0)
+            starfield_set_layer_geometry(iLayer, vec2_zero(), vec2_zero(), 0.0f);
+    }
+    memset(m_aCells, 0, sizeof(m_aCells));
+
+    struct vec2 vPos = g_mainCamera.vPos;
+    uint32_t uPerStarDraws = 0;
+    uint32_t uShippedDraws = 0;
+    uint32_t uSaved = 0;
+    int iCachedFrames = 0;
+    int iForcedFrames = 0;
+    int iCountMismatches = 0;
+    int iImageMismatches = 0;
+    for (int f = 0; f < iFrames; ++f)
+    {
+        vPos = vec2_add(vPos, (f % 80 == 79) ? vec2_make(1733.0f, -911.0f) : vec2_make(2.7f, -1.9f));
+        test_set_camera(vPos, 1.0f);
+        m_fFlickerFrame = (float)f;
+        starfield_populate_stars();
+
+        /* Per star: blit threshold out of reach */
+        m_iScrollBandStrips = STARFIELD_NUM_STARS;
+        uint32_t uBefore = g_hostLibdragonStats.uRdpqDraws;
+        starfield_render();
+        uint32_t uFramePerStar = g_hostLibdragonStats.uRdpqDraws - uBefore;
+        memset(pRef, 0, uImageBytes);
+        test_paint_cache_layers(pRef);
+
+        /* As shipped */
+        m_iScrollBandStrips = iBandStrips;
+        uBefore = g_hostLibdragonStats.uRdpqDraws;
+        starfield_render();
+        uint32_t uFrameShipped = g_hostLibdragonStats.uRdpqDraws - uBefore;
+        memset(pCached, 0, uImageBytes);
+        int iCachedLayers = test_paint_cache_layers(pCached);
+        uint32_t uFrameSaved = 0;
+        for (int iLayer = 0; iLayer < STARFIELD_SCROLL_CACHE_LAYERS; ++iLayer)
+            uFrameSaved += m_aLayerDraw[iLayer].bScrollCached ? (uint32_t)m_aLayerDraw[iLayer].iScrollSaved : 0u;
+
+        /* Every frame with a star on the texture */
+        m_iScrollBandStrips = 0;
+        starfield_build_star_cmds();
+        m_iScrollBandStrips = iBandStrips;
+        memset(pForced, 0, uImageBytes);
+        iForcedFrames += test_paint_cache_layers(pForced) > 0 ? 1 : 0;
+
+        uPerStarDraws += uFramePerStar;
+        uShippedDraws += uFrameShipped;
+        uSaved += uFrameSaved;
+        iCachedFrames += iCachedLayers > 0 ? 1 : 0;
+        if (uFramePerStar - uFrameShipped != uFrameSaved)
+        {
+            if (iCountMismatches++ == 0)
+                printf("  frame %d: %lu RDP draws per star, %lu cached, %lu reported saved\n",
+                       f,
+                       (unsigned long)uFramePerStar,
+                       (unsigned long)uFrameShipped,
+                       (unsigned long)uFrameSaved);
+        }
+        if (memcmp(pRef, pCached, uImageBytes) != 0 || memcmp(pRef, pForced, uImageBytes) != 0)
+        {
+            if (iImageMismatches++ == 0)
+                printf("  frame %d: cached layers paint a different screen\n", f);
+        }
+    }
+
+    printf("  %d frames: %lu RDP draws/frame per star, %lu with the cache (used in %d frames, every frame with a star in %d when forced), SSAVED %lu/frame\n",
+           iFrames,
+           (unsigned long)(uPerStarDraws / (uint32_t)iFrames),
+           (unsigned long)(uShippedDraws / (uint32_t)iFrames),
+           iCachedFrames,
+           iForcedFrames,
+           (unsigned long)(uSaved / (uint32_t)iFrames));
+    TEST_CHECK(iCachedFrames > 0 && uSaved > 0, "scroll cache never used at the shipped density");
+    TEST_CHECK(iCountMismatches == 0, "saved RDP draws differ from SSAVED in %d of %d frames", iCountMismatches, iFrames);
+    TEST_CHECK(iImageMismatches == 0, "scroll cache screen differs from the per-star dots in %d of %d frames", iImageMismatches, iFrames);
+
+    starfield_scroll_cache_free();
+    free(pRef);
+    free(pCached);
+    free(pForced);
+}
+
+int main(void)
+{
+    const uint32_t aSeeds[] = {0x2545F491u, 7u};
+
+    camera_init(&g_mainCamera, SCREEN_W, SCREEN_H);
+    for (size_t s = 0; s < sizeof(aSeeds) / sizeof(aSeeds[0]); ++s)
+    {
+        printf("seed %08lx\n", (unsigned long)aSeeds[s]);
+        starfield_init(SCREEN_W, SCREEN_H, aSeeds[s]);
+        test_check_cell_cache();
+        test_check_cell_cache_grid();
+        test_check_render_kernel();
+        test_check_scroll_cache();
+        starfield_free();
+    }
+
+    printf("%s (%d failures)\n", m_iFailures ? "FAILED" : "OK", m_iFailures);
+    return m_iFailures ? 1 : 0;
+}
@@ -0,0 +1,23 @@
+/* Shared by the host tests (make host-tests): failure counting and the ui.c screen size the game modules
+ * read. Each test is a single translation unit, so this is included once, after the module under test. */
+
+#pragma once
+
+#include <stdio.h>
+
+int SCREEN_W = 320; /* ui.c */
+int SCREEN_H = 240;
+
+static int m_iFailures = 0;
+
+#define TEST_CHECK(_bCond, ...)        \
+    do                                 \
+    {                                  \
+        if (!(_bCond))                 \
+        {                              \
+            printf("  FAIL: ");        \
+            printf(__VA_ARGS__);       \
+            printf("\n");              \
+            m_iFailures++;             \
+        }                              \
+    } while (0)
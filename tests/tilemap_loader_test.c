@@ -0,0 +1,731 @@
+/* Headless test of the staged tilemap loader (make host-tests).
+ *
+ * Drives tilemap_importer_load_step over real map folders on the build machine, through the CSV path with the
+ * runtime atlas build and through the binary .tmap path with its baked atlas. Per map it checks:
+ * - no single step does more than its slice of work: ROM bytes read, CSV layers parsed, sparse row indexes
+ *   built, collision mask rows classified, atlas tiles loaded or packed, sprite loads and atlas pages (step
+ *   times are logged; host timings say nothing about the N64 frame budget),
+ * - progress only moves forward and ends at 1,
+ * - layers and atlas match the source CSV files and tile PNGs, decoded independently here,
+ * - sparse row index rect queries return exactly the hash table tiles in the rect (timings of both are logged),
+ * - the .tmap load builds the same layers, sparse row index, collision mask and atlas as the CSV load
+ *   (load times of both paths are logged),
+ * - aborting after any step releases every sprite and surface.
+ *
+ * .tmap files are big-endian (N64 byte order); the test swaps the buffer to host order after the READ stage,
+ * so load_tmap_parse runs on the same data as on the console.
+ *
+ * Usage: tilemap_loader_test [-t <dir>] <folder>:<surface|jnr> ...
+ * Run where "rom:" points at assets/; with -t, <dir>/rom:/<folder>/<folder>.tmap holds the converted maps. */
+
+#include "../tilemap_importer.c"
+#include "../tools/png_decode.h"
+#include <stddef.h>
+#include <unistd.h>
+#include "test_common.h"
+
+#define TEST_MAX_STEPS 100000
+#define TEST_TIMING_RUNS 5 /* Full loads per path for the CSV vs. .tmap timing (fastest is reported) */
+
+/* ---------- Fixture: source files decoded without the importer ---------- */
+
+typedef struct
+{
+    int aTileIds[TILEMAP_IMPORTER_MAX_TILES]; /* Sorted ascending, index = tile index in the layers */
+    uint16_t uTileCount;
+} test_tile_ids_t;
+
+static bool test_load_tile_ids(const char *_pFolder, test_tile_ids_t *_pOut)
+{
+    char szPath[256];
+    snprintf(szPath, sizeof(szPath), "rom:/%s/tile_ids.csv", _pFolder);
+    FILE *pFile = fopen(szPath, "r");
+    if (!pFile)
+        return false;
+
+    _pOut->uTileCount = 0;
+    int iValue = 0;
+    while (_pOut->uTileCount < TILEMAP_IMPORTER_MAX_TILES && fscanf(pFile, " %d ,", &iValue) == 1)
+        _pOut->aTileIds[_pOut->uTileCount++] = iValue;
+    fclose(pFile);
+
+    qsort(_pOut->aTileIds, _pOut->uTileCount, sizeof(int), cmp_int_asc);
+    return _pOut->uTileCount > 0;
+}
+
+static int test_tile_index(const test_tile_ids_t *_pIds, int _iTileId)
+{
+    for (uint16_t i = 0; i < _pIds->uTileCount; ++i)
+    {
+        if (_pIds->aTileIds[i] == _iTileId)
+            return i;
+    }
+    return -1;
+}
+
+/* Compare every cell of a layer with its CSV file */
+static void test_check_layer(const char *_pFolder, uint8_t _uLayer, const tilemap_layer_t *_pLayer, const test_tile_ids_t *_pIds)
+{
+    char szPath[256];
+    snprintf(szPath, sizeof(szPath), "rom:/%s/%s_%02d.csv", _pFolder, _pFolder, _uLayer);
+    FILE *pFile = fopen(szPath, "r");
+    TEST_CHECK(pFile != NULL, "%s missing", szPath);
+    if (!pFile)
+        return;
+
+    uint32_t uMismatches = 0;
+    uint16_t uRows = 0;
+    static char szLine[8192];
+    while (fgets(szLine, sizeof(szLine), pFile) && uRows < _pLayer->uHeight)
+    {
+        uint16_t uCol = 0;
+        for (char *pToken = strtok(szLine, ",\r\n"); pToken && uCol < _pLayer->uWidth; pToken = strtok(NULL, ",\r\n"), ++uCol)
+        {
+            int iTileId = atoi(pToken);
+            int iExpected = (iTileId == -1) ? TILEMAP_IMPORTER_EMPTY_TILE : test_tile_index(_pIds, iTileId);
+            if (tilemap_layer_get_tile(_pLayer, uCol, uRows) != iExpected)
+                uMismatches++;
+        }
+        TEST_CHECK(uCol == _pLayer->uWidth, "%s row %u has %u columns, layer width %u", szPath, (unsigned)uRows, (unsigned)uCol, (unsigned)_pLayer->uWidth);
+        uRows++;
+    }
+    fclose(pFile);
+
+    TEST_CHECK(uRows == _pLayer->uHeight, "%s has %u rows, layer height %u", szPath, (unsigned)uRows, (unsigned)_pLayer->uHeight);
+    TEST_CHECK(uMismatches == 0, "%s: %lu cells differ from the CSV", szPath, (unsigned long)uMismatches);
+}
+
+/* Screen-sized rect queries (22x15 tiles) swept over the layer: the row index must return the same tiles as a
+ * scan of the whole hash table, as tilemap_update did before the index existed */
+static void test_check_sparse_row_index(uint8_t _uLayer, const tilemap_layer_t *_pLayer)
+{
+    const sparse_layer_data_t *pSparse = &_pLayer->sparse;
+    const uint16_t uStep = 8;
+    uint32_t uRects = 0;
+    uint32_t uHashHits = 0;
+    uint32_t uIndexHits = 0;
+    uint32_t uBadTiles = 0;
+    uint64_t uHashUs = 0;
+    uint64_t uIndexUs = 0;
+
+    for (uint16_t uTop = 0; uTop < _pLayer->uHeight; uTop += uStep)
+    {
+        for (uint16_t uLeft = 0; uLeft < _pLayer->uWidth; uLeft += uStep)
+        {
+            uint16_t uRight = (uint16_t)(uLeft + 21);
+            uint16_t uBottom = (uint16_t)(uTop + 14);
+            uRects++;
+
+            uint64_t uStartUs = get_ticks_us();
+            for (uint16_t i = 0; i < pSparse->uCapacity; ++i)
+            {
+                const sparse_tile_entry_t *pEntry = &pSparse->pEntries[i];
+                if (pEntry->uX != SPARSE_ENTRY_EMPTY && pEntry->uX >= uLeft && pEntry->uX <= uRight && pEntry->uY >= uTop && pEntry->uY <= uBottom)
+                    uHashHits++;
+            }
+            uHashUs += get_ticks_us() - uStartUs;
+
+            uStartUs = get_ticks_us();
+            for (uint16_t y = uTop; y <= uBottom && y < _pLayer->uHeight; ++y)
+            {
+                uint16_t uBegin, uEnd;
+                tilemap_layer_sparse_row_span(pSparse, y, uLeft, uRight, &uBegin, &uEnd);
+                uIndexHits += (uint32_t)(uEnd - uBegin);
+                for (uint16_t i = uBegin; i < uEnd; ++i)
+                {
+                    uint16_t uX = pSparse->pRowColumns[i];
+                    if (uX < uLeft || uX > uRight || (i > uBegin && uX <= pSparse->pRowColumns[i - 1]) || pSparse->pRowTileIds[i] != tilemap_layer_sparse_get(pSparse, uX, y))
+                        uBadTiles++;
+                }
+            }
+            uIndexUs += get_ticks_us() - uStartUs;
+        }
+    }
+
+    printf("  sparse layer %u (%u tiles): %lu rect queries, hash scan %lu us, row index %lu us\n",
+           (unsigned)_uLayer,
+           (unsigned)pSparse->uCount,
+           (unsigned long)uRects,
+           (unsigned long)uHashUs,
+           (unsigned long)uIndexUs);
+    TEST_CHECK(uIndexHits == uHashHits, "sparse layer %u: row index returned %lu tiles, hash scan %lu", (unsigned)_uLayer, (unsigned long)uIndexHits, (unsigned long)uHashHits);
+    TEST_CHECK(uBadTiles == 0, "sparse layer %u: %lu row index tiles out of the rect, unsorted or with the wrong ID", (unsigned)_uLayer, (unsigned long)uBadTiles);
+}
+
+/* Every tile must sit in its own atlas slot with the PNG's pixels (RGBA5551) and trimmed rect */
+static void test_check_atlas(const char *_pFolder, const tilemap_importer_t *_pImporter, const test_tile_ids_t *_pIds)
+{
+    uint16_t uExpectedPages = (_pIds->uTileCount + TILE_ATLAS_TILES_PER_PAGE - 1) / TILE_ATLAS_TILES_PER_PAGE;
+    TEST_CHECK(_pImporter->uAtlasPageCount == uExpectedPages, "%u atlas pages, expected %u", (unsigned)_pImporter->uAtlasPageCount, (unsigned)uExpectedPages);
+
+    bool aSlotUsed[TILE_ATLAS_MAX_PAGES * TILE_ATLAS_TILES_PER_PAGE] = {false};
+    uint32_t uPixelMismatches = 0;
+    uint32_t uRectMismatches = 0;
+    for (uint16_t t = 0; t < _pIds->uTileCount; ++t)
+    {
+        const tile_atlas_entry_t *pEntry = &_pImporter->pAtlasEntries[t];
+        if (pEntry->uPageIndex >= _pImporter->uAtlasPageCount || pEntry->uU0 % 16 != 0 || pEntry->uV0 % 16 != 0 || pEntry->uU0 >= TILE_ATLAS_PAGE_WIDTH || pEntry->uV0 >= TILE_ATLAS_PAGE_HEIGHT)
+        {
+            TEST_CHECK(false, "tile %u has no valid atlas slot", (unsigned)t);
+            continue;
+        }
+
+        int iSlot = pEntry->uPageIndex * TILE_ATLAS_TILES_PER_PAGE + (pEntry->uV0 / 16) * 4 + pEntry->uU0 / 16;
+        TEST_CHECK(!aSlotUsed[iSlot], "tile %u shares atlas slot %d", (unsigned)t, iSlot);
+        aSlotUsed[iSlot] = true;
+
+        char szPath[256];
+        snprintf(szPath, sizeof(szPath), "rom:/%s/%d.png", _pFolder, _pIds->aTileIds[t]);
+        uint8_t *pRGBA = NULL;
+        uint32_t uWidth = 0;
+        uint32_t uHeight = 0;
+        if (!png_decode_file(szPath, &pRGBA, &uWidth, &uHeight))
+        {
+            TEST_CHECK(false, "cannot decode %s", szPath);
+            continue;
+        }
+
+        const surface_t *pPage = &_pImporter->pAtlasPages[pEntry->uPageIndex];
+        int iMinX = 16, iMinY = 16, iMaxX = -1, iMaxY = -1;
+        for (int y = 0; y < 16; ++y)
+        {
+            for (int x = 0; x < 16; ++x)
+            {
+                const uint8_t *pSrc = &pRGBA[(y * uWidth + x) * 4];
+                uint16_t uExpected = (uint16_t)(((pSrc[0] >> 3) << 11) | ((pSrc[1] >> 3) << 6) | ((pSrc[2] >> 3) << 1) | (pSrc[3] > 127 ? 1 : 0));
+                const uint16_t *pDst = (const uint16_t *)((const uint8_t *)pPage->buffer + (pEntry->uV0 + y) * pPage->stride) + pEntry->uU0 + x;
+                if (*pDst != uExpected)
+                    uPixelMismatches++;
+            }
+        }
+
+        for (uint32_t y = 0; y < uHeight; ++y)
+        {
+            for (uint32_t x = 0; x < uWidth; ++x)
+            {
+                if (pRGBA[(y * uWidth + x) * 4 + 3] <= 127)
+                    continue;
+                iMinX = (int)x < iMinX ? (int)x : iMinX;
+                iMinY = (int)y < iMinY ? (int)y : iMinY;
+                iMaxX = (int)x > iMaxX ? (int)x : iMaxX;
+                iMaxY = (int)y > iMaxY ? (int)y : iMaxY;
+            }
+        }
+        free(pRGBA);
+
+        const tile_trimmed_rect_t *pRect = &_pImporter->pTileTrimmedRects[t];
+        bool bEmpty = iMaxX < 0;
+        if (bEmpty ? (pRect->vSize.iX != 0 || pRect->vSize.iY != 0)
+                   : (pRect->vOffset.iX != iMinX || pRect->vOffset.iY != iMinY || pRect->vSize.iX != iMaxX - iMinX + 1 || pRect->vSize.iY != iMaxY - iMinY + 1))
+            uRectMismatches++;
+    }
+
+    TEST_CHECK(uPixelMismatches == 0, "%lu atlas pixels differ from the tile PNGs", (unsigned long)uPixelMismatches);
+    TEST_CHECK(uRectMismatches == 0, "%lu trimmed rects differ from the tile PNGs", (unsigned long)uRectMismatches);
+}
+
+/* ---------- .tmap byte order ---------- */
+
+static void test_swap16(uint8_t *_p)
+{
+    uint8_t uTmp = _p[0];
+    _p[0] = _p[1];
+    _p[1] = uTmp;
+}
+
+static void test_swap32(uint8_t *_p)
+{
+    uint8_t uTmp = _p[0];
+    _p[0] = _p[3];
+    _p[3] = uTmp;
+    uTmp = _p[1];
+    _p[1] = _p[2];
+    _p[2] = uTmp;
+}
+
+/* Swap _uCount 16-bit values of _uStride bytes each, starting at _uOffset; false if they run past the file */
+static bool test_swap16_array(uint8_t *_pBlob, size_t _uSize, size_t _uOffset, size_t _uCount, size_t _uStride)
+{
+    if (_uOffset + _uCount * _uStride > _uSize)
+        return false;
+    for (size_t i = 0; i < _uCount; ++i)
+        test_swap16(_pBlob + _uOffset + i * _uStride);
+    return true;
+}
+
+/* Swap a big-endian .tmap buffer to host order in place, following the layout in tilemap_format.h */
+static bool test_tmap_to_host_order(uint8_t *_pBlob, size_t _uSize)
+{
+    if (_uSize < sizeof(tilemap_format_header_t))
+        return false;
+
+    tilemap_format_header_t *pHeader = (tilemap_format_header_t *)_pBlob;
+    test_swap32((uint8_t *)&pHeader->uMagic);
+    test_swap16((uint8_t *)&pHeader->uVersion);
+    test_swap16((uint8_t *)&pHeader->uTileCount);
+    test_swap32((uint8_t *)&pHeader->uTileIdsOffset);
+    for (int i = 0; i < TILEMAP_FORMAT_MAX_LAYERS; ++i)
+    {
+        tilemap_format_layer_t *pRecord = &pHeader->aLayers[i];
+        test_swap16((uint8_t *)&pRecord->uWidth);
+        test_swap16((uint8_t *)&pRecord->uHeight);
+        test_swap16((uint8_t *)&pRecord->uTileCount);
+        test_swap16((uint8_t *)&pRecord->uSparseCapacity);
+        test_swap16((uint8_t *)&pRecord->uSparseCount);
+        test_swap32((uint8_t *)&pRecord->uDataOffset);
+        test_swap32((uint8_t *)&pRecord->uDataSize);
+    }
+    test_swap16((uint8_t *)&pHeader->uAtlasPageCount);
+    test_swap16((uint8_t *)&pHeader->uReserved);
+    test_swap32((uint8_t *)&pHeader->uAtlasPagesOffset);
+    test_swap32((uint8_t *)&pHeader->uAtlasEntriesOffset);
+    test_swap32((uint8_t *)&pHeader->uTrimmedRectsOffset);
+
+    if (!test_swap16_array(_pBlob, _uSize, pHeader->uTileIdsOffset, pHeader->uTileCount, sizeof(uint16_t)))
+        return false;
+
+    for (uint8_t i = 0; i < pHeader->uLayerCount && i < TILEMAP_FORMAT_MAX_LAYERS; ++i)
+    {
+        const tilemap_format_layer_t *pRecord = &pHeader->aLayers[i];
+        bool bOk = true;
+        if (pRecord->uStorage == TILEMAP_LAYER_STORAGE_SPARSE)
+        {
+            /* {u16 x, u16 y, u8 tileId, u8 pad} */
+            bOk = test_swap16_array(_pBlob, _uSize, pRecord->uDataOffset, pRecord->uSparseCapacity, sizeof(sparse_tile_entry_t)) &&
+                  test_swap16_array(_pBlob, _uSize, pRecord->uDataOffset + offsetof(sparse_tile_entry_t, uY), pRecord->uSparseCapacity, sizeof(sparse_tile_entry_t));
+        }
+        else if (pRecord->uStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+        {
+            /* {u16 dataIndex, u8 tileId, u8 pad} records, followed by byte-sized chunk data */
+            uint32_t uChunks = (((uint32_t)pRecord->uWidth + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT) *
+                               (((uint32_t)pRecord->uHeight + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT);
+            bOk = test_swap16_array(_pBlob, _uSize, pRecord->uDataOffset, uChunks, TILEMAP_FORMAT_CHUNK_RECORD_SIZE);
+        }
+        if (!bOk)
+            return false;
+    }
+
+    if (pHeader->uAtlasPageCount > 0)
+    {
+        /* RGBA16 pages and s32 trimmed rects; atlas entries are bytes */
+        size_t uRectsOffset = pHeader->uTrimmedRectsOffset;
+        size_t uRectValues = (size_t)pHeader->uTileCount * 4;
+        if (!test_swap16_array(_pBlob, _uSize, pHeader->uAtlasPagesOffset, (size_t)pHeader->uAtlasPageCount * TILEMAP_FORMAT_ATLAS_PAGE_BYTES / 2, sizeof(uint16_t)) ||
+            uRectsOffset + uRectValues * sizeof(int32_t) > _uSize)
+            return false;
+        for (size_t i = 0; i < uRectValues; ++i)
+            test_swap32(_pBlob + uRectsOffset + i * sizeof(int32_t));
+    }
+    return true;
+}
+
+/* Before a loader step: a .tmap buffer that has been read completely is swapped to host order for PARSE */
+static void test_before_step(tilemap_importer_loader_t *_pLoader)
+{
+    if (_pLoader->uStage == TILEMAP_LOAD_STAGE_PARSE && _pLoader->pBlob)
+        TEST_CHECK(test_tmap_to_host_order(_pLoader->pBlob, _pLoader->uBlobSize), "%s.tmap: offsets run past the end of the file", _pLoader->szMapFolder);
+}
+
+static tilemap_load_status_t test_load_step(tilemap_importer_loader_t *_pLoader)
+{
+    test_before_step(_pLoader);
+    return tilemap_importer_load_step(_pLoader);
+}
+
+/* ---------- Staged load ---------- */
+
+/* Work done by one load step, from the loader and importer state before and after it */
+typedef struct
+{
+    uint32_t uBytesRead;
+    uint32_t uCsvLayers;
+    uint32_t uRowIndexes;
+    uint32_t uMaskRows;
+    uint32_t uAtlasTiles;
+} test_step_work_t;
+
+static void test_step_work(const tilemap_importer_loader_t *_pBefore,
+                           const tilemap_importer_t *_pImporterBefore,
+                           const tilemap_importer_loader_t *_pAfter,
+                           const tilemap_importer_t *_pImporterAfter,
+                           test_step_work_t *_pOut)
+{
+    memset(_pOut, 0, sizeof(*_pOut));
+    switch (_pBefore->uStage)
+    {
+    case TILEMAP_LOAD_STAGE_READ:
+        _pOut->uBytesRead = (uint32_t)(_pAfter->uBlobRead - _pBefore->uBlobRead);
+        break;
+    case TILEMAP_LOAD_STAGE_CSV_LAYERS:
+    case TILEMAP_LOAD_STAGE_ROW_INDEX:
+        for (uint8_t i = 0; i < _pImporterAfter->uLayerCount; ++i)
+        {
+            if (_pImporterBefore->aLayers[i].uWidth == 0 && _pImporterAfter->aLayers[i].uWidth != 0)
+                _pOut->uCsvLayers++;
+            if (!_pImporterBefore->aLayers[i].sparse.pRowStart && _pImporterAfter->aLayers[i].sparse.pRowStart)
+                _pOut->uRowIndexes++;
+        }
+        break;
+    case TILEMAP_LOAD_STAGE_MASK:
+        _pOut->uMaskRows = (uint32_t)(_pAfter->uMaskRow - _pBefore->uMaskRow);
+        break;
+    case TILEMAP_LOAD_STAGE_ATLAS_SPRITES:
+    case TILEMAP_LOAD_STAGE_ATLAS_PACK:
+        _pOut->uAtlasTiles = (uint32_t)(_pAfter->uAtlasTile - _pBefore->uAtlasTile);
+        break;
+    default:
+        break;
+    }
+}
+
+static inline uint32_t test_max_u32(uint32_t _uA, uint32_t _uB)
+{
+    return _uA > _uB ? _uA : _uB;
+}
+
+/* Run a whole staged load, checking the work of every step */
+static bool test_staged_load(const char *_pFolder, tilemap_type_t _eType, tilemap_importer_t *_pImporter)
+{
+    tilemap_importer_loader_t loader;
+    TEST_CHECK(tilemap_importer_load_begin(&loader, _pImporter, _pFolder, _eType), "load_begin failed");
+
+    uint32_t uSteps = 0;
+    uint32_t uMaxStepUs = 0;
+    uint32_t uMaxSpriteLoads = 0;
+    uint32_t uMaxSurfaceAllocs = 0;
+    test_step_work_t maxWork = {0};
+    uint64_t uTotalUs = 0;
+    float fProgress = tilemap_importer_load_progress(&loader);
+    tilemap_load_status_t eStatus = TILEMAP_LOAD_PENDING;
+    while (eStatus == TILEMAP_LOAD_PENDING && uSteps < TEST_MAX_STEPS)
+    {
+        test_before_step(&loader);
+        host_libdragon_stats_t before = g_hostLibdragonStats;
+        tilemap_importer_loader_t loaderBefore = loader;
+        tilemap_importer_t importerBefore = *_pImporter;
+        uint64_t uStartUs = get_ticks_us();
+        eStatus = tilemap_importer_load_step(&loader);
+        uint32_t uStepUs = (uint32_t)(get_ticks_us() - uStartUs);
+        uSteps++;
+        uTotalUs += uStepUs;
+
+        uint32_t uSpriteLoads = g_hostLibdragonStats.uSpriteLoads - before.uSpriteLoads;
+        uint32_t uSurfaceAllocs = g_hostLibdragonStats.uSurfaceAllocs - before.uSurfaceAllocs;
+        uMaxStepUs = uStepUs > uMaxStepUs ? uStepUs : uMaxStepUs;
+        uMaxSpriteLoads = uSpriteLoads > uMaxSpriteLoads ? uSpriteLoads : uMaxSpriteLoads;
+        uMaxSurfaceAllocs = uSurfaceAllocs > uMaxSurfaceAllocs ? uSurfaceAllocs : uMaxSurfaceAllocs;
+
+        test_step_work_t work;
+        test_step_work(&loaderBefore, &importerBefore, &loader, _pImporter, &work);
+        maxWork.uBytesRead = test_max_u32(maxWork.uBytesRead, work.uBytesRead);
+        maxWork.uCsvLayers = test_max_u32(maxWork.uCsvLayers, work.uCsvLayers);
+        maxWork.uRowIndexes = test_max_u32(maxWork.uRowIndexes, work.uRowIndexes);
+        maxWork.uMaskRows = test_max_u32(maxWork.uMaskRows, work.uMaskRows);
+        maxWork.uAtlasTiles = test_max_u32(maxWork.uAtlasTiles, work.uAtlasTiles);
+
+        float fNext = tilemap_importer_load_progress(&loader);
+        TEST_CHECK(fNext >= fProgress && fNext <= 1.0f, "progress went from %.3f to %.3f at step %lu", fProgress, fNext, (unsigned long)uSteps);
+        fProgress = fNext;
+    }
+
+    printf("  %lu steps, %lu us total, max step %lu us, max %lu sprite loads and %lu atlas pages per step\n",
+           (unsigned long)uSteps,
+           (unsigned long)uTotalUs,
+           (unsigned long)uMaxStepUs,
+           (unsigned long)uMaxSpriteLoads,
+           (unsigned long)uMaxSurfaceAllocs);
+    printf("  per step max: %lu bytes read, %lu CSV layers, %lu row indexes, %lu mask rows, %lu atlas tiles\n",
+           (unsigned long)maxWork.uBytesRead,
+           (unsigned long)maxWork.uCsvLayers,
+           (unsigned long)maxWork.uRowIndexes,
+           (unsigned long)maxWork.uMaskRows,
+           (unsigned long)maxWork.uAtlasTiles);
+
+    TEST_CHECK(eStatus == TILEMAP_LOAD_DONE, "load did not finish (status %d after %lu steps)", (int)eStatus, (unsigned long)uSteps);
+    TEST_CHECK(fProgress == 1.0f, "progress ends at %.3f", fProgress);
+    TEST_CHECK(maxWork.uBytesRead <= TILEMAP_LOAD_READ_SLICE, "a step read %lu bytes (slice is %d)", (unsigned long)maxWork.uBytesRead, TILEMAP_LOAD_READ_SLICE);
+    TEST_CHECK(maxWork.uCsvLayers <= 1, "a step parsed %lu CSV layers", (unsigned long)maxWork.uCsvLayers);
+    TEST_CHECK(maxWork.uRowIndexes <= 1, "a step built %lu row indexes", (unsigned long)maxWork.uRowIndexes);
+    TEST_CHECK(maxWork.uMaskRows <= TILEMAP_LOAD_MASK_ROWS, "a step classified %lu mask rows (slice is %d)", (unsigned long)maxWork.uMaskRows, TILEMAP_LOAD_MASK_ROWS);
+    TEST_CHECK(maxWork.uAtlasTiles <= TILEMAP_LOAD_ATLAS_TILES, "a step handled %lu atlas tiles (slice is %d)", (unsigned long)maxWork.uAtlasTiles, TILEMAP_LOAD_ATLAS_TILES);
+    TEST_CHECK(uMaxSpriteLoads <= TILEMAP_LOAD_ATLAS_TILES, "a step loaded %lu sprites (slice is %d)", (unsigned long)uMaxSpriteLoads, TILEMAP_LOAD_ATLAS_TILES);
+    TEST_CHECK(uMaxSurfaceAllocs <= 1, "a step allocated %lu atlas pages", (unsigned long)uMaxSurfaceAllocs);
+    TEST_CHECK(g_hostLibdragonStats.iLiveSprites == 0, "%d tile sprites still loaded", g_hostLibdragonStats.iLiveSprites);
+    return eStatus == TILEMAP_LOAD_DONE;
+}
+
+/* Abort a load after every possible step: nothing may stay allocated */
+static void test_abort_at_every_step(const char *_pFolder, tilemap_type_t _eType, uint32_t _uSteps)
+{
+    uint32_t uLeaks = 0;
+    g_bHostLibdragonQuiet = true;
+    for (uint32_t uAbortAt = 0; uAbortAt < _uSteps; ++uAbortAt)
+    {
+        tilemap_importer_t importer;
+        tilemap_importer_loader_t loader;
+        if (!tilemap_importer_load_begin(&loader, &importer, _pFolder, _eType))
+            break;
+
+        tilemap_load_status_t eStatus = TILEMAP_LOAD_PENDING;
+        for (uint32_t i = 0; i < uAbortAt && eStatus == TILEMAP_LOAD_PENDING; ++i)
+            eStatus = test_load_step(&loader);
+        if (eStatus == TILEMAP_LOAD_PENDING)
+            tilemap_importer_load_abort(&loader);
+        else
+            tilemap_importer_free(&importer);
+
+        if (g_hostLibdragonStats.iLiveSprites != 0 || g_hostLibdragonStats.iLiveSurfaces != 0 || importer.bInitialized)
+            uLeaks++;
+        g_hostLibdragonStats.iLiveSprites = 0;
+        g_hostLibdragonStats.iLiveSurfaces = 0;
+    }
+    g_bHostLibdragonQuiet = false;
+
+    TEST_CHECK(uLeaks == 0, "%lu aborted loads left sprites or surfaces behind", (unsigned long)uLeaks);
+}
+
+/* Abort a load after every step of a full load */
+static void test_abort_all_steps(const char *_pFolder, tilemap_type_t _eType)
+{
+    tilemap_importer_t importer;
+    tilemap_importer_loader_t loader;
+    uint32_t uSteps = 0;
+    g_bHostLibdragonQuiet = true;
+    if (tilemap_importer_load_begin(&loader, &importer, _pFolder, _eType))
+    {
+        while (test_load_step(&loader) == TILEMAP_LOAD_PENDING)
+            uSteps++;
+        tilemap_importer_free(&importer);
+    }
+    g_bHostLibdragonQuiet = false;
+    test_abort_at_every_step(_pFolder, _eType, uSteps + 1);
+}
+
+/* Fastest of TEST_TIMING_RUNS full loads (step time only, the byte swap is not counted) */
+static uint64_t test_time_load(const char *_pFolder, tilemap_type_t _eType)
+{
+    uint64_t uBestUs = UINT64_MAX;
+    g_bHostLibdragonQuiet = true;
+    for (int iRun = 0; iRun < TEST_TIMING_RUNS; ++iRun)
+    {
+        tilemap_importer_t importer;
+        tilemap_importer_loader_t loader;
+        if (!tilemap_importer_load_begin(&loader, &importer, _pFolder, _eType))
+            break;
+
+        uint64_t uUs = 0;
+        tilemap_load_status_t eStatus = TILEMAP_LOAD_PENDING;
+        while (eStatus == TILEMAP_LOAD_PENDING)
+        {
+            test_before_step(&loader);
+            uint64_t uStartUs = get_ticks_us();
+            eStatus = tilemap_importer_load_step(&loader);
+            uUs += get_ticks_us() - uStartUs;
+        }
+        if (eStatus == TILEMAP_LOAD_DONE)
+            tilemap_importer_free(&importer);
+        uBestUs = uUs < uBestUs ? uUs : uBestUs;
+    }
+    g_bHostLibdragonQuiet = false;
+    return uBestUs;
+}
+
+/* The .tmap load must build the same layers, sparse row index, collision mask and atlas as the CSV load */
+static void test_compare_importers(const tilemap_importer_t *_pCsv, const tilemap_importer_t *_pTmap)
+{
+    TEST_CHECK(_pTmap->uLayerCount == _pCsv->uLayerCount && _pTmap->uTileCount == _pCsv->uTileCount,
+               ".tmap has %u layers and %u tiles, CSV %u and %u",
+               (unsigned)_pTmap->uLayerCount,
+               (unsigned)_pTmap->uTileCount,
+               (unsigned)_pCsv->uLayerCount,
+               (unsigned)_pCsv->uTileCount);
+    if (_pTmap->uLayerCount != _pCsv->uLayerCount || _pTmap->uTileCount != _pCsv->uTileCount)
+        return;
+
+    for (uint8_t i = 0; i < _pCsv->uLayerCount; ++i)
+    {
+        const tilemap_layer_t *pCsv = &_pCsv->aLayers[i];
+        const tilemap_layer_t *pTmap = &_pTmap->aLayers[i];
+        if (pTmap->eStorage != pCsv->eStorage || pTmap->uWidth != pCsv->uWidth || pTmap->uHeight != pCsv->uHeight || pTmap->uTileCount != pCsv->uTileCount)
+        {
+            TEST_CHECK(false,
+                       "layer %u: .tmap storage %d %ux%u (%u tiles), CSV storage %d %ux%u (%u tiles)",
+                       (unsigned)i,
+                       (int)pTmap->eStorage,
+                       (unsigned)pTmap->uWidth,
+                       (unsigned)pTmap->uHeight,
+                       (unsigned)pTmap->uTileCount,
+                       (int)pCsv->eStorage,
+                       (unsigned)pCsv->uWidth,
+                       (unsigned)pCsv->uHeight,
+                       (unsigned)pCsv->uTileCount);
+            continue;
+        }
+
+        uint32_t uMismatches = 0;
+        for (uint16_t y = 0; y < pCsv->uHeight; ++y)
+        {
+            for (uint16_t x = 0; x < pCsv->uWidth; ++x)
+            {
+                if (tilemap_layer_get_tile(pTmap, x, y) != tilemap_layer_get_tile(pCsv, x, y))
+                    uMismatches++;
+            }
+        }
+        TEST_CHECK(uMismatches == 0, "layer %u: %lu cells differ between .tmap and CSV", (unsigned)i, (unsigned long)uMismatches);
+
+        if (pCsv->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
+        {
+            const sparse_layer_data_t *pA = &pCsv->sparse;
+            const sparse_layer_data_t *pB = &pTmap->sparse;
+            bool bSame = pA->uCount == pB->uCount && pA->uRowCount == pB->uRowCount && pA->pRowStart && pB->pRowStart &&
+                         memcmp(pA->pRowStart, pB->pRowStart, sizeof(uint16_t) * (pA->uRowCount + 1u)) == 0 &&
+                         memcmp(pA->pRowColumns, pB->pRowColumns, sizeof(uint16_t) * pA->uCount) == 0 &&
+                         memcmp(pA->pRowTileIds, pB->pRowTileIds, pA->uCount) == 0;
+            TEST_CHECK(bSame, "sparse layer %u: row index differs between .tmap and CSV", (unsigned)i);
+        }
+    }
+
+    const tilemap_collision_mask_t *pMaskA = &_pCsv->collisionMask;
+    const tilemap_collision_mask_t *pMaskB = &_pTmap->collisionMask;
+    bool bSameMask = pMaskA->uWidth == pMaskB->uWidth && pMaskA->uHeight == pMaskB->uHeight && pMaskA->uWordsPerRow == pMaskB->uWordsPerRow &&
+                     pMaskA->pWords && pMaskB->pWords && memcmp(pMaskA->pWords, pMaskB->pWords, sizeof(uint32_t) * pMaskA->uWordsPerRow * pMaskA->uHeight) == 0;
+    TEST_CHECK(bSameMask, "collision mask differs between .tmap and CSV");
+
+    /* Baked atlas vs. runtime atlas: the converter packs its own slots, so compare tile by tile */
+    TEST_CHECK(_pTmap->uAtlasPageCount == _pCsv->uAtlasPageCount, ".tmap has %u atlas pages, CSV %u", (unsigned)_pTmap->uAtlasPageCount, (unsigned)_pCsv->uAtlasPageCount);
+    uint32_t uPixelMismatches = 0;
+    uint32_t uRectMismatches = 0;
+    for (uint16_t t = 0; t < _pCsv->uTileCount; ++t)
+    {
+        const tile_atlas_entry_t *pA = &_pCsv->pAtlasEntries[t];
+        const tile_atlas_entry_t *pB = &_pTmap->pAtlasEntries[t];
+        if (pB->uPageIndex >= _pTmap->uAtlasPageCount || pB->uU0 > TILE_ATLAS_PAGE_WIDTH - 16 || pB->uV0 > TILE_ATLAS_PAGE_HEIGHT - 16)
+        {
+            TEST_CHECK(false, ".tmap tile %u has no valid atlas slot", (unsigned)t);
+            continue;
+        }
+        const surface_t *pPageA = &_pCsv->pAtlasPages[pA->uPageIndex];
+        const surface_t *pPageB = &_pTmap->pAtlasPages[pB->uPageIndex];
+        for (uint16_t y = 0; y < 16; ++y)
+        {
+            if (memcmp((const uint8_t *)pPageA->buffer + (pA->uV0 + y) * pPageA->stride + pA->uU0 * sizeof(uint16_t),
+                       (const uint8_t *)pPageB->buffer + (pB->uV0 + y) * pPageB->stride + pB->uU0 * sizeof(uint16_t),
+                       16 * sizeof(uint16_t)) != 0)
+                uPixelMismatches++;
+        }
+        if (memcmp(&_pCsv->pTileTrimmedRects[t], &_pTmap->pTileTrimmedRects[t], sizeof(tile_trimmed_rect_t)) != 0)
+            uRectMismatches++;
+    }
+    TEST_CHECK(uPixelMismatches == 0, "%lu atlas tile rows differ between .tmap and CSV", (unsigned long)uPixelMismatches);
+    TEST_CHECK(uRectMismatches == 0, "%lu trimmed rects differ between .tmap and CSV", (unsigned long)uRectMismatches);
+}
+
+/* Load the converted .tmap from _pTmapDir ("rom:" there holds only .tmap files, so a CSV fallback fails) */
+static void test_map_tmap(const char *_pFolder, tilemap_type_t _eType, const char *_pTmapDir, const tilemap_importer_t *_pCsvImporter)
+{
+    char szCwd[512];
+    if (!getcwd(szCwd, sizeof(szCwd)) || chdir(_pTmapDir) != 0)
+    {
+        TEST_CHECK(false, "cannot enter %s", _pTmapDir);
+        return;
+    }
+
+    printf("  from %s.tmap:\n", _pFolder);
+    host_libdragon_stats_t csvStats = g_hostLibdragonStats; /* The CSV importer stays loaded for the comparison */
+    memset(&g_hostLibdragonStats, 0, sizeof(g_hostLibdragonStats));
+    tilemap_importer_t importer;
+    if (test_staged_load(_pFolder, _eType, &importer))
+    {
+        TEST_CHECK(importer.pLayerBlob != NULL, "%s loaded from CSV instead of its .tmap", _pFolder);
+        TEST_CHECK(g_hostLibdragonStats.uSpriteLoads == 0, "baked atlas not used (%lu tile sprites loaded)", (unsigned long)g_hostLibdragonStats.uSpriteLoads);
+        test_compare_importers(_pCsvImporter, &importer);
+        tilemap_importer_free(&importer);
+        TEST_CHECK(g_hostLibdragonStats.iLiveSurfaces == 0, "%d surfaces left after tilemap_importer_free", g_hostLibdragonStats.iLiveSurfaces);
+    }
+    test_abort_all_steps(_pFolder, _eType);
+    uint64_t uTmapUs = test_time_load(_pFolder, _eType);
+    g_hostLibdragonStats = csvStats;
+
+    if (chdir(szCwd) != 0)
+    {
+        TEST_CHECK(false, "cannot return to %s", szCwd);
+        return;
+    }
+    uint64_t uCsvUs = test_time_load(_pFolder, _eType);
+
+    printf("  load time (best of %d): CSV %lu us, .tmap %lu us (%.1fx)\n",
+           TEST_TIMING_RUNS,
+           (unsigned long)uCsvUs,
+           (unsigned long)uTmapUs,
+           uTmapUs > 0 ? (double)uCsvUs / (double)uTmapUs : 0.0);
+}
+
+static void test_map(const char *_pFolder, tilemap_type_t _eType, const char *_pTmapDir)
+{
+    printf("%s (%s)\n", _pFolder, _eType == TILEMAP_TYPE_JNR ? "jnr" : "surface");
+
+    test_tile_ids_t ids;
+    if (!test_load_tile_ids(_pFolder, &ids))
+    {
+        TEST_CHECK(false, "cannot read rom:/%s/tile_ids.csv", _pFolder);
+        return;
+    }
+
+    memset(&g_hostLibdragonStats, 0, sizeof(g_hostLibdragonStats));
+    uint32_t uLoadsBefore = g_hostLibdragonStats.uSpriteLoads;
+    tilemap_importer_t importer;
+    if (!test_staged_load(_pFolder, _eType, &importer))
+        return;
+
+    TEST_CHECK(g_hostLibdragonStats.uSpriteLoads - uLoadsBefore == ids.uTileCount, "%lu sprites loaded for %u tiles", (unsigned long)(g_hostLibdragonStats.uSpriteLoads - uLoadsBefore), (unsigned)ids.uTileCount);
+    TEST_CHECK(!importer.bInitialized || importer.uTileCount == ids.uTileCount, "importer has %u tiles, tile_ids.csv %u", (unsigned)importer.uTileCount, (unsigned)ids.uTileCount);
+
+    for (uint8_t uLayer = 0; uLayer < importer.uLayerCount; ++uLayer)
+    {
+        test_check_layer(_pFolder, uLayer, &importer.aLayers[uLayer], &ids);
+        if (importer.aLayers[uLayer].eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
+            test_check_sparse_row_index(uLayer, &importer.aLayers[uLayer]);
+    }
+    test_check_atlas(_pFolder, &importer, &ids);
+
+    if (_pTmapDir)
+        test_map_tmap(_pFolder, _eType, _pTmapDir, &importer);
+
+    tilemap_importer_free(&importer);
+    TEST_CHECK(g_hostLibdragonStats.iLiveSurfaces == 0, "%d surfaces left after tilemap_importer_free", g_hostLibdragonStats.iLiveSurfaces);
+
+    test_abort_all_steps(_pFolder, _eType);
+}
+
+int main(int _iArgc, char **_ppArgv)
+{
+    const char *pTmapDir = NULL;
+    int iFirstMap = 1;
+    if (_iArgc > 2 && strcmp(_ppArgv[1], "-t") == 0)
+    {
+        pTmapDir = _ppArgv[2];
+        iFirstMap = 3;
+    }
+
+    if (_iArgc <= iFirstMap)
+    {
+        printf("usage: %s [-t <dir>] <folder>:<surface|jnr> ...\n", _ppArgv[0]);
+        return 2;
+    }
+
+    for (int i = iFirstMap; i < _iArgc; ++i)
+    {
+        char szFolder[64];
+        const char *pType = strchr(_ppArgv[i], ':');
+        size_t uLength = pType ? (size_t)(pType - _ppArgv[i]) : strlen(_ppArgv[i]);
+        if (uLength >= sizeof(szFolder))
+            uLength = sizeof(szFolder) - 1;
+        memcpy(szFolder, _ppArgv[i], uLength);
+        szFolder[uLength] = '\0';
+
+        test_map(szFolder, (pType && strcmp(pType + 1, "jnr") == 0) ? TILEMAP_TYPE_JNR : TILEMAP_TYPE_SURFACE, pTmapDir);
+    }
+
+    printf("%s (%d failures)\n", m_iFailures ? "FAILED" : "OK", m_iFailures);
+    return m_iFailures ? 1 : 0;
+}
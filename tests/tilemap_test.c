@@ -0,0 +1,1169 @@
+/* Headless test of the tilemap queries (make host-tests).
+ *
+ * Loads real maps through tilemap_init and checks the optimized paths of tilemap.c against the per-tile
+ * layer lookups they replaced:
+ * - every tile's collision mask code matches the collision, walkable and decoration layers,
+ * - swept player rects classify the same tiles through the mask (row skip + code) as through the layers
+ *   (timings of both are logged),
+ * - tilemap_sweep_box (grid traversal) returns exactly what a scan of the whole swept AABB returns
+ *   (timings of both are logged),
+ * - the sphere factor table matches the per-call lookup it replaced, and
+ *   tilemap_world_to_screen_distorted_batch matches camera_world_to_screen plus that per-call distortion
+ *   over a grid of world positions and camera states,
+ * - a synthetic CHUNKED layer (.tmap chunk table + chunk data; shipped maps never pass
+ *   tilemap_format_prefer_chunked) reads every tile, appends every visibility row and answers
+ *   tilemap_layer_region_is_empty the same as the dense decode of its tiles,
+ * - on JNR maps, the chunk cache draws the same tile as the per-tile path in every cell of its layers (and of a
+ *   dense/chunked fixture pair), including the cells past the map edges,
+ * - SURFACE layer flattening refuses single-tile backgrounds, and on a tiled background every composite
+ *   tile is the background tile with the walkable tile alpha-tested over it (textured rectangles per frame
+ *   for both layers, drawn separately vs. flattened, are logged),
+ * - visiting the maps in turn (staged loads next to the current map, resident maps taken back), the resident
+ *   maps plus the current one never exceed the 4 MB (shrunk to 64 KB) or the Expansion Pak residency budget.
+ *
+ * Usage: tilemap_test <folder>:<surface|jnr> ...
+ * Run where "rom:" points at assets/. */
+
+/* The shipped maps take 20-55 KB each, so the 4 MB residency budget is shrunk to make the LRU evict */
+#define TILEMAP_RESIDENCY_BUDGET_BYTES (64 * 1024)
+#include "../tilemap.c"
+#include "../tilemap_format.h"
+#include "test_common.h"
+
+/* ---------- Collision mask ---------- */
+
+static uint8_t test_layer_tile(uint8_t _uLayer, int _iSampleX, int _iSampleY)
+{
+    const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, _uLayer);
+    if (!tilemap_layer_is_valid(pLayer) || _iSampleX >= (int)pLayer->uWidth || _iSampleY >= (int)pLayer->uHeight)
+        return TILEMAP_IMPORTER_EMPTY_TILE;
+    return tilemap_layer_get_tile(pLayer, _iSampleX, _iSampleY);
+}
+
+/* Reference classification straight from the layers (see tilemap_collision_code_t) */
+static tilemap_collision_code_t test_layer_code(int _iSampleX, int _iSampleY)
+{
+    if (s_eTilemapType == TILEMAP_TYPE_JNR)
+        return test_layer_tile(TILEMAP_LAYER_JNR_COLLISION, _iSampleX, _iSampleY) != TILEMAP_IMPORTER_EMPTY_TILE ? TILEMAP_COLLISION_CODE_SOLID : TILEMAP_COLLISION_CODE_FREE;
+
+    if (test_layer_tile(TILEMAP_LAYER_SURFACE_WALKABLE, _iSampleX, _iSampleY) == TILEMAP_IMPORTER_EMPTY_TILE)
+        return TILEMAP_COLLISION_CODE_HOLE;
+    if (test_layer_tile(TILEMAP_LAYER_SURFACE_COLLISION, _iSampleX, _iSampleY) != TILEMAP_IMPORTER_EMPTY_TILE)
+        return TILEMAP_COLLISION_CODE_SOLID;
+    if (test_layer_tile(TILEMAP_LAYER_SURFACE_DECO_BG, _iSampleX, _iSampleY) != TILEMAP_IMPORTER_EMPTY_TILE ||
+        test_layer_tile(TILEMAP_LAYER_SURFACE_DECO_FG, _iSampleX, _iSampleY) != TILEMAP_IMPORTER_EMPTY_TILE)
+        return TILEMAP_COLLISION_CODE_LANDING_BLOCKED;
+    return TILEMAP_COLLISION_CODE_FREE;
+}
+
+static void test_check_collision_codes(void)
+{
+    const tilemap_collision_mask_t *pMask = &g_mainTilemap.importer.collisionMask;
+    uint32_t uMismatches = 0;
+    uint32_t aCodeCounts[4] = {0};
+    for (int y = 0; y < (int)pMask->uHeight; ++y)
+    {
+        for (int x = 0; x < (int)pMask->uWidth; ++x)
+        {
+            tilemap_collision_code_t eCode = tilemap_collision_code_at(x, y);
+            aCodeCounts[eCode]++;
+            if (eCode != test_layer_code(x, y))
+                uMismatches++;
+        }
+    }
+
+    printf("  collision mask %ux%u: %lu free, %lu solid, %lu hole, %lu landing blocked\n",
+           (unsigned)pMask->uWidth,
+           (unsigned)pMask->uHeight,
+           (unsigned long)aCodeCounts[TILEMAP_COLLISION_CODE_FREE],
+           (unsigned long)aCodeCounts[TILEMAP_COLLISION_CODE_SOLID],
+           (unsigned long)aCodeCounts[TILEMAP_COLLISION_CODE_HOLE],
+           (unsigned long)aCodeCounts[TILEMAP_COLLISION_CODE_LANDING_BLOCKED]);
+    TEST_CHECK(uMismatches == 0, "%lu tiles have a collision code that differs from their layers", (unsigned long)uMismatches);
+}
+
+/* Tiles a sweep collides with, per rect: bit (y - top) * size + (x - left) */
+typedef uint16_t test_rect_hits_t;
+
+#define TEST_SWEEP_RECTS 4096
+#define TEST_SWEEP_MAX_SIZE 3 /* Player-sized rects, 2x2..3x3 tiles */
+
+/* Pseudo-random rect; a few start past the map edges to cover wrapping (SURFACE) and clamping */
+static void test_sweep_rect(uint32_t *_pSeed, const tilemap_layer_t *_pRefLayer, int *_piLeft, int *_piTop, int *_piSize)
+{
+    *_pSeed = *_pSeed * 1664525u + 1013904223u;
+    *_piLeft = (int)((*_pSeed >> 8) % (_pRefLayer->uWidth + 8u)) - 4;
+    *_piTop = (int)((*_pSeed >> 20) % (_pRefLayer->uHeight + 8u)) - 4;
+    *_piSize = 2 + (int)(*_pSeed & 1u);
+}
+
+/* Classify the tiles under the rects through the layers (the sweeps before the mask) and through the mask
+ * (row skip, then one code per tile); both must report the same tiles */
+static void test_check_collision_sweeps(void)
+{
+    const tilemap_layer_t *pRefLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, 0);
+    const bool bSurface = (s_eTilemapType == TILEMAP_TYPE_SURFACE);
+    const tilemap_layer_t *pCollisionLayer =
+        tilemap_importer_get_layer(&g_mainTilemap.importer, bSurface ? TILEMAP_LAYER_SURFACE_COLLISION : TILEMAP_LAYER_JNR_COLLISION);
+    const tilemap_layer_t *pWalkableLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_WALKABLE);
+    if (!tilemap_layer_is_valid(pRefLayer) || !tilemap_layer_is_valid(pCollisionLayer))
+    {
+        TEST_CHECK(false, "map has no collision layer");
+        return;
+    }
+
+    const bool bHasWalkable = bSurface && tilemap_layer_is_valid(pWalkableLayer);
+    const uint8_t uCodeSet = bSurface ? (TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_SOLID) | TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_HOLE))
+                                      : TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_SOLID);
+
+    static test_rect_hits_t s_aLayerHits[TEST_SWEEP_RECTS];
+    static test_rect_hits_t s_aMaskHits[TEST_SWEEP_RECTS];
+    uint32_t uLayerTiles = 0;
+
+    uint32_t uSeed = 0x1234567u;
+    uint64_t uStartUs = get_ticks_us();
+    for (int i = 0; i < TEST_SWEEP_RECTS; ++i)
+    {
+        int iLeft, iTop, iSize;
+        test_sweep_rect(&uSeed, pRefLayer, &iLeft, &iTop, &iSize);
+        test_rect_hits_t uHits = 0;
+        for (int y = iTop; y < iTop + iSize; ++y)
+        {
+            for (int x = iLeft; x < iLeft + iSize; ++x)
+            {
+                int iSampleX, iSampleY;
+                tilemap_resolve_tile_coords(pRefLayer, x, y, &iSampleX, &iSampleY);
+                bool bHit;
+                if (bSurface && (!bHasWalkable || tilemap_layer_get_tile(pWalkableLayer, iSampleX, iSampleY) == TILEMAP_IMPORTER_EMPTY_TILE))
+                    bHit = true;
+                else
+                    bHit = tilemap_layer_get_tile(pCollisionLayer, iSampleX, iSampleY) != TILEMAP_IMPORTER_EMPTY_TILE;
+                if (bHit)
+                {
+                    uHits |= (test_rect_hits_t)(1u << ((y - iTop) * TEST_SWEEP_MAX_SIZE + (x - iLeft)));
+                    uLayerTiles++;
+                }
+            }
+        }
+        s_aLayerHits[i] = uHits;
+    }
+    uint64_t uLayerUs = get_ticks_us() - uStartUs;
+
+    uSeed = 0x1234567u;
+    uStartUs = get_ticks_us();
+    for (int i = 0; i < TEST_SWEEP_RECTS; ++i)
+    {
+        int iLeft, iTop, iSize;
+        test_sweep_rect(&uSeed, pRefLayer, &iLeft, &iTop, &iSize);
+        test_rect_hits_t uHits = 0;
+        for (int y = iTop; y < iTop + iSize; ++y)
+        {
+            if (!tilemap_collision_row_any(y, iLeft, iLeft + iSize - 1, uCodeSet))
+                continue;
+
+            for (int x = iLeft; x < iLeft + iSize; ++x)
+            {
+                int iSampleX, iSampleY;
+                tilemap_resolve_tile_coords(pRefLayer, x, y, &iSampleX, &iSampleY);
+                if (uCodeSet & TILEMAP_COLLISION_SET(tilemap_collision_code_at(iSampleX, iSampleY)))
+                    uHits |= (test_rect_hits_t)(1u << ((y - iTop) * TEST_SWEEP_MAX_SIZE + (x - iLeft)));
+            }
+        }
+        s_aMaskHits[i] = uHits;
+    }
+    uint64_t uMaskUs = get_ticks_us() - uStartUs;
+
+    uint32_t uMismatches = 0;
+    for (int i = 0; i < TEST_SWEEP_RECTS; ++i)
+    {
+        if (s_aLayerHits[i] != s_aMaskHits[i])
+            uMismatches++;
+    }
+
+    printf("  %d swept rects (%lu solid tiles): layer lookups %lu us, mask %lu us\n",
+           TEST_SWEEP_RECTS,
+           (unsigned long)uLayerTiles,
+           (unsigned long)uLayerUs,
+           (unsigned long)uMaskUs);
+    TEST_CHECK(uMismatches == 0, "%lu swept rects hit different tiles through the mask than through the layers", (unsigned long)uMismatches);
+}
+
+/* ---------- Sweep traversal ---------- */
+
+/* Reference sweep: every tile in the AABB of the whole swept box (+1 px), row-major (the pre-traversal algorithm) */
+static tilemap_sweep_result_t test_sweep_box_scan(struct vec2 _vStartPos, struct vec2 _vDelta, struct vec2 _vHalfExtents, tilemap_collision_type_t _eType)
+{
+    tilemap_sweep_result_t result = {1.0f, {0.0f, 0.0f}, false, false};
+    tilemap_sweep_world_bounds(_vStartPos, _vDelta, _vHalfExtents, &result);
+
+    tilemap_sweep_state_t state;
+    if (!tilemap_sweep_state_init(&state, _vStartPos, _vDelta, _vHalfExtents, _eType))
+        return result;
+
+    float fMinX = fminf(_vStartPos.fX, _vStartPos.fX + _vDelta.fX) - _vHalfExtents.fX;
+    float fMaxX = fmaxf(_vStartPos.fX, _vStartPos.fX + _vDelta.fX) + _vHalfExtents.fX;
+    float fMinY = fminf(_vStartPos.fY, _vStartPos.fY + _vDelta.fY) - _vHalfExtents.fY;
+    float fMaxY = fmaxf(_vStartPos.fY, _vStartPos.fY + _vDelta.fY) + _vHalfExtents.fY;
+
+    int iTileMinX = (int)fm_floorf((fMinX - 1.0f) / (float)TILE_SIZE);
+    int iTileMaxX = (int)fm_ceilf((fMaxX + 1.0f) / (float)TILE_SIZE);
+    int iTileMinY = (int)fm_floorf((fMinY - 1.0f) / (float)TILE_SIZE);
+    int iTileMaxY = (int)fm_ceilf((fMaxY + 1.0f) / (float)TILE_SIZE);
+
+    for (int iTileY = iTileMinY; iTileY <= iTileMaxY; ++iTileY)
+    {
+        for (int iTileX = iTileMinX; iTileX <= iTileMaxX; ++iTileX)
+            tilemap_sweep_test_tile(&state, iTileX, iTileY);
+    }
+
+    tilemap_sweep_merge_best(&state, &result);
+    return result;
+}
+
+#define TEST_SWEEP_MOVES 8192
+
+/* Pseudo-random player-sized moves over the map (short steps, long diagonals, straight falls and jumps,
+ * some starting outside the world), both sweep types on each map */
+static void test_check_sweep_traversal(void)
+{
+    const float fWorldWidth = (float)(g_mainTilemap.uWorldWidthTiles * TILE_SIZE);
+    const float fWorldHeight = (float)(g_mainTilemap.uWorldHeightTiles * TILE_SIZE);
+
+    for (int iType = 0; iType < 2; ++iType)
+    {
+        const tilemap_collision_type_t eType = (iType == 0) ? TILEMAP_COLLISION_JNR : TILEMAP_COLLISION_SURFACE;
+        uint32_t uSeed = 0x2545F491u;
+        int iHits = 0;
+        int iMismatches = 0;
+        uint64_t uScanUs = 0, uTraversalUs = 0;
+
+        for (int i = 0; i < TEST_SWEEP_MOVES; ++i)
+        {
+            uSeed = uSeed * 1664525u + 1013904223u;
+            struct vec2 vStart = vec2_make(((float)(uSeed >> 8) / 16777216.0f * 1.1f - 0.05f) * fWorldWidth, ((float)(uSeed & 0xFFFFu) / 65536.0f * 1.1f - 0.05f) * fWorldHeight);
+            uSeed = uSeed * 1664525u + 1013904223u;
+            float fReach = (i & 3) == 0 ? 160.0f : 24.0f;
+            struct vec2 vDelta = vec2_make(((float)(uSeed >> 16) / 32768.0f - 1.0f) * fReach, ((float)(uSeed & 0xFFFFu) / 32768.0f - 1.0f) * fReach);
+            if ((i & 7) == 1)
+                vDelta.fX = 0.0f; /* Straight fall / jump */
+            else if ((i & 7) == 5)
+                vDelta.fY = 0.0f; /* Horizontal run */
+            struct vec2 vHalfExtents = vec2_make(5.0f + (float)(uSeed & 3u), 7.0f + (float)((uSeed >> 2) & 3u));
+
+            uint64_t uStartUs = get_ticks_us();
+            tilemap_sweep_result_t tScan = test_sweep_box_scan(vStart, vDelta, vHalfExtents, eType);
+            uScanUs += get_ticks_us() - uStartUs;
+
+            uStartUs = get_ticks_us();
+            tilemap_sweep_result_t tTraversal = tilemap_sweep_box(vStart, vDelta, vHalfExtents, eType);
+            uTraversalUs += get_ticks_us() - uStartUs;
+
+            if (tScan.bHit)
+                iHits++;
+
+            if (tScan.bHit != tTraversal.bHit || tScan.fTime != tTraversal.fTime || tScan.vNormal.fX != tTraversal.vNormal.fX || tScan.vNormal.fY != tTraversal.vNormal.fY ||
+                tScan.bCornerish != tTraversal.bCornerish)
+            {
+                if (iMismatches < 4)
+                    printf("  sweep mismatch: start (%.2f, %.2f) delta (%.2f, %.2f): scan t=%.4f, traversal t=%.4f\n",
+                           vStart.fX,
+                           vStart.fY,
+                           vDelta.fX,
+                           vDelta.fY,
+                           tScan.fTime,
+                           tTraversal.fTime);
+                iMismatches++;
+            }
+        }
+
+        printf("  %s sweeps: %d moves (%d hits), scan %lu us, traversal %lu us\n",
+               eType == TILEMAP_COLLISION_JNR ? "JNR" : "SURFACE",
+               TEST_SWEEP_MOVES,
+               iHits,
+               (unsigned long)uScanUs,
+               (unsigned long)uTraversalUs);
+        TEST_CHECK(iMismatches == 0, "%d of %d sweeps differ between traversal and full scan", iMismatches, TEST_SWEEP_MOVES);
+    }
+}
+
+/* ---------- Sphere distortion ---------- */
+
+#define TEST_SPHERE_CACHE_MAX 32
+
+/* Reference: the per-call factor lookup the table replaced (linear search over a small cache, fm_cosf on miss),
+ * verbatim, so the test compares against the old arithmetic rather than the table's own builder */
+static int32_t test_sphere_factor_q16_cached(int16_t _iSampleY, int16_t *_pACacheY, int32_t *_pACacheFq, uint8_t *_pUCacheCount, int16_t _iCenterY)
+{
+    /* Use absolute Y distance from center for quadrant mirroring */
+    int16_t iAbsDeltaY = (int16_t)abs((int)_iSampleY - (int)_iCenterY);
+
+    /* Search cache by absolute distance (not signed Y) */
+    for (uint8_t i = 0; i < *_pUCacheCount; ++i)
+    {
+        if (_pACacheY[i] == iAbsDeltaY)
+            return _pACacheFq[i];
+    }
+
+    float fFactor = 1.0f;
+
+    if (_iCenterY > 0)
+    {
+        /* Use absolute deltaY since cos is even: cos(-x) = cos(x) */
+        float fDeltaY = (float)iAbsDeltaY;
+        float fLatScale = (FM_PI * 0.5f) / (float)_iCenterY;
+        float fLatitude = fDeltaY * fLatScale;
+
+        float fCosLat = fm_cosf(fLatitude);
+        float fStrength = TILEMAP_SPHERE_STRENGTH;
+
+        fFactor = (1.0f - fStrength) + (fStrength * fCosLat);
+
+        if (fFactor < 0.0f)
+            fFactor = 0.0f;
+        if (fFactor > 1.0f)
+            fFactor = 1.0f;
+    }
+
+    int32_t iFactorQ = (int32_t)(fFactor * 65536.0f + 0.5f);
+
+    if (*_pUCacheCount < TEST_SPHERE_CACHE_MAX)
+    {
+        /* Cache by absolute distance, not signed Y */
+        _pACacheY[*_pUCacheCount] = iAbsDeltaY;
+        _pACacheFq[*_pUCacheCount] = iFactorQ;
+        (*_pUCacheCount)++;
+    }
+
+    return iFactorQ;
+}
+
+/* Reference: the per-call tilemap_world_to_screen_distorted before the batch version */
+static bool test_world_to_screen_distorted_ref(struct vec2 _vWorldPos, struct vec2i *_pOutScreen)
+{
+    struct vec2i vScreenBase;
+    camera_world_to_screen(&g_mainCamera, _vWorldPos, &vScreenBase);
+
+    int16_t iCenterX = (int16_t)g_mainCamera.vHalf.iX;
+    int16_t iCenterY = (int16_t)g_mainCamera.vHalf.iY;
+
+    int16_t aCacheY[TEST_SPHERE_CACHE_MAX];
+    int32_t aCacheFq[TEST_SPHERE_CACHE_MAX];
+    uint8_t uCacheCount = 0;
+    int32_t iFactorQ = test_sphere_factor_q16_cached((int16_t)vScreenBase.iY, aCacheY, aCacheFq, &uCacheCount, iCenterY);
+
+    int iOffsetX = vScreenBase.iX - (int)iCenterX;
+    _pOutScreen->iX = tilemap_apply_sphere_distortion_x((int)iCenterX, iOffsetX, iFactorQ);
+    _pOutScreen->iY = vScreenBase.iY;
+
+    return (_pOutScreen->iX >= 0 && _pOutScreen->iX < SCREEN_W && vScreenBase.iY >= 0 && vScreenBase.iY < SCREEN_H);
+}
+
+/* Table vs. per-call lookup for several center rows, over rows inside and beyond the table, plus fixed factors */
+static void test_check_sphere_factors(void)
+{
+    int iMismatches = 0;
+    const int16_t iCenterY = (int16_t)(SCREEN_H / 2);
+    const int16_t aCenters[] = {iCenterY, 1, 60, (int16_t)(SCREEN_H - 1)};
+    for (size_t c = 0; c < sizeof(aCenters) / sizeof(aCenters[0]); ++c)
+    {
+        for (int iY = -TILEMAP_SPHERE_LUT_ROWS - 64; iY < SCREEN_H + TILEMAP_SPHERE_LUT_ROWS + 64; ++iY)
+        {
+            int16_t aCacheY[1];
+            int32_t aCacheFq[1];
+            uint8_t uCacheCount = 0;
+            if (test_sphere_factor_q16_cached((int16_t)iY, aCacheY, aCacheFq, &uCacheCount, aCenters[c]) != tilemap_get_sphere_factor_q16(iY, aCenters[c]))
+                iMismatches++;
+        }
+    }
+    TEST_CHECK(iMismatches == 0, "%d sphere factors differ from the per-call lookup", iMismatches);
+
+    /* No shrink on the center row, full TILEMAP_SPHERE_STRENGTH shrink at the poles (cos = 0) */
+    const int32_t iPoleQ16 = (int32_t)((1.0f - TILEMAP_SPHERE_STRENGTH) * 65536.0f + 0.5f);
+    TEST_CHECK(tilemap_get_sphere_factor_q16(iCenterY, iCenterY) == 65536, "center row factor is not 1.0");
+    TEST_CHECK(abs((int)(tilemap_get_sphere_factor_q16(0, iCenterY) - iPoleQ16)) <= 1 && abs((int)(tilemap_get_sphere_factor_q16(2 * iCenterY, iCenterY) - iPoleQ16)) <= 1,
+               "pole factors are not 1 - TILEMAP_SPHERE_STRENGTH");
+}
+
+#define TEST_PROJECT_GRID 48 /* Points per axis, spread over and beyond the visible area */
+
+/* Batch projection vs. camera_world_to_screen + per-call distortion, point by point, over camera positions
+ * (inside, at and across the world edges), zooms and viewport sizes */
+static void test_check_distorted_projection(void)
+{
+    const camera2D savedCamera = g_mainCamera;
+    const float fWorldWidth = (float)(g_mainTilemap.uWorldWidthTiles * TILE_SIZE);
+    const float fWorldHeight = (float)(g_mainTilemap.uWorldHeightTiles * TILE_SIZE);
+    const struct vec2 aCamPos[] = {{0.0f, 0.0f}, {fWorldWidth * 0.5f, fWorldHeight * 0.5f}, {fWorldWidth - 0.25f, fWorldHeight}, {-37.6f, 12.3f}, {123.456f, 78.9f}, {fWorldWidth + 5.5f, -3.25f}};
+    const float aZooms[] = {1.0f, 0.5f, 0.73f, 1.25f, 2.0f, 3.3f};
+    const struct vec2i aHalves[] = {{160, 120}, {320, 240}, {161, 119}};
+
+    static struct vec2 s_aWorld[TEST_PROJECT_GRID * TEST_PROJECT_GRID];
+    static struct vec2i s_aScreen[TEST_PROJECT_GRID * TEST_PROJECT_GRID];
+    static bool s_aVisible[TEST_PROJECT_GRID * TEST_PROJECT_GRID];
+    const uint16_t uCount = TEST_PROJECT_GRID * TEST_PROJECT_GRID;
+
+    uint32_t uPoints = 0;
+    uint32_t uMismatches = 0;
+    uint32_t uVisibleMismatches = 0;
+    uint64_t uRefUs = 0, uBatchUs = 0;
+
+    for (size_t h = 0; h < sizeof(aHalves) / sizeof(aHalves[0]); ++h)
+    {
+        for (size_t z = 0; z < sizeof(aZooms) / sizeof(aZooms[0]); ++z)
+        {
+            for (size_t c = 0; c < sizeof(aCamPos) / sizeof(aCamPos[0]); ++c)
+            {
+                g_mainCamera.vHalf = aHalves[h];
+                g_mainCamera.vPos = aCamPos[c];
+                camera_set_zoom(&g_mainCamera, aZooms[z]);
+
+                /* Grid over twice the visible extent, off the pixel lattice */
+                float fSpanX = 4.0f * (float)aHalves[h].iX / aZooms[z];
+                float fSpanY = 4.0f * (float)aHalves[h].iY / aZooms[z];
+                for (int gy = 0; gy < TEST_PROJECT_GRID; ++gy)
+                {
+                    for (int gx = 0; gx < TEST_PROJECT_GRID; ++gx)
+                    {
+                        s_aWorld[gy * TEST_PROJECT_GRID + gx] = vec2_make(aCamPos[c].fX + ((float)gx / (TEST_PROJECT_GRID - 1) - 0.5f) * fSpanX + 0.37f,
+                                                                          aCamPos[c].fY + ((float)gy / (TEST_PROJECT_GRID - 1) - 0.5f) * fSpanY + 0.61f);
+                    }
+                }
+
+                uint64_t uStartUs = get_ticks_us();
+                uint16_t uVisible = tilemap_world_to_screen_distorted_batch(s_aWorld, s_aScreen, s_aVisible, uCount);
+                uBatchUs += get_ticks_us() - uStartUs;
+
+                uint16_t uRefVisible = 0;
+                uStartUs = get_ticks_us();
+                for (uint16_t i = 0; i < uCount; ++i)
+                {
+                    struct vec2i vRef;
+                    bool bRefVisible = test_world_to_screen_distorted_ref(s_aWorld[i], &vRef);
+                    uRefVisible += bRefVisible ? 1 : 0;
+                    if (vRef.iX != s_aScreen[i].iX || vRef.iY != s_aScreen[i].iY)
+                    {
+                        if (uMismatches < 4)
+                            printf("  projection mismatch: world (%.2f, %.2f) cam (%.2f, %.2f) zoom %.2f: per-call (%d, %d), batch (%d, %d)\n",
+                                   s_aWorld[i].fX,
+                                   s_aWorld[i].fY,
+                                   aCamPos[c].fX,
+                                   aCamPos[c].fY,
+                                   aZooms[z],
+                                   vRef.iX,
+                                   vRef.iY,
+                                   s_aScreen[i].iX,
+                                   s_aScreen[i].iY);
+                        uMismatches++;
+                    }
+                    if (bRefVisible != s_aVisible[i])
+                        uVisibleMismatches++;
+                }
+                uRefUs += get_ticks_us() - uStartUs;
+
+                TEST_CHECK(uVisible == uRefVisible, "batch reports %u visible points, per-call %u", (unsigned)uVisible, (unsigned)uRefVisible);
+                uPoints += uCount;
+            }
+        }
+    }
+
+    g_mainCamera = savedCamera;
+
+    printf("  distorted projection: %lu points, per-call %lu us, batch %lu us\n", (unsigned long)uPoints, (unsigned long)uRefUs, (unsigned long)uBatchUs);
+    TEST_CHECK(uMismatches == 0, "%lu batch projections differ from the per-call path", (unsigned long)uMismatches);
+    TEST_CHECK(uVisibleMismatches == 0, "%lu batch visibility flags differ from the per-call path", (unsigned long)uVisibleMismatches);
+}
+
+/* ---------- Layer flattening ---------- */
+
+/* Rebuild every layer's visibility from scratch on the next tilemap_update */
+static void test_invalidate_visibility(void)
+{
+    const tilemap_flat_layer_t *pFlat = &g_mainTilemap.importer.flat;
+    for (uint8_t i = 0; i < TILEMAP_IMPORTER_MAX_LAYERS; ++i)
+    {
+        tile_layer_visibility_t *pVis = &g_mainTilemap.aLayerVisibility[i];
+        pVis->bFlat = pFlat->bActive && i == pFlat->uLowerLayer;
+        tilemap_layer_visibility_reset(pVis);
+        pVis->uVisibleCount = 0;
+        pVis->bLastRectValid = false;
+    }
+}
+
+/* Textured rectangles for background + walkable per frame, averaged over 6x4 screen-sized views across the map */
+static double test_surface_base_rects_per_frame(void)
+{
+    const tilemap_layer_t *pRef = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_WALKABLE);
+    const float fWorldW = (float)pRef->uWidth * TILE_SIZE;
+    const float fWorldH = (float)pRef->uHeight * TILE_SIZE;
+    uint32_t uDraws = 0;
+    int iViews = 0;
+
+    test_invalidate_visibility();
+    for (int iY = 0; iY < 4; ++iY)
+    {
+        for (int iX = 0; iX < 6; ++iX)
+        {
+            g_mainCamera.vPos = vec2_make(floorf(((float)iX + 0.5f) * fWorldW / 6.0f), floorf(((float)iY + 0.5f) * fWorldH / 4.0f));
+            tilemap_update();
+            uint32_t uBefore = g_hostLibdragonStats.uRdpqDraws;
+            tilemap_render_layers(TILEMAP_LAYER_SURFACE_BACKGROUND, TILEMAP_LAYER_SURFACE_WALKABLE, TILEMAP_RENDER_MODE_TEXTURE);
+            uDraws += g_hostLibdragonStats.uRdpqDraws - uBefore;
+            iViews++;
+        }
+    }
+    return (double)uDraws / iViews;
+}
+
+/* Every composite tile is its lower tile with the upper tile drawn over it where the upper alpha bit is set,
+ * and each composite ID stands for one (lower, upper) pair */
+static void test_check_flat_composites(const tilemap_layer_t *_pLower, const tilemap_layer_t *_pUpper)
+{
+    const tilemap_importer_t *pImporter = &g_mainTilemap.importer;
+    const tilemap_flat_layer_t *pFlat = &pImporter->flat;
+    int16_t aPairOf[TILEMAP_IMPORTER_MAX_TILES];
+    for (int i = 0; i < TILEMAP_IMPORTER_MAX_TILES; ++i)
+        aPairOf[i] = -1;
+
+    uint32_t uPairMismatches = 0;
+    uint32_t uPixelMismatches = 0;
+    for (uint16_t uY = 0; uY < _pLower->uHeight; ++uY)
+    {
+        for (uint16_t uX = 0; uX < _pLower->uWidth; ++uX)
+        {
+            uint8_t uLower = tilemap_layer_get_tile(_pLower, uX, uY);
+            uint8_t uUpper = tilemap_layer_get_tile(_pUpper, uX, uY);
+            uint8_t uFlat = tilemap_layer_get_tile(&pFlat->layer, uX, uY);
+            if (uLower == TILEMAP_IMPORTER_EMPTY_TILE && uUpper == TILEMAP_IMPORTER_EMPTY_TILE)
+            {
+                uPairMismatches += (uFlat != TILEMAP_IMPORTER_EMPTY_TILE);
+                continue;
+            }
+
+            int16_t iPair = (int16_t)((uLower << 8) | uUpper);
+            if (uFlat >= pFlat->uTileCount || (aPairOf[uFlat] >= 0 && aPairOf[uFlat] != iPair))
+            {
+                uPairMismatches++;
+                continue;
+            }
+            if (aPairOf[uFlat] >= 0)
+                continue;
+            aPairOf[uFlat] = iPair;
+
+            tile_atlas_entry_t flatEntry, lowerEntry, upperEntry;
+            tilemap_importer_get_flat_atlas_entry(pImporter, uFlat, &flatEntry);
+            const surface_t *pFlatPage = tilemap_importer_get_flat_atlas_page(pImporter, flatEntry.uPageIndex);
+            bool bLower = uLower != TILEMAP_IMPORTER_EMPTY_TILE && tilemap_importer_get_atlas_entry(pImporter, uLower, &lowerEntry);
+            bool bUpper = uUpper != TILEMAP_IMPORTER_EMPTY_TILE && tilemap_importer_get_atlas_entry(pImporter, uUpper, &upperEntry);
+            const surface_t *pLowerPage = bLower ? tilemap_importer_get_atlas_page(pImporter, lowerEntry.uPageIndex) : NULL;
+            const surface_t *pUpperPage = bUpper ? tilemap_importer_get_atlas_page(pImporter, upperEntry.uPageIndex) : NULL;
+            for (int iPy = 0; iPy < TILE_SIZE; ++iPy)
+            {
+                for (int iPx = 0; iPx < TILE_SIZE; ++iPx)
+                {
+                    uint16_t uExpected = 0;
+                    if (pLowerPage)
+                        uExpected = ((const uint16_t *)((const uint8_t *)pLowerPage->buffer + (size_t)(lowerEntry.uV0 + iPy) * pLowerPage->stride))[lowerEntry.uU0 + iPx];
+                    if (pUpperPage)
+                    {
+                        uint16_t uUpperPixel = ((const uint16_t *)((const uint8_t *)pUpperPage->buffer + (size_t)(upperEntry.uV0 + iPy) * pUpperPage->stride))[upperEntry.uU0 + iPx];
+                        if (uUpperPixel & 1u)
+                            uExpected = uUpperPixel;
+                    }
+                    uint16_t uActual = ((const uint16_t *)((const uint8_t *)pFlatPage->buffer + (size_t)(flatEntry.uV0 + iPy) * pFlatPage->stride))[flatEntry.uU0 + iPx];
+                    uPixelMismatches += (uActual != uExpected);
+                }
+            }
+        }
+    }
+    TEST_CHECK(uPairMismatches == 0, "%lu cells have a composite that is not their (background, walkable) pair", (unsigned long)uPairMismatches);
+    TEST_CHECK(uPixelMismatches == 0, "%lu composite pixels differ from background + alpha-tested walkable", (unsigned long)uPixelMismatches);
+}
+
+/* Flattening refuses the shipped single-tile backgrounds (one rectangle already). A tiled background built from
+ * two of the map's tiles is flattened: composites must match the two layers drawn back to back, and the
+ * rectangles per frame with and without flattening are logged. */
+static void test_check_flatten(void)
+{
+    tilemap_importer_t *pImporter = &g_mainTilemap.importer;
+    tilemap_layer_t *pBackground = &pImporter->aLayers[TILEMAP_LAYER_SURFACE_BACKGROUND];
+    const tilemap_layer_t *pWalkable = &pImporter->aLayers[TILEMAP_LAYER_SURFACE_WALKABLE];
+    camera_init(&g_mainCamera, SCREEN_W, SCREEN_H);
+
+    if (pBackground->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
+    {
+        double fSingleRects = test_surface_base_rects_per_frame();
+        g_bHostLibdragonQuiet = true;
+        bool bFlattened = tilemap_importer_flatten_layers(pImporter, TILEMAP_LAYER_SURFACE_BACKGROUND, TILEMAP_LAYER_SURFACE_WALKABLE);
+        g_bHostLibdragonQuiet = false;
+        TEST_CHECK(!bFlattened, "flattening accepted a single-tile background");
+        printf("  flatten: single-tile background, %.1f rects/frame, not flattened\n", fSingleRects);
+    }
+
+    /* Tiled background: 3x2 blocks alternating between the first two tile IDs of the walkable layer */
+    uint8_t aIds[2] = {TILEMAP_IMPORTER_EMPTY_TILE, TILEMAP_IMPORTER_EMPTY_TILE};
+    for (uint16_t uY = 0; uY < pWalkable->uHeight && aIds[1] == TILEMAP_IMPORTER_EMPTY_TILE; ++uY)
+    {
+        for (uint16_t uX = 0; uX < pWalkable->uWidth; ++uX)
+        {
+            uint8_t uTile = tilemap_layer_get_tile(pWalkable, uX, uY);
+            if (uTile == TILEMAP_IMPORTER_EMPTY_TILE || uTile == aIds[0])
+                continue;
+            if (aIds[0] == TILEMAP_IMPORTER_EMPTY_TILE)
+                aIds[0] = uTile;
+            else
+            {
+                aIds[1] = uTile;
+                break;
+            }
+        }
+    }
+    TEST_CHECK(aIds[1] != TILEMAP_IMPORTER_EMPTY_TILE, "walkable layer has fewer than two tile IDs");
+    if (aIds[1] == TILEMAP_IMPORTER_EMPTY_TILE)
+        return;
+
+    tilemap_layer_t shipped = *pBackground;
+    tilemap_layer_t tiled = {0};
+    tiled.eStorage = TILEMAP_LAYER_STORAGE_DENSE;
+    tiled.uWidth = pWalkable->uWidth;
+    tiled.uHeight = pWalkable->uHeight;
+    tiled.uTileCount = (uint16_t)((uint32_t)tiled.uWidth * tiled.uHeight > 0xFFFF ? 0xFFFF : (uint32_t)tiled.uWidth * tiled.uHeight);
+    tiled.pData = (uint8_t *)malloc((size_t)tiled.uWidth * tiled.uHeight);
+    tiled.ppData = (uint8_t **)malloc(sizeof(uint8_t *) * tiled.uHeight);
+    for (uint16_t uY = 0; uY < tiled.uHeight; ++uY)
+    {
+        tiled.ppData[uY] = tiled.pData + (size_t)uY * tiled.uWidth;
+        for (uint16_t uX = 0; uX < tiled.uWidth; ++uX)
+            tiled.ppData[uY][uX] = aIds[((uX / 3) + (uY / 2)) & 1];
+    }
+    *pBackground = tiled;
+
+    double fSeparateRects = test_surface_base_rects_per_frame();
+    g_bHostLibdragonQuiet = true;
+    bool bFlattened = tilemap_importer_flatten_layers(pImporter, TILEMAP_LAYER_SURFACE_BACKGROUND, TILEMAP_LAYER_SURFACE_WALKABLE);
+    g_bHostLibdragonQuiet = false;
+    TEST_CHECK(bFlattened, "flattening a tiled background failed");
+    if (bFlattened)
+    {
+        test_check_flat_composites(pBackground, pWalkable);
+        double fFlatRects = test_surface_base_rects_per_frame();
+        TEST_CHECK(fFlatRects < fSeparateRects, "flattened layers take %.1f rects/frame, separate %.1f", fFlatRects, fSeparateRects);
+        printf("  flatten: tiled background, %.1f rects/frame separate, %.1f flattened (%u composite tiles)\n",
+               fSeparateRects,
+               fFlatRects,
+               (unsigned)pImporter->flat.uTileCount);
+    }
+
+    /* Back to the shipped layer; the composite is released with the importer */
+    *pBackground = shipped;
+    free(tiled.ppData);
+    free(tiled.pData);
+    pImporter->flat.bActive = false;
+    test_invalidate_visibility();
+}
+
+/* ---------- Chunked layers ---------- */
+
+/* Shipped maps never pass tilemap_format_prefer_chunked, so the chunked paths are checked on a synthetic layer:
+ * its chunk table and chunk data are laid out as in a .tmap CHUNKED payload, next to the dense decode of the
+ * same tiles. */
+typedef struct
+{
+    tilemap_layer_t dense;
+    tilemap_layer_t chunked;
+    uint32_t aKindCount[3]; /* Empty, uniform and mixed chunks */
+} test_chunked_fixture_t;
+
+static uint32_t test_hash(int _iX, int _iY)
+{
+    uint32_t uHash = ((uint32_t)_iX * 73856093u) ^ ((uint32_t)_iY * 19349663u);
+    uHash ^= uHash >> 15;
+    uHash *= 0x2C1B3C6Du;
+    uHash ^= uHash >> 12;
+    return uHash;
+}
+
+/* Two tile IDs the map's atlas knows, taken from the first non-empty cells of its layers */
+static bool test_pick_tile_ids(uint8_t _aIds[2])
+{
+    int iFound = 0;
+    for (uint8_t uLayer = 0; uLayer < TILEMAP_IMPORTER_MAX_LAYERS && iFound < 2; ++uLayer)
+    {
+        const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, uLayer);
+        if (!tilemap_layer_is_valid(pLayer))
+            continue;
+        for (uint16_t uY = 0; uY < pLayer->uHeight && iFound < 2; ++uY)
+        {
+            for (uint16_t uX = 0; uX < pLayer->uWidth && iFound < 2; ++uX)
+            {
+                uint8_t uTile = tilemap_layer_get_tile(pLayer, uX, uY);
+                tile_atlas_entry_t entry;
+                if (uTile == TILEMAP_IMPORTER_EMPTY_TILE || (iFound == 1 && uTile == _aIds[0]) || !tilemap_importer_get_atlas_entry(&g_mainTilemap.importer, uTile, &entry))
+                    continue;
+                _aIds[iFound++] = uTile;
+            }
+        }
+    }
+    return iFound == 2;
+}
+
+/* 3 chunks in 8 are empty, 3 uniform (either ID) and 2 mixed: holes and both IDs hashed per tile */
+static uint8_t test_chunked_fixture_tile(int _iX, int _iY, const uint8_t _aIds[2])
+{
+    uint32_t uKind = test_hash(_iX >> TILEMAP_CHUNK_SHIFT, _iY >> TILEMAP_CHUNK_SHIFT) & 7u;
+    if (uKind < 3)
+        return TILEMAP_IMPORTER_EMPTY_TILE;
+    if (uKind < 6)
+        return _aIds[uKind & 1u];
+
+    uint32_t uTile = test_hash(_iX + 7919, _iY) % 3u;
+    return uTile == 2 ? TILEMAP_IMPORTER_EMPTY_TILE : _aIds[uTile];
+}
+
+/* Dense rows plus the chunked payload (chunk table padded by tilemap_format_chunk_table_size, then 256 tiles per
+ * mixed chunk with empty edge padding), encoded like tmap_convert's write_chunked_payload */
+static bool test_chunked_fixture_build(test_chunked_fixture_t *_pFixture, uint16_t _uWidth, uint16_t _uHeight, const uint8_t _aIds[2])
+{
+    memset(_pFixture, 0, sizeof(*_pFixture));
+    tilemap_layer_t *pDense = &_pFixture->dense;
+    pDense->eStorage = TILEMAP_LAYER_STORAGE_DENSE;
+    pDense->uWidth = _uWidth;
+    pDense->uHeight = _uHeight;
+    pDense->pData = (uint8_t *)malloc((size_t)_uWidth * _uHeight);
+    pDense->ppData = (uint8_t **)malloc(sizeof(uint8_t *) * _uHeight);
+    uint32_t uTileCount = 0;
+    for (uint16_t uY = 0; uY < _uHeight; ++uY)
+    {
+        pDense->ppData[uY] = pDense->pData + (size_t)uY * _uWidth;
+        for (uint16_t uX = 0; uX < _uWidth; ++uX)
+        {
+            pDense->ppData[uY][uX] = test_chunked_fixture_tile(uX, uY, _aIds);
+            uTileCount += (pDense->ppData[uY][uX] != TILEMAP_IMPORTER_EMPTY_TILE);
+        }
+    }
+    pDense->uTileCount = (uint16_t)(uTileCount > 0xFFFF ? 0xFFFF : uTileCount);
+
+    tilemap_layer_t *pChunked = &_pFixture->chunked;
+    *pChunked = *pDense;
+    pChunked->eStorage = TILEMAP_LAYER_STORAGE_CHUNKED;
+    pChunked->pData = NULL;
+    pChunked->ppData = NULL;
+    pChunked->uChunksX = (uint16_t)((_uWidth + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT);
+    pChunked->uChunksY = (uint16_t)((_uHeight + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT);
+
+    /* Worst case: every chunk mixed */
+    const uint32_t uTableSize = tilemap_format_chunk_table_size(_uWidth, _uHeight);
+    const uint32_t uChunkCount = (uint32_t)pChunked->uChunksX * pChunked->uChunksY;
+    uint8_t *pPayload = (uint8_t *)malloc(uTableSize + (size_t)uChunkCount * TILEMAP_CHUNK_TILES);
+    pChunked->pChunks = (tilemap_chunk_t *)pPayload;
+    pChunked->pChunkData = pPayload + uTableSize;
+    memset(pChunked->pChunkData, TILEMAP_IMPORTER_EMPTY_TILE, (size_t)uChunkCount * TILEMAP_CHUNK_TILES);
+
+    uint16_t uMixed = 0;
+    for (uint16_t uCy = 0; uCy < pChunked->uChunksY; ++uCy)
+    {
+        for (uint16_t uCx = 0; uCx < pChunked->uChunksX; ++uCx)
+        {
+            const int iX0 = uCx << TILEMAP_CHUNK_SHIFT;
+            const int iY0 = uCy << TILEMAP_CHUNK_SHIFT;
+            const int iX1 = iX0 + TILEMAP_CHUNK_SIZE < _uWidth ? iX0 + TILEMAP_CHUNK_SIZE : _uWidth;
+            const int iY1 = iY0 + TILEMAP_CHUNK_SIZE < _uHeight ? iY0 + TILEMAP_CHUNK_SIZE : _uHeight;
+            const uint8_t uFirst = pDense->ppData[iY0][iX0];
+            bool bUniform = true;
+            for (int iY = iY0; iY < iY1 && bUniform; ++iY)
+            {
+                for (int iX = iX0; iX < iX1 && bUniform; ++iX)
+                    bUniform = pDense->ppData[iY][iX] == uFirst;
+            }
+
+            tilemap_chunk_t *pChunk = &pChunked->pChunks[(uint32_t)uCy * pChunked->uChunksX + uCx];
+            pChunk->uPadding = 0;
+            if (bUniform)
+            {
+                pChunk->uDataIndex = TILEMAP_CHUNK_UNIFORM;
+                pChunk->uTileId = uFirst;
+                _pFixture->aKindCount[uFirst == TILEMAP_IMPORTER_EMPTY_TILE ? 0 : 1]++;
+                continue;
+            }
+
+            pChunk->uDataIndex = uMixed;
+            pChunk->uTileId = TILEMAP_IMPORTER_EMPTY_TILE;
+            uint8_t *pDst = pChunked->pChunkData + (size_t)uMixed * TILEMAP_CHUNK_TILES;
+            for (int iY = iY0; iY < iY1; ++iY)
+                memcpy(pDst + ((iY - iY0) << TILEMAP_CHUNK_SHIFT), &pDense->ppData[iY][iX0], (size_t)(iX1 - iX0));
+            uMixed++;
+            _pFixture->aKindCount[2]++;
+        }
+    }
+    pChunked->uMixedChunkCount = uMixed;
+    return tilemap_format_prefer_chunked(_uWidth, _uHeight, uMixed) != 0;
+}
+
+static void test_chunked_fixture_free(test_chunked_fixture_t *_pFixture)
+{
+    free(_pFixture->dense.ppData);
+    free(_pFixture->dense.pData);
+    free(_pFixture->chunked.pChunks);
+}
+
+static void test_visibility_clear(tile_layer_visibility_t *_pVis)
+{
+    tilemap_layer_visibility_reset(_pVis);
+    _pVis->uVisibleCount = 0;
+    _pVis->bTruncated = false;
+}
+
+/* Same buckets holding the same entries in the same order */
+static bool test_visibility_equal(const tile_layer_visibility_t *_pA, const tile_layer_visibility_t *_pB)
+{
+    if (_pA->uBucketCount != _pB->uBucketCount || _pA->uVisibleCount != _pB->uVisibleCount || _pA->bTruncated != _pB->bTruncated)
+        return false;
+    for (uint16_t i = 0; i < _pA->uBucketCount; ++i)
+    {
+        const tile_bucket_t *pA = &_pA->pBuckets[i];
+        const tile_bucket_t *pB = &_pB->pBuckets[i];
+        if (pA->uPageId != pB->uPageId || pA->uCount != pB->uCount || memcmp(pA->aTileX, pB->aTileX, sizeof(int16_t) * pA->uCount) != 0 ||
+            memcmp(pA->aTileY, pB->aTileY, sizeof(int16_t) * pA->uCount) != 0 || memcmp(pA->aTileId, pB->aTileId, pA->uCount) != 0)
+            return false;
+    }
+    return true;
+}
+
+/* Per-tile reads, visibility rows and region emptiness of the chunked layer against its dense decode */
+static void test_check_chunked_layer(void)
+{
+    uint8_t aIds[2];
+    bool bIds = test_pick_tile_ids(aIds);
+    TEST_CHECK(bIds, "map has fewer than two tile IDs with atlas entries");
+    if (!bIds)
+        return;
+
+    /* SURFACE layers wrap at the world width; JNR layers get a width that pads the last chunk column. Heights pad
+     * the last chunk row in both. */
+    uint16_t uWidth = g_mainTilemap.uWorldWidthTiles;
+    if (s_eTilemapType == TILEMAP_TYPE_JNR)
+        uWidth = (uint16_t)((uWidth & ~TILEMAP_CHUNK_MASK) + 5);
+    uint16_t uHeight = (uint16_t)((g_mainTilemap.uWorldHeightTiles & ~TILEMAP_CHUNK_MASK) + 9);
+
+    test_chunked_fixture_t fixture;
+    bool bPreferred = test_chunked_fixture_build(&fixture, uWidth, uHeight, aIds);
+    TEST_CHECK(bPreferred, "fixture %ux%u with %u mixed chunks would not be stored chunked", (unsigned)uWidth, (unsigned)uHeight, (unsigned)fixture.aKindCount[2]);
+    TEST_CHECK(fixture.aKindCount[0] && fixture.aKindCount[1] && fixture.aKindCount[2], "fixture lacks a chunk kind (%u empty, %u uniform, %u mixed)",
+               (unsigned)fixture.aKindCount[0], (unsigned)fixture.aKindCount[1], (unsigned)fixture.aKindCount[2]);
+    const tilemap_layer_t *pDense = &fixture.dense;
+    const tilemap_layer_t *pChunked = &fixture.chunked;
+
+    /* Per-tile reads */
+    uint32_t uTileMismatches = 0;
+    for (uint16_t uY = 0; uY < uHeight; ++uY)
+    {
+        for (uint16_t uX = 0; uX < uWidth; ++uX)
+        {
+            uint8_t uChunkedTile = tilemap_layer_get_tile(pChunked, uX, uY);
+            if (uChunkedTile != pDense->ppData[uY][uX] && uTileMismatches++ < 3)
+                TEST_CHECK(false, "tile (%u, %u): chunked %u, dense %u", (unsigned)uX, (unsigned)uY, (unsigned)uChunkedTile, (unsigned)pDense->ppData[uY][uX]);
+        }
+    }
+    TEST_CHECK(uTileMismatches == 0, "%lu chunked tiles differ from the dense decode", (unsigned long)uTileMismatches);
+
+    /* Visibility rows: spans inside, across and beyond every edge (wrapped on SURFACE, repeated edges on JNR),
+     * then random spans of up to 160 cells */
+    tile_layer_visibility_t aVis[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        memset(&aVis[i], 0, sizeof(aVis[i]));
+        aVis[i].uMaxBuckets = (uint16_t)TILE_ATLAS_MAX_PAGES;
+        aVis[i].pBuckets = (tile_bucket_t *)calloc(TILE_ATLAS_MAX_PAGES, sizeof(tile_bucket_t));
+    }
+
+    uint32_t uSpans = 0;
+    uint32_t uRowMismatches = 0;
+    uint32_t uDenseTouched = 0;
+    uint32_t uChunkedTouched = 0;
+    uint32_t uSeed = 0x51ED270Bu;
+    const int iSpanStarts[] = {-40, -17, -1, 0, 13, (int)uWidth / 2 - 21, (int)uWidth - 40, (int)uWidth - 3, (int)uWidth + 11};
+    const int iEdgeSpans = (int)(sizeof(iSpanStarts) / sizeof(iSpanStarts[0]));
+    for (int iRow = -2; iRow < (int)uHeight + 2; ++iRow)
+    {
+        for (int iSpan = 0; iSpan < iEdgeSpans + 24; ++iSpan)
+        {
+            int iLeft, iRight;
+            if (iSpan < iEdgeSpans)
+            {
+                iLeft = iSpanStarts[iSpan];
+                iRight = iLeft + 63;
+            }
+            else
+            {
+                uSeed = uSeed * 1664525u + 1013904223u;
+                iLeft = (int)((uSeed >> 8) % (4u * uWidth)) - 2 * (int)uWidth;
+                iRight = iLeft + (int)((uSeed >> 24) % 160u);
+            }
+
+            test_visibility_clear(&aVis[0]);
+            test_visibility_clear(&aVis[1]);
+            uDenseTouched += tilemap_visibility_append_rect(pDense, &aVis[0], (int16_t)iLeft, (int16_t)iRow, (int16_t)iRight, (int16_t)iRow);
+            uChunkedTouched += tilemap_visibility_append_chunked_row(pChunked, &aVis[1], (int16_t)iRow, (int16_t)iLeft, (int16_t)iRight);
+            uSpans++;
+            if (!test_visibility_equal(&aVis[0], &aVis[1]) && uRowMismatches++ < 3)
+                TEST_CHECK(false, "row %d [%d, %d]: chunked visibility (%u tiles) differs from dense (%u tiles)", iRow, iLeft, iRight, (unsigned)aVis[1].uVisibleCount,
+                           (unsigned)aVis[0].uVisibleCount);
+        }
+    }
+    TEST_CHECK(uRowMismatches == 0, "%lu of %lu chunked visibility rows differ from the dense decode", (unsigned long)uRowMismatches, (unsigned long)uSpans);
+    for (int i = 0; i < 2; ++i)
+        free(aVis[i].pBuckets);
+
+    /* Region emptiness answers per chunk: a rect is empty exactly when every chunk it touches is (mixed chunks
+     * always hold a tile), so the reference scans the dense tiles of the rect grown to chunk bounds */
+    uint32_t uRegions = 0;
+    uint32_t uEmptyRegions = 0;
+    uint32_t uRegionMismatches = 0;
+    for (int iRect = 0; iRect < 20000; ++iRect)
+    {
+        uSeed = uSeed * 1664525u + 1013904223u;
+        int iX0 = (int)((uSeed >> 8) % uWidth);
+        int iY0 = (int)((uSeed >> 20) % uHeight);
+        uSeed = uSeed * 1664525u + 1013904223u;
+        int iX1 = iX0 + (int)((uSeed >> 8) % 40u);
+        int iY1 = iY0 + (int)((uSeed >> 20) % 40u);
+        if (iX1 >= (int)uWidth)
+            iX1 = (int)uWidth - 1;
+        if (iY1 >= (int)uHeight)
+            iY1 = (int)uHeight - 1;
+
+        bool bExpected = true;
+        int iScanX1 = (iX1 | TILEMAP_CHUNK_MASK) < (int)uWidth ? (iX1 | TILEMAP_CHUNK_MASK) : (int)uWidth - 1;
+        int iScanY1 = (iY1 | TILEMAP_CHUNK_MASK) < (int)uHeight ? (iY1 | TILEMAP_CHUNK_MASK) : (int)uHeight - 1;
+        for (int iY = iY0 & ~TILEMAP_CHUNK_MASK; iY <= iScanY1 && bExpected; ++iY)
+        {
+            for (int iX = iX0 & ~TILEMAP_CHUNK_MASK; iX <= iScanX1 && bExpected; ++iX)
+                bExpected = pDense->ppData[iY][iX] == TILEMAP_IMPORTER_EMPTY_TILE;
+        }
+
+        bool bEmpty = tilemap_layer_region_is_empty(pChunked, iX0, iY0, iX1, iY1);
+        uRegions++;
+        uEmptyRegions += bEmpty;
+        if (bEmpty != bExpected && uRegionMismatches++ < 3)
+            TEST_CHECK(false, "region (%d, %d)-(%d, %d): chunked says %s", iX0, iY0, iX1, iY1, bEmpty ? "empty" : "not empty");
+    }
+    TEST_CHECK(uRegionMismatches == 0, "%lu of %lu region emptiness answers differ from the dense decode", (unsigned long)uRegionMismatches, (unsigned long)uRegions);
+    TEST_CHECK(uEmptyRegions > 0 && uEmptyRegions < uRegions, "region checks saw %lu empty of %lu", (unsigned long)uEmptyRegions, (unsigned long)uRegions);
+
+    printf("  chunked: %ux%u fixture, %u empty / %u uniform / %u mixed chunks, %lu rows (cells touched: dense %lu, chunked %lu), %lu regions (%lu empty)\n",
+           (unsigned)uWidth,
+           (unsigned)uHeight,
+           (unsigned)fixture.aKindCount[0],
+           (unsigned)fixture.aKindCount[1],
+           (unsigned)fixture.aKindCount[2],
+           (unsigned long)uSpans,
+           (unsigned long)uDenseTouched,
+           (unsigned long)uChunkedTouched,
+           (unsigned long)uRegions,
+           (unsigned long)uEmptyRegions);
+
+    test_chunked_fixture_free(&fixture);
+}
+
+/* ---------- Chunk cache ---------- */
+
+/* Per cell, the tile a chunk-cache chunk draws (slot fill or per-tile fallback) is the one the visibility rebuild
+ * shows, over the map plus two cache chunks beyond every edge */
+static uint32_t test_chunk_cache_edge_mismatches(const tilemap_layer_t *_pLayer, tile_layer_visibility_t *_pVis)
+{
+    const int iMargin = 2 * TILEMAP_CHUNK_CACHE_TILES;
+    const int iLeft = -iMargin;
+    const int iRight = (int)_pLayer->uWidth + iMargin - 1;
+    const size_t uRowCells = (size_t)(iRight - iLeft + 1);
+    uint8_t *pRow = (uint8_t *)malloc(uRowCells);
+    uint32_t uMismatches = 0;
+
+    for (int iRow = -iMargin; iRow < (int)_pLayer->uHeight + iMargin; ++iRow)
+    {
+        memset(pRow, TILEMAP_IMPORTER_EMPTY_TILE, uRowCells);
+        test_visibility_clear(_pVis);
+        tilemap_visibility_append_rect(_pLayer, _pVis, (int16_t)iLeft, (int16_t)iRow, (int16_t)iRight, (int16_t)iRow);
+        for (uint16_t uBucket = 0; uBucket < _pVis->uBucketCount; ++uBucket)
+        {
+            const tile_bucket_t *pBucket = &_pVis->pBuckets[uBucket];
+            for (uint16_t i = 0; i < pBucket->uCount; ++i)
+                pRow[pBucket->aTileX[i] - iLeft] = pBucket->aTileId[i];
+        }
+
+        for (int iX = iLeft; iX <= iRight; ++iX)
+        {
+            uint8_t uCached = tilemap_chunk_cache_sample(_pLayer, iX, iRow);
+            if (uCached != pRow[iX - iLeft] && uMismatches++ < 3)
+                TEST_CHECK(false, "cell (%d, %d) of a %ux%u layer (storage %d): chunk cache draws %u, per-tile path %u", iX, iRow, (unsigned)_pLayer->uWidth,
+                           (unsigned)_pLayer->uHeight, (int)_pLayer->eStorage, (unsigned)uCached, (unsigned)pRow[iX - iLeft]);
+        }
+    }
+    free(pRow);
+    return uMismatches;
+}
+
+/* JNR: the map's cached layers and a dense/chunked pair of the fixture */
+static void test_check_chunk_cache_edges(void)
+{
+    tile_layer_visibility_t vis;
+    memset(&vis, 0, sizeof(vis));
+    vis.uMaxBuckets = (uint16_t)TILE_ATLAS_MAX_PAGES;
+    vis.pBuckets = (tile_bucket_t *)calloc(TILE_ATLAS_MAX_PAGES, sizeof(tile_bucket_t));
+
+    uint32_t uLayers = 0;
+    uint32_t uMismatches = 0;
+    for (uint8_t uLayer = 0; uLayer < g_mainTilemap.importer.uLayerCount; ++uLayer)
+    {
+        const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, uLayer);
+        if (!(TILEMAP_CHUNK_CACHE_LAYER_MASK & (1u << uLayer)) || !tilemap_layer_is_valid(pLayer) || pLayer->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
+            continue;
+        uMismatches += test_chunk_cache_edge_mismatches(pLayer, &vis);
+        uLayers++;
+    }
+
+    uint8_t aIds[2];
+    if (test_pick_tile_ids(aIds))
+    {
+        test_chunked_fixture_t fixture;
+        test_chunked_fixture_build(&fixture, (uint16_t)((g_mainTilemap.uWorldWidthTiles & ~TILEMAP_CHUNK_MASK) + 5), (uint16_t)((g_mainTilemap.uWorldHeightTiles & ~TILEMAP_CHUNK_MASK) + 9), aIds);
+        uMismatches += test_chunk_cache_edge_mismatches(&fixture.dense, &vis);
+        uMismatches += test_chunk_cache_edge_mismatches(&fixture.chunked, &vis);
+        uLayers += 2;
+        test_chunked_fixture_free(&fixture);
+    }
+    free(vis.pBuckets);
+
+    TEST_CHECK(uMismatches == 0, "%lu cells drawn differently by the chunk cache and the per-tile path", (unsigned long)uMismatches);
+    printf("  chunk cache: %lu layers match the per-tile path up to %d tiles beyond the edges\n", (unsigned long)uLayers, 2 * TILEMAP_CHUNK_CACHE_TILES);
+}
+
+/* ---------- Residency ---------- */
+
+static size_t test_resident_bytes(void)
+{
+    size_t uTotal = 0;
+    for (int i = 0; i < TILEMAP_RESIDENCY_SLOTS; ++i)
+        if (s_aResidentMaps[i].bUsed)
+            uTotal += s_aResidentMaps[i].uBytes;
+    return uTotal;
+}
+
+/* Visits the maps in turn like gp_state: resident maps are taken back, the others are staged while the current
+ * map stays loaded. The resident maps plus the current map (parked at the hand-over) stay within the budget,
+ * for the 4 MB and the Expansion Pak budget. */
+static void test_check_residency(const char *const *_apFolders, const tilemap_type_t *_aTypes, int _iCount)
+{
+    printf("residency\n");
+
+    for (int iExpanded = 0; iExpanded < 2; ++iExpanded)
+    {
+        g_bHostMemoryExpanded = iExpanded != 0;
+        size_t uBudget = tilemap_residency_budget();
+        size_t uPeak = 0;
+        int iStaged = 0;
+        int iTaken = 0;
+
+        g_bHostLibdragonQuiet = true;
+        bool bLoaded = tilemap_init(_apFolders[0], _aTypes[0]);
+        for (int iVisit = 1; bLoaded && iVisit <= 3 * _iCount; ++iVisit)
+        {
+            int iMap = iVisit % _iCount;
+            if (tilemap_is_resident(_apFolders[iMap], _aTypes[iMap]))
+            {
+                bLoaded = tilemap_init(_apFolders[iMap], _aTypes[iMap]);
+                iTaken++;
+                continue;
+            }
+
+            bLoaded = tilemap_load_begin(_apFolders[iMap], _aTypes[iMap]);
+            size_t uCurrent = tilemap_importer_resident_bytes(&g_mainTilemap.importer);
+            size_t uHeld = test_resident_bytes() + (uCurrent <= uBudget ? uCurrent : 0);
+            TEST_CHECK(uHeld <= uBudget, "staging %s: %lu bytes resident with the current map, budget %lu", _apFolders[iMap], (unsigned long)uHeld, (unsigned long)uBudget);
+            if (uHeld > uPeak)
+                uPeak = uHeld;
+
+            bLoaded = bLoaded && tilemap_load_finish();
+            TEST_CHECK(test_resident_bytes() <= uBudget, "after %s: %lu bytes resident, budget %lu", _apFolders[iMap], (unsigned long)test_resident_bytes(), (unsigned long)uBudget);
+            iStaged++;
+        }
+        TEST_CHECK(bLoaded, "residency: a map failed to load");
+
+        tilemap_free();
+        tilemap_residency_flush();
+        g_bHostLibdragonQuiet = false;
+        printf("  %4lu KB budget: %d staged loads, %d resident takes, peak %lu KB resident with the current map\n", (unsigned long)(uBudget / 1024), iStaged, iTaken, (unsigned long)(uPeak / 1024));
+    }
+    g_bHostMemoryExpanded = true;
+}
+
+/* ---------- Driver ---------- */
+
+static void test_map(const char *_pFolder, tilemap_type_t _eType)
+{
+    printf("%s (%s)\n", _pFolder, _eType == TILEMAP_TYPE_JNR ? "jnr" : "surface");
+
+    g_bHostLibdragonQuiet = true;
+    bool bLoaded = tilemap_init(_pFolder, _eType);
+    g_bHostLibdragonQuiet = false;
+    if (!bLoaded)
+    {
+        TEST_CHECK(false, "tilemap_init failed for %s", _pFolder);
+        return;
+    }
+
+    test_check_collision_codes();
+    test_check_collision_sweeps();
+    test_check_sweep_traversal();
+    test_check_distorted_projection();
+    test_check_chunked_layer();
+    if (_eType == TILEMAP_TYPE_JNR)
+        test_check_chunk_cache_edges();
+    if (_eType == TILEMAP_TYPE_SURFACE)
+        test_check_flatten();
+
+    g_bHostLibdragonQuiet = true;
+    tilemap_free();
+    tilemap_residency_flush();
+    g_bHostLibdragonQuiet = false;
+}
+
+int main(int _iArgc, char **_ppArgv)
+{
+    if (_iArgc < 2)
+    {
+        printf("usage: %s <folder>:<surface|jnr> ...\n", _ppArgv[0]);
+        return 2;
+    }
+
+    camera_init(&g_mainCamera, SCREEN_W, SCREEN_H);
+    test_check_sphere_factors();
+
+    static char aszFolders[16][64];
+    const char *apFolders[16];
+    tilemap_type_t aTypes[16];
+    int iMapCount = 0;
+
+    for (int i = 1; i < _iArgc; ++i)
+    {
+        char *pFolder = aszFolders[iMapCount < 16 ? iMapCount : 15];
+        const char *pType = strchr(_ppArgv[i], ':');
+        size_t uLength = pType ? (size_t)(pType - _ppArgv[i]) : strlen(_ppArgv[i]);
+        if (uLength >= sizeof(aszFolders[0]))
+            uLength = sizeof(aszFolders[0]) - 1;
+        memcpy(pFolder, _ppArgv[i], uLength);
+        pFolder[uLength] = '\0';
+
+        tilemap_type_t eType = (pType && strcmp(pType + 1, "jnr") == 0) ? TILEMAP_TYPE_JNR : TILEMAP_TYPE_SURFACE;
+        test_map(pFolder, eType);
+        if (iMapCount < 16)
+        {
+            apFolders[iMapCount] = pFolder;
+            aTypes[iMapCount++] = eType;
+        }
+    }
+
+    if (iMapCount > 1)
+        test_check_residency(apFolders, aTypes, iMapCount);
+
+    printf("%s (%d failures)\n", m_iFailures ? "FAILED" : "OK", m_iFailures);
+    return m_iFailures ? 1 : 0;
+}
@@ -1,5 +1,6 @@
 /* tilemap.c */
 #include "tilemap.h"
+#include "csv_helper.h"
 #include "game_objects/gp_state.h"
 #include "libdragon.h"
 #include "math_helper.h"
@@ -46,10 +47,37 @@ typedef enum
    ========================= */
 
 #define TILEMAP_SPHERE_STRENGTH 0.065f /* existing subtle spherical X-shrink */
-#define TILEMAP_SPHERE_CACHE_MAX 32
+#define TILEMAP_SPHERE_LUT_ROWS 512     /* Q16 factor table entries (absolute row distance from center) */
 #define TILEMAP_CULL_MARGIN_X_TILES 1                                           /* render extra columns left+right */
+#define TILEMAP_INCREMENTAL_MAX_SHIFT 4                                         /* larger camera rect moves rebuild visibility from scratch */
 #define TILEMAP_RENDER_ROWS 48 /* render rows count for spherical distortion */ // 48 SMALLEST NUMBER that fits in TMEM. 82% vs 91% with 120.
 
+/* JNR chunk cache: static layers are pre-rendered into offscreen RGBA16 chunks and blitted whole.
+ * Only used at zoom 1.0 with an integer camera offset; other frames take the per-tile path.
+ * Slot memory is sized per map from the RAM budget and the free heap (off on 4 MB systems). */
+#define TILEMAP_CHUNK_CACHE_ENABLED 1
+#define TILEMAP_CHUNK_CACHE_PIXELS 64                                           /* chunk edge in pixels */
+#define TILEMAP_CHUNK_CACHE_TILES (TILEMAP_CHUNK_CACHE_PIXELS / TILE_SIZE)       /* chunk edge in tiles */
+#define TILEMAP_CHUNK_CACHE_BUDGET_BYTES 0                                      /* 4 MB RDRAM: too small, cache stays off */
+#define TILEMAP_CHUNK_CACHE_BUDGET_BYTES_EXPANDED (512 * 1024)                  /* Expansion Pak */
+#define TILEMAP_CHUNK_CACHE_HEAP_SHARE 4                                        /* take at most 1/N of the free heap */
+#define TILEMAP_CHUNK_CACHE_MIN_SLOTS 30                                        /* one screen of chunks (6x5); fewer would thrash */
+#define TILEMAP_CHUNK_CACHE_FILLS_PER_FRAME 8                                   /* new chunks rasterized per frame, the rest draw per tile */
+#define TILEMAP_CHUNK_CACHE_LAYER_MASK 0x0F                                     /* JNR layers 0-3 are static */
+
+/* Residency cache: freed maps stay loaded (LRU) so re-entering a recently visited map skips the load */
+#define TILEMAP_RESIDENCY_SLOTS 6
+#ifndef TILEMAP_RESIDENCY_BUDGET_BYTES
+#define TILEMAP_RESIDENCY_BUDGET_BYTES (192 * 1024)          /* 4 MB RDRAM */
+#endif
+#define TILEMAP_RESIDENCY_BUDGET_BYTES_EXPANDED (768 * 1024) /* Expansion Pak */
+
+/* Layer flattening: SURFACE maps whose logic.csv has "flatten_layers,1" draw background + walkable as one
+ * precomposed layer (one rectangle per cell instead of two passes). Only pays off when the background is tiled:
+ * a single-tile background is one full-surface rectangle already, and flattening refuses it (mine and purpo,
+ * so neither sets the option; tests/tilemap_test.c measures both cases). */
+#define TILEMAP_FLATTEN_OPTION_KEY "flatten_layers"
+
 /* Main tilemap instance - accessible globally */
 tilemap_t g_mainTilemap;
 
@@ -76,20 +104,50 @@ static inline int tilemap_calculate_scaled_tile_size(float _fZoom)
     return iScaledSize;
 }
 
+/* Atlas entry / page of a tile stored in a layer's buckets (the flattened layer has its own atlas) */
+static inline bool tilemap_visibility_atlas_entry(const tile_layer_visibility_t *_pVis, uint8_t _uTileId, tile_atlas_entry_t *_pAtlasEntry)
+{
+    if (_pVis->bFlat)
+        return tilemap_importer_get_flat_atlas_entry(&g_mainTilemap.importer, _uTileId, _pAtlasEntry);
+    return tilemap_importer_get_atlas_entry(&g_mainTilemap.importer, _uTileId, _pAtlasEntry);
+}
+
+static inline const surface_t *tilemap_visibility_atlas_page(const tile_layer_visibility_t *_pVis, uint8_t _uPageId)
+{
+    if (_pVis->bFlat)
+        return tilemap_importer_get_flat_atlas_page(&g_mainTilemap.importer, _uPageId);
+    return tilemap_importer_get_atlas_page(&g_mainTilemap.importer, _uPageId);
+}
+
 /* Get tile data from bucket and atlas entry. Returns false if tile is invalid. */
-static inline bool tilemap_get_tile_data(const tile_bucket_t *_pBucket, uint16_t _uTileIndex, int16_t *_piTileX, int16_t *_piTileY, uint8_t *_puTileId,
-                                         tile_atlas_entry_t *_pAtlasEntry)
+static inline bool tilemap_get_tile_data(const tile_layer_visibility_t *_pVis, const tile_bucket_t *_pBucket, uint16_t _uTileIndex, int16_t *_piTileX, int16_t *_piTileY,
+                                         uint8_t *_puTileId, tile_atlas_entry_t *_pAtlasEntry)
 {
     *_piTileX = _pBucket->aTileX[_uTileIndex];
     *_piTileY = _pBucket->aTileY[_uTileIndex];
     *_puTileId = _pBucket->aTileId[_uTileIndex];
 
-    if (!tilemap_importer_get_atlas_entry(&g_mainTilemap.importer, *_puTileId, _pAtlasEntry))
+    if (!tilemap_visibility_atlas_entry(_pVis, *_puTileId, _pAtlasEntry))
         return false;
 
     return true;
 }
 
+/* Layer drawn in render slot _uLayerIndex: with flattening, the composite takes the lower slot and the upper
+ * slot draws nothing. Collision and walk checks always read the original layers. */
+static inline const tilemap_layer_t *tilemap_get_render_layer(uint8_t _uLayerIndex)
+{
+    const tilemap_flat_layer_t *pFlat = &g_mainTilemap.importer.flat;
+    if (pFlat->bActive)
+    {
+        if (_uLayerIndex == pFlat->uLowerLayer)
+            return &pFlat->layer;
+        if (_uLayerIndex == pFlat->uUpperLayer)
+            return NULL;
+    }
+    return tilemap_importer_get_layer(&g_mainTilemap.importer, _uLayerIndex);
+}
+
 static inline void tilemap_layer_visibility_reset(tile_layer_visibility_t *_pVis)
 {
     for (int i = 0; i < TILE_ATLAS_MAX_PAGES; ++i)
@@ -168,6 +226,8 @@ static inline bool tilemap_layer_is_valid(const tilemap_layer_t *_pLayer)
         return _pLayer->ppData != NULL;
     else if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
         return _pLayer->sparse.pEntries != NULL;
+    else if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+        return _pLayer->pChunks != NULL;
     else /* TILEMAP_LAYER_STORAGE_SINGLE */
         return true;
 }
@@ -232,6 +292,67 @@ static inline void tilemap_resolve_tile_coords(const tilemap_layer_t *_pLayer, i
     }
 }
 
+/* True if every cell of the tile rect samples an empty chunk (whole-rect early out for collision queries).
+ * X spans that wrap around the SURFACE seam are not contiguous in the map and are never reported empty. */
+static inline bool tilemap_tile_rect_is_empty(const tilemap_layer_t *_pLayer, int _iLeft, int _iTop, int _iRight, int _iBottom)
+{
+    int iSampleLeft, iSampleTop, iSampleRight, iSampleBottom;
+    tilemap_resolve_tile_coords(_pLayer, _iLeft, _iTop, &iSampleLeft, &iSampleTop);
+    tilemap_resolve_tile_coords(_pLayer, _iRight, _iBottom, &iSampleRight, &iSampleBottom);
+
+    if (s_eTilemapType != TILEMAP_TYPE_JNR && iSampleRight - iSampleLeft != _iRight - _iLeft)
+        return false;
+
+    return tilemap_layer_region_is_empty(_pLayer, iSampleLeft, iSampleTop, iSampleRight, iSampleBottom);
+}
+
+/* Collision code of a resolved (in-bounds) tile */
+static inline tilemap_collision_code_t tilemap_collision_code_at(int _iSampleX, int _iSampleY)
+{
+    return tilemap_collision_mask_get(&g_mainTilemap.importer.collisionMask, _iSampleX, _iSampleY);
+}
+
+/* True if any tile of visible row _iTileY with X in [_iLeft, _iRight] has a collision code in _uCodeSet.
+ * Resolves coordinates like tilemap_resolve_tile_coords; SURFACE spans across the seam test both pieces. */
+static bool tilemap_collision_row_any(int _iTileY, int _iLeft, int _iRight, uint8_t _uCodeSet)
+{
+    const tilemap_collision_mask_t *pMask = &g_mainTilemap.importer.collisionMask;
+    const int iWidth = (int)pMask->uWidth;
+    const int iSampleY = clampi(_iTileY, 0, (int)pMask->uHeight - 1);
+
+    if (s_eTilemapType == TILEMAP_TYPE_JNR)
+        return tilemap_collision_mask_row_any(pMask, iSampleY, clampi(_iLeft, 0, iWidth - 1), clampi(_iRight, 0, iWidth - 1), _uCodeSet);
+
+    if (_iRight - _iLeft + 1 >= iWidth)
+        return tilemap_collision_mask_row_any(pMask, iSampleY, 0, iWidth - 1, _uCodeSet);
+
+    int iSampleLeft = tilemap_mod_i(_iLeft, iWidth, g_mainTilemap.uWorldWidthMask);
+    int iSampleRight = tilemap_mod_i(_iRight, iWidth, g_mainTilemap.uWorldWidthMask);
+    if (iSampleLeft <= iSampleRight)
+        return tilemap_collision_mask_row_any(pMask, iSampleY, iSampleLeft, iSampleRight, _uCodeSet);
+
+    return tilemap_collision_mask_row_any(pMask, iSampleY, iSampleLeft, iWidth - 1, _uCodeSet) || tilemap_collision_mask_row_any(pMask, iSampleY, 0, iSampleRight, _uCodeSet);
+}
+
+/* Collision codes of the tiles where the given layer can have a tile (0: layer is not part of the mask) */
+static inline uint8_t tilemap_collision_code_set_for_layer(uint8_t _uLayerIndex)
+{
+    if (s_eTilemapType == TILEMAP_TYPE_JNR)
+        return (_uLayerIndex == TILEMAP_LAYER_JNR_COLLISION) ? TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_SOLID) : 0;
+
+    switch (_uLayerIndex)
+    {
+    case TILEMAP_LAYER_SURFACE_COLLISION:
+        /* Hole outranks solid, so holes may hide collision tiles */
+        return TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_SOLID) | TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_HOLE);
+    case TILEMAP_LAYER_SURFACE_DECO_BG:
+    case TILEMAP_LAYER_SURFACE_DECO_FG:
+        return (uint8_t)~TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_FREE);
+    default:
+        return 0;
+    }
+}
+
 /* Get tile ID at world position for a specific layer. Returns TILEMAP_IMPORTER_EMPTY_TILE if layer is invalid or position is out of bounds. */
 static inline uint8_t tilemap_get_tile_id_at_world_pos(struct vec2 _vWorldPos, uint8_t _uLayerIndex)
 {
@@ -306,29 +427,23 @@ static inline void tilemap_compute_camera_tile_rect(int16_t *_pLeft, int16_t *_p
 }
 
 /* =========================
-   Sphere factor cache (quadrant-optimized: cache by absolute Y distance)
-   ========================= */
-
-static inline int32_t tilemap_get_sphere_factor_q16(int16_t _iSampleY, int16_t *_pACacheY, int32_t *_pACacheFq, uint8_t *_pUCacheCount, int16_t _iCenterY)
-{
-    /* Use absolute Y distance from center for quadrant mirroring */
-    int16_t iAbsDeltaY = (int16_t)abs((int)_iSampleY - (int)_iCenterY);
+   Sphere factor table (Q16 factor per absolute row distance from the center row)
+   =========================
+   The factor depends only on the row distance and the center row (not on zoom: the distortion
+   is applied in screen space), so the table is built once and rebuilt if the center row changes. */
 
-    /* Search cache by absolute distance (not signed Y) */
-    for (uint8_t i = 0; i < *_pUCacheCount; ++i)
-    {
-        if (_pACacheY[i] == iAbsDeltaY)
-            return _pACacheFq[i];
-    }
+static int32_t s_aSphereFactorQ16[TILEMAP_SPHERE_LUT_ROWS];
+static int16_t s_iSphereLutCenterY = -1; /* center row the table was built for, -1 if not built */
 
+static int32_t tilemap_sphere_factor_compute_q16(int _iAbsDeltaY, int16_t _iCenterY)
+{
     float fFactor = 1.0f;
 
     if (_iCenterY > 0)
     {
         /* Use absolute deltaY since cos is even: cos(-x) = cos(x) */
-        float fDeltaY = (float)iAbsDeltaY;
         float fLatScale = (FM_PI * 0.5f) / (float)_iCenterY;
-        float fLatitude = fDeltaY * fLatScale;
+        float fLatitude = (float)_iAbsDeltaY * fLatScale;
 
         float fCosLat = fm_cosf(fLatitude);
         float fStrength = TILEMAP_SPHERE_STRENGTH;
@@ -341,17 +456,28 @@ static inline int32_t tilemap_get_sphere_factor_q16(int16_t _iSampleY, int16_t *
             fFactor = 1.0f;
     }
 
-    int32_t iFactorQ = (int32_t)(fFactor * 65536.0f + 0.5f);
+    return (int32_t)(fFactor * 65536.0f + 0.5f);
+}
 
-    if (*_pUCacheCount < TILEMAP_SPHERE_CACHE_MAX)
-    {
-        /* Cache by absolute distance, not signed Y */
-        _pACacheY[*_pUCacheCount] = iAbsDeltaY;
-        _pACacheFq[*_pUCacheCount] = iFactorQ;
-        (*_pUCacheCount)++;
-    }
+static void tilemap_sphere_lut_build(int16_t _iCenterY)
+{
+    for (int i = 0; i < TILEMAP_SPHERE_LUT_ROWS; ++i)
+        s_aSphereFactorQ16[i] = tilemap_sphere_factor_compute_q16(i, _iCenterY);
+
+    s_iSphereLutCenterY = _iCenterY;
+}
+
+/* Q16 factor for screen row _iSampleY (rows beyond the table are computed directly) */
+static inline int32_t tilemap_get_sphere_factor_q16(int _iSampleY, int16_t _iCenterY)
+{
+    if (_iCenterY != s_iSphereLutCenterY)
+        tilemap_sphere_lut_build(_iCenterY);
+
+    int iAbsDeltaY = abs(_iSampleY - (int)_iCenterY);
+    if (iAbsDeltaY < TILEMAP_SPHERE_LUT_ROWS)
+        return s_aSphereFactorQ16[iAbsDeltaY];
 
-    return iFactorQ;
+    return tilemap_sphere_factor_compute_q16(iAbsDeltaY, _iCenterY);
 }
 
 /* Apply spherical distortion to an X coordinate offset.
@@ -362,6 +488,150 @@ static inline int tilemap_apply_sphere_distortion_x(int _iCenterX, int _iOffsetX
     return (int)_iCenterX + (int)(((int64_t)_iOffsetX * (int64_t)_iFactorQ + 0x8000) >> 16);
 }
 
+/* =========================
+   Residency cache
+   ========================= */
+
+typedef struct
+{
+    tilemap_importer_t importer;
+    tilemap_type_t eType;
+    char szMapFolder[64];
+    size_t uBytes;     /* tilemap_importer_resident_bytes at park time */
+    uint32_t uLastUse; /* LRU stamp */
+    bool bUsed;
+} tilemap_resident_map_t;
+
+static tilemap_resident_map_t s_aResidentMaps[TILEMAP_RESIDENCY_SLOTS];
+static uint32_t s_uResidencyClock = 0;
+
+static size_t tilemap_residency_budget(void)
+{
+    return is_memory_expanded() ? TILEMAP_RESIDENCY_BUDGET_BYTES_EXPANDED : TILEMAP_RESIDENCY_BUDGET_BYTES;
+}
+
+static void tilemap_residency_evict(tilemap_resident_map_t *_pEntry)
+{
+    debugf("Tilemap residency: evict %s (%lu bytes)\n", _pEntry->szMapFolder, (unsigned long)_pEntry->uBytes);
+    tilemap_importer_free(&_pEntry->importer);
+    memset(_pEntry, 0, sizeof(*_pEntry));
+    PROF_COUNTER_ADD(PROF_COUNTER_MAP_EVICTS, 1);
+}
+
+/* Evict least recently used maps until _uBytes more fit the budget. Returns the slot to put them in, or NULL
+ * (nothing evicted) if _uBytes alone is over budget. */
+static tilemap_resident_map_t *tilemap_residency_reserve(size_t _uBytes)
+{
+    if (_uBytes > tilemap_residency_budget())
+        return NULL;
+
+    for (;;)
+    {
+        size_t uTotal = 0;
+        tilemap_resident_map_t *pFree = NULL;
+        tilemap_resident_map_t *pOldest = NULL;
+
+        for (int i = 0; i < TILEMAP_RESIDENCY_SLOTS; ++i)
+        {
+            tilemap_resident_map_t *pEntry = &s_aResidentMaps[i];
+            if (!pEntry->bUsed)
+            {
+                if (!pFree)
+                    pFree = pEntry;
+                continue;
+            }
+            uTotal += pEntry->uBytes;
+            if (!pOldest || pEntry->uLastUse < pOldest->uLastUse)
+                pOldest = pEntry;
+        }
+
+        if (pFree && uTotal + _uBytes <= tilemap_residency_budget())
+            return pFree;
+
+        /* _uBytes fits the budget on its own, so evicting eventually makes room */
+        tilemap_residency_evict(pOldest);
+    }
+}
+
+/* Move a loaded importer into the cache (evicting least recently used maps to stay within budget).
+ * The source importer is left empty either way; a map that cannot be kept is freed. */
+static void tilemap_residency_park(tilemap_importer_t *_pImporter, const char *_pMapFolder, tilemap_type_t _eType)
+{
+    size_t uBytes = tilemap_importer_resident_bytes(_pImporter);
+    tilemap_resident_map_t *pFree = NULL;
+    if (_pImporter->bInitialized && strlen(_pMapFolder) < sizeof(s_aResidentMaps[0].szMapFolder))
+        pFree = tilemap_residency_reserve(uBytes);
+
+    /* Not a resident map, so not an eviction either */
+    if (!pFree)
+    {
+        debugf("Tilemap residency: %s not kept (%lu bytes)\n", _pMapFolder, (unsigned long)uBytes);
+        tilemap_importer_free(_pImporter);
+        return;
+    }
+
+    pFree->importer = *_pImporter;
+    pFree->eType = _eType;
+    strcpy(pFree->szMapFolder, _pMapFolder);
+    pFree->uBytes = uBytes;
+    pFree->uLastUse = ++s_uResidencyClock;
+    pFree->bUsed = true;
+    memset(_pImporter, 0, sizeof(*_pImporter));
+}
+
+/* Move a cached map into _pOutImporter. Returns false on a miss. */
+static bool tilemap_residency_take(const char *_pMapFolder, tilemap_type_t _eType, tilemap_importer_t *_pOutImporter)
+{
+    for (int i = 0; i < TILEMAP_RESIDENCY_SLOTS; ++i)
+    {
+        tilemap_resident_map_t *pEntry = &s_aResidentMaps[i];
+        if (pEntry->bUsed && pEntry->eType == _eType && strcmp(pEntry->szMapFolder, _pMapFolder) == 0)
+        {
+            *_pOutImporter = pEntry->importer;
+            memset(pEntry, 0, sizeof(*pEntry));
+            PROF_COUNTER_ADD(PROF_COUNTER_MAP_HITS, 1);
+            return true;
+        }
+    }
+
+    PROF_COUNTER_ADD(PROF_COUNTER_MAP_MISSES, 1);
+    return false;
+}
+
+bool tilemap_is_resident(const char *_pMapFolder, tilemap_type_t _eType)
+{
+    if (!_pMapFolder)
+        return false;
+
+    for (int i = 0; i < TILEMAP_RESIDENCY_SLOTS; ++i)
+    {
+        const tilemap_resident_map_t *pEntry = &s_aResidentMaps[i];
+        if (pEntry->bUsed && pEntry->eType == _eType && strcmp(pEntry->szMapFolder, _pMapFolder) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool tilemap_residency_flush(void)
+{
+    bool bReleased = false;
+    for (int i = 0; i < TILEMAP_RESIDENCY_SLOTS; ++i)
+    {
+        if (s_aResidentMaps[i].bUsed)
+        {
+            tilemap_residency_evict(&s_aResidentMaps[i]);
+            bReleased = true;
+        }
+    }
+    return bReleased;
+}
+
+static bool tilemap_init_from_importer(void);
+
+/* JNR chunk cache (defined next to the renderer) */
+static void tilemap_chunk_cache_init(void);
+static void tilemap_chunk_cache_free(void);
+
 /* =========================
    Init / Free
    ========================= */
@@ -384,38 +654,32 @@ bool tilemap_init(const char *_pMapFolder, tilemap_type_t _eType)
     strncpy(s_szCurrentMapFolder, _pMapFolder, sizeof(s_szCurrentMapFolder) - 1);
     s_szCurrentMapFolder[sizeof(s_szCurrentMapFolder) - 1] = '\0';
 
-    if (!tilemap_importer_init(&g_mainTilemap.importer, _pMapFolder, _eType))
+    /* Recently visited maps are still resident: skip the load entirely */
+    if (!tilemap_residency_take(_pMapFolder, _eType, &g_mainTilemap.importer))
     {
-        debugf("Failed to initialize tilemap importer\n");
-        return false;
-    }
-
-    /* cache world width (1 revolution) from layer 0 */
-    const tilemap_layer_t *pL0 = tilemap_importer_get_layer(&g_mainTilemap.importer, 0);
-    g_mainTilemap.uWorldWidthTiles = pL0 ? pL0->uWidth : 0;
-    g_mainTilemap.uWorldHeightTiles = pL0 ? pL0->uHeight : 0;
+        bool bLoaded = tilemap_importer_init(&g_mainTilemap.importer, _pMapFolder, _eType);
 
-    /* Check if width is power-of-2 and compute mask for fast modulo */
-    if (g_mainTilemap.uWorldWidthTiles > 0)
-    {
-        uint16_t uWidth = g_mainTilemap.uWorldWidthTiles;
-        /* Check if width is power-of-2: (width & (width - 1)) == 0 */
-        if ((uWidth & (uWidth - 1)) == 0)
+        /* A failed load is usually out of memory: release the resident maps and try once more */
+        if (!bLoaded && tilemap_residency_flush())
         {
-            /* Power-of-2: mask is width - 1 */
-            g_mainTilemap.uWorldWidthMask = uWidth - 1;
+            debugf("Tilemap load failed with maps resident, retrying after flush\n");
+            bLoaded = tilemap_importer_init(&g_mainTilemap.importer, _pMapFolder, _eType);
         }
-        else
+
+        if (!bLoaded)
         {
-            /* Not power-of-2: mask is 0 (use standard modulo) */
-            g_mainTilemap.uWorldWidthMask = 0;
+            debugf("Failed to initialize tilemap importer\n");
+            return false;
         }
     }
-    else
-    {
-        g_mainTilemap.uWorldWidthMask = 0;
-    }
 
+    return tilemap_init_from_importer();
+}
+
+/* Allocate the per-layer visibility buckets (all or nothing) */
+static bool tilemap_visibility_alloc(void)
+{
+    const tilemap_flat_layer_t *pFlat = &g_mainTilemap.importer.flat;
     bool bAllocationSuccess = true;
 
     for (uint8_t i = 0; i < TILEMAP_IMPORTER_MAX_LAYERS; ++i)
@@ -424,6 +688,7 @@ bool tilemap_init(const char *_pMapFolder, tilemap_type_t _eType)
 
         pVis->uMaxBuckets = (uint16_t)TILE_ATLAS_MAX_PAGES;
         pVis->uBucketCount = 0;
+        pVis->bFlat = pFlat->bActive && i == pFlat->uLowerLayer;
 
         pVis->pBuckets = (tile_bucket_t *)malloc(sizeof(tile_bucket_t) * (size_t)pVis->uMaxBuckets);
         if (!pVis->pBuckets)
@@ -461,6 +726,54 @@ bool tilemap_init(const char *_pMapFolder, tilemap_type_t _eType)
             g_mainTilemap.aLayerVisibility[i].bLastRectValid = false;
         }
 
+        return false;
+    }
+
+    return true;
+}
+
+/* Finish setup once g_mainTilemap.importer is loaded: world size, visibility buckets and render targets */
+static bool tilemap_init_from_importer(void)
+{
+    /* cache world width (1 revolution) from layer 0 */
+    const tilemap_layer_t *pL0 = tilemap_importer_get_layer(&g_mainTilemap.importer, 0);
+    g_mainTilemap.uWorldWidthTiles = pL0 ? pL0->uWidth : 0;
+    g_mainTilemap.uWorldHeightTiles = pL0 ? pL0->uHeight : 0;
+
+    /* Check if width is power-of-2 and compute mask for fast modulo */
+    if (g_mainTilemap.uWorldWidthTiles > 0)
+    {
+        uint16_t uWidth = g_mainTilemap.uWorldWidthTiles;
+        /* Check if width is power-of-2: (width & (width - 1)) == 0 */
+        if ((uWidth & (uWidth - 1)) == 0)
+        {
+            /* Power-of-2: mask is width - 1 */
+            g_mainTilemap.uWorldWidthMask = uWidth - 1;
+        }
+        else
+        {
+            /* Not power-of-2: mask is 0 (use standard modulo) */
+            g_mainTilemap.uWorldWidthMask = 0;
+        }
+    }
+    else
+    {
+        g_mainTilemap.uWorldWidthMask = 0;
+    }
+
+    /* Per-map option: precompose background + walkable into one render layer (a resident map may already have it) */
+    if (s_eTilemapType == TILEMAP_TYPE_SURFACE && csv_helper_load_logic_flag(s_szCurrentMapFolder, TILEMAP_FLATTEN_OPTION_KEY))
+        tilemap_importer_flatten_layers(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_BACKGROUND, TILEMAP_LAYER_SURFACE_WALKABLE);
+
+    bool bAllocationSuccess = tilemap_visibility_alloc();
+    if (!bAllocationSuccess && tilemap_residency_flush())
+    {
+        debugf("Tilemap visibility allocation failed with maps resident, retrying after flush\n");
+        bAllocationSuccess = tilemap_visibility_alloc();
+    }
+
+    if (!bAllocationSuccess)
+    {
         tilemap_importer_free(&g_mainTilemap.importer);
         return false;
     }
@@ -474,13 +787,23 @@ bool tilemap_init(const char *_pMapFolder, tilemap_type_t _eType)
         /* Height: Screen (240) */
         int iSurfWidth = 320 + (TILEMAP_CULL_MARGIN_X_TILES * TILE_SIZE * 2);
         g_surfTemp = surface_alloc(FMT_RGBA16, iSurfWidth, 240);
+        if (!g_surfTemp.buffer && tilemap_residency_flush())
+            g_surfTemp = surface_alloc(FMT_RGBA16, iSurfWidth, 240);
     }
+#if TILEMAP_CHUNK_CACHE_ENABLED
+    else
+    {
+        tilemap_chunk_cache_init();
+    }
+#endif
 
     return true;
 }
 
 void tilemap_free(void)
 {
+    tilemap_chunk_cache_free();
+
     if (g_surfTemp.buffer)
     {
         surface_free(&g_surfTemp);
@@ -506,6 +829,10 @@ void tilemap_free(void)
         pVis->bLastRectValid = false;
     }
 
+    /* Keep the map resident for quick re-entry (tilemap_residency_flush releases it) */
+    if (g_mainTilemap.importer.bInitialized)
+        tilemap_residency_park(&g_mainTilemap.importer, s_szCurrentMapFolder, s_eTilemapType);
+
     tilemap_importer_free(&g_mainTilemap.importer);
     g_mainTilemap.bInitialized = false;
     s_szCurrentMapFolder[0] = '\0';
@@ -519,293 +846,977 @@ const char *tilemap_get_loaded_folder(void)
 }
 
 /* =========================
-   Update (now with X wrap sampling)
+   Staged load (build the next map over several frames, then hand it over)
    ========================= */
 
-void tilemap_update(void)
+typedef struct
 {
-    if (!g_mainTilemap.bInitialized)
-        return;
-
-    int16_t iCamLeft = 0, iCamTop = 0, iCamRight = -1, iCamBottom = -1;
-    tilemap_compute_camera_tile_rect(&iCamLeft, &iCamTop, &iCamRight, &iCamBottom);
-
-    for (uint8_t uLayerIndex = 0; uLayerIndex < TILEMAP_IMPORTER_MAX_LAYERS; ++uLayerIndex)
-    {
-        const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, uLayerIndex);
-        if (!tilemap_layer_is_valid(pLayer))
-            continue;
+    tilemap_importer_loader_t loader;
+    tilemap_importer_t importer; /* Filled off to the side while the current map keeps rendering */
+    tilemap_type_t eType;
+    tilemap_load_status_t eStatus;
+    bool bActive;
+#ifdef DEV_BUILD
+    uint32_t uSteps;
+    uint32_t uUpdates;
+    uint32_t uBudgetUs;
+    uint32_t uMaxStepUs;
+    uint32_t uOverBudgetSteps; /* Steps that alone took longer than the frame budget */
+#endif
+} tilemap_staged_load_t;
 
-        if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
-            continue;
+static tilemap_staged_load_t s_stagedLoad;
 
-        tile_layer_visibility_t *pVis = &g_mainTilemap.aLayerVisibility[uLayerIndex];
-        if (!pVis->pBuckets || pVis->uMaxBuckets == 0)
-            continue;
+bool tilemap_load_begin(const char *_pMapFolder, tilemap_type_t _eType)
+{
+    tilemap_load_cancel();
 
-        int16_t iLeft = iCamLeft;
-        int16_t iTop = iCamTop;
-        int16_t iRight = iCamRight;
-        int16_t iBottom = iCamBottom;
+    /* The current map is parked when the staged one takes over: make room for it before the new map is loaded
+     * next to it, so the resident maps and the current one never exceed the budget together */
+    if (g_mainTilemap.importer.bInitialized)
+        tilemap_residency_reserve(tilemap_importer_resident_bytes(&g_mainTilemap.importer));
 
-        if (iBottom < iTop)
-        {
-            pVis->bLastRectValid = true;
-            pVis->iLastLeft = iLeft;
-            pVis->iLastTop = iTop;
-            pVis->iLastRight = iRight;
-            pVis->iLastBottom = iBottom;
-            pVis->uBucketCount = 0;
-            continue;
-        }
+    if (!tilemap_importer_load_begin(&s_stagedLoad.loader, &s_stagedLoad.importer, _pMapFolder, _eType))
+        return false;
+    PROF_COUNTER_ADD(PROF_COUNTER_MAP_MISSES, 1);
+
+    s_stagedLoad.eType = _eType;
+    s_stagedLoad.eStatus = TILEMAP_LOAD_PENDING;
+    s_stagedLoad.bActive = true;
+#ifdef DEV_BUILD
+    s_stagedLoad.uSteps = 0;
+    s_stagedLoad.uUpdates = 0;
+    s_stagedLoad.uBudgetUs = 0;
+    s_stagedLoad.uMaxStepUs = 0;
+    s_stagedLoad.uOverBudgetSteps = 0;
+#endif
+    return true;
+}
 
-        if (pVis->bLastRectValid && pVis->iLastLeft == iLeft && pVis->iLastTop == iTop && pVis->iLastRight == iRight && pVis->iLastBottom == iBottom)
-        {
-            continue;
-        }
+bool tilemap_load_update(uint32_t _uBudgetUs)
+{
+    if (!s_stagedLoad.bActive)
+        return false;
 
-        pVis->bLastRectValid = true;
-        pVis->iLastLeft = iLeft;
-        pVis->iLastTop = iTop;
-        pVis->iLastRight = iRight;
-        pVis->iLastBottom = iBottom;
+    uint64_t uStartUs = get_ticks_us();
+#ifdef DEV_BUILD
+    s_stagedLoad.uUpdates++;
+    s_stagedLoad.uBudgetUs = _uBudgetUs;
+#endif
 
-        tilemap_layer_visibility_reset(pVis);
+    /* Steps are not preempted: a step starts only while budget is left */
+    while (s_stagedLoad.eStatus == TILEMAP_LOAD_PENDING && get_ticks_us() - uStartUs < _uBudgetUs)
+    {
+#ifdef DEV_BUILD
+        uint64_t uStepStartUs = get_ticks_us();
+#endif
+        s_stagedLoad.eStatus = tilemap_importer_load_step(&s_stagedLoad.loader);
+#ifdef DEV_BUILD
+        uint32_t uStepUs = (uint32_t)(get_ticks_us() - uStepStartUs);
+        s_stagedLoad.uSteps++;
+        if (uStepUs > s_stagedLoad.uMaxStepUs)
+            s_stagedLoad.uMaxStepUs = uStepUs;
+        if (uStepUs > _uBudgetUs)
+            s_stagedLoad.uOverBudgetSteps++;
+#endif
+    }
 
-        uint16_t uVisibleCount = 0;
+    return s_stagedLoad.eStatus != TILEMAP_LOAD_PENDING;
+}
 
-        /* Sparse layer optimization: iterate stored tiles instead of visible area */
-        if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
-        {
-            /* Iterate through all tiles in sparse hash table */
-            const sparse_layer_data_t *pSparse = &pLayer->sparse;
+float tilemap_load_progress(void)
+{
+    if (!s_stagedLoad.bActive)
+        return 0.0f;
+    return tilemap_importer_load_progress(&s_stagedLoad.loader);
+}
 
-            /* Empty layer fast path (0 tiles) */
-            if (pSparse->uCapacity == 0 || !pSparse->pEntries)
-                continue;
+bool tilemap_load_is_pending(const char *_pMapFolder, tilemap_type_t _eType)
+{
+    return s_stagedLoad.bActive && _pMapFolder && s_stagedLoad.eType == _eType && strcmp(s_stagedLoad.loader.szMapFolder, _pMapFolder) == 0;
+}
 
-            /* Precompute wrapping logic once per layer (SURFACE mode only) */
-            bool bNeedWrapCheck = false;
-            int16_t iLayerWidth = (int16_t)pLayer->uWidth;
+bool tilemap_load_finish(void)
+{
+    if (!s_stagedLoad.bActive)
+        return false;
 
-            if (s_eTilemapType != TILEMAP_TYPE_JNR && iLayerWidth > 0)
-            {
-                /* SURFACE mode: rect can have negative/wrapped coordinates */
-                bNeedWrapCheck = (iLeft < 0 || iRight >= iLayerWidth);
-            }
+    /* Blocking fallback: run whatever the frame budgets did not get to */
+    uint32_t uBlockingSteps = 0;
+    while (s_stagedLoad.eStatus == TILEMAP_LOAD_PENDING)
+    {
+        s_stagedLoad.eStatus = tilemap_importer_load_step(&s_stagedLoad.loader);
+        uBlockingSteps++;
+    }
 
-            for (uint16_t i = 0; i < pSparse->uCapacity; ++i)
-            {
-                const sparse_tile_entry_t *pEntry = &pSparse->pEntries[i];
+#ifdef DEV_BUILD
+    debugf("Tilemap staged load %s: %lu steps over %lu updates, max step %lu us (budget %lu us, %lu over), %lu blocking steps\n",
+           s_stagedLoad.loader.szMapFolder,
+           (unsigned long)s_stagedLoad.uSteps,
+           (unsigned long)s_stagedLoad.uUpdates,
+           (unsigned long)s_stagedLoad.uMaxStepUs,
+           (unsigned long)s_stagedLoad.uBudgetUs,
+           (unsigned long)s_stagedLoad.uOverBudgetSteps,
+           (unsigned long)uBlockingSteps);
+#else
+    (void)uBlockingSteps;
+#endif
 
-                /* Skip empty slots */
-                if (pEntry->uX == SPARSE_ENTRY_EMPTY)
+    s_stagedLoad.bActive = false;
+    if (s_stagedLoad.eStatus != TILEMAP_LOAD_DONE)
+    {
+        debugf("Failed to initialize tilemap importer\n");
+        return false;
+    }
+
+    /* Hand over: replace the current map with the staged one */
+    tilemap_free();
+
+    s_eTilemapType = s_stagedLoad.eType;
+    memset(&g_mainTilemap, 0, sizeof(tilemap_t));
+    strncpy(s_szCurrentMapFolder, s_stagedLoad.loader.szMapFolder, sizeof(s_szCurrentMapFolder) - 1);
+    s_szCurrentMapFolder[sizeof(s_szCurrentMapFolder) - 1] = '\0';
+
+    g_mainTilemap.importer = s_stagedLoad.importer;
+    memset(&s_stagedLoad.importer, 0, sizeof(s_stagedLoad.importer));
+
+    return tilemap_init_from_importer();
+}
+
+void tilemap_load_cancel(void)
+{
+    if (!s_stagedLoad.bActive)
+        return;
+
+    if (s_stagedLoad.eStatus == TILEMAP_LOAD_PENDING)
+        tilemap_importer_load_abort(&s_stagedLoad.loader);
+    else if (s_stagedLoad.eStatus == TILEMAP_LOAD_DONE)
+        tilemap_importer_free(&s_stagedLoad.importer);
+
+    s_stagedLoad.bActive = false;
+}
+
+/* =========================
+   Update (now with X wrap sampling)
+   ========================= */
+
+/* Append a visible tile to the bucket of its atlas page.
+ * Returns false if a capacity limit was hit (tile dropped, caller forces a full rebuild next time). */
+static inline bool tilemap_visibility_push(tile_layer_visibility_t *_pVis, int16_t _iTileX, int16_t _iTileY, uint8_t _uTileId)
+{
+    if (_pVis->uVisibleCount >= (uint16_t)TILEMAP_MAX_VISIBLE_TILES)
+        return false;
+
+    /* Look up atlas entry to get pageId */
+    tile_atlas_entry_t tAtlasEntry;
+    if (!tilemap_visibility_atlas_entry(_pVis, _uTileId, &tAtlasEntry))
+        return true; /* Invalid tile or no atlas entry */
+
+    uint8_t uPageId = tAtlasEntry.uPageIndex;
+    int16_t iBucketIndex = _pVis->aBucketIndexByPageId[uPageId];
+    tile_bucket_t *pBucket = NULL;
+
+    if (iBucketIndex < 0)
+    {
+        if (_pVis->uBucketCount >= _pVis->uMaxBuckets)
+            return false;
+
+        uint16_t uNewIndex = _pVis->uBucketCount++;
+        pBucket = &_pVis->pBuckets[uNewIndex];
+        pBucket->uPageId = (uint16_t)uPageId;
+        pBucket->uCount = 0;
+
+        _pVis->aBucketIndexByPageId[uPageId] = (int16_t)uNewIndex;
+    }
+    else
+    {
+        pBucket = &_pVis->pBuckets[(uint16_t)iBucketIndex];
+    }
+
+    if (pBucket->uCount >= TILEMAP_BUCKET_SIZE)
+        return false;
+
+    pBucket->aTileX[pBucket->uCount] = _iTileX;
+    pBucket->aTileY[pBucket->uCount] = _iTileY;
+    pBucket->aTileId[pBucket->uCount] = _uTileId; /* Store tileId for u/v lookup */
+    pBucket->uCount++;
+    _pVis->uVisibleCount++;
+    return true;
+}
+
+/* Dense tile shown at visible cell (x, y), using the same rules as the full rebuild:
+ * edge rows repeat (and edge columns in JNR), SURFACE maps wrap X. */
+static inline uint8_t tilemap_sample_visible_dense_tile(const tilemap_layer_t *_pLayer, int _iTileX, int _iTileY)
+{
+    const int iWidth = (int)_pLayer->uWidth;
+    const int iHeight = (int)_pLayer->uHeight;
+
+    int iSampleY = (_iTileY < 0) ? 0 : ((_iTileY >= iHeight) ? iHeight - 1 : _iTileY);
+    int iSampleX;
+    if (s_eTilemapType == TILEMAP_TYPE_JNR)
+        iSampleX = (_iTileX < 0) ? 0 : ((_iTileX >= iWidth) ? iWidth - 1 : _iTileX);
+    else
+        iSampleX = tilemap_mod_i(_iTileX, iWidth, g_mainTilemap.uWorldWidthMask);
+
+    return _pLayer->ppData[iSampleY][iSampleX];
+}
+
+/* Append the sparse tiles of one row whose visible X lies in [_iLeft, _iRight], via the layer's row index.
+ * Sparse layers show nothing outside the map; on SURFACE maps the span may wrap around either edge
+ * (stored X is the visible, unwrapped coordinate). Returns the number of entries touched. */
+static uint32_t tilemap_visibility_append_sparse_row(const tilemap_layer_t *_pLayer, tile_layer_visibility_t *_pVis, int16_t _iTileY, int16_t _iLeft, int16_t _iRight)
+{
+    if (_iTileY < 0 || _iTileY >= (int)_pLayer->uHeight)
+        return 0;
+
+    const sparse_layer_data_t *pSparse = &_pLayer->sparse;
+    const int iWidth = (int)_pLayer->uWidth;
+    const int iWrapCount = (s_eTilemapType == TILEMAP_TYPE_JNR) ? 1 : 3;
+    static const int s_aWrapOffsets[3] = {0, -1, 1}; /* visible X = map X + offset * width */
+
+    uint32_t uTouched = 0;
+
+    for (int iWrap = 0; iWrap < iWrapCount; ++iWrap)
+    {
+        int iOffsetX = s_aWrapOffsets[iWrap] * iWidth;
+        int iMapX0 = (int)_iLeft - iOffsetX;
+        int iMapX1 = (int)_iRight - iOffsetX;
+        if (iMapX0 < 0)
+            iMapX0 = 0;
+        if (iMapX1 > iWidth - 1)
+            iMapX1 = iWidth - 1;
+        if (iMapX0 > iMapX1)
+            continue;
+
+        uint16_t uBegin, uEnd;
+        tilemap_layer_sparse_row_span(pSparse, (uint16_t)_iTileY, (uint16_t)iMapX0, (uint16_t)iMapX1, &uBegin, &uEnd);
+
+        for (uint16_t i = uBegin; i < uEnd; ++i)
+        {
+            uTouched++;
+            if (!tilemap_visibility_push(_pVis, (int16_t)(pSparse->pRowColumns[i] + iOffsetX), _iTileY, pSparse->pRowTileIds[i]))
+                _pVis->bTruncated = true;
+        }
+    }
+
+    return uTouched;
+}
+
+/* Append the tiles of one chunked-layer row whose visible X lies in [_iLeft, _iRight], with the same
+ * sampling rules as dense layers. The row is walked in runs that stay inside one chunk: empty chunks are
+ * skipped and uniform chunks pushed from their chunk record without reading tiles. Returns the cells touched. */
+static uint32_t tilemap_visibility_append_chunked_row(const tilemap_layer_t *_pLayer, tile_layer_visibility_t *_pVis, int16_t _iTileY, int16_t _iLeft, int16_t _iRight)
+{
+    const int iWidth = (int)_pLayer->uWidth;
+    const int iHeight = (int)_pLayer->uHeight;
+    const int iSampleY = (_iTileY < 0) ? 0 : ((_iTileY >= iHeight) ? iHeight - 1 : _iTileY);
+    const tilemap_chunk_t *pChunkRow = &_pLayer->pChunks[(iSampleY >> TILEMAP_CHUNK_SHIFT) * _pLayer->uChunksX];
+    const uint32_t uRowInChunk = (uint32_t)(iSampleY & TILEMAP_CHUNK_MASK) << TILEMAP_CHUNK_SHIFT;
+
+    uint32_t uTouched = 0;
+    int iTileX = _iLeft;
+
+    while (iTileX <= _iRight)
+    {
+        /* Visible cells [iTileX, iTileX + iRun) map to consecutive sample columns of one chunk */
+        int iSampleX;
+        int iRun;
+        if (s_eTilemapType == TILEMAP_TYPE_JNR && (iTileX < 0 || iTileX >= iWidth))
+        {
+            iSampleX = (iTileX < 0) ? 0 : iWidth - 1; /* Repeated edge column */
+            iRun = 1;
+        }
+        else
+        {
+            iSampleX = (s_eTilemapType == TILEMAP_TYPE_JNR) ? iTileX : tilemap_mod_i(iTileX, iWidth, g_mainTilemap.uWorldWidthMask);
+            iRun = iWidth - iSampleX;
+        }
+
+        int iChunkRun = TILEMAP_CHUNK_SIZE - (iSampleX & TILEMAP_CHUNK_MASK);
+        if (iRun > iChunkRun)
+            iRun = iChunkRun;
+        if (iRun > _iRight - iTileX + 1)
+            iRun = _iRight - iTileX + 1;
+
+        const tilemap_chunk_t *pChunk = &pChunkRow[iSampleX >> TILEMAP_CHUNK_SHIFT];
+        if (pChunk->uDataIndex == TILEMAP_CHUNK_UNIFORM)
+        {
+            uTouched++;
+            if (pChunk->uTileId != TILEMAP_IMPORTER_EMPTY_TILE)
+            {
+                for (int i = 0; i < iRun; ++i)
+                {
+                    if (!tilemap_visibility_push(_pVis, (int16_t)(iTileX + i), _iTileY, pChunk->uTileId))
+                        _pVis->bTruncated = true;
+                }
+            }
+        }
+        else
+        {
+            const uint8_t *pSrc = &_pLayer->pChunkData[((uint32_t)pChunk->uDataIndex << (2 * TILEMAP_CHUNK_SHIFT)) + uRowInChunk + (uint32_t)(iSampleX & TILEMAP_CHUNK_MASK)];
+            uTouched += (uint32_t)iRun;
+            for (int i = 0; i < iRun; ++i)
+            {
+                if (pSrc[i] == TILEMAP_IMPORTER_EMPTY_TILE)
                     continue;
+                if (!tilemap_visibility_push(_pVis, (int16_t)(iTileX + i), _iTileY, pSrc[i]))
+                    _pVis->bTruncated = true;
+            }
+        }
 
-                int16_t iTileX = (int16_t)pEntry->uX;
-                int16_t iTileY = (int16_t)pEntry->uY;
-                uint8_t uTileId = pEntry->uTileId;
+        iTileX += iRun;
+    }
 
-                /* Y bounds check */
-                if (iTileY < iTop || iTileY > iBottom)
+    return uTouched;
+}
+
+/* Sample every cell of a tile rect into the buckets. Returns the number of cells touched. */
+static uint32_t tilemap_visibility_append_rect(const tilemap_layer_t *_pLayer, tile_layer_visibility_t *_pVis, int16_t _iLeft, int16_t _iTop, int16_t _iRight, int16_t _iBottom)
+{
+    uint32_t uTouched = 0;
+
+    if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
+    {
+        for (int16_t iTileY = _iTop; iTileY <= _iBottom; ++iTileY)
+            uTouched += tilemap_visibility_append_sparse_row(_pLayer, _pVis, iTileY, _iLeft, _iRight);
+        return uTouched;
+    }
+
+    if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+    {
+        for (int16_t iTileY = _iTop; iTileY <= _iBottom; ++iTileY)
+            uTouched += tilemap_visibility_append_chunked_row(_pLayer, _pVis, iTileY, _iLeft, _iRight);
+        return uTouched;
+    }
+
+    for (int16_t iTileY = _iTop; iTileY <= _iBottom; ++iTileY)
+    {
+        for (int16_t iTileX = _iLeft; iTileX <= _iRight; ++iTileX)
+        {
+            uTouched++;
+
+            uint8_t uTileId = tilemap_sample_visible_dense_tile(_pLayer, iTileX, iTileY);
+            if (uTileId == TILEMAP_IMPORTER_EMPTY_TILE)
+                continue;
+
+            if (!tilemap_visibility_push(_pVis, iTileX, iTileY, uTileId))
+                _pVis->bTruncated = true;
+        }
+    }
+
+    return uTouched;
+}
+
+/* Remove bucket entries outside the given tile rect (order-preserving compaction). Returns the number removed. */
+static uint32_t tilemap_visibility_drop_outside(tile_layer_visibility_t *_pVis, int16_t _iLeft, int16_t _iTop, int16_t _iRight, int16_t _iBottom)
+{
+    uint32_t uDropped = 0;
+
+    for (uint16_t uBucketIndex = 0; uBucketIndex < _pVis->uBucketCount; ++uBucketIndex)
+    {
+        tile_bucket_t *pBucket = &_pVis->pBuckets[uBucketIndex];
+        uint16_t uWrite = 0;
+
+        for (uint16_t uRead = 0; uRead < pBucket->uCount; ++uRead)
+        {
+            int16_t iTileX = pBucket->aTileX[uRead];
+            int16_t iTileY = pBucket->aTileY[uRead];
+            if (iTileX < _iLeft || iTileX > _iRight || iTileY < _iTop || iTileY > _iBottom)
+            {
+                uDropped++;
+                continue;
+            }
+
+            if (uWrite != uRead)
+            {
+                pBucket->aTileX[uWrite] = iTileX;
+                pBucket->aTileY[uWrite] = iTileY;
+                pBucket->aTileId[uWrite] = pBucket->aTileId[uRead];
+            }
+            uWrite++;
+        }
+
+        pBucket->uCount = uWrite;
+    }
+
+    _pVis->uVisibleCount = (uint16_t)(_pVis->uVisibleCount - uDropped);
+    return uDropped;
+}
+
+/* Edge-scroll update: keep the tiles still inside the new rect, drop the ones that left and
+ * sample only the newly exposed rows/columns. Returns false if the shift is too large for it to pay off. */
+static bool tilemap_update_layer_incremental(const tilemap_layer_t *_pLayer,
+                                             tile_layer_visibility_t *_pVis,
+                                             int16_t _iOldLeft,
+                                             int16_t _iOldTop,
+                                             int16_t _iOldRight,
+                                             int16_t _iOldBottom,
+                                             int16_t _iLeft,
+                                             int16_t _iTop,
+                                             int16_t _iRight,
+                                             int16_t _iBottom,
+                                             uint32_t *_pTouched)
+{
+    if (_pVis->bTruncated || _iOldBottom < _iOldTop || _iOldRight < _iOldLeft)
+        return false;
+
+    if (abs(_iLeft - _iOldLeft) > TILEMAP_INCREMENTAL_MAX_SHIFT || abs(_iRight - _iOldRight) > TILEMAP_INCREMENTAL_MAX_SHIFT ||
+        abs(_iTop - _iOldTop) > TILEMAP_INCREMENTAL_MAX_SHIFT || abs(_iBottom - _iOldBottom) > TILEMAP_INCREMENTAL_MAX_SHIFT)
+        return false;
+
+    /* Rect that stays visible */
+    int16_t iKeepLeft = (_iLeft > _iOldLeft) ? _iLeft : _iOldLeft;
+    int16_t iKeepRight = (_iRight < _iOldRight) ? _iRight : _iOldRight;
+    int16_t iKeepTop = (_iTop > _iOldTop) ? _iTop : _iOldTop;
+    int16_t iKeepBottom = (_iBottom < _iOldBottom) ? _iBottom : _iOldBottom;
+    if (iKeepLeft > iKeepRight || iKeepTop > iKeepBottom)
+        return false;
+
+    /* Drop tiles that left (skipped when the rect only grew) */
+    if (_iLeft > _iOldLeft || _iTop > _iOldTop || _iRight < _iOldRight || _iBottom < _iOldBottom)
+        *_pTouched += tilemap_visibility_drop_outside(_pVis, _iLeft, _iTop, _iRight, _iBottom);
+
+    /* Newly exposed full-width rows above and below the kept rect */
+    if (_iTop < iKeepTop)
+        *_pTouched += tilemap_visibility_append_rect(_pLayer, _pVis, _iLeft, _iTop, _iRight, iKeepTop - 1);
+    if (_iBottom > iKeepBottom)
+        *_pTouched += tilemap_visibility_append_rect(_pLayer, _pVis, _iLeft, iKeepBottom + 1, _iRight, _iBottom);
+
+    /* Newly exposed columns left and right of the kept rect (kept rows only) */
+    if (_iLeft < iKeepLeft)
+        *_pTouched += tilemap_visibility_append_rect(_pLayer, _pVis, _iLeft, iKeepTop, iKeepLeft - 1, iKeepBottom);
+    if (_iRight > iKeepRight)
+        *_pTouched += tilemap_visibility_append_rect(_pLayer, _pVis, iKeepRight + 1, iKeepTop, _iRight, iKeepBottom);
+
+    return true;
+}
+
+void tilemap_update(void)
+{
+    if (!g_mainTilemap.bInitialized)
+        return;
+
+    int16_t iCamLeft = 0, iCamTop = 0, iCamRight = -1, iCamBottom = -1;
+    tilemap_compute_camera_tile_rect(&iCamLeft, &iCamTop, &iCamRight, &iCamBottom);
+
+    uint32_t uTilesTouched = 0;
+
+    for (uint8_t uLayerIndex = 0; uLayerIndex < TILEMAP_IMPORTER_MAX_LAYERS; ++uLayerIndex)
+    {
+        const tilemap_layer_t *pLayer = tilemap_get_render_layer(uLayerIndex);
+        if (!tilemap_layer_is_valid(pLayer))
+            continue;
+
+        if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
+            continue;
+
+        tile_layer_visibility_t *pVis = &g_mainTilemap.aLayerVisibility[uLayerIndex];
+        if (!pVis->pBuckets || pVis->uMaxBuckets == 0)
+            continue;
+
+        int16_t iLeft = iCamLeft;
+        int16_t iTop = iCamTop;
+        int16_t iRight = iCamRight;
+        int16_t iBottom = iCamBottom;
+
+        if (iBottom < iTop)
+        {
+            pVis->bLastRectValid = true;
+            pVis->iLastLeft = iLeft;
+            pVis->iLastTop = iTop;
+            pVis->iLastRight = iRight;
+            pVis->iLastBottom = iBottom;
+            pVis->uBucketCount = 0;
+            pVis->uVisibleCount = 0;
+            continue;
+        }
+
+        if (pVis->bLastRectValid && pVis->iLastLeft == iLeft && pVis->iLastTop == iTop && pVis->iLastRight == iRight && pVis->iLastBottom == iBottom)
+        {
+            continue;
+        }
+
+        bool bHadRect = pVis->bLastRectValid;
+        int16_t iOldLeft = pVis->iLastLeft;
+        int16_t iOldTop = pVis->iLastTop;
+        int16_t iOldRight = pVis->iLastRight;
+        int16_t iOldBottom = pVis->iLastBottom;
+
+        pVis->bLastRectValid = true;
+        pVis->iLastLeft = iLeft;
+        pVis->iLastTop = iTop;
+        pVis->iLastRight = iRight;
+        pVis->iLastBottom = iBottom;
+
+        /* Small scroll: only touch the rows/columns that entered or left the view */
+        if (bHadRect &&
+            tilemap_update_layer_incremental(pLayer, pVis, iOldLeft, iOldTop, iOldRight, iOldBottom, iLeft, iTop, iRight, iBottom, &uTilesTouched))
+        {
+            if (pVis->uBucketCount > 0)
+                CACHE_FLUSH_DATA(pVis->pBuckets, sizeof(tile_bucket_t) * pVis->uBucketCount);
+            continue;
+        }
+
+        /* Full rebuild */
+        tilemap_layer_visibility_reset(pVis);
+        pVis->uVisibleCount = 0;
+        pVis->bTruncated = false;
+
+        /* Sparse layer: walk only the rows in view through the row index.
+         * Chunked layer: walk rows chunk by chunk, skipping empty chunks. */
+        if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE || pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+        {
+            uTilesTouched += tilemap_visibility_append_rect(pLayer, pVis, iLeft, iTop, iRight, iBottom);
+
+            if (pVis->uBucketCount > 0)
+                CACHE_FLUSH_DATA(pVis->pBuckets, sizeof(tile_bucket_t) * pVis->uBucketCount);
+            continue; /* Skip dense iteration path */
+        }
+
+        /* Dense layer path: iterate visible area (original algorithm) */
+
+        /* Determine wrapping/clamping behavior based on tilemap type */
+        /* Check if clamping/wrapping is needed for outer tiles */
+        bool bNeedWrapX = (iLeft < 0) || (iRight >= (int16_t)pLayer->uWidth);
+        bool bNeedClampY = (iTop < 0) || (iBottom >= (int16_t)pLayer->uHeight);
+
+        uTilesTouched += (uint32_t)(iRight - iLeft + 1) * (uint32_t)(iBottom - iTop + 1);
+
+        for (int16_t iTileY = iTop; iTileY <= iBottom; ++iTileY)
+        {
+            int iSampleY = (int)iTileY;
+
+            /* Clamp Y coordinate to repeat top and bottom rows (same logic for both modes) */
+            if (bNeedClampY)
+            {
+                if (iSampleY < 0)
+                    iSampleY = 0; /* Repeat top row */
+                else if (iSampleY >= (int)pLayer->uHeight)
+                    iSampleY = (int)pLayer->uHeight - 1; /* Repeat bottom row */
+            }
+            else
+            {
+                /* in-range fast path */
+                if (iSampleY < 0 || iSampleY >= (int)pLayer->uHeight)
                     continue;
+            }
 
-                /* X visibility check with optional wrapping */
-                bool bVisible = false;
-                int16_t iTileXAdjusted = iTileX;
+            /* Get row pointer for maximum performance (dense storage guaranteed here) */
+            const uint8_t *pRow = pLayer->ppData[iSampleY];
+
+            for (int16_t iTileX = iLeft; iTileX <= iRight; ++iTileX)
+            {
+                int iSampleX = (int)iTileX;
 
-                if (!bNeedWrapCheck)
+                if (s_eTilemapType == TILEMAP_TYPE_JNR)
                 {
-                    /* Fast path: no wrapping needed (JNR or rect fully in bounds) */
-                    bVisible = (iTileX >= iLeft && iTileX <= iRight);
+                    /* JNR mode: clamp X coordinate to repeat left and right columns */
+                    if (bNeedWrapX)
+                    {
+                        if (iSampleX < 0)
+                            iSampleX = 0; /* Repeat left column */
+                        else if (iSampleX >= (int)pLayer->uWidth)
+                            iSampleX = (int)pLayer->uWidth - 1; /* Repeat right column */
+                    }
+                    else
+                    {
+                        /* in-range fast path */
+                        if (iSampleX < 0 || iSampleX >= (int)pLayer->uWidth)
+                            continue;
+                    }
                 }
                 else
                 {
-                    /* SURFACE mode wrapping: check if tile or wrapped equivalent is visible
-                     * Example: tile X=63 in width 64, rect [-2, 10] → check 63, 63-64=-1 (visible!) */
-                    if (iTileX >= iLeft && iTileX <= iRight)
-                    {
-                        bVisible = true;
-                    }
+                    /* SURFACE mode: wrap X coordinate */
+                    if (bNeedWrapX)
+                        iSampleX = tilemap_mod_i(iSampleX, (int)pLayer->uWidth, g_mainTilemap.uWorldWidthMask);
                     else
                     {
-                        /* Check wrapped positions */
-                        int16_t iTileXMinus = iTileX - iLayerWidth;
-                        int16_t iTileXPlus = iTileX + iLayerWidth;
-
-                        if (iTileXMinus >= iLeft && iTileXMinus <= iRight)
-                        {
-                            bVisible = true;
-                            iTileXAdjusted = iTileXMinus;
-                        }
-                        else if (iTileXPlus >= iLeft && iTileXPlus <= iRight)
-                        {
-                            bVisible = true;
-                            iTileXAdjusted = iTileXPlus;
-                        }
+                        /* in-range fast path */
+                        if (iSampleX >= (int)pLayer->uWidth)
+                            continue;
                     }
                 }
 
-                if (!bVisible)
+                uint8_t uTileId = pRow[iSampleX];
+                if (uTileId == TILEMAP_IMPORTER_EMPTY_TILE)
                     continue;
 
-                if (uVisibleCount >= (uint16_t)TILEMAP_MAX_VISIBLE_TILES)
-                    break;
+                if (!tilemap_visibility_push(pVis, iTileX, iTileY, uTileId)) /* store UNWRAPPED */
+                {
+                    pVis->bTruncated = true;
+                    if (pVis->uVisibleCount >= (uint16_t)TILEMAP_MAX_VISIBLE_TILES)
+                        break;
+                }
+            }
 
-                /* Look up atlas entry to get pageId */
-                tile_atlas_entry_t tAtlasEntry;
-                if (!tilemap_importer_get_atlas_entry(&g_mainTilemap.importer, uTileId, &tAtlasEntry))
+            if (pVis->uVisibleCount >= (uint16_t)TILEMAP_MAX_VISIBLE_TILES)
+                break;
+        }
+
+        /* Flush cache for this layer's buckets after populating them */
+        if (pVis->pBuckets && pVis->uBucketCount > 0)
+        {
+            CACHE_FLUSH_DATA(pVis->pBuckets, sizeof(tile_bucket_t) * pVis->uBucketCount);
+        }
+    }
+
+    PROF_COUNTER_ADD(PROF_COUNTER_TILES_TOUCHED, uTilesTouched);
+}
+
+/* =========================
+   JNR chunk cache
+   =========================
+   Each cached layer keeps one byte per 64x64 px chunk: a slot index, TILEMAP_CHUNK_CACHE_NO_SLOT
+   (not rasterized yet) or TILEMAP_CHUNK_CACHE_EMPTY (no visible tile, nothing to draw).
+   Slots are reused least-recently-drawn first; a slot drawn this frame is never evicted. */
+
+#define TILEMAP_CHUNK_CACHE_SLOT_BYTES (TILEMAP_CHUNK_CACHE_PIXELS * TILEMAP_CHUNK_CACHE_PIXELS * 2)
+#define TILEMAP_CHUNK_CACHE_MAX_SLOTS (TILEMAP_CHUNK_CACHE_BUDGET_BYTES_EXPANDED / TILEMAP_CHUNK_CACHE_SLOT_BYTES)
+#define TILEMAP_CHUNK_CACHE_NO_SLOT 0xFF
+#define TILEMAP_CHUNK_CACHE_EMPTY 0xFE
+/* rdpq_tex_blit splits a chunk into TMEM-sized strips: one load + one rectangle each */
+#define TILEMAP_CHUNK_CACHE_BLIT_DRAWS ((TILEMAP_CHUNK_CACHE_SLOT_BYTES + 4095) / 4096)
+
+_Static_assert(TILEMAP_CHUNK_CACHE_PIXELS % TILE_SIZE == 0, "chunk must hold whole tiles");
+_Static_assert(TILEMAP_CHUNK_CACHE_MAX_SLOTS > 0 && TILEMAP_CHUNK_CACHE_MAX_SLOTS < TILEMAP_CHUNK_CACHE_EMPTY, "slot index must fit below the marker values");
+_Static_assert(TILEMAP_CHUNK_CACHE_MIN_SLOTS <= TILEMAP_CHUNK_CACHE_MAX_SLOTS, "expanded budget must hold the minimum slot count");
+
+typedef struct
+{
+    surface_t surface;
+    uint32_t uLastFrame;  /* Frame stamp of the last blit (LRU key) */
+    uint32_t uChunkIndex; /* Owner chunk (cy * chunksX + cx) */
+    uint8_t uLayer;       /* Owner layer, TILEMAP_CHUNK_CACHE_NO_SLOT when free */
+} tilemap_chunk_slot_t;
+
+typedef struct
+{
+    tilemap_chunk_slot_t aSlots[TILEMAP_CHUNK_CACHE_MAX_SLOTS];
+    uint8_t *apSlotByChunk[TILEMAP_IMPORTER_MAX_LAYERS]; /* Per-layer chunk -> slot map, NULL if layer not cached */
+    uint16_t auChunksX[TILEMAP_IMPORTER_MAX_LAYERS];
+    uint16_t auChunksY[TILEMAP_IMPORTER_MAX_LAYERS];
+    uint32_t uFrame;
+    uint16_t uFillsLeft;
+    uint8_t uSlotCount;
+} tilemap_chunk_cache_t;
+
+static tilemap_chunk_cache_t s_chunkCache;
+
+/* Floor division for chunk coordinates left/above the map origin */
+static inline int tilemap_chunk_floor_div(int _iValue, int _iDivisor)
+{
+    int iQ = _iValue / _iDivisor;
+    if ((_iValue % _iDivisor) != 0 && _iValue < 0)
+        --iQ;
+    return iQ;
+}
+
+/* Tile shown at cell (x, y) with the same rules as the visibility rebuild (JNR: dense and chunked layers repeat
+ * their edge tiles, sparse layers are empty outside the map) */
+static inline uint8_t tilemap_chunk_cache_sample(const tilemap_layer_t *_pLayer, int _iTileX, int _iTileY)
+{
+    if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE && (_iTileX < 0 || _iTileY < 0 || _iTileX >= (int)_pLayer->uWidth || _iTileY >= (int)_pLayer->uHeight))
+        return TILEMAP_IMPORTER_EMPTY_TILE;
+
+    int iSampleX, iSampleY;
+    tilemap_resolve_tile_coords(_pLayer, _iTileX, _iTileY, &iSampleX, &iSampleY);
+    return tilemap_layer_get_tile(_pLayer, iSampleX, iSampleY);
+}
+
+/* Draw the tiles of one chunk with its top-left at (_iOriginX, _iOriginY) in the current target.
+ * Caller sets the render mode. Returns the number of rectangles issued. */
+static uint32_t tilemap_chunk_cache_draw_tiles(const tilemap_layer_t *_pLayer, int _iChunkX, int _iChunkY, int _iOriginX, int _iOriginY, bool _bClipToScreen)
+{
+    int iCurrentPage = -1;
+    uint32_t uDraws = 0;
+
+    for (int iTy = 0; iTy < TILEMAP_CHUNK_CACHE_TILES; ++iTy)
+    {
+        int iScreenY = _iOriginY + iTy * TILE_SIZE;
+        if (_bClipToScreen && (iScreenY + TILE_SIZE <= 0 || iScreenY >= SCREEN_H))
+            continue;
+
+        for (int iTx = 0; iTx < TILEMAP_CHUNK_CACHE_TILES; ++iTx)
+        {
+            int iScreenX = _iOriginX + iTx * TILE_SIZE;
+            if (_bClipToScreen && (iScreenX + TILE_SIZE <= 0 || iScreenX >= SCREEN_W))
+                continue;
+
+            uint8_t uTileId = tilemap_chunk_cache_sample(_pLayer, _iChunkX * TILEMAP_CHUNK_CACHE_TILES + iTx, _iChunkY * TILEMAP_CHUNK_CACHE_TILES + iTy);
+            if (uTileId == TILEMAP_IMPORTER_EMPTY_TILE)
+                continue;
+
+            tile_atlas_entry_t tAtlasEntry;
+            if (!tilemap_importer_get_atlas_entry(&g_mainTilemap.importer, uTileId, &tAtlasEntry))
+                continue;
+
+            if ((int)tAtlasEntry.uPageIndex != iCurrentPage)
+            {
+                const surface_t *pAtlasPage = tilemap_importer_get_atlas_page(&g_mainTilemap.importer, tAtlasEntry.uPageIndex);
+                if (!pAtlasPage)
                     continue;
+                rdpq_tex_upload(TILE0, pAtlasPage, NULL);
+                iCurrentPage = (int)tAtlasEntry.uPageIndex;
+            }
 
-                uint8_t uPageId = tAtlasEntry.uPageIndex;
-                int16_t iBucketIndex = pVis->aBucketIndexByPageId[uPageId];
-                tile_bucket_t *pBucket = NULL;
+            rdpq_texture_rectangle(TILE0, iScreenX, iScreenY, iScreenX + TILE_SIZE, iScreenY + TILE_SIZE, (int)tAtlasEntry.uU0, (int)tAtlasEntry.uV0);
+            ++uDraws;
+        }
+    }
 
-                if (iBucketIndex < 0)
-                {
-                    if (pVis->uBucketCount >= pVis->uMaxBuckets)
-                        continue;
+    return uDraws;
+}
 
-                    uint16_t uNewIndex = pVis->uBucketCount++;
-                    pBucket = &pVis->pBuckets[uNewIndex];
-                    pBucket->uPageId = (uint16_t)uPageId;
-                    pBucket->uCount = 0;
+/* Least recently drawn slot not used this frame, detached from its previous owner. Returns TILEMAP_CHUNK_CACHE_NO_SLOT if all are in use. */
+static uint8_t tilemap_chunk_cache_acquire_slot(void)
+{
+    uint8_t uBest = TILEMAP_CHUNK_CACHE_NO_SLOT;
+    uint32_t uBestFrame = UINT32_MAX;
 
-                    pVis->aBucketIndexByPageId[uPageId] = (int16_t)uNewIndex;
-                }
-                else
-                {
-                    pBucket = &pVis->pBuckets[(uint16_t)iBucketIndex];
-                }
+    for (uint8_t uSlot = 0; uSlot < s_chunkCache.uSlotCount; ++uSlot)
+    {
+        const tilemap_chunk_slot_t *pSlot = &s_chunkCache.aSlots[uSlot];
+        if (pSlot->uLayer == TILEMAP_CHUNK_CACHE_NO_SLOT)
+            return uSlot;
+        if (pSlot->uLastFrame != s_chunkCache.uFrame && pSlot->uLastFrame < uBestFrame)
+        {
+            uBestFrame = pSlot->uLastFrame;
+            uBest = uSlot;
+        }
+    }
 
-                if (pBucket->uCount < TILEMAP_BUCKET_SIZE)
-                {
-                    pBucket->aTileX[pBucket->uCount] = iTileXAdjusted; /* Use wrapped coordinate for correct rendering */
-                    pBucket->aTileY[pBucket->uCount] = iTileY;
-                    pBucket->aTileId[pBucket->uCount] = uTileId;
-                    pBucket->uCount++;
-                    uVisibleCount++;
-                }
+    if (uBest != TILEMAP_CHUNK_CACHE_NO_SLOT)
+    {
+        tilemap_chunk_slot_t *pSlot = &s_chunkCache.aSlots[uBest];
+        s_chunkCache.apSlotByChunk[pSlot->uLayer][pSlot->uChunkIndex] = TILEMAP_CHUNK_CACHE_NO_SLOT;
+        pSlot->uLayer = TILEMAP_CHUNK_CACHE_NO_SLOT;
+    }
+
+    return uBest;
+}
+
+/* Rasterize one chunk into a cache slot (or mark it empty). Returns the number of RDP draws issued. */
+static uint32_t tilemap_chunk_cache_fill(const tilemap_layer_t *_pLayer, uint8_t _uLayerIndex, int _iChunkX, int _iChunkY)
+{
+    uint32_t uChunkIndex = (uint32_t)_iChunkY * s_chunkCache.auChunksX[_uLayerIndex] + (uint32_t)_iChunkX;
+    uint8_t *pEntry = &s_chunkCache.apSlotByChunk[_uLayerIndex][uChunkIndex];
+
+    /* Empty chunks never need a slot */
+    bool bEmpty = true;
+    for (int iTy = 0; iTy < TILEMAP_CHUNK_CACHE_TILES && bEmpty; ++iTy)
+    {
+        for (int iTx = 0; iTx < TILEMAP_CHUNK_CACHE_TILES; ++iTx)
+        {
+            if (tilemap_chunk_cache_sample(_pLayer, _iChunkX * TILEMAP_CHUNK_CACHE_TILES + iTx, _iChunkY * TILEMAP_CHUNK_CACHE_TILES + iTy) != TILEMAP_IMPORTER_EMPTY_TILE)
+            {
+                bEmpty = false;
+                break;
             }
-            continue; /* Skip dense iteration path */
         }
+    }
 
-        /* Dense layer path: iterate visible area (original algorithm) */
+    if (bEmpty)
+    {
+        *pEntry = TILEMAP_CHUNK_CACHE_EMPTY;
+        return 0;
+    }
 
-        /* Determine wrapping/clamping behavior based on tilemap type */
-        /* Check if clamping/wrapping is needed for outer tiles */
-        bool bNeedWrapX = (iLeft < 0) || (iRight >= (int16_t)pLayer->uWidth);
-        bool bNeedClampY = (iTop < 0) || (iBottom >= (int16_t)pLayer->uHeight);
+    uint8_t uSlot = tilemap_chunk_cache_acquire_slot();
+    if (uSlot == TILEMAP_CHUNK_CACHE_NO_SLOT)
+        return 0;
+
+    tilemap_chunk_slot_t *pSlot = &s_chunkCache.aSlots[uSlot];
+
+    /* Nested attach: rdpq_detach restores the display target. Clear to transparent so
+     * empty cells keep alpha 0 for the alpha-compared blit of upper layers. */
+    rdpq_attach(&pSlot->surface, NULL);
+    rdpq_set_mode_fill(RGBA32(0, 0, 0, 0));
+    rdpq_fill_rectangle(0, 0, TILEMAP_CHUNK_CACHE_PIXELS, TILEMAP_CHUNK_CACHE_PIXELS);
+    rdpq_set_mode_copy(false);
+    uint32_t uDraws = 1 + tilemap_chunk_cache_draw_tiles(_pLayer, _iChunkX, _iChunkY, 0, 0, false);
+    rdpq_detach();
+
+    pSlot->uLayer = _uLayerIndex;
+    pSlot->uChunkIndex = uChunkIndex;
+    pSlot->uLastFrame = s_chunkCache.uFrame;
+    *pEntry = uSlot;
+
+    return uDraws;
+}
+
+static inline bool tilemap_chunk_cache_layer_enabled(const tilemap_layer_t *_pLayer, uint8_t _uLayerIndex)
+{
+    return s_chunkCache.uSlotCount > 0 && s_chunkCache.apSlotByChunk[_uLayerIndex] && _pLayer->eStorage != TILEMAP_LAYER_STORAGE_SINGLE;
+}
+
+/* Render one layer from cached chunks at integer base (_iBaseX, _iBaseY). Newly exposed chunks are
+ * rasterized first (up to the per-frame fill budget), since that switches the render target;
+ * chunks still missing afterwards are drawn per tile straight to the screen. */
+static void tilemap_chunk_cache_render_layer(const tilemap_layer_t *_pLayer, uint8_t _uLayerIndex, int _iBaseX, int _iBaseY)
+{
+    const int iChunksX = (int)s_chunkCache.auChunksX[_uLayerIndex];
+    const int iChunksY = (int)s_chunkCache.auChunksY[_uLayerIndex];
+    uint8_t *pMap = s_chunkCache.apSlotByChunk[_uLayerIndex];
+
+    int iCx0 = tilemap_chunk_floor_div(-_iBaseX, TILEMAP_CHUNK_CACHE_PIXELS);
+    int iCx1 = tilemap_chunk_floor_div(SCREEN_W - 1 - _iBaseX, TILEMAP_CHUNK_CACHE_PIXELS);
+    int iCy0 = tilemap_chunk_floor_div(-_iBaseY, TILEMAP_CHUNK_CACHE_PIXELS);
+    int iCy1 = tilemap_chunk_floor_div(SCREEN_H - 1 - _iBaseY, TILEMAP_CHUNK_CACHE_PIXELS);
+
+    /* Cached grid covers the map only; visible chunks outside it always draw per tile */
+    int iGx0 = (iCx0 < 0) ? 0 : iCx0;
+    int iGx1 = (iCx1 >= iChunksX) ? iChunksX - 1 : iCx1;
+    int iGy0 = (iCy0 < 0) ? 0 : iCy0;
+    int iGy1 = (iCy1 >= iChunksY) ? iChunksY - 1 : iCy1;
+
+    uint32_t uDraws = 0;
+
+    /* Stamp visible slots first so the fills below cannot evict them */
+    for (int iCy = iGy0; iCy <= iGy1; ++iCy)
+    {
+        for (int iCx = iGx0; iCx <= iGx1; ++iCx)
+        {
+            uint8_t uEntry = pMap[iCy * iChunksX + iCx];
+            if (uEntry < s_chunkCache.uSlotCount)
+                s_chunkCache.aSlots[uEntry].uLastFrame = s_chunkCache.uFrame;
+        }
+    }
+
+    for (int iCy = iGy0; iCy <= iGy1 && s_chunkCache.uFillsLeft > 0; ++iCy)
+    {
+        for (int iCx = iGx0; iCx <= iGx1 && s_chunkCache.uFillsLeft > 0; ++iCx)
+        {
+            if (pMap[iCy * iChunksX + iCx] != TILEMAP_CHUNK_CACHE_NO_SLOT)
+                continue;
+            uDraws += tilemap_chunk_cache_fill(_pLayer, _uLayerIndex, iCx, iCy);
+            --s_chunkCache.uFillsLeft;
+        }
+    }
+
+    rdpq_set_mode_copy(false);
+    rdpq_mode_alphacompare(_uLayerIndex == 0 ? 0 : 1);
+
+    for (int iCy = iCy0; iCy <= iCy1; ++iCy)
+    {
+        int iScreenY = _iBaseY + iCy * TILEMAP_CHUNK_CACHE_PIXELS;
+        bool bRowInGrid = (iCy >= 0 && iCy < iChunksY);
 
-        for (int16_t iTileY = iTop; iTileY <= iBottom; ++iTileY)
+        for (int iCx = iCx0; iCx <= iCx1; ++iCx)
         {
-            int iSampleY = (int)iTileY;
+            int iScreenX = _iBaseX + iCx * TILEMAP_CHUNK_CACHE_PIXELS;
+            uint8_t uEntry = (bRowInGrid && iCx >= 0 && iCx < iChunksX) ? pMap[iCy * iChunksX + iCx] : TILEMAP_CHUNK_CACHE_NO_SLOT;
 
-            /* Clamp Y coordinate to repeat top and bottom rows (same logic for both modes) */
-            if (bNeedClampY)
+            if (uEntry == TILEMAP_CHUNK_CACHE_EMPTY)
+                continue;
+
+            if (uEntry < s_chunkCache.uSlotCount)
             {
-                if (iSampleY < 0)
-                    iSampleY = 0; /* Repeat top row */
-                else if (iSampleY >= (int)pLayer->uHeight)
-                    iSampleY = (int)pLayer->uHeight - 1; /* Repeat bottom row */
+                rdpq_tex_blit(&s_chunkCache.aSlots[uEntry].surface, iScreenX, iScreenY, NULL);
+                uDraws += TILEMAP_CHUNK_CACHE_BLIT_DRAWS;
             }
             else
             {
-                /* in-range fast path */
-                if (iSampleY < 0 || iSampleY >= (int)pLayer->uHeight)
-                    continue;
+                uDraws += tilemap_chunk_cache_draw_tiles(_pLayer, iCx, iCy, iScreenX, iScreenY, true);
             }
+        }
+    }
 
-            /* Get row pointer for maximum performance (dense storage guaranteed here) */
-            const uint8_t *pRow = pLayer->ppData[iSampleY];
-
-            for (int16_t iTileX = iLeft; iTileX <= iRight; ++iTileX)
-            {
-                int iSampleX = (int)iTileX;
-
-                if (s_eTilemapType == TILEMAP_TYPE_JNR)
-                {
-                    /* JNR mode: clamp X coordinate to repeat left and right columns */
-                    if (bNeedWrapX)
-                    {
-                        if (iSampleX < 0)
-                            iSampleX = 0; /* Repeat left column */
-                        else if (iSampleX >= (int)pLayer->uWidth)
-                            iSampleX = (int)pLayer->uWidth - 1; /* Repeat right column */
-                    }
-                    else
-                    {
-                        /* in-range fast path */
-                        if (iSampleX < 0 || iSampleX >= (int)pLayer->uWidth)
-                            continue;
-                    }
-                }
-                else
-                {
-                    /* SURFACE mode: wrap X coordinate */
-                    if (bNeedWrapX)
-                        iSampleX = tilemap_mod_i(iSampleX, (int)pLayer->uWidth, g_mainTilemap.uWorldWidthMask);
-                    else
-                    {
-                        /* in-range fast path */
-                        if (iSampleX >= (int)pLayer->uWidth)
-                            continue;
-                    }
-                }
+    PROF_COUNTER_ADD(PROF_COUNTER_TILE_DRAWS, uDraws);
+    PROF_COUNTER_ADD(PROF_COUNTER_TILE_DRAWS_UNCACHED, g_mainTilemap.aLayerVisibility[_uLayerIndex].uVisibleCount);
+}
 
-                uint8_t uTileId = pRow[iSampleX];
-                if (uTileId == TILEMAP_IMPORTER_EMPTY_TILE)
-                    continue;
+static void tilemap_chunk_cache_free(void)
+{
+    for (uint8_t uSlot = 0; uSlot < s_chunkCache.uSlotCount; ++uSlot)
+        surface_free(&s_chunkCache.aSlots[uSlot].surface);
 
-                if (uVisibleCount >= (uint16_t)TILEMAP_MAX_VISIBLE_TILES)
-                    break;
+    for (uint8_t i = 0; i < TILEMAP_IMPORTER_MAX_LAYERS; ++i)
+    {
+        if (s_chunkCache.apSlotByChunk[i])
+            free(s_chunkCache.apSlotByChunk[i]);
+    }
 
-                /* Look up atlas entry to get pageId */
-                tile_atlas_entry_t tAtlasEntry;
-                if (!tilemap_importer_get_atlas_entry(&g_mainTilemap.importer, uTileId, &tAtlasEntry))
-                    continue; /* Invalid tile or no atlas entry */
+    memset(&s_chunkCache, 0, sizeof(s_chunkCache));
+}
 
-                uint8_t uPageId = tAtlasEntry.uPageIndex;
-                int16_t iBucketIndex = pVis->aBucketIndexByPageId[uPageId];
-                tile_bucket_t *pBucket = NULL;
+/* Slots to allocate for the current map: the RAM budget, capped by a share of what the loaded map left free */
+static uint8_t tilemap_chunk_cache_slot_budget(void)
+{
+    size_t uBudget = is_memory_expanded() ? TILEMAP_CHUNK_CACHE_BUDGET_BYTES_EXPANDED : TILEMAP_CHUNK_CACHE_BUDGET_BYTES;
+
+    heap_stats_t stats;
+    sys_get_heap_stats(&stats);
+    size_t uHeapFree = (stats.total > stats.used) ? (size_t)(stats.total - stats.used) : 0;
+    if (uBudget > uHeapFree / TILEMAP_CHUNK_CACHE_HEAP_SHARE)
+        uBudget = uHeapFree / TILEMAP_CHUNK_CACHE_HEAP_SHARE;
+
+    size_t uSlots = uBudget / TILEMAP_CHUNK_CACHE_SLOT_BYTES;
+    if (uSlots > TILEMAP_CHUNK_CACHE_MAX_SLOTS)
+        uSlots = TILEMAP_CHUNK_CACHE_MAX_SLOTS;
+    return (uint8_t)uSlots;
+}
 
-                if (iBucketIndex < 0)
-                {
-                    if (pVis->uBucketCount >= pVis->uMaxBuckets)
-                        continue;
+/* Allocate chunk maps for the cached JNR layers and as many slots as the budget allows.
+ * Failure is not fatal: the renderer falls back to the per-tile path. */
+static void tilemap_chunk_cache_init(void)
+{
+    memset(&s_chunkCache, 0, sizeof(s_chunkCache));
 
-                    uint16_t uNewIndex = pVis->uBucketCount++;
-                    pBucket = &pVis->pBuckets[uNewIndex];
-                    pBucket->uPageId = (uint16_t)uPageId;
-                    pBucket->uCount = 0;
+    uint8_t uSlotBudget = tilemap_chunk_cache_slot_budget();
+    if (uSlotBudget < TILEMAP_CHUNK_CACHE_MIN_SLOTS)
+    {
+        debugf("Chunk cache: off (%d slots fit, %d needed)\n", uSlotBudget, TILEMAP_CHUNK_CACHE_MIN_SLOTS);
+        return;
+    }
 
-                    pVis->aBucketIndexByPageId[uPageId] = (int16_t)uNewIndex;
-                }
-                else
-                {
-                    pBucket = &pVis->pBuckets[(uint16_t)iBucketIndex];
-                }
+    uint8_t uLayerCount = g_mainTilemap.importer.uLayerCount;
+    for (uint8_t i = 0; i < uLayerCount && i < TILEMAP_IMPORTER_MAX_LAYERS; ++i)
+    {
+        if (!(TILEMAP_CHUNK_CACHE_LAYER_MASK & (1u << i)))
+            continue;
 
-                if (pBucket->uCount < TILEMAP_BUCKET_SIZE)
-                {
-                    pBucket->aTileX[pBucket->uCount] = iTileX; /* store UNWRAPPED */
-                    pBucket->aTileY[pBucket->uCount] = iTileY;
-                    pBucket->aTileId[pBucket->uCount] = uTileId; /* Store tileId for u/v lookup */
-                    pBucket->uCount++;
-                    uVisibleCount++;
-                }
-            }
+        const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, i);
+        if (!tilemap_layer_is_valid(pLayer) || pLayer->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
+            continue;
 
-            if (uVisibleCount >= (uint16_t)TILEMAP_MAX_VISIBLE_TILES)
-                break;
-        }
+        uint16_t uChunksX = (uint16_t)((pLayer->uWidth + TILEMAP_CHUNK_CACHE_TILES - 1) / TILEMAP_CHUNK_CACHE_TILES);
+        uint16_t uChunksY = (uint16_t)((pLayer->uHeight + TILEMAP_CHUNK_CACHE_TILES - 1) / TILEMAP_CHUNK_CACHE_TILES);
+        size_t uMapBytes = (size_t)uChunksX * uChunksY;
 
-        /* Flush cache for this layer's buckets after populating them */
-        if (pVis->pBuckets && pVis->uBucketCount > 0)
+        s_chunkCache.apSlotByChunk[i] = (uint8_t *)malloc(uMapBytes);
+        if (!s_chunkCache.apSlotByChunk[i])
         {
-            CACHE_FLUSH_DATA(pVis->pBuckets, sizeof(tile_bucket_t) * pVis->uBucketCount);
+            debugf("Chunk cache: failed to allocate chunk map for layer %d\n", i);
+            goto fail;
         }
+        memset(s_chunkCache.apSlotByChunk[i], TILEMAP_CHUNK_CACHE_NO_SLOT, uMapBytes);
+        s_chunkCache.auChunksX[i] = uChunksX;
+        s_chunkCache.auChunksY[i] = uChunksY;
+    }
+
+    for (uint8_t uSlot = 0; uSlot < uSlotBudget; ++uSlot)
+    {
+        tilemap_chunk_slot_t *pSlot = &s_chunkCache.aSlots[uSlot];
+        pSlot->surface = surface_alloc(FMT_RGBA16, TILEMAP_CHUNK_CACHE_PIXELS, TILEMAP_CHUNK_CACHE_PIXELS);
+        if (!pSlot->surface.buffer)
+            break; /* keep the slots we got */
+        pSlot->uLayer = TILEMAP_CHUNK_CACHE_NO_SLOT;
+        s_chunkCache.uSlotCount = (uint8_t)(uSlot + 1);
+    }
+
+    if (s_chunkCache.uSlotCount < TILEMAP_CHUNK_CACHE_MIN_SLOTS)
+    {
+        debugf("Chunk cache: only %d slot surfaces allocated\n", s_chunkCache.uSlotCount);
+        goto fail;
     }
+
+    s_chunkCache.uFrame = 1; /* stamp 0 means never drawn */
+    debugf("Chunk cache: %d slots (%lu KB)\n", s_chunkCache.uSlotCount, (unsigned long)(s_chunkCache.uSlotCount * TILEMAP_CHUNK_CACHE_SLOT_BYTES / 1024));
+    return;
+
+fail:
+    tilemap_chunk_cache_free();
 }
 
 /* =========================
@@ -882,7 +1893,7 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
     /* Iterate layers */
     for (uint8_t uLayerIndex = _uStartLayer; uLayerIndex <= _uEndLayer; ++uLayerIndex)
     {
-        const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, uLayerIndex);
+        const tilemap_layer_t *pLayer = tilemap_get_render_layer(uLayerIndex);
         if (!tilemap_layer_is_valid(pLayer))
             continue;
 
@@ -931,6 +1942,9 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
                     float fT1 = ((float)iRenderY1 - fBaseY) / fZoom;
                     rdpq_texture_rectangle_scaled(TILE0, 0, 0, iRenderX1, iRenderY1, fS0, fT0, fS1, fT1);
                 }
+
+                PROF_COUNTER_ADD(PROF_COUNTER_TILE_DRAWS, 1);
+                PROF_COUNTER_ADD(PROF_COUNTER_TILE_DRAWS_UNCACHED, 1);
             }
             else /* DEBUG */
             {
@@ -945,6 +1959,13 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
             continue;
         }
 
+        /* JNR chunk cache: blit pre-rendered chunks instead of one rectangle per tile */
+        if (_eMode == TILEMAP_RENDER_MODE_TEXTURE && bUseIntegerMath && tilemap_chunk_cache_layer_enabled(pLayer, uLayerIndex))
+        {
+            tilemap_chunk_cache_render_layer(pLayer, uLayerIndex, iBaseXInt, iBaseYInt);
+            continue;
+        }
+
         /* Set RDP mode per layer based on render mode (DENSE/SPARSE path) */
         if (_eMode == TILEMAP_RENDER_MODE_TEXTURE)
         {
@@ -973,6 +1994,7 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
         }
 
         const tile_layer_visibility_t *pVis = &g_mainTilemap.aLayerVisibility[uLayerIndex];
+        uint32_t uLayerDraws = 0;
 
         /* Iterate buckets */
         for (uint16_t uBucketIndex = 0; uBucketIndex < pVis->uBucketCount; ++uBucketIndex)
@@ -984,7 +2006,7 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
             /* Texture mode: upload atlas page once per bucket */
             if (_eMode == TILEMAP_RENDER_MODE_TEXTURE)
             {
-                const surface_t *pAtlasPage = tilemap_importer_get_atlas_page(&g_mainTilemap.importer, (uint8_t)pBucket->uPageId);
+                const surface_t *pAtlasPage = tilemap_visibility_atlas_page(pVis, (uint8_t)pBucket->uPageId);
                 if (!pAtlasPage)
                     continue;
 
@@ -998,7 +2020,7 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
                 uint8_t uTileId;
                 tile_atlas_entry_t tAtlasEntry;
 
-                if (!tilemap_get_tile_data(pBucket, uTileIndex, &iTileX, &iTileY, &uTileId, &tAtlasEntry))
+                if (!tilemap_get_tile_data(pVis, pBucket, uTileIndex, &iTileX, &iTileY, &uTileId, &tAtlasEntry))
                     continue;
 
                 /* Calculate screen position */
@@ -1046,13 +2068,14 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
                                                       (float)(tAtlasEntry.uU0 + TILE_SIZE),
                                                       (float)(tAtlasEntry.uV0 + TILE_SIZE));
                     }
+                    ++uLayerDraws;
                 }
                 else /* TILEMAP_RENDER_MODE_DEBUG */
                 {
                     /* Get trimmed rect for debug visualization */
                     struct vec2i vTrimmedOffset = {0, 0};
                     struct vec2i vTrimmedSize = {0, 0};
-                    bool bHasTrimmedRect = tilemap_importer_get_tile_trimmed_rect(&g_mainTilemap.importer, uTileId, &vTrimmedOffset, &vTrimmedSize);
+                    bool bHasTrimmedRect = !pVis->bFlat && tilemap_importer_get_tile_trimmed_rect(&g_mainTilemap.importer, uTileId, &vTrimmedOffset, &vTrimmedSize);
 
                     if (!bHasTrimmedRect || vTrimmedSize.iX == 0 || vTrimmedSize.iY == 0)
                     {
@@ -1088,6 +2111,10 @@ static void tilemap_render_layers(uint8_t _uStartLayer, uint8_t _uEndLayer, tile
                 }
             }
         }
+
+        /* Per-tile path: draws issued are also what the uncached renderer costs */
+        PROF_COUNTER_ADD(PROF_COUNTER_TILE_DRAWS, uLayerDraws);
+        PROF_COUNTER_ADD(PROF_COUNTER_TILE_DRAWS_UNCACHED, uLayerDraws);
     }
 }
 
@@ -1160,11 +2187,6 @@ void tilemap_render_surface_end(void)
     rdpq_set_mode_standard();
     rdpq_mode_filter(FILTER_BILINEAR);
 
-    /* Distortion cache (per frame) */
-    int16_t aCacheY[TILEMAP_SPHERE_CACHE_MAX];
-    int32_t aCacheFq[TILEMAP_SPHERE_CACHE_MAX];
-    uint8_t uCacheCount = 0;
-
     /* Pre-calculate constants outside loop (optimization) */
     float fSourceCenter = (float)g_surfTemp.width * 0.5f;
     float fScreenW = (float)iScreenW;
@@ -1179,7 +2201,7 @@ void tilemap_render_surface_end(void)
      * PERFORMANCE BREAKDOWN:
      * - Tile rendering: ~hundreds of rdpq_texture_rectangle_scaled calls (one per visible tile)
      * - Distortion: 48 texture uploads + 48 render calls (unavoidable due to TMEM)
-     * - Distortion factor calculation: Already cached, minimal cost
+     * - Distortion factor calculation: one table lookup per row
      */
     for (int iY = 0; iY < iScreenH; iY += iRowHeight)
     {
@@ -1187,9 +2209,9 @@ void tilemap_render_surface_end(void)
         if (iY + iH > iScreenH)
             iH = iScreenH - iY;
 
-        /* Calculate distortion factor for this row center (cached, fast) */
+        /* Distortion factor for this row center (table lookup) */
         int iSampleY = iY + iH / 2;
-        int32_t iFactorQ = tilemap_get_sphere_factor_q16((int16_t)iSampleY, aCacheY, aCacheFq, &uCacheCount, (int16_t)iCenterY);
+        int32_t iFactorQ = tilemap_get_sphere_factor_q16(iSampleY, (int16_t)iCenterY);
         float fFactor = (float)iFactorQ * fQ16ToFloat; /* Optimized: use pre-calculated constant */
 
         /* Calculate source rectangle width based on distortion */
@@ -1232,6 +2254,10 @@ void tilemap_render_surface_end(void)
 /* Public API wrappers for unified rendering function */
 void tilemap_render_jnr_begin(void)
 {
+    /* New frame for the chunk cache LRU and fill budget (tilemap_render_jnr_end shares it) */
+    ++s_chunkCache.uFrame;
+    s_chunkCache.uFillsLeft = TILEMAP_CHUNK_CACHE_FILLS_PER_FRAME;
+
     tilemap_render_layers(0, 2, TILEMAP_RENDER_MODE_TEXTURE);
 }
 
@@ -1297,6 +2323,18 @@ bool tilemap_can_walk(struct vec2 _vWorldPos, bool _bCheckLanding)
     if (!g_mainTilemap.bInitialized)
         return false;
 
+    /* SURFACE: one collision mask read answers ground, blocking and landing */
+    const tilemap_layer_t *pRefLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, 0);
+    if (s_eTilemapType == TILEMAP_TYPE_SURFACE && tilemap_layer_is_valid(pRefLayer))
+    {
+        int iTileX, iTileY, iSampleX, iSampleY;
+        tilemap_world_to_tile_coords(_vWorldPos, &iTileX, &iTileY);
+        tilemap_resolve_tile_coords(pRefLayer, iTileX, iTileY, &iSampleX, &iSampleY);
+
+        tilemap_collision_code_t eCode = tilemap_collision_code_at(iSampleX, iSampleY);
+        return eCode == TILEMAP_COLLISION_CODE_FREE || (eCode == TILEMAP_COLLISION_CODE_LANDING_BLOCKED && !_bCheckLanding);
+    }
+
     /* Check walkable layer (ground) - must have a tile */
     uint8_t uTileWalkable = tilemap_get_tile_id_at_world_pos(_vWorldPos, TILEMAP_LAYER_SURFACE_WALKABLE);
     if (uTileWalkable == TILEMAP_IMPORTER_EMPTY_TILE)
@@ -1333,21 +2371,36 @@ static inline bool boxes_intersect(float _fBox1Left, float _fBox1Right, float _f
 
 /* Helper: Check if a box collides with tiles in a specific layer.
  * Returns true if collision found, false otherwise.
- * _bUseTileBoundingBoxes: if true, uses full tile boxes; if false, uses trimmed rects. */
+ * _bUseTileBoundingBoxes: if true, uses full tile boxes; if false, uses trimmed rects.
+ * _uLayerIndex: selects the collision mask codes that can hold a tile of this layer (rows and tiles without one are skipped). */
 static bool tilemap_check_collision_with_layer(float _fPlayerLeft, float _fPlayerRight, float _fPlayerTop, float _fPlayerBottom, int _iTileLeft, int _iTileRight, int _iTileTop,
-                                               int _iTileBottom, const tilemap_layer_t *_pLayer, bool _bUseTileBoundingBoxes)
+                                               int _iTileBottom, uint8_t _uLayerIndex, bool _bUseTileBoundingBoxes)
 {
-    if (!tilemap_layer_is_valid(_pLayer))
+    const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, _uLayerIndex);
+    if (!tilemap_layer_is_valid(pLayer))
+        return false;
+
+    /* Box only covers empty chunks: nothing to test */
+    if (tilemap_tile_rect_is_empty(pLayer, _iTileLeft, _iTileTop, _iTileRight, _iTileBottom))
         return false;
 
+    const uint8_t uCodeSet = tilemap_collision_code_set_for_layer(_uLayerIndex);
+
     for (int iTileY = _iTileTop; iTileY <= _iTileBottom; ++iTileY)
     {
+        /* Whole row span has no candidate tile (16 tiles per mask word) */
+        if (uCodeSet && !tilemap_collision_row_any(iTileY, _iTileLeft, _iTileRight, uCodeSet))
+            continue;
+
         for (int iTileX = _iTileLeft; iTileX <= _iTileRight; ++iTileX)
         {
             int iSampleX, iSampleY;
-            tilemap_resolve_tile_coords(_pLayer, iTileX, iTileY, &iSampleX, &iSampleY);
+            tilemap_resolve_tile_coords(pLayer, iTileX, iTileY, &iSampleX, &iSampleY);
 
-            uint8_t uTileId = tilemap_layer_get_tile(_pLayer, iSampleX, iSampleY);
+            if (uCodeSet && !(uCodeSet & TILEMAP_COLLISION_SET(tilemap_collision_code_at(iSampleX, iSampleY))))
+                continue;
+
+            uint8_t uTileId = tilemap_layer_get_tile(pLayer, iSampleX, iSampleY);
             if (uTileId == TILEMAP_IMPORTER_EMPTY_TILE)
                 continue;
 
@@ -1394,6 +2447,18 @@ static bool tilemap_check_collision_with_layer(float _fPlayerLeft, float _fPlaye
     return false;
 }
 
+/* True if the walkable layer has a tile at the world position (SURFACE reads the collision mask) */
+static inline bool tilemap_has_ground_at_world_pos(const tilemap_layer_t *_pWalkableLayer, struct vec2 _vWorldPos)
+{
+    if (s_eTilemapType != TILEMAP_TYPE_SURFACE)
+        return tilemap_get_tile_id_at_world_pos(_vWorldPos, TILEMAP_LAYER_SURFACE_WALKABLE) != TILEMAP_IMPORTER_EMPTY_TILE;
+
+    int iTileX, iTileY, iSampleX, iSampleY;
+    tilemap_world_to_tile_coords(_vWorldPos, &iTileX, &iTileY);
+    tilemap_resolve_tile_coords(_pWalkableLayer, iTileX, iTileY, &iSampleX, &iSampleY);
+    return tilemap_collision_code_at(iSampleX, iSampleY) != TILEMAP_COLLISION_CODE_HOLE;
+}
+
 bool tilemap_can_walk_box(struct vec2 _vCenterPos, struct vec2 _vHalfExtents, bool _bUseTileBoundingBoxes, bool _bCheckLanding)
 {
     if (!g_mainTilemap.bInitialized)
@@ -1419,12 +2484,12 @@ bool tilemap_can_walk_box(struct vec2 _vCenterPos, struct vec2 _vHalfExtents, bo
     int iTileTop = (int)fm_floorf(fBoxTop / (float)TILE_SIZE);
     int iTileBottom = (int)fm_floorf(fBoxBottom / (float)TILE_SIZE);
 
-    /* Get SURFACE layers */
-    const tilemap_layer_t *pCollisionLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_COLLISION);
+    /* Get SURFACE walkable layer */
     const tilemap_layer_t *pWalkableLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_WALKABLE);
 
     /* 1. Check collision layer (layer 2) - return false if box collides with blocking tiles */
-    if (tilemap_check_collision_with_layer(fBoxLeft, fBoxRight, fBoxTop, fBoxBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, pCollisionLayer, _bUseTileBoundingBoxes))
+    if (tilemap_check_collision_with_layer(
+            fBoxLeft, fBoxRight, fBoxTop, fBoxBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, TILEMAP_LAYER_SURFACE_COLLISION, _bUseTileBoundingBoxes))
     {
         return false; /* Blocked by collision tiles */
     }
@@ -1440,7 +2505,7 @@ bool tilemap_can_walk_box(struct vec2 _vCenterPos, struct vec2 _vHalfExtents, bo
     struct vec2 aCorners[4] = {{fBoxLeft, fBoxTop}, {fBoxRight, fBoxTop}, {fBoxLeft, fBoxBottom}, {fBoxRight, fBoxBottom}};
     for (int i = 0; i < 4; ++i)
     {
-        if (tilemap_get_tile_id_at_world_pos(aCorners[i], TILEMAP_LAYER_SURFACE_WALKABLE) == TILEMAP_IMPORTER_EMPTY_TILE)
+        if (!tilemap_has_ground_at_world_pos(pWalkableLayer, aCorners[i]))
             return false; /* No ground support at corner */
     }
 
@@ -1448,15 +2513,15 @@ bool tilemap_can_walk_box(struct vec2 _vCenterPos, struct vec2 _vHalfExtents, bo
     if (_bCheckLanding)
     {
         /* Check decoration background layer (layer 3) - return false if box collides */
-        const tilemap_layer_t *pDecoBGLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_DECO_BG);
-        if (tilemap_check_collision_with_layer(fBoxLeft, fBoxRight, fBoxTop, fBoxBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, pDecoBGLayer, _bUseTileBoundingBoxes))
+        if (tilemap_check_collision_with_layer(
+                fBoxLeft, fBoxRight, fBoxTop, fBoxBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, TILEMAP_LAYER_SURFACE_DECO_BG, _bUseTileBoundingBoxes))
         {
             return false; /* Landing blocked by decoration background */
         }
 
         /* Check decoration foreground layer (layer 4) - return false if box collides */
-        const tilemap_layer_t *pDecoFGLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_DECO_FG);
-        if (tilemap_check_collision_with_layer(fBoxLeft, fBoxRight, fBoxTop, fBoxBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, pDecoFGLayer, _bUseTileBoundingBoxes))
+        if (tilemap_check_collision_with_layer(
+                fBoxLeft, fBoxRight, fBoxTop, fBoxBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, TILEMAP_LAYER_SURFACE_DECO_FG, _bUseTileBoundingBoxes))
         {
             return false; /* Landing blocked by decoration foreground */
         }
@@ -1491,11 +2556,8 @@ bool tilemap_check_collision_layer(struct vec2 _vCenterPos, struct vec2 _vHalfEx
     int iTileTop = (int)fm_floorf(fPlayerTop / (float)TILE_SIZE);
     int iTileBottom = (int)fm_floorf(fPlayerBottom / (float)TILE_SIZE);
 
-    /* Get the specified layer */
-    const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, _uLayerIndex);
-
-    /* Check collision with layer using trimmed rects */
-    return tilemap_check_collision_with_layer(fPlayerLeft, fPlayerRight, fPlayerTop, fPlayerBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, pLayer, false);
+    /* Check collision with the specified layer using trimmed rects */
+    return tilemap_check_collision_with_layer(fPlayerLeft, fPlayerRight, fPlayerTop, fPlayerBottom, iTileLeft, iTileRight, iTileTop, iTileBottom, _uLayerIndex, false);
 }
 
 /* Helper: Sweep AABB vs AABB (Ray vs AABB in Minkowski space) */
@@ -1574,186 +2636,329 @@ static bool sweep_aabb(struct vec2 _vOrigin, struct vec2 _vDelta, struct vec2 _v
     return true;
 }
 
-tilemap_sweep_result_t tilemap_sweep_box(struct vec2 _vStartPos, struct vec2 _vDelta, struct vec2 _vHalfExtents, tilemap_collision_type_t _eType)
+/* Sweep state shared by the per-tile tests of tilemap_sweep_box */
+typedef struct
 {
-    tilemap_sweep_result_t result = {1.0f, {0.0f, 0.0f}, false, false};
+    struct vec2 vStartPos;
+    struct vec2 vDelta;
+    struct vec2 vHalfExtents;
+    tilemap_collision_type_t eType;
+
+    const tilemap_layer_t *pRefLayer; /* Layer 0, used for wrapping/clamping */
+    const tilemap_layer_t *pCollisionLayer;
+    const tilemap_layer_t *pWalkableLayer;
+    const tilemap_layer_t *pJnrLayer;
+
+    /* Collision mask codes that can collide in this sweep; SURFACE sweeps on a SURFACE map are fully
+     * classified by the mask, other combinations only use it to skip tiles (0: no mask for this combination) */
+    uint8_t uCodeSet;
+    bool bMaskClassifies;
+
+    /* Earliest tile hit; equal times keep the lowest row, then column (the order of a row-major scan) */
+    tilemap_sweep_result_t best;
+    int iBestTileX;
+    int iBestTileY;
+} tilemap_sweep_state_t;
+
+/* Time slack when stopping the traversal after a hit (tiles are entered 1 px early, see tilemap_sweep_box) */
+#define TILEMAP_SWEEP_TIME_EPSILON 1e-4f
+
+static bool tilemap_sweep_state_init(tilemap_sweep_state_t *_pState, struct vec2 _vStartPos, struct vec2 _vDelta, struct vec2 _vHalfExtents, tilemap_collision_type_t _eType)
+{
+    /* Pre-fetch reference layer (Layer 0) for wrapping calculations */
+    _pState->pRefLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, 0);
+    if (!tilemap_layer_is_valid(_pState->pRefLayer))
+        return false;
 
-    if (!g_mainTilemap.bInitialized)
-        return result;
+    _pState->vStartPos = _vStartPos;
+    _pState->vDelta = _vDelta;
+    _pState->vHalfExtents = _vHalfExtents;
+    _pState->eType = _eType;
+
+    _pState->pCollisionLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_COLLISION);
+    _pState->pWalkableLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_WALKABLE);
+    _pState->pJnrLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_JNR_COLLISION);
+
+    _pState->bMaskClassifies = (_eType == TILEMAP_COLLISION_SURFACE && s_eTilemapType == TILEMAP_TYPE_SURFACE);
+    _pState->uCodeSet = 0;
+    if (_pState->bMaskClassifies)
+        _pState->uCodeSet = TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_SOLID) | TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_HOLE);
+    else if (_eType == TILEMAP_COLLISION_JNR)
+        _pState->uCodeSet = tilemap_collision_code_set_for_layer(TILEMAP_LAYER_JNR_COLLISION);
+
+    _pState->best = (tilemap_sweep_result_t){1.0f, {0.0f, 0.0f}, false, false};
+    _pState->iBestTileX = 0;
+    _pState->iBestTileY = 0;
+    return true;
+}
 
-    /* Determine which layer(s) to check based on collision type */
-    /* JNR: Check Layer 1 (Geometry). Surface: Check Layer 2 (Blocking) AND Layer 1 (Water/Hole) */
+/* Sweep the box against one tile (visible, unwrapped coordinates) and keep the earliest hit */
+static void tilemap_sweep_test_tile(tilemap_sweep_state_t *_pState, int _iTileX, int _iTileY)
+{
+    int iSampleX, iSampleY;
+    tilemap_resolve_tile_coords(_pState->pRefLayer, _iTileX, _iTileY, &iSampleX, &iSampleY);
 
-    /* Calculate bounds of swept box */
-    float fStartLeft = _vStartPos.fX - _vHalfExtents.fX;
-    float fStartRight = _vStartPos.fX + _vHalfExtents.fX;
-    float fStartTop = _vStartPos.fY - _vHalfExtents.fY;
-    float fStartBottom = _vStartPos.fY + _vHalfExtents.fY;
-
-    float fEndLeft = fStartLeft + _vDelta.fX;
-    float fEndRight = fStartRight + _vDelta.fX;
-    float fEndTop = fStartTop + _vDelta.fY;
-    float fEndBottom = fStartBottom + _vDelta.fY;
-
-    float fMinX = fminf(fStartLeft, fEndLeft);
-    float fMaxX = fmaxf(fStartRight, fEndRight);
-    float fMinY = fminf(fStartTop, fEndTop);
-    float fMaxY = fmaxf(fStartBottom, fEndBottom);
-
-    /* Convert to tile coordinates (range to check) */
-    /* Add a small margin to be safe */
-    int iTileMinX = (int)fm_floorf((fMinX - 1.0f) / (float)TILE_SIZE);
-    int iTileMaxX = (int)fm_ceilf((fMaxX + 1.0f) / (float)TILE_SIZE);
-    int iTileMinY = (int)fm_floorf((fMinY - 1.0f) / (float)TILE_SIZE);
-    int iTileMaxY = (int)fm_ceilf((fMaxY + 1.0f) / (float)TILE_SIZE);
+    tilemap_collision_code_t eCode = tilemap_collision_code_at(iSampleX, iSampleY);
+    if (_pState->uCodeSet && !(_pState->uCodeSet & TILEMAP_COLLISION_SET(eCode)))
+        return;
 
-    /* Check north/south boundaries */
-    if (g_mainTilemap.uWorldHeightTiles > 0)
+    /* Perform collision check based on type */
+    bool bIsCollision = false;
+    uint8_t uTileIdToCheck = TILEMAP_IMPORTER_EMPTY_TILE;
+
+    if (_pState->bMaskClassifies)
+    {
+        /* Hole (full tile) or blocking tile (needs its ID for the trimmed rect) */
+        bIsCollision = true;
+        if (eCode == TILEMAP_COLLISION_CODE_SOLID)
+            uTileIdToCheck = tilemap_layer_get_tile(_pState->pCollisionLayer, iSampleX, iSampleY);
+    }
+    else if (_pState->eType == TILEMAP_COLLISION_SURFACE)
     {
-        float fWorldHeight = (float)(g_mainTilemap.uWorldHeightTiles * TILE_SIZE);
-        if (fMaxY > fWorldHeight)
+        /* SURFACE: Collision if walkable has NO tile (water/hole) OR collision has tile (blocking) */
+        const tilemap_layer_t *pCollisionLayer = _pState->pCollisionLayer;
+        const tilemap_layer_t *pWalkableLayer = _pState->pWalkableLayer;
+        uint8_t uTileCollision = (tilemap_layer_is_valid(pCollisionLayer)) ? tilemap_layer_get_tile(pCollisionLayer, iSampleX, iSampleY) : TILEMAP_IMPORTER_EMPTY_TILE;
+        uint8_t uTileWalkable = (tilemap_layer_is_valid(pWalkableLayer)) ? tilemap_layer_get_tile(pWalkableLayer, iSampleX, iSampleY) : TILEMAP_IMPORTER_EMPTY_TILE;
+
+        if (uTileWalkable == TILEMAP_IMPORTER_EMPTY_TILE)
         {
-            /* Check collision with bottom boundary */
-            struct vec2 vBottomMin = {-100000.0f, fWorldHeight};
-            struct vec2 vBottomMax = {100000.0f, fWorldHeight + 100.0f};
-            float fTime;
-            struct vec2 vNormal;
-            bool bCornerish;
-            if (sweep_aabb(_vStartPos, _vDelta, _vHalfExtents, vBottomMin, vBottomMax, &fTime, &vNormal, &bCornerish))
-            {
-                if (fTime < result.fTime)
-                {
-                    result.fTime = fTime;
-                    result.vNormal = vNormal;
-                    result.bHit = true;
-                    result.bCornerish = bCornerish;
-                }
-            }
+            /* Hit water/hole (empty walkable) */
+            bIsCollision = true;
+            uTileIdToCheck = TILEMAP_IMPORTER_EMPTY_TILE;
         }
-        if (fMinY < 0.0f)
+        else if (uTileCollision != TILEMAP_IMPORTER_EMPTY_TILE)
         {
-            /* Check collision with top boundary */
-            struct vec2 vTopMin = {-100000.0f, -100.0f};
-            struct vec2 vTopMax = {100000.0f, 0.0f};
-            float fTime;
-            struct vec2 vNormal;
-            bool bCornerish;
-            if (sweep_aabb(_vStartPos, _vDelta, _vHalfExtents, vTopMin, vTopMax, &fTime, &vNormal, &bCornerish))
-            {
-                if (fTime < result.fTime)
-                {
-                    result.fTime = fTime;
-                    result.vNormal = vNormal;
-                    result.bHit = true;
-                    result.bCornerish = bCornerish;
-                }
-            }
+            /* Hit collision/blocking layer */
+            bIsCollision = true;
+            uTileIdToCheck = uTileCollision;
         }
     }
-
-    /* Pre-fetch reference layer (Layer 0) for wrapping calculations */
-    const tilemap_layer_t *pRefLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, 0);
-    if (!tilemap_layer_is_valid(pRefLayer))
-        return result;
-
-    /* Iterate tiles */
-    for (int iTileY = iTileMinY; iTileY <= iTileMaxY; ++iTileY)
+    else /* TILEMAP_COLLISION_JNR */
     {
-        for (int iTileX = iTileMinX; iTileX <= iTileMaxX; ++iTileX)
+        /* JNR: Collision if collision layer has tile */
+        const tilemap_layer_t *pLayer = _pState->pJnrLayer;
+        uint8_t uTileId = (tilemap_layer_is_valid(pLayer)) ? tilemap_layer_get_tile(pLayer, iSampleX, iSampleY) : TILEMAP_IMPORTER_EMPTY_TILE;
+
+        if (uTileId != TILEMAP_IMPORTER_EMPTY_TILE)
         {
-            int iSampleX, iSampleY;
-            tilemap_resolve_tile_coords(pRefLayer, iTileX, iTileY, &iSampleX, &iSampleY);
+            bIsCollision = true;
+            uTileIdToCheck = uTileId;
+        }
+    }
+
+    if (!bIsCollision)
+        return;
 
-            /* Perform collision check based on type */
-            bool bIsCollision = false;
-            uint8_t uTileIdToCheck = TILEMAP_IMPORTER_EMPTY_TILE;
+    /* Calculate tile bounds */
+    float fTileWorldX = (float)_iTileX * (float)TILE_SIZE;
+    float fTileWorldY = (float)_iTileY * (float)TILE_SIZE;
+    struct vec2 vTileMin, vTileMax;
 
-            if (_eType == TILEMAP_COLLISION_SURFACE)
-            {
-                /* SURFACE: Collision if walkable has NO tile (water/hole) OR collision has tile (blocking) */
-                const tilemap_layer_t *pCollisionLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_COLLISION);
-                const tilemap_layer_t *pWalkableLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_SURFACE_WALKABLE);
+    /* Use trimmed rect if available (and valid tile ID) */
+    struct vec2i vTrimmedOffset = {0, 0};
+    struct vec2i vTrimmedSize = {0, 0};
+    bool bHasTrimmed = false;
 
-                uint8_t uTileCollision = (tilemap_layer_is_valid(pCollisionLayer)) ? tilemap_layer_get_tile(pCollisionLayer, iSampleX, iSampleY) : TILEMAP_IMPORTER_EMPTY_TILE;
-                uint8_t uTileWalkable = (tilemap_layer_is_valid(pWalkableLayer)) ? tilemap_layer_get_tile(pWalkableLayer, iSampleX, iSampleY) : TILEMAP_IMPORTER_EMPTY_TILE;
+    if (uTileIdToCheck != TILEMAP_IMPORTER_EMPTY_TILE)
+    {
+        bHasTrimmed = tilemap_importer_get_tile_trimmed_rect(&g_mainTilemap.importer, uTileIdToCheck, &vTrimmedOffset, &vTrimmedSize);
+    }
 
-                if (uTileWalkable == TILEMAP_IMPORTER_EMPTY_TILE)
-                {
-                    /* Hit water/hole (empty walkable) */
-                    bIsCollision = true;
-                    uTileIdToCheck = TILEMAP_IMPORTER_EMPTY_TILE;
-                }
-                else if (uTileCollision != TILEMAP_IMPORTER_EMPTY_TILE)
-                {
-                    /* Hit collision/blocking layer */
-                    bIsCollision = true;
-                    uTileIdToCheck = uTileCollision;
-                }
-            }
-            else /* TILEMAP_COLLISION_JNR */
-            {
-                /* JNR: Collision if collision layer has tile */
-                const tilemap_layer_t *pLayer = tilemap_importer_get_layer(&g_mainTilemap.importer, TILEMAP_LAYER_JNR_COLLISION);
-                uint8_t uTileId = (tilemap_layer_is_valid(pLayer)) ? tilemap_layer_get_tile(pLayer, iSampleX, iSampleY) : TILEMAP_IMPORTER_EMPTY_TILE;
+    if (bHasTrimmed && vTrimmedSize.iX > 0 && vTrimmedSize.iY > 0)
+    {
+        vTileMin.fX = fTileWorldX + (float)vTrimmedOffset.iX;
+        vTileMin.fY = fTileWorldY + (float)vTrimmedOffset.iY;
+        vTileMax.fX = vTileMin.fX + (float)vTrimmedSize.iX;
+        vTileMax.fY = vTileMin.fY + (float)vTrimmedSize.iY;
+    }
+    else
+    {
+        /* Fallback to full tile (always used for "Water" collision) */
+        vTileMin.fX = fTileWorldX;
+        vTileMin.fY = fTileWorldY;
+        vTileMax.fX = fTileWorldX + (float)TILE_SIZE;
+        vTileMax.fY = fTileWorldY + (float)TILE_SIZE;
+    }
 
-                if (uTileId != TILEMAP_IMPORTER_EMPTY_TILE)
-                {
-                    bIsCollision = true;
-                    uTileIdToCheck = uTileId;
-                }
-            }
+    float fTime;
+    struct vec2 vNormal;
+    bool bCornerish;
+    if (!sweep_aabb(_pState->vStartPos, _pState->vDelta, _pState->vHalfExtents, vTileMin, vTileMax, &fTime, &vNormal, &bCornerish))
+        return;
 
-            if (!bIsCollision)
-                continue;
+    /* If we found a closer collision (or an equally close one earlier in row-major order) */
+    tilemap_sweep_result_t *pBest = &_pState->best;
+    bool bEarlierTile = (_iTileY < _pState->iBestTileY) || (_iTileY == _pState->iBestTileY && _iTileX < _pState->iBestTileX);
+    if (fTime < pBest->fTime || (pBest->bHit && fTime == pBest->fTime && bEarlierTile))
+    {
+        pBest->fTime = fTime;
+        pBest->vNormal = vNormal;
+        pBest->bHit = true;
+        pBest->bCornerish = bCornerish;
+        _pState->iBestTileX = _iTileX;
+        _pState->iBestTileY = _iTileY;
+    }
+}
 
-            /* Calculate tile bounds */
-            float fTileWorldX = (float)iTileX * (float)TILE_SIZE;
-            float fTileWorldY = (float)iTileY * (float)TILE_SIZE;
-            struct vec2 vTileMin, vTileMax;
+/* Test the tiles [_iLeft, _iRight] of one row, skipping rows without a candidate in the collision mask */
+static void tilemap_sweep_test_row(tilemap_sweep_state_t *_pState, int _iTileY, int _iLeft, int _iRight)
+{
+    if (_pState->uCodeSet && !tilemap_collision_row_any(_iTileY, _iLeft, _iRight, _pState->uCodeSet))
+        return;
 
-            /* Use trimmed rect if available (and valid tile ID) */
-            struct vec2i vTrimmedOffset = {0, 0};
-            struct vec2i vTrimmedSize = {0, 0};
-            bool bHasTrimmed = false;
+    for (int iTileX = _iLeft; iTileX <= _iRight; ++iTileX)
+        tilemap_sweep_test_tile(_pState, iTileX, _iTileY);
+}
 
-            if (uTileIdToCheck != TILEMAP_IMPORTER_EMPTY_TILE)
-            {
-                bHasTrimmed = tilemap_importer_get_tile_trimmed_rect(&g_mainTilemap.importer, uTileIdToCheck, &vTrimmedOffset, &vTrimmedSize);
-            }
+/* Sweep against the north/south world boundaries */
+static void tilemap_sweep_world_bounds(struct vec2 _vStartPos, struct vec2 _vDelta, struct vec2 _vHalfExtents, tilemap_sweep_result_t *_pResult)
+{
+    if (g_mainTilemap.uWorldHeightTiles == 0)
+        return;
+
+    float fMinY = fminf(_vStartPos.fY, _vStartPos.fY + _vDelta.fY) - _vHalfExtents.fY;
+    float fMaxY = fmaxf(_vStartPos.fY, _vStartPos.fY + _vDelta.fY) + _vHalfExtents.fY;
+    float fWorldHeight = (float)(g_mainTilemap.uWorldHeightTiles * TILE_SIZE);
 
-            if (bHasTrimmed && vTrimmedSize.iX > 0 && vTrimmedSize.iY > 0)
+    if (fMaxY > fWorldHeight)
+    {
+        /* Check collision with bottom boundary */
+        struct vec2 vBottomMin = {-100000.0f, fWorldHeight};
+        struct vec2 vBottomMax = {100000.0f, fWorldHeight + 100.0f};
+        float fTime;
+        struct vec2 vNormal;
+        bool bCornerish;
+        if (sweep_aabb(_vStartPos, _vDelta, _vHalfExtents, vBottomMin, vBottomMax, &fTime, &vNormal, &bCornerish))
+        {
+            if (fTime < _pResult->fTime)
             {
-                vTileMin.fX = fTileWorldX + (float)vTrimmedOffset.iX;
-                vTileMin.fY = fTileWorldY + (float)vTrimmedOffset.iY;
-                vTileMax.fX = vTileMin.fX + (float)vTrimmedSize.iX;
-                vTileMax.fY = vTileMin.fY + (float)vTrimmedSize.iY;
+                _pResult->fTime = fTime;
+                _pResult->vNormal = vNormal;
+                _pResult->bHit = true;
+                _pResult->bCornerish = bCornerish;
             }
-            else
+        }
+    }
+    if (fMinY < 0.0f)
+    {
+        /* Check collision with top boundary */
+        struct vec2 vTopMin = {-100000.0f, -100.0f};
+        struct vec2 vTopMax = {100000.0f, 0.0f};
+        float fTime;
+        struct vec2 vNormal;
+        bool bCornerish;
+        if (sweep_aabb(_vStartPos, _vDelta, _vHalfExtents, vTopMin, vTopMax, &fTime, &vNormal, &bCornerish))
+        {
+            if (fTime < _pResult->fTime)
             {
-                /* Fallback to full tile (always used for "Water" collision) */
-                vTileMin.fX = fTileWorldX;
-                vTileMin.fY = fTileWorldY;
-                vTileMax.fX = fTileWorldX + (float)TILE_SIZE;
-                vTileMax.fY = fTileWorldY + (float)TILE_SIZE;
+                _pResult->fTime = fTime;
+                _pResult->vNormal = vNormal;
+                _pResult->bHit = true;
+                _pResult->bCornerish = bCornerish;
             }
+        }
+    }
+}
 
-            float fTime;
-            struct vec2 vNormal;
-            bool bCornerish;
-            if (sweep_aabb(_vStartPos, _vDelta, _vHalfExtents, vTileMin, vTileMax, &fTime, &vNormal, &bCornerish))
-            {
-                /* If we found a closer collision */
-                if (fTime < result.fTime)
-                {
-                    result.fTime = fTime;
-                    result.vNormal = vNormal;
-                    result.bHit = true;
-                    result.bCornerish = bCornerish;
-                }
-            }
+/* Boundary hits win ties against tiles (they were tested first) */
+static inline void tilemap_sweep_merge_best(const tilemap_sweep_state_t *_pState, tilemap_sweep_result_t *_pResult)
+{
+    if (_pState->best.bHit && _pState->best.fTime < _pResult->fTime)
+        *_pResult = _pState->best;
+}
+
+tilemap_sweep_result_t tilemap_sweep_box(struct vec2 _vStartPos, struct vec2 _vDelta, struct vec2 _vHalfExtents, tilemap_collision_type_t _eType)
+{
+    tilemap_sweep_result_t result = {1.0f, {0.0f, 0.0f}, false, false};
+
+    if (!g_mainTilemap.bInitialized)
+        return result;
+
+    /* Determine which layer(s) to check based on collision type */
+    /* JNR: Check Layer 1 (Geometry). Surface: Check Layer 2 (Blocking) AND Layer 1 (Water/Hole) */
+
+    /* Check north/south boundaries */
+    tilemap_sweep_world_bounds(_vStartPos, _vDelta, _vHalfExtents, &result);
+
+    tilemap_sweep_state_t state;
+    if (!tilemap_sweep_state_init(&state, _vStartPos, _vDelta, _vHalfExtents, _eType))
+        return result;
+
+    /* Box at t = 0, grown by 1 px so tiles the box merely touches are visited too (sweep_aabb reports contact) */
+    const float fMargin = 1.0f;
+    float fLeft = _vStartPos.fX - _vHalfExtents.fX - fMargin;
+    float fRight = _vStartPos.fX + _vHalfExtents.fX + fMargin;
+    float fTop = _vStartPos.fY - _vHalfExtents.fY - fMargin;
+    float fBottom = _vStartPos.fY + _vHalfExtents.fY + fMargin;
+
+    int iTileLeft = (int)fm_floorf(fLeft / (float)TILE_SIZE);
+    int iTileRight = (int)fm_floorf(fRight / (float)TILE_SIZE);
+    int iTileTop = (int)fm_floorf(fTop / (float)TILE_SIZE);
+    int iTileBottom = (int)fm_floorf(fBottom / (float)TILE_SIZE);
+
+    /* JNR: swept rect only covers empty collision chunks (SURFACE also collides with empty walkable tiles) */
+    if (_eType == TILEMAP_COLLISION_JNR)
+    {
+        float fEndLeft = fLeft + _vDelta.fX;
+        float fEndRight = fRight + _vDelta.fX;
+        float fEndTop = fTop + _vDelta.fY;
+        float fEndBottom = fBottom + _vDelta.fY;
+        int iSweptLeft = (int)fm_floorf(fminf(fLeft, fEndLeft) / (float)TILE_SIZE);
+        int iSweptRight = (int)fm_floorf(fmaxf(fRight, fEndRight) / (float)TILE_SIZE);
+        int iSweptTop = (int)fm_floorf(fminf(fTop, fEndTop) / (float)TILE_SIZE);
+        int iSweptBottom = (int)fm_floorf(fmaxf(fBottom, fEndBottom) / (float)TILE_SIZE);
+        if (!tilemap_layer_is_valid(state.pJnrLayer) || tilemap_tile_rect_is_empty(state.pJnrLayer, iSweptLeft, iSweptTop, iSweptRight, iSweptBottom))
+            return result;
+    }
+
+    /* Tiles under the box at the start */
+    for (int iTileY = iTileTop; iTileY <= iTileBottom; ++iTileY)
+        tilemap_sweep_test_row(&state, iTileY, iTileLeft, iTileRight);
+
+    /* Grid traversal: follow the leading edges; each step enters one new column or row of tiles, in time order.
+     * A tile is entered no later than its earliest possible hit, so the walk stops once past the best hit. */
+    const float fNever = 2.0f;
+    float fNextX = fNever, fStepX = 0.0f;
+    float fNextY = fNever, fStepY = 0.0f;
+
+    if (_vDelta.fX > 0.0f)
+        fNextX = ((float)(iTileRight + 1) * (float)TILE_SIZE - fRight) / _vDelta.fX;
+    else if (_vDelta.fX < 0.0f)
+        fNextX = ((float)iTileLeft * (float)TILE_SIZE - fLeft) / _vDelta.fX;
+    if (_vDelta.fX != 0.0f)
+        fStepX = (float)TILE_SIZE / fabsf(_vDelta.fX);
+
+    if (_vDelta.fY > 0.0f)
+        fNextY = ((float)(iTileBottom + 1) * (float)TILE_SIZE - fBottom) / _vDelta.fY;
+    else if (_vDelta.fY < 0.0f)
+        fNextY = ((float)iTileTop * (float)TILE_SIZE - fTop) / _vDelta.fY;
+    if (_vDelta.fY != 0.0f)
+        fStepY = (float)TILE_SIZE / fabsf(_vDelta.fY);
+
+    for (;;)
+    {
+        float fNext = fminf(fNextX, fNextY);
+        float fStopTime = fminf(result.fTime, state.best.fTime) + TILEMAP_SWEEP_TIME_EPSILON;
+        if (fNext > 1.0f || fNext > fStopTime)
+            break;
+
+        if (fNextX <= fNextY)
+        {
+            int iTileX = (_vDelta.fX > 0.0f) ? ++iTileRight : --iTileLeft;
+            for (int iTileY = iTileTop; iTileY <= iTileBottom; ++iTileY)
+                tilemap_sweep_test_tile(&state, iTileX, iTileY);
+            fNextX += fStepX;
+        }
+        else
+        {
+            int iTileY = (_vDelta.fY > 0.0f) ? ++iTileBottom : --iTileTop;
+            tilemap_sweep_test_row(&state, iTileY, iTileLeft, iTileRight);
+            fNextY += fStepY;
         }
     }
 
+    tilemap_sweep_merge_best(&state, &result);
     return result;
 }
 
@@ -1804,44 +3009,66 @@ bool tilemap_world_to_surface_smooth(struct vec2 _vWorldPos, struct vec2i *_pOut
     return tilemap_world_to_surface_internal(_vWorldPos, _pOutSurface, false);
 }
 
-/* Convert world position to screen position, adjusted by the spherical distortion of the tilemap */
-bool tilemap_world_to_screen_distorted(struct vec2 _vWorldPos, struct vec2i *_pOutScreen)
+/* Convert world positions to screen positions, adjusted by the spherical distortion of the tilemap.
+ * Camera terms are hoisted out of the loop; each point costs one multiply-add per axis and a table lookup. */
+uint16_t tilemap_world_to_screen_distorted_batch(const struct vec2 *_pWorldPos, struct vec2i *_pOutScreen, bool *_pOutVisible, uint16_t _uCount)
 {
-    if (!_pOutScreen)
-        return false;
+    if (!_pWorldPos || !_pOutScreen)
+        return 0;
 
     if (!g_mainTilemap.bInitialized)
     {
         /* Fallback to standard camera conversion if tilemap not initialized */
-        camera_world_to_screen(&g_mainCamera, _vWorldPos, _pOutScreen);
-        return true;
+        for (uint16_t i = 0; i < _uCount; ++i)
+        {
+            camera_world_to_screen(&g_mainCamera, _pWorldPos[i], &_pOutScreen[i]);
+            if (_pOutVisible)
+                _pOutVisible[i] = true;
+        }
+        return _uCount;
     }
 
-    /* Convert world to screen using standard camera (with quantization in SURFACE mode) */
-    struct vec2i vScreenBase;
-    camera_world_to_screen(&g_mainCamera, _vWorldPos, &vScreenBase);
+    /* Same terms and evaluation order as camera_world_to_screen */
+    float fZoom = camera_get_zoom(&g_mainCamera);
+    float fBaseX = (float)g_mainCamera.vHalf.iX - g_mainCamera.vPos.fX * fZoom;
+    float fBaseY = (float)g_mainCamera.vHalf.iY - g_mainCamera.vPos.fY * fZoom;
 
-    /* Get screen center for distortion calculation */
-    int16_t iCenterX = (int16_t)g_mainCamera.vHalf.iX;
+    int iCenterX = g_mainCamera.vHalf.iX;
     int16_t iCenterY = (int16_t)g_mainCamera.vHalf.iY;
+    if (iCenterY != s_iSphereLutCenterY)
+        tilemap_sphere_lut_build(iCenterY);
+
+    uint16_t uVisibleCount = 0;
+
+    for (uint16_t i = 0; i < _uCount; ++i)
+    {
+        int iScreenX = (int)fm_floorf(fBaseX + _pWorldPos[i].fX * fZoom);
+        int iScreenY = (int)fm_floorf(fBaseY + _pWorldPos[i].fY * fZoom);
 
-    /* Calculate distortion factor for this Y coordinate */
-    int16_t aCacheY[TILEMAP_SPHERE_CACHE_MAX];
-    int32_t aCacheFq[TILEMAP_SPHERE_CACHE_MAX];
-    uint8_t uCacheCount = 0;
+        /* Y is not distorted, only X */
+        int iAbsDeltaY = abs(iScreenY - (int)iCenterY);
+        int32_t iFactorQ = (iAbsDeltaY < TILEMAP_SPHERE_LUT_ROWS) ? s_aSphereFactorQ16[iAbsDeltaY] : tilemap_sphere_factor_compute_q16(iAbsDeltaY, iCenterY);
+        int iDistortedX = tilemap_apply_sphere_distortion_x(iCenterX, iScreenX - iCenterX, iFactorQ);
 
-    int32_t iFactorQ = tilemap_get_sphere_factor_q16((int16_t)vScreenBase.iY, aCacheY, aCacheFq, &uCacheCount, iCenterY);
+        _pOutScreen[i].iX = iDistortedX;
+        _pOutScreen[i].iY = iScreenY;
 
-    /* Apply spherical distortion to X coordinate */
-    int iOffsetX = vScreenBase.iX - (int)iCenterX;
-    int iDistortedX = tilemap_apply_sphere_distortion_x((int)iCenterX, iOffsetX, iFactorQ);
+        bool bVisible = (iDistortedX >= 0 && iDistortedX < SCREEN_W && iScreenY >= 0 && iScreenY < SCREEN_H);
+        if (_pOutVisible)
+            _pOutVisible[i] = bVisible;
+        uVisibleCount += bVisible ? 1 : 0;
+    }
+
+    return uVisibleCount;
+}
 
-    /* Y coordinate is not distorted, only X */
-    _pOutScreen->iX = iDistortedX;
-    _pOutScreen->iY = vScreenBase.iY;
+/* Convert world position to screen position, adjusted by the spherical distortion of the tilemap */
+bool tilemap_world_to_screen_distorted(struct vec2 _vWorldPos, struct vec2i *_pOutScreen)
+{
+    if (!_pOutScreen)
+        return false;
 
-    /* Check if the position is within screen bounds */
-    return (iDistortedX >= 0 && iDistortedX < SCREEN_W && vScreenBase.iY >= 0 && vScreenBase.iY < SCREEN_H);
+    return tilemap_world_to_screen_distorted_batch(&_vWorldPos, _pOutScreen, NULL, 1) == 1;
 }
 
 /* Wrap/normalize world X coordinate to canonical range [0, worldWidth * TILE_SIZE) */
@@ -14,12 +14,7 @@
 /* Tile IDs are uint8_t; keep lookup tables at 256 entries */
 #define TILEMAP_TILE_ID_COUNT 256
 
-/* Collision layer configuration */
-#define TILEMAP_LAYER_JNR_COLLISION 2     /* JNR collision layer index */
-#define TILEMAP_LAYER_SURFACE_WALKABLE 1  /* Surface walkable/ground layer index */
-#define TILEMAP_LAYER_SURFACE_COLLISION 2 /* Surface collision/blocking layer index */
-#define TILEMAP_LAYER_SURFACE_DECO_BG 3   /* Surface decoration background layer (player overdraws) */
-#define TILEMAP_LAYER_SURFACE_DECO_FG 4   /* Surface decoration foreground layer (overdraws player) */
+/* Collision layer indices (TILEMAP_LAYER_JNR_COLLISION, TILEMAP_LAYER_SURFACE_*) are defined in tilemap_importer.h */
 
 /* Include atlas constants */
 #include "tilemap_importer.h"
@@ -42,6 +37,9 @@ typedef struct
     uint16_t uMaxBuckets;
 
     int16_t aBucketIndexByPageId[TILE_ATLAS_MAX_PAGES]; /* Lookup: pageId -> bucket index */
+    uint16_t uVisibleCount;                             /* Tiles currently stored across all buckets */
+    bool bTruncated;                                    /* A capacity limit dropped tiles: next rect change rebuilds fully */
+    bool bFlat;                                         /* Holds composite tile IDs of the flattened layer (own atlas) */
 
     bool bLastRectValid;
     int16_t iLastLeft, iLastTop, iLastRight, iLastBottom;
@@ -76,6 +74,22 @@ void tilemap_debug(void);
  * Returns NULL if no tilemap is initialized. */
 const char *tilemap_get_loaded_folder(void);
 
+/* Staged load: build a map over several frames (e.g. during the landing animation) while the current one
+ * keeps running, then swap it in. tilemap_load_update runs load steps until _uBudgetUs is used up and
+ * returns true once the load has finished. tilemap_load_finish completes any remaining steps (blocking
+ * fallback) and replaces the current map, like tilemap_init. */
+bool tilemap_load_begin(const char *_pMapFolder, tilemap_type_t _eType);
+bool tilemap_load_update(uint32_t _uBudgetUs);
+float tilemap_load_progress(void); /* 0..1, 0 if no load is active */
+bool tilemap_load_is_pending(const char *_pMapFolder, tilemap_type_t _eType);
+bool tilemap_load_finish(void);
+void tilemap_load_cancel(void); /* Frees the staged map; call when the transition that started it is dropped */
+
+/* tilemap_free keeps recently used maps loaded (LRU within a RAM budget, larger with an Expansion Pak);
+ * tilemap_init of a resident map skips the load. */
+bool tilemap_is_resident(const char *_pMapFolder, tilemap_type_t _eType);
+bool tilemap_residency_flush(void); /* Release all resident maps; returns false if none were loaded */
+
 /* SURFACE rendering API (renders to intermediate surface with distortion) */
 void tilemap_render_surface_begin(void); /* Render layers 0-3 (before player) */
 void tilemap_render_surface_end(void);   /* Render layer 4 (after player) and composite with distortion */
@@ -140,6 +154,10 @@ tilemap_sweep_result_t tilemap_sweep_box(struct vec2 _vStartPos, struct vec2 _vD
  * Returns true if the position is within screen bounds, false otherwise. */
 bool tilemap_world_to_screen_distorted(struct vec2 _vWorldPos, struct vec2i *_pOutScreen);
 
+/* Batch version of tilemap_world_to_screen_distorted for many points (currency, player, ...).
+ * _pOutVisible may be NULL. Returns the number of points within screen bounds. */
+uint16_t tilemap_world_to_screen_distorted_batch(const struct vec2 *_pWorldPos, struct vec2i *_pOutScreen, bool *_pOutVisible, uint16_t _uCount);
+
 /* Wrap/normalize world X coordinate to canonical range [0, worldWidth * TILE_SIZE).
  * Returns the input unchanged when wrapping is disabled (JNR mode or tilemap not initialized).
  * This is used to keep entities within the wrapped world bounds. */
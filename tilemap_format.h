@@ -0,0 +1,126 @@
+#pragma once
+
+/* Binary tilemap format (.tmap) shared by tools/tmap_convert.c and tilemap_importer.c.
+ * Must stay free of libdragon includes so the host converter can use it.
+ *
+ * File layout (all values big-endian, i.e. native N64 byte order):
+ *   tilemap_format_header_t
+ *   uint16_t aTileIds[uTileCount]          original tile IDs, sorted ascending (index = runtime tile ID)
+ *   per layer payload (TILEMAP_FORMAT_ALIGN aligned):
+ *     DENSE:  uWidth * uHeight bytes, row-major
+ *     SPARSE: uSparseCapacity * 6-byte entries {u16 x, u16 y, u8 tileId, u8 pad}, hash table already built
+ *     SINGLE: no payload
+ *     CHUNKED: chunk table of ceil(w/16) * ceil(h/16) 4-byte records {u16 dataIndex, u8 tileId, u8 pad}
+ *              (dataIndex TILEMAP_FORMAT_CHUNK_UNIFORM = whole chunk is tileId, possibly empty),
+ *              then at the next TILEMAP_FORMAT_ALIGN boundary 256 bytes (16x16, row-major) per mixed chunk
+ *   atlas section (TILEMAP_FORMAT_ALIGN aligned, see tools/tmap_convert.c):
+ *     pages:   uAtlasPageCount RGBA16 pages of TILEMAP_FORMAT_ATLAS_PAGE_BYTES each (64x32, stride 128)
+ *     entries: uTileCount * 3-byte {u8 pageIndex, u8 u0, u8 v0}
+ *     rects:   uTileCount * 16-byte trimmed rects {s32 offX, s32 offY, s32 sizeX, s32 sizeY}
+ *
+ * The importer reads the whole file in one go and only patches pointers into the buffer. */
+
+#include <stdint.h>
+
+#define TILEMAP_FORMAT_MAGIC 0x544D4150u /* "TMAP" */
+#define TILEMAP_FORMAT_VERSION 3
+#define TILEMAP_FORMAT_MAX_LAYERS 5
+#define TILEMAP_FORMAT_ALIGN 8
+
+/* Baked atlas page size: 64x32 RGBA16 (keep in sync with TILE_ATLAS_PAGE_WIDTH/HEIGHT) */
+#define TILEMAP_FORMAT_ATLAS_PAGE_BYTES (64 * 32 * 2)
+
+/* Sparsity threshold: layers with fill ratio below this use sparse storage */
+#define TILEMAP_FORMAT_SPARSE_THRESHOLD 0.2f
+
+/* Minimum sparse hash table capacity */
+#define TILEMAP_FORMAT_SPARSE_MIN_CAPACITY 16
+
+/* Chunked layers: 16x16 tile chunks, uniform chunks collapse to their chunk record */
+#define TILEMAP_FORMAT_CHUNK_SHIFT 4
+#define TILEMAP_FORMAT_CHUNK_SIZE (1 << TILEMAP_FORMAT_CHUNK_SHIFT)
+#define TILEMAP_FORMAT_CHUNK_MASK (TILEMAP_FORMAT_CHUNK_SIZE - 1)
+#define TILEMAP_FORMAT_CHUNK_TILES (TILEMAP_FORMAT_CHUNK_SIZE * TILEMAP_FORMAT_CHUNK_SIZE)
+#define TILEMAP_FORMAT_CHUNK_RECORD_SIZE 4
+#define TILEMAP_FORMAT_CHUNK_UNIFORM 0xFFFFu
+
+/* Per-layer record (20 bytes) */
+typedef struct
+{
+    uint8_t uStorage;         /* tilemap_layer_storage_t */
+    uint8_t uSingleTileId;    /* SINGLE: repeated tile ID */
+    uint16_t uWidth;          /* Width in tiles */
+    uint16_t uHeight;         /* Height in tiles */
+    uint16_t uTileCount;      /* Non-empty tiles */
+    uint16_t uSparseCapacity; /* SPARSE: hash table capacity (power of 2) */
+    uint16_t uSparseCount;    /* SPARSE: entries in use */
+    uint32_t uDataOffset;     /* Payload offset from file start (0 if none) */
+    uint32_t uDataSize;       /* Payload size in bytes */
+} tilemap_format_layer_t;
+
+/* File header (132 bytes) */
+typedef struct
+{
+    uint32_t uMagic;
+    uint16_t uVersion;
+    uint16_t uTileCount;      /* Entries in the tile ID table */
+    uint8_t uLayerCount;      /* Layers stored in the file */
+    uint8_t aPadding[3];
+    uint32_t uTileIdsOffset;  /* Offset of the uint16_t tile ID table */
+    tilemap_format_layer_t aLayers[TILEMAP_FORMAT_MAX_LAYERS];
+
+    uint16_t uAtlasPageCount;     /* Baked atlas pages (0 = atlas built at runtime from tile sprites) */
+    uint16_t uReserved;
+    uint32_t uAtlasPagesOffset;   /* Offset of the raw RGBA16 page pixels */
+    uint32_t uAtlasEntriesOffset; /* Offset of the tileId -> atlas entry table */
+    uint32_t uTrimmedRectsOffset; /* Offset of the tileId -> trimmed rect table */
+} tilemap_format_header_t;
+
+_Static_assert(sizeof(tilemap_format_layer_t) == 20, "tilemap_format_layer_t layout changed");
+_Static_assert(sizeof(tilemap_format_header_t) == 132, "tilemap_format_header_t layout changed");
+
+/* Fast integer hash function for 2D coordinates (sparse layer hash tables) */
+static inline uint32_t tilemap_format_hash_coord(uint16_t _uX, uint16_t _uY)
+{
+    return ((uint32_t)_uX * 73856093u) ^ ((uint32_t)_uY * 19349663u);
+}
+
+/* Calculate next power of 2 >= n */
+static inline uint16_t tilemap_format_next_power_of_2(uint16_t _uN)
+{
+    if (_uN == 0)
+        return 1;
+    _uN--;
+    _uN |= _uN >> 1;
+    _uN |= _uN >> 2;
+    _uN |= _uN >> 4;
+    _uN |= _uN >> 8;
+    _uN++;
+    return _uN;
+}
+
+/* Chunk table size in bytes, padded so the chunk data that follows stays aligned */
+static inline uint32_t tilemap_format_chunk_table_size(uint16_t _uWidth, uint16_t _uHeight)
+{
+    uint32_t uChunksX = ((uint32_t)_uWidth + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT;
+    uint32_t uChunksY = ((uint32_t)_uHeight + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT;
+    uint32_t uSize = uChunksX * uChunksY * TILEMAP_FORMAT_CHUNK_RECORD_SIZE;
+    return (uSize + TILEMAP_FORMAT_ALIGN - 1) & ~(uint32_t)(TILEMAP_FORMAT_ALIGN - 1);
+}
+
+/* Dense layers switch to chunked storage when it saves at least a quarter of the dense size */
+static inline int tilemap_format_prefer_chunked(uint16_t _uWidth, uint16_t _uHeight, uint32_t _uMixedChunks)
+{
+    uint32_t uDenseSize = (uint32_t)_uWidth * (uint32_t)_uHeight;
+    uint32_t uChunkedSize = tilemap_format_chunk_table_size(_uWidth, _uHeight) + _uMixedChunks * TILEMAP_FORMAT_CHUNK_TILES;
+    return uChunkedSize * 4u <= uDenseSize * 3u;
+}
+
+/* Sparse hash table capacity for a given tile count (load factor ~0.67) */
+static inline uint16_t tilemap_format_sparse_capacity(uint16_t _uTileCount)
+{
+    uint16_t uCapacity = tilemap_format_next_power_of_2((uint16_t)((_uTileCount * 3) / 2));
+    if (uCapacity < TILEMAP_FORMAT_SPARSE_MIN_CAPACITY)
+        uCapacity = TILEMAP_FORMAT_SPARSE_MIN_CAPACITY;
+    return uCapacity;
+}
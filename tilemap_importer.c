@@ -4,13 +4,23 @@
 #include "n64sys.h"
 #include "resource_helper.h"
 #include "sprite_tools.h"
+#include "tilemap_format.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-/* Sparsity threshold: layers with fill ratio below this use sparse storage */
-#define TILEMAP_SPARSE_THRESHOLD 0.2f
+/* .tmap sparse entries are serialized as {u16 x, u16 y, u8 tileId, u8 pad} */
+_Static_assert(sizeof(sparse_tile_entry_t) == 6, "sparse_tile_entry_t must match the .tmap entry layout");
+
+/* .tmap atlas tables are serialized as {u8 page, u8 u0, u8 v0} and {s32 offX, s32 offY, s32 sizeX, s32 sizeY} */
+_Static_assert(sizeof(tile_atlas_entry_t) == 3, "tile_atlas_entry_t must match the .tmap atlas entry layout");
+_Static_assert(sizeof(tile_trimmed_rect_t) == 16, "tile_trimmed_rect_t must match the .tmap trimmed rect layout");
+_Static_assert(TILEMAP_FORMAT_ATLAS_PAGE_BYTES == TILE_ATLAS_PAGE_WIDTH * TILE_ATLAS_PAGE_HEIGHT * 2, "baked atlas page size mismatch");
+
+/* .tmap chunk records are serialized as {u16 dataIndex, u8 tileId, u8 pad} */
+_Static_assert(sizeof(tilemap_chunk_t) == TILEMAP_FORMAT_CHUNK_RECORD_SIZE, "tilemap_chunk_t must match the .tmap chunk record layout");
+_Static_assert(TILEMAP_CHUNK_SHIFT == TILEMAP_FORMAT_CHUNK_SHIFT && TILEMAP_CHUNK_UNIFORM == TILEMAP_FORMAT_CHUNK_UNIFORM, "chunk geometry mismatch");
 
 static int cmp_int_asc(const void *_pA, const void *_pB)
 {
@@ -21,27 +31,6 @@ static int cmp_int_asc(const void *_pA, const void *_pB)
 
 /* ---------- Sparse layer hash table functions ---------- */
 
-/* Fast integer hash function for 2D coordinates */
-static inline uint32_t hash_coord(uint16_t _uX, uint16_t _uY)
-{
-    uint32_t h = ((uint32_t)_uX * 73856093u) ^ ((uint32_t)_uY * 19349663u);
-    return h;
-}
-
-/* Calculate next power of 2 >= n */
-static inline uint16_t next_power_of_2(uint16_t _uN)
-{
-    if (_uN == 0)
-        return 1;
-    _uN--;
-    _uN |= _uN >> 1;
-    _uN |= _uN >> 2;
-    _uN |= _uN >> 4;
-    _uN |= _uN >> 8;
-    _uN++;
-    return _uN;
-}
-
 /* Initialize sparse layer hash table with given capacity */
 static bool sparse_layer_init(sparse_layer_data_t *_pSparse, uint16_t _uTileCount)
 {
@@ -58,9 +47,7 @@ static bool sparse_layer_init(sparse_layer_data_t *_pSparse, uint16_t _uTileCoun
     }
 
     /* Calculate capacity: next power of 2 above tile_count * 1.5 (load factor ~0.67) */
-    uint16_t uCapacity = next_power_of_2((_uTileCount * 3) / 2);
-    if (uCapacity < 16)
-        uCapacity = 16; /* Minimum capacity */
+    uint16_t uCapacity = tilemap_format_sparse_capacity(_uTileCount);
 
     _pSparse->pEntries = (sparse_tile_entry_t *)malloc(sizeof(sparse_tile_entry_t) * uCapacity);
     if (!_pSparse->pEntries)
@@ -93,7 +80,7 @@ static bool sparse_layer_insert(sparse_layer_data_t *_pSparse, uint16_t _uX, uin
     if (!_pSparse || !_pSparse->pEntries || _pSparse->uCount >= _pSparse->uCapacity)
         return false;
 
-    uint32_t uHash = hash_coord(_uX, _uY);
+    uint32_t uHash = tilemap_format_hash_coord(_uX, _uY);
     uint16_t uIndex = (uint16_t)(uHash & (uint32_t)(_pSparse->uCapacity - 1));
 
     /* Linear probing to find empty slot */
@@ -126,14 +113,14 @@ static bool sparse_layer_insert(sparse_layer_data_t *_pSparse, uint16_t _uX, uin
     return false;
 }
 
-/* Lookup tile in sparse layer hash table - used by inline accessor in header */
-uint8_t tilemap_layer_sparse_get(const sparse_layer_data_t *_pSparse, uint16_t _uX, uint16_t _uY)
+/* Lookup tile in sparse layer hash table (used before the row index exists) */
+static uint8_t sparse_layer_hash_get(const sparse_layer_data_t *_pSparse, uint16_t _uX, uint16_t _uY)
 {
     /* Empty layer fast path (0 tiles) */
     if (!_pSparse || !_pSparse->pEntries || _pSparse->uCapacity == 0)
         return TILEMAP_IMPORTER_EMPTY_TILE;
 
-    uint32_t uHash = hash_coord(_uX, _uY);
+    uint32_t uHash = tilemap_format_hash_coord(_uX, _uY);
     uint16_t uIndex = (uint16_t)(uHash & (uint32_t)(_pSparse->uCapacity - 1));
 
     /* Linear probing to find entry */
@@ -160,6 +147,169 @@ uint8_t tilemap_layer_sparse_get(const sparse_layer_data_t *_pSparse, uint16_t _
     return TILEMAP_IMPORTER_EMPTY_TILE;
 }
 
+/* Build the CSR row index from the hash table: counting sort by row, then insertion sort by X per row
+ * (rows hold few tiles in sparse layers). */
+static bool sparse_layer_build_row_index(sparse_layer_data_t *_pSparse, uint16_t _uHeight)
+{
+    if (!_pSparse || _uHeight == 0)
+        return false;
+
+    const uint16_t uCount = _pSparse->uCount;
+    const size_t uStartBytes = sizeof(uint16_t) * ((size_t)_uHeight + 1);
+    const size_t uColumnBytes = sizeof(uint16_t) * uCount;
+
+    uint8_t *pBuffer = (uint8_t *)malloc(uStartBytes + uColumnBytes + uCount);
+    if (!pBuffer)
+    {
+        debugf("Failed to allocate sparse row index (%u rows, %u tiles)\n", (unsigned)_uHeight, (unsigned)uCount);
+        return false;
+    }
+
+    uint16_t *pRowStart = (uint16_t *)pBuffer;
+    uint16_t *pColumns = (uint16_t *)(pBuffer + uStartBytes);
+    uint8_t *pTileIds = pBuffer + uStartBytes + uColumnBytes;
+
+    memset(pRowStart, 0, uStartBytes);
+
+    /* Count tiles per row */
+    uint16_t uFound = 0;
+    for (uint16_t i = 0; i < _pSparse->uCapacity; ++i)
+    {
+        const sparse_tile_entry_t *pEntry = &_pSparse->pEntries[i];
+        if (pEntry->uX == SPARSE_ENTRY_EMPTY)
+            continue;
+
+        if (pEntry->uY >= _uHeight || uFound >= uCount)
+        {
+            debugf("Sparse layer entry out of range (y=%u, height=%u)\n", (unsigned)pEntry->uY, (unsigned)_uHeight);
+            free(pBuffer);
+            return false;
+        }
+
+        pRowStart[pEntry->uY + 1]++;
+        uFound++;
+    }
+
+    if (uFound != uCount)
+    {
+        debugf("Sparse layer count mismatch: %u entries, expected %u\n", (unsigned)uFound, (unsigned)uCount);
+        free(pBuffer);
+        return false;
+    }
+
+    /* Prefix sum: pRowStart[y] = first tile of row y */
+    for (uint16_t y = 0; y < _uHeight; ++y)
+        pRowStart[y + 1] = (uint16_t)(pRowStart[y + 1] + pRowStart[y]);
+
+    /* Scatter using pRowStart[y] as write cursor (advances it to the start of row y + 1) */
+    for (uint16_t i = 0; i < _pSparse->uCapacity; ++i)
+    {
+        const sparse_tile_entry_t *pEntry = &_pSparse->pEntries[i];
+        if (pEntry->uX == SPARSE_ENTRY_EMPTY)
+            continue;
+
+        uint16_t uDst = pRowStart[pEntry->uY]++;
+        pColumns[uDst] = pEntry->uX;
+        pTileIds[uDst] = pEntry->uTileId;
+    }
+
+    /* Restore row starts */
+    for (uint16_t y = _uHeight; y > 0; --y)
+        pRowStart[y] = pRowStart[y - 1];
+    pRowStart[0] = 0;
+
+    /* Sort each row by X */
+    for (uint16_t y = 0; y < _uHeight; ++y)
+    {
+        for (uint16_t i = (uint16_t)(pRowStart[y] + 1); i < pRowStart[y + 1]; ++i)
+        {
+            uint16_t uX = pColumns[i];
+            uint8_t uTileId = pTileIds[i];
+            uint16_t j = i;
+            while (j > pRowStart[y] && pColumns[j - 1] > uX)
+            {
+                pColumns[j] = pColumns[j - 1];
+                pTileIds[j] = pTileIds[j - 1];
+                --j;
+            }
+            pColumns[j] = uX;
+            pTileIds[j] = uTileId;
+        }
+    }
+
+    CACHE_FLUSH_DATA(pBuffer, uStartBytes + uColumnBytes + uCount);
+
+    _pSparse->pRowStart = pRowStart;
+    _pSparse->pRowColumns = pColumns;
+    _pSparse->pRowTileIds = pTileIds;
+    _pSparse->uRowCount = _uHeight;
+    return true;
+}
+
+static void sparse_layer_free_row_index(sparse_layer_data_t *_pSparse)
+{
+    if (_pSparse->pRowStart)
+    {
+        free(_pSparse->pRowStart);
+        _pSparse->pRowStart = NULL;
+    }
+
+    _pSparse->pRowColumns = NULL;
+    _pSparse->pRowTileIds = NULL;
+    _pSparse->uRowCount = 0;
+}
+
+/* First index in [_uBegin, _uEnd) whose column is >= _uX */
+static inline uint16_t sparse_row_lower_bound(const uint16_t *_pColumns, uint16_t _uBegin, uint16_t _uEnd, uint16_t _uX)
+{
+    while (_uBegin < _uEnd)
+    {
+        uint16_t uMid = (uint16_t)(_uBegin + ((_uEnd - _uBegin) >> 1));
+        if (_pColumns[uMid] < _uX)
+            _uBegin = (uint16_t)(uMid + 1);
+        else
+            _uEnd = uMid;
+    }
+    return _uBegin;
+}
+
+void tilemap_layer_sparse_row_span(const sparse_layer_data_t *_pSparse, uint16_t _uY, uint16_t _uX0, uint16_t _uX1, uint16_t *_pOutBegin, uint16_t *_pOutEnd)
+{
+    *_pOutBegin = 0;
+    *_pOutEnd = 0;
+
+    if (!_pSparse || !_pSparse->pRowStart || _uY >= _pSparse->uRowCount || _uX0 > _uX1)
+        return;
+
+    uint16_t uRowBegin = _pSparse->pRowStart[_uY];
+    uint16_t uRowEnd = _pSparse->pRowStart[_uY + 1];
+
+    uint16_t uBegin = sparse_row_lower_bound(_pSparse->pRowColumns, uRowBegin, uRowEnd, _uX0);
+    uint16_t uEnd = uBegin;
+    while (uEnd < uRowEnd && _pSparse->pRowColumns[uEnd] <= _uX1)
+        uEnd++;
+
+    *_pOutBegin = uBegin;
+    *_pOutEnd = uEnd;
+}
+
+/* Lookup tile in sparse layer - used by inline accessor in header */
+uint8_t tilemap_layer_sparse_get(const sparse_layer_data_t *_pSparse, uint16_t _uX, uint16_t _uY)
+{
+    if (!_pSparse || !_pSparse->pRowStart)
+        return sparse_layer_hash_get(_pSparse, _uX, _uY);
+
+    if (_uY >= _pSparse->uRowCount)
+        return TILEMAP_IMPORTER_EMPTY_TILE;
+
+    uint16_t uRowEnd = _pSparse->pRowStart[_uY + 1];
+    uint16_t uIndex = sparse_row_lower_bound(_pSparse->pRowColumns, _pSparse->pRowStart[_uY], uRowEnd, _uX);
+    if (uIndex < uRowEnd && _pSparse->pRowColumns[uIndex] == _uX)
+        return _pSparse->pRowTileIds[uIndex];
+
+    return TILEMAP_IMPORTER_EMPTY_TILE;
+}
+
 /* Free sparse layer hash table */
 static void sparse_layer_free(sparse_layer_data_t *_pSparse)
 {
@@ -174,6 +324,140 @@ static void sparse_layer_free(sparse_layer_data_t *_pSparse)
 
     _pSparse->uCapacity = 0;
     _pSparse->uCount = 0;
+
+    sparse_layer_free_row_index(_pSparse);
+}
+
+/* ---------- Chunked layer functions ---------- */
+
+/* Returns true if all in-bounds tiles of chunk (_uChunkX, _uChunkY) share one ID (written to *_pOutTileId).
+ * Padding past the layer edge is never read at runtime, so it does not break uniformity. */
+static bool chunk_is_uniform(uint8_t *const *_ppRows, uint16_t _uWidth, uint16_t _uHeight, uint16_t _uChunkX, uint16_t _uChunkY, uint8_t *_pOutTileId)
+{
+    uint32_t uX0 = (uint32_t)_uChunkX << TILEMAP_CHUNK_SHIFT;
+    uint32_t uY0 = (uint32_t)_uChunkY << TILEMAP_CHUNK_SHIFT;
+    uint32_t uX1 = uX0 + TILEMAP_CHUNK_SIZE < _uWidth ? uX0 + TILEMAP_CHUNK_SIZE : _uWidth;
+    uint32_t uY1 = uY0 + TILEMAP_CHUNK_SIZE < _uHeight ? uY0 + TILEMAP_CHUNK_SIZE : _uHeight;
+    uint8_t uRefTileId = _ppRows[uY0][uX0];
+
+    for (uint32_t y = uY0; y < uY1; ++y)
+    {
+        for (uint32_t x = uX0; x < uX1; ++x)
+        {
+            if (_ppRows[y][x] != uRefTileId)
+                return false;
+        }
+    }
+
+    *_pOutTileId = uRefTileId;
+    return true;
+}
+
+/* Convert dense rows into chunked storage if that saves enough memory (see tilemap_format_prefer_chunked).
+ * Returns false (layer untouched) if chunking does not pay off or allocation fails. */
+static bool chunked_layer_build(tilemap_layer_t *_pLayer, uint8_t *const *_ppRows)
+{
+    const uint16_t uChunksX = (uint16_t)((_pLayer->uWidth + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT);
+    const uint16_t uChunksY = (uint16_t)((_pLayer->uHeight + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT);
+
+    uint32_t uMixedCount = 0;
+    uint8_t uTileId;
+    for (uint16_t cy = 0; cy < uChunksY; ++cy)
+    {
+        for (uint16_t cx = 0; cx < uChunksX; ++cx)
+        {
+            if (!chunk_is_uniform(_ppRows, _pLayer->uWidth, _pLayer->uHeight, cx, cy, &uTileId))
+                uMixedCount++;
+        }
+    }
+
+    if (uMixedCount >= TILEMAP_CHUNK_UNIFORM || !tilemap_format_prefer_chunked(_pLayer->uWidth, _pLayer->uHeight, uMixedCount))
+        return false;
+
+    /* Single allocation: chunk table, then the mixed chunk tiles (owned by pChunks) */
+    const size_t uTableSize = tilemap_format_chunk_table_size(_pLayer->uWidth, _pLayer->uHeight);
+    const size_t uDataSize = (size_t)uMixedCount * TILEMAP_CHUNK_TILES;
+    uint8_t *pBuffer = (uint8_t *)malloc(uTableSize + uDataSize);
+    if (!pBuffer)
+        return false;
+
+    tilemap_chunk_t *pChunks = (tilemap_chunk_t *)pBuffer;
+    uint8_t *pChunkData = pBuffer + uTableSize;
+    memset(pChunkData, TILEMAP_IMPORTER_EMPTY_TILE, uDataSize);
+
+    uint16_t uDataIndex = 0;
+    for (uint16_t cy = 0; cy < uChunksY; ++cy)
+    {
+        for (uint16_t cx = 0; cx < uChunksX; ++cx)
+        {
+            tilemap_chunk_t *pChunk = &pChunks[(uint32_t)cy * uChunksX + cx];
+            pChunk->uPadding = 0;
+
+            if (chunk_is_uniform(_ppRows, _pLayer->uWidth, _pLayer->uHeight, cx, cy, &uTileId))
+            {
+                pChunk->uDataIndex = TILEMAP_CHUNK_UNIFORM;
+                pChunk->uTileId = uTileId;
+                continue;
+            }
+
+            pChunk->uDataIndex = uDataIndex;
+            pChunk->uTileId = TILEMAP_IMPORTER_EMPTY_TILE;
+
+            uint8_t *pDst = &pChunkData[(size_t)uDataIndex * TILEMAP_CHUNK_TILES];
+            uint32_t uX0 = (uint32_t)cx << TILEMAP_CHUNK_SHIFT;
+            uint32_t uY0 = (uint32_t)cy << TILEMAP_CHUNK_SHIFT;
+            for (uint32_t y = 0; y < TILEMAP_CHUNK_SIZE && uY0 + y < _pLayer->uHeight; ++y)
+            {
+                for (uint32_t x = 0; x < TILEMAP_CHUNK_SIZE && uX0 + x < _pLayer->uWidth; ++x)
+                    pDst[(y << TILEMAP_CHUNK_SHIFT) + x] = _ppRows[uY0 + y][uX0 + x];
+            }
+            uDataIndex++;
+        }
+    }
+
+    CACHE_FLUSH_DATA(pBuffer, uTableSize + uDataSize);
+
+    _pLayer->eStorage = TILEMAP_LAYER_STORAGE_CHUNKED;
+    _pLayer->pChunks = pChunks;
+    _pLayer->pChunkData = pChunkData;
+    _pLayer->uChunksX = uChunksX;
+    _pLayer->uChunksY = uChunksY;
+    _pLayer->uMixedChunkCount = (uint16_t)uMixedCount;
+    return true;
+}
+
+/* Chunk records must only reference existing mixed chunks (checked once for .tmap data) */
+static bool chunked_layer_is_valid(const tilemap_layer_t *_pLayer)
+{
+    const uint32_t uChunkCount = (uint32_t)_pLayer->uChunksX * (uint32_t)_pLayer->uChunksY;
+    for (uint32_t i = 0; i < uChunkCount; ++i)
+    {
+        uint16_t uDataIndex = _pLayer->pChunks[i].uDataIndex;
+        if (uDataIndex != TILEMAP_CHUNK_UNIFORM && uDataIndex >= _pLayer->uMixedChunkCount)
+            return false;
+    }
+    return true;
+}
+
+bool tilemap_layer_region_is_empty(const tilemap_layer_t *_pLayer, int _iX0, int _iY0, int _iX1, int _iY1)
+{
+    if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
+        return _pLayer->uSingleTileId == TILEMAP_IMPORTER_EMPTY_TILE;
+
+    if (_pLayer->eStorage != TILEMAP_LAYER_STORAGE_CHUNKED)
+        return _pLayer->uTileCount == 0;
+
+    for (int cy = _iY0 >> TILEMAP_CHUNK_SHIFT; cy <= (_iY1 >> TILEMAP_CHUNK_SHIFT); ++cy)
+    {
+        const tilemap_chunk_t *pChunk = &_pLayer->pChunks[cy * _pLayer->uChunksX];
+        for (int cx = _iX0 >> TILEMAP_CHUNK_SHIFT; cx <= (_iX1 >> TILEMAP_CHUNK_SHIFT); ++cx)
+        {
+            if (pChunk[cx].uDataIndex != TILEMAP_CHUNK_UNIFORM || pChunk[cx].uTileId != TILEMAP_IMPORTER_EMPTY_TILE)
+                return false;
+        }
+    }
+
+    return true;
 }
 
 static void free_layer(tilemap_layer_t *_pLayer)
@@ -186,7 +470,9 @@ static void free_layer(tilemap_layer_t *_pLayer)
     {
         if (_pLayer->pData)
         {
-            free(_pLayer->pData);
+            /* Blob-backed data is released together with the importer's .tmap buffer */
+            if (!_pLayer->bBlobData)
+                free(_pLayer->pData);
             _pLayer->pData = NULL;
         }
         if (_pLayer->ppData)
@@ -197,13 +483,35 @@ static void free_layer(tilemap_layer_t *_pLayer)
     }
     else if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
     {
-        sparse_layer_free(&_pLayer->sparse);
+        if (_pLayer->bBlobData)
+        {
+            _pLayer->sparse.pEntries = NULL;
+            _pLayer->sparse.uCapacity = 0;
+            _pLayer->sparse.uCount = 0;
+            sparse_layer_free_row_index(&_pLayer->sparse);
+        }
+        else
+        {
+            sparse_layer_free(&_pLayer->sparse);
+        }
+    }
+    else if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+    {
+        /* pChunkData shares the chunk table allocation */
+        if (!_pLayer->bBlobData)
+            free(_pLayer->pChunks);
+        _pLayer->pChunks = NULL;
+        _pLayer->pChunkData = NULL;
+        _pLayer->uChunksX = 0;
+        _pLayer->uChunksY = 0;
+        _pLayer->uMixedChunkCount = 0;
     }
     /* TILEMAP_LAYER_STORAGE_SINGLE requires no freeing */
 
     _pLayer->uWidth = 0;
     _pLayer->uHeight = 0;
     _pLayer->uTileCount = 0;
+    _pLayer->bBlobData = false;
 }
 
 /* ---------- tile_ids.csv ---------- */
@@ -285,41 +593,27 @@ static bool load_tile_ids_sorted(const char *_pMapFolder, int **_ppTileIds, uint
 
 /* ---------- Sprite loading ---------- */
 
-static bool load_tile_sprites(const char *_pMapFolder, const int *_pTileIds, uint16_t _uTileCount, sprite_t ***_pppSprites)
+/* Load tile sprites [_uFirst, _uEnd) into _ppSprites. On failure the sprites loaded so far stay in
+ * _ppSprites (released with the importer). */
+static bool load_tile_sprites(const char *_pMapFolder, const int *_pTileIds, uint16_t _uFirst, uint16_t _uEnd, sprite_t **_ppSprites)
 {
-    if (!_pMapFolder || !_pTileIds || !_pppSprites)
-        return false;
-
-    *_pppSprites = NULL;
-
-    sprite_t **ppSprites = (sprite_t **)malloc(sizeof(sprite_t *) * _uTileCount);
-    if (!ppSprites)
-    {
-        debugf("Failed to allocate memory for sprite pointers\n");
+    if (!_pMapFolder || !_pTileIds || !_ppSprites)
         return false;
-    }
-    memset(ppSprites, 0, sizeof(sprite_t *) * _uTileCount);
 
     char szPath[256];
 
-    for (uint16_t i = 0; i < _uTileCount; ++i)
+    for (uint16_t i = _uFirst; i < _uEnd; ++i)
     {
         snprintf(szPath, sizeof(szPath), "rom:/%s/%d.sprite", _pMapFolder, _pTileIds[i]);
-        ppSprites[i] = sprite_load(szPath);
+        _ppSprites[i] = sprite_load(szPath);
 
-        if (!ppSprites[i])
+        if (!_ppSprites[i])
         {
             debugf("Failed to load sprite for tile ID %d at %s\n", _pTileIds[i], szPath);
-            for (uint16_t j = 0; j < _uTileCount; ++j)
-            {
-                SAFE_FREE_SPRITE(ppSprites[j]);
-            }
-            free(ppSprites);
             return false;
         }
     }
 
-    *_pppSprites = ppSprites;
     return true;
 }
 
@@ -560,7 +854,7 @@ static bool load_csv_layer(const char *_pMapFolder, uint8_t _uLayerIndex, tilema
         uSingleTileId = uRefTileId;
     }
 
-    bool bUseSparse = (fFillRatio < TILEMAP_SPARSE_THRESHOLD);
+    bool bUseSparse = (fFillRatio < TILEMAP_FORMAT_SPARSE_THRESHOLD);
 
     /* Set layer dimensions */
     _pOutLayer->uWidth = uWidth;
@@ -620,6 +914,12 @@ static bool load_csv_layer(const char *_pMapFolder, uint8_t _uLayerIndex, tilema
         free(pData);
         free(ppRows);
     }
+    else if (chunked_layer_build(_pOutLayer, ppRows))
+    {
+        /* Chunked storage copied what it needs; free temporary dense storage */
+        free(pData);
+        free(ppRows);
+    }
     else
     {
         /* Use dense storage (keep the allocated arrays) */
@@ -643,95 +943,364 @@ static bool load_csv_layer(const char *_pMapFolder, uint8_t _uLayerIndex, tilema
     return true;
 }
 
-/* ---------- Atlas building helpers ---------- */
+/* ---------- Binary tilemap (.tmap) ---------- */
 
-/* Validate tile index (returns false if invalid) */
-static inline bool validate_tile_index(const tilemap_importer_t *_pImporter, uint8_t _uTileIndex)
+/* Validate a .tmap layer record against the file size and the expected dimensions */
+static bool tmap_layer_record_is_valid(const tilemap_format_layer_t *_pRecord, size_t _uFileSize, const tilemap_format_layer_t *_pRef)
 {
-    if (!_pImporter || !_pImporter->bInitialized)
+    if (_pRecord->uWidth == 0 || _pRecord->uHeight == 0)
         return false;
-    if (_uTileIndex == TILEMAP_IMPORTER_EMPTY_TILE)
+
+    if (_pRecord->uWidth != _pRef->uWidth || _pRecord->uHeight != _pRef->uHeight)
         return false;
-    if (_uTileIndex >= _pImporter->uTileCount)
+
+    if ((size_t)_pRecord->uDataOffset + (size_t)_pRecord->uDataSize > _uFileSize)
         return false;
-    return true;
-}
 
-/* Tile frequency entry for sorting */
-typedef struct
-{
-    uint8_t uTileId;
-    uint32_t uFrequency;
-} tile_frequency_t;
+    if (_pRecord->uDataOffset % TILEMAP_FORMAT_ALIGN != 0)
+        return false;
 
-static int cmp_frequency_desc(const void *_pA, const void *_pB)
-{
-    const tile_frequency_t *pA = (const tile_frequency_t *)_pA;
-    const tile_frequency_t *pB = (const tile_frequency_t *)_pB;
-    if (pB->uFrequency > pA->uFrequency)
-        return 1;
-    if (pB->uFrequency < pA->uFrequency)
-        return -1;
-    return 0;
+    switch (_pRecord->uStorage)
+    {
+    case TILEMAP_LAYER_STORAGE_DENSE:
+        return _pRecord->uDataSize == (uint32_t)_pRecord->uWidth * (uint32_t)_pRecord->uHeight;
+    case TILEMAP_LAYER_STORAGE_SPARSE:
+        if (_pRecord->uSparseCapacity == 0 || (_pRecord->uSparseCapacity & (_pRecord->uSparseCapacity - 1)) != 0)
+            return false;
+        return _pRecord->uDataSize == (uint32_t)_pRecord->uSparseCapacity * sizeof(sparse_tile_entry_t);
+    case TILEMAP_LAYER_STORAGE_SINGLE:
+        return true;
+    case TILEMAP_LAYER_STORAGE_CHUNKED:
+    {
+        uint32_t uTableSize = tilemap_format_chunk_table_size(_pRecord->uWidth, _pRecord->uHeight);
+        return _pRecord->uDataSize >= uTableSize && (_pRecord->uDataSize - uTableSize) % TILEMAP_FORMAT_CHUNK_TILES == 0 &&
+               (_pRecord->uDataSize - uTableSize) / TILEMAP_FORMAT_CHUNK_TILES < TILEMAP_FORMAT_CHUNK_UNIFORM;
+    }
+    default:
+        return false;
+    }
 }
 
-/* Build frequency histogram by scanning all layers */
-static bool build_tile_frequency_histogram(const tilemap_importer_t *_pImporter, tile_frequency_t *_pFreq, uint16_t _uTileCount)
+/* Point atlas pages into the .tmap buffer and copy the small per-tile lookup tables.
+ * Leaves the importer untouched on failure. */
+static bool load_tmap_atlas(tilemap_importer_t *_pImporter, uint8_t *_pBlob, size_t _uFileSize)
 {
-    if (!_pImporter || !_pFreq)
+    const tilemap_format_header_t *pHeader = (const tilemap_format_header_t *)_pBlob;
+    const uint16_t uPageCount = pHeader->uAtlasPageCount;
+    const uint16_t uTileCount = pHeader->uTileCount;
+    const size_t uEntriesSize = sizeof(tile_atlas_entry_t) * uTileCount;
+    const size_t uRectsSize = sizeof(tile_trimmed_rect_t) * uTileCount;
+
+    if (uPageCount > TILE_ATLAS_MAX_PAGES || pHeader->uAtlasPagesOffset % TILEMAP_FORMAT_ALIGN != 0 ||
+        (size_t)pHeader->uAtlasPagesOffset + (size_t)uPageCount * TILEMAP_FORMAT_ATLAS_PAGE_BYTES > _uFileSize ||
+        (size_t)pHeader->uAtlasEntriesOffset + uEntriesSize > _uFileSize || (size_t)pHeader->uTrimmedRectsOffset + uRectsSize > _uFileSize ||
+        pHeader->uTrimmedRectsOffset % sizeof(int32_t) != 0)
         return false;
 
-    /* Initialize frequency array */
-    for (uint16_t i = 0; i < _uTileCount; ++i)
+    surface_t *pPages = (surface_t *)malloc(sizeof(surface_t) * uPageCount);
+    tile_atlas_entry_t *pEntries = (tile_atlas_entry_t *)malloc(uEntriesSize);
+    tile_trimmed_rect_t *pTrimmedRects = (tile_trimmed_rect_t *)malloc(uRectsSize);
+    if (!pPages || !pEntries || !pTrimmedRects)
     {
-        _pFreq[i].uTileId = (uint8_t)i;
-        _pFreq[i].uFrequency = 0;
+        debugf("Failed to allocate .tmap atlas tables\n");
+        free(pPages);
+        free(pEntries);
+        free(pTrimmedRects);
+        return false;
     }
 
-    /* Scan all layers */
-    for (uint8_t uLayer = 0; uLayer < TILEMAP_IMPORTER_MAX_LAYERS; ++uLayer)
+    /* Pages are not owned by the surfaces (surface_free leaves the buffer alone) */
+    for (uint16_t i = 0; i < uPageCount; ++i)
     {
-        const tilemap_layer_t *pLayer = &_pImporter->aLayers[uLayer];
-        if (!pLayer->ppData || pLayer->uWidth == 0 || pLayer->uHeight == 0)
-            continue;
-
-        for (uint16_t y = 0; y < pLayer->uHeight; ++y)
-        {
-            const uint8_t *pRow = pLayer->ppData[y];
-            for (uint16_t x = 0; x < pLayer->uWidth; ++x)
-            {
-                uint8_t uTileId = pRow[x];
-                if (uTileId != TILEMAP_IMPORTER_EMPTY_TILE && uTileId < _uTileCount)
-                {
-                    _pFreq[uTileId].uFrequency++;
-                }
-            }
-        }
+        void *pPixels = _pBlob + pHeader->uAtlasPagesOffset + (size_t)i * TILEMAP_FORMAT_ATLAS_PAGE_BYTES;
+        pPages[i] = surface_make(pPixels, FMT_RGBA16, TILE_ATLAS_PAGE_WIDTH, TILE_ATLAS_PAGE_HEIGHT, TILE_ATLAS_PAGE_WIDTH * 2);
     }
 
+    memcpy(pEntries, _pBlob + pHeader->uAtlasEntriesOffset, uEntriesSize);
+    memcpy(pTrimmedRects, _pBlob + pHeader->uTrimmedRectsOffset, uRectsSize);
+
+    CACHE_FLUSH_DATA(pEntries, uEntriesSize);
+    CACHE_FLUSH_DATA(pTrimmedRects, uRectsSize);
+
+    _pImporter->pAtlasPages = pPages;
+    _pImporter->uAtlasPageCount = uPageCount;
+    _pImporter->pAtlasEntries = pEntries;
+    _pImporter->pTileTrimmedRects = pTrimmedRects;
     return true;
 }
 
-/* Convert a sprite pixel to RGBA16 format */
-static uint16_t convert_pixel_to_rgba16(const surface_t *_pSrcSurface, tex_format_t _eFormat, const uint16_t *_pPalette, uint16_t _x, uint16_t _y)
+/* Opens rom:/<folder>/<folder>.tmap and allocates a buffer for the whole file (read by the caller, in slices).
+ * Returns NULL if the file is missing or too small (CSV fallback). */
+static uint8_t *load_tmap_open(const char *_pMapFolder, FILE **_ppFile, size_t *_pFileSize)
 {
-    const uint8_t *pRow = (const uint8_t *)_pSrcSurface->buffer + (_y * _pSrcSurface->stride);
+    char szPath[256];
+    snprintf(szPath, sizeof(szPath), "rom:/%s/%s.tmap", _pMapFolder, _pMapFolder);
 
-    if (_eFormat == FMT_RGBA16)
+    FILE *pFile = fopen(szPath, "rb");
+    if (!pFile)
+        return NULL;
+
+    fseek(pFile, 0, SEEK_END);
+    long iSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    if (iSize < (long)sizeof(tilemap_format_header_t))
     {
-        /* Read pixel directly - assume libdragon surfaces are already in correct format */
-        const uint16_t *pPixel = (const uint16_t *)(pRow + (_x * 2));
-        return *pPixel;
+        debugf("Invalid .tmap file (too small): %s\n", szPath);
+        fclose(pFile);
+        return NULL;
     }
-    else if (_eFormat == FMT_RGBA32)
+
+    uint8_t *pBlob = (uint8_t *)malloc((size_t)iSize);
+    if (!pBlob)
     {
-        const uint32_t *pPixel = (const uint32_t *)(pRow + (_x * 4));
-        uint32_t uRGBA32 = *pPixel;
-        /* Convert RGBA32 (8888) to RGBA16 (5551)
-         * On little-endian systems, when reading uint32_t from [R,G,B,A] in memory:
-         * uRGBA32 = R | (G << 8) | (B << 16) | (A << 24)
-         * So: r = bits 0-7, g = bits 8-15, b = bits 16-23, a = bits 24-31 */
-        uint8_t r = (uint8_t)(uRGBA32 & 0xFF);
+        debugf("Failed to allocate %ld bytes for %s\n", iSize, szPath);
+        fclose(pFile);
+        return NULL;
+    }
+
+    *_ppFile = pFile;
+    *_pFileSize = (size_t)iSize;
+    return pBlob;
+}
+
+/* Validates a fully read .tmap buffer and points the layers into it. Takes ownership of _pBlob (freed on failure).
+ * Returns false without touching the importer if the file is invalid (CSV fallback). */
+static bool load_tmap_parse(tilemap_importer_t *_pImporter, uint8_t *_pBlob, size_t _uFileSize, const char *_pMapFolder, uint8_t _uLayerCount, int **_ppTileIds, uint16_t *_pTileCount)
+{
+    char szPath[256];
+    snprintf(szPath, sizeof(szPath), "rom:/%s/%s.tmap", _pMapFolder, _pMapFolder);
+
+    uint8_t *pBlob = _pBlob;
+    const size_t uFileSize = _uFileSize;
+    const tilemap_format_header_t *pHeader = (const tilemap_format_header_t *)pBlob;
+
+    if (pHeader->uMagic != TILEMAP_FORMAT_MAGIC || pHeader->uVersion != TILEMAP_FORMAT_VERSION)
+    {
+        debugf("Invalid .tmap header in %s (rebuild assets)\n", szPath);
+        free(pBlob);
+        return false;
+    }
+
+    if (pHeader->uTileCount == 0 || pHeader->uTileCount > TILEMAP_IMPORTER_MAX_TILES || pHeader->uLayerCount < _uLayerCount ||
+        (size_t)pHeader->uTileIdsOffset + sizeof(uint16_t) * pHeader->uTileCount > uFileSize)
+    {
+        debugf("Invalid .tmap contents in %s (tiles=%u, layers=%u)\n", szPath, (unsigned)pHeader->uTileCount, (unsigned)pHeader->uLayerCount);
+        free(pBlob);
+        return false;
+    }
+
+    for (uint8_t i = 0; i < _uLayerCount; ++i)
+    {
+        if (!tmap_layer_record_is_valid(&pHeader->aLayers[i], uFileSize, &pHeader->aLayers[0]))
+        {
+            debugf("Invalid .tmap layer %u in %s\n", (unsigned)i, szPath);
+            free(pBlob);
+            return false;
+        }
+    }
+
+    /* Tile ID remap table (index -> original ID, used for sprite file names) */
+    int *pTileIds = (int *)malloc(sizeof(int) * pHeader->uTileCount);
+    if (!pTileIds)
+    {
+        debugf("Failed to allocate memory for tile IDs\n");
+        free(pBlob);
+        return false;
+    }
+
+    const uint16_t *pBlobTileIds = (const uint16_t *)(pBlob + pHeader->uTileIdsOffset);
+    for (uint16_t i = 0; i < pHeader->uTileCount; ++i)
+        pTileIds[i] = (int)pBlobTileIds[i];
+
+    /* Point layers into the blob; only dense row pointers need their own allocation */
+    tilemap_layer_t aLayers[TILEMAP_IMPORTER_MAX_LAYERS];
+    memset(aLayers, 0, sizeof(aLayers));
+
+    for (uint8_t i = 0; i < _uLayerCount; ++i)
+    {
+        const tilemap_format_layer_t *pRecord = &pHeader->aLayers[i];
+        tilemap_layer_t *pLayer = &aLayers[i];
+
+        pLayer->eStorage = (tilemap_layer_storage_t)pRecord->uStorage;
+        pLayer->uWidth = pRecord->uWidth;
+        pLayer->uHeight = pRecord->uHeight;
+        pLayer->uTileCount = pRecord->uTileCount;
+        pLayer->uSingleTileId = pRecord->uSingleTileId;
+        pLayer->bBlobData = true;
+
+        if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_DENSE)
+        {
+            uint8_t **ppRows = (uint8_t **)malloc(sizeof(uint8_t *) * pLayer->uHeight);
+            if (!ppRows)
+            {
+                debugf("Failed to allocate row pointers for .tmap layer %u\n", (unsigned)i);
+                for (uint8_t j = 0; j < i; ++j)
+                    free_layer(&aLayers[j]);
+                free(pTileIds);
+                free(pBlob);
+                return false;
+            }
+
+            uint8_t *pData = pBlob + pRecord->uDataOffset;
+            for (uint16_t y = 0; y < pLayer->uHeight; ++y)
+                ppRows[y] = &pData[(size_t)y * (size_t)pLayer->uWidth];
+
+            pLayer->pData = pData;
+            pLayer->ppData = ppRows;
+            CACHE_FLUSH_DATA(ppRows, sizeof(uint8_t *) * pLayer->uHeight);
+        }
+        else if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
+        {
+            pLayer->sparse.pEntries = (sparse_tile_entry_t *)(pBlob + pRecord->uDataOffset);
+            pLayer->sparse.uCapacity = pRecord->uSparseCapacity;
+            pLayer->sparse.uCount = pRecord->uSparseCount;
+        }
+        else if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+        {
+            uint32_t uTableSize = tilemap_format_chunk_table_size(pLayer->uWidth, pLayer->uHeight);
+            pLayer->pChunks = (tilemap_chunk_t *)(pBlob + pRecord->uDataOffset);
+            pLayer->pChunkData = pBlob + pRecord->uDataOffset + uTableSize;
+            pLayer->uChunksX = (uint16_t)((pLayer->uWidth + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT);
+            pLayer->uChunksY = (uint16_t)((pLayer->uHeight + TILEMAP_CHUNK_MASK) >> TILEMAP_CHUNK_SHIFT);
+            pLayer->uMixedChunkCount = (uint16_t)((pRecord->uDataSize - uTableSize) / TILEMAP_CHUNK_TILES);
+
+            if (!chunked_layer_is_valid(pLayer))
+            {
+                debugf("Invalid chunk table in .tmap layer %u\n", (unsigned)i);
+                for (uint8_t j = 0; j <= i; ++j)
+                    free_layer(&aLayers[j]);
+                free(pTileIds);
+                free(pBlob);
+                return false;
+            }
+        }
+    }
+
+    /* Flush cache for the whole file buffer once (layer data and atlas pixels live inside it) */
+    CACHE_FLUSH_DATA(pBlob, uFileSize);
+
+    for (uint8_t i = 0; i < _uLayerCount; ++i)
+        _pImporter->aLayers[i] = aLayers[i];
+
+    /* Baked atlas is optional: without it the caller builds the atlas from the tile sprites */
+    if (pHeader->uAtlasPageCount > 0 && !load_tmap_atlas(_pImporter, pBlob, uFileSize))
+        debugf("Invalid .tmap atlas in %s, building atlas at runtime\n", szPath);
+
+    _pImporter->pLayerBlob = pBlob;
+    _pImporter->uLayerBlobSize = uFileSize;
+    *_ppTileIds = pTileIds;
+    *_pTileCount = pHeader->uTileCount;
+    return true;
+}
+
+/* ---------- Atlas building helpers ---------- */
+
+/* Validate tile index (returns false if invalid) */
+static inline bool validate_tile_index(const tilemap_importer_t *_pImporter, uint8_t _uTileIndex)
+{
+    if (!_pImporter || !_pImporter->bInitialized)
+        return false;
+    if (_uTileIndex == TILEMAP_IMPORTER_EMPTY_TILE)
+        return false;
+    if (_uTileIndex >= _pImporter->uTileCount)
+        return false;
+    return true;
+}
+
+/* Tile frequency entry for sorting */
+typedef struct tile_frequency_s
+{
+    uint8_t uTileId;
+    uint32_t uFrequency;
+} tile_frequency_t;
+
+static int cmp_frequency_desc(const void *_pA, const void *_pB)
+{
+    const tile_frequency_t *pA = (const tile_frequency_t *)_pA;
+    const tile_frequency_t *pB = (const tile_frequency_t *)_pB;
+    if (pB->uFrequency > pA->uFrequency)
+        return 1;
+    if (pB->uFrequency < pA->uFrequency)
+        return -1;
+    /* Tie-break on tile ID so the packing is deterministic (and matches tools/tmap_convert.c) */
+    return (pA->uTileId > pB->uTileId) - (pA->uTileId < pB->uTileId);
+}
+
+/* Build frequency histogram by scanning all layers */
+static bool build_tile_frequency_histogram(const tilemap_importer_t *_pImporter, tile_frequency_t *_pFreq, uint16_t _uTileCount)
+{
+    if (!_pImporter || !_pFreq)
+        return false;
+
+    /* Initialize frequency array */
+    for (uint16_t i = 0; i < _uTileCount; ++i)
+    {
+        _pFreq[i].uTileId = (uint8_t)i;
+        _pFreq[i].uFrequency = 0;
+    }
+
+    /* Scan all layers */
+    for (uint8_t uLayer = 0; uLayer < TILEMAP_IMPORTER_MAX_LAYERS; ++uLayer)
+    {
+        const tilemap_layer_t *pLayer = &_pImporter->aLayers[uLayer];
+        if (pLayer->uWidth == 0 || pLayer->uHeight == 0)
+            continue;
+
+        if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+        {
+            for (uint16_t y = 0; y < pLayer->uHeight; ++y)
+            {
+                for (uint16_t x = 0; x < pLayer->uWidth; ++x)
+                {
+                    uint8_t uTileId = tilemap_layer_get_tile(pLayer, x, y);
+                    if (uTileId != TILEMAP_IMPORTER_EMPTY_TILE && uTileId < _uTileCount)
+                        _pFreq[uTileId].uFrequency++;
+                }
+            }
+            continue;
+        }
+
+        if (!pLayer->ppData)
+            continue;
+
+        for (uint16_t y = 0; y < pLayer->uHeight; ++y)
+        {
+            const uint8_t *pRow = pLayer->ppData[y];
+            for (uint16_t x = 0; x < pLayer->uWidth; ++x)
+            {
+                uint8_t uTileId = pRow[x];
+                if (uTileId != TILEMAP_IMPORTER_EMPTY_TILE && uTileId < _uTileCount)
+                {
+                    _pFreq[uTileId].uFrequency++;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+/* Convert a sprite pixel to RGBA16 format */
+static uint16_t convert_pixel_to_rgba16(const surface_t *_pSrcSurface, tex_format_t _eFormat, const uint16_t *_pPalette, uint16_t _x, uint16_t _y)
+{
+    const uint8_t *pRow = (const uint8_t *)_pSrcSurface->buffer + (_y * _pSrcSurface->stride);
+
+    if (_eFormat == FMT_RGBA16)
+    {
+        /* Read pixel directly - assume libdragon surfaces are already in correct format */
+        const uint16_t *pPixel = (const uint16_t *)(pRow + (_x * 2));
+        return *pPixel;
+    }
+    else if (_eFormat == FMT_RGBA32)
+    {
+        const uint32_t *pPixel = (const uint32_t *)(pRow + (_x * 4));
+        uint32_t uRGBA32 = *pPixel;
+        /* Convert RGBA32 (8888) to RGBA16 (5551)
+         * On little-endian systems, when reading uint32_t from [R,G,B,A] in memory:
+         * uRGBA32 = R | (G << 8) | (B << 16) | (A << 24)
+         * So: r = bits 0-7, g = bits 8-15, b = bits 16-23, a = bits 24-31 */
+        uint8_t r = (uint8_t)(uRGBA32 & 0xFF);
         uint8_t g = (uint8_t)((uRGBA32 >> 8) & 0xFF);
         uint8_t b = (uint8_t)((uRGBA32 >> 16) & 0xFF);
         uint8_t a = (uint8_t)((uRGBA32 >> 24) & 0xFF);
@@ -768,300 +1337,897 @@ static void copy_tile_to_atlas_page(surface_t *_pDstPage, uint8_t _uDstX, uint8_
     if (!_pDstPage || !_pSprite)
         return;
 
-    surface_t srcSurface = sprite_get_pixels(_pSprite);
-    if (!srcSurface.buffer)
-        return;
+    surface_t srcSurface = sprite_get_pixels(_pSprite);
+    if (!srcSurface.buffer)
+        return;
+
+    /* Verify sprite dimensions match expected tile size */
+    if (srcSurface.width < 16 || srcSurface.height < 16)
+    {
+        debugf("Warning: Sprite size (%ux%u) is smaller than tile size (16x16)\n", (unsigned)srcSurface.width, (unsigned)srcSurface.height);
+        return;
+    }
+
+    tex_format_t eFormat = sprite_get_format(_pSprite);
+    uint16_t *pPalette = NULL;
+    if (eFormat == FMT_CI4 || eFormat == FMT_CI8)
+    {
+        pPalette = sprite_get_palette(_pSprite);
+        if (!pPalette)
+        {
+            debugf("Warning: CI format sprite has no palette\n");
+            return;
+        }
+    }
+
+    /* Copy 16x16 tile (use top-left 16x16 region of sprite) */
+    /* Always convert pixel-by-pixel to ensure correct format conversion */
+    for (uint8_t y = 0; y < 16; ++y)
+    {
+        uint8_t *pDstRow = (uint8_t *)_pDstPage->buffer + ((_uDstY + y) * _pDstPage->stride);
+
+        for (uint8_t x = 0; x < 16; ++x)
+        {
+            uint16_t uPixel = convert_pixel_to_rgba16(&srcSurface, eFormat, pPalette, x, y);
+            /* Write pixel directly - libdragon handles byte order */
+            uint16_t *pDstPixel = (uint16_t *)(pDstRow + ((_uDstX + x) * 2));
+            *pDstPixel = uPixel;
+        }
+    }
+}
+
+/* Runtime atlas path (CSV maps or .tmap files without a baked atlas): load every tile sprite with its
+ * trimmed rect, order the tiles by usage, pack them into pages and release the sprites again.
+ * Each part works on a range of tiles so the staged loader can spread the build over several steps. */
+
+/* Allocate the sprite table and trimmed rects of all tiles (filled by atlas_load_tile_range) */
+static bool atlas_alloc_tile_tables(tilemap_importer_t *_pImporter, uint16_t _uTileCount)
+{
+    sprite_t **ppSprites = (sprite_t **)malloc(sizeof(sprite_t *) * _uTileCount);
+    if (!ppSprites)
+    {
+        debugf("Failed to allocate memory for sprite pointers\n");
+        return false;
+    }
+    memset(ppSprites, 0, sizeof(sprite_t *) * _uTileCount);
+
+    _pImporter->ppTileSprites = ppSprites;
+    _pImporter->uTileCount = _uTileCount;
+
+    tile_trimmed_rect_t *pTrimmedRects = (tile_trimmed_rect_t *)malloc(sizeof(tile_trimmed_rect_t) * _uTileCount);
+    if (!pTrimmedRects)
+    {
+        debugf("Failed to allocate memory for trimmed rects\n");
+        return false;
+    }
+    memset(pTrimmedRects, 0, sizeof(tile_trimmed_rect_t) * _uTileCount);
+
+    _pImporter->pTileTrimmedRects = pTrimmedRects;
+    return true;
+}
+
+/* Load the sprites of tiles [_uFirst, _uEnd) and compute their trimmed bounding boxes */
+static bool atlas_load_tile_range(tilemap_importer_t *_pImporter, const char *_pMapFolder, const int *_pTileIds, uint16_t _uFirst, uint16_t _uEnd)
+{
+    if (!load_tile_sprites(_pMapFolder, _pTileIds, _uFirst, _uEnd, _pImporter->ppTileSprites))
+    {
+        debugf("Failed to load tile sprites\n");
+        return false;
+    }
+
+    for (uint16_t i = _uFirst; i < _uEnd; ++i)
+    {
+        struct vec2i vOffset = {0, 0};
+        struct vec2i vSize = {0, 0};
+
+        if (!sprite_tools_get_trimmed_rect(_pImporter->ppTileSprites[i], &vOffset, &vSize))
+        {
+            debugf("Failed to get trimmed rect for tile %u\n", (unsigned)i);
+            /* Continue anyway, use default values (0,0) offset and size */
+        }
+
+        _pImporter->pTileTrimmedRects[i].vOffset = vOffset;
+        _pImporter->pTileTrimmedRects[i].vSize = vSize;
+    }
+
+    return true;
+}
+
+/* Order the tiles by usage (most used first) and allocate the page table and atlas entries.
+ * Pages themselves are allocated by atlas_pack_tile_range. Returns the sorted tiles, NULL on failure. */
+static tile_frequency_t *atlas_sort_tiles(tilemap_importer_t *_pImporter)
+{
+    uint16_t uTileCount = _pImporter->uTileCount;
+
+    tile_frequency_t *pFreq = (tile_frequency_t *)malloc(sizeof(tile_frequency_t) * uTileCount);
+    if (!pFreq)
+    {
+        debugf("Failed to allocate frequency array\n");
+        return NULL;
+    }
+
+    if (!build_tile_frequency_histogram(_pImporter, pFreq, uTileCount))
+    {
+        debugf("Failed to build frequency histogram\n");
+        free(pFreq);
+        return NULL;
+    }
+
+    /* Sort by frequency (descending) */
+    qsort(pFreq, uTileCount, sizeof(tile_frequency_t), cmp_frequency_desc);
+
+    /* Calculate number of pages needed */
+    uint16_t uPageCount = (uTileCount + TILE_ATLAS_TILES_PER_PAGE - 1) / TILE_ATLAS_TILES_PER_PAGE;
+    if (uPageCount > TILE_ATLAS_MAX_PAGES)
+        uPageCount = TILE_ATLAS_MAX_PAGES;
+
+    /* Page table (uAtlasPageCount counts the pages allocated so far) */
+    surface_t *pPages = (surface_t *)malloc(sizeof(surface_t) * (uPageCount > 0 ? uPageCount : 1));
+    tile_atlas_entry_t *pEntries = (tile_atlas_entry_t *)malloc(sizeof(tile_atlas_entry_t) * uTileCount);
+    if (!pPages || !pEntries)
+    {
+        debugf("Failed to allocate atlas pages\n");
+        free(pPages);
+        free(pEntries);
+        free(pFreq);
+        return NULL;
+    }
+
+    /* Initialize all entries to invalid */
+    for (uint16_t i = 0; i < uTileCount; ++i)
+    {
+        pEntries[i].uPageIndex = 255;
+        pEntries[i].uU0 = 0;
+        pEntries[i].uV0 = 0;
+    }
+
+    _pImporter->pAtlasPages = pPages;
+    _pImporter->uAtlasPageCount = 0;
+    _pImporter->pAtlasEntries = pEntries;
+    return pFreq;
+}
+
+/* Pack sorted tiles [_uFirst, _uEnd) into the atlas, 8 tiles per page (4x2 grid). A page is allocated
+ * and cleared at its first tile and flushed once its last tile is written. Tiles past the page limit keep
+ * an invalid entry. */
+static bool atlas_pack_tile_range(tilemap_importer_t *_pImporter, const tile_frequency_t *_pSortedTiles, uint16_t _uFirst, uint16_t _uEnd)
+{
+    const uint16_t uTileCount = _pImporter->uTileCount;
+    const uint16_t uTileLimit = (uint16_t)(TILE_ATLAS_MAX_PAGES * TILE_ATLAS_TILES_PER_PAGE);
+
+    for (uint16_t uGlobalTileIndex = _uFirst; uGlobalTileIndex < _uEnd && uGlobalTileIndex < uTileLimit; ++uGlobalTileIndex)
+    {
+        uint16_t uPage = uGlobalTileIndex / TILE_ATLAS_TILES_PER_PAGE;
+        uint8_t uTileInPage = (uint8_t)(uGlobalTileIndex % TILE_ATLAS_TILES_PER_PAGE);
+        surface_t *pPage = &_pImporter->pAtlasPages[uPage];
+
+        if (uPage == _pImporter->uAtlasPageCount)
+        {
+            *pPage = surface_alloc(FMT_RGBA16, TILE_ATLAS_PAGE_WIDTH, TILE_ATLAS_PAGE_HEIGHT);
+            if (!pPage->buffer)
+            {
+                debugf("Failed to allocate atlas page %u\n", (unsigned)uPage);
+                return false;
+            }
+            _pImporter->uAtlasPageCount = uPage + 1;
+
+            /* Clear the page to transparent (important: surface_alloc doesn't zero-initialize) */
+            memset(pPage->buffer, 0, (size_t)pPage->stride * TILE_ATLAS_PAGE_HEIGHT);
+        }
+
+        uint8_t uTileId = _pSortedTiles[uGlobalTileIndex].uTileId;
+        sprite_t *pSprite = _pImporter->ppTileSprites[uTileId];
+        if (pSprite)
+        {
+            /* Calculate position in page: 4 tiles per row, 2 rows */
+            uint8_t uPageX = (uTileInPage % 4) * 16;
+            uint8_t uPageY = (uTileInPage / 4) * 16;
+
+            /* Copy tile to page */
+            copy_tile_to_atlas_page(pPage, uPageX, uPageY, pSprite);
+
+            /* Store atlas entry */
+            _pImporter->pAtlasEntries[uTileId].uPageIndex = (uint8_t)uPage;
+            _pImporter->pAtlasEntries[uTileId].uU0 = uPageX;
+            _pImporter->pAtlasEntries[uTileId].uV0 = uPageY;
+        }
+
+        /* CRITICAL: Flush the page once it is complete so all memset() and copy_tile_to_atlas_page()
+         * writes are visible to DMA. */
+        if (uTileInPage == TILE_ATLAS_TILES_PER_PAGE - 1 || uGlobalTileIndex == uTileCount - 1)
+            CACHE_FLUSH_DATA(pPage->buffer, (size_t)pPage->stride * TILE_ATLAS_PAGE_HEIGHT);
+    }
+
+    return true;
+}
+
+/* Flush the atlas tables and free the individual tile sprites - they're no longer needed after atlas creation */
+static void atlas_finish(tilemap_importer_t *_pImporter)
+{
+    CACHE_FLUSH_DATA(_pImporter->pAtlasEntries, sizeof(tile_atlas_entry_t) * _pImporter->uTileCount);
+    CACHE_FLUSH_DATA(_pImporter->pTileTrimmedRects, sizeof(tile_trimmed_rect_t) * _pImporter->uTileCount);
+
+    if (_pImporter->ppTileSprites)
+    {
+        for (uint16_t i = 0; i < _pImporter->uTileCount; ++i)
+        {
+            SAFE_FREE_SPRITE(_pImporter->ppTileSprites[i]);
+        }
+        free(_pImporter->ppTileSprites);
+        _pImporter->ppTileSprites = NULL;
+    }
+}
+
+/* ---------- Collision mask ---------- */
+
+/* Tile of a collision-relevant layer, empty if the layer is missing or smaller than the mask */
+static inline uint8_t collision_mask_layer_tile(const tilemap_layer_t *_pLayer, uint16_t _uX, uint16_t _uY)
+{
+    if (_uX >= _pLayer->uWidth || _uY >= _pLayer->uHeight)
+        return TILEMAP_IMPORTER_EMPTY_TILE;
+    return tilemap_layer_get_tile(_pLayer, _uX, _uY);
+}
+
+/* Allocate an all-free mask matching layer 0 (rows are classified by collision_mask_build_rows) */
+static bool collision_mask_alloc(tilemap_importer_t *_pImporter)
+{
+    tilemap_collision_mask_t *pMask = &_pImporter->collisionMask;
+    const tilemap_layer_t *pRef = &_pImporter->aLayers[0];
+
+    pMask->uWidth = pRef->uWidth;
+    pMask->uHeight = pRef->uHeight;
+    pMask->uWordsPerRow = (uint16_t)((pRef->uWidth + 15) >> 4);
+
+    size_t uSize = sizeof(uint32_t) * (size_t)pMask->uWordsPerRow * (size_t)pMask->uHeight;
+    pMask->pWords = (uint32_t *)malloc(uSize);
+    if (!pMask->pWords)
+        return false;
+    memset(pMask->pWords, 0, uSize);
+    return true;
+}
+
+/* Classify every tile of mask rows [_uY0, _uY1) once (see tilemap_collision_code_t).
+ * SURFACE: hole beats solid beats landing-blocked, JNR: solid wherever the collision layer has a tile. */
+static void collision_mask_build_rows(tilemap_importer_t *_pImporter, uint16_t _uY0, uint16_t _uY1)
+{
+    tilemap_collision_mask_t *pMask = &_pImporter->collisionMask;
+
+    const bool bJnr = (_pImporter->eType == TILEMAP_TYPE_JNR);
+    const tilemap_layer_t *pCollision = &_pImporter->aLayers[bJnr ? TILEMAP_LAYER_JNR_COLLISION : TILEMAP_LAYER_SURFACE_COLLISION];
+    const tilemap_layer_t *pWalkable = &_pImporter->aLayers[TILEMAP_LAYER_SURFACE_WALKABLE];
+    const tilemap_layer_t *pDecoBG = &_pImporter->aLayers[TILEMAP_LAYER_SURFACE_DECO_BG];
+    const tilemap_layer_t *pDecoFG = &_pImporter->aLayers[TILEMAP_LAYER_SURFACE_DECO_FG];
+
+    for (uint16_t y = _uY0; y < _uY1; ++y)
+    {
+        uint32_t *pRow = &pMask->pWords[(size_t)y * pMask->uWordsPerRow];
+        for (uint16_t x = 0; x < pMask->uWidth; ++x)
+        {
+            uint32_t uCode = TILEMAP_COLLISION_CODE_FREE;
+
+            if (bJnr)
+            {
+                if (collision_mask_layer_tile(pCollision, x, y) != TILEMAP_IMPORTER_EMPTY_TILE)
+                    uCode = TILEMAP_COLLISION_CODE_SOLID;
+            }
+            else if (collision_mask_layer_tile(pWalkable, x, y) == TILEMAP_IMPORTER_EMPTY_TILE)
+                uCode = TILEMAP_COLLISION_CODE_HOLE;
+            else if (collision_mask_layer_tile(pCollision, x, y) != TILEMAP_IMPORTER_EMPTY_TILE)
+                uCode = TILEMAP_COLLISION_CODE_SOLID;
+            else if (collision_mask_layer_tile(pDecoBG, x, y) != TILEMAP_IMPORTER_EMPTY_TILE || collision_mask_layer_tile(pDecoFG, x, y) != TILEMAP_IMPORTER_EMPTY_TILE)
+                uCode = TILEMAP_COLLISION_CODE_LANDING_BLOCKED;
+
+            pRow[x >> 4] |= uCode << ((x & 15) << 1);
+        }
+    }
+
+    CACHE_FLUSH_DATA(&pMask->pWords[(size_t)_uY0 * pMask->uWordsPerRow], sizeof(uint32_t) * (size_t)pMask->uWordsPerRow * (size_t)(_uY1 - _uY0));
+}
+
+static void collision_mask_free(tilemap_collision_mask_t *_pMask)
+{
+    if (_pMask->pWords)
+    {
+        free(_pMask->pWords);
+        _pMask->pWords = NULL;
+    }
+    _pMask->uWordsPerRow = 0;
+    _pMask->uWidth = 0;
+    _pMask->uHeight = 0;
+}
+
+bool tilemap_collision_mask_row_any(const tilemap_collision_mask_t *_pMask, int _iY, int _iX0, int _iX1, uint8_t _uCodeSet)
+{
+    const uint32_t uPairLow = 0x55555555u; /* Low bit of every 2-bit code */
+    const uint32_t *pRow = &_pMask->pWords[_iY * _pMask->uWordsPerRow];
+    const int iWord0 = _iX0 >> 4;
+    const int iWord1 = _iX1 >> 4;
+
+    for (int w = iWord0; w <= iWord1; ++w)
+    {
+        uint32_t uLo = pRow[w] & uPairLow;
+        uint32_t uHi = (pRow[w] >> 1) & uPairLow;
+
+        /* One bit per tile that has a code in the set */
+        uint32_t uMatch = 0;
+        if (_uCodeSet & TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_FREE))
+            uMatch |= ~(uLo | uHi) & uPairLow;
+        if (_uCodeSet & TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_SOLID))
+            uMatch |= uLo & ~uHi;
+        if (_uCodeSet & TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_HOLE))
+            uMatch |= uHi & ~uLo;
+        if (_uCodeSet & TILEMAP_COLLISION_SET(TILEMAP_COLLISION_CODE_LANDING_BLOCKED))
+            uMatch |= uLo & uHi;
+
+        /* Trim the tiles outside [_iX0, _iX1] in the first and last word */
+        if (w == iWord0)
+            uMatch &= uPairLow << ((_iX0 & 15) << 1);
+        if (w == iWord1)
+            uMatch &= uPairLow >> ((15 - (_iX1 & 15)) << 1);
+
+        if (uMatch)
+            return true;
+    }
+
+    return false;
+}
+
+/* ---------- Flattened render layer ---------- */
+
+#define FLAT_PAIR_TABLE_SIZE (256 * 256) /* (lower << 8 | upper) -> composite tile ID */
+
+/* Pixel row _uY of a tile in an atlas page */
+static inline const uint16_t *flat_atlas_tile_row(const surface_t *_pPage, const tile_atlas_entry_t *_pEntry, uint32_t _uY)
+{
+    return (const uint16_t *)((const uint8_t *)_pPage->buffer + (size_t)(_pEntry->uV0 + _uY) * _pPage->stride) + _pEntry->uU0;
+}
+
+/* Regular atlas page and entry of a tile, NULL for empty or unpacked tiles */
+static const surface_t *flat_source_tile(const tilemap_importer_t *_pImporter, uint8_t _uTileId, tile_atlas_entry_t *_pOutEntry)
+{
+    if (_uTileId == TILEMAP_IMPORTER_EMPTY_TILE || !tilemap_importer_get_atlas_entry(_pImporter, _uTileId, _pOutEntry))
+        return NULL;
+    return tilemap_importer_get_atlas_page(_pImporter, _pOutEntry->uPageIndex);
+}
+
+/* Compose one (lower, upper) pair into a page slot the way the renderer draws the two layers:
+ * the lower tile as is, then the upper tile where its alpha bit is set */
+static void flat_compose_tile(const tilemap_importer_t *_pImporter, surface_t *_pDstPage, uint8_t _uDstX, uint8_t _uDstY, uint8_t _uLowerId, uint8_t _uUpperId)
+{
+    tile_atlas_entry_t lowerEntry = {0}, upperEntry = {0};
+    const surface_t *pLowerPage = flat_source_tile(_pImporter, _uLowerId, &lowerEntry);
+    const surface_t *pUpperPage = flat_source_tile(_pImporter, _uUpperId, &upperEntry);
 
-    /* Verify sprite dimensions match expected tile size */
-    if (srcSurface.width < 16 || srcSurface.height < 16)
+    for (uint32_t y = 0; y < 16; ++y)
     {
-        debugf("Warning: Sprite size (%ux%u) is smaller than tile size (16x16)\n", (unsigned)srcSurface.width, (unsigned)srcSurface.height);
-        return;
-    }
+        uint16_t *pDst = (uint16_t *)((uint8_t *)_pDstPage->buffer + (size_t)(_uDstY + y) * _pDstPage->stride) + _uDstX;
+        const uint16_t *pLower = pLowerPage ? flat_atlas_tile_row(pLowerPage, &lowerEntry, y) : NULL;
+        const uint16_t *pUpper = pUpperPage ? flat_atlas_tile_row(pUpperPage, &upperEntry, y) : NULL;
 
-    tex_format_t eFormat = sprite_get_format(_pSprite);
-    uint16_t *pPalette = NULL;
-    if (eFormat == FMT_CI4 || eFormat == FMT_CI8)
-    {
-        pPalette = sprite_get_palette(_pSprite);
-        if (!pPalette)
+        for (uint32_t x = 0; x < 16; ++x)
         {
-            debugf("Warning: CI format sprite has no palette\n");
-            return;
+            uint16_t uPixel = pLower ? pLower[x] : 0;
+            if (pUpper && (pUpper[x] & 1u))
+                uPixel = pUpper[x];
+            pDst[x] = uPixel;
         }
     }
+}
 
-    /* Copy 16x16 tile (use top-left 16x16 region of sprite) */
-    /* Always convert pixel-by-pixel to ensure correct format conversion */
-    for (uint8_t y = 0; y < 16; ++y)
-    {
-        uint8_t *pDstRow = (uint8_t *)_pDstPage->buffer + ((_uDstY + y) * _pDstPage->stride);
+static void flat_layer_free(tilemap_flat_layer_t *_pFlat)
+{
+    free_layer(&_pFlat->layer);
 
-        for (uint8_t x = 0; x < 16; ++x)
-        {
-            uint16_t uPixel = convert_pixel_to_rgba16(&srcSurface, eFormat, pPalette, x, y);
-            /* Write pixel directly - libdragon handles byte order */
-            uint16_t *pDstPixel = (uint16_t *)(pDstRow + ((_uDstX + x) * 2));
-            *pDstPixel = uPixel;
-        }
+    if (_pFlat->pAtlasPages)
+    {
+        for (uint16_t i = 0; i < _pFlat->uAtlasPageCount; ++i)
+            surface_free(&_pFlat->pAtlasPages[i]);
+        free(_pFlat->pAtlasPages);
     }
+
+    if (_pFlat->pAtlasEntries)
+        free(_pFlat->pAtlasEntries);
+
+    memset(_pFlat, 0, sizeof(tilemap_flat_layer_t));
 }
 
-/* Build atlas pages from sorted tile list */
-static bool build_atlas_pages(tilemap_importer_t *_pImporter, const tile_frequency_t *_pSortedTiles, uint16_t _uTileCount)
+bool tilemap_importer_flatten_layers(tilemap_importer_t *_pImporter, uint8_t _uLowerLayer, uint8_t _uUpperLayer)
 {
-    if (!_pImporter || !_pSortedTiles)
+    if (!_pImporter || !_pImporter->bInitialized || _uUpperLayer != _uLowerLayer + 1 || _uUpperLayer >= TILEMAP_IMPORTER_MAX_LAYERS)
         return false;
 
-    /* Calculate number of pages needed */
-    uint16_t uPageCount = (_uTileCount + TILE_ATLAS_TILES_PER_PAGE - 1) / TILE_ATLAS_TILES_PER_PAGE;
-    if (uPageCount > TILE_ATLAS_MAX_PAGES)
-        uPageCount = TILE_ATLAS_MAX_PAGES;
+    if (_pImporter->flat.bActive)
+        return _pImporter->flat.uLowerLayer == _uLowerLayer;
 
-    /* Allocate atlas pages */
-    surface_t *pPages = (surface_t *)malloc(sizeof(surface_t) * uPageCount);
-    if (!pPages)
+    const tilemap_layer_t *pLower = &_pImporter->aLayers[_uLowerLayer];
+    const tilemap_layer_t *pUpper = &_pImporter->aLayers[_uUpperLayer];
+    if (pLower->uWidth == 0 || pLower->uWidth != pUpper->uWidth || pLower->uHeight != pUpper->uHeight)
     {
-        debugf("Failed to allocate atlas pages\n");
+        debugf("flatten: layers %u/%u don't match in size\n", (unsigned)_uLowerLayer, (unsigned)_uUpperLayer);
         return false;
     }
 
-    /* Allocate atlas entries lookup table */
-    tile_atlas_entry_t *pEntries = (tile_atlas_entry_t *)malloc(sizeof(tile_atlas_entry_t) * _uTileCount);
-    if (!pEntries)
+    /* A single-tile lower layer is drawn as one rectangle already; composites would cost one per cell */
+    if (pLower->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
     {
-        debugf("Failed to allocate atlas entries\n");
-        free(pPages);
+        debugf("flatten: layer %u is a single-tile fill, keeping layers %u/%u separate\n", (unsigned)_uLowerLayer, (unsigned)_uLowerLayer, (unsigned)_uUpperLayer);
         return false;
     }
 
-    /* Initialize all entries to invalid */
-    for (uint16_t i = 0; i < _uTileCount; ++i)
+    tilemap_flat_layer_t flat;
+    memset(&flat, 0, sizeof(flat));
+    flat.uLowerLayer = _uLowerLayer;
+    flat.uUpperLayer = _uUpperLayer;
+
+    uint8_t *pPairIds = (uint8_t *)malloc(FLAT_PAIR_TABLE_SIZE);
+    uint16_t aPairs[TILEMAP_IMPORTER_MAX_TILES];
+    const uint16_t uWidth = pLower->uWidth;
+    const uint16_t uHeight = pLower->uHeight;
+
+    flat.layer.eStorage = TILEMAP_LAYER_STORAGE_DENSE;
+    flat.layer.uWidth = uWidth;
+    flat.layer.uHeight = uHeight;
+    flat.layer.pData = (uint8_t *)malloc((size_t)uWidth * uHeight);
+    flat.layer.ppData = (uint8_t **)malloc(sizeof(uint8_t *) * uHeight);
+    if (!pPairIds || !flat.layer.pData || !flat.layer.ppData)
     {
-        pEntries[i].uPageIndex = 255;
-        pEntries[i].uU0 = 0;
-        pEntries[i].uV0 = 0;
+        debugf("flatten: out of memory\n");
+        goto fail;
     }
+    memset(pPairIds, TILEMAP_IMPORTER_EMPTY_TILE, FLAT_PAIR_TABLE_SIZE);
 
-    /* Allocate and build each page */
-    for (uint16_t uPage = 0; uPage < uPageCount; ++uPage)
+    for (uint16_t y = 0; y < uHeight; ++y)
     {
-        pPages[uPage] = surface_alloc(FMT_RGBA16, TILE_ATLAS_PAGE_WIDTH, TILE_ATLAS_PAGE_HEIGHT);
-        if (!pPages[uPage].buffer)
+        uint8_t *pRow = flat.layer.pData + (size_t)y * uWidth;
+        flat.layer.ppData[y] = pRow;
+
+        for (uint16_t x = 0; x < uWidth; ++x)
         {
-            debugf("Failed to allocate atlas page %u\n", (unsigned)uPage);
-            /* Free already allocated pages */
-            for (uint16_t i = 0; i < uPage; ++i)
+            uint8_t uLowerId = tilemap_layer_get_tile(pLower, x, y);
+            uint8_t uUpperId = tilemap_layer_get_tile(pUpper, x, y);
+            if (uLowerId == TILEMAP_IMPORTER_EMPTY_TILE && uUpperId == TILEMAP_IMPORTER_EMPTY_TILE)
             {
-                surface_free(&pPages[i]);
+                pRow[x] = TILEMAP_IMPORTER_EMPTY_TILE;
+                continue;
             }
-            free(pPages);
-            free(pEntries);
-            return false;
+
+            uint16_t uKey = (uint16_t)((uLowerId << 8) | uUpperId);
+            if (pPairIds[uKey] == TILEMAP_IMPORTER_EMPTY_TILE)
+            {
+                if (flat.uTileCount >= TILEMAP_IMPORTER_MAX_TILES)
+                {
+                    debugf("flatten: more than %u tile pairs, keeping layers %u/%u separate\n", (unsigned)TILEMAP_IMPORTER_MAX_TILES, (unsigned)_uLowerLayer, (unsigned)_uUpperLayer);
+                    goto fail;
+                }
+                aPairs[flat.uTileCount] = uKey;
+                pPairIds[uKey] = (uint8_t)flat.uTileCount++;
+            }
+            pRow[x] = pPairIds[uKey];
+            flat.layer.uTileCount++;
         }
+    }
+
+    free(pPairIds);
+    pPairIds = NULL;
+
+    /* Composite atlas, tiles packed in order of first appearance */
+    uint16_t uPageCount = (uint16_t)((flat.uTileCount + TILE_ATLAS_TILES_PER_PAGE - 1) / TILE_ATLAS_TILES_PER_PAGE);
+    flat.pAtlasPages = (surface_t *)malloc(sizeof(surface_t) * (uPageCount > 0 ? uPageCount : 1));
+    flat.pAtlasEntries = (tile_atlas_entry_t *)malloc(sizeof(tile_atlas_entry_t) * (flat.uTileCount > 0 ? flat.uTileCount : 1));
+    if (!flat.pAtlasPages || !flat.pAtlasEntries)
+    {
+        debugf("flatten: out of memory\n");
+        goto fail;
+    }
 
-        /* Clear the page to transparent (important: surface_alloc doesn't zero-initialize) */
-        memset(pPages[uPage].buffer, 0, (size_t)pPages[uPage].stride * TILE_ATLAS_PAGE_HEIGHT);
+    for (uint16_t uPage = 0; uPage < uPageCount; ++uPage)
+    {
+        surface_t *pPage = &flat.pAtlasPages[uPage];
+        *pPage = surface_alloc(FMT_RGBA16, TILE_ATLAS_PAGE_WIDTH, TILE_ATLAS_PAGE_HEIGHT);
+        if (!pPage->buffer)
+        {
+            debugf("flatten: failed to allocate atlas page %u\n", (unsigned)uPage);
+            goto fail;
+        }
+        flat.uAtlasPageCount++;
+        memset(pPage->buffer, 0, (size_t)pPage->stride * TILE_ATLAS_PAGE_HEIGHT);
 
-        /* Pack up to 8 tiles into this page (4x2 grid) */
         for (uint8_t uTileInPage = 0; uTileInPage < TILE_ATLAS_TILES_PER_PAGE; ++uTileInPage)
         {
-            uint16_t uGlobalTileIndex = uPage * TILE_ATLAS_TILES_PER_PAGE + uTileInPage;
-            if (uGlobalTileIndex >= _uTileCount)
+            uint16_t uTileId = (uint16_t)(uPage * TILE_ATLAS_TILES_PER_PAGE + uTileInPage);
+            if (uTileId >= flat.uTileCount)
                 break;
 
-            uint8_t uTileId = _pSortedTiles[uGlobalTileIndex].uTileId;
-            sprite_t *pSprite = _pImporter->ppTileSprites[uTileId];
-            if (!pSprite)
-                continue;
-
-            /* Calculate position in page: 4 tiles per row, 2 rows */
             uint8_t uPageX = (uTileInPage % 4) * 16;
             uint8_t uPageY = (uTileInPage / 4) * 16;
+            flat_compose_tile(_pImporter, pPage, uPageX, uPageY, (uint8_t)(aPairs[uTileId] >> 8), (uint8_t)(aPairs[uTileId] & 0xFF));
 
-            /* Copy tile to page */
-            copy_tile_to_atlas_page(&pPages[uPage], uPageX, uPageY, pSprite);
-
-            /* Store atlas entry */
-            pEntries[uTileId].uPageIndex = (uint8_t)uPage;
-            pEntries[uTileId].uU0 = uPageX;
-            pEntries[uTileId].uV0 = uPageY;
+            flat.pAtlasEntries[uTileId].uPageIndex = (uint8_t)uPage;
+            flat.pAtlasEntries[uTileId].uU0 = uPageX;
+            flat.pAtlasEntries[uTileId].uV0 = uPageY;
         }
 
-        /* CRITICAL: Flush cache immediately after building this page
-         * This ensures all memset() and copy_tile_to_atlas_page() writes are visible to DMA.
-         * Only call cache operations if address is in cacheable range (KSEG0: 0x80000000-0x9fffffff) */
-        CACHE_FLUSH_DATA(pPages[uPage].buffer, (size_t)pPages[uPage].stride * TILE_ATLAS_PAGE_HEIGHT);
+        CACHE_FLUSH_DATA(pPage->buffer, (size_t)pPage->stride * TILE_ATLAS_PAGE_HEIGHT);
     }
 
-    /* Flush cache for atlas entries lookup table */
-    CACHE_FLUSH_DATA(pEntries, sizeof(tile_atlas_entry_t) * _uTileCount);
+    CACHE_FLUSH_DATA(flat.pAtlasEntries, sizeof(tile_atlas_entry_t) * flat.uTileCount);
+    CACHE_FLUSH_DATA(flat.layer.pData, (size_t)uWidth * uHeight);
 
-    _pImporter->pAtlasPages = pPages;
-    _pImporter->uAtlasPageCount = uPageCount;
-    _pImporter->pAtlasEntries = pEntries;
+    flat.bActive = true;
+    _pImporter->flat = flat;
 
+    debugf("flatten: layers %u+%u -> %u composite tiles on %u pages\n", (unsigned)_uLowerLayer, (unsigned)_uUpperLayer, (unsigned)flat.uTileCount, (unsigned)flat.uAtlasPageCount);
     return true;
+
+fail:
+    if (pPairIds)
+        free(pPairIds);
+    flat_layer_free(&flat);
+    return false;
 }
 
 /* ---------- Public API ---------- */
 
-bool tilemap_importer_init(tilemap_importer_t *_pImporter, const char *_pMapFolder, tilemap_type_t _eType)
-{
-    if (!_pImporter || !_pMapFolder)
-        return false;
-
-    memset(_pImporter, 0, sizeof(*_pImporter));
-
-    /* Determine layer count based on type */
-    uint8_t uLayerCount = (_eType == TILEMAP_TYPE_JNR) ? TILEMAP_LAYER_COUNT_JNR : TILEMAP_LAYER_COUNT_SURFACE;
-    _pImporter->uLayerCount = uLayerCount;
-    _pImporter->eType = _eType;
+/* ---------- Staged loading ---------- */
 
-    bool bOk = false;
+/* Loader stages, in order. A .tmap goes OPEN -> READ -> PARSE -> ROW_INDEX; without one (or if it is invalid)
+ * the loader continues at CSV_IDS -> CSV_LAYERS -> ROW_INDEX. A baked atlas finishes at ATLAS; otherwise the
+ * atlas is built from the tile sprites in ATLAS_SPRITES -> ATLAS_SORT -> ATLAS_PACK. */
+enum
+{
+    TILEMAP_LOAD_STAGE_OPEN = 0,
+    TILEMAP_LOAD_STAGE_READ,       /* TILEMAP_LOAD_READ_SLICE bytes per step */
+    TILEMAP_LOAD_STAGE_PARSE,
+    TILEMAP_LOAD_STAGE_CSV_IDS,
+    TILEMAP_LOAD_STAGE_CSV_LAYERS, /* One layer per step */
+    TILEMAP_LOAD_STAGE_ROW_INDEX,  /* One sparse layer per step */
+    TILEMAP_LOAD_STAGE_MASK,       /* TILEMAP_LOAD_MASK_ROWS rows per step */
+    TILEMAP_LOAD_STAGE_ATLAS,
+    TILEMAP_LOAD_STAGE_ATLAS_SPRITES, /* TILEMAP_LOAD_ATLAS_TILES sprites loaded per step */
+    TILEMAP_LOAD_STAGE_ATLAS_SORT,
+    TILEMAP_LOAD_STAGE_ATLAS_PACK,    /* TILEMAP_LOAD_ATLAS_TILES tiles packed per step */
+    TILEMAP_LOAD_STAGE_DONE,
+    TILEMAP_LOAD_STAGE_FAILED
+};
+
+#define TILEMAP_LOAD_READ_SLICE (8 * 1024) /* ROM bytes read per step */
+#define TILEMAP_LOAD_MASK_ROWS 16          /* Collision mask rows classified per step */
+#define TILEMAP_LOAD_ATLAS_TILES 8         /* Runtime atlas tiles loaded or packed per step (one page) */
+
+static void tilemap_loader_release(tilemap_importer_loader_t *_pLoader)
+{
+    if (_pLoader->pFile)
+    {
+        fclose(_pLoader->pFile);
+        _pLoader->pFile = NULL;
+    }
 
-    int *pTileIds = NULL;
-    uint16_t uTileCount = 0;
+    if (_pLoader->pBlob)
+    {
+        free(_pLoader->pBlob);
+        _pLoader->pBlob = NULL;
+    }
 
-    if (!load_tile_ids_sorted(_pMapFolder, &pTileIds, &uTileCount))
+    if (_pLoader->pTileIds)
     {
-        debugf("Failed to load tile IDs\n");
-        goto fail;
+        free(_pLoader->pTileIds);
+        _pLoader->pTileIds = NULL;
     }
 
-    sprite_t **ppSprites = NULL;
-    if (!load_tile_sprites(_pMapFolder, pTileIds, uTileCount, &ppSprites))
+    if (_pLoader->pAtlasOrder)
     {
-        debugf("Failed to load tile sprites\n");
-        goto fail;
+        free(_pLoader->pAtlasOrder);
+        _pLoader->pAtlasOrder = NULL;
     }
+}
 
-    _pImporter->ppTileSprites = ppSprites;
-    _pImporter->uTileCount = uTileCount;
+/* Last step of a successful load */
+static tilemap_load_status_t tilemap_loader_done(tilemap_importer_loader_t *_pLoader, bool _bAtlasBaked)
+{
+    _pLoader->pImporter->bInitialized = true;
+    tilemap_loader_release(_pLoader);
+    _pLoader->uStage = TILEMAP_LOAD_STAGE_DONE;
+
+    debugf("Tilemap %s loaded from %s (%s atlas) in %lu us\n",
+           _pLoader->szMapFolder,
+           _pLoader->bFromTmap ? ".tmap" : "CSV",
+           _bAtlasBaked ? "baked" : "runtime",
+           (unsigned long)(get_ticks_us() - _pLoader->uStartUs));
+    return TILEMAP_LOAD_DONE;
+}
 
-    /* Flush cache for sprite pointer array */
-    CACHE_FLUSH_DATA(ppSprites, sizeof(sprite_t *) * uTileCount);
+static tilemap_load_status_t tilemap_loader_fail(tilemap_importer_loader_t *_pLoader)
+{
+    tilemap_loader_release(_pLoader);
+    tilemap_importer_free(_pLoader->pImporter);
+    _pLoader->uStage = TILEMAP_LOAD_STAGE_FAILED;
+    return TILEMAP_LOAD_FAILED;
+}
 
-    /* Calculate trimmed bounding boxes for all tile sprites */
-    tile_trimmed_rect_t *pTrimmedRects = (tile_trimmed_rect_t *)malloc(sizeof(tile_trimmed_rect_t) * uTileCount);
-    if (!pTrimmedRects)
+bool tilemap_importer_load_begin(tilemap_importer_loader_t *_pLoader, tilemap_importer_t *_pImporter, const char *_pMapFolder, tilemap_type_t _eType)
+{
+    if (!_pLoader || !_pImporter || !_pMapFolder)
+        return false;
+
+    if (strlen(_pMapFolder) >= sizeof(_pLoader->szMapFolder))
     {
-        debugf("Failed to allocate memory for trimmed rects\n");
-        goto fail;
+        debugf("Tilemap folder name too long: %s\n", _pMapFolder);
+        return false;
     }
 
-    /* Initialize to zero before populating */
-    memset(pTrimmedRects, 0, sizeof(tile_trimmed_rect_t) * uTileCount); // remove - overly aggressive fix?
+    memset(_pLoader, 0, sizeof(*_pLoader));
+    memset(_pImporter, 0, sizeof(*_pImporter));
 
-    for (uint16_t i = 0; i < uTileCount; ++i)
+    /* Determine layer count based on type */
+    _pImporter->uLayerCount = (_eType == TILEMAP_TYPE_JNR) ? TILEMAP_LAYER_COUNT_JNR : TILEMAP_LAYER_COUNT_SURFACE;
+    _pImporter->eType = _eType;
+
+    _pLoader->pImporter = _pImporter;
+    strcpy(_pLoader->szMapFolder, _pMapFolder);
+    _pLoader->uStage = TILEMAP_LOAD_STAGE_OPEN;
+    _pLoader->uStartUs = get_ticks_us();
+    return true;
+}
+
+tilemap_load_status_t tilemap_importer_load_step(tilemap_importer_loader_t *_pLoader)
+{
+    if (!_pLoader || !_pLoader->pImporter)
+        return TILEMAP_LOAD_FAILED;
+
+    tilemap_importer_t *pImporter = _pLoader->pImporter;
+    const uint8_t uLayerCount = pImporter->uLayerCount;
+
+    switch (_pLoader->uStage)
     {
-        struct vec2i vOffset = {0, 0};
-        struct vec2i vSize = {0, 0};
+    case TILEMAP_LOAD_STAGE_OPEN:
+        /* Binary .tmap provides tile IDs and all layers in one file; CSV parsing is the fallback */
+        _pLoader->pBlob = load_tmap_open(_pLoader->szMapFolder, &_pLoader->pFile, &_pLoader->uBlobSize);
+        _pLoader->uBlobRead = 0;
+        _pLoader->uStage = _pLoader->pBlob ? TILEMAP_LOAD_STAGE_READ : TILEMAP_LOAD_STAGE_CSV_IDS;
+        return TILEMAP_LOAD_PENDING;
+
+    case TILEMAP_LOAD_STAGE_READ:
+    {
+        size_t uSlice = _pLoader->uBlobSize - _pLoader->uBlobRead;
+        if (uSlice > TILEMAP_LOAD_READ_SLICE)
+            uSlice = TILEMAP_LOAD_READ_SLICE;
+
+        size_t uRead = fread(_pLoader->pBlob + _pLoader->uBlobRead, 1, uSlice, _pLoader->pFile);
+        _pLoader->uBlobRead += uRead;
 
-        if (!sprite_tools_get_trimmed_rect(ppSprites[i], &vOffset, &vSize))
+        if (uRead != uSlice)
         {
-            debugf("Failed to get trimmed rect for tile %u\n", (unsigned)i);
-            /* Continue anyway, use default values (0,0) offset and size */
+            debugf("Failed to read %s.tmap, falling back to CSV\n", _pLoader->szMapFolder);
+            tilemap_loader_release(_pLoader);
+            _pLoader->uStage = TILEMAP_LOAD_STAGE_CSV_IDS;
         }
-
-        pTrimmedRects[i].vOffset = vOffset;
-        pTrimmedRects[i].vSize = vSize;
+        else if (_pLoader->uBlobRead == _pLoader->uBlobSize)
+        {
+            fclose(_pLoader->pFile);
+            _pLoader->pFile = NULL;
+            _pLoader->uStage = TILEMAP_LOAD_STAGE_PARSE;
+        }
+        return TILEMAP_LOAD_PENDING;
     }
 
-    _pImporter->pTileTrimmedRects = pTrimmedRects;
+    case TILEMAP_LOAD_STAGE_PARSE:
+    {
+        /* The parser owns the buffer from here on (kept by the importer or freed) */
+        uint8_t *pBlob = _pLoader->pBlob;
+        _pLoader->pBlob = NULL;
+
+        _pLoader->bFromTmap = load_tmap_parse(pImporter, pBlob, _pLoader->uBlobSize, _pLoader->szMapFolder, uLayerCount, &_pLoader->pTileIds, &_pLoader->uTileCount);
+        if (_pLoader->bFromTmap)
+        {
+            pImporter->uTileCount = _pLoader->uTileCount;
+            _pLoader->uLayer = 0;
+            _pLoader->uStage = TILEMAP_LOAD_STAGE_ROW_INDEX;
+        }
+        else
+        {
+            _pLoader->uStage = TILEMAP_LOAD_STAGE_CSV_IDS;
+        }
+        return TILEMAP_LOAD_PENDING;
+    }
 
-    /* Flush cache for trimmed rects array - AFTER assignment to ensure all writes are complete */
-    CACHE_FLUSH_DATA(pTrimmedRects, sizeof(tile_trimmed_rect_t) * uTileCount);
+    case TILEMAP_LOAD_STAGE_CSV_IDS:
+        if (!load_tile_ids_sorted(_pLoader->szMapFolder, &_pLoader->pTileIds, &_pLoader->uTileCount))
+        {
+            debugf("Failed to load tile IDs\n");
+            return tilemap_loader_fail(_pLoader);
+        }
+        pImporter->uTileCount = _pLoader->uTileCount;
+        _pLoader->uLayer = 0;
+        _pLoader->uStage = TILEMAP_LOAD_STAGE_CSV_LAYERS;
+        return TILEMAP_LOAD_PENDING;
 
-    /* Load CSV layers (only load the required number of layers based on type) */
-    for (uint8_t i = 0; i < uLayerCount; ++i)
+    case TILEMAP_LOAD_STAGE_CSV_LAYERS:
     {
+        uint8_t i = _pLoader->uLayer;
         tilemap_layer_t tLayer;
-        if (!load_csv_layer(_pMapFolder, i, &tLayer, pTileIds, uTileCount))
+        if (!load_csv_layer(_pLoader->szMapFolder, i, &tLayer, _pLoader->pTileIds, _pLoader->uTileCount))
         {
             debugf("Failed to load CSV layer %u\n", (unsigned)i);
-            goto fail;
+            return tilemap_loader_fail(_pLoader);
         }
 
         /* Verify consistent dimensions */
-        if (i > 0)
+        if (i > 0 && (tLayer.uWidth != pImporter->aLayers[0].uWidth || tLayer.uHeight != pImporter->aLayers[0].uHeight))
+        {
+            debugf("Layer %u dimensions (%ux%u) don't match layer 0 (%ux%u)\n",
+                   (unsigned)i,
+                   (unsigned)tLayer.uWidth,
+                   (unsigned)tLayer.uHeight,
+                   (unsigned)pImporter->aLayers[0].uWidth,
+                   (unsigned)pImporter->aLayers[0].uHeight);
+            free_layer(&tLayer);
+            return tilemap_loader_fail(_pLoader);
+        }
+
+        pImporter->aLayers[i] = tLayer;
+        if (++_pLoader->uLayer >= uLayerCount)
+        {
+            _pLoader->uLayer = 0;
+            _pLoader->uStage = TILEMAP_LOAD_STAGE_ROW_INDEX;
+        }
+        return TILEMAP_LOAD_PENDING;
+    }
+
+    case TILEMAP_LOAD_STAGE_ROW_INDEX:
+        /* Row index for sparse layers: view-rect queries and lookups only touch the rows in range */
+        while (_pLoader->uLayer < uLayerCount)
         {
-            if (tLayer.uWidth != _pImporter->aLayers[0].uWidth || tLayer.uHeight != _pImporter->aLayers[0].uHeight)
+            uint8_t i = _pLoader->uLayer++;
+            tilemap_layer_t *pLayer = &pImporter->aLayers[i];
+            if (pLayer->eStorage != TILEMAP_LAYER_STORAGE_SPARSE)
+                continue;
+
+            if (!sparse_layer_build_row_index(&pLayer->sparse, pLayer->uHeight))
             {
-                debugf("Layer %u dimensions (%ux%u) don't match layer 0 (%ux%u)\n",
-                       (unsigned)i,
-                       (unsigned)tLayer.uWidth,
-                       (unsigned)tLayer.uHeight,
-                       (unsigned)_pImporter->aLayers[0].uWidth,
-                       (unsigned)_pImporter->aLayers[0].uHeight);
-                free_layer(&tLayer);
-                goto fail;
+                debugf("Failed to build row index for sparse layer %u\n", (unsigned)i);
+                return tilemap_loader_fail(_pLoader);
             }
+            return TILEMAP_LOAD_PENDING;
         }
 
-        _pImporter->aLayers[i] = tLayer;
-    }
+        _pLoader->uMaskRow = 0;
+        _pLoader->uStage = TILEMAP_LOAD_STAGE_MASK;
+        return TILEMAP_LOAD_PENDING;
 
-    /* Build frequency histogram and create atlas pages */
-    tile_frequency_t *pFreq = (tile_frequency_t *)malloc(sizeof(tile_frequency_t) * uTileCount);
-    if (!pFreq)
+    case TILEMAP_LOAD_STAGE_MASK:
     {
-        debugf("Failed to allocate frequency array\n");
-        goto fail;
-    }
+        /* Packed collision classes for sweeps and walk checks */
+        tilemap_collision_mask_t *pMask = &pImporter->collisionMask;
+        if (!pMask->pWords && !collision_mask_alloc(pImporter))
+        {
+            debugf("Failed to build collision mask\n");
+            return tilemap_loader_fail(_pLoader);
+        }
 
-    if (!build_tile_frequency_histogram(_pImporter, pFreq, uTileCount))
-    {
-        debugf("Failed to build frequency histogram\n");
-        free(pFreq);
-        goto fail;
+        uint16_t uY0 = _pLoader->uMaskRow;
+        uint16_t uY1 = (pMask->uHeight - uY0 > TILEMAP_LOAD_MASK_ROWS) ? (uint16_t)(uY0 + TILEMAP_LOAD_MASK_ROWS) : pMask->uHeight;
+        collision_mask_build_rows(pImporter, uY0, uY1);
+
+        _pLoader->uMaskRow = uY1;
+        if (uY1 >= pMask->uHeight)
+            _pLoader->uStage = TILEMAP_LOAD_STAGE_ATLAS;
+        return TILEMAP_LOAD_PENDING;
     }
 
-    /* Sort by frequency (descending) */
-    qsort(pFreq, uTileCount, sizeof(tile_frequency_t), cmp_frequency_desc);
+    case TILEMAP_LOAD_STAGE_ATLAS:
+        /* Baked .tmap atlas already provides pages, entries and trimmed rects */
+        if (pImporter->pAtlasPages)
+            return tilemap_loader_done(_pLoader, true);
 
-    /* Flush after qsort since it writes to memory that will be freed and potentially reused */
-    CACHE_FLUSH_DATA(pFreq, sizeof(tile_frequency_t) * uTileCount);
+        if (!atlas_alloc_tile_tables(pImporter, _pLoader->uTileCount))
+            return tilemap_loader_fail(_pLoader);
+        _pLoader->uAtlasTile = 0;
+        _pLoader->uStage = TILEMAP_LOAD_STAGE_ATLAS_SPRITES;
+        return TILEMAP_LOAD_PENDING;
 
-    /* Build atlas pages */
-    if (!build_atlas_pages(_pImporter, pFreq, uTileCount))
+    case TILEMAP_LOAD_STAGE_ATLAS_SPRITES:
+    case TILEMAP_LOAD_STAGE_ATLAS_PACK:
     {
-        debugf("Failed to build atlas pages\n");
-        free(pFreq);
-        goto fail;
-    }
+        uint16_t uFirst = _pLoader->uAtlasTile;
+        uint16_t uEnd = (pImporter->uTileCount - uFirst > TILEMAP_LOAD_ATLAS_TILES) ? (uint16_t)(uFirst + TILEMAP_LOAD_ATLAS_TILES) : pImporter->uTileCount;
+        bool bSprites = _pLoader->uStage == TILEMAP_LOAD_STAGE_ATLAS_SPRITES;
 
-    free(pFreq);
-    pFreq = NULL;
+        if (bSprites ? !atlas_load_tile_range(pImporter, _pLoader->szMapFolder, _pLoader->pTileIds, uFirst, uEnd)
+                     : !atlas_pack_tile_range(pImporter, _pLoader->pAtlasOrder, uFirst, uEnd))
+            return tilemap_loader_fail(_pLoader);
 
-    /* Free individual tile sprites - they're no longer needed after atlas creation */
-    if (_pImporter->ppTileSprites)
-    {
-        for (uint16_t i = 0; i < _pImporter->uTileCount; ++i)
+        _pLoader->uAtlasTile = uEnd;
+        if (uEnd < pImporter->uTileCount)
+            return TILEMAP_LOAD_PENDING;
+
+        if (bSprites)
         {
-            SAFE_FREE_SPRITE(_pImporter->ppTileSprites[i]);
+            _pLoader->uStage = TILEMAP_LOAD_STAGE_ATLAS_SORT;
+            return TILEMAP_LOAD_PENDING;
         }
-        free(_pImporter->ppTileSprites);
-        _pImporter->ppTileSprites = NULL;
+
+        atlas_finish(pImporter);
+        return tilemap_loader_done(_pLoader, false);
     }
 
-    _pImporter->bInitialized = true;
-    bOk = true;
+    case TILEMAP_LOAD_STAGE_ATLAS_SORT:
+        _pLoader->pAtlasOrder = atlas_sort_tiles(pImporter);
+        if (!_pLoader->pAtlasOrder)
+            return tilemap_loader_fail(_pLoader);
+        _pLoader->uAtlasTile = 0;
+        _pLoader->uStage = TILEMAP_LOAD_STAGE_ATLAS_PACK;
+        return TILEMAP_LOAD_PENDING;
 
-fail:
-    if (pTileIds)
-    {
-        free(pTileIds);
-        pTileIds = NULL;
+    case TILEMAP_LOAD_STAGE_DONE:
+        return TILEMAP_LOAD_DONE;
+
+    default:
+        return TILEMAP_LOAD_FAILED;
     }
+}
+
+float tilemap_importer_load_progress(const tilemap_importer_loader_t *_pLoader)
+{
+    if (!_pLoader || !_pLoader->pImporter)
+        return 0.0f;
+
+    /* Fixed weights per stage: reading/parsing the layers dominates, then row index and mask */
+    const float fLayerCount = (float)_pLoader->pImporter->uLayerCount;
+    const uint16_t uMaskHeight = _pLoader->pImporter->collisionMask.uHeight;
+    const float fAtlasDone = (_pLoader->uTileCount > 0) ? (float)_pLoader->uAtlasTile / (float)_pLoader->uTileCount : 1.0f;
 
-    if (!bOk)
+    switch (_pLoader->uStage)
     {
-        tilemap_importer_free(_pImporter);
-        return false;
+    case TILEMAP_LOAD_STAGE_OPEN:
+    case TILEMAP_LOAD_STAGE_CSV_IDS:
+        return 0.0f;
+    case TILEMAP_LOAD_STAGE_READ:
+        return 0.6f * (float)_pLoader->uBlobRead / (float)_pLoader->uBlobSize;
+    case TILEMAP_LOAD_STAGE_PARSE:
+        return 0.6f;
+    case TILEMAP_LOAD_STAGE_CSV_LAYERS:
+        return 0.6f * (float)_pLoader->uLayer / fLayerCount;
+    case TILEMAP_LOAD_STAGE_ROW_INDEX:
+        return 0.65f + 0.1f * (float)_pLoader->uLayer / fLayerCount;
+    case TILEMAP_LOAD_STAGE_MASK:
+        return 0.75f + (uMaskHeight > 0 ? 0.15f * (float)_pLoader->uMaskRow / (float)uMaskHeight : 0.0f);
+    case TILEMAP_LOAD_STAGE_ATLAS:
+        return 0.9f;
+    case TILEMAP_LOAD_STAGE_ATLAS_SPRITES:
+        return 0.9f + 0.05f * fAtlasDone;
+    case TILEMAP_LOAD_STAGE_ATLAS_SORT:
+        return 0.95f;
+    case TILEMAP_LOAD_STAGE_ATLAS_PACK:
+        return 0.95f + 0.05f * fAtlasDone;
+    case TILEMAP_LOAD_STAGE_DONE:
+        return 1.0f;
+    default:
+        return 0.0f;
     }
+}
 
-    return true;
+void tilemap_importer_load_abort(tilemap_importer_loader_t *_pLoader)
+{
+    if (!_pLoader || !_pLoader->pImporter)
+        return;
+
+    if (_pLoader->uStage != TILEMAP_LOAD_STAGE_DONE && _pLoader->uStage != TILEMAP_LOAD_STAGE_FAILED)
+        tilemap_loader_fail(_pLoader);
+}
+
+bool tilemap_importer_init(tilemap_importer_t *_pImporter, const char *_pMapFolder, tilemap_type_t _eType)
+{
+    tilemap_importer_loader_t loader;
+    if (!tilemap_importer_load_begin(&loader, _pImporter, _pMapFolder, _eType))
+        return false;
+
+    tilemap_load_status_t eStatus;
+    do
+    {
+        eStatus = tilemap_importer_load_step(&loader);
+    } while (eStatus == TILEMAP_LOAD_PENDING);
+
+    return eStatus == TILEMAP_LOAD_DONE;
 }
 
 void tilemap_importer_free(tilemap_importer_t *_pImporter)
@@ -1104,11 +2270,78 @@ void tilemap_importer_free(tilemap_importer_t *_pImporter)
     for (uint8_t i = 0; i < TILEMAP_IMPORTER_MAX_LAYERS; ++i)
         free_layer(&_pImporter->aLayers[i]);
 
+    collision_mask_free(&_pImporter->collisionMask);
+    flat_layer_free(&_pImporter->flat);
+
+    /* Release .tmap buffer after the layers pointing into it */
+    if (_pImporter->pLayerBlob)
+    {
+        free(_pImporter->pLayerBlob);
+        _pImporter->pLayerBlob = NULL;
+    }
+    _pImporter->uLayerBlobSize = 0;
+
     _pImporter->uTileCount = 0;
     _pImporter->uAtlasPageCount = 0;
     _pImporter->bInitialized = false;
 }
 
+size_t tilemap_importer_resident_bytes(const tilemap_importer_t *_pImporter)
+{
+    if (!_pImporter || !_pImporter->bInitialized)
+        return 0;
+
+    /* Blob-backed layer data and baked atlas pages are counted once, with the .tmap buffer */
+    size_t uBytes = _pImporter->uLayerBlobSize;
+
+    for (uint8_t i = 0; i < _pImporter->uLayerCount; ++i)
+    {
+        const tilemap_layer_t *pLayer = &_pImporter->aLayers[i];
+        size_t uTiles = (size_t)pLayer->uWidth * (size_t)pLayer->uHeight;
+
+        if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_DENSE)
+        {
+            uBytes += (size_t)pLayer->uHeight * sizeof(uint8_t *);
+            if (!pLayer->bBlobData)
+                uBytes += uTiles;
+        }
+        else if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
+        {
+            if (!pLayer->bBlobData)
+                uBytes += (size_t)pLayer->sparse.uCapacity * sizeof(sparse_tile_entry_t);
+            if (pLayer->sparse.pRowStart)
+                uBytes += (size_t)(pLayer->sparse.uRowCount + 1) * sizeof(uint16_t) + (size_t)pLayer->sparse.uCount * (sizeof(uint16_t) + sizeof(uint8_t));
+        }
+        else if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED && !pLayer->bBlobData)
+        {
+            uBytes += tilemap_format_chunk_table_size(pLayer->uWidth, pLayer->uHeight) + (size_t)pLayer->uMixedChunkCount * TILEMAP_CHUNK_TILES;
+        }
+    }
+
+    uBytes += sizeof(uint32_t) * (size_t)_pImporter->collisionMask.uWordsPerRow * (size_t)_pImporter->collisionMask.uHeight;
+
+    uBytes += (size_t)_pImporter->uTileCount * (sizeof(tile_atlas_entry_t) + sizeof(tile_trimmed_rect_t));
+    uBytes += (size_t)_pImporter->uAtlasPageCount * sizeof(surface_t);
+    if (_pImporter->uAtlasPageCount > 0)
+    {
+        const uint8_t *pPixels = (const uint8_t *)_pImporter->pAtlasPages[0].buffer;
+        const uint8_t *pBlob = (const uint8_t *)_pImporter->pLayerBlob;
+        bool bPagesInBlob = pBlob && pPixels >= pBlob && pPixels < pBlob + _pImporter->uLayerBlobSize;
+        if (!bPagesInBlob)
+            uBytes += (size_t)_pImporter->uAtlasPageCount * TILE_ATLAS_PAGE_WIDTH * TILE_ATLAS_PAGE_HEIGHT * 2;
+    }
+
+    const tilemap_flat_layer_t *pFlat = &_pImporter->flat;
+    if (pFlat->bActive)
+    {
+        uBytes += (size_t)pFlat->layer.uWidth * pFlat->layer.uHeight + (size_t)pFlat->layer.uHeight * sizeof(uint8_t *);
+        uBytes += (size_t)pFlat->uTileCount * sizeof(tile_atlas_entry_t);
+        uBytes += (size_t)pFlat->uAtlasPageCount * (sizeof(surface_t) + TILE_ATLAS_PAGE_WIDTH * TILE_ATLAS_PAGE_HEIGHT * 2);
+    }
+
+    return uBytes;
+}
+
 sprite_t *tilemap_importer_get_tile_sprite(const tilemap_importer_t *_pImporter, uint8_t _uTileIndex)
 {
     if (!validate_tile_index(_pImporter, _uTileIndex))
@@ -1171,6 +2404,29 @@ const surface_t *tilemap_importer_get_atlas_page(const tilemap_importer_t *_pImp
     return &_pImporter->pAtlasPages[_uPageIndex];
 }
 
+bool tilemap_importer_get_flat_atlas_entry(const tilemap_importer_t *_pImporter, uint8_t _uTileIndex, tile_atlas_entry_t *_pOutEntry)
+{
+    if (!_pImporter || !_pOutEntry || !_pImporter->flat.bActive)
+        return false;
+
+    if (_uTileIndex >= _pImporter->flat.uTileCount)
+        return false;
+
+    *_pOutEntry = _pImporter->flat.pAtlasEntries[_uTileIndex];
+    return true;
+}
+
+const surface_t *tilemap_importer_get_flat_atlas_page(const tilemap_importer_t *_pImporter, uint8_t _uPageIndex)
+{
+    if (!_pImporter || !_pImporter->flat.bActive)
+        return NULL;
+
+    if (_uPageIndex >= _pImporter->flat.uAtlasPageCount)
+        return NULL;
+
+    return &_pImporter->flat.pAtlasPages[_uPageIndex];
+}
+
 void tilemap_importer_debug(const tilemap_importer_t *_pImporter)
 {
     if (!_pImporter)
@@ -1210,6 +2466,22 @@ void tilemap_importer_debug(const tilemap_importer_t *_pImporter)
                        fFillPercent,
                        (unsigned)uMemory);
             }
+            else if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+            {
+                uMemory = tilemap_format_chunk_table_size(pLayer->uWidth, pLayer->uHeight) + (uint32_t)pLayer->uMixedChunkCount * TILEMAP_CHUNK_TILES;
+                uint32_t uChunkCount = (uint32_t)pLayer->uChunksX * (uint32_t)pLayer->uChunksY;
+                float fSavingsPercent = (float)((int32_t)uTotalTiles - (int32_t)uMemory) / (float)uTotalTiles * 100.0f;
+                debugf("  Layer %u: CHUNKED %ux%u (%u tiles, %.1f%% fill, %u/%u mixed chunks, %u bytes, %.1f%% saved)\n",
+                       (unsigned)i,
+                       (unsigned)pLayer->uWidth,
+                       (unsigned)pLayer->uHeight,
+                       (unsigned)pLayer->uTileCount,
+                       fFillPercent,
+                       (unsigned)pLayer->uMixedChunkCount,
+                       (unsigned)uChunkCount,
+                       (unsigned)uMemory,
+                       fSavingsPercent);
+            }
             else if (pLayer->eStorage == TILEMAP_LAYER_STORAGE_SINGLE)
             {
                 debugf("  Layer %u: SINGLE %ux%u (TileID: %u, 0 bytes)\n", (unsigned)i, (unsigned)pLayer->uWidth, (unsigned)pLayer->uHeight, (unsigned)pLayer->uSingleTileId);
@@ -1217,6 +2489,8 @@ void tilemap_importer_debug(const tilemap_importer_t *_pImporter)
             else /* TILEMAP_LAYER_STORAGE_SPARSE */
             {
                 uMemory = (uint32_t)pLayer->sparse.uCapacity * sizeof(sparse_tile_entry_t);
+                if (pLayer->sparse.pRowStart)
+                    uMemory += (uint32_t)(pLayer->sparse.uRowCount + 1) * sizeof(uint16_t) + (uint32_t)pLayer->sparse.uCount * (sizeof(uint16_t) + sizeof(uint8_t));
                 uint32_t uDenseMemory = uTotalTiles;
                 float fSavingsPercent = (float)(uDenseMemory - uMemory) / (float)uDenseMemory * 100.0f;
                 debugf("  Layer %u: SPARSE %ux%u (%u tiles, %.1f%% fill, %u bytes, %.1f%% saved)\n",
@@ -1232,6 +2506,10 @@ void tilemap_importer_debug(const tilemap_importer_t *_pImporter)
             uTotalMemory += uMemory;
         }
 
+        uint32_t uMaskMemory = (uint32_t)sizeof(uint32_t) * _pImporter->collisionMask.uWordsPerRow * _pImporter->collisionMask.uHeight;
+        debugf("  Collision mask: %ux%u (%u bytes)\n", (unsigned)_pImporter->collisionMask.uWidth, (unsigned)_pImporter->collisionMask.uHeight, (unsigned)uMaskMemory);
+        uTotalMemory += uMaskMemory;
+
         debugf("  Total layer memory: %u bytes\n", (unsigned)uTotalMemory);
     }
 }
@@ -4,6 +4,7 @@
 #include "sprite.h"
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /* Maximum number of tiles that can be loaded (limited by uint8_t indexing) */
 #define TILEMAP_IMPORTER_MAX_TILES 255
@@ -15,6 +16,14 @@
 #define TILEMAP_LAYER_COUNT_SURFACE 5 /* Surface/Planet tilemaps use 5 layers */
 #define TILEMAP_LAYER_COUNT_JNR 4     /* JNR tilemaps use 4 layers */
 
+/* Collision layer configuration */
+#define TILEMAP_LAYER_JNR_COLLISION 2      /* JNR collision layer index */
+#define TILEMAP_LAYER_SURFACE_BACKGROUND 0 /* Surface background layer index (drawn only, never queried) */
+#define TILEMAP_LAYER_SURFACE_WALKABLE 1   /* Surface walkable/ground layer index */
+#define TILEMAP_LAYER_SURFACE_COLLISION 2  /* Surface collision/blocking layer index */
+#define TILEMAP_LAYER_SURFACE_DECO_BG 3    /* Surface decoration background layer (player overdraws) */
+#define TILEMAP_LAYER_SURFACE_DECO_FG 4    /* Surface decoration foreground layer (overdraws player) */
+
 /* Tilemap type enum - determines layer count and collision configuration */
 typedef enum
 {
@@ -54,9 +63,25 @@ typedef enum
 {
     TILEMAP_LAYER_STORAGE_DENSE = 0,  /* Full 2D array (optimal for densely filled layers) */
     TILEMAP_LAYER_STORAGE_SPARSE = 1, /* Hash table of non-empty tiles (optimal for sparse layers) */
-    TILEMAP_LAYER_STORAGE_SINGLE = 2  /* Single tile ID repeated across the entire layer (or all empty) */
+    TILEMAP_LAYER_STORAGE_SINGLE = 2, /* Single tile ID repeated across the entire layer (or all empty) */
+    TILEMAP_LAYER_STORAGE_CHUNKED = 3 /* 16x16 chunks, uniform (and empty) chunks stored as a single ID */
 } tilemap_layer_storage_t;
 
+/* Chunked layer geometry (must match TILEMAP_FORMAT_CHUNK_* in tilemap_format.h) */
+#define TILEMAP_CHUNK_SHIFT 4
+#define TILEMAP_CHUNK_SIZE (1 << TILEMAP_CHUNK_SHIFT)
+#define TILEMAP_CHUNK_MASK (TILEMAP_CHUNK_SIZE - 1)
+#define TILEMAP_CHUNK_TILES (TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE)
+#define TILEMAP_CHUNK_UNIFORM 0xFFFFu
+
+/* Chunk record - either a uniform tile ID or an index into the mixed chunk data */
+typedef struct
+{
+    uint16_t uDataIndex; /* Mixed chunk index (TILEMAP_CHUNK_UNIFORM if the whole chunk is uTileId) */
+    uint8_t uTileId;     /* Uniform tile ID (TILEMAP_IMPORTER_EMPTY_TILE for empty chunks) */
+    uint8_t uPadding;    /* Padding for alignment */
+} tilemap_chunk_t;
+
 /* Sparse tile entry - stores a single tile at a specific position */
 typedef struct
 {
@@ -72,6 +97,13 @@ typedef struct
     sparse_tile_entry_t *pEntries; /* Hash table entries (NULL if dense layer) */
     uint16_t uCapacity;            /* Hash table capacity (power of 2) */
     uint16_t uCount;               /* Number of non-empty tiles stored */
+
+    /* Row index (CSR), built at load time: the tiles of row y are
+     * pRowColumns / pRowTileIds [pRowStart[y] .. pRowStart[y + 1]), sorted by X */
+    uint16_t *pRowStart;   /* uRowCount + 1 offsets (owns the whole index allocation) */
+    uint16_t *pRowColumns; /* X coordinate per tile */
+    uint8_t *pRowTileIds;  /* Tile ID per tile */
+    uint16_t uRowCount;    /* Rows covered by the index (layer height) */
 } sparse_layer_data_t;
 
 /* Tilemap layer structure - supports both dense and sparse storage */
@@ -91,8 +123,53 @@ typedef struct
 
     /* Single storage (used when eStorage == TILEMAP_LAYER_STORAGE_SINGLE) */
     uint8_t uSingleTileId; /* Tile ID repeated across layer */
+
+    /* Chunked storage (used when eStorage == TILEMAP_LAYER_STORAGE_CHUNKED) */
+    tilemap_chunk_t *pChunks;   /* uChunksX * uChunksY chunk records, row-major (owns pChunkData unless blob-backed) */
+    uint8_t *pChunkData;        /* TILEMAP_CHUNK_TILES bytes (row-major) per mixed chunk */
+    uint16_t uChunksX;          /* Chunks per row (edge chunks are padded with empty tiles) */
+    uint16_t uChunksY;          /* Chunk rows */
+    uint16_t uMixedChunkCount;  /* Chunks with their own tile data */
+
+    bool bBlobData; /* pData / sparse.pEntries / pChunks point into the importer's .tmap blob (not freed per layer) */
 } tilemap_layer_t;
 
+/* Per-tile collision class, built once at load time from the collision-relevant layers */
+typedef enum
+{
+    TILEMAP_COLLISION_CODE_FREE = 0,           /* Nothing to collide with (SURFACE: ground without collision/deco tiles) */
+    TILEMAP_COLLISION_CODE_SOLID = 1,          /* Collision tile (SURFACE: on top of ground) */
+    TILEMAP_COLLISION_CODE_HOLE = 2,           /* SURFACE: no walkable tile (water/hole), other layers may still have tiles */
+    TILEMAP_COLLISION_CODE_LANDING_BLOCKED = 3 /* SURFACE: ground without collision tile, but decoration blocks landing */
+} tilemap_collision_code_t;
+
+/* Set of collision codes for tilemap_collision_mask_row_any */
+#define TILEMAP_COLLISION_SET(_eCode) ((uint8_t)(1u << (_eCode)))
+
+/* Packed collision layer: 2 bits per tile, 16 tiles per word (tile x at bits 2*(x & 15)), row-major */
+typedef struct
+{
+    uint32_t *pWords;      /* uWordsPerRow * uHeight words */
+    uint16_t uWordsPerRow; /* (uWidth + 15) / 16 */
+    uint16_t uWidth;       /* Width in tiles (same as the layers) */
+    uint16_t uHeight;      /* Height in tiles */
+} tilemap_collision_mask_t;
+
+/* Render-only composite of two layers drawn back-to-back (see tilemap_importer_flatten_layers): every distinct
+ * (lower, upper) tile pair is one tile of its own atlas, so a cell takes one rectangle instead of two.
+ * Collision and walk checks keep reading the original layers. */
+typedef struct
+{
+    tilemap_layer_t layer;             /* DENSE layer of composite tile IDs */
+    surface_t *pAtlasPages;            /* Composite atlas pages (RGBA16, 64x32 each) */
+    uint16_t uAtlasPageCount;          /* Number of allocated composite pages */
+    tile_atlas_entry_t *pAtlasEntries; /* Lookup table: composite tile ID -> {pageIndex, u0, v0} */
+    uint16_t uTileCount;               /* Number of composite tiles */
+    uint8_t uLowerLayer;               /* Layer drawn as the composite */
+    uint8_t uUpperLayer;               /* Layer folded into the composite (not drawn) */
+    bool bActive;                      /* Composite built */
+} tilemap_flat_layer_t;
+
 /* Tilemap importer structure */
 typedef struct
 {
@@ -108,11 +185,70 @@ typedef struct
     surface_t *pAtlasPages;            /* Array of atlas page surfaces (RGBA16, 64x32 each) */
     uint16_t uAtlasPageCount;          /* Number of allocated atlas pages */
     tile_atlas_entry_t *pAtlasEntries; /* Lookup table: tileId -> {pageIndex, u0, v0} */
+
+    /* Binary tilemap (.tmap) file buffer backing layer data, NULL when loaded from CSV */
+    void *pLayerBlob;
+    size_t uLayerBlobSize;
+
+    /* Collision classes of all tiles, so sweeps and walk checks read one array instead of up to four layers */
+    tilemap_collision_mask_t collisionMask;
+
+    /* Optional composite of two drawn layers (inactive unless tilemap_importer_flatten_layers succeeded) */
+    tilemap_flat_layer_t flat;
 } tilemap_importer_t;
 
+/* Load a tilemap folder. Prefers the pre-built rom:/<folder>/<folder>.tmap (see tools/tmap_convert.c),
+ * whose baked atlas pages are used in place; falls back to parsing tile_ids.csv and the <folder>_NN.csv
+ * layers and building the atlas from the tile sprites when it is missing. */
 bool tilemap_importer_init(tilemap_importer_t *_pImporter, const char *_pMapFolder, tilemap_type_t _eType);
+
+/* Staged loading: the same work as tilemap_importer_init split into short steps (a ROM read slice,
+ * one layer, a band of collision mask rows, a page of runtime atlas tiles, ...) so a load can be spread over
+ * several frames (tested headless by tests/tilemap_loader_test.c, make host-tests). */
+typedef enum
+{
+    TILEMAP_LOAD_PENDING = 0, /* More steps to run */
+    TILEMAP_LOAD_DONE,        /* Importer is fully initialized */
+    TILEMAP_LOAD_FAILED       /* Load failed, importer was freed */
+} tilemap_load_status_t;
+
+typedef struct
+{
+    tilemap_importer_t *pImporter; /* Importer being filled */
+    char szMapFolder[64];
+    FILE *pFile;       /* Open .tmap while reading */
+    uint8_t *pBlob;    /* .tmap buffer until parsed */
+    size_t uBlobSize;  /* .tmap file size */
+    size_t uBlobRead;  /* Bytes read so far */
+    int *pTileIds;     /* Tile index -> original tile ID, until the atlas is built */
+    struct tile_frequency_s *pAtlasOrder; /* Tiles by usage, until the runtime atlas is packed */
+    uint16_t uTileCount;
+    uint16_t uAtlasTile; /* Next tile of the current runtime atlas stage */
+    uint16_t uMaskRow; /* Next collision mask row to classify */
+    uint8_t uStage;    /* Current stage (internal) */
+    uint8_t uLayer;    /* Next layer of the current stage */
+    bool bFromTmap;
+    uint64_t uStartUs;
+} tilemap_importer_loader_t;
+
+bool tilemap_importer_load_begin(tilemap_importer_loader_t *_pLoader, tilemap_importer_t *_pImporter, const char *_pMapFolder, tilemap_type_t _eType);
+tilemap_load_status_t tilemap_importer_load_step(tilemap_importer_loader_t *_pLoader);
+float tilemap_importer_load_progress(const tilemap_importer_loader_t *_pLoader); /* 0..1 */
+void tilemap_importer_load_abort(tilemap_importer_loader_t *_pLoader);           /* Frees everything loaded so far */
 void tilemap_importer_free(tilemap_importer_t *_pImporter);
 
+/* Approximate heap bytes owned by a loaded importer (layers, .tmap buffer, collision mask, atlas) */
+size_t tilemap_importer_resident_bytes(const tilemap_importer_t *_pImporter);
+
+/* Precompose layer _uLowerLayer and the layer above it, _uUpperLayer (alpha-tested over the lower one), into _pImporter->flat.
+ * Fails and leaves the importer unchanged if the layers don't match in size, the lower layer is a single-tile fill
+ * (nothing to save) or there are more distinct tile pairs than tile IDs. */
+bool tilemap_importer_flatten_layers(tilemap_importer_t *_pImporter, uint8_t _uLowerLayer, uint8_t _uUpperLayer);
+
+/* Atlas lookups for composite tile IDs of the flattened layer (same contract as the regular atlas getters) */
+bool tilemap_importer_get_flat_atlas_entry(const tilemap_importer_t *_pImporter, uint8_t _uTileIndex, tile_atlas_entry_t *_pOutEntry);
+const surface_t *tilemap_importer_get_flat_atlas_page(const tilemap_importer_t *_pImporter, uint8_t _uPageIndex);
+
 sprite_t *tilemap_importer_get_tile_sprite(const tilemap_importer_t *_pImporter, uint8_t _uTileIndex);
 const tilemap_layer_t *tilemap_importer_get_layer(const tilemap_importer_t *_pImporter, uint8_t _uLayerIndex);
 
@@ -139,9 +275,17 @@ static inline uint8_t tilemap_layer_get_tile(const tilemap_layer_t *_pLayer, int
         /* Dense: Direct array access */
         return _pLayer->ppData[_iY][_iX];
     }
+    else if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_CHUNKED)
+    {
+        /* Chunked: uniform chunks answer from the chunk record, mixed chunks index their tile block */
+        const tilemap_chunk_t *pChunk = &_pLayer->pChunks[(_iY >> TILEMAP_CHUNK_SHIFT) * _pLayer->uChunksX + (_iX >> TILEMAP_CHUNK_SHIFT)];
+        if (pChunk->uDataIndex == TILEMAP_CHUNK_UNIFORM)
+            return pChunk->uTileId;
+        return _pLayer->pChunkData[((uint32_t)pChunk->uDataIndex << (2 * TILEMAP_CHUNK_SHIFT)) + ((_iY & TILEMAP_CHUNK_MASK) << TILEMAP_CHUNK_SHIFT) + (_iX & TILEMAP_CHUNK_MASK)];
+    }
     else if (_pLayer->eStorage == TILEMAP_LAYER_STORAGE_SPARSE)
     {
-        /* Sparse: Hash table lookup - extern function in .c file */
+        /* Sparse: Row index lookup - extern function in .c file */
         extern uint8_t tilemap_layer_sparse_get(const sparse_layer_data_t *_pSparse, uint16_t _uX, uint16_t _uY);
         return tilemap_layer_sparse_get(&_pLayer->sparse, (uint16_t)_iX, (uint16_t)_iY);
     }
@@ -152,4 +296,24 @@ static inline uint8_t tilemap_layer_get_tile(const tilemap_layer_t *_pLayer, int
     }
 }
 
+/* Collision code of tile (x, y). Coordinates must be within bounds. */
+static inline tilemap_collision_code_t tilemap_collision_mask_get(const tilemap_collision_mask_t *_pMask, int _iX, int _iY)
+{
+    uint32_t uWord = _pMask->pWords[_iY * _pMask->uWordsPerRow + (_iX >> 4)];
+    return (tilemap_collision_code_t)((uWord >> ((_iX & 15) << 1)) & 3u);
+}
+
+/* Returns true if any tile in row _iY with X in [_iX0, _iX1] has a code in _uCodeSet (TILEMAP_COLLISION_SET bits).
+ * Tests 16 tiles per word. Coordinates must be within bounds. */
+bool tilemap_collision_mask_row_any(const tilemap_collision_mask_t *_pMask, int _iY, int _iX0, int _iX1, uint8_t _uCodeSet);
+
+/* Returns true if no tile in the layer rectangle [_iX0, _iX1] x [_iY0, _iY1] can be non-empty.
+ * Chunked layers answer per chunk, so collision and culling reject whole empty chunks at once;
+ * other storages only report true when the entire layer is empty. Coordinates must be within bounds. */
+bool tilemap_layer_region_is_empty(const tilemap_layer_t *_pLayer, int _iX0, int _iY0, int _iX1, int _iY1);
+
+/* Get the row index range [*_pOutBegin, *_pOutEnd) of the sparse tiles in row _uY with X in [_uX0, _uX1].
+ * Indices refer to pRowColumns / pRowTileIds; the range is empty if the row is out of bounds. */
+void tilemap_layer_sparse_row_span(const sparse_layer_data_t *_pSparse, uint16_t _uY, uint16_t _uX0, uint16_t _uX1, uint16_t *_pOutBegin, uint16_t *_pOutEnd);
+
 void tilemap_importer_debug(const tilemap_importer_t *_pImporter);
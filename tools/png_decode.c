@@ -0,0 +1,540 @@
+/* png_decode.c - minimal PNG decoder for host tools.
+ * Inflate follows the classic canonical-Huffman "puff" approach: small and slow, which is fine
+ * for build-time conversion of 16x16 tiles. */
+
+#include "png_decode.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INFLATE_MAX_BITS 15
+#define INFLATE_MAX_LCODES 286
+#define INFLATE_MAX_DCODES 30
+#define INFLATE_FIX_LCODES 288
+
+typedef struct
+{
+    const uint8_t *pSrc;
+    size_t uSrcLen;
+    size_t uSrcPos;
+    uint32_t uBitBuf;
+    int iBitCount;
+
+    uint8_t *pDst;
+    size_t uDstLen;
+    size_t uDstPos;
+
+    bool bError;
+} inflate_state_t;
+
+typedef struct
+{
+    uint16_t aCount[INFLATE_MAX_BITS + 1];
+    uint16_t aSymbol[INFLATE_FIX_LCODES];
+} huffman_t;
+
+/* ---------- Inflate ---------- */
+
+static uint32_t inflate_bits(inflate_state_t *_pState, int _iNeed)
+{
+    uint32_t uVal = _pState->uBitBuf;
+    while (_pState->iBitCount < _iNeed)
+    {
+        if (_pState->uSrcPos >= _pState->uSrcLen)
+        {
+            _pState->bError = true;
+            return 0;
+        }
+        uVal |= (uint32_t)_pState->pSrc[_pState->uSrcPos++] << _pState->iBitCount;
+        _pState->iBitCount += 8;
+    }
+
+    _pState->uBitBuf = (uint32_t)(uVal >> _iNeed);
+    _pState->iBitCount -= _iNeed;
+    return uVal & ((1u << _iNeed) - 1u);
+}
+
+static bool inflate_put(inflate_state_t *_pState, uint8_t _uByte)
+{
+    if (_pState->uDstPos >= _pState->uDstLen)
+    {
+        _pState->bError = true;
+        return false;
+    }
+    _pState->pDst[_pState->uDstPos++] = _uByte;
+    return true;
+}
+
+static bool inflate_stored(inflate_state_t *_pState)
+{
+    /* Discard leftover bits, then LEN / NLEN */
+    _pState->uBitBuf = 0;
+    _pState->iBitCount = 0;
+
+    if (_pState->uSrcPos + 4 > _pState->uSrcLen)
+        return false;
+
+    uint32_t uLen = _pState->pSrc[_pState->uSrcPos] | ((uint32_t)_pState->pSrc[_pState->uSrcPos + 1] << 8);
+    uint32_t uNLen = _pState->pSrc[_pState->uSrcPos + 2] | ((uint32_t)_pState->pSrc[_pState->uSrcPos + 3] << 8);
+    _pState->uSrcPos += 4;
+
+    if (uLen != (~uNLen & 0xFFFF) || _pState->uSrcPos + uLen > _pState->uSrcLen)
+        return false;
+
+    while (uLen--)
+    {
+        if (!inflate_put(_pState, _pState->pSrc[_pState->uSrcPos++]))
+            return false;
+    }
+    return true;
+}
+
+static int inflate_decode(inflate_state_t *_pState, const huffman_t *_pHuff)
+{
+    int iCode = 0;
+    int iFirst = 0;
+    int iIndex = 0;
+
+    for (int iLen = 1; iLen <= INFLATE_MAX_BITS; ++iLen)
+    {
+        iCode |= (int)inflate_bits(_pState, 1);
+        if (_pState->bError)
+            return -1;
+
+        int iCount = _pHuff->aCount[iLen];
+        if (iCode - iCount < iFirst)
+            return _pHuff->aSymbol[iIndex + (iCode - iFirst)];
+
+        iIndex += iCount;
+        iFirst += iCount;
+        iFirst <<= 1;
+        iCode <<= 1;
+    }
+
+    return -1;
+}
+
+static void inflate_construct(huffman_t *_pHuff, const uint16_t *_pLengths, int _iCount)
+{
+    uint16_t aOffs[INFLATE_MAX_BITS + 1];
+
+    memset(_pHuff->aCount, 0, sizeof(_pHuff->aCount));
+    for (int iSym = 0; iSym < _iCount; ++iSym)
+        _pHuff->aCount[_pLengths[iSym]]++;
+
+    aOffs[1] = 0;
+    for (int iLen = 1; iLen < INFLATE_MAX_BITS; ++iLen)
+        aOffs[iLen + 1] = (uint16_t)(aOffs[iLen] + _pHuff->aCount[iLen]);
+
+    for (int iSym = 0; iSym < _iCount; ++iSym)
+    {
+        if (_pLengths[iSym] != 0)
+            _pHuff->aSymbol[aOffs[_pLengths[iSym]]++] = (uint16_t)iSym;
+    }
+}
+
+static bool inflate_codes(inflate_state_t *_pState, const huffman_t *_pLenCode, const huffman_t *_pDistCode)
+{
+    static const uint16_t s_aLenBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t s_aLenExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t s_aDistBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                             193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t s_aDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    while (true)
+    {
+        int iSym = inflate_decode(_pState, _pLenCode);
+        if (iSym < 0)
+            return false;
+
+        if (iSym < 256)
+        {
+            if (!inflate_put(_pState, (uint8_t)iSym))
+                return false;
+            continue;
+        }
+
+        if (iSym == 256)
+            return true;
+
+        iSym -= 257;
+        if (iSym >= 29)
+            return false;
+
+        uint32_t uLen = s_aLenBase[iSym] + inflate_bits(_pState, s_aLenExtra[iSym]);
+
+        int iDistSym = inflate_decode(_pState, _pDistCode);
+        if (iDistSym < 0 || iDistSym >= 30)
+            return false;
+
+        uint32_t uDist = s_aDistBase[iDistSym] + inflate_bits(_pState, s_aDistExtra[iDistSym]);
+        if (_pState->bError || uDist > _pState->uDstPos)
+            return false;
+
+        while (uLen--)
+        {
+            if (!inflate_put(_pState, _pState->pDst[_pState->uDstPos - uDist]))
+                return false;
+        }
+    }
+}
+
+static bool inflate_fixed(inflate_state_t *_pState)
+{
+    huffman_t lenCode, distCode;
+    uint16_t aLengths[INFLATE_FIX_LCODES];
+
+    int iSym = 0;
+    for (; iSym < 144; ++iSym)
+        aLengths[iSym] = 8;
+    for (; iSym < 256; ++iSym)
+        aLengths[iSym] = 9;
+    for (; iSym < 280; ++iSym)
+        aLengths[iSym] = 7;
+    for (; iSym < INFLATE_FIX_LCODES; ++iSym)
+        aLengths[iSym] = 8;
+    inflate_construct(&lenCode, aLengths, INFLATE_FIX_LCODES);
+
+    for (iSym = 0; iSym < INFLATE_MAX_DCODES; ++iSym)
+        aLengths[iSym] = 5;
+    inflate_construct(&distCode, aLengths, INFLATE_MAX_DCODES);
+
+    return inflate_codes(_pState, &lenCode, &distCode);
+}
+
+static bool inflate_dynamic(inflate_state_t *_pState)
+{
+    static const uint8_t s_aOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    huffman_t lenCode, distCode;
+    uint16_t aLengths[INFLATE_MAX_LCODES + INFLATE_MAX_DCODES];
+
+    int iNLen = (int)inflate_bits(_pState, 5) + 257;
+    int iNDist = (int)inflate_bits(_pState, 5) + 1;
+    int iNCode = (int)inflate_bits(_pState, 4) + 4;
+    if (_pState->bError || iNLen > INFLATE_MAX_LCODES || iNDist > INFLATE_MAX_DCODES)
+        return false;
+
+    memset(aLengths, 0, sizeof(aLengths));
+    for (int i = 0; i < iNCode; ++i)
+        aLengths[s_aOrder[i]] = (uint16_t)inflate_bits(_pState, 3);
+    inflate_construct(&lenCode, aLengths, 19);
+
+    int iIndex = 0;
+    while (iIndex < iNLen + iNDist)
+    {
+        int iSym = inflate_decode(_pState, &lenCode);
+        if (iSym < 0)
+            return false;
+
+        if (iSym < 16)
+        {
+            aLengths[iIndex++] = (uint16_t)iSym;
+            continue;
+        }
+
+        uint16_t uRepeatLen = 0;
+        int iRepeat;
+        if (iSym == 16)
+        {
+            if (iIndex == 0)
+                return false;
+            uRepeatLen = aLengths[iIndex - 1];
+            iRepeat = 3 + (int)inflate_bits(_pState, 2);
+        }
+        else if (iSym == 17)
+        {
+            iRepeat = 3 + (int)inflate_bits(_pState, 3);
+        }
+        else
+        {
+            iRepeat = 11 + (int)inflate_bits(_pState, 7);
+        }
+
+        if (iIndex + iRepeat > iNLen + iNDist)
+            return false;
+        while (iRepeat--)
+            aLengths[iIndex++] = uRepeatLen;
+    }
+
+    if (aLengths[256] == 0)
+        return false;
+
+    inflate_construct(&lenCode, aLengths, iNLen);
+    inflate_construct(&distCode, aLengths + iNLen, iNDist);
+
+    return inflate_codes(_pState, &lenCode, &distCode);
+}
+
+/* Inflate a zlib stream (header + deflate blocks, Adler-32 ignored) */
+static bool zlib_inflate(const uint8_t *_pSrc, size_t _uSrcLen, uint8_t *_pDst, size_t _uDstLen)
+{
+    if (_uSrcLen < 2 || (_pSrc[0] & 0x0F) != 8 || ((_pSrc[0] << 8) | _pSrc[1]) % 31 != 0 || (_pSrc[1] & 0x20))
+        return false;
+
+    inflate_state_t state;
+    memset(&state, 0, sizeof(state));
+    state.pSrc = _pSrc + 2;
+    state.uSrcLen = _uSrcLen - 2;
+    state.pDst = _pDst;
+    state.uDstLen = _uDstLen;
+
+    bool bLast = false;
+    while (!bLast)
+    {
+        bLast = inflate_bits(&state, 1) != 0;
+        uint32_t uType = inflate_bits(&state, 2);
+        if (state.bError)
+            return false;
+
+        bool bOk;
+        if (uType == 0)
+            bOk = inflate_stored(&state);
+        else if (uType == 1)
+            bOk = inflate_fixed(&state);
+        else if (uType == 2)
+            bOk = inflate_dynamic(&state);
+        else
+            bOk = false;
+
+        if (!bOk || state.bError)
+            return false;
+    }
+
+    return state.uDstPos == _uDstLen;
+}
+
+/* ---------- PNG ---------- */
+
+static uint32_t read_be32(const uint8_t *_p)
+{
+    return ((uint32_t)_p[0] << 24) | ((uint32_t)_p[1] << 16) | ((uint32_t)_p[2] << 8) | (uint32_t)_p[3];
+}
+
+static uint8_t paeth(uint8_t _a, uint8_t _b, uint8_t _c)
+{
+    int p = (int)_a + (int)_b - (int)_c;
+    int pa = abs(p - (int)_a);
+    int pb = abs(p - (int)_b);
+    int pc = abs(p - (int)_c);
+    if (pa <= pb && pa <= pc)
+        return _a;
+    if (pb <= pc)
+        return _b;
+    return _c;
+}
+
+static bool png_unfilter(uint8_t *_pRaw, uint32_t _uHeight, uint32_t _uRowBytes, uint32_t _uBpp)
+{
+    uint8_t *pPrev = NULL;
+    for (uint32_t y = 0; y < _uHeight; ++y)
+    {
+        uint8_t *pLine = _pRaw + (size_t)y * (_uRowBytes + 1);
+        uint8_t uFilter = pLine[0];
+        uint8_t *pRow = pLine + 1;
+
+        for (uint32_t x = 0; x < _uRowBytes; ++x)
+        {
+            uint8_t a = (x >= _uBpp) ? pRow[x - _uBpp] : 0;
+            uint8_t b = pPrev ? pPrev[x] : 0;
+            uint8_t c = (pPrev && x >= _uBpp) ? pPrev[x - _uBpp] : 0;
+
+            switch (uFilter)
+            {
+            case 0:
+                break;
+            case 1:
+                pRow[x] = (uint8_t)(pRow[x] + a);
+                break;
+            case 2:
+                pRow[x] = (uint8_t)(pRow[x] + b);
+                break;
+            case 3:
+                pRow[x] = (uint8_t)(pRow[x] + (uint8_t)(((int)a + (int)b) / 2));
+                break;
+            case 4:
+                pRow[x] = (uint8_t)(pRow[x] + paeth(a, b, c));
+                break;
+            default:
+                return false;
+            }
+        }
+        pPrev = pRow;
+    }
+    return true;
+}
+
+bool png_decode_file(const char *_pPath, uint8_t **_ppOutRGBA, uint32_t *_pOutWidth, uint32_t *_pOutHeight)
+{
+    static const uint8_t s_aSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    *_ppOutRGBA = NULL;
+
+    FILE *pFile = fopen(_pPath, "rb");
+    if (!pFile)
+    {
+        fprintf(stderr, "png_decode: cannot open %s\n", _pPath);
+        return false;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    long iSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    uint8_t *pFileData = (uint8_t *)malloc((size_t)iSize);
+    if (!pFileData || fread(pFileData, 1, (size_t)iSize, pFile) != (size_t)iSize || iSize < 8 || memcmp(pFileData, s_aSignature, 8) != 0)
+    {
+        fprintf(stderr, "png_decode: %s is not a PNG file\n", _pPath);
+        fclose(pFile);
+        free(pFileData);
+        return false;
+    }
+    fclose(pFile);
+
+    uint32_t uWidth = 0, uHeight = 0;
+    uint8_t uBitDepth = 0, uColorType = 0, uInterlace = 0;
+    uint8_t aPalette[256][4];
+    memset(aPalette, 0xFF, sizeof(aPalette));
+
+    uint8_t *pIdat = NULL;
+    size_t uIdatLen = 0;
+    bool bOk = true;
+
+    size_t uPos = 8;
+    while (bOk && uPos + 12 <= (size_t)iSize)
+    {
+        uint32_t uLen = read_be32(pFileData + uPos);
+        const uint8_t *pType = pFileData + uPos + 4;
+        const uint8_t *pData = pFileData + uPos + 8;
+        if (uPos + 12 + uLen > (size_t)iSize)
+        {
+            bOk = false;
+            break;
+        }
+
+        if (memcmp(pType, "IHDR", 4) == 0 && uLen >= 13)
+        {
+            uWidth = read_be32(pData);
+            uHeight = read_be32(pData + 4);
+            uBitDepth = pData[8];
+            uColorType = pData[9];
+            uInterlace = pData[12];
+        }
+        else if (memcmp(pType, "PLTE", 4) == 0)
+        {
+            for (uint32_t i = 0; i < uLen / 3 && i < 256; ++i)
+            {
+                aPalette[i][0] = pData[i * 3 + 0];
+                aPalette[i][1] = pData[i * 3 + 1];
+                aPalette[i][2] = pData[i * 3 + 2];
+            }
+        }
+        else if (memcmp(pType, "tRNS", 4) == 0 && uColorType == 3)
+        {
+            for (uint32_t i = 0; i < uLen && i < 256; ++i)
+                aPalette[i][3] = pData[i];
+        }
+        else if (memcmp(pType, "IDAT", 4) == 0)
+        {
+            uint8_t *pNew = (uint8_t *)realloc(pIdat, uIdatLen + uLen);
+            if (!pNew)
+            {
+                bOk = false;
+                break;
+            }
+            pIdat = pNew;
+            memcpy(pIdat + uIdatLen, pData, uLen);
+            uIdatLen += uLen;
+        }
+        else if (memcmp(pType, "IEND", 4) == 0)
+        {
+            break;
+        }
+
+        uPos += 12 + uLen;
+    }
+    free(pFileData);
+
+    uint32_t uChannels = 0;
+    switch (uColorType)
+    {
+    case 0:
+        uChannels = 1;
+        break;
+    case 2:
+        uChannels = 3;
+        break;
+    case 3:
+        uChannels = 1;
+        break;
+    case 4:
+        uChannels = 2;
+        break;
+    case 6:
+        uChannels = 4;
+        break;
+    default:
+        break;
+    }
+
+    if (!bOk || !pIdat || uWidth == 0 || uHeight == 0 || uBitDepth != 8 || uInterlace != 0 || uChannels == 0)
+    {
+        fprintf(stderr, "png_decode: unsupported PNG %s (%ux%u, depth %u, color type %u, interlace %u)\n", _pPath, uWidth, uHeight, uBitDepth, uColorType, uInterlace);
+        free(pIdat);
+        return false;
+    }
+
+    uint32_t uRowBytes = uWidth * uChannels;
+    size_t uRawLen = (size_t)(uRowBytes + 1) * uHeight;
+    uint8_t *pRaw = (uint8_t *)malloc(uRawLen);
+    uint8_t *pRGBA = (uint8_t *)malloc((size_t)uWidth * uHeight * 4);
+
+    if (!pRaw || !pRGBA || !zlib_inflate(pIdat, uIdatLen, pRaw, uRawLen) || !png_unfilter(pRaw, uHeight, uRowBytes, uChannels))
+    {
+        fprintf(stderr, "png_decode: corrupt image data in %s\n", _pPath);
+        free(pIdat);
+        free(pRaw);
+        free(pRGBA);
+        return false;
+    }
+    free(pIdat);
+
+    for (uint32_t y = 0; y < uHeight; ++y)
+    {
+        const uint8_t *pRow = pRaw + (size_t)y * (uRowBytes + 1) + 1;
+        for (uint32_t x = 0; x < uWidth; ++x)
+        {
+            uint8_t *pOut = pRGBA + ((size_t)y * uWidth + x) * 4;
+            const uint8_t *pIn = pRow + (size_t)x * uChannels;
+            switch (uColorType)
+            {
+            case 0:
+                pOut[0] = pOut[1] = pOut[2] = pIn[0];
+                pOut[3] = 0xFF;
+                break;
+            case 2:
+                pOut[0] = pIn[0];
+                pOut[1] = pIn[1];
+                pOut[2] = pIn[2];
+                pOut[3] = 0xFF;
+                break;
+            case 3:
+                memcpy(pOut, aPalette[pIn[0]], 4);
+                break;
+            case 4:
+                pOut[0] = pOut[1] = pOut[2] = pIn[0];
+                pOut[3] = pIn[1];
+                break;
+            default:
+                memcpy(pOut, pIn, 4);
+                break;
+            }
+        }
+    }
+    free(pRaw);
+
+    *_ppOutRGBA = pRGBA;
+    *_pOutWidth = uWidth;
+    *_pOutHeight = uHeight;
+    return true;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+/* Minimal PNG decoder for host tools (no external dependencies).
+ * Supports non-interlaced 8-bit grayscale, grayscale+alpha, RGB, RGBA and palette images,
+ * which covers everything exported for the tile assets. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Decode a PNG file into a tightly packed RGBA8888 buffer (caller frees *_ppOutRGBA with free()).
+ * Returns false and prints a message to stderr on unsupported or malformed files. */
+bool png_decode_file(const char *_pPath, uint8_t **_ppOutRGBA, uint32_t *_pOutWidth, uint32_t *_pOutHeight);
@@ -0,0 +1,565 @@
+/* tmap_check.c - host tool: checks a .tmap written by tmap_convert against its source asset folder.
+ *
+ * Usage: tmap_check <asset folder> <file.tmap>
+ * Example: tmap_check assets/cave build/tests/cave.tmap
+ *
+ * Reads the file with its own big-endian readers (it does not share code with the converter or the
+ * importer) and validates the header, every offset and size against the file bounds, then decodes each
+ * layer through its storage kind (dense, sparse hash lookup, single, chunked) and compares every cell
+ * with the <name>_NN.csv layers remapped through tile_ids.csv. The baked atlas is checked against the
+ * tile PNGs: every tile has its own 16x16 page slot holding its RGBA16 pixels and the trimmed rect of
+ * its alpha bit. Run over all maps by "make host-tests"; exits non-zero on the first broken map. */
+
+#include "../tilemap_format.h"
+#include "png_decode.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Keep in sync with tilemap_importer.h */
+#define TMAP_MAX_TILES 255
+#define TMAP_EMPTY_TILE 255
+#define TMAP_SPARSE_ENTRY_EMPTY 0xFFFF
+#define TMAP_SPARSE_ENTRY_SIZE 6
+#define TMAP_STORAGE_DENSE 0
+#define TMAP_STORAGE_SPARSE 1
+#define TMAP_STORAGE_SINGLE 2
+#define TMAP_STORAGE_CHUNKED 3
+
+/* Keep in sync with TILE_ATLAS_* in tilemap_importer.h */
+#define TMAP_TILE_SIZE 16
+#define TMAP_ATLAS_PAGE_WIDTH 64
+#define TMAP_ATLAS_PAGE_HEIGHT 32
+#define TMAP_ATLAS_TILES_PER_PAGE 8
+#define TMAP_ATLAS_ENTRY_SIZE 3
+#define TMAP_TRIMMED_RECT_SIZE 16
+
+/* Header field offsets (tilemap_format_header_t) */
+#define TMAP_HEADER_LAYERS_OFFSET 16
+#define TMAP_HEADER_ATLAS_OFFSET 116
+
+typedef struct
+{
+    const uint8_t *pData;
+    size_t uSize;
+} tmap_file_t;
+
+typedef struct
+{
+    uint16_t uWidth;
+    uint16_t uHeight;
+    uint8_t *pData; /* uWidth * uHeight remapped tile IDs */
+} tmap_csv_layer_t;
+
+static const char *m_pMapName = "";
+
+/* Prints "tmap_check: <map>: <message>" and returns false */
+static bool fail(const char *_pFormat, ...) __attribute__((format(printf, 1, 2)));
+static bool fail(const char *_pFormat, ...)
+{
+    va_list args;
+    va_start(args, _pFormat);
+    fprintf(stderr, "tmap_check: %s: ", m_pMapName);
+    vfprintf(stderr, _pFormat, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    return false;
+}
+
+/* ---------- Input (big-endian readers) ---------- */
+
+static uint8_t read_u8(const tmap_file_t *_pFile, size_t _uOffset)
+{
+    return _pFile->pData[_uOffset];
+}
+
+static uint16_t read_u16(const tmap_file_t *_pFile, size_t _uOffset)
+{
+    return (uint16_t)((_pFile->pData[_uOffset] << 8) | _pFile->pData[_uOffset + 1]);
+}
+
+static uint32_t read_u32(const tmap_file_t *_pFile, size_t _uOffset)
+{
+    return ((uint32_t)_pFile->pData[_uOffset] << 24) | ((uint32_t)_pFile->pData[_uOffset + 1] << 16) | ((uint32_t)_pFile->pData[_uOffset + 2] << 8) |
+           (uint32_t)_pFile->pData[_uOffset + 3];
+}
+
+/* True if [_uOffset, _uOffset + _uSize) lies in the file and _uOffset is aligned */
+static bool range_ok(const tmap_file_t *_pFile, uint32_t _uOffset, uint64_t _uSize)
+{
+    return (_uOffset % TILEMAP_FORMAT_ALIGN) == 0 && (uint64_t)_uOffset + _uSize <= _pFile->uSize;
+}
+
+static uint8_t *read_file(const char *_pPath, size_t *_pOutSize, bool _bText)
+{
+    FILE *pFile = fopen(_pPath, "rb");
+    if (!pFile)
+        return NULL;
+
+    fseek(pFile, 0, SEEK_END);
+    long iSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    uint8_t *pData = (uint8_t *)malloc((size_t)iSize + 1);
+    if (!pData)
+    {
+        fclose(pFile);
+        return NULL;
+    }
+
+    size_t uRead = fread(pData, 1, (size_t)iSize, pFile);
+    fclose(pFile);
+    if (_bText)
+        pData[uRead] = '\0';
+    *_pOutSize = uRead;
+    return pData;
+}
+
+/* ---------- Source CSVs ---------- */
+
+static int cmp_int_asc(const void *_pA, const void *_pB)
+{
+    const int a = *(const int *)_pA;
+    const int b = *(const int *)_pB;
+    return (a > b) - (a < b);
+}
+
+static bool load_tile_ids(const char *_pFolder, int *_pTileIds, uint16_t *_pTileCount)
+{
+    char szPath[512];
+    snprintf(szPath, sizeof(szPath), "%s/tile_ids.csv", _pFolder);
+
+    size_t uSize = 0;
+    char *pText = (char *)read_file(szPath, &uSize, true);
+    if (!pText)
+        return fail("cannot read %s", szPath);
+
+    uint16_t uCount = 0;
+    for (char *pCursor = pText; *pCursor;)
+    {
+        char *pEnd = NULL;
+        long iValue = strtol(pCursor, &pEnd, 10);
+        if (pEnd == pCursor)
+        {
+            pCursor++;
+            continue;
+        }
+        if (uCount >= TMAP_MAX_TILES)
+        {
+            free(pText);
+            return fail("too many tile IDs in %s (%d max)", szPath, TMAP_MAX_TILES);
+        }
+        _pTileIds[uCount++] = (int)iValue;
+        pCursor = pEnd;
+    }
+    free(pText);
+
+    qsort(_pTileIds, uCount, sizeof(int), cmp_int_asc);
+    *_pTileCount = uCount;
+    return true;
+}
+
+/* Returns false if the layer file does not exist or does not parse (*_pbError tells which) */
+static bool load_csv_layer(const char *_pFolder, const char *_pName, int _iLayer, const int *_pTileIds, uint16_t _uTileCount, tmap_csv_layer_t *_pOut,
+                           bool *_pbError)
+{
+    char szPath[512];
+    snprintf(szPath, sizeof(szPath), "%s/%s_%02d.csv", _pFolder, _pName, _iLayer);
+
+    *_pbError = false;
+    size_t uSize = 0;
+    char *pText = (char *)read_file(szPath, &uSize, true);
+    if (!pText)
+        return false;
+
+    /* Width from the first line, height from the non-empty line count */
+    uint16_t uWidth = 0;
+    uint16_t uHeight = 0;
+    for (char *pLine = pText; *pLine;)
+    {
+        char *pEol = pLine + strcspn(pLine, "\r\n");
+        if (pEol != pLine)
+        {
+            if (uHeight == 0)
+            {
+                uWidth = 1;
+                for (char *p = pLine; p < pEol; ++p)
+                    uWidth += (*p == ',');
+            }
+            uHeight++;
+        }
+        pLine = pEol + strspn(pEol, "\r\n");
+    }
+
+    size_t uTotal = (size_t)uWidth * uHeight;
+    uint8_t *pData = (uint8_t *)malloc(uTotal ? uTotal : 1);
+    size_t uIndex = 0;
+    for (char *pCursor = pText; pData && *pCursor && uIndex < uTotal;)
+    {
+        char *pEnd = NULL;
+        long iTileId = strtol(pCursor, &pEnd, 10);
+        if (pEnd == pCursor)
+        {
+            pCursor++;
+            continue;
+        }
+        pCursor = pEnd;
+
+        int iKey = (int)iTileId;
+        const int *pFound = (const int *)bsearch(&iKey, _pTileIds, _uTileCount, sizeof(int), cmp_int_asc);
+        if (iTileId != -1 && !pFound)
+        {
+            free(pData);
+            free(pText);
+            *_pbError = true;
+            return fail("%s: tile ID %ld not in tile_ids.csv", szPath, iTileId);
+        }
+        pData[uIndex++] = (iTileId == -1) ? TMAP_EMPTY_TILE : (uint8_t)(pFound - _pTileIds);
+    }
+    free(pText);
+
+    if (!pData || uTotal == 0 || uIndex != uTotal)
+    {
+        free(pData);
+        *_pbError = true;
+        return fail("%s: %ld values, expected %ld", szPath, (long)uIndex, (long)uTotal);
+    }
+
+    _pOut->uWidth = uWidth;
+    _pOut->uHeight = uHeight;
+    _pOut->pData = pData;
+    return true;
+}
+
+/* ---------- Layer decoding ---------- */
+
+/* Sparse hash lookup with linear probing, as the runtime does it */
+static uint8_t sparse_lookup(const tmap_file_t *_pFile, uint32_t _uOffset, uint16_t _uCapacity, uint16_t _uX, uint16_t _uY)
+{
+    uint16_t uIndex = (uint16_t)(tilemap_format_hash_coord(_uX, _uY) & (uint32_t)(_uCapacity - 1));
+    for (uint16_t uProbe = 0; uProbe < _uCapacity; ++uProbe)
+    {
+        size_t uEntry = _uOffset + (size_t)uIndex * TMAP_SPARSE_ENTRY_SIZE;
+        uint16_t uEntryX = read_u16(_pFile, uEntry + 0);
+        if (uEntryX == TMAP_SPARSE_ENTRY_EMPTY)
+            return TMAP_EMPTY_TILE;
+        if (uEntryX == _uX && read_u16(_pFile, uEntry + 2) == _uY)
+            return read_u8(_pFile, uEntry + 4);
+        uIndex = (uIndex + 1) & (_uCapacity - 1);
+    }
+    return TMAP_EMPTY_TILE;
+}
+
+static bool check_sparse_table(const tmap_file_t *_pFile, uint32_t _uOffset, uint16_t _uCapacity, uint16_t _uCount, const tmap_csv_layer_t *_pCsv)
+{
+    if (_uCapacity < TILEMAP_FORMAT_SPARSE_MIN_CAPACITY || (_uCapacity & (_uCapacity - 1)) != 0)
+        return fail("sparse capacity %d is not a power of 2 >= %d", _uCapacity, TILEMAP_FORMAT_SPARSE_MIN_CAPACITY);
+
+    uint16_t uUsed = 0;
+    for (uint16_t i = 0; i < _uCapacity; ++i)
+    {
+        size_t uEntry = _uOffset + (size_t)i * TMAP_SPARSE_ENTRY_SIZE;
+        uint16_t uX = read_u16(_pFile, uEntry + 0);
+        if (uX == TMAP_SPARSE_ENTRY_EMPTY)
+            continue;
+        if (uX >= _pCsv->uWidth || read_u16(_pFile, uEntry + 2) >= _pCsv->uHeight)
+            return fail("sparse entry %d points outside the layer (x %d)", i, uX);
+        uUsed++;
+    }
+    if (uUsed != _uCount)
+        return fail("sparse table holds %d entries, record says %d", uUsed, _uCount);
+    if (uUsed >= _uCapacity)
+        return fail("sparse table is full (%d of %d), lookups of empty cells would not terminate", uUsed, _uCapacity);
+    return true;
+}
+
+/* Tile at (_uX, _uY) through the chunk table; *_pbOk is cleared on an out-of-range data index */
+static uint8_t chunked_lookup(const tmap_file_t *_pFile, uint32_t _uOffset, uint16_t _uWidth, uint16_t _uHeight, uint32_t _uMixedCount, uint16_t _uX,
+                              uint16_t _uY, bool *_pbOk)
+{
+    uint32_t uChunksX = ((uint32_t)_uWidth + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT;
+    uint32_t uChunk = ((uint32_t)_uY >> TILEMAP_FORMAT_CHUNK_SHIFT) * uChunksX + ((uint32_t)_uX >> TILEMAP_FORMAT_CHUNK_SHIFT);
+    size_t uRecord = _uOffset + (size_t)uChunk * TILEMAP_FORMAT_CHUNK_RECORD_SIZE;
+
+    uint16_t uDataIndex = read_u16(_pFile, uRecord);
+    if (uDataIndex == TILEMAP_FORMAT_CHUNK_UNIFORM)
+        return read_u8(_pFile, uRecord + 2);
+    if (uDataIndex >= _uMixedCount)
+    {
+        *_pbOk = false;
+        return TMAP_EMPTY_TILE;
+    }
+
+    size_t uPool = _uOffset + tilemap_format_chunk_table_size(_uWidth, _uHeight);
+    uint32_t uLocal = ((uint32_t)(_uY & TILEMAP_FORMAT_CHUNK_MASK) << TILEMAP_FORMAT_CHUNK_SHIFT) | (_uX & TILEMAP_FORMAT_CHUNK_MASK);
+    return read_u8(_pFile, uPool + (size_t)uDataIndex * TILEMAP_FORMAT_CHUNK_TILES + uLocal);
+}
+
+static bool check_layer(const tmap_file_t *_pFile, uint8_t _uLayer, const tmap_csv_layer_t *_pCsv)
+{
+    size_t uRecord = TMAP_HEADER_LAYERS_OFFSET + (size_t)_uLayer * sizeof(tilemap_format_layer_t);
+    uint8_t uStorage = read_u8(_pFile, uRecord + 0);
+    uint8_t uSingleTileId = read_u8(_pFile, uRecord + 1);
+    uint16_t uWidth = read_u16(_pFile, uRecord + 2);
+    uint16_t uHeight = read_u16(_pFile, uRecord + 4);
+    uint16_t uTileCount = read_u16(_pFile, uRecord + 6);
+    uint16_t uSparseCapacity = read_u16(_pFile, uRecord + 8);
+    uint16_t uSparseCount = read_u16(_pFile, uRecord + 10);
+    uint32_t uDataOffset = read_u32(_pFile, uRecord + 12);
+    uint32_t uDataSize = read_u32(_pFile, uRecord + 16);
+    uint32_t uTotal = (uint32_t)uWidth * uHeight;
+    uint32_t uMixedCount = 0;
+
+    if (uWidth != _pCsv->uWidth || uHeight != _pCsv->uHeight)
+        return fail("layer is %dx%d but the CSV is %dx%d", uWidth, uHeight, _pCsv->uWidth, _pCsv->uHeight);
+
+    switch (uStorage)
+    {
+    case TMAP_STORAGE_DENSE:
+        if (uDataSize != uTotal || !range_ok(_pFile, uDataOffset, uDataSize))
+            return fail("dense payload at %ld (%ld bytes) is out of bounds or misaligned", (long)uDataOffset, (long)uDataSize);
+        break;
+    case TMAP_STORAGE_SPARSE:
+        if (uDataSize != (uint32_t)uSparseCapacity * TMAP_SPARSE_ENTRY_SIZE || !range_ok(_pFile, uDataOffset, uDataSize))
+            return fail("sparse payload at %ld (%ld bytes) is out of bounds or misaligned", (long)uDataOffset, (long)uDataSize);
+        if (!check_sparse_table(_pFile, uDataOffset, uSparseCapacity, uSparseCount, _pCsv))
+            return false;
+        break;
+    case TMAP_STORAGE_SINGLE:
+        if (uSingleTileId != TMAP_EMPTY_TILE && uSingleTileId >= read_u16(_pFile, 6))
+            return fail("single tile ID %d is past the tile table (%d)", uSingleTileId, read_u16(_pFile, 6));
+        break;
+    case TMAP_STORAGE_CHUNKED:
+    {
+        uint32_t uTableSize = tilemap_format_chunk_table_size(uWidth, uHeight);
+        if (uDataSize < uTableSize || (uDataSize - uTableSize) % TILEMAP_FORMAT_CHUNK_TILES != 0 || !range_ok(_pFile, uDataOffset, uDataSize))
+            return fail("chunked payload at %ld (%ld bytes) is out of bounds, misaligned or not whole chunks", (long)uDataOffset, (long)uDataSize);
+        uMixedCount = (uDataSize - uTableSize) / TILEMAP_FORMAT_CHUNK_TILES;
+        break;
+    }
+    default:
+        return fail("unknown storage kind %u", (unsigned)uStorage);
+    }
+
+    uint32_t uNonEmpty = 0;
+    bool bOk = true;
+    for (uint16_t y = 0; y < uHeight; ++y)
+    {
+        for (uint16_t x = 0; x < uWidth; ++x)
+        {
+            uint8_t uTileId = TMAP_EMPTY_TILE;
+            if (uStorage == TMAP_STORAGE_DENSE)
+                uTileId = read_u8(_pFile, uDataOffset + (size_t)y * uWidth + x);
+            else if (uStorage == TMAP_STORAGE_SPARSE)
+                uTileId = sparse_lookup(_pFile, uDataOffset, uSparseCapacity, x, y);
+            else if (uStorage == TMAP_STORAGE_SINGLE)
+                uTileId = uSingleTileId;
+            else
+                uTileId = chunked_lookup(_pFile, uDataOffset, uWidth, uHeight, uMixedCount, x, y, &bOk);
+
+            if (!bOk)
+                return fail("chunk data index out of range at x %d, y %d", x, y);
+            if (uTileId != _pCsv->pData[(size_t)y * uWidth + x])
+                return fail("cell mismatch at x %d, y %d", x, y);
+            uNonEmpty += (uTileId != TMAP_EMPTY_TILE);
+        }
+    }
+
+    if (uNonEmpty != uTileCount)
+        return fail("layer has %ld non-empty tiles, record says %d", (long)uNonEmpty, uTileCount);
+    return true;
+}
+
+/* ---------- Atlas ---------- */
+
+static uint16_t rgba8_to_rgba16(const uint8_t *_pPixel)
+{
+    return (uint16_t)(((_pPixel[0] >> 3) << 11) | ((_pPixel[1] >> 3) << 6) | ((_pPixel[2] >> 3) << 1) | (_pPixel[3] > 127 ? 1 : 0));
+}
+
+/* Page slot pixels and trimmed rect of one tile against <folder>/<id>.png */
+static bool check_atlas_tile(const tmap_file_t *_pFile, const char *_pFolder, int _iTileId, size_t _uPage, uint8_t _uU0, uint8_t _uV0, size_t _uRect)
+{
+    char szPath[512];
+    snprintf(szPath, sizeof(szPath), "%s/%d.png", _pFolder, _iTileId);
+
+    uint8_t *pRGBA = NULL;
+    uint32_t uWidth = 0, uHeight = 0;
+    if (!png_decode_file(szPath, &pRGBA, &uWidth, &uHeight))
+        return fail("cannot decode %s", szPath);
+
+    bool bOk = uWidth >= TMAP_TILE_SIZE && uHeight >= TMAP_TILE_SIZE;
+    for (uint32_t y = 0; bOk && y < TMAP_TILE_SIZE; ++y)
+    {
+        for (uint32_t x = 0; bOk && x < TMAP_TILE_SIZE; ++x)
+        {
+            size_t uPixel = _uPage + ((size_t)(_uV0 + y) * TMAP_ATLAS_PAGE_WIDTH + _uU0 + x) * 2;
+            bOk = read_u16(_pFile, uPixel) == rgba8_to_rgba16(pRGBA + ((size_t)y * uWidth + x) * 4);
+        }
+    }
+
+    int32_t iMinX = (int32_t)uWidth, iMinY = (int32_t)uHeight, iMaxX = -1, iMaxY = -1;
+    for (uint32_t y = 0; bOk && y < uHeight; ++y)
+    {
+        for (uint32_t x = 0; x < uWidth; ++x)
+        {
+            if (pRGBA[((size_t)y * uWidth + x) * 4 + 3] <= 127)
+                continue;
+            iMinX = (int32_t)x < iMinX ? (int32_t)x : iMinX;
+            iMaxX = (int32_t)x > iMaxX ? (int32_t)x : iMaxX;
+            iMinY = (int32_t)y < iMinY ? (int32_t)y : iMinY;
+            iMaxY = (int32_t)y > iMaxY ? (int32_t)y : iMaxY;
+        }
+    }
+    free(pRGBA);
+
+    if (!bOk)
+        return fail("%s: atlas pixels differ from the PNG (%ldx%ld)", szPath, (long)uWidth, (long)uHeight);
+
+    int32_t aExpected[4] = {0, 0, 0, 0};
+    if (iMaxX >= 0)
+    {
+        aExpected[0] = iMinX;
+        aExpected[1] = iMinY;
+        aExpected[2] = iMaxX - iMinX + 1;
+        aExpected[3] = iMaxY - iMinY + 1;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        if ((int32_t)read_u32(_pFile, _uRect + (size_t)i * 4) != aExpected[i])
+            return fail("%s: trimmed rect field %d is %ld", szPath, i, (long)(int32_t)read_u32(_pFile, _uRect + (size_t)i * 4));
+    }
+    return true;
+}
+
+static bool check_atlas(const tmap_file_t *_pFile, const char *_pFolder, const int *_pTileIds, uint16_t _uTileCount)
+{
+    uint16_t uPageCount = read_u16(_pFile, TMAP_HEADER_ATLAS_OFFSET);
+    uint32_t uPagesOffset = read_u32(_pFile, TMAP_HEADER_ATLAS_OFFSET + 4);
+    uint32_t uEntriesOffset = read_u32(_pFile, TMAP_HEADER_ATLAS_OFFSET + 8);
+    uint32_t uRectsOffset = read_u32(_pFile, TMAP_HEADER_ATLAS_OFFSET + 12);
+
+    /* tmap_convert always bakes; a runtime-built atlas (0 pages) would be a converter regression */
+    if (uPageCount == 0 || uPageCount > (TMAP_MAX_TILES + TMAP_ATLAS_TILES_PER_PAGE - 1) / TMAP_ATLAS_TILES_PER_PAGE)
+        return fail("bad atlas page count %d (%d tiles)", uPageCount, _uTileCount);
+    if (!range_ok(_pFile, uPagesOffset, (uint64_t)uPageCount * TILEMAP_FORMAT_ATLAS_PAGE_BYTES) ||
+        !range_ok(_pFile, uEntriesOffset, (uint64_t)_uTileCount * TMAP_ATLAS_ENTRY_SIZE) ||
+        !range_ok(_pFile, uRectsOffset, (uint64_t)_uTileCount * TMAP_TRIMMED_RECT_SIZE))
+        return fail("atlas tables out of bounds or misaligned (pages at %ld, entries at %ld)", (long)uPagesOffset, (long)uEntriesOffset);
+
+    uint8_t aSlotUsed[(TMAP_MAX_TILES + TMAP_ATLAS_TILES_PER_PAGE - 1) / TMAP_ATLAS_TILES_PER_PAGE][TMAP_ATLAS_TILES_PER_PAGE];
+    memset(aSlotUsed, 0, sizeof(aSlotUsed));
+
+    for (uint16_t i = 0; i < _uTileCount; ++i)
+    {
+        size_t uEntry = uEntriesOffset + (size_t)i * TMAP_ATLAS_ENTRY_SIZE;
+        uint8_t uPage = read_u8(_pFile, uEntry + 0);
+        uint8_t uU0 = read_u8(_pFile, uEntry + 1);
+        uint8_t uV0 = read_u8(_pFile, uEntry + 2);
+
+        if (uPage >= uPageCount || uU0 % TMAP_TILE_SIZE || uV0 % TMAP_TILE_SIZE || uU0 + TMAP_TILE_SIZE > TMAP_ATLAS_PAGE_WIDTH ||
+            uV0 + TMAP_TILE_SIZE > TMAP_ATLAS_PAGE_HEIGHT)
+            return fail("atlas entry of tile %d is not a page slot (page %d)", i, uPage);
+
+        uint8_t uSlot = (uint8_t)((uV0 / TMAP_TILE_SIZE) * (TMAP_ATLAS_PAGE_WIDTH / TMAP_TILE_SIZE) + uU0 / TMAP_TILE_SIZE);
+        if (aSlotUsed[uPage][uSlot])
+            return fail("tile %d shares atlas page %d slot with another tile", i, uPage);
+        aSlotUsed[uPage][uSlot] = 1;
+
+        size_t uPageBase = uPagesOffset + (size_t)uPage * TILEMAP_FORMAT_ATLAS_PAGE_BYTES;
+        if (!check_atlas_tile(_pFile, _pFolder, _pTileIds[i], uPageBase, uU0, uV0, uRectsOffset + (size_t)i * TMAP_TRIMMED_RECT_SIZE))
+            return false;
+    }
+    return true;
+}
+
+/* ---------- Main ---------- */
+
+static bool check_map(const char *_pFolder, const char *_pName, const tmap_file_t *_pFile)
+{
+    if (_pFile->uSize < sizeof(tilemap_format_header_t))
+        return fail("file is %ld bytes, smaller than the header (%ld)", (long)_pFile->uSize, (long)sizeof(tilemap_format_header_t));
+    if (read_u32(_pFile, 0) != TILEMAP_FORMAT_MAGIC || read_u16(_pFile, 4) != TILEMAP_FORMAT_VERSION)
+        return fail("bad magic or version %d (expected %d)", read_u16(_pFile, 4), TILEMAP_FORMAT_VERSION);
+
+    int aTileIds[TMAP_MAX_TILES];
+    uint16_t uTileCount = 0;
+    if (!load_tile_ids(_pFolder, aTileIds, &uTileCount))
+        return false;
+
+    uint16_t uFileTileCount = read_u16(_pFile, 6);
+    uint32_t uTileIdsOffset = read_u32(_pFile, 12);
+    if (uFileTileCount != uTileCount || !range_ok(_pFile, uTileIdsOffset, (uint64_t)uTileCount * 2))
+        return fail("tile table has %d IDs (tile_ids.csv: %d) or is out of bounds", uFileTileCount, uTileCount);
+    for (uint16_t i = 0; i < uTileCount; ++i)
+    {
+        if (read_u16(_pFile, uTileIdsOffset + (size_t)i * 2) != (uint16_t)aTileIds[i])
+            return fail("tile table entry %d is %d", i, read_u16(_pFile, uTileIdsOffset + (size_t)i * 2));
+    }
+
+    uint8_t uLayerCount = read_u8(_pFile, 8);
+    if (uLayerCount == 0 || uLayerCount > TILEMAP_FORMAT_MAX_LAYERS)
+        return fail("bad layer count %d (max %d)", uLayerCount, TILEMAP_FORMAT_MAX_LAYERS);
+
+    uint8_t uCsvLayers = 0;
+    for (int iLayer = 0; iLayer < TILEMAP_FORMAT_MAX_LAYERS; ++iLayer)
+    {
+        tmap_csv_layer_t csv = {0};
+        bool bError = false;
+        if (!load_csv_layer(_pFolder, _pName, iLayer, aTileIds, uTileCount, &csv, &bError))
+        {
+            if (bError)
+                return false;
+            break;
+        }
+        uCsvLayers++;
+
+        bool bOk = iLayer < uLayerCount && check_layer(_pFile, (uint8_t)iLayer, &csv);
+        free(csv.pData);
+        if (!bOk)
+            return iLayer < uLayerCount ? fail("in layer %d", iLayer) : fail("CSV layer %d is missing from the file", iLayer);
+    }
+    if (uCsvLayers != uLayerCount)
+        return fail("file has %d layers, folder has %d", uLayerCount, uCsvLayers);
+
+    return check_atlas(_pFile, _pFolder, aTileIds, uTileCount);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <asset folder> <file.tmap>\n", argv[0]);
+        return 1;
+    }
+
+    const char *pFolder = argv[1];
+
+    /* Map name = last path component of the folder */
+    char szName[256];
+    const char *pSlash = strrchr(pFolder, '/');
+    snprintf(szName, sizeof(szName), "%s", pSlash ? pSlash + 1 : pFolder);
+    size_t uNameLen = strlen(szName);
+    while (uNameLen > 0 && szName[uNameLen - 1] == '/')
+        szName[--uNameLen] = '\0';
+    m_pMapName = szName;
+
+    tmap_file_t file = {0};
+    uint8_t *pData = read_file(argv[2], &file.uSize, false);
+    if (!pData)
+    {
+        fprintf(stderr, "tmap_check: cannot read %s\n", argv[2]);
+        return 1;
+    }
+    file.pData = pData;
+
+    bool bOk = check_map(pFolder, szName, &file);
+    free(pData);
+    if (!bOk)
+        return 1;
+
+    printf("tmap_check: %s OK (%zu bytes)\n", szName, file.uSize);
+    return 0;
+}
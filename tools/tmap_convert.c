@@ -0,0 +1,944 @@
+/* tmap_convert.c - host tool: converts a tilemap folder (tile_ids.csv + <name>_NN.csv layers
+ * + <id>.png tiles) into the binary .tmap format read by tilemap_importer.c.
+ *
+ * Usage: tmap_convert <asset folder> <output.tmap>
+ * Example: tmap_convert assets/cave filesystem/cave/cave.tmap
+ *
+ * Mirrors the runtime CSV importer exactly: tile IDs are sorted ascending and remapped to their
+ * index, storage kind (dense/sparse/single) is chosen with the same thresholds and sparse hash
+ * tables are built with the same hash and insertion order.
+ *
+ * The tile atlas is baked here as well: tiles are converted to RGBA16, trimmed rects are computed
+ * from the alpha bit and tiles are packed into 64x32 pages so the runtime only points surfaces into
+ * the loaded file. Pages are filled by co-visibility: each page is seeded with the most used unpacked
+ * tile and grown with the tiles that most often sit next to its members (4-neighbours and the same
+ * cell on other layers), so a screen binds fewer pages. The expected pages per screen over a camera
+ * sweep is printed for both the plain frequency order and the packed order.
+ *
+ * tools/tmap_check.c verifies the output against the source folder ("make host-tests"). */
+
+#include "../tilemap_format.h"
+#include "png_decode.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Keep in sync with tilemap_importer.h */
+#define TMAP_MAX_TILES 255
+#define TMAP_EMPTY_TILE 255
+#define TMAP_SPARSE_ENTRY_EMPTY 0xFFFF
+#define TMAP_SPARSE_ENTRY_SIZE 6
+#define TMAP_STORAGE_DENSE 0
+#define TMAP_STORAGE_SPARSE 1
+#define TMAP_STORAGE_SINGLE 2
+#define TMAP_STORAGE_CHUNKED 3
+
+/* Keep in sync with TILE_ATLAS_* in tilemap_importer.h */
+#define TMAP_TILE_SIZE 16
+#define TMAP_ATLAS_TILES_PER_PAGE 8
+#define TMAP_ATLAS_TILES_PER_ROW 4
+#define TMAP_ATLAS_PAGE_WIDTH 64
+#define TMAP_ATLAS_PAGE_HEIGHT 32
+#define TMAP_ATLAS_MAX_PAGES ((TMAP_MAX_TILES + TMAP_ATLAS_TILES_PER_PAGE - 1) / TMAP_ATLAS_TILES_PER_PAGE)
+#define TMAP_ATLAS_NO_PAGE 255
+#define TMAP_ATLAS_ENTRY_SIZE 3
+#define TMAP_TRIMMED_RECT_SIZE 16
+
+/* Camera sweep for the pages-per-screen report: 320x240 view, sampled every 4 tiles */
+#define TMAP_SWEEP_VIEW_TILES_X 20
+#define TMAP_SWEEP_VIEW_TILES_Y 15
+#define TMAP_SWEEP_STEP_TILES 4
+
+typedef struct
+{
+    uint16_t uWidth;
+    uint16_t uHeight;
+    uint8_t *pData; /* uWidth * uHeight remapped tile IDs */
+} tmap_layer_src_t;
+
+typedef struct
+{
+    uint8_t *pData;
+    size_t uSize;
+    size_t uCapacity;
+} tmap_buffer_t;
+
+typedef struct
+{
+    uint16_t aPixels[TMAP_TILE_SIZE * TMAP_TILE_SIZE]; /* Top-left 16x16 region as RGBA16 (5551) */
+    int32_t iOffsetX, iOffsetY;                        /* Trimmed rect over the whole image */
+    int32_t iSizeX, iSizeY;
+} tmap_tile_t;
+
+typedef struct
+{
+    uint8_t uTileId;
+    uint32_t uFrequency;
+} tmap_frequency_t;
+
+static int cmp_int_asc(const void *_pA, const void *_pB)
+{
+    const int a = *(const int *)_pA;
+    const int b = *(const int *)_pB;
+    return (a > b) - (a < b);
+}
+
+static int cmp_frequency_desc(const void *_pA, const void *_pB)
+{
+    const tmap_frequency_t *pA = (const tmap_frequency_t *)_pA;
+    const tmap_frequency_t *pB = (const tmap_frequency_t *)_pB;
+    if (pB->uFrequency != pA->uFrequency)
+        return (pB->uFrequency > pA->uFrequency) ? 1 : -1;
+    return (pA->uTileId > pB->uTileId) - (pA->uTileId < pB->uTileId);
+}
+
+/* ---------- Output buffer (big-endian writers) ---------- */
+
+static void buffer_reserve(tmap_buffer_t *_pBuf, size_t _uSize)
+{
+    if (_uSize <= _pBuf->uCapacity)
+        return;
+
+    size_t uNewCapacity = _pBuf->uCapacity ? _pBuf->uCapacity : 4096;
+    while (uNewCapacity < _uSize)
+        uNewCapacity *= 2;
+
+    _pBuf->pData = (uint8_t *)realloc(_pBuf->pData, uNewCapacity);
+    if (!_pBuf->pData)
+    {
+        fprintf(stderr, "tmap_convert: out of memory\n");
+        exit(1);
+    }
+    memset(_pBuf->pData + _pBuf->uCapacity, 0, uNewCapacity - _pBuf->uCapacity);
+    _pBuf->uCapacity = uNewCapacity;
+}
+
+static void buffer_put_u8(tmap_buffer_t *_pBuf, size_t _uOffset, uint8_t _uValue)
+{
+    buffer_reserve(_pBuf, _uOffset + 1);
+    _pBuf->pData[_uOffset] = _uValue;
+}
+
+static void buffer_put_u16(tmap_buffer_t *_pBuf, size_t _uOffset, uint16_t _uValue)
+{
+    buffer_reserve(_pBuf, _uOffset + 2);
+    _pBuf->pData[_uOffset + 0] = (uint8_t)(_uValue >> 8);
+    _pBuf->pData[_uOffset + 1] = (uint8_t)(_uValue & 0xFF);
+}
+
+static void buffer_put_u32(tmap_buffer_t *_pBuf, size_t _uOffset, uint32_t _uValue)
+{
+    buffer_reserve(_pBuf, _uOffset + 4);
+    _pBuf->pData[_uOffset + 0] = (uint8_t)(_uValue >> 24);
+    _pBuf->pData[_uOffset + 1] = (uint8_t)((_uValue >> 16) & 0xFF);
+    _pBuf->pData[_uOffset + 2] = (uint8_t)((_uValue >> 8) & 0xFF);
+    _pBuf->pData[_uOffset + 3] = (uint8_t)(_uValue & 0xFF);
+}
+
+static size_t buffer_align(tmap_buffer_t *_pBuf)
+{
+    size_t uAligned = (_pBuf->uSize + TILEMAP_FORMAT_ALIGN - 1) & ~(size_t)(TILEMAP_FORMAT_ALIGN - 1);
+    buffer_reserve(_pBuf, uAligned);
+    _pBuf->uSize = uAligned;
+    return uAligned;
+}
+
+/* ---------- CSV reading ---------- */
+
+static char *read_text_file(const char *_pPath)
+{
+    FILE *pFile = fopen(_pPath, "rb");
+    if (!pFile)
+        return NULL;
+
+    fseek(pFile, 0, SEEK_END);
+    long iSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    char *pText = (char *)malloc((size_t)iSize + 1);
+    if (!pText)
+    {
+        fclose(pFile);
+        return NULL;
+    }
+
+    size_t uRead = fread(pText, 1, (size_t)iSize, pFile);
+    fclose(pFile);
+    pText[uRead] = '\0';
+    return pText;
+}
+
+static bool load_tile_ids(const char *_pFolder, int *_pTileIds, uint16_t *_pTileCount)
+{
+    char szPath[512];
+    snprintf(szPath, sizeof(szPath), "%s/tile_ids.csv", _pFolder);
+
+    char *pText = read_text_file(szPath);
+    if (!pText)
+    {
+        fprintf(stderr, "tmap_convert: cannot read %s\n", szPath);
+        return false;
+    }
+
+    uint16_t uCount = 0;
+    char *pCursor = pText;
+    while (*pCursor)
+    {
+        char *pEnd = NULL;
+        long iValue = strtol(pCursor, &pEnd, 10);
+        if (pEnd == pCursor)
+        {
+            pCursor++;
+            continue;
+        }
+
+        if (uCount >= TMAP_MAX_TILES)
+        {
+            fprintf(stderr, "tmap_convert: too many tile IDs in %s (max %d)\n", szPath, TMAP_MAX_TILES);
+            free(pText);
+            return false;
+        }
+
+        _pTileIds[uCount++] = (int)iValue;
+        pCursor = pEnd;
+    }
+    free(pText);
+
+    if (uCount == 0)
+    {
+        fprintf(stderr, "tmap_convert: no tile IDs in %s\n", szPath);
+        return false;
+    }
+
+    qsort(_pTileIds, uCount, sizeof(int), cmp_int_asc);
+    *_pTileCount = uCount;
+    return true;
+}
+
+/* Returns false if the layer file does not exist; exits on malformed data */
+static bool load_layer(const char *_pFolder, const char *_pName, int _iLayer, const int *_pTileIds, uint16_t _uTileCount, tmap_layer_src_t *_pOut)
+{
+    char szPath[512];
+    snprintf(szPath, sizeof(szPath), "%s/%s_%02d.csv", _pFolder, _pName, _iLayer);
+
+    char *pText = read_text_file(szPath);
+    if (!pText)
+        return false;
+
+    /* Dimensions: width from first line, height from non-empty line count */
+    uint16_t uWidth = 0;
+    uint16_t uHeight = 0;
+    for (char *pLine = pText; *pLine;)
+    {
+        char *pEol = pLine + strcspn(pLine, "\r\n");
+        if (pEol != pLine)
+        {
+            uint16_t uLineWidth = 1;
+            for (char *p = pLine; p < pEol; ++p)
+                if (*p == ',')
+                    uLineWidth++;
+
+            if (uHeight == 0)
+                uWidth = uLineWidth;
+            else if (uLineWidth != uWidth)
+            {
+                fprintf(stderr, "tmap_convert: %s line %u has inconsistent width: %u vs %u\n", szPath, (unsigned)(uHeight + 1), (unsigned)uLineWidth, (unsigned)uWidth);
+                exit(1);
+            }
+            uHeight++;
+        }
+        pLine = pEol + strspn(pEol, "\r\n");
+    }
+
+    if (uWidth == 0 || uHeight == 0)
+    {
+        fprintf(stderr, "tmap_convert: empty or invalid CSV file: %s\n", szPath);
+        exit(1);
+    }
+
+    uint8_t *pData = (uint8_t *)malloc((size_t)uWidth * uHeight);
+    if (!pData)
+    {
+        fprintf(stderr, "tmap_convert: out of memory\n");
+        exit(1);
+    }
+
+    size_t uIndex = 0;
+    char *pCursor = pText;
+    while (uIndex < (size_t)uWidth * uHeight)
+    {
+        char *pEnd = NULL;
+        long iTileId = strtol(pCursor, &pEnd, 10);
+        if (pEnd == pCursor)
+        {
+            if (*pCursor == '\0')
+                break;
+            pCursor++;
+            continue;
+        }
+        pCursor = pEnd;
+
+        if (iTileId == -1)
+        {
+            pData[uIndex++] = TMAP_EMPTY_TILE;
+            continue;
+        }
+
+        int iKey = (int)iTileId;
+        const int *pFound = (const int *)bsearch(&iKey, _pTileIds, _uTileCount, sizeof(int), cmp_int_asc);
+        if (!pFound)
+        {
+            fprintf(stderr, "tmap_convert: tile ID %d in %s not found in tile_ids.csv\n", iKey, szPath);
+            exit(1);
+        }
+        pData[uIndex++] = (uint8_t)(pFound - _pTileIds);
+    }
+    free(pText);
+
+    if (uIndex != (size_t)uWidth * uHeight)
+    {
+        fprintf(stderr, "tmap_convert: %s has %zu values, expected %u\n", szPath, uIndex, (unsigned)(uWidth * uHeight));
+        exit(1);
+    }
+
+    _pOut->uWidth = uWidth;
+    _pOut->uHeight = uHeight;
+    _pOut->pData = pData;
+    return true;
+}
+
+/* ---------- Layer encoding ---------- */
+
+static void write_sparse_payload(tmap_buffer_t *_pBuf, size_t _uOffset, const tmap_layer_src_t *_pLayer, uint16_t _uCapacity, uint16_t *_pOutCount)
+{
+    /* Build hash table in host memory first, then serialize (same probing as sparse_layer_insert) */
+    uint16_t *pX = (uint16_t *)malloc(sizeof(uint16_t) * _uCapacity);
+    uint16_t *pY = (uint16_t *)malloc(sizeof(uint16_t) * _uCapacity);
+    uint8_t *pId = (uint8_t *)malloc(_uCapacity);
+    if (!pX || !pY || !pId)
+    {
+        fprintf(stderr, "tmap_convert: out of memory\n");
+        exit(1);
+    }
+
+    for (uint16_t i = 0; i < _uCapacity; ++i)
+    {
+        pX[i] = TMAP_SPARSE_ENTRY_EMPTY;
+        pY[i] = TMAP_SPARSE_ENTRY_EMPTY;
+        pId[i] = TMAP_EMPTY_TILE;
+    }
+
+    uint16_t uCount = 0;
+    for (uint16_t y = 0; y < _pLayer->uHeight; ++y)
+    {
+        for (uint16_t x = 0; x < _pLayer->uWidth; ++x)
+        {
+            uint8_t uTileId = _pLayer->pData[(size_t)y * _pLayer->uWidth + x];
+            if (uTileId == TMAP_EMPTY_TILE)
+                continue;
+
+            uint16_t uIndex = (uint16_t)(tilemap_format_hash_coord(x, y) & (uint32_t)(_uCapacity - 1));
+            while (pX[uIndex] != TMAP_SPARSE_ENTRY_EMPTY)
+                uIndex = (uIndex + 1) & (_uCapacity - 1);
+
+            pX[uIndex] = x;
+            pY[uIndex] = y;
+            pId[uIndex] = uTileId;
+            uCount++;
+        }
+    }
+
+    for (uint16_t i = 0; i < _uCapacity; ++i)
+    {
+        size_t uEntry = _uOffset + (size_t)i * TMAP_SPARSE_ENTRY_SIZE;
+        buffer_put_u16(_pBuf, uEntry + 0, pX[i]);
+        buffer_put_u16(_pBuf, uEntry + 2, pY[i]);
+        buffer_put_u8(_pBuf, uEntry + 4, pId[i]);
+        buffer_put_u8(_pBuf, uEntry + 5, 0);
+    }
+
+    free(pX);
+    free(pY);
+    free(pId);
+    *_pOutCount = uCount;
+}
+
+/* Returns true if all in-bounds tiles of chunk (_uChunkX, _uChunkY) share one ID (written to *_pOutTileId) */
+static bool chunk_is_uniform(const tmap_layer_src_t *_pLayer, uint16_t _uChunkX, uint16_t _uChunkY, uint8_t *_pOutTileId)
+{
+    uint32_t uX0 = (uint32_t)_uChunkX * TILEMAP_FORMAT_CHUNK_SIZE;
+    uint32_t uY0 = (uint32_t)_uChunkY * TILEMAP_FORMAT_CHUNK_SIZE;
+    uint32_t uX1 = uX0 + TILEMAP_FORMAT_CHUNK_SIZE < _pLayer->uWidth ? uX0 + TILEMAP_FORMAT_CHUNK_SIZE : _pLayer->uWidth;
+    uint32_t uY1 = uY0 + TILEMAP_FORMAT_CHUNK_SIZE < _pLayer->uHeight ? uY0 + TILEMAP_FORMAT_CHUNK_SIZE : _pLayer->uHeight;
+    uint8_t uRefTileId = _pLayer->pData[uY0 * _pLayer->uWidth + uX0];
+
+    for (uint32_t y = uY0; y < uY1; ++y)
+    {
+        for (uint32_t x = uX0; x < uX1; ++x)
+        {
+            if (_pLayer->pData[y * _pLayer->uWidth + x] != uRefTileId)
+                return false;
+        }
+    }
+
+    *_pOutTileId = uRefTileId;
+    return true;
+}
+
+static uint32_t count_mixed_chunks(const tmap_layer_src_t *_pLayer)
+{
+    uint16_t uChunksX = (uint16_t)((_pLayer->uWidth + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT);
+    uint16_t uChunksY = (uint16_t)((_pLayer->uHeight + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT);
+    uint32_t uMixed = 0;
+    uint8_t uTileId;
+
+    for (uint16_t cy = 0; cy < uChunksY; ++cy)
+    {
+        for (uint16_t cx = 0; cx < uChunksX; ++cx)
+        {
+            if (!chunk_is_uniform(_pLayer, cx, cy, &uTileId))
+                uMixed++;
+        }
+    }
+    return uMixed;
+}
+
+/* Chunk table, then 16x16 tiles per mixed chunk (edge padding is empty), same layout as chunked_layer_build */
+static void write_chunked_payload(tmap_buffer_t *_pBuf, size_t _uOffset, const tmap_layer_src_t *_pLayer, uint32_t _uMixedCount)
+{
+    uint16_t uChunksX = (uint16_t)((_pLayer->uWidth + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT);
+    uint16_t uChunksY = (uint16_t)((_pLayer->uHeight + TILEMAP_FORMAT_CHUNK_MASK) >> TILEMAP_FORMAT_CHUNK_SHIFT);
+    size_t uTableSize = tilemap_format_chunk_table_size(_pLayer->uWidth, _pLayer->uHeight);
+    size_t uPoolOffset = _uOffset + uTableSize;
+
+    buffer_reserve(_pBuf, uPoolOffset + (size_t)_uMixedCount * TILEMAP_FORMAT_CHUNK_TILES);
+    memset(_pBuf->pData + _uOffset, 0, uTableSize);
+    memset(_pBuf->pData + uPoolOffset, TMAP_EMPTY_TILE, (size_t)_uMixedCount * TILEMAP_FORMAT_CHUNK_TILES);
+
+    uint16_t uDataIndex = 0;
+    uint8_t uTileId;
+    for (uint16_t cy = 0; cy < uChunksY; ++cy)
+    {
+        for (uint16_t cx = 0; cx < uChunksX; ++cx)
+        {
+            size_t uRecord = _uOffset + ((size_t)cy * uChunksX + cx) * TILEMAP_FORMAT_CHUNK_RECORD_SIZE;
+
+            if (chunk_is_uniform(_pLayer, cx, cy, &uTileId))
+            {
+                buffer_put_u16(_pBuf, uRecord + 0, TILEMAP_FORMAT_CHUNK_UNIFORM);
+                buffer_put_u8(_pBuf, uRecord + 2, uTileId);
+                continue;
+            }
+
+            buffer_put_u16(_pBuf, uRecord + 0, uDataIndex);
+            buffer_put_u8(_pBuf, uRecord + 2, TMAP_EMPTY_TILE);
+
+            uint8_t *pDst = _pBuf->pData + uPoolOffset + (size_t)uDataIndex * TILEMAP_FORMAT_CHUNK_TILES;
+            uint32_t uX0 = (uint32_t)cx * TILEMAP_FORMAT_CHUNK_SIZE;
+            uint32_t uY0 = (uint32_t)cy * TILEMAP_FORMAT_CHUNK_SIZE;
+            for (uint32_t y = 0; y < TILEMAP_FORMAT_CHUNK_SIZE && uY0 + y < _pLayer->uHeight; ++y)
+            {
+                for (uint32_t x = 0; x < TILEMAP_FORMAT_CHUNK_SIZE && uX0 + x < _pLayer->uWidth; ++x)
+                    pDst[y * TILEMAP_FORMAT_CHUNK_SIZE + x] = _pLayer->pData[(uY0 + y) * _pLayer->uWidth + uX0 + x];
+            }
+            uDataIndex++;
+        }
+    }
+}
+
+/* Returns the chosen storage kind */
+static uint8_t encode_layer(tmap_buffer_t *_pBuf, size_t _uRecordOffset, const tmap_layer_src_t *_pLayer)
+{
+    uint32_t uTotalTiles = (uint32_t)_pLayer->uWidth * _pLayer->uHeight;
+    uint32_t uNonEmpty = 0;
+    bool bAllSame = true;
+    uint8_t uRefTileId = _pLayer->pData[0];
+
+    for (uint32_t i = 0; i < uTotalTiles; ++i)
+    {
+        uint8_t uTileId = _pLayer->pData[i];
+        if (uTileId != TMAP_EMPTY_TILE)
+            uNonEmpty++;
+        if (uTileId != uRefTileId)
+            bAllSame = false;
+    }
+
+    uint8_t uStorage;
+    uint8_t uSingleTileId = TMAP_EMPTY_TILE;
+    if (uNonEmpty == 0)
+    {
+        uStorage = TMAP_STORAGE_SINGLE;
+    }
+    else if (uNonEmpty == uTotalTiles && bAllSame)
+    {
+        uStorage = TMAP_STORAGE_SINGLE;
+        uSingleTileId = uRefTileId;
+    }
+    else if ((float)uNonEmpty / (float)uTotalTiles < TILEMAP_FORMAT_SPARSE_THRESHOLD)
+    {
+        uStorage = TMAP_STORAGE_SPARSE;
+    }
+    else
+    {
+        uStorage = TMAP_STORAGE_DENSE;
+    }
+
+    /* Dense layers with large empty or uniform areas shrink as 16x16 chunks */
+    uint32_t uMixedChunks = 0;
+    if (uStorage == TMAP_STORAGE_DENSE)
+    {
+        uMixedChunks = count_mixed_chunks(_pLayer);
+        if (uMixedChunks < TILEMAP_FORMAT_CHUNK_UNIFORM && tilemap_format_prefer_chunked(_pLayer->uWidth, _pLayer->uHeight, uMixedChunks))
+            uStorage = TMAP_STORAGE_CHUNKED;
+    }
+
+    uint32_t uDataOffset = 0;
+    uint32_t uDataSize = 0;
+    uint16_t uSparseCapacity = 0;
+    uint16_t uSparseCount = 0;
+
+    if (uStorage == TMAP_STORAGE_DENSE)
+    {
+        uDataOffset = (uint32_t)buffer_align(_pBuf);
+        uDataSize = uTotalTiles;
+        buffer_reserve(_pBuf, uDataOffset + uDataSize);
+        memcpy(_pBuf->pData + uDataOffset, _pLayer->pData, uDataSize);
+        _pBuf->uSize = uDataOffset + uDataSize;
+    }
+    else if (uStorage == TMAP_STORAGE_SPARSE)
+    {
+        uSparseCapacity = tilemap_format_sparse_capacity((uint16_t)uNonEmpty);
+        uDataOffset = (uint32_t)buffer_align(_pBuf);
+        uDataSize = (uint32_t)uSparseCapacity * TMAP_SPARSE_ENTRY_SIZE;
+        write_sparse_payload(_pBuf, uDataOffset, _pLayer, uSparseCapacity, &uSparseCount);
+        _pBuf->uSize = uDataOffset + uDataSize;
+    }
+    else if (uStorage == TMAP_STORAGE_CHUNKED)
+    {
+        uDataOffset = (uint32_t)buffer_align(_pBuf);
+        uDataSize = tilemap_format_chunk_table_size(_pLayer->uWidth, _pLayer->uHeight) + uMixedChunks * TILEMAP_FORMAT_CHUNK_TILES;
+        write_chunked_payload(_pBuf, uDataOffset, _pLayer, uMixedChunks);
+        _pBuf->uSize = uDataOffset + uDataSize;
+    }
+
+    buffer_put_u8(_pBuf, _uRecordOffset + 0, uStorage);
+    buffer_put_u8(_pBuf, _uRecordOffset + 1, uSingleTileId);
+    buffer_put_u16(_pBuf, _uRecordOffset + 2, _pLayer->uWidth);
+    buffer_put_u16(_pBuf, _uRecordOffset + 4, _pLayer->uHeight);
+    buffer_put_u16(_pBuf, _uRecordOffset + 6, (uint16_t)uNonEmpty);
+    buffer_put_u16(_pBuf, _uRecordOffset + 8, uSparseCapacity);
+    buffer_put_u16(_pBuf, _uRecordOffset + 10, uSparseCount);
+    buffer_put_u32(_pBuf, _uRecordOffset + 12, uDataOffset);
+    buffer_put_u32(_pBuf, _uRecordOffset + 16, uDataSize);
+    return uStorage;
+}
+
+/* ---------- Atlas baking ---------- */
+
+static uint16_t rgba8_to_rgba16(const uint8_t *_pPixel)
+{
+    return (uint16_t)(((_pPixel[0] >> 3) << 11) | ((_pPixel[1] >> 3) << 6) | ((_pPixel[2] >> 3) << 1) | (_pPixel[3] > 127 ? 1 : 0));
+}
+
+/* Decode <folder>/<id>.png, convert its top-left 16x16 to RGBA16 and compute the trimmed rect
+ * (bounding box of pixels whose RGBA16 alpha bit is set, like sprite_tools_get_trimmed_rect) */
+static bool load_tile(const char *_pFolder, int _iTileId, tmap_tile_t *_pOut)
+{
+    char szPath[512];
+    snprintf(szPath, sizeof(szPath), "%s/%d.png", _pFolder, _iTileId);
+
+    uint8_t *pRGBA = NULL;
+    uint32_t uWidth = 0, uHeight = 0;
+    if (!png_decode_file(szPath, &pRGBA, &uWidth, &uHeight))
+        return false;
+
+    if (uWidth < TMAP_TILE_SIZE || uHeight < TMAP_TILE_SIZE)
+    {
+        fprintf(stderr, "tmap_convert: %s is %ux%u, tiles must be at least %dx%d\n", szPath, uWidth, uHeight, TMAP_TILE_SIZE, TMAP_TILE_SIZE);
+        free(pRGBA);
+        return false;
+    }
+
+    for (uint32_t y = 0; y < TMAP_TILE_SIZE; ++y)
+    {
+        for (uint32_t x = 0; x < TMAP_TILE_SIZE; ++x)
+            _pOut->aPixels[y * TMAP_TILE_SIZE + x] = rgba8_to_rgba16(pRGBA + ((size_t)y * uWidth + x) * 4);
+    }
+
+    int32_t iMinX = (int32_t)uWidth, iMinY = (int32_t)uHeight, iMaxX = -1, iMaxY = -1;
+    for (uint32_t y = 0; y < uHeight; ++y)
+    {
+        for (uint32_t x = 0; x < uWidth; ++x)
+        {
+            if (pRGBA[((size_t)y * uWidth + x) * 4 + 3] <= 127)
+                continue;
+
+            if ((int32_t)x < iMinX)
+                iMinX = (int32_t)x;
+            if ((int32_t)x > iMaxX)
+                iMaxX = (int32_t)x;
+            if ((int32_t)y < iMinY)
+                iMinY = (int32_t)y;
+            if ((int32_t)y > iMaxY)
+                iMaxY = (int32_t)y;
+        }
+    }
+    free(pRGBA);
+
+    if (iMaxX < 0)
+    {
+        /* Fully transparent: zero-sized rect */
+        _pOut->iOffsetX = _pOut->iOffsetY = _pOut->iSizeX = _pOut->iSizeY = 0;
+    }
+    else
+    {
+        _pOut->iOffsetX = iMinX;
+        _pOut->iOffsetY = iMinY;
+        _pOut->iSizeX = iMaxX - iMinX + 1;
+        _pOut->iSizeY = iMaxY - iMinY + 1;
+    }
+    return true;
+}
+
+/* Adjacency counts between tile pairs: right/down neighbours within a layer and the same cell on
+ * different layers. _pPairs is _uTileCount * _uTileCount, symmetric. */
+static void count_covisibility(const tmap_layer_src_t *_pLayers, uint8_t _uLayerCount, uint16_t _uTileCount, uint32_t *_pPairs)
+{
+    memset(_pPairs, 0, (size_t)_uTileCount * _uTileCount * sizeof(uint32_t));
+
+    for (uint8_t l = 0; l < _uLayerCount; ++l)
+    {
+        const tmap_layer_src_t *pLayer = &_pLayers[l];
+        for (uint16_t y = 0; y < pLayer->uHeight; ++y)
+        {
+            for (uint16_t x = 0; x < pLayer->uWidth; ++x)
+            {
+                size_t uIndex = (size_t)y * pLayer->uWidth + x;
+                uint8_t uA = pLayer->pData[uIndex];
+                if (uA == TMAP_EMPTY_TILE)
+                    continue;
+
+                uint8_t aOther[2 + TILEMAP_FORMAT_MAX_LAYERS];
+                uint8_t uOtherCount = 0;
+                if (x + 1 < pLayer->uWidth)
+                    aOther[uOtherCount++] = pLayer->pData[uIndex + 1];
+                if (y + 1 < pLayer->uHeight)
+                    aOther[uOtherCount++] = pLayer->pData[uIndex + pLayer->uWidth];
+                for (uint8_t m = (uint8_t)(l + 1); m < _uLayerCount; ++m)
+                    aOther[uOtherCount++] = _pLayers[m].pData[uIndex];
+
+                for (uint8_t i = 0; i < uOtherCount; ++i)
+                {
+                    uint8_t uB = aOther[i];
+                    if (uB == TMAP_EMPTY_TILE || uB == uA)
+                        continue;
+                    _pPairs[(size_t)uA * _uTileCount + uB]++;
+                    _pPairs[(size_t)uB * _uTileCount + uA]++;
+                }
+            }
+        }
+    }
+}
+
+/* Greedy page packing: seed each page with the most used unpacked tile (first in _pSorted), then add
+ * the unpacked tile with the highest summed adjacency to the page members until the page is full.
+ * Ties fall back to the frequency order, so tiles that never touch packed ones keep that order. */
+static void pack_covisibility(const tmap_frequency_t *_pSorted, uint16_t _uTileCount, const uint32_t *_pPairs, tmap_frequency_t *_pOut)
+{
+    bool aPacked[TMAP_MAX_TILES] = {false};
+    uint16_t uOut = 0;
+
+    while (uOut < _uTileCount)
+    {
+        uint16_t uPageStart = uOut;
+        for (uint16_t i = 0; i < _uTileCount; ++i)
+        {
+            if (!aPacked[i])
+            {
+                aPacked[i] = true;
+                _pOut[uOut++] = _pSorted[i];
+                break;
+            }
+        }
+
+        while (uOut < _uTileCount && uOut - uPageStart < TMAP_ATLAS_TILES_PER_PAGE)
+        {
+            uint16_t uBest = 0;
+            uint64_t uBestScore = 0;
+            bool bFound = false;
+            for (uint16_t i = 0; i < _uTileCount; ++i)
+            {
+                if (aPacked[i])
+                    continue;
+
+                uint64_t uScore = 0;
+                for (uint16_t j = uPageStart; j < uOut; ++j)
+                    uScore += _pPairs[(size_t)_pSorted[i].uTileId * _uTileCount + _pOut[j].uTileId];
+
+                if (!bFound || uScore > uBestScore)
+                {
+                    uBest = i;
+                    uBestScore = uScore;
+                    bFound = true;
+                }
+            }
+            aPacked[uBest] = true;
+            _pOut[uOut++] = _pSorted[uBest];
+        }
+    }
+}
+
+/* Average page binds of a TMAP_SWEEP_VIEW_TILES_X x _Y view (distinct pages per layer, summed over
+ * layers like the per-layer page buckets at runtime), over camera positions every TMAP_SWEEP_STEP_TILES tiles */
+static float sweep_pages_per_screen(const tmap_layer_src_t *_pLayers, uint8_t _uLayerCount, const tmap_frequency_t *_pOrder, uint16_t _uTileCount)
+{
+    uint8_t aPageOfTile[TMAP_MAX_TILES];
+    for (uint16_t i = 0; i < _uTileCount; ++i)
+        aPageOfTile[_pOrder[i].uTileId] = (uint8_t)(i / TMAP_ATLAS_TILES_PER_PAGE);
+
+    uint16_t uWidth = _pLayers[0].uWidth;
+    uint16_t uHeight = _pLayers[0].uHeight;
+    uint16_t uViewW = uWidth < TMAP_SWEEP_VIEW_TILES_X ? uWidth : TMAP_SWEEP_VIEW_TILES_X;
+    uint16_t uViewH = uHeight < TMAP_SWEEP_VIEW_TILES_Y ? uHeight : TMAP_SWEEP_VIEW_TILES_Y;
+
+    uint64_t uPageSum = 0;
+    uint32_t uSamples = 0;
+    for (uint32_t uTop = 0; uTop + uViewH <= uHeight; uTop += TMAP_SWEEP_STEP_TILES)
+    {
+        for (uint32_t uLeft = 0; uLeft + uViewW <= uWidth; uLeft += TMAP_SWEEP_STEP_TILES)
+        {
+            for (uint8_t l = 0; l < _uLayerCount; ++l)
+            {
+                bool aUsed[TMAP_ATLAS_MAX_PAGES] = {false};
+                for (uint32_t y = uTop; y < uTop + uViewH; ++y)
+                {
+                    const uint8_t *pRow = _pLayers[l].pData + (size_t)y * uWidth;
+                    for (uint32_t x = uLeft; x < uLeft + uViewW; ++x)
+                    {
+                        if (pRow[x] == TMAP_EMPTY_TILE)
+                            continue;
+                        uint8_t uPage = aPageOfTile[pRow[x]];
+                        if (!aUsed[uPage])
+                        {
+                            aUsed[uPage] = true;
+                            uPageSum++;
+                        }
+                    }
+                }
+            }
+            uSamples++;
+        }
+    }
+    return uSamples ? (float)uPageSum / (float)uSamples : 0.0f;
+}
+
+/* Writes pages, atlas entries and trimmed rects; returns the page count */
+static uint16_t write_atlas(tmap_buffer_t *_pBuf, const tmap_tile_t *_pTiles, const tmap_frequency_t *_pSorted, uint16_t _uTileCount, uint32_t *_pPagesOffset, uint32_t *_pEntriesOffset, uint32_t *_pRectsOffset)
+{
+    uint16_t uPageCount = (uint16_t)((_uTileCount + TMAP_ATLAS_TILES_PER_PAGE - 1) / TMAP_ATLAS_TILES_PER_PAGE);
+    if (uPageCount > TMAP_ATLAS_MAX_PAGES)
+        uPageCount = TMAP_ATLAS_MAX_PAGES;
+
+    uint8_t aEntries[TMAP_MAX_TILES][TMAP_ATLAS_ENTRY_SIZE];
+    for (uint16_t i = 0; i < _uTileCount; ++i)
+    {
+        aEntries[i][0] = TMAP_ATLAS_NO_PAGE;
+        aEntries[i][1] = 0;
+        aEntries[i][2] = 0;
+    }
+
+    /* Pages (zero = transparent), 4x2 tiles each */
+    size_t uPagesOffset = buffer_align(_pBuf);
+    size_t uPagesSize = (size_t)uPageCount * TILEMAP_FORMAT_ATLAS_PAGE_BYTES;
+    buffer_reserve(_pBuf, uPagesOffset + uPagesSize);
+    memset(_pBuf->pData + uPagesOffset, 0, uPagesSize);
+
+    for (uint16_t uPage = 0; uPage < uPageCount; ++uPage)
+    {
+        size_t uPageOffset = uPagesOffset + (size_t)uPage * TILEMAP_FORMAT_ATLAS_PAGE_BYTES;
+        for (uint8_t uTileInPage = 0; uTileInPage < TMAP_ATLAS_TILES_PER_PAGE; ++uTileInPage)
+        {
+            uint16_t uGlobalIndex = (uint16_t)(uPage * TMAP_ATLAS_TILES_PER_PAGE + uTileInPage);
+            if (uGlobalIndex >= _uTileCount)
+                break;
+
+            uint8_t uTileId = _pSorted[uGlobalIndex].uTileId;
+            uint8_t uPageX = (uint8_t)((uTileInPage % TMAP_ATLAS_TILES_PER_ROW) * TMAP_TILE_SIZE);
+            uint8_t uPageY = (uint8_t)((uTileInPage / TMAP_ATLAS_TILES_PER_ROW) * TMAP_TILE_SIZE);
+
+            for (uint32_t y = 0; y < TMAP_TILE_SIZE; ++y)
+            {
+                size_t uRow = uPageOffset + (size_t)(uPageY + y) * TMAP_ATLAS_PAGE_WIDTH * 2;
+                for (uint32_t x = 0; x < TMAP_TILE_SIZE; ++x)
+                    buffer_put_u16(_pBuf, uRow + (size_t)(uPageX + x) * 2, _pTiles[uTileId].aPixels[y * TMAP_TILE_SIZE + x]);
+            }
+
+            aEntries[uTileId][0] = (uint8_t)uPage;
+            aEntries[uTileId][1] = uPageX;
+            aEntries[uTileId][2] = uPageY;
+        }
+    }
+    _pBuf->uSize = uPagesOffset + uPagesSize;
+
+    /* Atlas entries */
+    size_t uEntriesOffset = buffer_align(_pBuf);
+    for (uint16_t i = 0; i < _uTileCount; ++i)
+    {
+        for (uint8_t j = 0; j < TMAP_ATLAS_ENTRY_SIZE; ++j)
+            buffer_put_u8(_pBuf, uEntriesOffset + (size_t)i * TMAP_ATLAS_ENTRY_SIZE + j, aEntries[i][j]);
+    }
+    _pBuf->uSize = uEntriesOffset + (size_t)_uTileCount * TMAP_ATLAS_ENTRY_SIZE;
+
+    /* Trimmed rects */
+    size_t uRectsOffset = buffer_align(_pBuf);
+    for (uint16_t i = 0; i < _uTileCount; ++i)
+    {
+        size_t uRect = uRectsOffset + (size_t)i * TMAP_TRIMMED_RECT_SIZE;
+        buffer_put_u32(_pBuf, uRect + 0, (uint32_t)_pTiles[i].iOffsetX);
+        buffer_put_u32(_pBuf, uRect + 4, (uint32_t)_pTiles[i].iOffsetY);
+        buffer_put_u32(_pBuf, uRect + 8, (uint32_t)_pTiles[i].iSizeX);
+        buffer_put_u32(_pBuf, uRect + 12, (uint32_t)_pTiles[i].iSizeY);
+    }
+    _pBuf->uSize = uRectsOffset + (size_t)_uTileCount * TMAP_TRIMMED_RECT_SIZE;
+
+    *_pPagesOffset = (uint32_t)uPagesOffset;
+    *_pEntriesOffset = (uint32_t)uEntriesOffset;
+    *_pRectsOffset = (uint32_t)uRectsOffset;
+    return uPageCount;
+}
+
+/* ---------- Main ---------- */
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <asset folder> <output.tmap>\n", argv[0]);
+        return 1;
+    }
+
+    const char *pFolder = argv[1];
+    const char *pOutPath = argv[2];
+
+    /* Map name = last path component of the folder */
+    char szName[256];
+    const char *pSlash = strrchr(pFolder, '/');
+    snprintf(szName, sizeof(szName), "%s", pSlash ? pSlash + 1 : pFolder);
+    size_t uNameLen = strlen(szName);
+    while (uNameLen > 0 && szName[uNameLen - 1] == '/')
+        szName[--uNameLen] = '\0';
+
+    int aTileIds[TMAP_MAX_TILES];
+    uint16_t uTileCount = 0;
+    if (!load_tile_ids(pFolder, aTileIds, &uTileCount))
+        return 1;
+
+    tmap_layer_src_t aLayers[TILEMAP_FORMAT_MAX_LAYERS];
+    memset(aLayers, 0, sizeof(aLayers));
+    uint8_t uLayerCount = 0;
+    while (uLayerCount < TILEMAP_FORMAT_MAX_LAYERS && load_layer(pFolder, szName, uLayerCount, aTileIds, uTileCount, &aLayers[uLayerCount]))
+    {
+        if (aLayers[uLayerCount].uWidth != aLayers[0].uWidth || aLayers[uLayerCount].uHeight != aLayers[0].uHeight)
+        {
+            fprintf(stderr, "tmap_convert: %s layer %u dimensions don't match layer 0\n", szName, (unsigned)uLayerCount);
+            return 1;
+        }
+        uLayerCount++;
+    }
+
+    if (uLayerCount == 0)
+    {
+        fprintf(stderr, "tmap_convert: no layers found for %s in %s\n", szName, pFolder);
+        return 1;
+    }
+
+    tmap_buffer_t buf = {0};
+    const size_t uHeaderSize = sizeof(tilemap_format_header_t);
+    buffer_reserve(&buf, uHeaderSize);
+    buf.uSize = uHeaderSize;
+
+    /* Tile ID table */
+    size_t uTileIdsOffset = buffer_align(&buf);
+    for (uint16_t i = 0; i < uTileCount; ++i)
+        buffer_put_u16(&buf, uTileIdsOffset + (size_t)i * 2, (uint16_t)aTileIds[i]);
+    buf.uSize = uTileIdsOffset + (size_t)uTileCount * 2;
+
+    /* Tile images */
+    static tmap_tile_t s_aTiles[TMAP_MAX_TILES];
+    for (uint16_t i = 0; i < uTileCount; ++i)
+    {
+        if (!load_tile(pFolder, aTileIds[i], &s_aTiles[i]))
+            return 1;
+    }
+
+    /* Layers; the usage histogram counts dense and chunked layers only, like the runtime fallback */
+    tmap_frequency_t aFreq[TMAP_MAX_TILES];
+    for (uint16_t i = 0; i < uTileCount; ++i)
+    {
+        aFreq[i].uTileId = (uint8_t)i;
+        aFreq[i].uFrequency = 0;
+    }
+
+    const size_t uLayerRecordBase = 16;
+    for (uint8_t i = 0; i < uLayerCount; ++i)
+    {
+        uint8_t uStorage = encode_layer(&buf, uLayerRecordBase + (size_t)i * sizeof(tilemap_format_layer_t), &aLayers[i]);
+        if (uStorage == TMAP_STORAGE_DENSE || uStorage == TMAP_STORAGE_CHUNKED)
+        {
+            size_t uTotal = (size_t)aLayers[i].uWidth * aLayers[i].uHeight;
+            for (size_t j = 0; j < uTotal; ++j)
+            {
+                if (aLayers[i].pData[j] != TMAP_EMPTY_TILE)
+                    aFreq[aLayers[i].pData[j]].uFrequency++;
+            }
+        }
+    }
+
+    /* Atlas: frequency order, then regrouped into pages by co-visibility */
+    qsort(aFreq, uTileCount, sizeof(tmap_frequency_t), cmp_frequency_desc);
+
+    uint32_t *pPairs = malloc((size_t)uTileCount * uTileCount * sizeof(uint32_t));
+    if (!pPairs)
+    {
+        fprintf(stderr, "tmap_convert: out of memory\n");
+        return 1;
+    }
+    tmap_frequency_t aPacked[TMAP_MAX_TILES];
+    count_covisibility(aLayers, uLayerCount, uTileCount, pPairs);
+    pack_covisibility(aFreq, uTileCount, pPairs, aPacked);
+    free(pPairs);
+
+    printf("%s: pages per screen %.2f (frequency) -> %.2f (co-visibility)\n", szName, sweep_pages_per_screen(aLayers, uLayerCount, aFreq, uTileCount),
+           sweep_pages_per_screen(aLayers, uLayerCount, aPacked, uTileCount));
+
+    for (uint8_t i = 0; i < uLayerCount; ++i)
+        free(aLayers[i].pData);
+
+    uint32_t uPagesOffset = 0, uEntriesOffset = 0, uRectsOffset = 0;
+    uint16_t uPageCount = write_atlas(&buf, s_aTiles, aPacked, uTileCount, &uPagesOffset, &uEntriesOffset, &uRectsOffset);
+    buffer_align(&buf);
+
+    /* Header */
+    buffer_put_u32(&buf, 0, TILEMAP_FORMAT_MAGIC);
+    buffer_put_u16(&buf, 4, TILEMAP_FORMAT_VERSION);
+    buffer_put_u16(&buf, 6, uTileCount);
+    buffer_put_u8(&buf, 8, uLayerCount);
+    buffer_put_u32(&buf, 12, (uint32_t)uTileIdsOffset);
+    buffer_put_u16(&buf, 116, uPageCount);
+    buffer_put_u32(&buf, 120, uPagesOffset);
+    buffer_put_u32(&buf, 124, uEntriesOffset);
+    buffer_put_u32(&buf, 128, uRectsOffset);
+
+    FILE *pOut = fopen(pOutPath, "wb");
+    if (!pOut)
+    {
+        fprintf(stderr, "tmap_convert: cannot write %s\n", pOutPath);
+        return 1;
+    }
+    fwrite(buf.pData, 1, buf.uSize, pOut);
+    fclose(pOut);
+    free(buf.pData);
+
+    return 0;
+}